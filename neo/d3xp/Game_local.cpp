@@ -31,11 +31,13 @@ If you have questions concerning this license or the applicable additional terms
 #include "sys/platform.h"
 #include "idlib/LangDict.h"
 #include "idlib/Timer.h"
+#include "idlib/Profiler.h"
 #include "framework/async/NetworkSystem.h"
 #include "framework/BuildVersion.h"
 #include "framework/DeclEntityDef.h"
 #include "framework/FileSystem.h"
 #include "renderer/ModelManager.h"
+#include "sys/jobs.h"
 
 #include "gamesys/SysCvar.h"
 #include "gamesys/SysCmds.h"
@@ -75,6 +77,7 @@ idUserInterfaceManager *	uiManager = NULL;
 idDeclManager *				declManager = NULL;
 idAASFileManager *			AASFileManager = NULL;
 idCollisionModelManager *	collisionModelManager = NULL;
+idParallelJobManager *		parallelJobManager = NULL;
 idCVar *					idCVar::staticVars = NULL;
 
 idCVar com_forceGenericSIMD( "com_forceGenericSIMD", "0", CVAR_BOOL|CVAR_SYSTEM, "force generic platform independent SIMD" );
@@ -156,6 +159,8 @@ extern "C" ID_GAME_API gameExport_t *GetGameAPI( gameImport_t *import ) {
 		declManager					= import->declManager;
 		AASFileManager				= import->AASFileManager;
 		collisionModelManager		= import->collisionModelManager;
+		parallelJobManager			= import->parallelJobManager;
+		profiler					= import->profiler;
 	}
 
 	// set interface pointers used by idLib
@@ -163,6 +168,7 @@ extern "C" ID_GAME_API gameExport_t *GetGameAPI( gameImport_t *import ) {
 	idLib::common				= common;
 	idLib::cvarSystem			= cvarSystem;
 	idLib::fileSystem			= fileSystem;
+	idLib::profiler				= profiler;
 
 	// setup export interface
 	gameExport.version = GAME_API_VERSION;
@@ -194,6 +200,8 @@ void TestGameAPI( void ) {
 	testImport.declManager				= ::declManager;
 	testImport.AASFileManager			= ::AASFileManager;
 	testImport.collisionModelManager	= ::collisionModelManager;
+	testImport.parallelJobManager		= ::parallelJobManager;
+	testImport.profiler					= ::profiler;
 
 	testExport = *GetGameAPI( &testImport );
 }
@@ -2459,6 +2467,8 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 	idPlayer* player;
 	const renderView_t* view;
 
+	PROF_SCOPE( "idGameLocal::RunFrame" );
+
 #ifdef _DEBUG
 	if ( isMultiplayer ) {
 		assert( !isClient );
@@ -936,13 +936,33 @@ idClass::ProcessEventArgPtr
 ================
 */
 bool idClass::ProcessEventArgPtr( const idEventDef *ev, intptr_t *data ) {
-	idTypeInfo	*c;
-	int			num;
 	eventCallback_t	callback;
 
 	assert( ev );
 	assert( idEvent::initialized );
 
+	callback = GetType()->eventMap[ ev->GetEventNum() ];
+	if ( !callback ) {
+		// we don't respond to this event, so ignore it
+		return false;
+	}
+
+	ProcessEventCallback( ev, callback, data );
+
+	return true;
+}
+
+/*
+================
+idClass::ProcessEventCallback
+
+Calls the callback of the event from the event map of this class.  The script
+interpreter uses it directly since it already looked up the callback.
+================
+*/
+void idClass::ProcessEventCallback( const idEventDef *ev, eventCallback_t callback, intptr_t *data ) {
+	assert( ev && callback );
+
 #ifdef _D3XP
 	SetTimeState ts;
 
@@ -952,20 +972,11 @@ bool idClass::ProcessEventArgPtr( const idEventDef *ev, intptr_t *data ) {
 	}
 #endif
 
-	if ( g_debugTriggers.GetBool() && ( ev == &EV_Activate ) && IsType( idEntity::Type ) ) {
+	if ( ( ev == &EV_Activate ) && g_debugTriggers.GetBool() && IsType( idEntity::Type ) ) {
 		const idEntity *ent = *reinterpret_cast<idEntity **>( data );
 		gameLocal.Printf( "%d: '%s' activated by '%s'\n", gameLocal.framenum, static_cast<idEntity *>( this )->GetName(), ent ? ent->GetName() : "NULL" );
 	}
 
-	c = GetType();
-	num = ev->GetEventNum();
-	if ( !c->eventMap[ num ] ) {
-		// we don't respond to this event, so ignore it
-		return false;
-	}
-
-	callback = c->eventMap[ num ];
-
 	switch( ev->GetFormatspecIndex() ) {
 	case 1 << D_EVENT_MAXARGS :
 		( this->*callback )();
@@ -978,8 +989,6 @@ bool idClass::ProcessEventArgPtr( const idEventDef *ev, intptr_t *data ) {
 		gameLocal.Warning( "Invalid formatspec on event '%s'", ev->GetName() );
 		break;
 	}
-
-	return true;
 }
 
 /*
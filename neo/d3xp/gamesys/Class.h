@@ -177,6 +177,7 @@ class idSaveGame;
 class idRestoreGame;
 
 class idClass {
+	friend class idEvent;
 public:
 	ABSTRACT_PROTOTYPE( idClass );
 
@@ -236,6 +237,7 @@ public:
 	bool						ProcessEvent( const idEventDef *ev, idEventArg arg1, idEventArg arg2, idEventArg arg3, idEventArg arg4, idEventArg arg5, idEventArg arg6, idEventArg arg7, idEventArg arg8 );
 
 	bool						ProcessEventArgPtr( const idEventDef *ev, intptr_t *data );
+	void						ProcessEventCallback( const idEventDef *ev, eventCallback_t callback, intptr_t *data );
 	void						CancelEvents( const idEventDef *ev );
 
 	void						Event_Remove( void );
@@ -259,6 +261,8 @@ private:
 
 	void						Event_SafeRemove( void );
 
+	idLinkList<idEvent>			eventList;			// events posted to this object
+
 	static bool					initialized;
 	static idList<idTypeInfo *>	types;
 	static idList<idTypeInfo *>	typenums;
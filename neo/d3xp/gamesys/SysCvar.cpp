@@ -136,6 +136,8 @@ idCVar g_skipFX(					"g_skipFX",					"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_skipParticles(				"g_skipParticles",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 
 idCVar g_disasm(					"g_disasm",					"0",			CVAR_GAME | CVAR_BOOL, "disassemble script into base/script/disasm.txt on the local drive when script is compiled" );
+idCVar g_scriptCache(				"g_scriptCache",			"1",			CVAR_GAME | CVAR_BOOL, "write the compiled scripts to fs_savepath and load them from there while the script files are unchanged" );
+idCVar g_scriptDecode(				"g_scriptDecode",			"1",			CVAR_GAME | CVAR_INTEGER, "0 = interpret the compiled script statements, 1 = run the pre-decoded statements, 2 = run the pre-decoded statements and check each one against the compiled statement", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar g_debugBounds(				"g_debugBounds",			"0",			CVAR_GAME | CVAR_BOOL, "checks for models with bounds > 2048" );
 idCVar g_debugAnim(					"g_debugAnim",				"-1",			CVAR_GAME | CVAR_INTEGER, "displays information on which animations are playing on the specified entity number.  set to -1 to disable." );
 idCVar g_debugMove(					"g_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -163,6 +165,7 @@ idCVar g_showCollisionWorld(		"g_showCollisionWorld",		"0",			CVAR_GAME | CVAR_B
 idCVar g_showCollisionModels(		"g_showCollisionModels",	"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showCollisionTraces(		"g_showCollisionTraces",	"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_maxShowDistance(			"g_maxShowDistance",		"128",			CVAR_GAME | CVAR_FLOAT, "" );
+idCVar g_clipBroadphase(			"g_clipBroadphase",			"1",			CVAR_GAME | CVAR_INTEGER, "clip model broadphase used from the next map load on, 0 = sector tree, 1 = loose spatial hash", 0, 1, idCmdSystem::ArgCompletion_Integer<0,1> );
 idCVar g_showEntityInfo(			"g_showEntityInfo",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showviewpos(				"g_showviewpos",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showcamerainfo(			"g_showcamerainfo",			"0",			CVAR_GAME | CVAR_ARCHIVE, "displays the current frame # for the camera when playing cinematics" );
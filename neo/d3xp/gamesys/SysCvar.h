@@ -52,6 +52,8 @@ extern idCVar	g_hitEffect;
 extern idCVar	g_muzzleFlash;
 
 extern idCVar	g_disasm;
+extern idCVar	g_scriptCache;
+extern idCVar	g_scriptDecode;
 extern idCVar	g_debugBounds;
 extern idCVar	g_debugAnim;
 extern idCVar	g_debugMove;
@@ -77,6 +79,7 @@ extern idCVar	g_showCollisionWorld;
 extern idCVar	g_showCollisionModels;
 extern idCVar	g_showCollisionTraces;
 extern idCVar	g_maxShowDistance;
+extern idCVar	g_clipBroadphase;
 extern idCVar	g_showEntityInfo;
 extern idCVar	g_showviewpos;
 extern idCVar	g_showcamerainfo;
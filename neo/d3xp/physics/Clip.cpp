@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "gamesys/SaveGame.h"
+#include "gamesys/SysCvar.h"
 #include "Entity.h"
 #include "Game_local.h"
 
@@ -43,9 +44,26 @@ typedef struct clipSector_s {
 	struct clipLink_s *		clipLinks;
 } clipSector_t;
 
+#define CLIP_HASH_LEVELS				10			// level 0 is a single cell the size of the world
+#define CLIP_HASH_SIZE					4096
+
+typedef struct clipLevel_s {
+	idVec3					cellSize;
+	int						numCells;			// along each axis
+	int						numModels;
+	idList<struct clipCell_s *>	cells;
+} clipLevel_t;
+
+typedef struct clipCell_s {
+	clipLevel_t *			level;
+	int						cell[3];
+	struct clipLink_s *		clipLinks;
+} clipCell_t;
+
 typedef struct clipLink_s {
 	idClipModel *			clipModel;
-	struct clipSector_s *	sector;
+	struct clipLink_s **	head;		// clipLinks of the sector or cell
+	clipCell_t *			cell;		// NULL when linked into the sector tree
 	struct clipLink_s *		prevInSector;
 	struct clipLink_s *		nextInSector;
 	struct clipLink_s *		nextLink;
@@ -62,6 +80,7 @@ typedef struct trmCache_s {
 idVec3 vec3_boxEpsilon( CM_BOX_EPSILON, CM_BOX_EPSILON, CM_BOX_EPSILON );
 
 idBlockAlloc<clipLink_t, 1024>	clipLinkAllocator;
+idBlockAlloc<clipCell_t, 256>	clipCellAllocator;
 
 
 /*
@@ -498,11 +517,14 @@ void idClipModel::Unlink( void ) {
 		if ( link->prevInSector ) {
 			link->prevInSector->nextInSector = link->nextInSector;
 		} else {
-			link->sector->clipLinks = link->nextInSector;
+			*link->head = link->nextInSector;
 		}
 		if ( link->nextInSector ) {
 			link->nextInSector->prevInSector = link->prevInSector;
 		}
+		if ( link->cell ) {
+			link->cell->level->numModels--;
+		}
 		clipLinkAllocator.Free( link );
 	}
 }
@@ -528,7 +550,8 @@ void idClipModel::Link_r( struct clipSector_s *node ) {
 
 	link = clipLinkAllocator.Alloc();
 	link->clipModel = this;
-	link->sector = node;
+	link->head = &node->clipLinks;
+	link->cell = NULL;
 	link->nextInSector = node->clipLinks;
 	link->prevInSector = NULL;
 	if ( node->clipLinks ) {
@@ -539,6 +562,30 @@ void idClipModel::Link_r( struct clipSector_s *node ) {
 	clipLinks = link;
 }
 
+/*
+===============
+idClipModel::Link_Cell
+===============
+*/
+void idClipModel::Link_Cell( struct clipCell_s *cell ) {
+	clipLink_t *link;
+
+	link = clipLinkAllocator.Alloc();
+	link->clipModel = this;
+	link->head = &cell->clipLinks;
+	link->cell = cell;
+	link->nextInSector = cell->clipLinks;
+	link->prevInSector = NULL;
+	if ( cell->clipLinks ) {
+		cell->clipLinks->prevInSector = link;
+	}
+	cell->clipLinks = link;
+	link->nextLink = clipLinks;
+	clipLinks = link;
+
+	cell->level->numModels++;
+}
+
 /*
 ===============
 idClipModel::Link
@@ -551,11 +598,10 @@ void idClipModel::Link( idClip &clp ) {
 		return;
 	}
 
-	if ( clipLinks ) {
-		Unlink();	// unlink from old position
-	}
-
 	if ( bounds.IsCleared() ) {
+		if ( clipLinks ) {
+			Unlink();	// unlink from old position
+		}
 		return;
 	}
 
@@ -574,6 +620,25 @@ void idClipModel::Link( idClip &clp ) {
 	absBounds[0] -= vec3_boxEpsilon;
 	absBounds[1] += vec3_boxEpsilon;
 
+	clp.numLinks++;
+
+	if ( clp.numClipLevels ) {
+		clipCell_t *cell = clp.GetClipCell( absBounds );
+		if ( clipLinks && clipLinks->cell == cell ) {
+			// moved inside the same cell
+			clp.numLinksKept++;
+			return;
+		}
+		if ( clipLinks ) {
+			Unlink();	// unlink from old position
+		}
+		Link_Cell( cell );
+		return;
+	}
+
+	if ( clipLinks ) {
+		Unlink();	// unlink from old position
+	}
 	Link_r( clp.clipSectors );
 }
 
@@ -624,8 +689,11 @@ idClip::idClip
 idClip::idClip( void ) {
 	numClipSectors = 0;
 	clipSectors = NULL;
+	numClipLevels = 0;
+	clipLevels = NULL;
 	worldBounds.Zero();
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	numTouchQueries = numTouchTests = numLinks = numLinksKept = 0;
 }
 
 /*
@@ -678,6 +746,106 @@ clipSector_t *idClip::CreateClipSectors_r( const int depth, const idBounds &boun
 	return anode;
 }
 
+/*
+===============
+idClip::CreateClipLevels
+
+Sets up the spatial hash.  Each level halves the cells of the previous level
+along every axis.  A clip model is linked into a single cell, on the deepest
+level with cells at least as large as its bounds, in the cell that holds the
+center of its bounds.  So a clip model never sticks out more than half a cell
+from its cell.  Cells are created when a clip model first moves into them and
+stay around until the map is unloaded.
+===============
+*/
+void idClip::CreateClipLevels( void ) {
+	int i;
+
+	numClipLevels = CLIP_HASH_LEVELS;
+	clipLevels = new clipLevel_t[numClipLevels];
+	for ( i = 0; i < numClipLevels; i++ ) {
+		clipLevels[i].numCells = 1 << i;
+		clipLevels[i].cellSize = ( worldBounds[1] - worldBounds[0] ) * ( 1.0f / clipLevels[i].numCells );
+		clipLevels[i].numModels = 0;
+		clipLevels[i].cells.SetGranularity( 256 );
+	}
+	clipCells.SetGranularity( 1024 );
+	clipCellHash.Clear( CLIP_HASH_SIZE, 1024 );
+}
+
+/*
+===============
+ClipCell_Coord
+
+  cell along an axis, positions outside the world are put in the outer cells
+===============
+*/
+static ID_INLINE int ClipCell_Coord( const float v, const float worldMin, const float cellSize, const int numCells ) {
+	int c = idMath::FtoiFast( idMath::Floor( ( v - worldMin ) / cellSize ) );
+	if ( c < 0 ) {
+		return 0;
+	}
+	if ( c >= numCells ) {
+		return numCells - 1;
+	}
+	return c;
+}
+
+/*
+===============
+ClipCell_Key
+===============
+*/
+static ID_INLINE int ClipCell_Key( const int level, const int x, const int y, const int z ) {
+	return ( x * 73856093 ) ^ ( y * 19349663 ) ^ ( z * 83492791 ) ^ ( level * 50331653 );
+}
+
+/*
+===============
+idClip::GetClipCell
+===============
+*/
+clipCell_t *idClip::GetClipCell( const idBounds &absBounds ) {
+	int				i, l, c[3], key;
+	idVec3			size, center;
+	clipLevel_t *	level;
+	clipCell_t *	cell;
+
+	size = absBounds[1] - absBounds[0];
+	center = absBounds.GetCenter();
+
+	for ( l = numClipLevels - 1; l > 0; l-- ) {
+		const idVec3 &cellSize = clipLevels[l].cellSize;
+		if ( size[0] <= cellSize[0] && size[1] <= cellSize[1] && size[2] <= cellSize[2] ) {
+			break;
+		}
+	}
+	level = &clipLevels[l];
+
+	for ( i = 0; i < 3; i++ ) {
+		c[i] = ClipCell_Coord( center[i], worldBounds[0][i], level->cellSize[i], level->numCells );
+	}
+
+	key = ClipCell_Key( l, c[0], c[1], c[2] );
+	for ( i = clipCellHash.First( key ); i != -1; i = clipCellHash.Next( i ) ) {
+		cell = clipCells[i];
+		if ( cell->level == level && cell->cell[0] == c[0] && cell->cell[1] == c[1] && cell->cell[2] == c[2] ) {
+			return cell;
+		}
+	}
+
+	cell = clipCellAllocator.Alloc();
+	cell->level = level;
+	cell->cell[0] = c[0];
+	cell->cell[1] = c[1];
+	cell->cell[2] = c[2];
+	cell->clipLinks = NULL;
+	clipCellHash.Add( key, clipCells.Append( cell ) );
+	level->cells.Append( cell );
+
+	return cell;
+}
+
 /*
 ===============
 idClip::Init
@@ -687,26 +855,36 @@ void idClip::Init( void ) {
 	cmHandle_t h;
 	idVec3 size, maxSector = vec3_origin;
 
-	// clear clip sectors
-	clipSectors = new clipSector_t[MAX_SECTORS];
-	memset( clipSectors, 0, MAX_SECTORS * sizeof( clipSector_t ) );
 	numClipSectors = 0;
+	numClipLevels = 0;
 	touchCount = -1;
 	// get world map bounds
 	h = collisionModelManager->LoadModel( "worldMap", false );
 	collisionModelManager->GetModelBounds( h, worldBounds );
-	// create world sectors
-	CreateClipSectors_r( 0, worldBounds, maxSector );
 
 	size = worldBounds[1] - worldBounds[0];
 	gameLocal.Printf( "map bounds are (%1.1f, %1.1f, %1.1f)\n", size[0], size[1], size[2] );
-	gameLocal.Printf( "max clip sector is (%1.1f, %1.1f, %1.1f)\n", maxSector[0], maxSector[1], maxSector[2] );
+
+	if ( g_clipBroadphase.GetInteger() == 1 ) {
+		// create the spatial hash
+		CreateClipLevels();
+		maxSector = clipLevels[numClipLevels - 1].cellSize;
+		gameLocal.Printf( "smallest clip cell is (%1.1f, %1.1f, %1.1f)\n", maxSector[0], maxSector[1], maxSector[2] );
+	} else {
+		// clear clip sectors
+		clipSectors = new clipSector_t[MAX_SECTORS];
+		memset( clipSectors, 0, MAX_SECTORS * sizeof( clipSector_t ) );
+		// create world sectors
+		CreateClipSectors_r( 0, worldBounds, maxSector );
+		gameLocal.Printf( "max clip sector is (%1.1f, %1.1f, %1.1f)\n", maxSector[0], maxSector[1], maxSector[2] );
+	}
 
 	// initialize a default clip model
 	defaultClipModel.LoadModel( idTraceModel( idBounds( idVec3( 0, 0, 0 ) ).Expand( 8 ) ) );
 
 	// set counters to zero
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	numTouchQueries = numTouchTests = numLinks = numLinksKept = 0;
 }
 
 /*
@@ -718,6 +896,12 @@ void idClip::Shutdown( void ) {
 	delete[] clipSectors;
 	clipSectors = NULL;
 
+	delete[] clipLevels;
+	clipLevels = NULL;
+	numClipLevels = 0;
+	clipCells.Clear();
+	clipCellHash.Free();
+
 	// free the trace model used for the temporaryClipModel
 	if ( temporaryClipModel.traceModelIndex != -1 ) {
 		idClipModel::FreeTraceModel( temporaryClipModel.traceModelIndex );
@@ -731,6 +915,7 @@ void idClip::Shutdown( void ) {
 	}
 
 	clipLinkAllocator.Shutdown();
+	clipCellAllocator.Shutdown();
 }
 
 /*
@@ -759,9 +944,79 @@ void idClip::ClipModelsTouchingBounds_r( const struct clipSector_s *node, listPa
 		}
 	}
 
-	for ( clipLink_t *link = node->clipLinks; link; link = link->nextInSector ) {
+	ClipModelsTouchingLinks( node->clipLinks, parms );
+}
+
+/*
+====================
+idClip::ClipModelsTouchingCells
+
+  the center of a clip model is at most half a cell outside the bounds
+====================
+*/
+void idClip::ClipModelsTouchingCells( listParms_t &parms ) const {
+	int					i, j, l, x, y, z, key, numCells;
+	int					mins[3], maxs[3];
+	const clipLevel_t *	level;
+	const clipCell_t *	cell;
+
+	for ( l = 0; l < numClipLevels; l++ ) {
+		level = &clipLevels[l];
+		if ( !level->numModels ) {
+			continue;
+		}
+
+		numCells = 1;
+		for ( i = 0; i < 3; i++ ) {
+			float margin = level->cellSize[i] * 0.5f + CM_BOX_EPSILON;
+			mins[i] = ClipCell_Coord( parms.bounds[0][i] - margin, worldBounds[0][i], level->cellSize[i], level->numCells );
+			maxs[i] = ClipCell_Coord( parms.bounds[1][i] + margin, worldBounds[0][i], level->cellSize[i], level->numCells );
+			numCells *= maxs[i] - mins[i] + 1;
+		}
+
+		if ( numCells > level->cells.Num() ) {
+			// fewer cells exist than the bounds cover
+			for ( j = 0; j < level->cells.Num(); j++ ) {
+				cell = level->cells[j];
+				if ( cell->clipLinks &&
+						cell->cell[0] >= mins[0] && cell->cell[0] <= maxs[0] &&
+						cell->cell[1] >= mins[1] && cell->cell[1] <= maxs[1] &&
+						cell->cell[2] >= mins[2] && cell->cell[2] <= maxs[2] ) {
+					ClipModelsTouchingLinks( cell->clipLinks, parms );
+				}
+			}
+			continue;
+		}
+
+		for ( x = mins[0]; x <= maxs[0]; x++ ) {
+			for ( y = mins[1]; y <= maxs[1]; y++ ) {
+				for ( z = mins[2]; z <= maxs[2]; z++ ) {
+					key = ClipCell_Key( l, x, y, z );
+					for ( j = clipCellHash.First( key ); j != -1; j = clipCellHash.Next( j ) ) {
+						cell = clipCells[j];
+						if ( cell->level == level && cell->cell[0] == x && cell->cell[1] == y && cell->cell[2] == z ) {
+							ClipModelsTouchingLinks( cell->clipLinks, parms );
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/*
+====================
+idClip::ClipModelsTouchingLinks
+====================
+*/
+void idClip::ClipModelsTouchingLinks( const struct clipLink_s *links, listParms_t &parms ) const {
+
+	for ( const clipLink_t *link = links; link; link = link->nextInSector ) {
 		idClipModel	*check = link->clipModel;
 
+		numTouchTests++;
+
 		// if the clip model is enabled
 		if ( !check->enabled ) {
 			continue;
@@ -822,7 +1077,12 @@ int idClip::ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, i
 	parms.maxCount = maxCount;
 
 	touchCount++;
-	ClipModelsTouchingBounds_r( clipSectors, parms );
+	numTouchQueries++;
+	if ( numClipLevels ) {
+		ClipModelsTouchingCells( parms );
+	} else {
+		ClipModelsTouchingBounds_r( clipSectors, parms );
+	}
 
 	return parms.count;
 }
@@ -1609,7 +1869,10 @@ idClip::PrintStatistics
 void idClip::PrintStatistics( void ) {
 	gameLocal.Printf( "t = %-3d, r = %-3d, m = %-3d, render = %-3d, contents = %-3d, contacts = %-3d\n",
 					numTranslations, numRotations, numMotions, numRenderModelTraces, numContents, numContacts );
+	gameLocal.Printf( "%s: touching = %-3d, tested = %-4d, links = %-3d, kept = %-3d, cells = %d\n",
+					numClipLevels ? "hash" : "sectors", numTouchQueries, numTouchTests, numLinks, numLinksKept, numClipLevels ? clipCells.Num() : numClipSectors );
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	numTouchQueries = numTouchTests = numLinks = numLinksKept = 0;
 }
 
 /*
@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #define __CLIP_H__
 
 #include "idlib/geometry/TraceModel.h"
+#include "idlib/containers/HashIndex.h"
 #include "cm/CollisionModel.h"
 
 class idSaveGame;
@@ -128,11 +129,12 @@ private:
 	int						traceModelIndex;		// trace model used for collision detection
 	int						renderModelHandle;		// render model def handle
 
-	struct clipLink_s *		clipLinks;				// links into sectors
+	struct clipLink_s *		clipLinks;				// links into sectors or a single cell
 	int						touchCount;
 
 	void					Init( void );			// initialize
 	void					Link_r( struct clipSector_s *node );
+	void					Link_Cell( struct clipCell_s *cell );
 
 	static int				AllocTraceModel( const idTraceModel &trm );
 	static void				FreeTraceModel( int traceModelIndex );
@@ -314,6 +316,10 @@ public:
 private:
 	int						numClipSectors;
 	struct clipSector_s *	clipSectors;
+	int						numClipLevels;			// levels of the spatial hash, 0 when the sector tree is used
+	struct clipLevel_s *	clipLevels;
+	idList<struct clipCell_s *>	clipCells;
+	idHashIndex				clipCellHash;
 	idBounds				worldBounds;
 	idClipModel				temporaryClipModel;
 	idClipModel				defaultClipModel;
@@ -325,10 +331,18 @@ private:
 	int						numRenderModelTraces;
 	int						numContents;
 	int						numContacts;
+	mutable int				numTouchQueries;
+	mutable int				numTouchTests;
+	int						numLinks;
+	int						numLinksKept;
 
 private:
 	struct clipSector_s *	CreateClipSectors_r( const int depth, const idBounds &bounds, idVec3 &maxSector );
+	void					CreateClipLevels( void );
+	struct clipCell_s *		GetClipCell( const idBounds &absBounds );
 	void					ClipModelsTouchingBounds_r( const struct clipSector_s *node, struct listParms_s &parms ) const;
+	void					ClipModelsTouchingCells( struct listParms_s &parms ) const;
+	void					ClipModelsTouchingLinks( const struct clipLink_s *links, struct listParms_s &parms ) const;
 	const idTraceModel *	TraceModelForClipModel( const idClipModel *mdl ) const;
 	int						GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const;
 	void					TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const;
@@ -715,20 +715,83 @@ void idInterpreter::LeaveFunction( idVarDef *returnDef ) {
 	}
 }
 
+/*
+================
+idInterpreter::GetEventArgs
+
+Converts the event parms on the stack for the event callback, at the offsets
+bound by function_t::BindEvent.  Terminates the thread and returns false when
+an entity parm doesn't exist.
+================
+*/
+bool idInterpreter::GetEventArgs( const function_t *func, int start, int argsize, intptr_t *data ) {
+	const idEventDef	*evdef;
+	const eventParm_t	*parm;
+	varEval_t			var;
+	int					i;
+
+	evdef = func->eventdef;
+	if ( argsize > func->parmTotal ) {
+		Error( "Invalid arg format string for '%s' event.", evdef->GetName() );
+	}
+
+	parm = func->eventParms.Ptr();
+	for( i = 0; i < func->eventParms.Num(); i++, parm++ ) {
+		var.bytePtr = &localstack[ start + parm->stackOffset ];
+		switch( parm->type ) {
+		case D_EVENT_INTEGER :
+			( *( int * )&data[ i ] ) = int( *var.floatPtr );
+			break;
+
+		case D_EVENT_FLOAT :
+			( *( float * )&data[ i ] ) = *var.floatPtr;
+			break;
+
+		case D_EVENT_VECTOR :
+			( *( idVec3 ** )&data[ i ] ) = var.vectorPtr;
+			break;
+
+		case D_EVENT_STRING :
+			( *( const char ** )&data[ i ] ) = var.stringPtr;
+			break;
+
+		case D_EVENT_ENTITY :
+			( *( idEntity ** )&data[ i ] ) = GetEntity( *var.entityNumberPtr );
+			if ( !( *( idEntity ** )&data[ i ] ) ) {
+				Warning( "Entity not found for event '%s'. Terminating thread.", evdef->GetName() );
+				threadDying = true;
+				return false;
+			}
+			break;
+
+		case D_EVENT_ENTITY_NULL :
+			( *( idEntity ** )&data[ i ] ) = GetEntity( *var.entityNumberPtr );
+			break;
+
+		case D_EVENT_TRACE :
+			Error( "trace type not supported from script for '%s' event.", evdef->GetName() );
+			break;
+
+		default :
+			Error( "Invalid arg format string for '%s' event.", evdef->GetName() );
+			break;
+		}
+	}
+
+	return true;
+}
+
 /*
 ================
 idInterpreter::CallEvent
 ================
 */
 void idInterpreter::CallEvent( const function_t *func, int argsize ) {
-	int					i;
-	int					j;
 	varEval_t			var;
-	int					pos;
 	int					start;
 	intptr_t			data[ D_EVENT_MAXARGS ];
 	const idEventDef	*evdef;
-	const char			*format;
+	eventCallback_t		callback;
 
 	if ( !func ) {
 		Error( "NULL function" );
@@ -741,7 +804,14 @@ void idInterpreter::CallEvent( const function_t *func, int argsize ) {
 	var.intPtr = ( int * )&localstack[ start ];
 	eventEntity = GetEntity( *var.entityNumberPtr );
 
-	if ( !eventEntity || !eventEntity->RespondsTo( *evdef ) ) {
+	// look the callback up once instead of RespondsTo and ProcessEventArgPtr both doing it
+	callback = NULL;
+	if ( eventEntity ) {
+		assert( idEvent::initialized );
+		callback = eventEntity->GetType()->eventMap[ evdef->GetEventNum() ];
+	}
+
+	if ( !callback ) {
 		if ( eventEntity && developer.GetBool() ) {
 			// give a warning in developer mode
 			Warning( "Function '%s' not supported on entity '%s'", evdef->GetName(), eventEntity->name.c_str() );
@@ -780,58 +850,13 @@ void idInterpreter::CallEvent( const function_t *func, int argsize ) {
 		return;
 	}
 
-	format = evdef->GetArgFormat();
-	for( j = 0, i = 0, pos = type_object.Size(); ( pos < argsize ) || ( format[ i ] != 0 ); i++ ) {
-		switch( format[ i ] ) {
-		case D_EVENT_INTEGER :
-			var.intPtr = ( int * )&localstack[ start + pos ];
-			( *( int * )&data[ i ] ) = int( *var.floatPtr );
-			break;
-
-		case D_EVENT_FLOAT :
-			var.intPtr = ( int * )&localstack[ start + pos ];
-			( *( float * )&data[ i ] ) = *var.floatPtr;
-			break;
-
-		case D_EVENT_VECTOR :
-			var.intPtr = ( int * )&localstack[ start + pos ];
-			( *( idVec3 ** )&data[ i ] ) = var.vectorPtr;
-			break;
-
-		case D_EVENT_STRING :
-			( *( const char ** )&data[ i ] ) = ( char * )&localstack[ start + pos ];
-			break;
-
-		case D_EVENT_ENTITY :
-			var.intPtr = ( int * )&localstack[ start + pos ];
-			( *( idEntity ** )&data[ i ] ) = GetEntity( *var.entityNumberPtr );
-			if ( !( *( idEntity ** )&data[ i ] ) ) {
-				Warning( "Entity not found for event '%s'. Terminating thread.", evdef->GetName() );
-				threadDying = true;
-				PopParms( argsize );
-				return;
-			}
-			break;
-
-		case D_EVENT_ENTITY_NULL :
-			var.intPtr = ( int * )&localstack[ start + pos ];
-			( *( idEntity ** )&data[ i ] ) = GetEntity( *var.entityNumberPtr );
-			break;
-
-		case D_EVENT_TRACE :
-			Error( "trace type not supported from script for '%s' event.", evdef->GetName() );
-			break;
-
-		default :
-			Error( "Invalid arg format string for '%s' event.", evdef->GetName() );
-			break;
-		}
-
-		pos += func->parmSize[ j++ ];
+	if ( !GetEventArgs( func, start + type_object.Size(), argsize - type_object.Size(), data ) ) {
+		PopParms( argsize );
+		return;
 	}
 
 	popParms = argsize;
-	eventEntity->ProcessEventArgPtr( evdef, data );
+	eventEntity->ProcessEventCallback( evdef, callback, data );
 
 	if ( !multiFrameEvent ) {
 		if ( popParms ) {
@@ -892,14 +917,10 @@ idInterpreter::CallSysEvent
 ================
 */
 void idInterpreter::CallSysEvent( const function_t *func, int argsize ) {
-	int					i;
-	int					j;
-	varEval_t			source;
-	int					pos;
 	int					start;
 	intptr_t			data[ D_EVENT_MAXARGS ];
 	const idEventDef	*evdef;
-	const char			*format;
+	eventCallback_t		callback;
 
 	if ( !func ) {
 		Error( "NULL function" );
@@ -910,58 +931,16 @@ void idInterpreter::CallSysEvent( const function_t *func, int argsize ) {
 
 	start = localstackUsed - argsize;
 
-	format = evdef->GetArgFormat();
-	for( j = 0, i = 0, pos = 0; ( pos < argsize ) || ( format[ i ] != 0 ); i++ ) {
-		switch( format[ i ] ) {
-		case D_EVENT_INTEGER :
-			source.intPtr = ( int * )&localstack[ start + pos ];
-			*( int * )&data[ i ] = int( *source.floatPtr );
-			break;
-
-		case D_EVENT_FLOAT :
-			source.intPtr = ( int * )&localstack[ start + pos ];
-			*( float * )&data[ i ] = *source.floatPtr;
-			break;
-
-		case D_EVENT_VECTOR :
-			source.intPtr = ( int * )&localstack[ start + pos ];
-			*( idVec3 ** )&data[ i ] = source.vectorPtr;
-			break;
-
-		case D_EVENT_STRING :
-			*( const char ** )&data[ i ] = ( char * )&localstack[ start + pos ];
-			break;
-
-		case D_EVENT_ENTITY :
-			source.intPtr = ( int * )&localstack[ start + pos ];
-			*( idEntity ** )&data[ i ] = GetEntity( *source.entityNumberPtr );
-			if ( !*( idEntity ** )&data[ i ] ) {
-				Warning( "Entity not found for event '%s'. Terminating thread.", evdef->GetName() );
-				threadDying = true;
-				PopParms( argsize );
-				return;
-			}
-			break;
-
-		case D_EVENT_ENTITY_NULL :
-			source.intPtr = ( int * )&localstack[ start + pos ];
-			*( idEntity ** )&data[ i ] = GetEntity( *source.entityNumberPtr );
-			break;
-
-		case D_EVENT_TRACE :
-			Error( "trace type not supported from script for '%s' event.", evdef->GetName() );
-			break;
-
-		default :
-			Error( "Invalid arg format string for '%s' event.", evdef->GetName() );
-			break;
-		}
-
-		pos += func->parmSize[ j++ ];
+	if ( !GetEventArgs( func, start, argsize, data ) ) {
+		PopParms( argsize );
+		return;
 	}
 
 	popParms = argsize;
-	thread->ProcessEventArgPtr( evdef, data );
+	callback = thread->GetType()->eventMap[ evdef->GetEventNum() ];
+	if ( callback ) {
+		thread->ProcessEventCallback( evdef, callback, data );
+	}
 	if ( popParms ) {
 		PopParms( popParms );
 	}
@@ -985,6 +964,10 @@ bool idInterpreter::Execute( void ) {
 	idScriptObject *obj;
 	const function_t *func;
 
+	if ( g_scriptDecode.GetInteger() && !g_debugScript.GetBool() ) {
+		return ExecuteDecoded();
+	}
+
 	if ( threadDying || !currentFunction ) {
 		return true;
 	}
@@ -1885,6 +1868,1236 @@ bool idInterpreter::Execute( void ) {
 	return threadDying;
 }
 
+/*
+===============================================================================
+
+	Decoded statements
+
+	With g_scriptDecode set Execute runs the decoded statements of the program
+	instead of the compiled statements.  The operands are already resolved so
+	only local variables need the stack base added, and a comparison that is
+	only tested by the next OP_IFNOT runs as one superinstruction.  Each handler
+	does what the matching case of Execute does.  GCC and clang jump from each
+	handler directly to the next one with computed goto, other compilers use a
+	switch.  g_scriptDecode 2 checks every statement against the compiled
+	statement before it's executed.  The debugger is updated for every
+	statement like in Execute until it reports that it isn't active.
+
+===============================================================================
+*/
+
+#if defined( __GNUC__ )
+#define ID_SCRIPT_COMPUTED_GOTO		1
+#else
+#define ID_SCRIPT_COMPUTED_GOTO		0
+#endif
+
+/*
+====================
+idInterpreter::CheckDecodedStatement
+====================
+*/
+void idInterpreter::CheckDecodedStatement( int index ) {
+	decodedStatement_t			check;
+	const decodedStatement_t	*ds;
+	statement_t					*st;
+
+	ds = &gameLocal.program.GetDecodedStatements()[ index ];
+	st = &gameLocal.program.GetStatement( index );
+
+	gameLocal.program.DecodeStatement( index, check );
+	if ( ds->op != check.op || ds->stack != check.stack ) {
+		Error( "decoded statement %d is out of date", index );
+	}
+	if ( ( st->a && GetVariable( st->a ).bytePtr != GetDecodedVariable( ds->a, ds->stack & DECODED_STACK_A ).bytePtr ) ||
+		( st->b && GetVariable( st->b ).bytePtr != GetDecodedVariable( ds->b, ds->stack & DECODED_STACK_B ).bytePtr ) ||
+		( st->c && GetVariable( st->c ).bytePtr != GetDecodedVariable( ds->c, ds->stack & DECODED_STACK_C ).bytePtr ) ) {
+		Error( "decoded operands of statement %d don't match", index );
+	}
+}
+
+#define DECODED_A	GetDecodedVariable( ds->a, ds->stack & DECODED_STACK_A )
+#define DECODED_B	GetDecodedVariable( ds->b, ds->stack & DECODED_STACK_B )
+#define DECODED_C	GetDecodedVariable( ds->c, ds->stack & DECODED_STACK_C )
+
+// lets an attached debugger check for breakpoints
+#define DECODED_DEBUGGER								\
+	if ( debugger ) {									\
+		debugger = updateGameDebugger( this, &gameLocal.program, instructionPointer );	\
+	}
+
+// moves to the next statement like the loop in Execute
+#define DECODED_FETCH									\
+	if ( doneProcessing || threadDying ) {				\
+		goto done;										\
+	}													\
+	instructionPointer++;								\
+	if ( !--runaway ) {									\
+		Error( "runaway loop error" );					\
+	}													\
+	DECODED_DEBUGGER									\
+	ds = &decoded[ instructionPointer ];				\
+	if ( check ) {										\
+		CheckDecodedStatement( instructionPointer );	\
+	}
+
+// the OP_IFNOT after the comparison of a superinstruction
+#define DECODED_IFNOT( value )							\
+	if ( !--runaway ) {									\
+		Error( "runaway loop error" );					\
+	}													\
+	instructionPointer++;								\
+	DECODED_DEBUGGER									\
+	if ( check ) {										\
+		CheckDecodedStatement( instructionPointer );	\
+	}													\
+	if ( ( value ) == 0 ) {								\
+		NextInstruction( instructionPointer + decoded[ instructionPointer ].b.jumpOffset );	\
+	}
+
+#if ID_SCRIPT_COMPUTED_GOTO
+#define DECODED_CASE( op )		op_##op:
+#define DECODED_NEXT			DECODED_FETCH goto *dispatchTable[ ds->op ]
+#define DECODED_LABEL( op )		dispatchTable[ op ] = &&op_##op
+#else
+#define DECODED_CASE( op )		case op:
+#define DECODED_NEXT			continue
+#endif
+
+/*
+====================
+idInterpreter::ExecuteDecoded
+====================
+*/
+bool idInterpreter::ExecuteDecoded( void ) {
+	varEval_t	var_a;
+	varEval_t	var_b;
+	varEval_t	var_c;
+	varEval_t	var;
+	const decodedStatement_t *decoded;
+	const decodedStatement_t *ds;
+	int			runaway;
+	bool		check;
+	bool		debugger;
+	idThread	*newThread;
+	float		floatVal;
+	idScriptObject *obj;
+	const function_t *func;
+
+	if ( threadDying || !currentFunction ) {
+		return true;
+	}
+
+	if ( multiFrameEvent ) {
+		// move to previous instruction and call it again
+		instructionPointer--;
+	}
+
+	runaway = 5000000;
+	check = ( g_scriptDecode.GetInteger() == 2 );
+	debugger = true;
+
+	// statements are never compiled while a script runs, so this stays valid
+	decoded = gameLocal.program.GetDecodedStatements();
+
+#if ID_SCRIPT_COMPUTED_GOTO
+	static void *dispatchTable[ NUM_DECODED_OPCODES ];
+	if ( !dispatchTable[ OP_RETURN ] ) {
+		for( int i = 0; i < NUM_DECODED_OPCODES; i++ ) {
+			dispatchTable[ i ] = &&op_bad;
+		}
+		DECODED_LABEL( OP_RETURN );
+		DECODED_LABEL( OP_THREAD );
+		DECODED_LABEL( OP_OBJTHREAD );
+		DECODED_LABEL( OP_CALL );
+		DECODED_LABEL( OP_EVENTCALL );
+		DECODED_LABEL( OP_OBJECTCALL );
+		DECODED_LABEL( OP_SYSCALL );
+		DECODED_LABEL( OP_IFNOT );
+		DECODED_LABEL( OP_IF );
+		DECODED_LABEL( OP_GOTO );
+		DECODED_LABEL( OP_ADD_F );
+		DECODED_LABEL( OP_ADD_V );
+		DECODED_LABEL( OP_ADD_S );
+		DECODED_LABEL( OP_ADD_FS );
+		DECODED_LABEL( OP_ADD_SF );
+		DECODED_LABEL( OP_ADD_VS );
+		DECODED_LABEL( OP_ADD_SV );
+		DECODED_LABEL( OP_SUB_F );
+		DECODED_LABEL( OP_SUB_V );
+		DECODED_LABEL( OP_MUL_F );
+		DECODED_LABEL( OP_MUL_V );
+		DECODED_LABEL( OP_MUL_FV );
+		DECODED_LABEL( OP_MUL_VF );
+		DECODED_LABEL( OP_DIV_F );
+		DECODED_LABEL( OP_MOD_F );
+		DECODED_LABEL( OP_BITAND );
+		DECODED_LABEL( OP_BITOR );
+		DECODED_LABEL( OP_GE );
+		DECODED_LABEL( OP_LE );
+		DECODED_LABEL( OP_GT );
+		DECODED_LABEL( OP_LT );
+		DECODED_LABEL( OP_AND );
+		DECODED_LABEL( OP_AND_BOOLF );
+		DECODED_LABEL( OP_AND_FBOOL );
+		DECODED_LABEL( OP_AND_BOOLBOOL );
+		DECODED_LABEL( OP_OR );
+		DECODED_LABEL( OP_OR_BOOLF );
+		DECODED_LABEL( OP_OR_FBOOL );
+		DECODED_LABEL( OP_OR_BOOLBOOL );
+		DECODED_LABEL( OP_NOT_BOOL );
+		DECODED_LABEL( OP_NOT_F );
+		DECODED_LABEL( OP_NOT_V );
+		DECODED_LABEL( OP_NOT_S );
+		DECODED_LABEL( OP_NOT_ENT );
+		DECODED_LABEL( OP_NEG_F );
+		DECODED_LABEL( OP_NEG_V );
+		DECODED_LABEL( OP_INT_F );
+		DECODED_LABEL( OP_EQ_F );
+		DECODED_LABEL( OP_EQ_V );
+		DECODED_LABEL( OP_EQ_S );
+		DECODED_LABEL( OP_EQ_E );
+		DECODED_LABEL( OP_EQ_EO );
+		DECODED_LABEL( OP_EQ_OE );
+		DECODED_LABEL( OP_EQ_OO );
+		DECODED_LABEL( OP_NE_F );
+		DECODED_LABEL( OP_NE_V );
+		DECODED_LABEL( OP_NE_S );
+		DECODED_LABEL( OP_NE_E );
+		DECODED_LABEL( OP_NE_EO );
+		DECODED_LABEL( OP_NE_OE );
+		DECODED_LABEL( OP_NE_OO );
+		DECODED_LABEL( OP_UADD_F );
+		DECODED_LABEL( OP_UADD_V );
+		DECODED_LABEL( OP_USUB_F );
+		DECODED_LABEL( OP_USUB_V );
+		DECODED_LABEL( OP_UMUL_F );
+		DECODED_LABEL( OP_UMUL_V );
+		DECODED_LABEL( OP_UDIV_F );
+		DECODED_LABEL( OP_UDIV_V );
+		DECODED_LABEL( OP_UMOD_F );
+		DECODED_LABEL( OP_UOR_F );
+		DECODED_LABEL( OP_UAND_F );
+		DECODED_LABEL( OP_UINC_F );
+		DECODED_LABEL( OP_UINCP_F );
+		DECODED_LABEL( OP_UDEC_F );
+		DECODED_LABEL( OP_UDECP_F );
+		DECODED_LABEL( OP_COMP_F );
+		DECODED_LABEL( OP_STORE_F );
+		DECODED_LABEL( OP_STORE_ENT );
+		DECODED_LABEL( OP_STORE_BOOL );
+		DECODED_LABEL( OP_STORE_OBJENT );
+		DECODED_LABEL( OP_STORE_OBJ );
+		DECODED_LABEL( OP_STORE_ENTOBJ );
+		DECODED_LABEL( OP_STORE_S );
+		DECODED_LABEL( OP_STORE_V );
+		DECODED_LABEL( OP_STORE_FTOS );
+		DECODED_LABEL( OP_STORE_BTOS );
+		DECODED_LABEL( OP_STORE_VTOS );
+		DECODED_LABEL( OP_STORE_FTOBOOL );
+		DECODED_LABEL( OP_STORE_BOOLTOF );
+		DECODED_LABEL( OP_STOREP_F );
+		DECODED_LABEL( OP_STOREP_ENT );
+		DECODED_LABEL( OP_STOREP_FLD );
+		DECODED_LABEL( OP_STOREP_BOOL );
+		DECODED_LABEL( OP_STOREP_S );
+		DECODED_LABEL( OP_STOREP_V );
+		DECODED_LABEL( OP_STOREP_FTOS );
+		DECODED_LABEL( OP_STOREP_BTOS );
+		DECODED_LABEL( OP_STOREP_VTOS );
+		DECODED_LABEL( OP_STOREP_FTOBOOL );
+		DECODED_LABEL( OP_STOREP_BOOLTOF );
+		DECODED_LABEL( OP_STOREP_OBJ );
+		DECODED_LABEL( OP_STOREP_OBJENT );
+		DECODED_LABEL( OP_ADDRESS );
+		DECODED_LABEL( OP_INDIRECT_F );
+		DECODED_LABEL( OP_INDIRECT_ENT );
+		DECODED_LABEL( OP_INDIRECT_BOOL );
+		DECODED_LABEL( OP_INDIRECT_S );
+		DECODED_LABEL( OP_INDIRECT_V );
+		DECODED_LABEL( OP_INDIRECT_OBJ );
+		DECODED_LABEL( OP_PUSH_F );
+		DECODED_LABEL( OP_PUSH_FTOS );
+		DECODED_LABEL( OP_PUSH_BTOF );
+		DECODED_LABEL( OP_PUSH_FTOB );
+		DECODED_LABEL( OP_PUSH_VTOS );
+		DECODED_LABEL( OP_PUSH_BTOS );
+		DECODED_LABEL( OP_PUSH_ENT );
+		DECODED_LABEL( OP_PUSH_S );
+		DECODED_LABEL( OP_PUSH_V );
+		DECODED_LABEL( OP_PUSH_OBJ );
+		DECODED_LABEL( OP_PUSH_OBJENT );
+		DECODED_LABEL( OP_LT_IFNOT );
+		DECODED_LABEL( OP_LE_IFNOT );
+		DECODED_LABEL( OP_GT_IFNOT );
+		DECODED_LABEL( OP_GE_IFNOT );
+		DECODED_LABEL( OP_EQ_F_IFNOT );
+		DECODED_LABEL( OP_NE_F_IFNOT );
+		DECODED_LABEL( OP_EQ_E_IFNOT );
+		DECODED_LABEL( OP_NE_E_IFNOT );
+		DECODED_LABEL( OP_NOT_BOOL_IFNOT );
+		DECODED_LABEL( OP_NOT_F_IFNOT );
+	}
+#endif
+
+	doneProcessing = false;
+
+#if ID_SCRIPT_COMPUTED_GOTO
+	DECODED_NEXT;
+	{
+#else
+	for( ;; ) {
+		DECODED_FETCH
+
+		switch( ds->op ) {
+#endif
+		DECODED_CASE( OP_RETURN )
+			LeaveFunction( gameLocal.program.GetStatement( instructionPointer ).a );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_THREAD )
+			newThread = new idThread( this, ds->a.functionPtr, ds->b.argSize );
+			newThread->Start();
+
+			// return the thread number to the script
+			gameLocal.program.ReturnFloat( newThread->GetThreadNum() );
+			PopParms( ds->b.argSize );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_OBJTHREAD )
+			var_a = DECODED_A;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( obj ) {
+				func = obj->GetTypeDef()->GetFunction( ds->b.virtualFunction );
+				assert( ds->c.argSize == func->parmTotal );
+				newThread = new idThread( this, GetEntity( *var_a.entityNumberPtr ), func, func->parmTotal );
+				newThread->Start();
+
+				// return the thread number to the script
+				gameLocal.program.ReturnFloat( newThread->GetThreadNum() );
+			} else {
+				// return a null thread to the script
+				gameLocal.program.ReturnFloat( 0.0f );
+			}
+			PopParms( ds->c.argSize );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_CALL )
+			EnterFunction( ds->a.functionPtr, false );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_EVENTCALL )
+			CallEvent( ds->a.functionPtr, ds->b.argSize );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_OBJECTCALL )
+			var_a = DECODED_A;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( obj ) {
+				func = obj->GetTypeDef()->GetFunction( ds->b.virtualFunction );
+				EnterFunction( func, false );
+			} else {
+				// return a 'safe' value
+				gameLocal.program.ReturnVector( vec3_zero );
+				gameLocal.program.ReturnString( "" );
+				PopParms( ds->c.argSize );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_SYSCALL )
+			CallSysEvent( ds->a.functionPtr, ds->b.argSize );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_IFNOT )
+			var_a = DECODED_A;
+			if ( *var_a.intPtr == 0 ) {
+				NextInstruction( instructionPointer + ds->b.jumpOffset );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_IF )
+			var_a = DECODED_A;
+			if ( *var_a.intPtr != 0 ) {
+				NextInstruction( instructionPointer + ds->b.jumpOffset );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_GOTO )
+			NextInstruction( instructionPointer + ds->a.jumpOffset );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_ADD_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = *var_a.floatPtr + *var_b.floatPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_ADD_V )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_ADD_S )
+			idStr::Copynz( DECODED_C.stringPtr, DECODED_A.stringPtr, MAX_STRING_LEN );
+			idStr::Append( DECODED_C.stringPtr, MAX_STRING_LEN, DECODED_B.stringPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_ADD_FS )
+			var_a = DECODED_A;
+			idStr::Copynz( DECODED_C.stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
+			idStr::Append( DECODED_C.stringPtr, MAX_STRING_LEN, DECODED_B.stringPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_ADD_SF )
+			var_b = DECODED_B;
+			idStr::Copynz( DECODED_C.stringPtr, DECODED_A.stringPtr, MAX_STRING_LEN );
+			idStr::Append( DECODED_C.stringPtr, MAX_STRING_LEN, FloatToString( *var_b.floatPtr ) );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_ADD_VS )
+			var_a = DECODED_A;
+			idStr::Copynz( DECODED_C.stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
+			idStr::Append( DECODED_C.stringPtr, MAX_STRING_LEN, DECODED_B.stringPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_ADD_SV )
+			var_b = DECODED_B;
+			idStr::Copynz( DECODED_C.stringPtr, DECODED_A.stringPtr, MAX_STRING_LEN );
+			idStr::Append( DECODED_C.stringPtr, MAX_STRING_LEN, var_b.vectorPtr->ToString() );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_SUB_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = *var_a.floatPtr - *var_b.floatPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_SUB_V )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.vectorPtr = *var_a.vectorPtr - *var_b.vectorPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_MUL_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = *var_a.floatPtr * *var_b.floatPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_MUL_V )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = *var_a.vectorPtr * *var_b.vectorPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_MUL_FV )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.vectorPtr = *var_a.floatPtr * *var_b.vectorPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_MUL_VF )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.vectorPtr = *var_a.vectorPtr * *var_b.floatPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_DIV_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+
+			if ( *var_b.floatPtr == 0.0f ) {
+				Warning( "Divide by zero" );
+				*var_c.floatPtr = idMath::INFINITY;
+			} else {
+				*var_c.floatPtr = *var_a.floatPtr / *var_b.floatPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_MOD_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+
+			if ( *var_b.floatPtr == 0.0f ) {
+				Warning( "Divide by zero" );
+				*var_c.floatPtr = *var_a.floatPtr;
+			} else {
+				*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) % static_cast<int>( *var_b.floatPtr );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_BITAND )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) & static_cast<int>( *var_b.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_BITOR )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) | static_cast<int>( *var_b.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_GE )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_LE )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_GT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_LT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_AND )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.floatPtr != 0.0f );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_AND_BOOLF )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.floatPtr != 0.0f );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_AND_FBOOL )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.intPtr != 0 );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_AND_BOOLBOOL )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.intPtr != 0 );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_OR )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.floatPtr != 0.0f );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_OR_BOOLF )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.floatPtr != 0.0f );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_OR_FBOOL )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.intPtr != 0 );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_OR_BOOLBOOL )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.intPtr != 0 );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NOT_BOOL )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.intPtr == 0 );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NOT_F )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NOT_V )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.vectorPtr == vec3_zero );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NOT_S )
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( strlen( DECODED_A.stringPtr ) == 0 );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NOT_ENT )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( GetEntity( *var_a.entityNumberPtr ) == NULL );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NEG_F )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			*var_c.floatPtr = -*var_a.floatPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NEG_V )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			*var_c.vectorPtr = -*var_a.vectorPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_INT_F )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_EQ_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_EQ_V )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.vectorPtr == *var_b.vectorPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_EQ_S )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( idStr::Cmp( DECODED_A.stringPtr, DECODED_B.stringPtr ) == 0 );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_EQ_E )
+		DECODED_CASE( OP_EQ_EO )
+		DECODED_CASE( OP_EQ_OE )
+		DECODED_CASE( OP_EQ_OO )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NE_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NE_V )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.vectorPtr != *var_b.vectorPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NE_S )
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( idStr::Cmp( DECODED_A.stringPtr, DECODED_B.stringPtr ) != 0 );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NE_E )
+		DECODED_CASE( OP_NE_EO )
+		DECODED_CASE( OP_NE_OE )
+		DECODED_CASE( OP_NE_OO )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UADD_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.floatPtr += *var_a.floatPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UADD_V )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.vectorPtr += *var_a.vectorPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_USUB_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.floatPtr -= *var_a.floatPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_USUB_V )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.vectorPtr -= *var_a.vectorPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UMUL_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.floatPtr *= *var_a.floatPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UMUL_V )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.vectorPtr *= *var_a.floatPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UDIV_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+
+			if ( *var_a.floatPtr == 0.0f ) {
+				Warning( "Divide by zero" );
+				*var_b.floatPtr = idMath::INFINITY;
+			} else {
+				*var_b.floatPtr = *var_b.floatPtr / *var_a.floatPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UDIV_V )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+
+			if ( *var_a.floatPtr == 0.0f ) {
+				Warning( "Divide by zero" );
+				var_b.vectorPtr->Set( idMath::INFINITY, idMath::INFINITY, idMath::INFINITY );
+			} else {
+				*var_b.vectorPtr = *var_b.vectorPtr / *var_a.floatPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UMOD_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+
+			if ( *var_a.floatPtr == 0.0f ) {
+				Warning( "Divide by zero" );
+				*var_b.floatPtr = *var_a.floatPtr;
+			} else {
+				*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) % static_cast<int>( *var_a.floatPtr );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UOR_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) | static_cast<int>( *var_a.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UAND_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) & static_cast<int>( *var_a.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UINC_F )
+			var_a = DECODED_A;
+			( *var_a.floatPtr )++;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UINCP_F )
+			var_a = DECODED_A;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( obj ) {
+				var.bytePtr = &obj->data[ ds->b.ptrOffset ];
+				( *var.floatPtr )++;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UDEC_F )
+			var_a = DECODED_A;
+			( *var_a.floatPtr )--;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_UDECP_F )
+			var_a = DECODED_A;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( obj ) {
+				var.bytePtr = &obj->data[ ds->b.ptrOffset ];
+				( *var.floatPtr )--;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_COMP_F )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ~static_cast<int>( *var_a.floatPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_F )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.floatPtr = *var_a.floatPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_ENT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_BOOL )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.intPtr = *var_a.intPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_OBJENT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( !obj ) {
+				*var_b.entityNumberPtr = 0;
+			} else if ( !obj->GetTypeDef()->Inherits( gameLocal.program.GetStatement( instructionPointer ).b->TypeDef() ) ) {
+				//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), st->b->TypeDef()->Name() );
+				*var_b.entityNumberPtr = 0;
+			} else {
+				*var_b.entityNumberPtr = *var_a.entityNumberPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_OBJ )
+		DECODED_CASE( OP_STORE_ENTOBJ )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_S )
+			idStr::Copynz( DECODED_B.stringPtr, DECODED_A.stringPtr, MAX_STRING_LEN );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_V )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.vectorPtr = *var_a.vectorPtr;
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_FTOS )
+			var_a = DECODED_A;
+			idStr::Copynz( DECODED_B.stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_BTOS )
+			var_a = DECODED_A;
+			idStr::Copynz( DECODED_B.stringPtr, *var_a.intPtr ? "true" : "false", MAX_STRING_LEN );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_VTOS )
+			var_a = DECODED_A;
+			idStr::Copynz( DECODED_B.stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_FTOBOOL )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			if ( *var_a.floatPtr != 0.0f ) {
+				*var_b.intPtr = 1;
+			} else {
+				*var_b.intPtr = 0;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STORE_BOOLTOF )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			*var_b.floatPtr = static_cast<float>( *var_a.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_F )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
+				var_a = DECODED_A;
+				*var_b.evalPtr->floatPtr = *var_a.floatPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_ENT )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
+				var_a = DECODED_A;
+				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_FLD )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
+				var_a = DECODED_A;
+				*var_b.evalPtr->intPtr = *var_a.intPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_BOOL )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
+				var_a = DECODED_A;
+				*var_b.evalPtr->intPtr = *var_a.intPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_S )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
+				idStr::Copynz( var_b.evalPtr->stringPtr, DECODED_A.stringPtr, MAX_STRING_LEN );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_V )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->vectorPtr ) {
+				var_a = DECODED_A;
+				*var_b.evalPtr->vectorPtr = *var_a.vectorPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_FTOS )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
+				var_a = DECODED_A;
+				idStr::Copynz( var_b.evalPtr->stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_BTOS )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
+				var_a = DECODED_A;
+				if ( *var_a.floatPtr != 0.0f ) {
+					idStr::Copynz( var_b.evalPtr->stringPtr, "true", MAX_STRING_LEN );
+				} else {
+					idStr::Copynz( var_b.evalPtr->stringPtr, "false", MAX_STRING_LEN );
+				}
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_VTOS )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
+				var_a = DECODED_A;
+				idStr::Copynz( var_b.evalPtr->stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_FTOBOOL )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
+				var_a = DECODED_A;
+				if ( *var_a.floatPtr != 0.0f ) {
+					*var_b.evalPtr->intPtr = 1;
+				} else {
+					*var_b.evalPtr->intPtr = 0;
+				}
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_BOOLTOF )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
+				var_a = DECODED_A;
+				*var_b.evalPtr->floatPtr = static_cast<float>( *var_a.intPtr );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_OBJ )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
+				var_a = DECODED_A;
+				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_STOREP_OBJENT )
+			var_b = DECODED_B;
+			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
+				var_a = DECODED_A;
+				obj = GetScriptObject( *var_a.entityNumberPtr );
+				if ( !obj ) {
+					*var_b.evalPtr->entityNumberPtr = 0;
+
+				// st->b points to type_pointer, which is just a temporary that gets its type reassigned, so we store the real type in st->c
+				// so that we can do a type check during run time since we don't know what type the script object is at compile time because it
+				// comes from an entity
+				} else if ( !obj->GetTypeDef()->Inherits( gameLocal.program.GetStatement( instructionPointer ).c->TypeDef() ) ) {
+					//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), st->c->TypeDef()->Name() );
+					*var_b.evalPtr->entityNumberPtr = 0;
+				} else {
+					*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
+				}
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_ADDRESS )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( obj ) {
+				var_c.evalPtr->bytePtr = &obj->data[ ds->b.ptrOffset ];
+			} else {
+				var_c.evalPtr->bytePtr = NULL;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_INDIRECT_F )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( obj ) {
+				var.bytePtr = &obj->data[ ds->b.ptrOffset ];
+				*var_c.floatPtr = *var.floatPtr;
+			} else {
+				*var_c.floatPtr = 0.0f;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_INDIRECT_ENT )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( obj ) {
+				var.bytePtr = &obj->data[ ds->b.ptrOffset ];
+				*var_c.entityNumberPtr = *var.entityNumberPtr;
+			} else {
+				*var_c.entityNumberPtr = 0;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_INDIRECT_BOOL )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( obj ) {
+				var.bytePtr = &obj->data[ ds->b.ptrOffset ];
+				*var_c.intPtr = *var.intPtr;
+			} else {
+				*var_c.intPtr = 0;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_INDIRECT_S )
+			var_a = DECODED_A;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( obj ) {
+				var.bytePtr = &obj->data[ ds->b.ptrOffset ];
+				idStr::Copynz( DECODED_C.stringPtr, var.stringPtr, MAX_STRING_LEN );
+			} else {
+				idStr::Copynz( DECODED_C.stringPtr, "", MAX_STRING_LEN );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_INDIRECT_V )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( obj ) {
+				var.bytePtr = &obj->data[ ds->b.ptrOffset ];
+				*var_c.vectorPtr = *var.vectorPtr;
+			} else {
+				var_c.vectorPtr->Zero();
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_INDIRECT_OBJ )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			obj = GetScriptObject( *var_a.entityNumberPtr );
+			if ( !obj ) {
+				*var_c.entityNumberPtr = 0;
+			} else {
+				var.bytePtr = &obj->data[ ds->b.ptrOffset ];
+				*var_c.entityNumberPtr = *var.entityNumberPtr;
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_F )
+			var_a = DECODED_A;
+			Push( *var_a.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_FTOS )
+			var_a = DECODED_A;
+			PushString( FloatToString( *var_a.floatPtr ) );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_BTOF )
+			var_a = DECODED_A;
+			floatVal = *var_a.intPtr;
+			Push( *reinterpret_cast<int *>( &floatVal ) );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_FTOB )
+			var_a = DECODED_A;
+			if ( *var_a.floatPtr != 0.0f ) {
+				Push( 1 );
+			} else {
+				Push( 0 );
+			}
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_VTOS )
+			var_a = DECODED_A;
+			PushString( var_a.vectorPtr->ToString() );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_BTOS )
+			var_a = DECODED_A;
+			PushString( *var_a.intPtr ? "true" : "false" );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_ENT )
+			var_a = DECODED_A;
+			Push( *var_a.entityNumberPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_S )
+			PushString( DECODED_A.stringPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_V )
+			var_a = DECODED_A;
+			PushVector(*var_a.vectorPtr);
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_OBJ )
+			var_a = DECODED_A;
+			Push( *var_a.entityNumberPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_PUSH_OBJENT )
+			var_a = DECODED_A;
+			Push( *var_a.entityNumberPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_LT_IFNOT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
+			DECODED_IFNOT( *var_c.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_LE_IFNOT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
+			DECODED_IFNOT( *var_c.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_GT_IFNOT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
+			DECODED_IFNOT( *var_c.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_GE_IFNOT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
+			DECODED_IFNOT( *var_c.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_EQ_F_IFNOT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
+			DECODED_IFNOT( *var_c.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NE_F_IFNOT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
+			DECODED_IFNOT( *var_c.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_EQ_E_IFNOT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
+			DECODED_IFNOT( *var_c.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NE_E_IFNOT )
+			var_a = DECODED_A;
+			var_b = DECODED_B;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
+			DECODED_IFNOT( *var_c.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NOT_BOOL_IFNOT )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.intPtr == 0 );
+			DECODED_IFNOT( *var_c.intPtr );
+			DECODED_NEXT;
+
+		DECODED_CASE( OP_NOT_F_IFNOT )
+			var_a = DECODED_A;
+			var_c = DECODED_C;
+			*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
+			DECODED_IFNOT( *var_c.intPtr );
+			DECODED_NEXT;
+
+#if ID_SCRIPT_COMPUTED_GOTO
+		op_bad:
+#else
+		default:
+#endif
+			Error( "Bad opcode %i", ds->op );
+			DECODED_NEXT;
+#if !ID_SCRIPT_COMPUTED_GOTO
+		}
+#endif
+	}
+
+done:
+	return threadDying;
+}
+
 
 bool idGameEditExt::CheckForBreakPointHit(const idInterpreter* interpreter, const function_t* function1, const function_t* function2, int depth) const
 {
@@ -73,6 +73,7 @@ private:
 	void				SetString( idVarDef *def, const char *from );
 	const char			*GetString( idVarDef *def );
 	varEval_t			GetVariable( idVarDef *def );
+	varEval_t			GetDecodedVariable( varEval_t value, int onStack );
 	idEntity			*GetEntity( int entnum ) const;
 	idScriptObject		*GetScriptObject( int entnum ) const;
 	void				NextInstruction( int position );
@@ -80,6 +81,10 @@ private:
 	void				LeaveFunction( idVarDef *returnDef );
 	void				CallEvent( const function_t *func, int argsize );
 	void				CallSysEvent( const function_t *func, int argsize );
+	bool				GetEventArgs( const function_t *func, int start, int argsize, intptr_t *data );
+
+	bool				ExecuteDecoded( void );
+	void				CheckDecodedStatement( int index );
 
 public:
 	bool				doneProcessing;
@@ -246,6 +251,18 @@ ID_INLINE varEval_t idInterpreter::GetVariable( idVarDef *def ) {
 	}
 }
 
+/*
+====================
+idInterpreter::GetDecodedVariable
+====================
+*/
+ID_INLINE varEval_t idInterpreter::GetDecodedVariable( varEval_t value, int onStack ) {
+	if ( onStack ) {
+		value.intPtr = ( int * )&localstack[ localstackBase + value.stackOffset ];
+	}
+	return value;
+}
+
 /*
 ================
 idInterpreter::GetEntity
@@ -28,7 +28,9 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "idlib/hashing/MD4.h"
+#include "idlib/Timer.h"
 #include "framework/FileSystem.h"
+#include "framework/Licensee.h"
 
 #include "gamesys/Event.h"
 #include "gamesys/SysCvar.h"
@@ -93,7 +95,7 @@ function_t::Allocated
 ================
 */
 size_t function_t::Allocated( void ) const {
-	return name.Allocated() + parmSize.Allocated();
+	return name.Allocated() + parmSize.Allocated() + eventParms.Allocated();
 }
 
 /*
@@ -130,6 +132,34 @@ void function_t::Clear( void ) {
 	filenum			= 0;
 	name.Clear();
 	parmSize.Clear();
+	eventParms.Clear();
+}
+
+/*
+================
+function_t::BindEvent
+
+Makes this the script function of the event.  The parm sizes have to be set,
+idInterpreter reads the event parms from the stack with the bound offsets.
+================
+*/
+void function_t::BindEvent( const idEventDef *ev ) {
+	const char	*format;
+	int			i;
+	int			offset;
+
+	eventdef = ev;
+
+	format = ev->GetArgFormat();
+	eventParms.SetGranularity( 1 );
+	eventParms.SetNum( ev->GetNumArgs() );
+	for( i = 0, offset = 0; i < eventParms.Num(); i++ ) {
+		eventParms[ i ].type = format[ i ];
+		eventParms[ i ].stackOffset = offset;
+		if ( i < parmSize.Num() ) {
+			offset += parmSize[ i ];
+		}
+	}
 }
 
 /***********************************************************************
@@ -1639,6 +1669,103 @@ statement_t *idProgram::AllocStatement( void ) {
 	return ret;
 }
 
+/*
+================
+Decode_Operand
+================
+*/
+static void Decode_Operand( const idVarDef *def, int stackBit, varEval_t &value, unsigned short &stack ) {
+	if ( !def ) {
+		value.bytePtr = NULL;
+	} else {
+		value = def->value;
+		if ( def->initialized == idVarDef::stackVariable ) {
+			stack |= stackBit;
+		}
+	}
+}
+
+/*
+================
+Decode_Superinstruction
+
+  returns the superinstruction for a comparison that is followed by an OP_IFNOT on its result
+================
+*/
+static int Decode_Superinstruction( const statement_t &st, const statement_t &next ) {
+	if ( next.op != OP_IFNOT || next.a != st.c || !st.c ) {
+		return st.op;
+	}
+
+	switch( st.op ) {
+	case OP_LT:			return OP_LT_IFNOT;
+	case OP_LE:			return OP_LE_IFNOT;
+	case OP_GT:			return OP_GT_IFNOT;
+	case OP_GE:			return OP_GE_IFNOT;
+	case OP_EQ_F:		return OP_EQ_F_IFNOT;
+	case OP_NE_F:		return OP_NE_F_IFNOT;
+	case OP_EQ_E:
+	case OP_EQ_EO:
+	case OP_EQ_OE:
+	case OP_EQ_OO:		return OP_EQ_E_IFNOT;
+	case OP_NE_E:
+	case OP_NE_EO:
+	case OP_NE_OE:
+	case OP_NE_OO:		return OP_NE_E_IFNOT;
+	case OP_NOT_BOOL:	return OP_NOT_BOOL_IFNOT;
+	case OP_NOT_F:		return OP_NOT_F_IFNOT;
+	default:			return st.op;
+	}
+}
+
+/*
+================
+idProgram::DecodeStatement
+
+  the OP_IFNOT of a superinstruction keeps its own decoded statement since it can be a jump target
+================
+*/
+void idProgram::DecodeStatement( int index, decodedStatement_t &ds ) const {
+	const statement_t &st = statements[ index ];
+
+	ds.op = st.op;
+	if ( index + 1 < statements.Num() ) {
+		ds.op = Decode_Superinstruction( st, statements[ index + 1 ] );
+	}
+	ds.stack = 0;
+	Decode_Operand( st.a, DECODED_STACK_A, ds.a, ds.stack );
+	Decode_Operand( st.b, DECODED_STACK_B, ds.b, ds.stack );
+	Decode_Operand( st.c, DECODED_STACK_C, ds.c, ds.stack );
+}
+
+/*
+================
+idProgram::DecodeStatements
+
+Decodes the statements compiled since the last call.  Statements are only
+appended while compiling, Restart drops the decoded statements of the map scripts.
+================
+*/
+void idProgram::DecodeStatements( void ) {
+	int i;
+	int first;
+
+	if ( decodedStatements.Num() > statements.Num() ) {
+		decodedStatements.SetNum( statements.Num(), false );
+	}
+
+	// the last statement may become a superinstruction
+	first = decodedStatements.Num() - 1;
+	if ( first < 0 ) {
+		first = 0;
+	}
+
+	decodedStatements.SetNum( statements.Num() );
+	for( i = first; i < statements.Num(); i++ ) {
+		DecodeStatement( i, decodedStatements[ i ] );
+	}
+}
+
 /*
 ==============
 idProgram::BeginCompilation
@@ -1945,6 +2072,7 @@ void idProgram::FreeData( void ) {
 	filename.Clear();
 	fileList.Clear();
 	statements.Clear();
+	decodedStatements.Clear();
 	functions.Clear();
 
 	top_functions	= 0;
@@ -1956,17 +2084,634 @@ void idProgram::FreeData( void ) {
 	filename = "";
 }
 
+/***********************************************************************
+
+  Compiled program cache
+
+  The program compiled by Startup is written to fs_savepath and loaded
+  instead of compiling the scripts again as long as none of the script
+  files changed. The defs, types, functions and statements refer to each
+  other by index in the cache.
+
+***********************************************************************/
+
+#define SCRIPT_CACHE_ID			"DSPC"
+#define SCRIPT_CACHE_VERSION	2
+#define SCRIPT_CACHE_DIR		"scriptcache/"
+
+static idTypeDef * const cacheTypes[] = {
+	&type_void, &type_scriptevent, &type_namespace, &type_string, &type_float, &type_vector, &type_entity, &type_field,
+	&type_function, &type_virtualfunction, &type_pointer, &type_object, &type_jumpoffset, &type_argsize, &type_boolean
+};
+
+static idVarDef * const cacheDefs[] = {
+	&def_void, &def_scriptevent, &def_namespace, &def_string, &def_float, &def_vector, &def_entity, &def_field,
+	&def_function, &def_virtualfunction, &def_pointer, &def_object, &def_jumpoffset, &def_argsize, &def_boolean
+};
+
+static const int NUM_CACHE_BUILTINS = sizeof( cacheTypes ) / sizeof( cacheTypes[ 0 ] );
+
+typedef enum {
+	CACHE_VALUE_INT,			// stack offset, object field offset, jump offset, arg size or virtual function
+	CACHE_VALUE_FUNCTION,
+	CACHE_VALUE_GLOBAL			// pointer into the global variables
+} cacheValue_t;
+
+/*
+================
+Cache_EventChecksum
+
+The compiled program depends on the events of the game code.
+================
+*/
+static int Cache_EventChecksum( void ) {
+	const idEventDef	*ev;
+	idStr				events;
+	int					i;
+
+	for( i = 0; i < idEventDef::NumEventCommands(); i++ ) {
+		ev = idEventDef::GetEventCommand( i );
+		events += ev->GetName();
+		events += ' ';
+		events += ev->GetArgFormat();
+		events += ' ';
+		events += ( ev->GetReturnType() ? ev->GetReturnType() : '0' );
+		events += '\n';
+	}
+
+	return MD4_BlockChecksum( events.c_str(), events.Length() );
+}
+
+/*
+================
+Cache_CompilerChecksum
+
+The compiled statements depend on the build of the game code and on the
+opcodes of the compiler.
+================
+*/
+static int Cache_CompilerChecksum( void ) {
+	const opcode_t	*op;
+	idStr			compiler;
+
+	compiler = va( "%s %d\n", ENGINE_VERSION, GAME_API_VERSION );
+	for( op = idCompiler::opcodes; op->name; op++ ) {
+		compiler += va( "%s %s %d %d %s %s %s\n", op->name, op->opname, op->priority, op->rightAssociative,
+			op->type_a->TypeDef()->Name(), op->type_b->TypeDef()->Name(), op->type_c->TypeDef()->Name() );
+	}
+
+	return MD4_BlockChecksum( compiler.c_str(), compiler.Length() );
+}
+
+/*
+================
+Cache_ValueType
+================
+*/
+static cacheValue_t Cache_ValueType( const idVarDef *def ) {
+	if ( def->Type() == ev_function ) {
+		return CACHE_VALUE_FUNCTION;
+	}
+	if ( def->initialized == idVarDef::stackVariable ) {
+		return CACHE_VALUE_INT;
+	}
+	if ( def->scope && def->scope->TypeDef() && def->scope->TypeDef()->Inherits( &type_object ) ) {
+		return CACHE_VALUE_INT;
+	}
+	switch( def->Type() ) {
+	case ev_jumpoffset :
+	case ev_argsize :
+	case ev_virtualfunction :
+		return CACHE_VALUE_INT;
+	default :
+		return CACHE_VALUE_GLOBAL;
+	}
+}
+
+/*
+================
+Cache_WriteTypeRef
+================
+*/
+static void Cache_WriteTypeRef( idFile *f, const idTypeDef *type, const idHashIndex &typeHash, const idList<idTypeDef *> &types ) {
+	int i;
+
+	if ( !type ) {
+		f->WriteInt( -1 );
+		return;
+	}
+	for( i = 0; i < NUM_CACHE_BUILTINS; i++ ) {
+		if ( type == cacheTypes[ i ] ) {
+			f->WriteInt( -2 - i );
+			return;
+		}
+	}
+	for( i = typeHash.First( (int)( (intptr_t)type >> 4 ) ); i != -1; i = typeHash.Next( i ) ) {
+		if ( types[ i ] == type ) {
+			f->WriteInt( i );
+			return;
+		}
+	}
+	// not in the type list, shouldn't happen
+	f->WriteInt( INT_MIN );
+}
+
+/*
+================
+Cache_WriteDefRef
+================
+*/
+static void Cache_WriteDefRef( idFile *f, const idVarDef *def ) {
+	int i;
+
+	if ( !def ) {
+		f->WriteInt( -1 );
+		return;
+	}
+	for( i = 0; i < NUM_CACHE_BUILTINS; i++ ) {
+		if ( def == cacheDefs[ i ] ) {
+			f->WriteInt( -2 - i );
+			return;
+		}
+	}
+	f->WriteInt( def->num );
+}
+
+/*
+================
+Cache_ReadTypeRef
+================
+*/
+static bool Cache_ReadTypeRef( idFile *f, const idList<idTypeDef *> &types, idTypeDef *&type ) {
+	int num;
+
+	f->ReadInt( num );
+	if ( num == -1 ) {
+		type = NULL;
+	} else if ( num < -1 && num >= -1 - NUM_CACHE_BUILTINS ) {
+		type = cacheTypes[ -2 - num ];
+	} else if ( num >= 0 && num < types.Num() ) {
+		type = types[ num ];
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+Cache_ReadDefRef
+================
+*/
+static bool Cache_ReadDefRef( idFile *f, const idList<idVarDef *> &defs, idVarDef *&def ) {
+	int num;
+
+	f->ReadInt( num );
+	if ( num == -1 ) {
+		def = NULL;
+	} else if ( num < -1 && num >= -1 - NUM_CACHE_BUILTINS ) {
+		def = cacheDefs[ -2 - num ];
+	} else if ( num >= 0 && num < defs.Num() ) {
+		def = defs[ num ];
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+idProgram::GetCacheSources
+
+Gets the checksums of the files and of all the files in the script directory,
+since files that only contain defines never show up in the file list.
+================
+*/
+void idProgram::GetCacheSources( const idStrList &files, idStrList &names, idList<int> &checksums ) const {
+	idFileList	*fileList;
+	void		*buffer;
+	int			length;
+	int			i;
+
+	names.Clear();
+	for( i = 0; i < files.Num(); i++ ) {
+		names.AddUnique( files[ i ] );
+	}
+	fileList = fileSystem->ListFilesTree( "script", ".script", true );
+	for( i = 0; i < fileList->GetNumFiles(); i++ ) {
+		names.AddUnique( fileList->GetFile( i ) );
+	}
+	fileSystem->FreeFileList( fileList );
+	names.Sort();
+
+	checksums.SetNum( names.Num() );
+	for( i = 0; i < names.Num(); i++ ) {
+		length = fileSystem->ReadFile( names[ i ], &buffer, NULL );
+		if ( length < 0 ) {
+			checksums[ i ] = 0;
+			continue;
+		}
+		checksums[ i ] = MD4_BlockChecksum( buffer, length );
+		fileSystem->FreeFile( buffer );
+	}
+}
+
+/*
+================
+idProgram::WriteCache
+================
+*/
+void idProgram::WriteCache( const char *cacheName ) const {
+	idFile			*f;
+	idStrList		names;
+	idList<int>		checksums;
+	idHashIndex		typeHash;
+	const idVarDef	*def;
+	const idTypeDef	*type;
+	intptr_t		offset;
+	int				i, j;
+
+	// make sure all the defs can be written before creating the file
+	for( i = 0; i < varDefs.Num(); i++ ) {
+		def = varDefs[ i ];
+		if ( def->num != i ) {
+			gameLocal.Warning( "idProgram::WriteCache: def '%s' is out of order", def->Name() );
+			return;
+		}
+		if ( Cache_ValueType( def ) == CACHE_VALUE_GLOBAL && def->value.bytePtr ) {
+			offset = def->value.bytePtr - variables;
+			if ( offset < 0 || offset >= numVariables ) {
+				gameLocal.Warning( "idProgram::WriteCache: def '%s' isn't a global variable", def->Name() );
+				return;
+			}
+		}
+	}
+
+	f = fileSystem->OpenFileWrite( cacheName );
+	if ( !f ) {
+		gameLocal.Warning( "idProgram::WriteCache: couldn't open %s", cacheName );
+		return;
+	}
+
+	typeHash.Clear( 1024, types.Num() );
+	for( i = 0; i < types.Num(); i++ ) {
+		typeHash.Add( (int)( (intptr_t)types[ i ] >> 4 ), i );
+	}
+
+	f->Write( SCRIPT_CACHE_ID, 4 );
+	f->WriteInt( SCRIPT_CACHE_VERSION );
+	f->WriteInt( sizeof( intptr_t ) );
+	f->WriteInt( Cache_EventChecksum() );
+	f->WriteInt( Cache_CompilerChecksum() );
+
+	// source files
+	GetCacheSources( fileList, names, checksums );
+	f->WriteInt( names.Num() );
+	for( i = 0; i < names.Num(); i++ ) {
+		f->WriteString( names[ i ] );
+		f->WriteInt( checksums[ i ] );
+	}
+
+	f->WriteInt( fileList.Num() );
+	for( i = 0; i < fileList.Num(); i++ ) {
+		f->WriteString( fileList[ i ] );
+	}
+
+	f->WriteInt( numVariables );
+	f->Write( variables, numVariables );
+
+	f->WriteInt( types.Num() );
+	f->WriteInt( varDefs.Num() );
+	f->WriteInt( functions.Num() );
+	f->WriteInt( statements.Num() );
+
+	for( i = 0; i < types.Num(); i++ ) {
+		type = types[ i ];
+		f->WriteInt( type->type );
+		f->WriteString( type->name );
+		f->WriteInt( type->size );
+		Cache_WriteTypeRef( f, type->auxType, typeHash, types );
+		Cache_WriteDefRef( f, type->def );
+		f->WriteInt( type->parmTypes.Num() );
+		for( j = 0; j < type->parmTypes.Num(); j++ ) {
+			Cache_WriteTypeRef( f, type->parmTypes[ j ], typeHash, types );
+			f->WriteString( type->parmNames[ j ] );
+		}
+		f->WriteInt( type->functions.Num() );
+		for( j = 0; j < type->functions.Num(); j++ ) {
+			f->WriteInt( type->functions[ j ] - &functions[ 0 ] );
+		}
+	}
+
+	for( i = 0; i < varDefs.Num(); i++ ) {
+		def = varDefs[ i ];
+		f->WriteString( def->Name() );
+		Cache_WriteTypeRef( f, def->TypeDef(), typeHash, types );
+		Cache_WriteDefRef( f, def->scope );
+		f->WriteInt( def->numUsers );
+		f->WriteInt( def->initialized );
+	}
+
+	// the values are written after all defs since the kind of value depends on the scope
+	for( i = 0; i < varDefs.Num(); i++ ) {
+		def = varDefs[ i ];
+		switch( Cache_ValueType( def ) ) {
+		case CACHE_VALUE_FUNCTION :
+			f->WriteInt( def->value.functionPtr ? def->value.functionPtr - &functions[ 0 ] : -1 );
+			break;
+		case CACHE_VALUE_GLOBAL :
+			f->WriteInt( def->value.bytePtr ? def->value.bytePtr - variables : -1 );
+			break;
+		default :
+			f->WriteInt( def->value.stackOffset );
+			break;
+		}
+	}
+
+	for( i = 0; i < functions.Num(); i++ ) {
+		const function_t &func = functions[ i ];
+		f->WriteString( func.Name() );
+		f->WriteString( func.eventdef ? func.eventdef->GetName() : "" );
+		Cache_WriteDefRef( f, func.def );
+		Cache_WriteTypeRef( f, func.type, typeHash, types );
+		f->WriteInt( func.firstStatement );
+		f->WriteInt( func.numStatements );
+		f->WriteInt( func.parmTotal );
+		f->WriteInt( func.locals );
+		f->WriteInt( func.filenum );
+		f->WriteInt( func.parmSize.Num() );
+		for( j = 0; j < func.parmSize.Num(); j++ ) {
+			f->WriteInt( func.parmSize[ j ] );
+		}
+	}
+
+	for( i = 0; i < statements.Num(); i++ ) {
+		const statement_t &st = statements[ i ];
+		f->WriteUnsignedShort( st.op );
+		f->WriteUnsignedShort( st.flags );
+		f->WriteUnsignedShort( st.linenumber );
+		f->WriteUnsignedShort( st.file );
+		Cache_WriteDefRef( f, st.a );
+		Cache_WriteDefRef( f, st.b );
+		Cache_WriteDefRef( f, st.c );
+	}
+
+	Cache_WriteDefRef( f, returnDef );
+	Cache_WriteDefRef( f, returnStringDef );
+	Cache_WriteDefRef( f, sysDef );
+
+	f->WriteInt( CalculateChecksum( false ) );
+
+	fileSystem->CloseFile( f );
+}
+
+/*
+================
+idProgram::LoadCache
+
+Returns false if there is no cache for the current scripts, the program is
+left empty then.
+================
+*/
+bool idProgram::LoadCache( const char *cacheName ) {
+	idFile			*f;
+	char			id[ 4 ];
+	idStrList		names;
+	idList<int>		checksums;
+	idStrList		sourceNames;
+	idList<int>		sourceChecksums;
+	idStr			str;
+	idVarDef		*def;
+	idTypeDef		*type;
+	idTypeDef		*ref;
+	int				num, numTypes, numDefs, numFunctions, numStatements;
+	int				value, i, j;
+	unsigned short	s;
+	bool			ok;
+
+	f = fileSystem->OpenFileRead( cacheName );
+	if ( !f ) {
+		return false;
+	}
+
+	f->Read( id, 4 );
+	f->ReadInt( value );
+	if ( memcmp( id, SCRIPT_CACHE_ID, 4 ) != 0 || value != SCRIPT_CACHE_VERSION ) {
+		fileSystem->CloseFile( f );
+		return false;
+	}
+	f->ReadInt( value );
+	if ( value != sizeof( intptr_t ) ) {
+		fileSystem->CloseFile( f );
+		return false;
+	}
+	f->ReadInt( value );
+	if ( value != Cache_EventChecksum() ) {
+		fileSystem->CloseFile( f );
+		return false;
+	}
+	f->ReadInt( value );
+	if ( value != Cache_CompilerChecksum() ) {
+		fileSystem->CloseFile( f );
+		return false;
+	}
+
+	// compare the source files
+	f->ReadInt( num );
+	for( i = 0; i < num; i++ ) {
+		f->ReadString( str );
+		names.Append( str );
+		f->ReadInt( value );
+		checksums.Append( value );
+	}
+
+	FreeData();
+
+	f->ReadInt( num );
+	for( i = 0; i < num; i++ ) {
+		f->ReadString( str );
+		fileList.Append( str );
+	}
+
+	GetCacheSources( fileList, sourceNames, sourceChecksums );
+	ok = ( sourceNames.Num() == names.Num() );
+	for( i = 0; ok && i < names.Num(); i++ ) {
+		ok = ( sourceNames[ i ] == names[ i ] && sourceChecksums[ i ] == checksums[ i ] );
+	}
+	if ( !ok ) {
+		fileSystem->CloseFile( f );
+		FreeData();
+		return false;
+	}
+
+	f->ReadInt( numVariables );
+	f->ReadInt( numTypes );
+	f->ReadInt( numDefs );
+	f->ReadInt( numFunctions );
+	f->ReadInt( numStatements );
+	ok = numVariables >= 0 && numVariables <= MAX_GLOBALS && numTypes >= 0 && numDefs >= 0 &&
+		numFunctions >= 0 && numFunctions <= functions.Max() && numStatements >= 0 && numStatements <= statements.Max();
+	if ( !ok ) {
+		fileSystem->CloseFile( f );
+		FreeData();
+		return false;
+	}
+	f->Read( variables, numVariables );
+
+	// allocate everything up front so the references can be resolved
+	for( i = 0; i < numTypes; i++ ) {
+		types.Append( new idTypeDef( ev_void, NULL, "", 0, NULL ) );
+	}
+	for( i = 0; i < numDefs; i++ ) {
+		def = new idVarDef();
+		def->num = varDefs.Append( def );
+	}
+	functions.SetNum( numFunctions );
+	statements.SetNum( numStatements );
+
+	for( i = 0; ok && i < numTypes; i++ ) {
+		type = types[ i ];
+		f->ReadInt( value );
+		type->type = (etype_t)value;
+		f->ReadString( type->name );
+		f->ReadInt( type->size );
+		ok = Cache_ReadTypeRef( f, types, type->auxType ) && Cache_ReadDefRef( f, varDefs, type->def );
+		f->ReadInt( num );
+		for( j = 0; ok && j < num; j++ ) {
+			ok = Cache_ReadTypeRef( f, types, ref );
+			type->parmTypes.Append( ref );
+			f->ReadString( type->parmNames.Alloc() );
+		}
+		f->ReadInt( num );
+		for( j = 0; ok && j < num; j++ ) {
+			f->ReadInt( value );
+			ok = ( value >= 0 && value < numFunctions );
+			type->functions.Append( ok ? &functions[ value ] : NULL );
+		}
+	}
+
+	for( i = 0; ok && i < numDefs; i++ ) {
+		def = varDefs[ i ];
+		f->ReadString( str );
+		AddDefToNameList( def, str );
+		ok = Cache_ReadTypeRef( f, types, ref ) && Cache_ReadDefRef( f, varDefs, def->scope );
+		def->SetTypeDef( ref );
+		f->ReadInt( def->numUsers );
+		f->ReadInt( value );
+		def->initialized = (idVarDef::initialized_t)value;
+	}
+
+	for( i = 0; ok && i < numDefs; i++ ) {
+		def = varDefs[ i ];
+		f->ReadInt( value );
+		switch( Cache_ValueType( def ) ) {
+		case CACHE_VALUE_FUNCTION :
+			ok = ( value >= -1 && value < numFunctions );
+			def->value.functionPtr = ( ok && value >= 0 ) ? &functions[ value ] : NULL;
+			break;
+		case CACHE_VALUE_GLOBAL :
+			ok = ( value >= -1 && value < numVariables );
+			def->value.bytePtr = ( ok && value >= 0 ) ? &variables[ value ] : NULL;
+			break;
+		default :
+			def->value.stackOffset = value;
+			break;
+		}
+	}
+
+	for( i = 0; ok && i < numFunctions; i++ ) {
+		function_t &func = functions[ i ];
+		func.Clear();
+		f->ReadString( str );
+		func.SetName( str );
+		f->ReadString( str );
+		if ( str.Length() ) {
+			func.eventdef = idEventDef::FindEvent( str );
+			ok = ( func.eventdef != NULL );
+		}
+		ok = ok && Cache_ReadDefRef( f, varDefs, func.def ) && Cache_ReadTypeRef( f, types, ref );
+		func.type = ref;
+		f->ReadInt( func.firstStatement );
+		f->ReadInt( func.numStatements );
+		f->ReadInt( func.parmTotal );
+		f->ReadInt( func.locals );
+		f->ReadInt( func.filenum );
+		f->ReadInt( num );
+		func.parmSize.SetGranularity( 1 );
+		for( j = 0; ok && j < num; j++ ) {
+			f->ReadInt( func.parmSize.Alloc() );
+		}
+		if ( func.eventdef ) {
+			ok = ok && ( num == func.eventdef->GetNumArgs() );
+			func.BindEvent( func.eventdef );
+		}
+	}
+
+	for( i = 0; ok && i < numStatements; i++ ) {
+		statement_t &st = statements[ i ];
+		f->ReadUnsignedShort( s );
+		st.op = s;
+		f->ReadUnsignedShort( s );
+		st.flags = s;
+		f->ReadUnsignedShort( s );
+		st.linenumber = s;
+		f->ReadUnsignedShort( s );
+		st.file = s;
+		ok = Cache_ReadDefRef( f, varDefs, st.a ) && Cache_ReadDefRef( f, varDefs, st.b ) && Cache_ReadDefRef( f, varDefs, st.c );
+	}
+
+	ok = ok && Cache_ReadDefRef( f, varDefs, returnDef ) && Cache_ReadDefRef( f, varDefs, returnStringDef ) && Cache_ReadDefRef( f, varDefs, sysDef );
+
+	// the program has to match the one that was written
+	if ( ok ) {
+		f->ReadInt( value );
+		ok = ( f->Tell() == f->Length() && value == CalculateChecksum( false ) );
+	}
+
+	fileSystem->CloseFile( f );
+
+	if ( !ok ) {
+		gameLocal.Warning( "idProgram::LoadCache: %s is corrupt", cacheName );
+		FreeData();
+		return false;
+	}
+
+	return true;
+}
+
 /*
 ================
 idProgram::Startup
 ================
 */
 void idProgram::Startup( const char *defaultScript ) {
+	idStr	cacheName;
+	idTimer	loadTime;
+
 	gameLocal.Printf( "Initializing scripts\n" );
 
 	// make sure all data is freed up
 	idThread::Restart();
 
+	// load the compiled program if the scripts didn't change
+	if ( defaultScript && *defaultScript && g_scriptCache.GetBool() ) {
+		cacheName = SCRIPT_CACHE_DIR;
+		cacheName += defaultScript;
+		cacheName.SetFileExtension( ".bin" );
+
+		loadTime.Start();
+		if ( LoadCache( cacheName ) ) {
+			FinishCompilation();
+			loadTime.Stop();
+			gameLocal.Printf( "Loaded '%s' from %s: %u ms\n", defaultScript, cacheName.c_str(), (unsigned int)loadTime.Milliseconds() );
+
+			if ( g_disasm.GetBool() ) {
+				Disassemble();
+			}
+			return;
+		}
+	}
+
 	// get ready for loading scripts
 	BeginCompilation();
 
@@ -1976,6 +2721,10 @@ void idProgram::Startup( const char *defaultScript ) {
 	}
 
 	FinishCompilation();
+
+	if ( cacheName.Length() ) {
+		WriteCache( cacheName );
+	}
 }
 
 /*
@@ -2156,6 +2905,7 @@ void idProgram::Restart( void ) {
 	functions.SetNum( top_functions	);
 
 	statements.SetNum( top_statements );
+	decodedStatements.SetNum( Min( decodedStatements.Num(), top_statements ), false );
 	fileList.SetNum( top_files, false );
 	filename.Clear();
 
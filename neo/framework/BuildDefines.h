@@ -66,6 +66,11 @@ If you have questions concerning this license or the applicable additional terms
 	#define ID_CLIENTINFO_TAGS 0
 #endif
 
+// compile in the PROF_SCOPE profiler zones
+#ifndef ID_PROFILER
+	#define ID_PROFILER 1
+#endif
+
 // for win32 this is defined in preprocessor settings so that MFC can be
 // compiled out.
 //#define ID_DEDICATED
@@ -129,4 +134,4 @@ dhewm WIP		42
 
 // threads
 
-#define MAX_THREADS				(10)
+#define MAX_THREADS				(32)
@@ -32,6 +32,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/containers/HashTable.h"
 #include "idlib/LangDict.h"
 #include "idlib/MapFile.h"
+#include "idlib/Profiler.h"
 #include "cm/CollisionModel.h"
 #include "framework/async/AsyncNetwork.h"
 #include "framework/async/NetworkSystem.h"
@@ -46,6 +47,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "renderer/Model.h"
 #include "renderer/ModelManager.h"
 #include "renderer/RenderSystem.h"
+#include "sys/jobs.h"
 #include "tools/compilers/compiler_public.h"
 #include "tools/compilers/aas/AASFileManager.h"
 #include "tools/edit_public.h"
@@ -86,6 +88,8 @@ idCVar com_asyncInput( "com_asyncInput", "0", CVAR_BOOL|CVAR_SYSTEM, "sample inp
 #define ASYNCSOUND_INFO "0: mix sound inline, 1 or 3: async update every 16ms 2: async update about every 100ms (original behavior)"
 idCVar com_asyncSound( "com_asyncSound", "1", CVAR_INTEGER|CVAR_SYSTEM, ASYNCSOUND_INFO, 0, 3 );
 idCVar com_forceGenericSIMD( "com_forceGenericSIMD", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "force generic platform independent SIMD" );
+idCVar com_numJobThreads( "com_numJobThreads", "0", CVAR_INTEGER | CVAR_SYSTEM | CVAR_ARCHIVE | CVAR_NOCHEAT, "number of job worker threads, 0 = one per additional CPU core, -1 = run all jobs on the waiting thread", -1, MAX_JOB_THREADS );
+idCVar com_profile( "com_profile", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "keep recording profiler zones so profileDump can write the last frames" );
 idCVar com_developer( "developer", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_NOCHEAT, "developer mode" );
 idCVar com_allowConsole( "com_allowConsole", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "allow toggling console with the tilde key" );
 idCVar com_speeds( "com_speeds", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_NOCHEAT, "show engine timings" );
@@ -2257,6 +2261,26 @@ void Com_FinishBuild_f( const idCmdArgs &args ) {
 	globalImages->FinishBuild( ( args.Argc() > 1 ) );
 }
 
+/*
+==============
+Com_ProfileDump_f
+==============
+*/
+void Com_ProfileDump_f( const idCmdArgs &args ) {
+	int numFrames = 30;
+	if ( args.Argc() > 1 ) {
+		numFrames = atoi( args.Argv( 1 ) );
+	}
+	idStr fileName;
+	if ( args.Argc() > 2 ) {
+		fileName = args.Argv( 2 );
+		fileName.DefaultFileExtension( ".json" );
+	} else {
+		sprintf( fileName, "profile/frame%i.json", com_frameNumber );
+	}
+	profiler->WriteTrace( numFrames, fileName );
+}
+
 /*
 ==============
 Com_Help_f
@@ -2333,11 +2357,13 @@ void idCommonLocal::InitCommands( void ) {
 	// idLib commands
 	cmdSystem->AddCommand( "memoryDump", Mem_Dump_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "creates a memory dump" );
 	cmdSystem->AddCommand( "memoryDumpCompressed", Mem_DumpCompressed_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "creates a compressed memory dump" );
+	cmdSystem->AddCommand( "memoryBenchmark", Mem_Benchmark_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "compares Mem_Alloc with malloc on the size distribution of the allocations so far, usage: memoryBenchmark [threads] [count]" );
 	cmdSystem->AddCommand( "showStringMemory", idStr::ShowMemoryUsage_f, CMD_FL_SYSTEM, "shows memory used by strings" );
 	cmdSystem->AddCommand( "showDictMemory", idDict::ShowMemoryUsage_f, CMD_FL_SYSTEM, "shows memory used by dictionaries" );
 	cmdSystem->AddCommand( "listDictKeys", idDict::ListKeys_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all keys used by dictionaries" );
 	cmdSystem->AddCommand( "listDictValues", idDict::ListValues_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all values used by dictionaries" );
 	cmdSystem->AddCommand( "testSIMD", idSIMD::Test_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "test SIMD code" );
+	cmdSystem->AddCommand( "profileDump", Com_ProfileDump_f, CMD_FL_SYSTEM, "writes the profiler zones of the last frames as Chrome trace JSON, usage: profileDump [frames] [file]" );
 
 	// localization
 	cmdSystem->AddCommand( "localizeGuis", Com_LocalizeGuis_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "localize guis" );
@@ -2403,7 +2429,10 @@ idCommonLocal::Frame
 =================
 */
 void idCommonLocal::Frame( void ) {
+	profiler->BeginFrame();
+
 	try {
+		PROF_SCOPE( "idCommonLocal::Frame" );
 
 		// pump all the events
 		Sys_GenerateEvents();
@@ -2416,6 +2445,17 @@ void idCommonLocal::Frame( void ) {
 			InitSIMD();
 		}
 
+		// restart the job worker threads if required
+		if ( com_numJobThreads.IsModified() ) {
+			parallelJobManager->SetNumThreads( com_numJobThreads.GetInteger() );
+			com_numJobThreads.ClearModified();
+		}
+
+		if ( com_profile.IsModified() ) {
+			profiler->SetRecording( com_profile.GetBool() );
+			com_profile.ClearModified();
+		}
+
 		if ( com_enableDebuggerServer.IsModified() ) {
 			if ( com_enableDebuggerServer.GetBool() ) {
 				DebuggerServerInit();
@@ -2442,6 +2482,9 @@ void idCommonLocal::Frame( void ) {
 			session->UpdateScreen( false );
 		}
 
+		// run the callbacks of finished background reads
+		fileSystem->UpdateAsyncReads();
+
 		// report timing information
 		if ( com_speeds.GetBool() ) {
 			static int	lastTime;
@@ -2692,6 +2735,8 @@ void idCommonLocal::LoadGameDLL( void ) {
 	gameImport.declManager				= ::declManager;
 	gameImport.AASFileManager			= ::AASFileManager;
 	gameImport.collisionModelManager	= ::collisionModelManager;
+	gameImport.parallelJobManager		= ::parallelJobManager;
+	gameImport.profiler					= ::profiler;
 
 	gameExport							= *GetGameAPI( &gameImport);
 
@@ -2942,6 +2987,7 @@ void idCommonLocal::Init( int argc, char **argv ) {
 		idLib::common		= common;
 		idLib::cvarSystem	= cvarSystem;
 		idLib::fileSystem	= fileSystem;
+		idLib::profiler		= profiler;
 
 		// initialize idLib
 		idLib::Init();
@@ -3002,6 +3048,11 @@ void idCommonLocal::Init( int argc, char **argv ) {
 		// init commands
 		InitCommands();
 
+		// start the job worker threads
+		parallelJobManager->Init();
+
+		profiler->Init();
+
 #ifdef ID_WRITE_VERSION
 		config_compressor = idCompressor::AllocArithmetic();
 #endif
@@ -3068,6 +3119,11 @@ void idCommonLocal::Shutdown( void ) {
 	// game specific shut down
 	ShutdownGame( false );
 
+	// stop the job worker threads
+	parallelJobManager->Shutdown();
+
+	profiler->Shutdown();
+
 	// shut down non-portable system services
 	Sys_Shutdown();
 
@@ -44,6 +44,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "sound/sound.h"
 
 #include "framework/DeclManager.h"
+#include "sys/jobs.h"
 
 /*
 
@@ -80,6 +81,11 @@ missing reload over a previously explicit definition
 #define USE_COMPRESSED_DECLS
 //#define GET_HUFFMAN_FREQUENCIES
 
+// binary cache of the scanned decl files in fs_savepath
+#define DECL_CACHE_FILENAME		"decls.cache"
+const int DECL_CACHE_IDENT		= ( ( 'C' << 24 ) + ( 'L' << 16 ) + ( 'C' << 8 ) + 'D' );
+const int DECL_CACHE_VERSION	= 1;
+
 class idDeclType {
 public:
 	idStr						typeName;
@@ -95,6 +101,7 @@ public:
 };
 
 class idDeclFile;
+class idDeclFileLoad;
 
 class idDeclLocal : public idDeclBase {
 	friend class idDeclFile;
@@ -145,12 +152,21 @@ protected:
 								// Set textSource possible with compression.
 	void						SetTextLocal( const char *text, const int length );
 
+								// Takes ownership of text that was compressed with CompressDeclText().
+	void						SetCompressedTextLocal( char *text, const int length, const int compressedLength, const int textChecksum );
+
+								// Frees the text unpacked by PrepareTextJob().
+	void						FreePreparedText( void );
+
+	static void					PrepareTextJob( void *data );
+
 private:
 	idDecl *					self;
 
 	idStr						name;					// name of the decl
 	char *						textSource;				// decl text definition
 	int							textLength;				// length of textSource
+	char *						preparedText;			// uncompressed text unpacked on a job thread before a level load
 	int							compressedLength;		// compressed length
 	idDeclFile *				sourceFile;				// source file in which the decl was defined
 	int							sourceTextOffset;		// offset in source file to decl text
@@ -173,10 +189,21 @@ class idDeclFile {
 public:
 								idDeclFile();
 								idDeclFile( const char *fileName, declType_t defaultType );
+								~idDeclFile();
 
 	void						Reload( bool force );
 	int							LoadAndParse();
 
+								// LoadAndParse() split up for parallel loading, Load() and Merge()
+								// must be called from the main thread, Scan() with quiet set
+								// doesn't print anything and may run on a job thread
+	void						GetCacheKey( idDeclFileLoad &load ) const;
+	bool						Load( idDeclFileLoad &load );
+	void						Scan( idDeclFileLoad &load, bool quiet ) const;
+	int							Merge( idDeclFileLoad &load );
+
+	static void					ScanJob( void *data );
+
 public:
 	idStr						fileName;
 	declType_t					defaultType;
@@ -187,10 +214,47 @@ public:
 	int							numLines;
 
 	idDeclLocal *				decls;
+
+	bool						cacheValid;				// the decl cache has an up to date entry for this file
+	idFile_Memory *				cacheEntry;				// entry not written to the decl cache yet
+};
+
+// a decl definition found while scanning a decl file
+typedef struct declScan_s {
+	declType_t					type;
+	idStr						name;
+	int							sourceTextOffset;
+	int							sourceTextLength;
+	int							sourceLine;
+	int							checksum;
+	char *						textSource;				// compressed text
+	int							compressedLength;
+} declScan_t;
+
+// a decl file read into memory and scanned for decl definitions
+class idDeclFileLoad {
+public:
+								idDeclFileLoad();
+								~idDeclFileLoad();
+
+	void						FreeDecls( void );
+
+	idDeclFile *				file;
+	char *						buffer;
+	int							length;
+	int							checksum;
+	int							numLines;
+	bool						loaded;
+	bool						scanned;				// false if a quiet scan hit a warning and has to be repeated
+	bool						fromCache;				// loaded from the decl cache, no buffer
+	ID_TIME_T					timestamp;				// decl cache key
+	int							pakChecksum;
+	idList<declScan_t>			decls;
 };
 
 class idDeclManagerLocal : public idDeclManager {
 	friend class idDeclLocal;
+	friend class idDeclFile;
 
 public:
 	virtual void				Init( void );
@@ -237,6 +301,17 @@ public:
 	idDeclType *				GetDeclType( int type ) const { return declTypes[type]; }
 	const idDeclFile *			GetImplicitDeclFile( void ) const { return &implicitDecls; }
 
+private:
+	void						LoadAndParseFiles( const idList<idDeclFile *> &files );
+	void						PrepareLevelDecls( void );
+
+	void						OpenDeclCache( void );
+	void						CloseDeclCache( void );
+	void						WriteDeclCache( void );
+	bool						ReadCacheEntry( idDeclFile *file, idDeclFileLoad &load );
+	void						UpdateCacheEntry( idDeclFile *file, const idDeclFileLoad &load );
+	void						InvalidateCacheEntry( idDeclFile *file );
+
 private:
 	idList<idDeclType *>		declTypes;
 	idList<idDeclFolder *>		declFolders;
@@ -250,8 +325,19 @@ private:
 	int							checksum;		// checksum of all loaded decl text
 	int							indent;			// for MediaPrint
 	bool						insideLevelLoad;
+	idList<idDeclLocal *>		levelDecls;		// decls referenced by the last level load
+	idParallelJobList *			declJobs;
+	int							typesChecksum;	// checksum of the registered decl types for the decl cache
+
+	sysMappedFile_t				cacheMapping;	// decl cache mapped at Init
+	idStrList					cacheEntryNames;
+	idList<int>					cacheEntryOffsets;
+	idHashIndex					cacheEntryHash;
+	bool						cacheDirty;
 
 	static idCVar				decl_show;
+	static idCVar				decl_parallelParse;
+	static idCVar				decl_cache;
 
 private:
 	static void					ListDecls_f( const idCmdArgs &args );
@@ -260,6 +346,8 @@ private:
 };
 
 idCVar idDeclManagerLocal::decl_show( "decl_show", "0", CVAR_SYSTEM, "set to 1 to print parses, 2 to also print references", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar idDeclManagerLocal::decl_cache( "decl_cache", "1", CVAR_SYSTEM | CVAR_BOOL, "keep a binary cache of the scanned decl files in fs_savepath" );
+idCVar idDeclManagerLocal::decl_parallelParse( "decl_parallelParse", "1", CVAR_SYSTEM | CVAR_BOOL, "scan decl files and unpack the decl text of the previous level on the job threads" );
 
 idDeclManagerLocal	declManagerLocal;
 idDeclManager *		declManager = &declManagerLocal;
@@ -481,8 +569,6 @@ int HuffmanCompressText( const char *text, int textLength, byte *compressed, int
 	int i, j;
 	idBitMsg msg;
 
-	totalUncompressedLength += textLength;
-
 	msg.Init( compressed, maxCompressedSize );
 	msg.BeginWriting();
 	for ( i = 0; i < textLength; i++ ) {
@@ -495,8 +581,6 @@ int HuffmanCompressText( const char *text, int textLength, byte *compressed, int
 		}
 	}
 
-	totalCompressedLength += msg.GetSize();
-
 	return msg.GetSize();
 }
 
@@ -525,6 +609,40 @@ int HuffmanDecompressText( char *text, int textLength, const byte *compressed, i
 	return msg.GetReadCount();
 }
 
+/*
+================
+CompressDeclText
+
+Returns the decl text in the form stored in idDeclLocal::textSource,
+this is thread-safe unless GET_HUFFMAN_FREQUENCIES is defined.
+================
+*/
+char *CompressDeclText( const char *text, int length, int &compressedLength ) {
+	char *textSource;
+
+#ifdef GET_HUFFMAN_FREQUENCIES
+	for( int i = 0; i < length; i++ ) {
+		huffmanFrequencies[((const unsigned char *)text)[i]]++;
+	}
+#endif
+
+#ifdef USE_COMPRESSED_DECLS
+	// decls can be large, so don't compress on the stack of a job thread
+	int maxBytesPerCode = ( maxHuffmanBits + 7 ) >> 3;
+	byte *compressed = (byte *)Mem_Alloc( length * maxBytesPerCode );
+	compressedLength = HuffmanCompressText( text, length, compressed, length * maxBytesPerCode );
+	textSource = (char *)Mem_Alloc( compressedLength );
+	memcpy( textSource, compressed, compressedLength );
+	Mem_Free( compressed );
+#else
+	compressedLength = length;
+	textSource = (char *) Mem_Alloc( length + 1 );
+	memcpy( textSource, text, length );
+	textSource[length] = '\0';
+#endif
+	return textSource;
+}
+
 /*
 ================
 ListHuffmanFrequencies_f
@@ -567,6 +685,8 @@ idDeclFile::idDeclFile( const char *fileName, declType_t defaultType ) {
 	this->fileSize = 0;
 	this->numLines = 0;
 	this->decls = NULL;
+	this->cacheValid = false;
+	this->cacheEntry = NULL;
 }
 
 /*
@@ -582,6 +702,17 @@ idDeclFile::idDeclFile() {
 	this->fileSize = 0;
 	this->numLines = 0;
 	this->decls = NULL;
+	this->cacheValid = false;
+	this->cacheEntry = NULL;
+}
+
+/*
+================
+idDeclFile::~idDeclFile
+================
+*/
+idDeclFile::~idDeclFile() {
+	delete cacheEntry;
 }
 
 /*
@@ -606,6 +737,46 @@ void idDeclFile::Reload( bool force ) {
 	LoadAndParse();
 }
 
+/*
+================
+idDeclFileLoad::idDeclFileLoad
+================
+*/
+idDeclFileLoad::idDeclFileLoad() {
+	file = NULL;
+	buffer = NULL;
+	length = 0;
+	checksum = 0;
+	numLines = 0;
+	loaded = false;
+	scanned = false;
+	fromCache = false;
+	timestamp = 0;
+	pakChecksum = 0;
+}
+
+/*
+================
+idDeclFileLoad::~idDeclFileLoad
+================
+*/
+idDeclFileLoad::~idDeclFileLoad() {
+	FreeDecls();
+	Mem_Free( buffer );
+}
+
+/*
+================
+idDeclFileLoad::FreeDecls
+================
+*/
+void idDeclFileLoad::FreeDecls( void ) {
+	for ( int i = 0; i < decls.Num(); i++ ) {
+		Mem_Free( decls[i].textSource );
+	}
+	decls.Clear();
+}
+
 /*
 ================
 idDeclFile::LoadAndParse
@@ -616,41 +787,86 @@ This is used during both the initial load, and any reloads
 int c_savedMemory = 0;
 
 int idDeclFile::LoadAndParse() {
+	idDeclFileLoad load;
+
+	GetCacheKey( load );
+	if ( !Load( load ) ) {
+		return 0;
+	}
+	Scan( load, false );
+	return Merge( load );
+}
+
+/*
+================
+idDeclFile::GetCacheKey
+
+A decl cache entry is valid as long as the file has the same length, timestamp
+and pk4 checksum, this doesn't need to read the file.
+================
+*/
+void idDeclFile::GetCacheKey( idDeclFileLoad &load ) const {
+	if ( declManagerLocal.decl_cache.GetBool() ) {
+		load.length = fileSystem->GetFileInfo( fileName, &load.timestamp, &load.pakChecksum );
+	}
+}
+
+/*
+================
+idDeclFile::Load
+================
+*/
+bool idDeclFile::Load( idDeclFileLoad &load ) {
+	// load the text
+	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
+	load.file = this;
+	load.length = fileSystem->ReadFile( fileName, (void **)&load.buffer, &timestamp );
+	if ( load.length == -1 ) {
+		load.buffer = NULL;
+		common->FatalError( "couldn't load %s", fileName.c_str() );
+		return false;
+	}
+	load.loaded = true;
+	return true;
+}
+
+/*
+================
+idDeclFile::Scan
+
+Identifies each individual declaration in the loaded text. A quiet scan
+suppresses all lexer output and leaves load.scanned false if anything would
+have been printed, the scan is then repeated on the main thread so the
+messages show up exactly as with a serial load.
+================
+*/
+void idDeclFile::Scan( idDeclFileLoad &load, bool quiet ) const {
 	int			i, numTypes;
 	idLexer		src;
 	idToken		token;
 	int			startMarker;
-	char *		buffer;
-	int			length, size;
+	int			size;
 	int			sourceLine;
 	idStr		name;
-	idDeclLocal *newDecl;
-	bool		reparse;
 
-	// load the text
-	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
-	length = fileSystem->ReadFile( fileName, (void **)&buffer, &timestamp );
-	if ( length == -1 ) {
-		common->FatalError( "couldn't load %s", fileName.c_str() );
-		return 0;
-	}
+	load.FreeDecls();
+	load.scanned = false;
 
-	if ( !src.LoadMemory( buffer, length, fileName ) ) {
-		common->Error( "Couldn't parse %s", fileName.c_str() );
-		Mem_Free( buffer );
-		return 0;
+	if ( !src.LoadMemory( load.buffer, load.length, fileName ) ) {
+		if ( !quiet ) {
+			common->Error( "Couldn't parse %s", fileName.c_str() );
+		}
+		return;
 	}
 
-	// mark all the defs that were from the last reload of this file
-	for ( idDeclLocal *decl = decls; decl; decl = decl->nextInFile ) {
-		decl->redefinedInReload = false;
+	if ( quiet ) {
+		src.SetFlags( DECL_LEXER_FLAGS | LEXFL_NOERRORS | LEXFL_NOWARNINGS );
+	} else {
+		src.SetFlags( DECL_LEXER_FLAGS );
 	}
 
-	src.SetFlags( DECL_LEXER_FLAGS );
-
-	checksum = MD5_BlockChecksum( buffer, length );
-
-	fileSize = length;
+	load.checksum = MD5_BlockChecksum( load.buffer, load.length );
+	load.decls.SetGranularity( 256 );
 
 	// scan through, identifying each individual declaration
 	while( 1 ) {
@@ -732,14 +948,72 @@ int idDeclFile::LoadAndParse() {
 		src.SkipBracedSection();
 		size = src.GetFileOffset() - startMarker;
 
+		declScan_t &scan = load.decls.Alloc();
+		scan.type = identifiedType;
+		scan.name = name;
+		scan.sourceTextOffset = startMarker;
+		scan.sourceTextLength = size;
+		scan.sourceLine = sourceLine;
+		scan.checksum = MD5_BlockChecksum( load.buffer + startMarker, size );
+		scan.textSource = CompressDeclText( load.buffer + startMarker, size, scan.compressedLength );
+	}
+
+	load.numLines = src.GetLineNum();
+
+	if ( quiet && ( src.HadWarning() || src.HadError() ) ) {
+		load.FreeDecls();
+		return;
+	}
+
+	load.scanned = true;
+}
+
+/*
+================
+idDeclFile::ScanJob
+================
+*/
+void idDeclFile::ScanJob( void *data ) {
+	idDeclFileLoad *load = (idDeclFileLoad *)data;
+	load->file->Scan( *load, true );
+}
+
+/*
+================
+idDeclFile::Merge
+
+Adds the scanned decls to the decl manager in file order.
+================
+*/
+int idDeclFile::Merge( idDeclFileLoad &load ) {
+	idDeclLocal *newDecl;
+	bool		reparse;
+
+	if ( !load.fromCache ) {
+		declManagerLocal.UpdateCacheEntry( this, load );
+	}
+
+	// mark all the defs that were from the last reload of this file
+	for ( idDeclLocal *decl = decls; decl; decl = decl->nextInFile ) {
+		decl->redefinedInReload = false;
+	}
+
+	checksum = load.checksum;
+
+	fileSize = load.length;
+
+	for ( int i = 0; i < load.decls.Num(); i++ ) {
+		declScan_t &scan = load.decls[i];
+
 		// look it up, possibly getting a newly created default decl
 		reparse = false;
-		newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, false );
+		newDecl = declManagerLocal.FindTypeWithoutParsing( scan.type, scan.name, false );
 		if ( newDecl ) {
 			// update the existing copy
 			if ( newDecl->sourceFile != this || newDecl->redefinedInReload ) {
-				src.Warning( "%s '%s' previously defined at %s:%i", declManagerLocal.GetDeclNameFromType( identifiedType ),
-								name.c_str(), newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
+				common->Warning( "file %s, line %d: %s '%s' previously defined at %s:%i", fileName.c_str(), scan.sourceLine,
+								declManagerLocal.GetDeclNameFromType( scan.type ), scan.name.c_str(),
+								newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
 				continue;
 			}
 			if ( newDecl->declState != DS_UNPARSED ) {
@@ -747,23 +1021,19 @@ int idDeclFile::LoadAndParse() {
 			}
 		} else {
 			// allow it to be created as a default, then add it to the per-file list
-			newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, true );
+			newDecl = declManagerLocal.FindTypeWithoutParsing( scan.type, scan.name, true );
 			newDecl->nextInFile = this->decls;
 			this->decls = newDecl;
 		}
 
 		newDecl->redefinedInReload = true;
 
-		if ( newDecl->textSource ) {
-			Mem_Free( newDecl->textSource );
-			newDecl->textSource = NULL;
-		}
-
-		newDecl->SetTextLocal( buffer + startMarker, size );
+		newDecl->SetCompressedTextLocal( scan.textSource, scan.sourceTextLength, scan.compressedLength, scan.checksum );
+		scan.textSource = NULL;
 		newDecl->sourceFile = this;
-		newDecl->sourceTextOffset = startMarker;
-		newDecl->sourceTextLength = size;
-		newDecl->sourceLine = sourceLine;
+		newDecl->sourceTextOffset = scan.sourceTextOffset;
+		newDecl->sourceTextLength = scan.sourceTextLength;
+		newDecl->sourceLine = scan.sourceLine;
 		newDecl->declState = DS_UNPARSED;
 
 		// if it is currently in use, reparse it immedaitely
@@ -772,9 +1042,11 @@ int idDeclFile::LoadAndParse() {
 		}
 	}
 
-	numLines = src.GetLineNum();
+	numLines = load.numLines;
 
-	Mem_Free( buffer );
+	load.FreeDecls();
+	Mem_Free( load.buffer );
+	load.buffer = NULL;
 
 	// any defs that weren't redefinedInReload should now be defaulted
 	for ( idDeclLocal *decl = decls ; decl ; decl = decl->nextInFile ) {
@@ -810,10 +1082,15 @@ void idDeclManagerLocal::Init( void ) {
 
 	checksum = 0;
 
+	declJobs = parallelJobManager->AllocJobList( "decls" );
+
 #ifdef USE_COMPRESSED_DECLS
 	SetupHuffman();
 #endif
 
+	cacheDirty = false;
+	OpenDeclCache();
+
 #ifdef GET_HUFFMAN_FREQUENCIES
 	ClearHuffmanFrequencies();
 #endif
@@ -886,6 +1163,9 @@ void idDeclManagerLocal::Shutdown( void ) {
 	int			i, j;
 	idDeclLocal *decl;
 
+	WriteDeclCache();
+	CloseDeclCache();
+
 	// free decls
 	for ( i = 0; i < DECL_MAX_TYPES; i++ ) {
 		for ( j = 0; j < linearLists[i].Num(); j++ ) {
@@ -898,11 +1178,16 @@ void idDeclManagerLocal::Shutdown( void ) {
 				Mem_Free( decl->textSource );
 				decl->textSource = NULL;
 			}
+			decl->FreePreparedText();
 			delete decl;
 		}
 		linearLists[i].Clear();
 		hashTables[i].Free();
 	}
+	levelDecls.Clear();
+
+	parallelJobManager->FreeJobList( declJobs );
+	declJobs = NULL;
 
 	// free decl files
 	loadedFiles.DeleteContents( true );
@@ -935,6 +1220,9 @@ idDeclManagerLocal::BeginLevelLoad
 void idDeclManagerLocal::BeginLevelLoad() {
 	insideLevelLoad = true;
 
+	// all decl files are loaded at this point
+	WriteDeclCache();
+
 	// clear all the referencedThisLevel flags and purge all the data
 	// so the next reference will cause a reparse
 	for ( int i = 0; i < DECL_MAX_TYPES; i++ ) {
@@ -944,6 +1232,10 @@ void idDeclManagerLocal::BeginLevelLoad() {
 			decl->Purge();
 		}
 	}
+
+	if ( decl_parallelParse.GetBool() ) {
+		PrepareLevelDecls();
+	}
 }
 
 /*
@@ -954,8 +1246,51 @@ idDeclManagerLocal::EndLevelLoad
 void idDeclManagerLocal::EndLevelLoad() {
 	insideLevelLoad = false;
 
-	// we don't need to do anything here, but the image manager, model manager,
-	// and sound sample manager will need to free media that was not referenced
+	// remember the decls this level referenced for the next level load,
+	// and drop the prepared text of the ones it didn't reference
+	levelDecls.Clear();
+	for ( int i = 0; i < DECL_MAX_TYPES; i++ ) {
+		int	num = linearLists[i].Num();
+		for ( int j = 0 ; j < num ; j++ ) {
+			idDeclLocal *decl = linearLists[i][j];
+			decl->FreePreparedText();
+			if ( decl->referencedThisLevel && !decl->parsedOutsideLevelLoad && decl->textSource != NULL ) {
+				levelDecls.Append( decl );
+			}
+		}
+	}
+
+	// the image manager, model manager, and sound sample manager
+	// will need to free media that was not referenced
+}
+
+/*
+===================
+idDeclManagerLocal::PrepareLevelDecls
+
+Most of the decls referenced by the last level load are referenced again by
+the next one, so their text is unpacked on the job threads up front instead
+of one decl at a time while parsing. Parse() itself calls back into the decl
+manager, the image and sound managers and the console, so the parsing stays
+on the main thread in reference order and the result is the same as without
+this.
+===================
+*/
+void idDeclManagerLocal::PrepareLevelDecls( void ) {
+	int start = Sys_Milliseconds();
+
+	for ( int i = 0; i < levelDecls.Num(); i++ ) {
+		idDeclLocal *decl = levelDecls[i];
+		if ( decl->declState == DS_UNPARSED && decl->textSource != NULL && decl->preparedText == NULL ) {
+			declJobs->AddJob( idDeclLocal::PrepareTextJob, decl );
+		}
+	}
+
+	int numJobs = declJobs->NumJobs();
+	declJobs->Submit();
+	declJobs->Wait();
+
+	common->DPrintf( "%d decls prepared in %d msec\n", numJobs, Sys_Milliseconds() - start );
 }
 
 /*
@@ -980,6 +1315,15 @@ void idDeclManagerLocal::RegisterDeclType( const char *typeName, declType_t type
 		declTypes.AssureSize( (int)type + 1, NULL );
 	}
 	declTypes[type] = declType;
+
+	// decl cache entries are only valid with the same decl types registered
+	idStr typeNames;
+	for ( int i = 0; i < declTypes.Num(); i++ ) {
+		if ( declTypes[i] ) {
+			typeNames += va( "%s %d\n", declTypes[i]->typeName.c_str(), declTypes[i]->type );
+		}
+	}
+	typesChecksum = MD5_BlockChecksum( typeNames.c_str(), typeNames.Length() );
 }
 
 /*
@@ -1013,7 +1357,10 @@ void idDeclManagerLocal::RegisterDeclFolder( const char *folder, const char *ext
 	// scan for decl files
 	fileList = fileSystem->ListFiles( declFolder->folder, declFolder->extension, true );
 
-	// load and parse decl files
+	idList<idDeclFile *> files;
+	files.SetGranularity( 64 );
+
+	// find or create the decl files
 	for ( i = 0; i < fileList->GetNumFiles(); i++ ) {
 		fileName = declFolder->folder + "/" + fileList->GetFile( i );
 
@@ -1029,10 +1376,362 @@ void idDeclManagerLocal::RegisterDeclFolder( const char *folder, const char *ext
 			df = new idDeclFile( fileName, defaultType );
 			loadedFiles.Append( df );
 		}
-		df->LoadAndParse();
+		files.Append( df );
 	}
 
 	fileSystem->FreeFileList( fileList );
+
+	// load and parse decl files
+	LoadAndParseFiles( files );
+}
+
+/*
+===================
+idDeclManagerLocal::LoadAndParseFiles
+
+Files with an up to date decl cache entry are not read at all. The file system
+isn't thread-safe, so the other files are read on the main thread and only
+scanned on the job threads. The scanned decls are added in file order which
+keeps the decl indices and GetChecksum() the same as with a serial load.
+===================
+*/
+void idDeclManagerLocal::LoadAndParseFiles( const idList<idDeclFile *> &files ) {
+	idList<idDeclFileLoad> loads;
+	bool parallel;
+	int i;
+
+#ifdef GET_HUFFMAN_FREQUENCIES
+	parallel = false;
+#else
+	parallel = decl_parallelParse.GetBool() && files.Num() > 1;
+#endif
+
+	loads.SetNum( files.Num() );
+	for ( i = 0; i < files.Num(); i++ ) {
+		files[i]->GetCacheKey( loads[i] );
+		if ( ReadCacheEntry( files[i], loads[i] ) ) {
+			continue;
+		}
+		if ( !files[i]->Load( loads[i] ) ) {
+			continue;
+		}
+		if ( parallel ) {
+			declJobs->AddJob( idDeclFile::ScanJob, &loads[i] );
+		} else {
+			files[i]->Scan( loads[i], false );
+		}
+	}
+
+	if ( declJobs->NumJobs() ) {
+		declJobs->Submit();
+		declJobs->Wait();
+	}
+
+	for ( i = 0; i < files.Num(); i++ ) {
+		if ( !loads[i].loaded ) {
+			continue;
+		}
+		if ( !loads[i].scanned ) {
+			files[i]->Scan( loads[i], false );
+		}
+		files[i]->Merge( loads[i] );
+	}
+}
+
+/*
+====================================================================================
+
+ binary decl cache
+
+ The scanned form of every decl file, with the compressed decl text, is kept
+ in fs_savepath so unchanged files are neither read nor lexed on startup.
+ The cache is memory mapped at Init and rewritten on level load or Shutdown
+ when an entry changed.
+
+====================================================================================
+*/
+
+/*
+===================
+idDeclManagerLocal::OpenDeclCache
+===================
+*/
+void idDeclManagerLocal::OpenDeclCache( void ) {
+	int ident, version, huffmanChecksum, numEntries, entryLength;
+	idStr name;
+
+	cacheEntryNames.Clear();
+	cacheEntryOffsets.Clear();
+	cacheEntryHash.Clear();
+
+	if ( !decl_cache.GetBool() ) {
+		return;
+	}
+
+	if ( !Sys_MapFile( fileSystem->RelativePathToOSPath( DECL_CACHE_FILENAME, "fs_savepath" ), cacheMapping ) ) {
+		return;
+	}
+
+	idFile_Memory f( DECL_CACHE_FILENAME, (const char *)cacheMapping.data, cacheMapping.length );
+
+	f.ReadInt( ident );
+	f.ReadInt( version );
+	f.ReadInt( huffmanChecksum );
+	f.ReadInt( numEntries );
+	if ( ident != DECL_CACHE_IDENT || version != DECL_CACHE_VERSION || huffmanChecksum != MD5_BlockChecksum( huffmanFrequencies, sizeof( huffmanFrequencies ) ) ) {
+		common->DPrintf( "ignoring out of date %s\n", DECL_CACHE_FILENAME );
+		CloseDeclCache();
+		return;
+	}
+
+	for ( int i = 0; i < numEntries; i++ ) {
+		int offset = f.Tell();
+		if ( f.ReadInt( entryLength ) != sizeof( int ) || entryLength < 0 || entryLength > f.Length() - f.Tell() ) {
+			break;
+		}
+		int nameLength;
+		f.ReadInt( nameLength );
+		if ( nameLength <= 0 || nameLength >= MAX_OSPATH || nameLength > f.Length() - f.Tell() ) {
+			break;
+		}
+		name.Fill( ' ', nameLength );
+		f.Read( &name[0], nameLength );
+		cacheEntryHash.Add( cacheEntryHash.GenerateKey( name, false ), cacheEntryNames.Append( name ) );
+		cacheEntryOffsets.Append( offset );
+		f.Seek( offset + sizeof( int ) + entryLength, FS_SEEK_SET );
+	}
+
+	common->Printf( "%d decl files in %s\n", cacheEntryNames.Num(), DECL_CACHE_FILENAME );
+}
+
+/*
+===================
+idDeclManagerLocal::CloseDeclCache
+===================
+*/
+void idDeclManagerLocal::CloseDeclCache( void ) {
+	Sys_UnmapFile( cacheMapping );
+	cacheEntryNames.Clear();
+	cacheEntryOffsets.Clear();
+	cacheEntryHash.Clear();
+}
+
+/*
+===================
+idDeclManagerLocal::WriteDeclCache
+
+Writes the pending entries together with the still valid entries of the
+current cache and maps the new cache.
+===================
+*/
+void idDeclManagerLocal::WriteDeclCache( void ) {
+	idList<const char *> entries;
+	idList<int> entryLengths;
+	int i, j, hash;
+
+	if ( !cacheDirty || !decl_cache.GetBool() ) {
+		return;
+	}
+	cacheDirty = false;
+
+	for ( i = 0; i < loadedFiles.Num(); i++ ) {
+		idDeclFile *file = loadedFiles[i];
+
+		if ( !file->cacheValid ) {
+			continue;
+		}
+		if ( file->cacheEntry != NULL ) {
+			entries.Append( file->cacheEntry->GetDataPtr() );
+			entryLengths.Append( file->cacheEntry->Length() );
+			continue;
+		}
+		hash = cacheEntryHash.GenerateKey( file->fileName, false );
+		for ( j = cacheEntryHash.First( hash ); j >= 0; j = cacheEntryHash.Next( j ) ) {
+			if ( cacheEntryNames[j].Icmp( file->fileName ) == 0 ) {
+				const char *entry = (const char *)cacheMapping.data + cacheEntryOffsets[j];
+				int entryLength;
+				memcpy( &entryLength, entry, sizeof( int ) );
+				entries.Append( entry );
+				entryLengths.Append( sizeof( int ) + LittleInt( entryLength ) );
+				break;
+			}
+		}
+	}
+
+	idFile_Memory f( DECL_CACHE_FILENAME );
+	f.SetGranularity( 1 << 20 );
+
+	f.WriteInt( DECL_CACHE_IDENT );
+	f.WriteInt( DECL_CACHE_VERSION );
+	f.WriteInt( MD5_BlockChecksum( huffmanFrequencies, sizeof( huffmanFrequencies ) ) );
+	f.WriteInt( entries.Num() );
+	for ( i = 0; i < entries.Num(); i++ ) {
+		f.Write( entries[i], entryLengths[i] );
+	}
+
+	// the old cache can't be overwritten while it is mapped
+	CloseDeclCache();
+
+	fileSystem->WriteFile( DECL_CACHE_FILENAME, f.GetDataPtr(), f.Length() );
+
+	for ( i = 0; i < loadedFiles.Num(); i++ ) {
+		delete loadedFiles[i]->cacheEntry;
+		loadedFiles[i]->cacheEntry = NULL;
+	}
+
+	OpenDeclCache();
+}
+
+/*
+===================
+idDeclManagerLocal::ReadCacheEntry
+===================
+*/
+bool idDeclManagerLocal::ReadCacheEntry( idDeclFile *file, idDeclFileLoad &load ) {
+	int i, hash, entryLength, defaultType, entryTypesChecksum, pakChecksum, timestamp, length, numDecls;
+	idStr name;
+
+	if ( cacheMapping.data == NULL || load.length < 0 ) {
+		return false;
+	}
+
+	hash = cacheEntryHash.GenerateKey( file->fileName, false );
+	for ( i = cacheEntryHash.First( hash ); i >= 0; i = cacheEntryHash.Next( i ) ) {
+		if ( cacheEntryNames[i].Icmp( file->fileName ) == 0 ) {
+			break;
+		}
+	}
+	if ( i < 0 ) {
+		return false;
+	}
+
+	idFile_Memory f( DECL_CACHE_FILENAME, (const char *)cacheMapping.data, cacheMapping.length );
+	f.Seek( cacheEntryOffsets[i], FS_SEEK_SET );
+	f.ReadInt( entryLength );
+	f.ReadString( name );
+	f.ReadInt( defaultType );
+	f.ReadInt( entryTypesChecksum );
+	f.ReadInt( pakChecksum );
+	f.ReadInt( timestamp );
+	f.ReadInt( length );
+
+	if ( defaultType != file->defaultType || entryTypesChecksum != typesChecksum ||
+			pakChecksum != load.pakChecksum || timestamp != (int)load.timestamp || length != load.length ) {
+		return false;
+	}
+
+	int end = cacheEntryOffsets[i] + sizeof( int ) + entryLength;
+
+	f.ReadInt( load.checksum );
+	f.ReadInt( load.numLines );
+	f.ReadInt( numDecls );
+	if ( numDecls < 0 || numDecls > ( end - f.Tell() ) / (int)( 8 * sizeof( int ) ) ) {
+		common->Warning( "corrupt %s entry for %s", DECL_CACHE_FILENAME, file->fileName.c_str() );
+		return false;
+	}
+
+	load.decls.SetNum( numDecls );
+	for ( i = 0; i < numDecls; i++ ) {
+		declScan_t &scan = load.decls[i];
+		int type, nameLength;
+
+		f.ReadInt( type );
+		f.ReadInt( nameLength );
+		if ( type < 0 || type >= declTypes.Num() || declTypes[type] == NULL || nameLength <= 0 || nameLength > end - f.Tell() ) {
+			break;
+		}
+		scan.type = (declType_t)type;
+		scan.name.Fill( ' ', nameLength );
+		f.Read( &scan.name[0], nameLength );
+		f.ReadInt( scan.sourceTextOffset );
+		f.ReadInt( scan.sourceTextLength );
+		f.ReadInt( scan.sourceLine );
+		f.ReadInt( scan.checksum );
+		f.ReadInt( scan.compressedLength );
+		if ( scan.compressedLength < 0 || scan.compressedLength > end - f.Tell() ) {
+			break;
+		}
+		scan.textSource = (char *)Mem_Alloc( scan.compressedLength );
+		f.Read( scan.textSource, scan.compressedLength );
+	}
+
+	if ( i < numDecls || f.Tell() != end ) {
+		common->Warning( "corrupt %s entry for %s", DECL_CACHE_FILENAME, file->fileName.c_str() );
+		for ( int j = 0; j < i; j++ ) {
+			Mem_Free( load.decls[j].textSource );
+		}
+		load.decls.Clear();
+		return false;
+	}
+
+	common->DPrintf( "...loading '%s' from %s\n", file->fileName.c_str(), DECL_CACHE_FILENAME );
+
+	file->timestamp = load.timestamp;
+	file->cacheValid = true;
+
+	load.file = file;
+	load.loaded = true;
+	load.scanned = true;
+	load.fromCache = true;
+	return true;
+}
+
+/*
+===================
+idDeclManagerLocal::UpdateCacheEntry
+
+Called with the scan of a file that was read from disk.
+===================
+*/
+void idDeclManagerLocal::UpdateCacheEntry( idDeclFile *file, const idDeclFileLoad &load ) {
+	if ( !decl_cache.GetBool() ) {
+		return;
+	}
+
+	idFile_Memory entry;
+
+	entry.WriteString( file->fileName );
+	entry.WriteInt( file->defaultType );
+	entry.WriteInt( typesChecksum );
+	entry.WriteInt( load.pakChecksum );
+	entry.WriteInt( (int)load.timestamp );
+	entry.WriteInt( load.length );
+	entry.WriteInt( load.checksum );
+	entry.WriteInt( load.numLines );
+	entry.WriteInt( load.decls.Num() );
+
+	for ( int i = 0; i < load.decls.Num(); i++ ) {
+		const declScan_t &scan = load.decls[i];
+		entry.WriteInt( scan.type );
+		entry.WriteString( scan.name );
+		entry.WriteInt( scan.sourceTextOffset );
+		entry.WriteInt( scan.sourceTextLength );
+		entry.WriteInt( scan.sourceLine );
+		entry.WriteInt( scan.checksum );
+		entry.WriteInt( scan.compressedLength );
+		entry.Write( scan.textSource, scan.compressedLength );
+	}
+
+	delete file->cacheEntry;
+	file->cacheEntry = new idFile_Memory( file->fileName );
+	file->cacheEntry->WriteInt( entry.Length() );
+	file->cacheEntry->Write( entry.GetDataPtr(), entry.Length() );
+	file->cacheValid = true;
+	cacheDirty = true;
+}
+
+/*
+===================
+idDeclManagerLocal::InvalidateCacheEntry
+===================
+*/
+void idDeclManagerLocal::InvalidateCacheEntry( idDeclFile *file ) {
+	if ( file->cacheValid ) {
+		delete file->cacheEntry;
+		file->cacheEntry = NULL;
+		file->cacheValid = false;
+		cacheDirty = true;
+	}
 }
 
 /*
@@ -1738,6 +2437,7 @@ idDeclLocal *idDeclManagerLocal::FindTypeWithoutParsing( declType_t type, const
 	decl->declState = DS_UNPARSED;
 	decl->textSource = NULL;
 	decl->textLength = 0;
+	decl->preparedText = NULL;
 	decl->sourceFile = &implicitDecls;
 	decl->referencedThisLevel = false;
 	decl->everReferenced = false;
@@ -1768,6 +2468,7 @@ idDeclLocal::idDeclLocal( void ) {
 	name = "unnamed";
 	textSource = NULL;
 	textLength = 0;
+	preparedText = NULL;
 	compressedLength = 0;
 	sourceFile = NULL;
 	sourceTextOffset = 0;
@@ -1923,30 +2624,52 @@ idDeclLocal::SetTextLocal
 =================
 */
 void idDeclLocal::SetTextLocal( const char *text, const int length ) {
+	int textCompressedLength;
+	char *compressed = CompressDeclText( text, length, textCompressedLength );
+	SetCompressedTextLocal( compressed, length, textCompressedLength, MD5_BlockChecksum( text, length ) );
+}
+
+/*
+=================
+idDeclLocal::SetCompressedTextLocal
+=================
+*/
+void idDeclLocal::SetCompressedTextLocal( char *text, const int length, const int textCompressedLength, const int textChecksum ) {
 
 	Mem_Free( textSource );
+	FreePreparedText();
 
-	checksum = MD5_BlockChecksum( text, length );
+	totalUncompressedLength += length;
+	totalCompressedLength += textCompressedLength;
 
-#ifdef GET_HUFFMAN_FREQUENCIES
-	for( int i = 0; i < length; i++ ) {
-		huffmanFrequencies[((const unsigned char *)text)[i]]++;
+	checksum = textChecksum;
+	textSource = text;
+	textLength = length;
+	compressedLength = textCompressedLength;
+}
+
+/*
+=================
+idDeclLocal::FreePreparedText
+=================
+*/
+void idDeclLocal::FreePreparedText( void ) {
+	if ( preparedText != NULL ) {
+		Mem_Free( preparedText );
+		preparedText = NULL;
 	}
-#endif
+}
 
-#ifdef USE_COMPRESSED_DECLS
-	int maxBytesPerCode = ( maxHuffmanBits + 7 ) >> 3;
-	byte *compressed = (byte *)_alloca( length * maxBytesPerCode );
-	compressedLength = HuffmanCompressText( text, length, compressed, length * maxBytesPerCode );
-	textSource = (char *)Mem_Alloc( compressedLength );
-	memcpy( textSource, compressed, compressedLength );
-#else
-	compressedLength = length;
-	textSource = (char *) Mem_Alloc( length + 1 );
-	memcpy( textSource, text, length );
-	textSource[length] = '\0';
-#endif
-	textLength = length;
+/*
+=================
+idDeclLocal::PrepareTextJob
+=================
+*/
+void idDeclLocal::PrepareTextJob( void *data ) {
+	idDeclLocal *decl = (idDeclLocal *)data;
+	char *text = (char *) Mem_Alloc( decl->textLength + 1 );
+	decl->GetText( text );
+	decl->preparedText = text;
 }
 
 /*
@@ -2031,6 +2754,8 @@ bool idDeclLocal::ReplaceSourceFileText( void ) {
 	// set new size of text in source file
 	sourceTextLength = textLength;
 
+	declManagerLocal.InvalidateCacheEntry( sourceFile );
+
 	return true;
 }
 
@@ -2050,6 +2775,7 @@ bool idDeclLocal::SourceFileChanged( void ) const {
 	newLength = fileSystem->ReadFile( GetFileName(), NULL, &newTimestamp );
 
 	if ( newLength != sourceFile->fileSize || newTimestamp != sourceFile->timestamp ) {
+		declManagerLocal.InvalidateCacheEntry( sourceFile );
 		return true;
 	}
 
@@ -2201,10 +2927,17 @@ void idDeclLocal::ParseLocal( void ) {
 
 	declState = DS_PARSED;
 
-	// parse
-	char *declText = (char *) _alloca( ( GetTextLength() + 1 ) * sizeof( char ) );
-	GetText( declText );
-	self->Parse( declText, GetTextLength() );
+	// parse, using the text unpacked before the level load if there is any
+	if ( preparedText != NULL ) {
+		char *declText = preparedText;
+		preparedText = NULL;
+		self->Parse( declText, GetTextLength() );
+		Mem_Free( declText );
+	} else {
+		char *declText = (char *) _alloca( ( GetTextLength() + 1 ) * sizeof( char ) );
+		GetText( declText );
+		self->Parse( declText, GetTextLength() );
+	}
 
 	// free generated text
 	if ( generatedDefaultText ) {
@@ -1240,6 +1240,10 @@ idFile_InZip::idFile_InZip( void ) {
 	zipFilePos = 0;
 	fileSize = 0;
 	memset( &z, 0, sizeof( z ) );
+	mapped = NULL;
+	compressedSize = 0;
+	filePos = 0;
+	stream = NULL;
 }
 
 /*
@@ -1248,8 +1252,14 @@ idFile_InZip::~idFile_InZip
 =================
 */
 idFile_InZip::~idFile_InZip( void ) {
-	unzCloseCurrentFile( z );
-	unzClose( z );
+	if ( stream ) {
+		inflateEnd( stream );
+		delete stream;
+	}
+	if ( z ) {
+		unzCloseCurrentFile( z );
+		unzClose( z );
+	}
 }
 
 /*
@@ -1260,11 +1270,63 @@ Properly handles partial reads
 =================
 */
 int idFile_InZip::Read( void *buffer, int len ) {
-	int l = unzReadCurrentFile( z, buffer, len );
+	int l = mapped ? ReadMapped( buffer, len ) : unzReadCurrentFile( z, buffer, len );
 	fileSystem->AddToReadCount( l );
 	return l;
 }
 
+/*
+=================
+idFile_InZip::ReadMapped
+
+Stored files are copied straight out of the mapping, deflated files are inflated from it
+=================
+*/
+int idFile_InZip::ReadMapped( void *buffer, int len ) {
+	if ( len > fileSize - filePos ) {
+		len = fileSize - filePos;
+	}
+	if ( len <= 0 ) {
+		return 0;
+	}
+
+	if ( stream == NULL ) {
+		memcpy( buffer, mapped + filePos, len );
+		filePos += len;
+		return len;
+	}
+
+	stream->next_out = (Bytef *)buffer;
+	stream->avail_out = len;
+	while ( stream->avail_out > 0 ) {
+		int err = inflate( stream, Z_SYNC_FLUSH );
+		if ( err != Z_OK ) {
+			break;
+		}
+	}
+	int l = len - stream->avail_out;
+	filePos += l;
+	return l;
+}
+
+/*
+=================
+idFile_InZip::ResetMapped
+=================
+*/
+bool idFile_InZip::ResetMapped( void ) {
+	filePos = 0;
+	if ( stream == NULL ) {
+		return true;
+	}
+	if ( inflateReset( stream ) != Z_OK ) {
+		return false;
+	}
+	stream->next_in = (Bytef *)mapped;
+	stream->avail_in = compressedSize;
+	return true;
+}
+
 /*
 =================
 idFile_InZip::Write
@@ -1299,6 +1361,9 @@ idFile_InZip::Tell
 =================
 */
 int idFile_InZip::Tell( void ) {
+	if ( mapped ) {
+		return filePos;
+	}
 	return unztell( z );
 }
 
@@ -1333,6 +1398,38 @@ int idFile_InZip::Seek( long offset, fsOrigin_t origin ) {
 	int res, i;
 	char *buf;
 
+	if ( mapped ) {
+		long target;
+
+		switch( origin ) {
+			case FS_SEEK_END:	target = fileSize - offset; break;
+			case FS_SEEK_SET:	target = offset; break;
+			case FS_SEEK_CUR:	target = filePos + offset; break;
+			default: {
+				common->FatalError( "idFile_InZip::Seek: bad origin for %s\n", name.c_str() );
+				return -1;
+			}
+		}
+		if ( target < 0 || target > fileSize ) {
+			return -1;
+		}
+		if ( stream == NULL ) {
+			filePos = target;
+			return 0;
+		}
+		// deflated data can only be skipped forward
+		if ( target < filePos && !ResetMapped() ) {
+			return -1;
+		}
+		buf = (char *) _alloca16( ZIP_SEEK_BUF_SIZE );
+		while ( filePos < target ) {
+			if ( ReadMapped( buf, Min( (long)ZIP_SEEK_BUF_SIZE, target - filePos ) ) <= 0 ) {
+				return -1;
+			}
+		}
+		return 0;
+	}
+
 	switch( origin ) {
 		case FS_SEEK_END: {
 			offset = fileSize - offset;
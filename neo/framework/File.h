@@ -237,12 +237,22 @@ public:
 	virtual void			Flush( void );
 	virtual int				Seek( long offset, fsOrigin_t origin );
 
+							// returns the file data inside the memory mapped pak, NULL unless the file is stored uncompressed in a mapped pak
+	const byte *			GetMappedData( void ) const { return ( mapped != NULL && stream == NULL ) ? mapped : NULL; }
+
 private:
 	idStr					name;			// name of the file in the pak
 	idStr					fullPath;		// full file path including pak file name
 	ZPOS64_T				zipFilePos;		// zip file info position in pak
 	int						fileSize;		// size of the file
 	void *					z;				// unzip info
+	const byte *			mapped;			// file data in the memory mapped pak, NULL when read through unzip
+	int						compressedSize;	// size of the mapped file data
+	int						filePos;		// current position when reading mapped data
+	z_stream *				stream;			// inflate state for deflated mapped data
+
+	int						ReadMapped( void *buffer, int len );
+	bool					ResetMapped( void );
 };
 
 #endif /* !__FILE_H__ */
@@ -259,6 +259,11 @@ static idInitExclusions	initExclusions;
 typedef struct fileInPack_s {
 	idStr				name;						// name of the file
 	ZPOS64_T			pos;						// file info position in zip
+	int					method;						// compression method, -1 if the file can only be read through unzip
+	int					crc;
+	int					compressedSize;
+	int					uncompressedSize;
+	int					localOffset;				// offset of the local file header in the pak
 	struct fileInPack_s * next;						// next file in the hash
 } fileInPack_t;
 
@@ -288,6 +293,7 @@ typedef struct {
 	bool				isNew;						// for downloaded paks
 	fileInPack_t		*hashTable[FILE_HASH_SIZE];
 	fileInPack_t		*buildBuffer;
+	sysMappedFile_t		mapping;					// whole pak mapped into memory, data is NULL if not mapped
 } pack_t;
 
 typedef struct {
@@ -311,6 +317,51 @@ typedef struct searchpath_s {
 // + .jpg and .tga
 #define MAX_CACHED_DIRS 6
 
+#define MAX_ASYNC_READ_THREADS	8
+#define ASYNC_READ_LOCK			CRITICAL_SECTION_THREE	// guards the async read queue and request states
+#define ASYNC_PREFETCH_TIMEOUT	10000					// msec a finished prefetch is kept when nobody reads it
+
+typedef enum {
+	ASYNC_QUEUED,
+	ASYNC_READING,
+	ASYNC_DONE
+} asyncReadState_t;
+
+typedef struct {
+	int					handle;
+	idStr				relativePath;
+	idFile *			file;						// opened on the main thread, NULL if the file wasn't found
+	const pack_t *		pak;						// reads from the same pak are sorted by their position in it
+	int					pakPos;
+	fsAsyncPriority_t	priority;
+	int					sequence;
+	fsAsyncCallback_t	callback;
+	void *				data;
+	bool				prefetch;
+	bool				cancelled;					// freed by the I/O thread when it's done reading
+	asyncReadState_t	state;
+	int					length;
+	ID_TIME_T			timestamp;
+	byte *				buffer;
+	double				queueTime;
+	int					finishTime;
+} asyncRead_t;
+
+typedef struct {
+	int					numReads;
+	int					numPrefetches;
+	int					numPrefetchesUsed;
+	int					numPrefetchesDropped;
+	int					numCancelled;
+	int					numNotFound;
+	int					numSamePak;					// reads that continued in the pak of the previous read on that thread
+	int					maxQueued;
+	int64_t				bytesRead;
+	double				readTime;					// usec spent reading on the I/O threads
+	double				queueTime;					// usec reads waited in the queue
+	double				stallTime;					// usec the main thread waited for reads
+} asyncReadStats_t;
+
 // how many OSes to handle game paks for ( we don't have to know them precisely )
 #define BINARY_CONFIG "binary.conf"
 #define ADDON_CONFIG "addon.conf"
@@ -355,6 +406,7 @@ public:
 	virtual void			SetRestartChecksums( const int pureChecksums[ MAX_PURE_PAKS ] );
 	virtual	void			ClearPureChecksums( void );
 	virtual int				ReadFile( const char *relativePath, void **buffer, ID_TIME_T *timestamp );
+	virtual int				GetFileInfo( const char *relativePath, ID_TIME_T *timestamp, int *pakChecksum );
 	virtual void			FreeFile( void *buffer );
 	virtual int				WriteFile( const char *relativePath, const void *buffer, int size, const char *basePath = "fs_savepath" );
 	virtual void			RemoveFile( const char *relativePath );
@@ -367,8 +419,14 @@ public:
 	virtual idFile *		OpenExplicitFileWrite( const char *OSPath );
 	virtual void			CloseFile( idFile *f );
 	virtual void			BackgroundDownload( backgroundDownload_t *bgl );
+	virtual int				ReadFileAsync( const char *relativePath, fsAsyncPriority_t priority = FS_ASYNC_PRIORITY_NORMAL, fsAsyncCallback_t callback = NULL, void *data = NULL );
+	virtual bool			AsyncReadDone( int handle );
+	virtual int				FinishAsyncRead( int handle, void **buffer, ID_TIME_T *timestamp = NULL );
+	virtual void			CancelAsyncRead( int handle );
+	virtual void			PrefetchFile( const char *relativePath );
+	virtual void			UpdateAsyncReads( void );
 	virtual void			ResetReadCount( void ) { readCount = 0; }
-	virtual void			AddToReadCount( int c ) { readCount += c; }
+	virtual void			AddToReadCount( int c );
 	virtual int				GetReadCount( void ) { return readCount; }
 	virtual void			FindDLL( const char *basename, char dllPath[ MAX_OSPATH ] );
 	virtual void			ClearDirCache( void );
@@ -389,12 +447,15 @@ public:
 	static void				Path_f( const idCmdArgs &args );
 	static void				TouchFile_f( const idCmdArgs &args );
 	static void				TouchFileList_f( const idCmdArgs &args );
+	static void				Benchmark_f( const idCmdArgs &args );
+	static void				AsyncStats_f( const idCmdArgs &args );
 
 private:
 	friend int				BackgroundDownloadThread( void *pexit );
+	friend int				AsyncReadThread( void *parms );
 
 	searchpath_t *			searchPaths;
-	int						readCount;			// total bytes read
+	volatile int			readCount;			// total bytes read, the async read threads add to it as well
 	int						loadCount;			// total files read
 	int						loadStack;			// total files in memory
 	idStr					gameFolder;			// this will be a single name without separators
@@ -415,6 +476,10 @@ private:
 	static idCVar			fs_game_base;
 	static idCVar			fs_caseSensitiveOS;
 	static idCVar			fs_searchAddons;
+	static idCVar			fs_mmapPaks;
+	static idCVar			fs_pakIndex;
+	static idCVar			fs_asyncLoad;
+	static idCVar			fs_asyncThreads;
 
 	backgroundDownload_t *	backgroundDownloads;
 	backgroundDownload_t	defaultBackgroundDownload;
@@ -432,6 +497,18 @@ private:
 
 	int						d3xp;	// 0: didn't check, -1: not installed, 1: installed
 
+	idList<asyncRead_t *>	asyncReads;				// indexed by the low bits of the handles, only touched by the main thread
+	idList<int>				asyncFreeSlots;
+	idHashIndex				asyncPrefetchHash;		// prefetched files by name
+	idList<asyncRead_t *>	asyncQueue;				// heap of the queued reads, guarded by ASYNC_READ_LOCK
+	int						asyncSequence;
+	int						numAsyncThreads;
+	xthreadInfo				asyncThreads[MAX_ASYNC_READ_THREADS];
+	sysSemaphore_t *		asyncQueued;			// posted for every queued read
+	sysSemaphore_t *		asyncDone;				// posted for every finished read
+	volatile bool			asyncThreadsExit;
+	asyncReadStats_t		asyncStats;
+
 private:
 	void					ReplaceSeparators( idStr &path, char sep = PATHSEPERATOR_CHAR );
 	int						HashFileName( const char *fname ) const;
@@ -446,6 +523,12 @@ private:
 
 	int						GetFileListTree( const char *relativePath, const idStrList &extensions, idStrList &list, idHashIndex &hashIndex, const char* gamedir = NULL );
 	pack_t *				LoadZipFile( const char *zipfile );
+	bool					ParseZipDirectory( pack_t *pack, FILE *f );
+	bool					WalkZipDirectory( pack_t *pack, unzFile uf );
+	void					HashZipDirectory( pack_t *pack );
+	idStr					GetPakIndexPath( const char *zipfile );
+	bool					ReadPakIndex( pack_t *pack, ID_TIME_T timestamp );
+	void					WritePakIndex( const pack_t *pack, ID_TIME_T timestamp );
 	void					AddGameDirectory( const char *path, const char *dir );
 	void					SetupGameDirectories( const char *gameName );
 	void					Startup( void );
@@ -455,7 +538,18 @@ private:
 	pack_t *				GetPackForChecksum( int checksum, bool searchAddons = false );
 							// searches all the paks, no pure check
 	pack_t *				FindPakForFileChecksum( const char *relativePath, int fileChecksum, bool bReference );
-	idFile_InZip *			ReadFileFromZip( pack_t *pak, fileInPack_t *pakFile, const char *relativePath );
+	void					StartAsyncReadThreads( void );
+	void					StopAsyncReadThreads( void );
+	asyncRead_t *			GetAsyncRead( int handle ) const;
+	void					FreeAsyncRead( asyncRead_t *read );
+	int						FindPrefetch( const char *relativePath ) const;
+	double					ReadAsyncFile( asyncRead_t *read );
+	void					PushAsyncQueue( asyncRead_t *read );
+	asyncRead_t *			PopAsyncQueue( void );
+	void					RemoveAsyncQueue( asyncRead_t *read );
+	void					ReleaseAsyncRead( asyncRead_t *read );
+	void					WaitForAsyncRead( asyncRead_t *read );
+	idFile_InZip *			ReadFileFromZip( pack_t *pak, fileInPack_t *pakFile, const char *relativePath, bool allowMapped = true );
 	int						GetFileChecksum( idFile *file );
 	pureStatus_t			GetPackStatus( pack_t *pak );
 	addonInfo_t *			ParseAddonDef( const char *buf, const int len );
@@ -482,10 +576,34 @@ idCVar	idFileSystemLocal::fs_caseSensitiveOS( "fs_caseSensitiveOS", "0", CVAR_SY
 idCVar	idFileSystemLocal::fs_caseSensitiveOS( "fs_caseSensitiveOS", "1", CVAR_SYSTEM | CVAR_BOOL, "" );
 #endif
 idCVar	idFileSystemLocal::fs_searchAddons( "fs_searchAddons", "0", CVAR_SYSTEM | CVAR_BOOL, "search all addon pk4s ( disables addon functionality )" );
+// mapping every pak needs a lot of address space, so only do it by default on 64bit
+#if D3_SIZEOFPTR == 8
+idCVar	idFileSystemLocal::fs_mmapPaks( "fs_mmapPaks", "1", CVAR_SYSTEM | CVAR_INIT | CVAR_BOOL, "memory map pk4 files and read files straight from the mapping" );
+#else
+idCVar	idFileSystemLocal::fs_mmapPaks( "fs_mmapPaks", "0", CVAR_SYSTEM | CVAR_INIT | CVAR_BOOL, "memory map pk4 files and read files straight from the mapping" );
+#endif
+idCVar	idFileSystemLocal::fs_asyncLoad( "fs_asyncLoad", "1", CVAR_SYSTEM | CVAR_BOOL, "read prefetched files on the I/O threads" );
+idCVar	idFileSystemLocal::fs_asyncThreads( "fs_asyncThreads", "2", CVAR_SYSTEM | CVAR_INIT | CVAR_INTEGER, "number of I/O threads for asynchronous reads, 0 reads on the main thread", 0, MAX_ASYNC_READ_THREADS );
+idCVar	idFileSystemLocal::fs_pakIndex( "fs_pakIndex", "1", CVAR_SYSTEM | CVAR_BOOL, "cache the pk4 directories in <fs_savepath>/pk4index instead of parsing them on every startup" );
 
 idFileSystemLocal	fileSystemLocal;
 idFileSystem *		fileSystem = &fileSystemLocal;
 
+/*
+================
+idFileSystemLocal::AddToReadCount
+
+  called by the async read threads as well
+================
+*/
+void idFileSystemLocal::AddToReadCount( int c ) {
+#ifdef _WIN32
+	InterlockedExchangeAdd( (volatile LONG *)&readCount, c );
+#else
+	__sync_fetch_and_add( &readCount, c );
+#endif
+}
+
 /*
 ================
 idFileSystemLocal::idFileSystemLocal
@@ -503,6 +621,13 @@ idFileSystemLocal::idFileSystemLocal( void ) {
 	memset( &backgroundThread, 0, sizeof( backgroundThread ) );
 	backgroundThread_exit = false;
 	addonPaks = NULL;
+	asyncSequence = 0;
+	numAsyncThreads = 0;
+	memset( asyncThreads, 0, sizeof( asyncThreads ) );
+	asyncQueued = NULL;
+	asyncDone = NULL;
+	asyncThreadsExit = false;
+	memset( &asyncStats, 0, sizeof( asyncStats ) );
 }
 
 /*
@@ -1079,6 +1204,20 @@ int idFileSystemLocal::ReadFile( const char *relativePath, void **buffer, ID_TIM
 		isConfig = false;
 	}
 
+	// a prefetched file only has to be waited for
+	if ( !isConfig ) {
+		int slot = FindPrefetch( relativePath );
+		if ( slot != -1 ) {
+			if ( !buffer ) {
+				if ( timestamp ) {
+					*timestamp = asyncReads[slot]->timestamp;
+				}
+				return asyncReads[slot]->length;
+			}
+			return FinishAsyncRead( asyncReads[slot]->handle, buffer, timestamp );
+		}
+	}
+
 	// look for it in the filesystem or pack files
 	f = OpenFileRead( relativePath, ( buffer != NULL ) );
 	if ( f == NULL ) {
@@ -1121,6 +1260,38 @@ int idFileSystemLocal::ReadFile( const char *relativePath, void **buffer, ID_TIM
 	return len;
 }
 
+/*
+=============
+idFileSystemLocal::GetFileInfo
+=============
+*/
+int idFileSystemLocal::GetFileInfo( const char *relativePath, ID_TIME_T *timestamp, int *pakChecksum ) {
+	pack_t *	pak;
+	idFile *	f;
+	int			len;
+
+	if ( !searchPaths ) {
+		common->FatalError( "Filesystem call made without initialization\n" );
+	}
+
+	*timestamp = FILE_NOT_FOUND_TIMESTAMP;
+	*pakChecksum = 0;
+
+	pak = NULL;
+	f = OpenFileReadFlags( relativePath, FSFLAG_SEARCH_DIRS | FSFLAG_SEARCH_PAKS, &pak, false );
+	if ( f == NULL ) {
+		return -1;
+	}
+	len = f->Length();
+	*timestamp = f->Timestamp();
+	if ( pak ) {
+		*pakChecksum = pak->checksum;
+	}
+	CloseFile( f );
+
+	return len;
+}
+
 /*
 =============
 idFileSystemLocal::FreeFile
@@ -1266,25 +1437,372 @@ addonInfo_t *idFileSystemLocal::ParseAddonDef( const char *buf, const int len )
 	return NULL;
 }
 
+#define ZIP_LOCAL_HEADER_SIGNATURE		0x04034b50
+#define ZIP_LOCAL_HEADER_SIZE			30
+#define ZIP_CENTRAL_HEADER_SIGNATURE	0x02014b50
+#define ZIP_CENTRAL_HEADER_SIZE			46
+#define ZIP_END_SIGNATURE				0x06054b50
+#define ZIP_END_SIZE					22
+#define ZIP_MAX_COMMENT					0xffff
+
+#define PAK_INDEX_IDENT					( ( 'X' << 24 ) + ( 'I' << 16 ) + ( 'K' << 8 ) + 'P' )
+#define PAK_INDEX_VERSION				1
+
+static ID_INLINE int ZipShort( const byte *p ) {
+	return p[0] | ( p[1] << 8 );
+}
+
+static ID_INLINE unsigned int ZipLong( const byte *p ) {
+	return p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) | ( (unsigned int)p[3] << 24 );
+}
+
+/*
+=================
+idFileSystemLocal::ParseZipDirectory
+
+Reads the zip central directory straight from the mapping, or with two reads if the pak
+isn't mapped. Returns false for anything unzip has to deal with, like zip64 archives.
+=================
+*/
+bool idFileSystemLocal::ParseZipDirectory( pack_t *pack, FILE *f ) {
+	const byte *	tail;
+	const byte *	dir;
+	byte *			buffer = NULL;
+	int				tailOffset, tailLength;
+	int				endOffset, dirOffset, dirLength, dirStart;
+	int				numEntries, i, p;
+
+	// find the end of central directory record, which is followed by at most a comment
+	tailLength = Min( pack->length, ZIP_END_SIZE + ZIP_MAX_COMMENT );
+	tailOffset = pack->length - tailLength;
+	if ( tailLength < ZIP_END_SIZE ) {
+		return false;
+	}
+	if ( pack->mapping.data ) {
+		tail = (const byte *)pack->mapping.data + tailOffset;
+	} else {
+		buffer = (byte *)Mem_Alloc( tailLength );
+		if ( fseek( f, tailOffset, SEEK_SET ) != 0 || (int)fread( buffer, 1, tailLength, f ) != tailLength ) {
+			Mem_Free( buffer );
+			return false;
+		}
+		tail = buffer;
+	}
+	for ( endOffset = tailLength - ZIP_END_SIZE; endOffset >= 0; endOffset-- ) {
+		if ( ZipLong( tail + endOffset ) == ZIP_END_SIGNATURE ) {
+			break;
+		}
+	}
+	if ( endOffset < 0 || ZipShort( tail + endOffset + 4 ) != 0 || ZipShort( tail + endOffset + 6 ) != 0 ) {
+		// no end record or a multi disk archive
+		Mem_Free( buffer );
+		return false;
+	}
+	numEntries = ZipShort( tail + endOffset + 10 );
+	dirLength = ZipLong( tail + endOffset + 12 );
+	dirOffset = ZipLong( tail + endOffset + 16 );
+	endOffset += tailOffset;
+	Mem_Free( buffer );
+	buffer = NULL;
+
+	// zip64 archives store 0xffff/0xffffffff here and the real values in another record
+	if ( numEntries == 0xffff || dirLength < 0 || dirOffset < 0 || dirLength > endOffset ) {
+		return false;
+	}
+	// data prepended to the zip file shifts all offsets, just like in unzip
+	dirStart = endOffset - dirLength;
+	const int bytesBefore = dirStart - dirOffset;
+	if ( bytesBefore < 0 ) {
+		return false;
+	}
+
+	if ( pack->mapping.data ) {
+		dir = (const byte *)pack->mapping.data + dirStart;
+	} else {
+		buffer = (byte *)Mem_Alloc( dirLength + 1 );
+		if ( fseek( f, dirStart, SEEK_SET ) != 0 || (int)fread( buffer, 1, dirLength, f ) != dirLength ) {
+			Mem_Free( buffer );
+			return false;
+		}
+		dir = buffer;
+	}
+
+	fileInPack_t *buildBuffer = new fileInPack_t[numEntries];
+	for ( i = 0, p = 0; i < numEntries; i++ ) {
+		if ( p + ZIP_CENTRAL_HEADER_SIZE > dirLength || ZipLong( dir + p ) != ZIP_CENTRAL_HEADER_SIGNATURE ) {
+			break;
+		}
+		const byte *header = dir + p;
+		const int nameLength = ZipShort( header + 28 );
+		const int entryLength = ZIP_CENTRAL_HEADER_SIZE + nameLength + ZipShort( header + 30 ) + ZipShort( header + 32 );
+		const unsigned int compressedSize = ZipLong( header + 20 );
+		const unsigned int uncompressedSize = ZipLong( header + 24 );
+		const unsigned int localOffset = ZipLong( header + 42 );
+		if ( p + entryLength > dirLength || nameLength >= MAX_ZIPPED_FILE_NAME ) {
+			break;
+		}
+		if ( compressedSize >= 0x7fffffff || uncompressedSize >= 0x7fffffff || localOffset >= (unsigned int)( dirOffset ) ) {
+			break;
+		}
+
+		fileInPack_t &file = buildBuffer[i];
+		file.name.Clear();
+		file.name.Append( (const char *)header + ZIP_CENTRAL_HEADER_SIZE, nameLength );
+		file.name.ToLower();
+		file.name.BackSlashesToSlashes();
+		// same value unzGetOffset64 gives for this file, so ReadFileFromZip can always fall back to unzip
+		file.pos = dirOffset + p;
+		file.crc = ZipLong( header + 16 );
+		file.compressedSize = compressedSize;
+		file.uncompressedSize = uncompressedSize;
+		file.localOffset = bytesBefore + localOffset;
+		// encrypted files are left to unzip
+		file.method = ( ZipShort( header + 8 ) & 1 ) ? -1 : ZipShort( header + 10 );
+		p += entryLength;
+	}
+	Mem_Free( buffer );
+
+	if ( i != numEntries ) {
+		delete[] buildBuffer;
+		return false;
+	}
+
+	pack->numfiles = numEntries;
+	pack->buildBuffer = buildBuffer;
+	return true;
+}
+
+/*
+=================
+idFileSystemLocal::WalkZipDirectory
+
+Builds the file list through unzip, files found this way are never read from the mapping
+=================
+*/
+bool idFileSystemLocal::WalkZipDirectory( pack_t *pack, unzFile uf ) {
+	unz_global_info64 gi;
+	char			filename_inzip[MAX_ZIPPED_FILE_NAME];
+	unz_file_info64	file_info;
+	int				i, err;
+
+	err = unzGetGlobalInfo64( uf, &gi );
+	if ( err != UNZ_OK ) {
+		return false;
+	}
+
+	fileInPack_t *buildBuffer = new fileInPack_t[gi.number_entry];
+
+	unzGoToFirstFile(uf);
+	for ( i = 0; i < (int)gi.number_entry; i++ ) {
+		err = unzGetCurrentFileInfo64( uf, &file_info, filename_inzip, sizeof(filename_inzip), NULL, 0, NULL, 0 );
+		if ( err != UNZ_OK ) {
+			break;
+		}
+		buildBuffer[i].name = filename_inzip;
+		buildBuffer[i].name.ToLower();
+		buildBuffer[i].name.BackSlashesToSlashes();
+		// store the file position in the zip
+		buildBuffer[i].pos = unzGetOffset64( uf );
+		buildBuffer[i].method = -1;
+		buildBuffer[i].crc = file_info.crc;
+		buildBuffer[i].compressedSize = file_info.compressed_size;
+		buildBuffer[i].uncompressedSize = file_info.uncompressed_size;
+		buildBuffer[i].localOffset = 0;
+		// go to the next file in the zip
+		unzGoToNextFile(uf);
+	}
+
+	// entries after a broken one stay unnamed and are never found, like before
+	for ( ; i < (int)gi.number_entry; i++ ) {
+		buildBuffer[i].pos = 0;
+		buildBuffer[i].method = -1;
+		buildBuffer[i].crc = 0;
+		buildBuffer[i].compressedSize = 0;
+		buildBuffer[i].uncompressedSize = 0;
+		buildBuffer[i].localOffset = 0;
+	}
+
+	pack->numfiles = gi.number_entry;
+	pack->buildBuffer = buildBuffer;
+	return true;
+}
+
+/*
+=================
+idFileSystemLocal::HashZipDirectory
+
+Links the files into the hash table and computes the pak checksum
+=================
+*/
+void idFileSystemLocal::HashZipDirectory( pack_t *pack ) {
+	int i, hash, numHeaderLongs;
+	int *headerLongs;
+
+	for( i = 0; i < FILE_HASH_SIZE; i++ ) {
+		pack->hashTable[i] = NULL;
+	}
+
+	numHeaderLongs = 0;
+	headerLongs = (int *)Mem_ClearedAlloc( ( pack->numfiles + 1 ) * sizeof(int) );
+	for ( i = 0; i < pack->numfiles; i++ ) {
+		fileInPack_t *file = &pack->buildBuffer[i];
+		if ( file->uncompressedSize > 0 ) {
+			headerLongs[numHeaderLongs++] = LittleInt( file->crc );
+		}
+		if ( file->name.Length() == 0 ) {
+			continue;
+		}
+		hash = HashFileName( file->name );
+		file->next = pack->hashTable[hash];
+		pack->hashTable[hash] = file;
+	}
+
+	pack->checksum = MD4_BlockChecksum( headerLongs, 4 * numHeaderLongs );
+	pack->checksum = LittleInt( pack->checksum );
+
+	Mem_Free( headerLongs );
+}
+
+/*
+=================
+idFileSystemLocal::GetPakIndexPath
+=================
+*/
+idStr idFileSystemLocal::GetPakIndexPath( const char *zipfile ) {
+	idStr fileName, pakName;
+
+	idStr( zipfile ).ExtractFileBase( pakName );
+	// paks with the same name in different folders get different index files
+	sprintf( fileName, "%s_%08x.idx", pakName.c_str(), idStr::IHash( zipfile ) );
+	return BuildOSPath( fs_savepath.GetString(), "pk4index", fileName );
+}
+
+/*
+=================
+idFileSystemLocal::ReadPakIndex
+
+The index is only used when the pak still has the size and timestamp it was written for
+=================
+*/
+bool idFileSystemLocal::ReadPakIndex( pack_t *pack, ID_TIME_T timestamp ) {
+	idStr	indexPath = GetPakIndexPath( pack->pakFilename );
+	idStr	pakFilename;
+	int		ident, version, length, time, numEntries, nameLength, i;
+
+	FILE *f = OpenOSFile( indexPath, "rb" );
+	if ( !f ) {
+		return false;
+	}
+	const int indexLength = DirectFileLength( f );
+	char *buffer = (char *)Mem_Alloc( indexLength + 1 );
+	const bool readOk = ( (int)fread( buffer, 1, indexLength, f ) == indexLength );
+	fclose( f );
+	if ( !readOk ) {
+		Mem_Free( buffer );
+		return false;
+	}
+
+	idFile_Memory index( indexPath, buffer, indexLength );
+	index.ReadInt( ident );
+	index.ReadInt( version );
+	index.ReadInt( length );
+	index.ReadInt( time );
+	index.ReadInt( numEntries );
+	index.ReadInt( nameLength );
+	if ( ident != PAK_INDEX_IDENT || version != PAK_INDEX_VERSION || length != pack->length || time != (int)timestamp
+			|| numEntries < 0 || nameLength < 0 || nameLength > index.Length() - index.Tell() ) {
+		Mem_Free( buffer );
+		return false;
+	}
+	pakFilename.Fill( ' ', nameLength );
+	index.Read( &pakFilename[0], nameLength );
+	if ( pakFilename.Icmp( pack->pakFilename ) != 0 ) {
+		Mem_Free( buffer );
+		return false;
+	}
+
+	fileInPack_t *buildBuffer = new fileInPack_t[numEntries];
+	for ( i = 0; i < numEntries; i++ ) {
+		fileInPack_t &file = buildBuffer[i];
+		int pos;
+
+		index.ReadInt( pos );
+		index.ReadInt( file.method );
+		index.ReadInt( file.crc );
+		index.ReadInt( file.compressedSize );
+		index.ReadInt( file.uncompressedSize );
+		index.ReadInt( file.localOffset );
+		if ( index.ReadInt( nameLength ) != sizeof( nameLength ) || nameLength < 0 || nameLength >= MAX_ZIPPED_FILE_NAME || nameLength > index.Length() - index.Tell() ) {
+			break;
+		}
+		file.pos = pos;
+		file.name.Fill( ' ', nameLength );
+		index.Read( &file.name[0], nameLength );
+		if ( file.localOffset < 0 || file.compressedSize < 0 || file.uncompressedSize < 0 || file.localOffset > pack->length - file.compressedSize ) {
+			break;
+		}
+	}
+	Mem_Free( buffer );
+
+	if ( i != numEntries ) {
+		delete[] buildBuffer;
+		return false;
+	}
+
+	pack->numfiles = numEntries;
+	pack->buildBuffer = buildBuffer;
+	return true;
+}
+
+/*
+=================
+idFileSystemLocal::WritePakIndex
+=================
+*/
+void idFileSystemLocal::WritePakIndex( const pack_t *pack, ID_TIME_T timestamp ) {
+	idStr indexPath = GetPakIndexPath( pack->pakFilename );
+	idFile_Memory index( indexPath );
+
+	index.WriteInt( PAK_INDEX_IDENT );
+	index.WriteInt( PAK_INDEX_VERSION );
+	index.WriteInt( pack->length );
+	index.WriteInt( (int)timestamp );
+	index.WriteInt( pack->numfiles );
+	index.WriteInt( pack->pakFilename.Length() );
+	index.Write( pack->pakFilename.c_str(), pack->pakFilename.Length() );
+	for ( int i = 0; i < pack->numfiles; i++ ) {
+		const fileInPack_t &file = pack->buildBuffer[i];
+		index.WriteInt( (int)file.pos );
+		index.WriteInt( file.method );
+		index.WriteInt( file.crc );
+		index.WriteInt( file.compressedSize );
+		index.WriteInt( file.uncompressedSize );
+		index.WriteInt( file.localOffset );
+		index.WriteInt( file.name.Length() );
+		index.Write( file.name.c_str(), file.name.Length() );
+	}
+
+	CreateOSPath( indexPath );
+	FILE *f = OpenOSFile( indexPath, "wb" );
+	if ( !f ) {
+		common->DPrintf( "couldn't write pk4 index %s\n", indexPath.c_str() );
+		return;
+	}
+	fwrite( index.GetDataPtr(), 1, index.Length(), f );
+	fclose( f );
+}
+
 /*
 =================
 idFileSystemLocal::LoadZipFile
 =================
 */
 pack_t *idFileSystemLocal::LoadZipFile( const char *zipfile ) {
-	fileInPack_t *	buildBuffer;
 	pack_t *		pack;
 	unzFile			uf;
-	int				err;
-	unz_global_info64 gi;
-	char			filename_inzip[MAX_ZIPPED_FILE_NAME];
-	unz_file_info64	file_info;
-	int				i;
-	int				hash;
-	int				fs_numHeaderLongs;
-	int *			fs_headerLongs;
 	FILE			*f;
 	int				len;
+	ID_TIME_T		timestamp;
 	int				confHash;
 	fileInPack_t	*pakFile;
 
@@ -1294,67 +1812,64 @@ pack_t *idFileSystemLocal::LoadZipFile( const char *zipfile ) {
 	}
 	fseek( f, 0, SEEK_END );
 	len = ftell( f );
-	fclose( f );
-
-	fs_numHeaderLongs = 0;
+	timestamp = Sys_FileTimeStamp( f );
 
 	uf = unzOpen( zipfile );
-	err = unzGetGlobalInfo64( uf, &gi );
-
-	if ( err != UNZ_OK ) {
+	if ( uf == NULL ) {
+		fclose( f );
 		return NULL;
 	}
 
-	buildBuffer = new fileInPack_t[gi.number_entry];
 	pack = new pack_t;
-	for( i = 0; i < FILE_HASH_SIZE; i++ ) {
-		pack->hashTable[i] = NULL;
-	}
-
 	pack->pakFilename = zipfile;
 	pack->handle = uf;
-	pack->numfiles = gi.number_entry;
-	pack->buildBuffer = buildBuffer;
+	pack->numfiles = 0;
+	pack->buildBuffer = NULL;
 	pack->referenced = false;
 	pack->addon = false;
 	pack->addon_search = false;
 	pack->addon_info = NULL;
 	pack->pureStatus = PURE_UNKNOWN;
 	pack->isNew = false;
+	pack->mapping.data = NULL;
+	pack->mapping.length = 0;
+	pack->mapping.handle = NULL;
 
 	pack->length = len;
 
-	unzGoToFirstFile(uf);
-	fs_headerLongs = (int *)Mem_ClearedAlloc( gi.number_entry * sizeof(int) );
-	for ( i = 0; i < (int)gi.number_entry; i++ ) {
-		err = unzGetCurrentFileInfo64( uf, &file_info, filename_inzip, sizeof(filename_inzip), NULL, 0, NULL, 0 );
-		if ( err != UNZ_OK ) {
-			break;
+	if ( fs_mmapPaks.GetBool() ) {
+		if ( !Sys_MapFile( zipfile, pack->mapping ) ) {
+			common->DPrintf( "couldn't map %s\n", zipfile );
+		} else if ( pack->mapping.length != len ) {
+			Sys_UnmapFile( pack->mapping );
 		}
-		if ( file_info.uncompressed_size > 0 ) {
-			fs_headerLongs[fs_numHeaderLongs++] = LittleInt( file_info.crc );
+	}
+
+	if ( !fs_pakIndex.GetBool() || !ReadPakIndex( pack, timestamp ) ) {
+		if ( ParseZipDirectory( pack, f ) ) {
+			if ( fs_pakIndex.GetBool() ) {
+				WritePakIndex( pack, timestamp );
+			}
+		} else if ( !WalkZipDirectory( pack, uf ) ) {
+			fclose( f );
+			Sys_UnmapFile( pack->mapping );
+			unzClose( uf );
+			delete pack;
+			return NULL;
 		}
-		hash = HashFileName( filename_inzip );
-		buildBuffer[i].name = filename_inzip;
-		buildBuffer[i].name.ToLower();
-		buildBuffer[i].name.BackSlashesToSlashes();
-		// store the file position in the zip
-		buildBuffer[i].pos = unzGetOffset64( uf );
-		// add the file to the hash
-		buildBuffer[i].next = pack->hashTable[hash];
-		pack->hashTable[hash] = &buildBuffer[i];
-		// go to the next file in the zip
-		unzGoToNextFile(uf);
 	}
+	fclose( f );
+
+	HashZipDirectory( pack );
 
 	// ignore all binary paks
 	confHash = HashFileName(BINARY_CONFIG);
 	for (pakFile = pack->hashTable[confHash]; pakFile; pakFile = pakFile->next) {
 		if (!FilenameCompare(pakFile->name, BINARY_CONFIG)) {
+			Sys_UnmapFile( pack->mapping );
 			unzClose(uf);
-			delete[] buildBuffer;
+			delete[] pack->buildBuffer;
 			delete pack;
-			Mem_Free( fs_headerLongs );
 			return NULL;
 		}
 	}
@@ -1382,11 +1897,6 @@ pack_t *idFileSystemLocal::LoadZipFile( const char *zipfile ) {
 		}
 	}
 
-	pack->checksum = MD4_BlockChecksum( fs_headerLongs, 4 * fs_numHeaderLongs );
-	pack->checksum = LittleInt( pack->checksum );
-
-	Mem_Free( fs_headerLongs );
-
 	return pack;
 }
 
@@ -2068,24 +2578,149 @@ void idFileSystemLocal::TouchFileList_f( const idCmdArgs &args ) {
 
 }
 
-
 /*
-================
-idFileSystemLocal::AddGameDirectory
+============
+idFileSystemLocal::Benchmark_f
 
-Sets gameFolder, adds the directory to the head of the search paths, then loads any pk4 files.
-================
+Times loading the pk4 directories through unzip, the central directory parser and the index,
+then reads the files through unzip and the mapping and checks they come out the same.
+============
 */
-void idFileSystemLocal::AddGameDirectory( const char *path, const char *dir ) {
-	int				i;
+void idFileSystemLocal::Benchmark_f( const idCmdArgs &args ) {
 	searchpath_t *	search;
-	pack_t *		pak;
-	idStr			pakfile;
-	idStrList		pakfiles;
+	int				walkTime = 0, parseTime = 0, indexTime = 0;
+	int				unzipTime = 0, mappedTime = 0, start;
+	int				numPaks = 0, numIndexed = 0, numFiles = 0, numMapped = 0, numMismatched = 0;
+	int64_t			bytesRead = 0;
+	byte *			buffer = NULL;
+	int				bufferSize = 0;
+
+	if ( args.Argc() > 2 ) {
+		common->Printf( "Usage: fs_benchmark [extension]\n" );
+		return;
+	}
+	const char *extension = ( args.Argc() == 2 ) ? args.Argv( 1 ) : NULL;
 
-	// check if the search path already exists
-	for ( search = searchPaths; search; search = search->next ) {
-		// if this element is a pak file
+	for ( search = fileSystemLocal.searchPaths; search; search = search->next ) {
+		pack_t *pak = search->pack;
+		if ( !pak ) {
+			continue;
+		}
+		numPaks++;
+
+		// directory loading, on a scratch pack that shares the mapping
+		pack_t scratch;
+		scratch.pakFilename = pak->pakFilename;
+		scratch.length = pak->length;
+		scratch.mapping = pak->mapping;
+
+		unzFile uf = unzOpen( pak->pakFilename );
+		if ( uf ) {
+			start = Sys_Milliseconds();
+			scratch.buildBuffer = NULL;
+			if ( fileSystemLocal.WalkZipDirectory( &scratch, uf ) ) {
+				fileSystemLocal.HashZipDirectory( &scratch );
+			}
+			walkTime += Sys_Milliseconds() - start;
+			delete[] scratch.buildBuffer;
+			unzClose( uf );
+		}
+
+		FILE *f = fileSystemLocal.OpenOSFile( pak->pakFilename, "rb" );
+		if ( f ) {
+			start = Sys_Milliseconds();
+			scratch.buildBuffer = NULL;
+			if ( fileSystemLocal.ParseZipDirectory( &scratch, f ) ) {
+				fileSystemLocal.HashZipDirectory( &scratch );
+			}
+			parseTime += Sys_Milliseconds() - start;
+			delete[] scratch.buildBuffer;
+
+			ID_TIME_T timestamp = Sys_FileTimeStamp( f );
+			fclose( f );
+
+			start = Sys_Milliseconds();
+			scratch.buildBuffer = NULL;
+			if ( fileSystemLocal.ReadPakIndex( &scratch, timestamp ) ) {
+				fileSystemLocal.HashZipDirectory( &scratch );
+				numIndexed++;
+			}
+			indexTime += Sys_Milliseconds() - start;
+			delete[] scratch.buildBuffer;
+		}
+
+		// file reads
+		for ( int i = 0; i < pak->numfiles; i++ ) {
+			fileInPack_t *pakFile = &pak->buildBuffer[i];
+			if ( pakFile->uncompressedSize <= 0 || pakFile->name.Length() == 0 ) {
+				continue;
+			}
+			if ( extension && idStr::Icmp( pakFile->name.Right( idStr::Length( extension ) ), extension ) != 0 ) {
+				continue;
+			}
+			if ( pakFile->uncompressedSize > bufferSize ) {
+				Mem_Free( buffer );
+				bufferSize = pakFile->uncompressedSize;
+				buffer = (byte *)Mem_Alloc( bufferSize );
+			}
+			numFiles++;
+
+			start = Sys_Milliseconds();
+			idFile_InZip *file = fileSystemLocal.ReadFileFromZip( pak, pakFile, pakFile->name, false );
+			int length = file->Read( buffer, file->Length() );
+			delete file;
+			unzipTime += Sys_Milliseconds() - start;
+			bytesRead += length;
+			unsigned long crc = crc32( 0, buffer, length );
+
+			if ( !pak->mapping.data ) {
+				continue;
+			}
+			start = Sys_Milliseconds();
+			file = fileSystemLocal.ReadFileFromZip( pak, pakFile, pakFile->name, true );
+			const bool mapped = ( file->mapped != NULL );
+			length = file->Read( buffer, file->Length() );
+			delete file;
+			mappedTime += Sys_Milliseconds() - start;
+			if ( mapped ) {
+				numMapped++;
+				if ( crc32( 0, buffer, length ) != crc ) {
+					common->Printf( "%s in %s differs when read from the mapping\n", pakFile->name.c_str(), pak->pakFilename.c_str() );
+					numMismatched++;
+				}
+			}
+		}
+	}
+	Mem_Free( buffer );
+
+	common->Printf( "%d paks, %d with a valid index\n", numPaks, numIndexed );
+	common->Printf( "directories: unzip %d ms, central directory %d ms, index %d ms\n", walkTime, parseTime, indexTime );
+	common->Printf( "%d files, %.2f MB\n", numFiles, bytesRead / ( 1024.0 * 1024.0 ) );
+	common->Printf( "reads: unzip %d ms", unzipTime );
+	if ( numMapped ) {
+		common->Printf( ", mapped %d ms (%d files, %d mismatched)", mappedTime, numMapped, numMismatched );
+	}
+	common->Printf( "\n" );
+}
+
+
+/*
+================
+idFileSystemLocal::AddGameDirectory
+
+Sets gameFolder, adds the directory to the head of the search paths, then loads any pk4 files.
+================
+*/
+void idFileSystemLocal::AddGameDirectory( const char *path, const char *dir ) {
+	int				i;
+	searchpath_t *	search;
+	pack_t *		pak;
+	idStr			pakfile;
+	idStrList		pakfiles;
+
+	// check if the search path already exists
+	for ( search = searchPaths; search; search = search->next ) {
+		// if this element is a pak file
 		if ( !search->dir ) {
 			continue;
 		}
@@ -2370,6 +3005,8 @@ void idFileSystemLocal::Startup( void ) {
 	cmdSystem->AddCommand( "path", Path_f, CMD_FL_SYSTEM, "lists search paths" );
 	cmdSystem->AddCommand( "touchFile", TouchFile_f, CMD_FL_SYSTEM, "touches a file" );
 	cmdSystem->AddCommand( "touchFileList", TouchFileList_f, CMD_FL_SYSTEM, "touches a list of files" );
+	cmdSystem->AddCommand( "fs_asyncStats", AsyncStats_f, CMD_FL_SYSTEM, "prints asynchronous read statistics, 'clear' resets them" );
+	cmdSystem->AddCommand( "fs_benchmark", Benchmark_f, CMD_FL_SYSTEM, "times pk4 directory loading and reading files through unzip and the mapping" );
 
 	// print the current search paths
 	Path_f( idCmdArgs() );
@@ -2690,6 +3327,8 @@ void idFileSystemLocal::Init( void ) {
 	// spawn a thread to handle background file reads
 	StartBackgroundDownloadThread();
 
+	StartAsyncReadThreads();
+
 	if ( ReadFile( "default.cfg", NULL, NULL ) <= 0 ) {
 		// DG: the demo gamedata is in demo/ instead of base/. to make it "just work", add a fallback for that
 		if(fs_game.GetString()[0] == '\0' || idStr::Icmp(fs_game.GetString(), BASE_GAMEDIR) == 0) {
@@ -2721,6 +3360,8 @@ void idFileSystemLocal::Restart( void ) {
 	// spawn a thread to handle background file reads
 	StartBackgroundDownloadThread();
 
+	StartAsyncReadThreads();
+
 	// if we can't find default.cfg, assume that the paths are
 	// busted and error out now, rather than getting an unreadable
 	// graphics screen when the font fails to load
@@ -2744,6 +3385,9 @@ void idFileSystemLocal::Shutdown( bool reloading ) {
 	Sys_DestroyThread(backgroundThread);
 	backgroundThread_exit = false;
 
+	// the pending reads hold files in the paks freed below
+	StopAsyncReadThreads();
+
 	gameFolder.Clear();
 
 	serverPaks.Clear();
@@ -2762,6 +3406,7 @@ void idFileSystemLocal::Shutdown( bool reloading ) {
 
 			if ( sp->pack ) {
 				unzClose( sp->pack->handle );
+				Sys_UnmapFile( sp->pack->mapping );
 				delete [] sp->pack->buildBuffer;
 				if ( sp->pack->addon_info ) {
 					sp->pack->addon_info->mapDecls.DeleteContents( true );
@@ -2784,6 +3429,8 @@ void idFileSystemLocal::Shutdown( bool reloading ) {
 	cmdSystem->RemoveCommand( "dir" );
 	cmdSystem->RemoveCommand( "dirtree" );
 	cmdSystem->RemoveCommand( "touchFile" );
+	cmdSystem->RemoveCommand( "fs_benchmark" );
+	cmdSystem->RemoveCommand( "fs_asyncStats" );
 
 	mapDict.Clear();
 }
@@ -2914,10 +3561,41 @@ pureStatus_t idFileSystemLocal::GetPackStatus( pack_t *pak ) {
 idFileSystemLocal::ReadFileFromZip
 ===========
 */
-idFile_InZip * idFileSystemLocal::ReadFileFromZip( pack_t *pak, fileInPack_t *pakFile, const char *relativePath ) {
+idFile_InZip * idFileSystemLocal::ReadFileFromZip( pack_t *pak, fileInPack_t *pakFile, const char *relativePath, bool allowMapped ) {
 	// relativePath == pakFile->name according to FilenameCompare()
 	// pakFile->Pos is position of that file within the zip
 
+	// stored and deflated files in a mapped pak don't need an unzip handle
+	if ( allowMapped && pak->mapping.data && ( pakFile->method == 0 || pakFile->method == Z_DEFLATED ) ) {
+		const byte *local = (const byte *)pak->mapping.data + pakFile->localOffset;
+		int dataOffset = pakFile->localOffset + ZIP_LOCAL_HEADER_SIZE;
+		if ( dataOffset <= pak->mapping.length && ZipLong( local ) == ZIP_LOCAL_HEADER_SIGNATURE ) {
+			dataOffset += ZipShort( local + 26 ) + ZipShort( local + 28 );
+		} else {
+			dataOffset = -1;
+		}
+		if ( dataOffset >= 0 && dataOffset <= pak->mapping.length - pakFile->compressedSize
+				&& ( pakFile->method != 0 || pakFile->compressedSize == pakFile->uncompressedSize ) ) {
+			idFile_InZip *file = new idFile_InZip();
+			file->z = NULL;
+			file->name = relativePath;
+			file->fullPath = pak->pakFilename + "/" + relativePath;
+			file->zipFilePos = pakFile->pos;
+			file->fileSize = pakFile->uncompressedSize;
+			file->mapped = (const byte *)pak->mapping.data + dataOffset;
+			file->compressedSize = pakFile->compressedSize;
+			if ( pakFile->method == Z_DEFLATED ) {
+				file->stream = new z_stream;
+				memset( file->stream, 0, sizeof( *file->stream ) );
+				if ( inflateInit2( file->stream, -MAX_WBITS ) != Z_OK ) {
+					common->FatalError( "Couldn't init inflate for %s in %s", relativePath, pak->pakFilename.c_str() );
+				}
+			}
+			file->ResetMapped();
+			return file;
+		}
+	}
+
 	// set position in pk4 file to the file (in the zip/pk4) we want a handle on
 	unzSetOffset64( pak->handle, pakFile->pos );
 
@@ -3581,6 +4259,582 @@ void idFileSystemLocal::BackgroundDownload( backgroundDownload_t *bgl ) {
 	}
 }
 
+/*
+=================================================================================
+
+asynchronous reads
+
+Files are looked up on the main thread, so the search paths and paks never have to
+be touched from another thread. The I/O threads only read the opened files, taking
+them from a heap ordered by priority and then by position in their pak, which makes
+reads from the same pk4 follow each other in the order the files are stored.
+
+=================================================================================
+*/
+
+/*
+=================
+AsyncReadBefore
+=================
+*/
+static bool AsyncReadBefore( const asyncRead_t *a, const asyncRead_t *b ) {
+	if ( a->priority != b->priority ) {
+		return a->priority > b->priority;
+	}
+	if ( a->pak != b->pak ) {
+		return (uintptr_t)a->pak < (uintptr_t)b->pak;
+	}
+	if ( a->pakPos != b->pakPos ) {
+		return a->pakPos < b->pakPos;
+	}
+	return a->sequence < b->sequence;
+}
+
+/*
+=================
+AsyncQueueSift
+=================
+*/
+static void AsyncQueueSift( idList<asyncRead_t *> &queue, int i ) {
+	// up
+	while ( i > 0 && AsyncReadBefore( queue[i], queue[( i - 1 ) / 2] ) ) {
+		idSwap( queue[i], queue[( i - 1 ) / 2] );
+		i = ( i - 1 ) / 2;
+	}
+	// down
+	while ( 1 ) {
+		int best = i;
+		int child = i * 2 + 1;
+		if ( child < queue.Num() && AsyncReadBefore( queue[child], queue[best] ) ) {
+			best = child;
+		}
+		if ( child + 1 < queue.Num() && AsyncReadBefore( queue[child + 1], queue[best] ) ) {
+			best = child + 1;
+		}
+		if ( best == i ) {
+			break;
+		}
+		idSwap( queue[i], queue[best] );
+		i = best;
+	}
+}
+
+/*
+=================
+idFileSystemLocal::PushAsyncQueue
+
+ASYNC_READ_LOCK must be held
+=================
+*/
+void idFileSystemLocal::PushAsyncQueue( asyncRead_t *read ) {
+	AsyncQueueSift( asyncQueue, asyncQueue.Append( read ) );
+	if ( asyncQueue.Num() > asyncStats.maxQueued ) {
+		asyncStats.maxQueued = asyncQueue.Num();
+	}
+}
+
+/*
+=================
+idFileSystemLocal::PopAsyncQueue
+
+ASYNC_READ_LOCK must be held
+=================
+*/
+asyncRead_t *idFileSystemLocal::PopAsyncQueue( void ) {
+	if ( !asyncQueue.Num() ) {
+		return NULL;
+	}
+	asyncRead_t *read = asyncQueue[0];
+	RemoveAsyncQueue( read );
+	return read;
+}
+
+/*
+=================
+idFileSystemLocal::RemoveAsyncQueue
+
+ASYNC_READ_LOCK must be held
+=================
+*/
+void idFileSystemLocal::RemoveAsyncQueue( asyncRead_t *read ) {
+	int i = asyncQueue.FindIndex( read );
+	assert( i != -1 );
+	int last = asyncQueue.Num() - 1;
+	asyncQueue[i] = asyncQueue[last];
+	asyncQueue.RemoveIndex( last );
+	if ( i < asyncQueue.Num() ) {
+		AsyncQueueSift( asyncQueue, i );
+	}
+}
+
+/*
+=================
+idFileSystemLocal::ReadAsyncFile
+
+Called from the I/O threads, returns the time spent reading
+=================
+*/
+double idFileSystemLocal::ReadAsyncFile( asyncRead_t *read ) {
+	double start = Sys_Microseconds();
+
+	read->buffer = (byte *)Mem_ClearedAlloc( read->length + 1 );
+	read->file->Read( read->buffer, read->length );
+	// guarantee that it will have a trailing 0 for string operations
+	read->buffer[read->length] = 0;
+
+	delete read->file;
+	read->file = NULL;
+
+	return Sys_Microseconds() - start;
+}
+
+/*
+=================
+AsyncReadThread
+=================
+*/
+int AsyncReadThread( void *parms ) {
+	idFileSystemLocal &fs = fileSystemLocal;
+	const pack_t *lastPak = NULL;
+
+	while ( 1 ) {
+		Sys_SemaphoreWait( fs.asyncQueued );
+
+		Sys_EnterCriticalSection( ASYNC_READ_LOCK );
+		if ( fs.asyncThreadsExit ) {
+			Sys_LeaveCriticalSection( ASYNC_READ_LOCK );
+			break;
+		}
+		// may be empty when the main thread took a read itself
+		asyncRead_t *read = fs.PopAsyncQueue();
+		if ( read ) {
+			read->state = ASYNC_READING;
+			fs.asyncStats.queueTime += Sys_Microseconds() - read->queueTime;
+			if ( read->pak && read->pak == lastPak ) {
+				fs.asyncStats.numSamePak++;
+			}
+		}
+		Sys_LeaveCriticalSection( ASYNC_READ_LOCK );
+
+		if ( !read ) {
+			continue;
+		}
+		lastPak = read->pak;
+
+		double readTime = fs.ReadAsyncFile( read );
+
+		Sys_EnterCriticalSection( ASYNC_READ_LOCK );
+		fs.asyncStats.readTime += readTime;
+		fs.asyncStats.bytesRead += read->length;
+		if ( read->cancelled ) {
+			Mem_Free( read->buffer );
+			delete read;
+		} else {
+			read->state = ASYNC_DONE;
+			read->finishTime = Sys_Milliseconds();
+		}
+		Sys_LeaveCriticalSection( ASYNC_READ_LOCK );
+
+		Sys_SemaphorePost( fs.asyncDone );
+	}
+	return 0;
+}
+
+/*
+=================
+idFileSystemLocal::StartAsyncReadThreads
+=================
+*/
+void idFileSystemLocal::StartAsyncReadThreads( void ) {
+	if ( numAsyncThreads ) {
+		common->Printf( "async read threads already running\n" );
+		return;
+	}
+	asyncQueued = Sys_CreateSemaphore();
+	asyncDone = Sys_CreateSemaphore();
+	asyncThreadsExit = false;
+	numAsyncThreads = idMath::ClampInt( 0, MAX_ASYNC_READ_THREADS, fs_asyncThreads.GetInteger() );
+	for ( int i = 0; i < numAsyncThreads; i++ ) {
+		Sys_CreateThread( AsyncReadThread, NULL, asyncThreads[i], "asyncRead" );
+	}
+}
+
+/*
+=================
+idFileSystemLocal::StopAsyncReadThreads
+
+Drops all reads, reads in progress are finished first
+=================
+*/
+void idFileSystemLocal::StopAsyncReadThreads( void ) {
+	for ( int i = 0; i < asyncReads.Num(); i++ ) {
+		if ( asyncReads[i] ) {
+			CancelAsyncRead( asyncReads[i]->handle );
+		}
+	}
+	assert( asyncQueue.Num() == 0 );
+	asyncReads.Clear();
+	asyncFreeSlots.Clear();
+	asyncPrefetchHash.Clear();
+
+	asyncThreadsExit = true;
+	for ( int i = 0; i < numAsyncThreads; i++ ) {
+		Sys_SemaphorePost( asyncQueued );
+	}
+	for ( int i = 0; i < numAsyncThreads; i++ ) {
+		Sys_DestroyThread( asyncThreads[i] );
+	}
+	numAsyncThreads = 0;
+	asyncThreadsExit = false;
+
+	Sys_DestroySemaphore( asyncQueued );
+	Sys_DestroySemaphore( asyncDone );
+	asyncQueued = NULL;
+	asyncDone = NULL;
+}
+
+/*
+=================
+idFileSystemLocal::GetAsyncRead
+=================
+*/
+asyncRead_t *idFileSystemLocal::GetAsyncRead( int handle ) const {
+	int slot = handle & 0xffff;
+	if ( handle <= 0 || slot >= asyncReads.Num() ) {
+		return NULL;
+	}
+	asyncRead_t *read = asyncReads[slot];
+	if ( !read || read->handle != handle ) {
+		return NULL;
+	}
+	return read;
+}
+
+/*
+=================
+idFileSystemLocal::ReleaseAsyncRead
+
+Invalidates the handle of the read
+=================
+*/
+void idFileSystemLocal::ReleaseAsyncRead( asyncRead_t *read ) {
+	int slot = read->handle & 0xffff;
+	assert( asyncReads[slot] == read );
+	if ( read->prefetch ) {
+		asyncPrefetchHash.Remove( idStr::IHash( read->relativePath ), slot );
+	}
+	asyncReads[slot] = NULL;
+	asyncFreeSlots.Append( slot );
+}
+
+/*
+=================
+idFileSystemLocal::FreeAsyncRead
+
+The read must be done
+=================
+*/
+void idFileSystemLocal::FreeAsyncRead( asyncRead_t *read ) {
+	ReleaseAsyncRead( read );
+	Mem_Free( read->buffer );
+	delete read->file;
+	delete read;
+}
+
+/*
+=================
+idFileSystemLocal::FindPrefetch
+
+Returns the slot of the prefetch of the file or -1
+=================
+*/
+int idFileSystemLocal::FindPrefetch( const char *relativePath ) const {
+	for ( int i = asyncPrefetchHash.First( idStr::IHash( relativePath ) ); i != -1; i = asyncPrefetchHash.Next( i ) ) {
+		if ( asyncReads[i] && asyncReads[i]->prefetch && !FilenameCompare( asyncReads[i]->relativePath, relativePath ) ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+=================
+idFileSystemLocal::ReadFileAsync
+=================
+*/
+int idFileSystemLocal::ReadFileAsync( const char *relativePath, fsAsyncPriority_t priority, fsAsyncCallback_t callback, void *data ) {
+	pack_t *pak;
+	int slot;
+
+	if ( !searchPaths ) {
+		common->FatalError( "Filesystem call made without initialization\n" );
+	}
+
+	if ( !relativePath || !relativePath[0] ) {
+		common->FatalError( "idFileSystemLocal::ReadFileAsync with empty name\n" );
+	}
+
+	if ( asyncFreeSlots.Num() ) {
+		slot = asyncFreeSlots[asyncFreeSlots.Num() - 1];
+		asyncFreeSlots.RemoveIndex( asyncFreeSlots.Num() - 1 );
+	} else {
+		slot = asyncReads.Append( NULL );
+		if ( slot > 0xffff ) {
+			common->FatalError( "idFileSystemLocal::ReadFileAsync: too many reads" );
+		}
+	}
+
+	asyncRead_t *read = new asyncRead_t;
+	asyncSequence++;
+	read->handle = ( ( ( asyncSequence & 0x3fff ) + 1 ) << 16 ) | slot;
+	read->relativePath = relativePath;
+	read->priority = priority;
+	read->sequence = asyncSequence;
+	read->callback = callback;
+	read->data = data;
+	read->prefetch = false;
+	read->cancelled = false;
+	read->buffer = NULL;
+	read->queueTime = 0.0;
+	read->finishTime = 0;
+	asyncReads[slot] = read;
+
+	read->file = OpenFileReadFlags( relativePath, FSFLAG_SEARCH_DIRS | FSFLAG_SEARCH_PAKS, &pak );
+	read->pak = pak;
+	read->pakPos = pak ? (int)static_cast<idFile_InZip *>( read->file )->zipFilePos : 0;
+	read->length = read->file ? read->file->Length() : -1;
+	read->timestamp = read->file ? read->file->Timestamp() : FILE_NOT_FOUND_TIMESTAMP;
+
+	asyncStats.numReads++;
+	if ( !read->file ) {
+		asyncStats.numNotFound++;
+		read->state = ASYNC_DONE;
+		read->finishTime = Sys_Milliseconds();
+	} else if ( !numAsyncThreads ) {
+		asyncStats.readTime += ReadAsyncFile( read );
+		asyncStats.bytesRead += read->length;
+		read->state = ASYNC_DONE;
+		read->finishTime = Sys_Milliseconds();
+	} else {
+		read->state = ASYNC_QUEUED;
+		read->queueTime = Sys_Microseconds();
+		Sys_EnterCriticalSection( ASYNC_READ_LOCK );
+		PushAsyncQueue( read );
+		Sys_LeaveCriticalSection( ASYNC_READ_LOCK );
+		Sys_SemaphorePost( asyncQueued );
+	}
+
+	return read->handle;
+}
+
+/*
+=================
+idFileSystemLocal::AsyncReadDone
+=================
+*/
+bool idFileSystemLocal::AsyncReadDone( int handle ) {
+	asyncRead_t *read = GetAsyncRead( handle );
+	if ( !read ) {
+		return true;
+	}
+	Sys_EnterCriticalSection( ASYNC_READ_LOCK );
+	bool done = ( read->state == ASYNC_DONE );
+	Sys_LeaveCriticalSection( ASYNC_READ_LOCK );
+	return done;
+}
+
+/*
+=================
+idFileSystemLocal::WaitForAsyncRead
+
+A read that is still queued is done right away on the calling thread
+=================
+*/
+void idFileSystemLocal::WaitForAsyncRead( asyncRead_t *read ) {
+	double start = Sys_Microseconds();
+
+	while ( 1 ) {
+		Sys_EnterCriticalSection( ASYNC_READ_LOCK );
+		asyncReadState_t state = read->state;
+		if ( state == ASYNC_QUEUED ) {
+			RemoveAsyncQueue( read );
+			read->state = ASYNC_READING;
+			asyncStats.queueTime += Sys_Microseconds() - read->queueTime;
+		}
+		Sys_LeaveCriticalSection( ASYNC_READ_LOCK );
+
+		if ( state == ASYNC_DONE ) {
+			break;
+		}
+		if ( state == ASYNC_QUEUED ) {
+			double readTime = ReadAsyncFile( read );
+			Sys_EnterCriticalSection( ASYNC_READ_LOCK );
+			asyncStats.readTime += readTime;
+			asyncStats.bytesRead += read->length;
+			read->state = ASYNC_DONE;
+			read->finishTime = Sys_Milliseconds();
+			Sys_LeaveCriticalSection( ASYNC_READ_LOCK );
+			break;
+		}
+		// posted for every read any I/O thread finishes
+		Sys_SemaphoreWait( asyncDone );
+	}
+
+	asyncStats.stallTime += Sys_Microseconds() - start;
+}
+
+/*
+=================
+idFileSystemLocal::FinishAsyncRead
+=================
+*/
+int idFileSystemLocal::FinishAsyncRead( int handle, void **buffer, ID_TIME_T *timestamp ) {
+	if ( buffer ) {
+		*buffer = NULL;
+	}
+	if ( timestamp ) {
+		*timestamp = FILE_NOT_FOUND_TIMESTAMP;
+	}
+
+	asyncRead_t *read = GetAsyncRead( handle );
+	if ( !read ) {
+		common->Warning( "idFileSystemLocal::FinishAsyncRead: invalid handle %d", handle );
+		return -1;
+	}
+
+	WaitForAsyncRead( read );
+
+	if ( buffer && read->buffer ) {
+		loadCount++;
+		loadStack++;
+		*buffer = read->buffer;
+		read->buffer = NULL;
+	}
+	if ( timestamp ) {
+		*timestamp = read->timestamp;
+	}
+	if ( read->prefetch ) {
+		asyncStats.numPrefetchesUsed++;
+	}
+	int length = read->length;
+
+	FreeAsyncRead( read );
+
+	return length;
+}
+
+/*
+=================
+idFileSystemLocal::CancelAsyncRead
+=================
+*/
+void idFileSystemLocal::CancelAsyncRead( int handle ) {
+	asyncRead_t *read = GetAsyncRead( handle );
+	if ( !read ) {
+		return;
+	}
+
+	Sys_EnterCriticalSection( ASYNC_READ_LOCK );
+	asyncReadState_t state = read->state;
+	if ( state == ASYNC_QUEUED ) {
+		RemoveAsyncQueue( read );
+	} else if ( state == ASYNC_READING ) {
+		// the I/O thread frees it when it's done
+		read->cancelled = true;
+	}
+	Sys_LeaveCriticalSection( ASYNC_READ_LOCK );
+
+	asyncStats.numCancelled++;
+	if ( state == ASYNC_READING ) {
+		ReleaseAsyncRead( read );
+	} else {
+		FreeAsyncRead( read );
+	}
+}
+
+/*
+=================
+idFileSystemLocal::PrefetchFile
+=================
+*/
+void idFileSystemLocal::PrefetchFile( const char *relativePath ) {
+	if ( !fs_asyncLoad.GetBool() || !numAsyncThreads ) {
+		return;
+	}
+	if ( FindPrefetch( relativePath ) != -1 ) {
+		return;
+	}
+
+	int handle = ReadFileAsync( relativePath, FS_ASYNC_PRIORITY_LOW );
+	asyncRead_t *read = GetAsyncRead( handle );
+	read->prefetch = true;
+	asyncPrefetchHash.Add( idStr::IHash( relativePath ), handle & 0xffff );
+	asyncStats.numPrefetches++;
+}
+
+/*
+=================
+idFileSystemLocal::UpdateAsyncReads
+=================
+*/
+void idFileSystemLocal::UpdateAsyncReads( void ) {
+	int now = Sys_Milliseconds();
+
+	// callbacks may start new reads
+	for ( int i = 0; i < asyncReads.Num(); i++ ) {
+		asyncRead_t *read = asyncReads[i];
+		if ( !read || ( !read->callback && !read->prefetch ) ) {
+			continue;
+		}
+
+		Sys_EnterCriticalSection( ASYNC_READ_LOCK );
+		bool done = ( read->state == ASYNC_DONE );
+		Sys_LeaveCriticalSection( ASYNC_READ_LOCK );
+		if ( !done ) {
+			continue;
+		}
+
+		if ( read->callback ) {
+			read->callback( read->relativePath, read->buffer, read->length, read->data );
+			FreeAsyncRead( read );
+		} else if ( now - read->finishTime > ASYNC_PREFETCH_TIMEOUT ) {
+			asyncStats.numPrefetchesDropped++;
+			FreeAsyncRead( read );
+		}
+	}
+}
+
+/*
+=================
+idFileSystemLocal::AsyncStats_f
+=================
+*/
+void idFileSystemLocal::AsyncStats_f( const idCmdArgs &args ) {
+	asyncReadStats_t &stats = fileSystemLocal.asyncStats;
+
+	if ( args.Argc() > 1 && !idStr::Icmp( args.Argv( 1 ), "clear" ) ) {
+		memset( &stats, 0, sizeof( stats ) );
+		return;
+	}
+
+	Sys_EnterCriticalSection( ASYNC_READ_LOCK );
+	const int numQueued = fileSystemLocal.asyncQueue.Num();
+	const asyncReadStats_t s = stats;
+	Sys_LeaveCriticalSection( ASYNC_READ_LOCK );
+
+	common->Printf( "%d I/O threads, fs_asyncLoad %d, %d reads queued\n", fileSystemLocal.numAsyncThreads, fs_asyncLoad.GetInteger(), numQueued );
+	common->Printf( "%d reads, %d not found, %d cancelled\n", s.numReads, s.numNotFound, s.numCancelled );
+	common->Printf( "%d prefetches, %d used, %d dropped unused\n", s.numPrefetches, s.numPrefetchesUsed, s.numPrefetchesDropped );
+	common->Printf( "%.2f MB read in %.1f msec", s.bytesRead / ( 1024.0 * 1024.0 ), s.readTime * 0.001 );
+	if ( s.readTime > 0.0 ) {
+		common->Printf( " (%.1f MB/s per thread)", ( s.bytesRead / ( 1024.0 * 1024.0 ) ) / ( s.readTime * 0.000001 ) );
+	}
+	common->Printf( "\n" );
+	common->Printf( "%d reads continued in the pk4 of the previous read\n", s.numSamePak );
+	common->Printf( "%.2f msec average queue wait, %d reads queued at most\n", s.numReads ? s.queueTime * 0.001 / s.numReads : 0.0, s.maxQueued );
+	common->Printf( "main thread waited %.1f msec for reads\n", s.stallTime * 0.001 );
+}
+
 /*
 =================
 idFileSystemLocal::PerformingCopyFiles
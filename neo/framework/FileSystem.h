@@ -127,6 +127,17 @@ struct backgroundDownload_t {
 	volatile bool		completed;
 };
 
+// priorities of asynchronous reads, higher priorities are read first
+typedef enum {
+	FS_ASYNC_PRIORITY_LOW,			// prefetches
+	FS_ASYNC_PRIORITY_NORMAL,
+	FS_ASYNC_PRIORITY_HIGH
+} fsAsyncPriority_t;
+
+// called on the main thread from UpdateAsyncReads, length is -1 if the file wasn't found
+// the buffer is freed after the callback returns
+typedef void ( *fsAsyncCallback_t )( const char *relativePath, const void *buffer, int length, void *data );
+
 // file list for directory listings
 class idFileList {
 	friend class idFileSystemLocal;
@@ -223,6 +234,10 @@ public:
 							// A 0 byte will always be appended at the end, so string ops are safe.
 							// The buffer should be considered read-only, because it may be cached for other uses.
 	virtual int				ReadFile( const char *relativePath, void **buffer, ID_TIME_T *timestamp = NULL ) = 0;
+							// Gets the length, timestamp and pk4 checksum of a file without reading it.
+							// The timestamp is 0 for files in a pk4, the pk4 checksum is 0 for other files.
+							// Returns -1 if the file is not present.
+	virtual int				GetFileInfo( const char *relativePath, ID_TIME_T *timestamp, int *pakChecksum ) = 0;
 							// Frees the memory allocated by ReadFile.
 	virtual void			FreeFile( void *buffer ) = 0;
 							// Writes a complete file, will create any needed subdirectories.
@@ -246,6 +261,22 @@ public:
 	virtual void			CloseFile( idFile *f ) = 0;
 							// Returns immediately, performing the read from a background thread.
 	virtual void			BackgroundDownload( backgroundDownload_t *bgl ) = 0;
+							// Starts reading a complete file on an I/O thread and returns a handle for the read.
+							// The file is looked up right away, only the reading happens in the background.
+							// With a callback the handle is only valid until the callback ran, otherwise the
+							// read has to be ended with FinishAsyncRead or CancelAsyncRead.
+	virtual int				ReadFileAsync( const char *relativePath, fsAsyncPriority_t priority = FS_ASYNC_PRIORITY_NORMAL, fsAsyncCallback_t callback = NULL, void *data = NULL ) = 0;
+							// true when the read is done, whether or not the file was found
+	virtual bool			AsyncReadDone( int handle ) = 0;
+							// Waits for the read to finish and returns like ReadFile, the buffer must be freed with FreeFile.
+	virtual int				FinishAsyncRead( int handle, void **buffer, ID_TIME_T *timestamp = NULL ) = 0;
+							// Drops the read and frees its buffer, the callback won't be called.
+	virtual void			CancelAsyncRead( int handle ) = 0;
+							// Reads a file in the background when fs_asyncLoad is set, a later ReadFile
+							// of the same file only waits for the read to finish.
+	virtual void			PrefetchFile( const char *relativePath ) = 0;
+							// Runs the callbacks of finished reads and drops old prefetched files nobody read.
+	virtual void			UpdateAsyncReads( void ) = 0;
 							// resets the bytes read counter
 	virtual void			ResetReadCount( void ) = 0;
 							// retrieves the current read count
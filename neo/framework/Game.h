@@ -43,6 +43,8 @@ class idRenderModelManager;
 class idUserInterface;
 class idUserInterfaceManager;
 class idNetworkSystem;
+class idParallelJobManager;
+class idProfiler;
 
 /*
 ===============================================================================
@@ -363,7 +365,7 @@ public:
 ===============================================================================
 */
 
-const int GAME_API_VERSION		= 9;
+const int GAME_API_VERSION		= 11;
 
 typedef struct {
 
@@ -381,6 +383,8 @@ typedef struct {
 	idDeclManager *				declManager;			// declaration manager
 	idAASFileManager *			AASFileManager;			// AAS file manager
 	idCollisionModelManager *	collisionModelManager;	// collision model manager
+	idParallelJobManager *		parallelJobManager;		// parallel job system
+	idProfiler *				profiler;				// PROF_SCOPE zone profiler
 
 } gameImport_t;
 
@@ -29,6 +29,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "sys/platform.h"
 #include "idlib/hashing/CRC32.h"
 #include "idlib/LangDict.h"
+#include "idlib/Profiler.h"
 #include "framework/async/AsyncNetwork.h"
 #include "framework/Console.h"
 #include "framework/Game.h"
@@ -57,6 +58,9 @@ idCVar	idSessionLocal::com_aviDemoHeight( "com_aviDemoHeight", "256", CVAR_SYSTE
 idCVar	idSessionLocal::com_aviDemoTics( "com_aviDemoTics", "2", CVAR_SYSTEM | CVAR_INTEGER, "", 1, 60 );
 idCVar	idSessionLocal::com_wipeSeconds( "com_wipeSeconds", "1", CVAR_SYSTEM, "" );
 idCVar	idSessionLocal::com_guid( "com_guid", "", CVAR_SYSTEM | CVAR_ARCHIVE | CVAR_ROM, "" );
+idCVar	idSessionLocal::com_timeDemoCSV( "com_timeDemoCSV", "0", CVAR_SYSTEM | CVAR_BOOL, "write the frame times of a timeDemo to timedemo/<demo>.csv" );
+idCVar	idSessionLocal::com_benchmarkBaseline( "com_benchmarkBaseline", "", CVAR_SYSTEM, "results file of an earlier benchmark to compare against" );
+idCVar	idSessionLocal::com_benchmarkTolerance( "com_benchmarkTolerance", "5", CVAR_SYSTEM | CVAR_FLOAT, "percent a benchmark may be slower than the baseline before it is reported as a regression" );
 
 idCVar	idSessionLocal::com_numQuicksaves( "com_numQuicksaves", "4", CVAR_SYSTEM|CVAR_ARCHIVE|CVAR_INTEGER,
                                            "number of quicksaves to keep before overwriting the oldest", 1, 99 );
@@ -342,6 +346,11 @@ void idSessionLocal::Clear() {
 	guiActive = NULL;
 	aviCaptureMode = false;
 	timeDemo = TD_NO;
+	timeDemoFrames.Clear();
+	benchmarkActive = false;
+	benchmarkQuit = false;
+	benchmarkDemos.Clear();
+	benchmarkResults.Clear();
 	waitingOnBind = false;
 	lastPacifierTime = 0;
 
@@ -436,6 +445,7 @@ void idSessionLocal::Shutdown() {
 		// else the game freezes when showing the timedemo results
 		timeDemo = TD_YES_THEN_QUIT;
 	}
+	benchmarkActive = false;
 
 	Stop();
 
@@ -698,6 +708,24 @@ static void Session_TimeDemoQuit_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+================
+Session_Benchmark_f
+================
+*/
+static void Session_Benchmark_f( const idCmdArgs &args ) {
+	sessLocal.StartBenchmark( args, false );
+}
+
+/*
+================
+Session_BenchmarkQuit_f
+================
+*/
+static void Session_BenchmarkQuit_f( const idCmdArgs &args ) {
+	sessLocal.StartBenchmark( args, true );
+}
+
 /*
 ================
 Session_AVIDemo_f
@@ -870,6 +898,7 @@ void idSessionLocal::StopPlayingRenderDemo() {
 	soundSystem->SetPlayingSoundWorld( menuSoundWorld );
 
 	common->Printf( "stopped playing %s.\n", readDemo->GetName() );
+	idStr demoName = readDemo->GetName();
 	delete readDemo;
 	readDemo = NULL;
 
@@ -879,8 +908,15 @@ void idSessionLocal::StopPlayingRenderDemo() {
 		float	demoFPS = numDemoFrames / demoSeconds;
 		idStr	message = va( "%i frames rendered in %3.1f seconds = %3.1f fps\n", numDemoFrames, demoSeconds, demoFPS );
 
+		ReportTimeDemoFrames( demoName, message );
+
 		common->Printf( "%s", message.c_str() );
-		if ( timeDemo == TD_YES_THEN_QUIT ) {
+		if ( cvarSystem->GetCVarBool( "r_nullBackend" ) ) {
+			cmdSystem->BufferCommandText( CMD_EXEC_NOW, "nullBackendStats\n" );
+		}
+		if ( benchmarkActive ) {
+			AdvanceBenchmark();
+		} else if ( timeDemo == TD_YES_THEN_QUIT ) {
 			cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "quit\n" );
 		} else {
 			soundSystem->SetMute( true );
@@ -962,6 +998,17 @@ void idSessionLocal::StartPlayingRenderDemo( idStr demoName ) {
 
 	lastDemoTic = -1;
 	timeDemoStartTime = Sys_Milliseconds();
+
+	timeDemoFrames.SetGranularity( 1024 );
+	timeDemoFrames.Clear();
+	timeDemoFrameStart = Sys_Microseconds();
+	timeDemoGameMsec = time_gameFrame;
+	Mem_ClearFrameStats();
+
+	// the null back end counts what it would have drawn during the demo
+	if ( cvarSystem->GetCVarBool( "r_nullBackend" ) ) {
+		cmdSystem->BufferCommandText( CMD_EXEC_NOW, "nullBackendStats reset\n" );
+	}
 }
 
 /*
@@ -993,12 +1040,260 @@ void idSessionLocal::TimeRenderDemo( const char *demoName, bool twice ) {
 
 
 	if ( !readDemo ) {
+		if ( benchmarkActive ) {
+			// keep going with the rest of the list
+			common->Warning( "benchmark: couldn't time %s", demo.c_str() );
+			AdvanceBenchmark();
+		}
 		return;
 	}
 
 	timeDemo = TD_YES;
 }
 
+/*
+================
+idSessionLocal::RecordTimeDemoFrame
+
+Called after every frame of a timeDemo
+================
+*/
+void idSessionLocal::RecordTimeDemoFrame() {
+	timeDemoFrame_t &frame = timeDemoFrames.Alloc();
+
+	double now = Sys_Microseconds();
+	frame.frameUsec = (int)( now - timeDemoFrameStart );
+	timeDemoFrameStart = now;
+
+	// time_gameFrame is reset whenever com_speeds prints it
+	frame.gameMsec = ( time_gameFrame >= timeDemoGameMsec ) ? time_gameFrame - timeDemoGameMsec : time_gameFrame;
+	timeDemoGameMsec = time_gameFrame;
+
+	renderSystem->GetFrameTimings( frame.render );
+
+	memoryStats_t allocs, frees;
+	Mem_GetFrameStats( allocs, frees );
+	frame.allocs = allocs.num;
+	frame.allocBytes = allocs.totalSize;
+	frame.frees = frees.num;
+	Mem_ClearFrameStats();
+}
+
+/*
+================
+TimeDemoPercentile
+
+nearest rank percentile of sorted frame times, in msec
+================
+*/
+static float TimeDemoPercentile( const idList<int> &sortedUsec, float percent ) {
+	int index = idMath::Ftoi( idMath::Ceil( percent * 0.01f * sortedUsec.Num() ) ) - 1;
+	if ( index < 0 ) {
+		index = 0;
+	} else if ( index >= sortedUsec.Num() ) {
+		index = sortedUsec.Num() - 1;
+	}
+	return sortedUsec[index] * 0.001f;
+}
+
+/*
+================
+idSessionLocal::ReportTimeDemoFrames
+
+Adds the frame time percentiles to the timeDemo message, writes
+the per frame CSV and remembers the result for a benchmark
+================
+*/
+void idSessionLocal::ReportTimeDemoFrames( const char *demoName, idStr &message ) {
+	int i;
+	int num = timeDemoFrames.Num();
+
+	if ( !num ) {
+		return;
+	}
+
+	idList<int> sortedUsec;
+	double total[8];
+	memset( total, 0, sizeof( total ) );
+
+	sortedUsec.SetNum( num );
+	for ( i = 0; i < num; i++ ) {
+		const timeDemoFrame_t &frame = timeDemoFrames[i];
+		sortedUsec[i] = frame.frameUsec;
+		total[0] += frame.frameUsec;
+		total[1] += frame.gameMsec * 1000;
+		total[2] += frame.render.frontEndUsec;
+		total[3] += frame.render.backEndUsec;
+		total[4] += frame.render.addLightsUsec;
+		total[5] += frame.render.addModelsUsec;
+		total[6] += frame.render.shadowUsec;
+		total[7] += frame.allocs;
+	}
+	sortedUsec.Sort();
+
+	float avg = total[0] * 0.001 / num;
+	float p50 = TimeDemoPercentile( sortedUsec, 50.0f );
+	float p95 = TimeDemoPercentile( sortedUsec, 95.0f );
+	float p99 = TimeDemoPercentile( sortedUsec, 99.0f );
+	float worst = sortedUsec[num - 1] * 0.001f;
+
+	message += va( "frame msec: avg %.2f p50 %.2f p95 %.2f p99 %.2f worst %.2f\n", avg, p50, p95, p99, worst );
+	message += va( "avg msec: game %.2f frontend %.2f backend %.2f addLights %.2f addModels %.2f shadow %.2f, %.1f allocs\n",
+		total[1] * 0.001 / num, total[2] * 0.001 / num, total[3] * 0.001 / num,
+		total[4] * 0.001 / num, total[5] * 0.001 / num, total[6] * 0.001 / num, total[7] / num );
+
+	idStr shortName = demoName;
+	shortName.StripPath();
+	shortName.StripFileExtension();
+
+	if ( com_timeDemoCSV.GetBool() || benchmarkActive ) {
+		idStr csvName = va( "timedemo/%s.csv", shortName.c_str() );
+		idFile *f = fileSystem->OpenFileWrite( csvName );
+		if ( f ) {
+			f->Printf( "frame,msec,game_msec,frontend_msec,backend_msec,add_lights_msec,add_models_msec,shadow_wait_msec,allocs,alloc_kb,frees\n" );
+			for ( i = 0; i < num; i++ ) {
+				const timeDemoFrame_t &frame = timeDemoFrames[i];
+				f->Printf( "%i,%.3f,%i,%.3f,%.3f,%.3f,%.3f,%.3f,%i,%i,%i\n", i,
+					frame.frameUsec * 0.001f, frame.gameMsec, frame.render.frontEndUsec * 0.001f,
+					frame.render.backEndUsec * 0.001f, frame.render.addLightsUsec * 0.001f,
+					frame.render.addModelsUsec * 0.001f, frame.render.shadowUsec * 0.001f,
+					frame.allocs, frame.allocBytes >> 10, frame.frees );
+			}
+			fileSystem->CloseFile( f );
+			common->Printf( "wrote %s\n", csvName.c_str() );
+		} else {
+			common->Warning( "couldn't write %s", csvName.c_str() );
+		}
+	}
+
+	if ( benchmarkActive ) {
+		benchmarkResults += va( "\"%s\" %i %.3f %.3f %.3f %.3f %.3f\n", shortName.c_str(), num, avg, p50, p95, p99, worst );
+	}
+
+	timeDemoFrames.Clear();
+}
+
+/*
+================
+idSessionLocal::StartBenchmark
+================
+*/
+void idSessionLocal::StartBenchmark( const idCmdArgs &args, bool quit ) {
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: %s <demo> [demo ...]\n", args.Argv( 0 ) );
+		return;
+	}
+
+	benchmarkDemos.Clear();
+	for ( int i = 1; i < args.Argc(); i++ ) {
+		benchmarkDemos.Append( args.Argv( i ) );
+	}
+	benchmarkResults = "// demo frames avg_msec p50_msec p95_msec p99_msec worst_msec\n";
+	benchmarkQuit = quit;
+	benchmarkActive = true;
+
+	AdvanceBenchmark();
+}
+
+/*
+================
+ParseBenchmarkResults
+
+reads the lines written by idSessionLocal::AdvanceBenchmark,
+each demo gets avg, p50, p95, p99 and worst in stats
+================
+*/
+static void ParseBenchmarkResults( idLexer &src, idStrList &names, idList<float> &stats ) {
+	idToken token;
+
+	while ( src.ReadToken( &token ) ) {
+		names.Append( token );
+		src.ParseInt();
+		for ( int i = 0; i < 5; i++ ) {
+			stats.Append( src.ParseFloat() );
+		}
+	}
+}
+
+/*
+================
+idSessionLocal::AdvanceBenchmark
+
+Starts timing the next demo of a benchmark, or writes the
+results and compares them against the baseline after the last one
+================
+*/
+void idSessionLocal::AdvanceBenchmark() {
+	int i, j;
+
+	if ( benchmarkDemos.Num() ) {
+		// let the current demo shut down before the next one starts
+		cmdSystem->BufferCommandText( CMD_EXEC_APPEND, va( "timeDemo \"%s\"\n", benchmarkDemos[0].c_str() ) );
+		benchmarkDemos.RemoveIndex( 0 );
+		return;
+	}
+
+	benchmarkActive = false;
+
+	idFile *f = fileSystem->OpenFileWrite( "benchmark/results.txt" );
+	if ( f ) {
+		f->Write( benchmarkResults.c_str(), benchmarkResults.Length() );
+		fileSystem->CloseFile( f );
+		common->Printf( "wrote benchmark/results.txt\n" );
+	}
+
+	idStr message;
+	int regressions = 0;
+	idStrList names, baseNames;
+	idList<float> stats, baseStats;
+
+	idLexer src( LEXFL_NOSTRINGCONCAT | LEXFL_NOFATALERRORS );
+	src.LoadMemory( benchmarkResults.c_str(), benchmarkResults.Length(), "benchmark results" );
+	ParseBenchmarkResults( src, names, stats );
+
+	const char *baseline = com_benchmarkBaseline.GetString();
+	if ( baseline[0] ) {
+		idLexer baseSrc( LEXFL_NOSTRINGCONCAT | LEXFL_NOFATALERRORS );
+		if ( baseSrc.LoadFile( baseline ) ) {
+			ParseBenchmarkResults( baseSrc, baseNames, baseStats );
+		} else {
+			common->Warning( "couldn't load benchmark baseline %s", baseline );
+		}
+	}
+
+	float tolerance = com_benchmarkTolerance.GetFloat();
+	for ( i = 0; i < names.Num(); i++ ) {
+		float avg = stats[i*5+0];
+		float p99 = stats[i*5+3];
+		message += va( "%s: avg %.2f p99 %.2f msec", names[i].c_str(), avg, p99 );
+
+		j = baseNames.FindIndex( names[i] );
+		if ( j >= 0 && baseStats[j*5+0] > 0.0f && baseStats[j*5+3] > 0.0f ) {
+			float avgDelta = ( avg - baseStats[j*5+0] ) * 100.0f / baseStats[j*5+0];
+			float p99Delta = ( p99 - baseStats[j*5+3] ) * 100.0f / baseStats[j*5+3];
+			message += va( " (%+.1f%%, %+.1f%%)", avgDelta, p99Delta );
+			if ( avgDelta > tolerance || p99Delta > tolerance ) {
+				message += " REGRESSION";
+				regressions++;
+			}
+		}
+		message += "\n";
+	}
+	if ( baseNames.Num() ) {
+		message += va( "%i regressions against %s\n", regressions, baseline );
+	}
+
+	common->Printf( "%s", message.c_str() );
+
+	if ( benchmarkQuit ) {
+		cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "quit\n" );
+	} else {
+		soundSystem->SetMute( true );
+		MessageBox( MSG_OK, message, "Benchmark Results", true );
+		soundSystem->SetMute( false );
+	}
+}
+
 
 /*
 ================
@@ -2602,6 +2897,8 @@ void idSessionLocal::UpdateScreen( bool outOfSequence ) {
 
 	insideUpdateScreen = true;
 
+	PROF_SCOPE( "idSessionLocal::UpdateScreen" );
+
 	// if this is a long-operation update and we are in windowed mode,
 	// release the mouse capture back to the desktop
 	if ( outOfSequence ) {
@@ -2619,6 +2916,10 @@ void idSessionLocal::UpdateScreen( bool outOfSequence ) {
 		renderSystem->EndFrame( NULL, NULL );
 	}
 
+	if ( timeDemo && readDemo ) {
+		RecordTimeDemoFrame();
+	}
+
 	insideUpdateScreen = false;
 }
 
@@ -2975,6 +3276,8 @@ void idSessionLocal::Init() {
 	cmdSystem->AddCommand( "playDemo", Session_PlayDemo_f, CMD_FL_SYSTEM, "plays back a demo", idCmdSystem::ArgCompletion_DemoName );
 	cmdSystem->AddCommand( "timeDemo", Session_TimeDemo_f, CMD_FL_SYSTEM, "times a demo", idCmdSystem::ArgCompletion_DemoName );
 	cmdSystem->AddCommand( "timeDemoQuit", Session_TimeDemoQuit_f, CMD_FL_SYSTEM, "times a demo and quits", idCmdSystem::ArgCompletion_DemoName );
+	cmdSystem->AddCommand( "benchmark", Session_Benchmark_f, CMD_FL_SYSTEM, "times a list of demos and compares them to com_benchmarkBaseline", idCmdSystem::ArgCompletion_DemoName );
+	cmdSystem->AddCommand( "benchmarkQuit", Session_BenchmarkQuit_f, CMD_FL_SYSTEM, "times a list of demos and quits", idCmdSystem::ArgCompletion_DemoName );
 	cmdSystem->AddCommand( "aviDemo", Session_AVIDemo_f, CMD_FL_SYSTEM, "writes AVIs for a demo", idCmdSystem::ArgCompletion_DemoName );
 	cmdSystem->AddCommand( "compressDemo", Session_CompressDemo_f, CMD_FL_SYSTEM, "compresses a demo file", idCmdSystem::ArgCompletion_DemoName );
 #endif
@@ -86,6 +86,16 @@ typedef enum {
 	TD_YES_THEN_QUIT
 } timeDemo_t;
 
+// one frame of a timeDemo, written to the per frame CSV
+typedef struct {
+	int					frameUsec;
+	int					gameMsec;
+	renderFrameTimings_t	render;
+	int					allocs;
+	int					allocBytes;
+	int					frees;
+} timeDemoFrame_t;
+
 const int USERCMD_PER_DEMO_FRAME	= 2;
 const int CONNECT_TRANSMIT_TIME		= 1000;
 const int MAX_LOGGED_USERCMDS		= 60*60*60;	// one hour of single player, 15 minutes of four player
@@ -185,6 +195,9 @@ public:
 	static idCVar		com_aviDemoTics;
 	static idCVar		com_wipeSeconds;
 	static idCVar		com_guid;
+	static idCVar		com_timeDemoCSV;
+	static idCVar		com_benchmarkBaseline;
+	static idCVar		com_benchmarkTolerance;
 	static idCVar		com_numQuicksaves;
 
 	static idCVar		gui_configServerRate;
@@ -239,6 +252,14 @@ public:
 	timeDemo_t			timeDemo;
 	int					timeDemoStartTime;
 	int					numDemoFrames;		// for timeDemo and demoShot
+	idList<timeDemoFrame_t>	timeDemoFrames;
+	double				timeDemoFrameStart;
+	int					timeDemoGameMsec;	// time_gameFrame at the last sample
+
+	bool				benchmarkActive;	// timing a list of demos with the benchmark command
+	bool				benchmarkQuit;
+	idStrList			benchmarkDemos;		// demos that haven't been timed yet
+	idStr				benchmarkResults;	// one line per timed demo
 	int					demoTimeOffset;
 	renderView_t		currentDemoRenderView;
 	// the next one will be read when
@@ -295,6 +316,10 @@ public:
 	void				StopPlayingRenderDemo();
 	void				CompressDemoFile( const char *scheme, const char *name );
 	void				TimeRenderDemo( const char *name, bool twice = false );
+	void				RecordTimeDemoFrame();
+	void				ReportTimeDemoFrames( const char *demoName, idStr &message );
+	void				StartBenchmark( const idCmdArgs &args, bool quit );
+	void				AdvanceBenchmark();
 	void				AVIRenderDemo( const char *name );
 	void				AVICmdDemo( const char *name );
 	void				AVIGame( const char *name );
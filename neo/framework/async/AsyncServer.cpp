@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "idlib/LangDict.h"
+#include "idlib/Profiler.h"
 #include "framework/Session_local.h"
 #include "framework/Game.h"
 
@@ -2358,6 +2359,8 @@ void idAsyncServer::RunFrame( void ) {
 	int			outgoingRate, incomingRate;
 	float		outgoingCompression, incomingCompression;
 
+	PROF_SCOPE( "idAsyncServer::RunFrame" );
+
 	msec = UpdateTime( 100 );
 
 	if ( !serverPort.GetPort() ) {
@@ -204,27 +204,291 @@ const idEventDef *idEventDef::FindEvent( const char *name ) {
 	return NULL;
 }
 
+/*
+===============================================================================
+
+	Binary heap of the scheduled events. Events are ordered by time and then
+	by the order in which they were posted, which is the same order the old
+	sorted event list had.
+
+===============================================================================
+*/
+
+class idEventHeap {
+public:
+	int						Num( void ) const { return heap.Num(); }
+	idEvent *				First( void ) const { return heap.Num() ? heap[ 0 ] : NULL; }
+
+	void					Add( idEvent *event );
+	void					Remove( idEvent *event );
+	void					Clear( void );
+							// all events in the order they will be serviced
+	void					GetSorted( idList<idEvent *> &list ) const;
+
+private:
+	idList<idEvent *>		heap;
+
+	void					Set( int index, idEvent *event );
+	void					SiftUp( int index );
+	void					SiftDown( int index );
+
+	static bool				Before( const idEvent *a, const idEvent *b );
+	static int				SortCompare( idEvent * const *a, idEvent * const *b );
+};
+
+/*
+================
+idEventHeap::Before
+================
+*/
+ID_INLINE bool idEventHeap::Before( const idEvent *a, const idEvent *b ) {
+	if ( a->time != b->time ) {
+		return a->time < b->time;
+	}
+	// the sequence number may wrap
+	return (int)( (unsigned int)a->sequence - (unsigned int)b->sequence ) < 0;
+}
+
+/*
+================
+idEventHeap::SortCompare
+================
+*/
+int idEventHeap::SortCompare( idEvent * const *a, idEvent * const *b ) {
+	if ( Before( *a, *b ) ) {
+		return -1;
+	}
+	if ( Before( *b, *a ) ) {
+		return 1;
+	}
+	return 0;
+}
+
+/*
+================
+idEventHeap::Set
+================
+*/
+ID_INLINE void idEventHeap::Set( int index, idEvent *event ) {
+	heap[ index ] = event;
+	event->heapIndex = index;
+}
+
+/*
+================
+idEventHeap::SiftUp
+================
+*/
+void idEventHeap::SiftUp( int index ) {
+	idEvent *event = heap[ index ];
+
+	while( index > 0 ) {
+		int parent = ( index - 1 ) >> 1;
+		if ( !Before( event, heap[ parent ] ) ) {
+			break;
+		}
+		Set( index, heap[ parent ] );
+		index = parent;
+	}
+	Set( index, event );
+}
+
+/*
+================
+idEventHeap::SiftDown
+================
+*/
+void idEventHeap::SiftDown( int index ) {
+	idEvent *event = heap[ index ];
+	int num = heap.Num();
+
+	while( 1 ) {
+		int child = index * 2 + 1;
+		if ( child >= num ) {
+			break;
+		}
+		if ( child + 1 < num && Before( heap[ child + 1 ], heap[ child ] ) ) {
+			child++;
+		}
+		if ( !Before( heap[ child ], event ) ) {
+			break;
+		}
+		Set( index, heap[ child ] );
+		index = child;
+	}
+	Set( index, event );
+}
+
+/*
+================
+idEventHeap::Add
+================
+*/
+void idEventHeap::Add( idEvent *event ) {
+	assert( event->queue == NULL );
+
+	if ( heap.GetGranularity() < 256 ) {
+		heap.SetGranularity( 256 );
+	}
+	event->queue = this;
+	heap.Append( event );
+	SiftUp( heap.Num() - 1 );
+}
+
+/*
+================
+idEventHeap::Remove
+================
+*/
+void idEventHeap::Remove( idEvent *event ) {
+	int index = event->heapIndex;
+
+	assert( event->queue == this && heap[ index ] == event );
+
+	event->queue = NULL;
+	event->heapIndex = -1;
+
+	idEvent *last = heap[ heap.Num() - 1 ];
+	heap.SetNum( heap.Num() - 1, false );
+	if ( last == event ) {
+		return;
+	}
+
+	Set( index, last );
+	if ( index > 0 && Before( last, heap[ ( index - 1 ) >> 1 ] ) ) {
+		SiftUp( index );
+	} else {
+		SiftDown( index );
+	}
+}
+
+/*
+================
+idEventHeap::Clear
+================
+*/
+void idEventHeap::Clear( void ) {
+	for( int i = 0; i < heap.Num(); i++ ) {
+		heap[ i ]->queue = NULL;
+		heap[ i ]->heapIndex = -1;
+	}
+	heap.Clear();
+}
+
+/*
+================
+idEventHeap::GetSorted
+================
+*/
+void idEventHeap::GetSorted( idList<idEvent *> &list ) const {
+	list = heap;
+	list.Sort( SortCompare );
+}
+
 /***********************************************************************
 
   idEvent
 
 ***********************************************************************/
 
+typedef struct {
+	int						numPosted;
+	int						numCancelled;
+	int						numServiced;
+	int						peakQueued;
+	int						peakServiced;		// most events serviced in a single frame
+	int						startFrame;
+} eventStats_t;
+
 static idLinkList<idEvent> FreeEvents;
-static idLinkList<idEvent> EventQueue;
-static idEvent EventPool[ MAX_EVENTS ];
+static idEventHeap EventQueue;
+static idList<idEvent *> EventBlocks;
+static int EventSequence;
+static eventStats_t EventStats;
 
 bool idEvent::initialized = false;
 
 idDynamicBlockAlloc<byte, 16 * 1024, 256>	idEvent::eventDataAllocator;
 
+/*
+================
+idEvent::idEvent
+================
+*/
+idEvent::idEvent() {
+	eventdef	= NULL;
+	data		= NULL;
+	time		= 0;
+	object		= NULL;
+	typeinfo	= NULL;
+	sequence	= 0;
+	queue		= NULL;
+	heapIndex	= -1;
+
+	eventNode.SetOwner( this );
+	objectNode.SetOwner( this );
+}
+
 /*
 ================
 idEvent::~idEvent()
 ================
 */
 idEvent::~idEvent() {
-	Free();
+	if ( queue ) {
+		queue->Remove( this );
+	}
+	if ( data ) {
+		eventDataAllocator.Free( data );
+		data = NULL;
+	}
+}
+
+/*
+================
+idEvent::GetFreeEvent
+
+Takes an event from the free list, the pool grows when the list is empty.
+================
+*/
+idEvent *idEvent::GetFreeEvent( void ) {
+	idEvent	*ev;
+	int		i;
+
+	if ( FreeEvents.IsListEmpty() ) {
+		if ( EventBlocks.Num() * EVENT_POOL_BLOCK >= MAX_EVENT_POOL ) {
+			gameLocal.Error( "idEvent::GetFreeEvent : No more free events" );
+		}
+		ev = new idEvent[ EVENT_POOL_BLOCK ];
+		EventBlocks.Append( ev );
+		for( i = 0; i < EVENT_POOL_BLOCK; i++ ) {
+			ev[ i ].eventNode.AddToEnd( FreeEvents );
+		}
+	}
+
+	ev = FreeEvents.Next();
+	ev->eventNode.Remove();
+
+	return ev;
+}
+
+/*
+================
+idEvent::Enqueue
+================
+*/
+void idEvent::Enqueue( idEventHeap &eventHeap ) {
+	sequence = EventSequence++;
+	eventHeap.Add( this );
+
+	if ( object ) {
+		objectNode.AddToEnd( object->eventList );
+	}
+
+	int num = EventQueue.Num();
+	if ( num > EventStats.peakQueued ) {
+		EventStats.peakQueued = num;
+	}
 }
 
 /*
@@ -241,13 +505,7 @@ idEvent *idEvent::Alloc( const idEventDef *evdef, int numargs, va_list args ) {
 	int			i;
 	const char	*materialName;
 
-	if ( FreeEvents.IsListEmpty() ) {
-		gameLocal.Error( "idEvent::Alloc : No more free events" );
-	}
-
-	ev = FreeEvents.Next();
-	ev->eventNode.Remove();
-
+	ev = GetFreeEvent();
 	ev->eventdef = evdef;
 
 	if ( numargs != evdef->GetNumArgs() ) {
@@ -357,6 +615,11 @@ idEvent::Free
 ================
 */
 void idEvent::Free( void ) {
+	if ( queue ) {
+		queue->Remove( this );
+	}
+	objectNode.Remove();
+
 	if ( data ) {
 		eventDataAllocator.Free( data );
 		data = NULL;
@@ -367,7 +630,6 @@ void idEvent::Free( void ) {
 	object		= NULL;
 	typeinfo	= NULL;
 
-	eventNode.SetOwner( this );
 	eventNode.AddToEnd( FreeEvents );
 }
 
@@ -377,8 +639,6 @@ idEvent::Schedule
 ================
 */
 void idEvent::Schedule( idClass *obj, const idTypeInfo *type, int time ) {
-	idEvent *event;
-
 	assert( initialized );
 	if ( !initialized ) {
 		return;
@@ -390,23 +650,16 @@ void idEvent::Schedule( idClass *obj, const idTypeInfo *type, int time ) {
 	// wraps after 24 days...like I care. ;)
 	this->time = gameLocal.time + time;
 
-	eventNode.Remove();
-
-	event = EventQueue.Next();
-	while( ( event != NULL ) && ( this->time >= event->time ) ) {
-		event = event->eventNode.Next();
-	}
+	Enqueue( EventQueue );
 
-	if ( event ) {
-		eventNode.InsertBefore( event->eventNode );
-	} else {
-		eventNode.AddToEnd( EventQueue );
-	}
+	EventStats.numPosted++;
 }
 
 /*
 ================
 idEvent::CancelEvents
+
+Only walks the events posted to the object.
 ================
 */
 void idEvent::CancelEvents( const idClass *obj, const idEventDef *evdef ) {
@@ -417,12 +670,11 @@ void idEvent::CancelEvents( const idClass *obj, const idEventDef *evdef ) {
 		return;
 	}
 
-	for( event = EventQueue.Next(); event != NULL; event = next ) {
-		next = event->eventNode.Next();
-		if ( event->object == obj ) {
-			if ( !evdef || ( evdef == event->eventdef ) ) {
-				event->Free();
-			}
+	for( event = obj->eventList.Next(); event != NULL; event = next ) {
+		next = event->objectNode.Next();
+		if ( !evdef || ( evdef == event->eventdef ) ) {
+			event->Free();
+			EventStats.numCancelled++;
 		}
 	}
 }
@@ -433,20 +685,17 @@ idEvent::ClearEventList
 ================
 */
 void idEvent::ClearEventList( void ) {
-	int i;
-
-	//
-	// initialize lists
-	//
-	FreeEvents.Clear();
-	EventQueue.Clear();
+	idEvent *event;
 
 	//
-	// add the events to the free list
+	// return the scheduled events to the free list
 	//
-	for( i = 0; i < MAX_EVENTS; i++ ) {
-		EventPool[ i ].Free();
+	while( ( event = EventQueue.First() ) != NULL ) {
+		event->Free();
 	}
+
+	memset( &EventStats, 0, sizeof( EventStats ) );
+	EventStats.startFrame = gameLocal.framenum;
 }
 
 /*
@@ -466,12 +715,10 @@ void idEvent::ServiceEvents( void ) {
 	const idEventDef *ev;
 	byte		*data;
 	const char  *materialName;
+	const char	*classname;
 
 	num = 0;
-	while( !EventQueue.IsListEmpty() ) {
-		event = EventQueue.Next();
-		assert( event );
-
+	while( ( event = EventQueue.First() ) != NULL ) {
 		if ( event->time > gameLocal.time ) {
 			break;
 		}
@@ -522,22 +769,29 @@ void idEvent::ServiceEvents( void ) {
 			}
 		}
 
-		// the event is removed from its list so that if then object
+		// the event is removed from its lists so that if then object
 		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		event->queue->Remove( event );
+		event->objectNode.Remove();
 		assert( event->object );
 		event->object->ProcessEventArgPtr( ev, args );
 
 		// return the event to the free list
+		classname = event->typeinfo->classname;
 		event->Free();
 
 		// Don't allow ourselves to stay in here too long.  An abnormally high number
 		// of events being processed is evidence of an infinite loop of events.
 		num++;
 		if ( num > MAX_EVENTSPERFRAME ) {
-			gameLocal.Error( "Event overflow.  Possible infinite loop in script." );
+			gameLocal.Error( "Event overflow.  Possible infinite loop in script.  Last event '%s' on '%s', %d events queued.", ev->GetName(), classname, EventQueue.Num() );
 		}
 	}
+
+	EventStats.numServiced += num;
+	if ( num > EventStats.peakServiced ) {
+		EventStats.peakServiced = num;
+	}
 }
 
 /*
@@ -589,12 +843,50 @@ void idEvent::Shutdown( void ) {
 
 	ClearEventList();
 
+	// free the event pool
+	EventQueue.Clear();
+	FreeEvents.Clear();
+	for( int i = 0; i < EventBlocks.Num(); i++ ) {
+		delete[] EventBlocks[ i ];
+	}
+	EventBlocks.Clear();
+
 	eventDataAllocator.Shutdown();
 
 	// say it is now shutdown
 	initialized = false;
 }
 
+/*
+================
+idEvent::Stats_f
+
+Rates are per second of game time since the event list was cleared or the stats were reset.
+================
+*/
+void idEvent::Stats_f( const idCmdArgs &args ) {
+	float seconds;
+
+	if ( args.Argc() > 1 && !idStr::Icmp( args.Argv( 1 ), "reset" ) ) {
+		memset( &EventStats, 0, sizeof( EventStats ) );
+		EventStats.startFrame = gameLocal.framenum;
+		return;
+	}
+
+	seconds = ( gameLocal.framenum - EventStats.startFrame ) * USERCMD_MSEC * 0.001f;
+	if ( seconds < USERCMD_MSEC * 0.001f ) {
+		seconds = USERCMD_MSEC * 0.001f;
+	}
+
+	gameLocal.Printf( "%5d events queued, peak %d\n", EventQueue.Num(), EventStats.peakQueued );
+	gameLocal.Printf( "%5d events in the pool, %d free, %d max\n", EventBlocks.Num() * EVENT_POOL_BLOCK, FreeEvents.Num(), MAX_EVENT_POOL );
+	gameLocal.Printf( "%5d posted    %8.1f/s\n", EventStats.numPosted, EventStats.numPosted / seconds );
+	gameLocal.Printf( "%5d cancelled %8.1f/s\n", EventStats.numCancelled, EventStats.numCancelled / seconds );
+	gameLocal.Printf( "%5d serviced  %8.1f/s\n", EventStats.numServiced, EventStats.numServiced / seconds );
+	gameLocal.Printf( "%5d most serviced in a frame, overflow at %d\n", EventStats.peakServiced, MAX_EVENTSPERFRAME );
+	gameLocal.Printf( "over %.1f seconds\n", seconds );
+}
+
 /*
 ================
 idEvent::Save
@@ -608,11 +900,15 @@ void idEvent::Save( idSaveGame *savefile ) {
 	bool validTrace;
 	const char	*format;
 	idStr s;
+	idList<idEvent *> events;
+	int n;
 
-	savefile->WriteInt( EventQueue.Num() );
+	// write the events in the order they will be serviced
+	EventQueue.GetSorted( events );
+	savefile->WriteInt( events.Num() );
 
-	event = EventQueue.Next();
-	while( event != NULL ) {
+	for( n = 0; n < events.Num(); n++ ) {
+		event = events[ n ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
@@ -665,7 +961,6 @@ void idEvent::Save( idSaveGame *savefile ) {
 			}
 		}
 		assert( size == event->eventdef->GetArgSize() );
-		event = event->eventNode.Next();
 	}
 }
 
@@ -686,13 +981,7 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 	savefile->ReadInt( num );
 
 	for ( i = 0; i < num; i++ ) {
-		if ( FreeEvents.IsListEmpty() ) {
-			gameLocal.Error( "idEvent::Restore : No more free events" );
-		}
-
-		event = FreeEvents.Next();
-		event->eventNode.Remove();
-		event->eventNode.AddToEnd( EventQueue );
+		event = GetFreeEvent();
 
 		savefile->ReadInt( event->time );
 
@@ -712,6 +1001,9 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 
 		savefile->ReadObject( event->object );
 
+		// the events were saved in the order they are serviced
+		event->Enqueue( EventQueue );
+
 		// read the args
 		savefile->ReadInt( argsize );
 		if ( argsize != event->eventdef->GetArgSize() ) {
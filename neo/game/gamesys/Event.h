@@ -51,6 +51,9 @@ If you have questions concerning this license or the applicable additional terms
 
 #define MAX_EVENTS					4096
 
+#define EVENT_POOL_BLOCK			1024		// the event pool grows by this many events
+#define MAX_EVENT_POOL				( 64 * 1024 )
+
 class idClass;
 class idTypeInfo;
 
@@ -88,8 +91,10 @@ public:
 
 class idSaveGame;
 class idRestoreGame;
+class idEventHeap;
 
 class idEvent {
+	friend class idEventHeap;
 private:
 	const idEventDef			*eventdef;
 	byte						*data;
@@ -97,14 +102,22 @@ private:
 	idClass						*object;
 	const idTypeInfo			*typeinfo;
 
-	idLinkList<idEvent>			eventNode;
+	int							sequence;		// orders events with the same time in the order they were posted
+	idEventHeap *				queue;			// heap of the queue the event is scheduled in
+	int							heapIndex;		// index in the heap of the queue
+
+	idLinkList<idEvent>			eventNode;		// free list
+	idLinkList<idEvent>			objectNode;		// events posted to the same object
 
 	static idDynamicBlockAlloc<byte, 16 * 1024, 256> eventDataAllocator;
 
+	static idEvent *			GetFreeEvent( void );
+	void						Enqueue( idEventHeap &eventHeap );
 
 public:
 	static bool					initialized;
 
+								idEvent();
 								~idEvent();
 
 	static idEvent				*Alloc( const idEventDef *evdef, int numargs, va_list args );
@@ -119,6 +132,7 @@ public:
 	static void					ServiceEvents( void );
 	static void					Init( void );
 	static void					Shutdown( void );
+	static void					Stats_f( const idCmdArgs &args );
 
 	// save games
 	static void					Save( idSaveGame *savefile );					// archives object for save game file
@@ -2506,13 +2506,13 @@ void idCompiler::ParseEventDef( idTypeDef *returnType, const char *name ) {
 		type->def = gameLocal.program.AllocDef( type, name, &def_namespace, true );
 
 		function_t &func	= gameLocal.program.AllocFunction( type->def );
-		func.eventdef		= ev;
 		func.parmSize.SetNum( num );
 		for( i = 0; i < num; i++ ) {
 			argType = newtype.GetParmType( i );
 			func.parmTotal		+= argType->Size();
 			func.parmSize[ i ]	= argType->Size();
 		}
+		func.BindEvent( ev );
 
 		// mark the parms as local
 		func.locals	= func.parmTotal;
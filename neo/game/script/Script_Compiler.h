@@ -198,6 +198,23 @@ enum {
 	NUM_OPCODES
 };
 
+// superinstructions of the decoded statements, a comparison fused with the
+// OP_IFNOT that tests its result.  see idProgram::DecodeStatements
+enum {
+	OP_LT_IFNOT = NUM_OPCODES,
+	OP_LE_IFNOT,
+	OP_GT_IFNOT,
+	OP_GE_IFNOT,
+	OP_EQ_F_IFNOT,
+	OP_NE_F_IFNOT,
+	OP_EQ_E_IFNOT,
+	OP_NE_E_IFNOT,
+	OP_NOT_BOOL_IFNOT,
+	OP_NOT_F_IFNOT,
+
+	NUM_DECODED_OPCODES
+};
+
 class idCompiler {
 private:
 	static bool		punctuationValid[ 256 ];
@@ -53,6 +53,12 @@ typedef enum {
 	ev_error = -1, ev_void, ev_scriptevent, ev_namespace, ev_string, ev_float, ev_vector, ev_entity, ev_field, ev_function, ev_virtualfunction, ev_pointer, ev_object, ev_jumpoffset, ev_argsize, ev_boolean
 } etype_t;
 
+// parm of an event function, the conversion and where the script pushed it
+typedef struct {
+	char				type;			// D_EVENT_* of the event def
+	int					stackOffset;	// from the first parm
+} eventParm_t;
+
 class function_t {
 public:
 						function_t();
@@ -61,6 +67,7 @@ public:
 	void				SetName( const char *name );
 	const char			*Name( void ) const;
 	void				Clear( void );
+	void				BindEvent( const idEventDef *ev );
 
 private:
 	idStr				name;
@@ -74,6 +81,7 @@ public:
 	int					locals;			// total ints of parms + locals
 	int					filenum;			// source file defined in
 	idList<int>			parmSize;
+	idList<eventParm_t>	eventParms;		// set by BindEvent
 };
 
 typedef union eval_s {
@@ -94,6 +102,7 @@ Contains type information for variables and functions.
 ***********************************************************************/
 
 class idTypeDef {
+	friend class idProgram;
 private:
 	etype_t						type;
 	idStr						name;
@@ -433,6 +442,21 @@ typedef struct statement_s {
 	idVarDef		*c;
 } statement_t;
 
+// operands of a decoded statement that are local variables
+#define DECODED_STACK_A		1
+#define DECODED_STACK_B		2
+#define DECODED_STACK_C		4
+
+// statement with the operands resolved for idInterpreter::Execute, the value of
+// the def or the stack offset of local variables.  same index as the statement
+typedef struct decodedStatement_s {
+	unsigned short	op;				// opcode or superinstruction
+	unsigned short	stack;			// DECODED_STACK_? bits
+	varEval_t		a;
+	varEval_t		b;
+	varEval_t		c;
+} decodedStatement_t;
+
 /***********************************************************************
 
 idProgram
@@ -455,6 +479,7 @@ private:
 	idStaticList<byte,MAX_GLOBALS>				variableDefaults;
 	idStaticList<function_t,MAX_FUNCS>			functions;
 	idStaticList<statement_t,MAX_STATEMENTS>	statements;
+	idList<decodedStatement_t>					decodedStatements;
 	idList<idTypeDef *>							types;
 	idList<idVarDefName *>						varDefNames;
 	idHashIndex									varDefNameHash;
@@ -472,6 +497,11 @@ private:
 	byte										*ReserveMem(int size);
 	idVarDef									*AllocVarDef(idTypeDef *type, const char *name, idVarDef *scope);
 
+	// compiled program cache
+	void										GetCacheSources( const idStrList &files, idStrList &names, idList<int> &checksums ) const;
+	bool										LoadCache( const char *cacheName );
+	void										WriteCache( const char *cacheName ) const;
+
 public:
 	idVarDef									*returnDef;
 	idVarDef									*returnStringDef;
@@ -525,6 +555,11 @@ public:
 	statement_t									&GetStatement( int index );
 	int											NumStatements( void ) { return statements.Num(); }
 
+	// decoded statements for the interpreter, statements compiled since the last call are decoded first
+	const decodedStatement_t					*GetDecodedStatements( void );
+	void										DecodeStatement( int index, decodedStatement_t &ds ) const;
+	void										DecodeStatements( void );
+
 	int											GetReturnedInteger( void );
 
 	void										ReturnFloat( float value );
@@ -545,6 +580,18 @@ ID_INLINE statement_t &idProgram::GetStatement( int index ) {
 	return statements[ index ];
 }
 
+/*
+================
+idProgram::GetDecodedStatements
+================
+*/
+ID_INLINE const decodedStatement_t *idProgram::GetDecodedStatements( void ) {
+	if ( decodedStatements.Num() != statements.Num() ) {
+		DecodeStatements();
+	}
+	return decodedStatements.Ptr();
+}
+
 /*
 ================
 idProgram::GetFunction
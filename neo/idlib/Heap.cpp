@@ -43,16 +43,139 @@ If you have questions concerning this license or the applicable additional terms
 //
 //	idHeap
 //
+//	Every thread has a cache with a list of free blocks for each
+//	size class, most allocations and frees only touch that cache.
+//	The cache exchanges batches of blocks with the central heap when
+//	it runs empty or holds too many blocks. The central heap carves
+//	64 kB pages into blocks of a single size class, each size class
+//	has its own lock. A page map finds the page of any block so the
+//	blocks don't need a header. All blocks are 16 byte aligned.
+//	Allocations larger than the largest size class come straight
+//	from malloc() with a small header.
+//
 //===============================================================
 
-#define SMALL_HEADER_SIZE		( (intptr_t) ( sizeof( byte ) + sizeof( byte ) ) )
-#define MEDIUM_HEADER_SIZE		( (intptr_t) ( sizeof( mediumHeapEntry_s ) + sizeof( byte ) ) )
-#define LARGE_HEADER_SIZE		( (intptr_t) ( sizeof( dword * ) + sizeof( byte ) ) )
+#define HEAP_ALIGN				16
+#define HEAP_PAGE_SHIFT			16
+#define HEAP_PAGE_SIZE			( 1 << HEAP_PAGE_SHIFT )
+#define HEAP_PAGES_PER_CHUNK	16								// pages allocated from the OS at once
+#define HEAP_PAGE_MAP_BITS		16
+#define HEAP_PAGE_MAP_SIZE		( 1 << HEAP_PAGE_MAP_BITS )
+#define HEAP_MAX_SMALL_SIZE		32768
+#define HEAP_NUM_SIZE_CLASSES	54
+#define HEAP_MAX_BATCH			32
+#define HEAP_LARGE_MAGIC		0x4c617267
+
+#define ALIGN_SIZE( bytes )		( ( (bytes) + HEAP_ALIGN - 1 ) & ~(HEAP_ALIGN - 1) )
+#define LARGE_HEADER_SIZE		ALIGN_SIZE( (intptr_t) sizeof( heapLargeHeader_t ) )
+
+// the sizes above 8 kB are the largest multiples of 128 that fit 7, 6, 5, 4, 3 and 2 times in a page
+static const int heapSizeClasses[HEAP_NUM_SIZE_CLASSES] = {
+	16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 256,
+	320, 384, 448, 512, 576, 640, 704, 768, 832, 896, 960, 1024,
+	1280, 1536, 1792, 2048, 2304, 2560, 2816, 3072, 3328, 3584, 3840, 4096,
+	4608, 5120, 5632, 6144, 6656, 7168, 7680, 8192,
+	9344, 10880, 13056, 16384, 21760, 32768
+};
 
-#define ALIGN_SIZE( bytes )		( ( (bytes) + ALIGN - 1 ) & ~(ALIGN - 1) )
-#define SMALL_ALIGN( bytes )	( ALIGN_SIZE( (bytes) + SMALL_HEADER_SIZE ) - SMALL_HEADER_SIZE )
-#define MEDIUM_SMALLEST_SIZE	( ALIGN_SIZE( 256 ) + ALIGN_SIZE( MEDIUM_HEADER_SIZE ) )
+/*
+================
+idHeapLock
+
+  a simple spin lock, the heap is used long before and after
+  the threading code is initialized
+================
+*/
+class idHeapLock {
+public:
+	void			Init( void ) { lock = 0; }
+	void			Lock( void );
+	void			Unlock( void );
 
+private:
+#ifdef _WIN32
+	volatile LONG	lock;
+#else
+	volatile int	lock;
+#endif
+};
+
+ID_INLINE void idHeapLock::Lock( void ) {
+	for ( int spins = 0; ; spins++ ) {
+		if ( !lock ) {
+#ifdef _WIN32
+			if ( InterlockedExchange( &lock, 1 ) == 0 ) {
+#else
+			if ( __sync_lock_test_and_set( &lock, 1 ) == 0 ) {
+#endif
+				return;
+			}
+		}
+		if ( spins > 1000 ) {
+			Sys_Sleep( 0 );
+		}
+	}
+}
+
+ID_INLINE void idHeapLock::Unlock( void ) {
+#ifdef _WIN32
+	InterlockedExchange( &lock, 0 );
+#else
+	__sync_lock_release( &lock );
+#endif
+}
+
+typedef struct heapPage_s {
+	struct heapPage_s *	next;				// next page with free blocks of the same size class, or next free page
+	struct heapPage_s *	prev;
+	struct heapChunk_s *chunk;
+	byte *				data;				// HEAP_PAGE_SIZE bytes
+	void *				firstFree;			// blocks returned to this page
+	int					numCarved;			// blocks carved from the page, the remainder was never touched
+	int					numUsed;			// blocks allocated or sitting in a thread cache
+	int					sizeClass;			// -1 if the page is free
+} heapPage_t;
+
+typedef struct heapChunk_s {
+	struct heapChunk_s *next;
+	void *				memory;				// as returned by malloc
+	int					numFreePages;
+	heapPage_t			pages[HEAP_PAGES_PER_CHUNK];
+} heapChunk_t;
+
+typedef struct {
+	idHeapLock			lock;
+	int					size;
+	int					blocksPerPage;
+	int					batchSize;			// blocks moved between a thread cache and the central heap at once
+	heapPage_t *		firstPage;			// pages with free blocks, full pages aren't linked
+	int					numPages;			// pages used by this size class
+} heapSizeClass_t;
+
+typedef struct heapThreadCache_s {
+	void *				freeList[HEAP_NUM_SIZE_CLASSES];
+	int					numFree[HEAP_NUM_SIZE_CLASSES];
+	// statistics, frees may come from a different thread than the allocation
+	unsigned int		numAllocs[HEAP_NUM_SIZE_CLASSES];
+	unsigned int		numFrees[HEAP_NUM_SIZE_CLASSES];
+	unsigned int		numLargeAllocs;
+	unsigned int		numLargeFrees;
+	memoryStats_t		totalAllocs;
+	memoryStats_t		frameAllocs;
+	memoryStats_t		frameFrees;
+	struct heapThreadCache_s *next;
+} heapThreadCache_t;
+
+typedef struct {
+	void *				memory;				// as returned by malloc
+	dword				size;
+	dword				magic;
+} heapLargeHeader_t;
+
+// the thread caches of a previous heap are invalid, that's what the generation is for
+static ID_THREAD_LOCAL heapThreadCache_t *	heapThreadCache = NULL;
+static ID_THREAD_LOCAL int					heapThreadGeneration = 0;
+static int									heapGeneration = 0;
 
 class idHeap {
 
@@ -69,79 +192,47 @@ public:
 
 	void			AllocDefragBlock( void );		// hack for huge renderbumps
 
+	heapThreadCache_t *GetThreadCache( void );
+	void			GetStats( memoryStats_t &stats );
+	void			GetFrameStats( memoryStats_t &allocs, memoryStats_t &frees );
+	void			ClearFrameStats( void );
+	int				GetSizeClassStats( memorySizeClassStats_t *stats, int maxStats );
+
 private:
+	heapSizeClass_t	sizeClasses[HEAP_NUM_SIZE_CLASSES];
+	byte			smallSizeClass[1024/16+1];		// size class for ( bytes + 15 ) >> 4
+	byte			largeSizeClass[HEAP_MAX_SMALL_SIZE/128+1];	// size class for ( bytes + 127 ) >> 7
+
+	idHeapLock		pageLock;						// protects the chunks, the free pages and the page map
+	heapChunk_t *	chunks;
+	heapPage_t *	freePages;
+	int				numChunks;
+	int				numFreePages;
+	heapPage_t **	pageMap[HEAP_PAGE_MAP_SIZE];	// two level map from address to page, read without locking
 
-	enum {
-		ALIGN = 8									// memory alignment in bytes
-	};
-
-	enum {
-		INVALID_ALLOC	= 0xdd,
-		SMALL_ALLOC		= 0xaa,						// small allocation
-		MEDIUM_ALLOC	= 0xbb,						// medium allocaction
-		LARGE_ALLOC		= 0xcc						// large allocaction
-	};
-
-	struct page_s {									// allocation page
-		void *				data;					// data pointer to allocated memory
-		dword				dataSize;				// number of bytes of memory 'data' points to
-		page_s *			next;					// next free page in same page manager
-		page_s *			prev;					// used only when allocated
-		dword				largestFree;			// this data used by the medium-size heap manager
-		void *				firstFree;				// pointer to first free entry
-	};
-
-	struct mediumHeapEntry_s {
-		page_s *			page;					// pointer to page
-		dword				size;					// size of block
-		mediumHeapEntry_s *	prev;					// previous block
-		mediumHeapEntry_s *	next;					// next block
-		mediumHeapEntry_s *	prevFree;				// previous free block
-		mediumHeapEntry_s *	nextFree;				// next free block
-		dword				freeBlock;				// non-zero if free block
-	};
-
-	// variables
-	void *			smallFirstFree[256/ALIGN+1];	// small heap allocator lists (for allocs of 1-255 bytes)
-	page_s *		smallCurPage;					// current page for small allocations
-	dword			smallCurPageOffset;				// byte offset in current page
-	page_s *		smallFirstUsedPage;				// first used page of the small heap manager
-
-	page_s *		mediumFirstFreePage;			// first partially free page
-	page_s *		mediumLastFreePage;				// last partially free page
-	page_s *		mediumFirstUsedPage;			// completely used page
-
-	page_s *		largeFirstUsedPage;				// first page used by the large heap manager
-
-	page_s *		swapPage;
-
-	dword			pagesAllocated;					// number of pages currently allocated
-	dword			pageSize;						// size of one alloc page in bytes
-
-	dword			pageRequests;					// page requests
-	dword			OSAllocs;						// number of allocs made to the OS
-
-	int				c_heapAllocRunningCount;
+	idHeapLock		cacheLock;						// protects the list of thread caches
+	heapThreadCache_t *threadCaches;
+	int				generation;
 
 	void			*defragBlock;					// a single huge block that can be allocated
 													// at startup, then freed when needed
 
-	// methods
-	page_s *		AllocatePage( dword bytes );	// allocate page from the OS
-	void			FreePage( idHeap::page_s *p );	// free an OS allocated page
+	void *			SystemAlloc( size_t bytes );	// malloc with the defrag block fallback
 
-	void *			SmallAllocate( dword bytes );	// allocate memory (1-255 bytes) from small heap manager
-	void			SmallFree( void *ptr );			// free memory allocated by small heap manager
+	int				SizeClass( dword bytes ) const;
+	heapPage_t *	FindPage( const void *p ) const;
+	heapPage_t *	AllocatePage( void );
+	void			FreePage( heapPage_t *page );
+	void			ReleaseChunk( heapChunk_t *chunk );
 
-	void *			MediumAllocateFromPage( idHeap::page_s *p, dword sizeNeeded );
-	void *			MediumAllocate( dword bytes );	// allocate memory (256-32768 bytes) from medium heap manager
-	void			MediumFree( void *ptr );		// free memory allocated by medium heap manager
+	void			FetchBlocks( heapThreadCache_t *cache, int sizeClass );
+	void			ReleaseBlocks( heapThreadCache_t *cache, int sizeClass, int count );
 
-	void *			LargeAllocate( dword bytes );	// allocate large block from OS directly
-	void			LargeFree( void *ptr );			// free memory allocated by large heap manager
+	void *			SmallAllocate( dword bytes );
+	void			SmallFree( heapPage_t *page, void *ptr );
 
-	void			ReleaseSwappedPages( void );
-	void			FreePageReal( idHeap::page_s *p );
+	void *			LargeAllocate( dword bytes );
+	void			LargeFree( void *ptr );
 };
 
 
@@ -151,27 +242,43 @@ idHeap::Init
 ================
 */
 void idHeap::Init () {
-	OSAllocs			= 0;
-	pageRequests		= 0;
-	pageSize			= 65536 - sizeof( idHeap::page_s );
-	pagesAllocated		= 0;								// reset page allocation counter
+	int i, j;
 
-	largeFirstUsedPage	= NULL;								// init large heap manager
-	swapPage			= NULL;
+	for ( i = 0; i < HEAP_NUM_SIZE_CLASSES; i++ ) {
+		heapSizeClass_t &sc = sizeClasses[i];
+		sc.lock.Init();
+		sc.size = heapSizeClasses[i];
+		sc.blocksPerPage = HEAP_PAGE_SIZE / sc.size;
+		sc.batchSize = Min( HEAP_MAX_BATCH, Max( 1, sc.blocksPerPage / 4 ) );
+		sc.firstPage = NULL;
+		sc.numPages = 0;
+	}
 
-	memset( smallFirstFree, 0, sizeof(smallFirstFree) );	// init small heap manager
-	smallFirstUsedPage	= NULL;
-	smallCurPage		= AllocatePage( pageSize );
-	assert( smallCurPage );
-	smallCurPageOffset	= SMALL_ALIGN( 0 );
+	for ( i = 0, j = 0; i < (int)sizeof( smallSizeClass ); i++ ) {
+		while ( heapSizeClasses[j] < i * 16 ) {
+			j++;
+		}
+		smallSizeClass[i] = j;
+	}
+	for ( i = 0, j = 0; i < (int)sizeof( largeSizeClass ); i++ ) {
+		while ( heapSizeClasses[j] < i * 128 ) {
+			j++;
+		}
+		largeSizeClass[i] = j;
+	}
 
-	defragBlock = NULL;
+	pageLock.Init();
+	chunks = NULL;
+	freePages = NULL;
+	numChunks = 0;
+	numFreePages = 0;
+	memset( pageMap, 0, sizeof( pageMap ) );
 
-	mediumFirstFreePage	= NULL;								// init medium heap manager
-	mediumLastFreePage	= NULL;
-	mediumFirstUsedPage	= NULL;
+	cacheLock.Init();
+	threadCaches = NULL;
+	generation = ++heapGeneration;
 
-	c_heapAllocRunningCount = 0;
+	defragBlock = NULL;
 }
 
 /*
@@ -191,47 +298,29 @@ idHeap::~idHeap
 ================
 */
 idHeap::~idHeap( void ) {
+	heapThreadCache_t *cache, *nextCache;
+	heapChunk_t *chunk, *nextChunk;
 
-	idHeap::page_s	*p;
-
-	if ( smallCurPage ) {
-		FreePage( smallCurPage );			// free small-heap current allocation page
-	}
-	p = smallFirstUsedPage;					// free small-heap allocated pages
-	while( p ) {
-		idHeap::page_s *next = p->next;
-		FreePage( p );
-		p= next;
-	}
-
-	p = largeFirstUsedPage;					// free large-heap allocated pages
-	while( p ) {
-		idHeap::page_s *next = p->next;
-		FreePage( p );
-		p = next;
+	for ( cache = threadCaches; cache; cache = nextCache ) {
+		nextCache = cache->next;
+		::free( cache );
 	}
 
-	p = mediumFirstFreePage;				// free medium-heap allocated pages
-	while( p ) {
-		idHeap::page_s *next = p->next;
-		FreePage( p );
-		p = next;
+	for ( chunk = chunks; chunk; chunk = nextChunk ) {
+		nextChunk = chunk->next;
+		::free( chunk->memory );
+		::free( chunk );
 	}
 
-	p = mediumFirstUsedPage;				// free medium-heap allocated completely used pages
-	while( p ) {
-		idHeap::page_s *next = p->next;
-		FreePage( p );
-		p = next;
+	for ( int i = 0; i < HEAP_PAGE_MAP_SIZE; i++ ) {
+		if ( pageMap[i] ) {
+			::free( pageMap[i] );
+		}
 	}
 
-	ReleaseSwappedPages();
-
 	if ( defragBlock ) {
 		free( defragBlock );
 	}
-
-	assert( pagesAllocated == 0 );
 }
 
 /*
@@ -257,724 +346,644 @@ void idHeap::AllocDefragBlock( void ) {
 
 /*
 ================
-idHeap::Allocate
+idHeap::SystemAlloc
 ================
 */
-void *idHeap::Allocate( const dword bytes ) {
-	if ( !bytes ) {
-		return NULL;
-	}
-	c_heapAllocRunningCount++;
-
-#if USE_LIBC_MALLOC
-	return malloc( bytes );
-#else
-	if ( !(bytes & ~255) ) {
-		return SmallAllocate( bytes );
-	}
-	if ( !(bytes & ~32767) ) {
-		return MediumAllocate( bytes );
+void *idHeap::SystemAlloc( size_t bytes ) {
+	void *p = ::malloc( bytes );
+	if ( !p ) {
+		if ( defragBlock ) {
+			idLib::common->Printf( "Freeing defragBlock on alloc of %i.\n", (int)bytes );
+			free( defragBlock );
+			defragBlock = NULL;
+			p = ::malloc( bytes );
+			AllocDefragBlock();
+		}
+		if ( !p ) {
+			common->FatalError( "malloc failure for %i", (int)bytes );
+		}
 	}
-	return LargeAllocate( bytes );
-#endif
+	return p;
 }
 
 /*
 ================
-idHeap::Free
+idHeap::GetThreadCache
+
+  the cache of the calling thread, created on first use
+  the cache of a thread that exits is never reused, the few
+  blocks it holds stay allocated until the heap is destroyed
 ================
 */
-void idHeap::Free( void *p ) {
-	if ( !p ) {
-		return;
+heapThreadCache_t *idHeap::GetThreadCache( void ) {
+	if ( heapThreadGeneration == generation ) {
+		return heapThreadCache;
 	}
-	c_heapAllocRunningCount--;
 
-#if USE_LIBC_MALLOC
-	free( p );
-#else
-	switch( ((byte *)(p))[-1] ) {
-		case SMALL_ALLOC: {
-			SmallFree( p );
-			break;
-		}
-		case MEDIUM_ALLOC: {
-			MediumFree( p );
-			break;
-		}
-		case LARGE_ALLOC: {
-			LargeFree( p );
-			break;
-		}
-		default: {
-			idLib::common->FatalError( "idHeap::Free: invalid memory block" );
-			break;
-		}
-	}
-#endif
+	heapThreadCache_t *cache = (heapThreadCache_t *) SystemAlloc( sizeof( heapThreadCache_t ) );
+	memset( cache, 0, sizeof( *cache ) );
+	cache->totalAllocs.minSize = cache->frameAllocs.minSize = cache->frameFrees.minSize = 0x0fffffff;
+	cache->totalAllocs.maxSize = cache->frameAllocs.maxSize = cache->frameFrees.maxSize = -1;
+
+	cacheLock.Lock();
+	cache->next = threadCaches;
+	threadCaches = cache;
+	cacheLock.Unlock();
+
+	heapThreadCache = cache;
+	heapThreadGeneration = generation;
+	return cache;
 }
 
 /*
 ================
-idHeap::Allocate16
+idHeap::SizeClass
 ================
 */
-void *idHeap::Allocate16( const dword bytes ) {
-	byte *ptr, *alignedPtr;
-
-	ptr = (byte *) malloc( bytes + 16 + sizeof(intptr_t) );
-	if ( !ptr ) {
-		if ( defragBlock ) {
-			idLib::common->Printf( "Freeing defragBlock on alloc of %i.\n", bytes );
-			free( defragBlock );
-			defragBlock = NULL;
-			ptr = (byte *) malloc( bytes + 16 + sizeof(intptr_t) );
-			AllocDefragBlock();
-		}
-		if ( !ptr ) {
-			common->FatalError( "malloc failure for %i", bytes );
-		}
-	}
-	alignedPtr = (byte *) ( ( ( (intptr_t) ptr ) + 15) & ~15 );
-	if ( alignedPtr - ptr < sizeof(intptr_t) ) {
-		alignedPtr += 16;
+ID_INLINE int idHeap::SizeClass( dword bytes ) const {
+	if ( bytes <= 1024 ) {
+		return smallSizeClass[( bytes + 15 ) >> 4];
 	}
-	*((intptr_t *)(alignedPtr - sizeof(intptr_t))) = (intptr_t) ptr;
-	return (void *) alignedPtr;
+	return largeSizeClass[( bytes + 127 ) >> 7];
 }
 
 /*
 ================
-idHeap::Free16
+idHeap::FindPage
+
+  returns NULL for memory not allocated from a page
 ================
 */
-void idHeap::Free16( void *p ) {
-	free( (void *) *((intptr_t *) (( (byte *) p ) - sizeof(intptr_t))) );
+ID_INLINE heapPage_t *idHeap::FindPage( const void *p ) const {
+	uint64_t address = (uintptr_t) p;
+	heapPage_t **leaf = pageMap[( address >> ( HEAP_PAGE_SHIFT + HEAP_PAGE_MAP_BITS ) ) & ( HEAP_PAGE_MAP_SIZE - 1 )];
+	if ( !leaf ) {
+		return NULL;
+	}
+	return leaf[( address >> HEAP_PAGE_SHIFT ) & ( HEAP_PAGE_MAP_SIZE - 1 )];
 }
 
 /*
 ================
-idHeap::Msize
+idHeap::AllocatePage
 
-  returns size of allocated memory block
-  p	= pointer to memory block
-  Notes:	size may not be the same as the size in the original
-			allocation request (due to block alignment reasons).
+  returns a free page, allocates a new chunk of pages from the OS if necessary
 ================
 */
-dword idHeap::Msize( void *p ) {
+heapPage_t *idHeap::AllocatePage( void ) {
+	heapPage_t *page;
+
+	pageLock.Lock();
+
+	if ( !freePages ) {
+		heapChunk_t *chunk = (heapChunk_t *) SystemAlloc( sizeof( heapChunk_t ) );
+		chunk->memory = SystemAlloc( HEAP_PAGES_PER_CHUNK * HEAP_PAGE_SIZE + HEAP_PAGE_SIZE - 1 );
+		byte *data = (byte *)( ( (intptr_t) chunk->memory + HEAP_PAGE_SIZE - 1 ) & ~(intptr_t)( HEAP_PAGE_SIZE - 1 ) );
+
+		for ( int i = 0; i < HEAP_PAGES_PER_CHUNK; i++ ) {
+			page = &chunk->pages[i];
+			page->chunk = chunk;
+			page->data = data + i * HEAP_PAGE_SIZE;
+			page->prev = NULL;
+			page->sizeClass = -1;
+
+			// register the page in the page map
+			uint64_t address = (uintptr_t) page->data;
+			heapPage_t **&leaf = pageMap[( address >> ( HEAP_PAGE_SHIFT + HEAP_PAGE_MAP_BITS ) ) & ( HEAP_PAGE_MAP_SIZE - 1 )];
+			if ( !leaf ) {
+				leaf = (heapPage_t **) SystemAlloc( HEAP_PAGE_MAP_SIZE * sizeof( heapPage_t * ) );
+				memset( leaf, 0, HEAP_PAGE_MAP_SIZE * sizeof( heapPage_t * ) );
+			}
+			leaf[( address >> HEAP_PAGE_SHIFT ) & ( HEAP_PAGE_MAP_SIZE - 1 )] = page;
 
-	if ( !p ) {
-		return 0;
+			page->next = freePages;
+			if ( freePages ) {
+				freePages->prev = page;
+			}
+			freePages = page;
+		}
+
+		chunk->numFreePages = HEAP_PAGES_PER_CHUNK;
+		chunk->next = chunks;
+		chunks = chunk;
+		numChunks++;
+		numFreePages += HEAP_PAGES_PER_CHUNK;
 	}
 
-#if USE_LIBC_MALLOC
-	#ifdef _WIN32
-		return _msize( p );
-	#else
-		return 0;
-	#endif
-#else
-	switch( ((byte *)(p))[-1] ) {
-		case SMALL_ALLOC: {
-			return SMALL_ALIGN( ((byte *)(p))[-SMALL_HEADER_SIZE] * ALIGN );
-		}
-		case MEDIUM_ALLOC: {
-			return ((mediumHeapEntry_s *)(((byte *)(p)) - ALIGN_SIZE( MEDIUM_HEADER_SIZE )))->size - ALIGN_SIZE( MEDIUM_HEADER_SIZE );
-		}
-		case LARGE_ALLOC: {
-			return ((idHeap::page_s*)(*((intptr_t *)(((byte *)p) - ALIGN_SIZE( LARGE_HEADER_SIZE )))))->dataSize - ALIGN_SIZE( LARGE_HEADER_SIZE );
-		}
-		default: {
-			idLib::common->FatalError( "idHeap::Msize: invalid memory block" );
-			return 0;
-		}
+	page = freePages;
+	freePages = page->next;
+	if ( freePages ) {
+		freePages->prev = NULL;
 	}
-#endif
+	numFreePages--;
+	page->chunk->numFreePages--;
+
+	pageLock.Unlock();
+
+	page->next = page->prev = NULL;
+	page->firstFree = NULL;
+	page->numCarved = 0;
+	page->numUsed = 0;
+	return page;
 }
 
 /*
 ================
-idHeap::Dump
+idHeap::FreePage
 
-  dump contents of the heap
+  chunks that become completely free are returned to the OS,
+  as long as there is another chunk worth of free pages
 ================
 */
-void idHeap::Dump( void ) {
-	idHeap::page_s	*pg;
+void idHeap::FreePage( heapPage_t *page ) {
+	page->sizeClass = -1;
+	page->prev = NULL;
 
-	for ( pg = smallFirstUsedPage; pg; pg = pg->next ) {
-		idLib::common->Printf( "%p  bytes %-8d  (in use by small heap)\n", pg->data, pg->dataSize);
+	pageLock.Lock();
+	page->next = freePages;
+	if ( freePages ) {
+		freePages->prev = page;
 	}
+	freePages = page;
+	numFreePages++;
 
-	if ( smallCurPage ) {
-		pg = smallCurPage;
-		idLib::common->Printf( "%p  bytes %-8d  (small heap active page)\n", pg->data, pg->dataSize );
+	if ( ++page->chunk->numFreePages == HEAP_PAGES_PER_CHUNK && numFreePages > HEAP_PAGES_PER_CHUNK ) {
+		ReleaseChunk( page->chunk );
 	}
+	pageLock.Unlock();
+}
 
-	for ( pg = mediumFirstUsedPage; pg; pg = pg->next ) {
-		idLib::common->Printf( "%p  bytes %-8d  (completely used by medium heap)\n", pg->data, pg->dataSize );
-	}
+/*
+================
+idHeap::ReleaseChunk
+
+  the page lock must be held
+================
+*/
+void idHeap::ReleaseChunk( heapChunk_t *chunk ) {
+	heapChunk_t **link;
+
+	for ( int i = 0; i < HEAP_PAGES_PER_CHUNK; i++ ) {
+		heapPage_t *page = &chunk->pages[i];
 
-	for ( pg = mediumFirstFreePage; pg; pg = pg->next ) {
-		idLib::common->Printf( "%p  bytes %-8d  (partially used by medium heap)\n", pg->data, pg->dataSize );
+		if ( page->prev ) {
+			page->prev->next = page->next;
+		} else {
+			freePages = page->next;
+		}
+		if ( page->next ) {
+			page->next->prev = page->prev;
+		}
+
+		uint64_t address = (uintptr_t) page->data;
+		pageMap[( address >> ( HEAP_PAGE_SHIFT + HEAP_PAGE_MAP_BITS ) ) & ( HEAP_PAGE_MAP_SIZE - 1 )][( address >> HEAP_PAGE_SHIFT ) & ( HEAP_PAGE_MAP_SIZE - 1 )] = NULL;
 	}
 
-	for ( pg = largeFirstUsedPage; pg; pg = pg->next ) {
-		idLib::common->Printf( "%p  bytes %-8d  (fully used by large heap)\n", pg->data, pg->dataSize );
+	for ( link = &chunks; *link != chunk; link = &(*link)->next ) {
 	}
+	*link = chunk->next;
+
+	numChunks--;
+	numFreePages -= HEAP_PAGES_PER_CHUNK;
 
-	idLib::common->Printf( "pages allocated : %d\n", pagesAllocated );
+	::free( chunk->memory );
+	::free( chunk );
 }
 
 /*
 ================
-idHeap::FreePageReal
+idHeap::FetchBlocks
 
-  frees page to be used by the OS
-  p	= page to free
+  moves a batch of blocks from the central heap to the thread cache
 ================
 */
-void idHeap::FreePageReal( idHeap::page_s *p ) {
-	assert( p );
-	::free( p );
-}
+void idHeap::FetchBlocks( heapThreadCache_t *cache, int sizeClass ) {
+	heapSizeClass_t &sc = sizeClasses[sizeClass];
+	void *list = cache->freeList[sizeClass];
+	int count = 0;
+
+	sc.lock.Lock();
+
+	while ( count < sc.batchSize ) {
+		heapPage_t *page = sc.firstPage;
+		if ( !page ) {
+			page = AllocatePage();
+			page->sizeClass = sizeClass;
+			sc.firstPage = page;
+			sc.numPages++;
+		}
 
-/*
-================
-idHeap::ReleaseSwappedPages
+		void *block;
+		if ( page->firstFree ) {
+			block = page->firstFree;
+			page->firstFree = *(void **)block;
+		} else {
+			block = page->data + page->numCarved * sc.size;
+			page->numCarved++;
+		}
 
-  releases the swap page to OS
-================
-*/
-void idHeap::ReleaseSwappedPages () {
-	if ( swapPage ) {
-		FreePageReal( swapPage );
+		// full pages are taken off the list
+		if ( ++page->numUsed == sc.blocksPerPage ) {
+			sc.firstPage = page->next;
+			if ( page->next ) {
+				page->next->prev = NULL;
+			}
+			page->next = NULL;
+		}
+
+		*(void **)block = list;
+		list = block;
+		count++;
 	}
-	swapPage = NULL;
+
+	sc.lock.Unlock();
+
+	cache->freeList[sizeClass] = list;
+	cache->numFree[sizeClass] += count;
 }
 
 /*
 ================
-idHeap::AllocatePage
+idHeap::ReleaseBlocks
 
-  allocates memory from the OS
-  bytes	= page size in bytes
-  returns pointer to page
+  moves blocks from the thread cache back to the central heap,
+  pages that become completely free are released unless they
+  are the last page of the size class with free blocks
 ================
 */
-idHeap::page_s* idHeap::AllocatePage( dword bytes ) {
-	idHeap::page_s*	p;
+void idHeap::ReleaseBlocks( heapThreadCache_t *cache, int sizeClass, int count ) {
+	heapSizeClass_t &sc = sizeClasses[sizeClass];
+	void *list = cache->freeList[sizeClass];
 
-	pageRequests++;
+	sc.lock.Lock();
 
-	if ( swapPage && swapPage->dataSize == bytes ) {			// if we've got a swap page somewhere
-		p			= swapPage;
-		swapPage	= NULL;
-	}
-	else {
-		dword size;
+	for ( int i = 0; i < count && list; i++ ) {
+		void *block = list;
+		list = *(void **)block;
 
-		size = bytes + sizeof(idHeap::page_s);
+		heapPage_t *page = FindPage( block );
+		assert( page && page->sizeClass == sizeClass );
 
-		p = (idHeap::page_s *) ::malloc( size + ALIGN - 1 );
-		if ( !p ) {
-			if ( defragBlock ) {
-				idLib::common->Printf( "Freeing defragBlock on alloc of %i.\n", size + ALIGN - 1 );
-				free( defragBlock );
-				defragBlock = NULL;
-				p = (idHeap::page_s *) ::malloc( size + ALIGN - 1 );
-				AllocDefragBlock();
+		*(void **)block = page->firstFree;
+		page->firstFree = block;
+
+		// a page that was full goes back on the list
+		if ( page->numUsed-- == sc.blocksPerPage ) {
+			page->prev = NULL;
+			page->next = sc.firstPage;
+			if ( sc.firstPage ) {
+				sc.firstPage->prev = page;
 			}
-			if ( !p ) {
-				common->FatalError( "malloc failure for %i", bytes );
+			sc.firstPage = page;
+		}
+
+		if ( page->numUsed == 0 && ( page != sc.firstPage || page->next != NULL ) ) {
+			if ( page->prev ) {
+				page->prev->next = page->next;
+			} else {
+				sc.firstPage = page->next;
 			}
+			if ( page->next ) {
+				page->next->prev = page->prev;
+			}
+			sc.numPages--;
+			FreePage( page );
 		}
 
-		p->data		= (void *) ALIGN_SIZE( (intptr_t)((byte *)(p)) + sizeof( idHeap::page_s ) );
-		p->dataSize	= size - sizeof(idHeap::page_s);
-		p->firstFree = NULL;
-		p->largestFree = 0;
-		OSAllocs++;
+		cache->numFree[sizeClass]--;
 	}
 
-	p->prev = NULL;
-	p->next = NULL;
-
-	pagesAllocated++;
+	sc.lock.Unlock();
 
-	return p;
+	cache->freeList[sizeClass] = list;
 }
 
 /*
 ================
-idHeap::FreePage
-
-  frees a page back to the operating system
-  p	= pointer to page
+idHeap::SmallAllocate
 ================
 */
-void idHeap::FreePage( idHeap::page_s *p ) {
-	assert( p );
+ID_INLINE void *idHeap::SmallAllocate( dword bytes ) {
+	heapThreadCache_t *cache = GetThreadCache();
+	int sizeClass = SizeClass( bytes );
 
-	if ( p->dataSize == pageSize && !swapPage ) {			// add to swap list?
-		swapPage = p;
-	}
-	else {
-		FreePageReal( p );
+	if ( !cache->freeList[sizeClass] ) {
+		FetchBlocks( cache, sizeClass );
 	}
 
-	pagesAllocated--;
+	void *block = cache->freeList[sizeClass];
+	cache->freeList[sizeClass] = *(void **)block;
+	cache->numFree[sizeClass]--;
+	cache->numAllocs[sizeClass]++;
+	return block;
 }
 
-//===============================================================
-//
-//	small heap code
-//
-//===============================================================
-
 /*
 ================
-idHeap::SmallAllocate
-
-  allocate memory (1-255 bytes) from the small heap manager
-  bytes = number of bytes to allocate
-  returns pointer to allocated memory
+idHeap::SmallFree
 ================
 */
-void *idHeap::SmallAllocate( dword bytes ) {
-	// we need the at least sizeof( dword ) bytes for the free list
-	if ( bytes < sizeof( intptr_t ) ) {
-		bytes = sizeof( intptr_t );
-	}
-
-	// increase the number of bytes if necessary to make sure the next small allocation is aligned
-	bytes = SMALL_ALIGN( bytes );
-
-	byte *smallBlock = (byte *)(smallFirstFree[bytes / ALIGN]);
-	if ( smallBlock ) {
-		intptr_t *link = (intptr_t *)(smallBlock + SMALL_HEADER_SIZE);
-		smallBlock[1] = SMALL_ALLOC;					// allocation identifier
-		smallFirstFree[bytes / ALIGN] = (void *)(*link);
-		return (void *)(link);
-	}
+ID_INLINE void idHeap::SmallFree( heapPage_t *page, void *ptr ) {
+	heapThreadCache_t *cache = GetThreadCache();
+	int sizeClass = page->sizeClass;
 
-	dword bytesLeft = (size_t)(pageSize) - smallCurPageOffset;
-	// if we need to allocate a new page
-	if ( bytes >= bytesLeft ) {
+	*(void **)ptr = cache->freeList[sizeClass];
+	cache->freeList[sizeClass] = ptr;
+	cache->numFrees[sizeClass]++;
 
-		smallCurPage->next	= smallFirstUsedPage;
-		smallFirstUsedPage	= smallCurPage;
-		smallCurPage		= AllocatePage( pageSize );
-		if ( !smallCurPage ) {
-			return NULL;
-		}
-		// make sure the first allocation is aligned
-		smallCurPageOffset	= SMALL_ALIGN( 0 );
+	// keep at most two batches in the cache
+	if ( ++cache->numFree[sizeClass] > 2 * sizeClasses[sizeClass].batchSize ) {
+		ReleaseBlocks( cache, sizeClass, sizeClasses[sizeClass].batchSize );
 	}
-
-	smallBlock			= ((byte *)smallCurPage->data) + smallCurPageOffset;
-	smallBlock[0]		= (byte)(bytes / ALIGN);		// write # of bytes/ALIGN
-	smallBlock[1]		= SMALL_ALLOC;					// allocation identifier
-	smallCurPageOffset  += bytes + SMALL_HEADER_SIZE;	// increase the offset on the current page
-	return ( smallBlock + SMALL_HEADER_SIZE );			// skip the first two bytes
 }
 
 /*
 ================
-idHeap::SmallFree
-
-  frees a block of memory allocated by SmallAllocate() call
-  data = pointer to block of memory
+idHeap::LargeAllocate
 ================
 */
-void idHeap::SmallFree( void *ptr ) {
-	((byte *)(ptr))[-1] = INVALID_ALLOC;
+void *idHeap::LargeAllocate( dword bytes ) {
+	byte *memory = (byte *) SystemAlloc( bytes + LARGE_HEADER_SIZE + HEAP_ALIGN - 1 );
+	byte *ptr = (byte *) ALIGN_SIZE( (intptr_t)( memory + LARGE_HEADER_SIZE ) );
+	heapLargeHeader_t *header = (heapLargeHeader_t *)( ptr - LARGE_HEADER_SIZE );
 
-	byte *d = ( (byte *)ptr ) - SMALL_HEADER_SIZE;
-	intptr_t *link = (intptr_t *)ptr;
-	// index into the table with free small memory blocks
-	dword ix = *d;
+	header->memory = memory;
+	header->size = bytes;
+	header->magic = HEAP_LARGE_MAGIC;
 
-	// check if the index is correct
-	if ( ix > (256 / ALIGN) ) {
-		idLib::common->FatalError( "SmallFree: invalid memory block" );
-	}
+	GetThreadCache()->numLargeAllocs++;
 
-	*link = (intptr_t)smallFirstFree[ix];	// write next index
-	smallFirstFree[ix] = (void *)d;		// link
+	return ptr;
 }
 
-//===============================================================
-//
-//	medium heap code
-//
-//	Medium-heap allocated pages not returned to OS until heap destructor
-//	called (re-used instead on subsequent medium-size malloc requests).
-//
-//===============================================================
-
 /*
 ================
-idHeap::MediumAllocateFromPage
-
-  performs allocation using the medium heap manager from a given page
-  p				= page
-  sizeNeeded	= # of bytes needed
-  returns pointer to allocated memory
+idHeap::LargeFree
 ================
 */
-void *idHeap::MediumAllocateFromPage( idHeap::page_s *p, dword sizeNeeded ) {
-
-	mediumHeapEntry_s	*best,*nw = NULL;
-	byte				*ret;
-
-	best = (mediumHeapEntry_s *)(p->firstFree);			// first block is largest
-
-	assert( best );
-	assert( best->size == p->largestFree );
-	assert( best->size >= sizeNeeded );
-
-	// if we can allocate another block from this page after allocating sizeNeeded bytes
-	if ( best->size >= (dword)( sizeNeeded + MEDIUM_SMALLEST_SIZE ) ) {
-		nw = (mediumHeapEntry_s *)((byte *)best + best->size - sizeNeeded);
-		nw->page		= p;
-		nw->prev		= best;
-		nw->next		= best->next;
-		nw->prevFree	= NULL;
-		nw->nextFree	= NULL;
-		nw->size		= sizeNeeded;
-		nw->freeBlock	= 0;			// used block
-		if ( best->next ) {
-			best->next->prev = nw;
-		}
-		best->next	= nw;
-		best->size	-= sizeNeeded;
+void idHeap::LargeFree( void *ptr ) {
+	heapLargeHeader_t *header = (heapLargeHeader_t *)( (byte *)ptr - LARGE_HEADER_SIZE );
 
-		p->largestFree = best->size;
+	if ( header->magic != HEAP_LARGE_MAGIC ) {
+		idLib::common->FatalError( "idHeap::Free: invalid memory block" );
 	}
-	else {
-		if ( best->prevFree ) {
-			best->prevFree->nextFree = best->nextFree;
-		}
-		else {
-			p->firstFree = (void *)best->nextFree;
-		}
-		if ( best->nextFree ) {
-			best->nextFree->prevFree = best->prevFree;
-		}
-
-		best->prevFree  = NULL;
-		best->nextFree  = NULL;
-		best->freeBlock = 0;			// used block
-		nw = best;
+	header->magic = 0;
 
-		p->largestFree = 0;
-	}
-
-	ret		= (byte *)(nw) + ALIGN_SIZE( MEDIUM_HEADER_SIZE );
-	ret[-1] = MEDIUM_ALLOC;		// allocation identifier
+	GetThreadCache()->numLargeFrees++;
 
-	return (void *)(ret);
+	::free( header->memory );
 }
 
 /*
 ================
-idHeap::MediumAllocate
-
-  allocate memory (256-32768 bytes) from medium heap manager
-  bytes	= number of bytes to allocate
-  returns pointer to allocated memory
+idHeap::Allocate
 ================
 */
-void *idHeap::MediumAllocate( dword bytes ) {
-	idHeap::page_s		*p;
-	void				*data;
-
-	dword sizeNeeded = ALIGN_SIZE( bytes ) + ALIGN_SIZE( MEDIUM_HEADER_SIZE );
-
-	// find first page with enough space
-	for ( p = mediumFirstFreePage; p; p = p->next ) {
-		if ( p->largestFree >= sizeNeeded ) {
-			break;
-		}
+void *idHeap::Allocate( const dword bytes ) {
+	if ( !bytes ) {
+		return NULL;
 	}
 
-	if ( !p ) {								// need to allocate new page?
-		p = AllocatePage( pageSize );
-		if ( !p ) {
-			return NULL;					// malloc failure!
-		}
-		p->prev		= NULL;
-		p->next		= mediumFirstFreePage;
-		if (p->next) {
-			p->next->prev = p;
-		}
-		else {
-			mediumLastFreePage	= p;
-		}
-
-		mediumFirstFreePage		= p;
-
-		p->largestFree	= pageSize;
-		p->firstFree	= (void *)p->data;
-
-		mediumHeapEntry_s *e;
-		e				= (mediumHeapEntry_s *)(p->firstFree);
-		e->page			= p;
-		// make sure ((byte *)e + e->size) is aligned
-		e->size			= pageSize & ~(ALIGN - 1);
-		e->prev			= NULL;
-		e->next			= NULL;
-		e->prevFree		= NULL;
-		e->nextFree		= NULL;
-		e->freeBlock	= 1;
+#if USE_LIBC_MALLOC
+	return malloc( bytes );
+#else
+	if ( bytes <= HEAP_MAX_SMALL_SIZE ) {
+		return SmallAllocate( bytes );
 	}
+	return LargeAllocate( bytes );
+#endif
+}
 
-	data = MediumAllocateFromPage( p, sizeNeeded );		// allocate data from page
-
-	// if the page can no longer serve memory, move it away from free list
-	// (so that it won't slow down the later alloc queries)
-	// this modification speeds up the pageWalk from O(N) to O(sqrt(N))
-	// a call to free may swap this page back to the free list
-
-	if ( p->largestFree < MEDIUM_SMALLEST_SIZE ) {
-		if ( p == mediumLastFreePage ) {
-			mediumLastFreePage = p->prev;
-		}
-
-		if ( p == mediumFirstFreePage ) {
-			mediumFirstFreePage = p->next;
-		}
-
-		if ( p->prev ) {
-			p->prev->next = p->next;
-		}
-		if ( p->next ) {
-			p->next->prev = p->prev;
-		}
-
-		// link to "completely used" list
-		p->prev = NULL;
-		p->next = mediumFirstUsedPage;
-		if ( p->next ) {
-			p->next->prev = p;
-		}
-		mediumFirstUsedPage = p;
-		return data;
+/*
+================
+idHeap::Free
+================
+*/
+void idHeap::Free( void *p ) {
+	if ( !p ) {
+		return;
 	}
 
-	// re-order linked list (so that next malloc query starts from current
-	// matching block) -- this speeds up both the page walks and block walks
-
-	if ( p != mediumFirstFreePage ) {
-		assert( mediumLastFreePage );
-		assert( mediumFirstFreePage );
-		assert( p->prev);
-
-		mediumLastFreePage->next	= mediumFirstFreePage;
-		mediumFirstFreePage->prev	= mediumLastFreePage;
-		mediumLastFreePage			= p->prev;
-		p->prev->next				= NULL;
-		p->prev						= NULL;
-		mediumFirstFreePage			= p;
+#if USE_LIBC_MALLOC
+	free( p );
+#else
+	heapPage_t *page = FindPage( p );
+	if ( page ) {
+		SmallFree( page, p );
+	} else {
+		LargeFree( p );
 	}
-
-	return data;
+#endif
 }
 
 /*
 ================
-idHeap::MediumFree
+idHeap::Allocate16
 
-  frees a block allocated by the medium heap manager
-  ptr	= pointer to data block
+  all heap blocks are 16 byte aligned already
 ================
 */
-void idHeap::MediumFree( void *ptr ) {
-	((byte *)(ptr))[-1] = INVALID_ALLOC;
-
-	mediumHeapEntry_s	*e = (mediumHeapEntry_s *)((byte *)ptr - ALIGN_SIZE( MEDIUM_HEADER_SIZE ));
-	idHeap::page_s		*p = e->page;
-	bool				isInFreeList;
-
-	isInFreeList = p->largestFree >= MEDIUM_SMALLEST_SIZE;
-
-	assert( e->size );
-	assert( e->freeBlock == 0 );
-
-	mediumHeapEntry_s *prev = e->prev;
-
-	// if the previous block is free we can merge
-	if ( prev && prev->freeBlock ) {
-		prev->size += e->size;
-		prev->next = e->next;
-		if ( e->next ) {
-			e->next->prev = prev;
-		}
-		e = prev;
-	}
-	else {
-		e->prevFree		= NULL;				// link to beginning of free list
-		e->nextFree		= (mediumHeapEntry_s *)p->firstFree;
-		if ( e->nextFree ) {
-			assert( !(e->nextFree->prevFree) );
-			e->nextFree->prevFree = e;
-		}
-
-		p->firstFree	= e;
-		p->largestFree	= e->size;
-		e->freeBlock	= 1;				// mark block as free
-	}
-
-	mediumHeapEntry_s *next = e->next;
+void *idHeap::Allocate16( const dword bytes ) {
+#if USE_LIBC_MALLOC
+	return LargeAllocate( bytes );
+#else
+	return Allocate( bytes );
+#endif
+}
 
-	// if the next block is free we can merge
-	if ( next && next->freeBlock ) {
-		e->size += next->size;
-		e->next = next->next;
+/*
+================
+idHeap::Free16
+================
+*/
+void idHeap::Free16( void *p ) {
+#if USE_LIBC_MALLOC
+	LargeFree( p );
+#else
+	Free( p );
+#endif
+}
 
-		if ( next->next ) {
-			next->next->prev = e;
-		}
+/*
+================
+idHeap::Msize
 
-		if ( next->prevFree ) {
-			next->prevFree->nextFree = next->nextFree;
-		}
-		else {
-			assert( next == p->firstFree );
-			p->firstFree = next->nextFree;
-		}
+  returns size of allocated memory block
+  p	= pointer to memory block
+  Notes:	size may not be the same as the size in the original
+			allocation request (due to block alignment reasons).
+================
+*/
+dword idHeap::Msize( void *p ) {
 
-		if ( next->nextFree ) {
-			next->nextFree->prevFree = next->prevFree;
-		}
+	if ( !p ) {
+		return 0;
 	}
 
-	if ( p->firstFree ) {
-		p->largestFree = ((mediumHeapEntry_s *)(p->firstFree))->size;
+#if USE_LIBC_MALLOC
+	#ifdef _WIN32
+		return _msize( p );
+	#else
+		return 0;
+	#endif
+#else
+	heapPage_t *page = FindPage( p );
+	if ( page ) {
+		return sizeClasses[page->sizeClass].size;
 	}
-	else {
-		p->largestFree = 0;
+	heapLargeHeader_t *header = (heapLargeHeader_t *)( (byte *)p - LARGE_HEADER_SIZE );
+	if ( header->magic != HEAP_LARGE_MAGIC ) {
+		idLib::common->FatalError( "idHeap::Msize: invalid memory block" );
 	}
+	return header->size;
+#endif
+}
 
-	// did e become the largest block of the page ?
-
-	if ( e->size > p->largestFree ) {
-		assert( e != p->firstFree );
-		p->largestFree = e->size;
-
-		if ( e->prevFree ) {
-			e->prevFree->nextFree = e->nextFree;
-		}
-		if ( e->nextFree ) {
-			e->nextFree->prevFree = e->prevFree;
-		}
-
-		e->nextFree = (mediumHeapEntry_s *)p->firstFree;
-		e->prevFree = NULL;
-		if ( e->nextFree ) {
-			e->nextFree->prevFree = e;
-		}
-		p->firstFree = e;
-	}
-
-	// if page wasn't in free list (because it was near-full), move it back there
-	if ( !isInFreeList ) {
-
-		// remove from "completely used" list
-		if ( p->prev ) {
-			p->prev->next = p->next;
-		}
-		if ( p->next ) {
-			p->next->prev = p->prev;
-		}
-		if ( p == mediumFirstUsedPage ) {
-			mediumFirstUsedPage = p->next;
-		}
+/*
+================
+idHeap::GetStats
 
-		p->next = NULL;
-		p->prev = mediumLastFreePage;
+  the counters of the thread caches are read without locking,
+  the result is only approximate while other threads allocate
+================
+*/
+void idHeap::GetStats( memoryStats_t &stats ) {
+	stats.num = 0;
+	stats.minSize = 0x0fffffff;
+	stats.maxSize = -1;
+	stats.totalSize = 0;
+
+	cacheLock.Lock();
+	for ( heapThreadCache_t *cache = threadCaches; cache; cache = cache->next ) {
+		stats.num += cache->totalAllocs.num;
+		stats.minSize = Min( stats.minSize, cache->totalAllocs.minSize );
+		stats.maxSize = Max( stats.maxSize, cache->totalAllocs.maxSize );
+		stats.totalSize += cache->totalAllocs.totalSize;
+	}
+	cacheLock.Unlock();
+}
 
-		if ( mediumLastFreePage ) {
-			mediumLastFreePage->next = p;
-		}
-		mediumLastFreePage = p;
-		if ( !mediumFirstFreePage ) {
-			mediumFirstFreePage = p;
+/*
+================
+idHeap::GetFrameStats
+================
+*/
+void idHeap::GetFrameStats( memoryStats_t &allocs, memoryStats_t &frees ) {
+	memoryStats_t *sum[2] = { &allocs, &frees };
+
+	for ( int i = 0; i < 2; i++ ) {
+		sum[i]->num = 0;
+		sum[i]->minSize = 0x0fffffff;
+		sum[i]->maxSize = -1;
+		sum[i]->totalSize = 0;
+	}
+
+	cacheLock.Lock();
+	for ( heapThreadCache_t *cache = threadCaches; cache; cache = cache->next ) {
+		const memoryStats_t *stats[2] = { &cache->frameAllocs, &cache->frameFrees };
+		for ( int i = 0; i < 2; i++ ) {
+			sum[i]->num += stats[i]->num;
+			sum[i]->minSize = Min( sum[i]->minSize, stats[i]->minSize );
+			sum[i]->maxSize = Max( sum[i]->maxSize, stats[i]->maxSize );
+			sum[i]->totalSize += stats[i]->totalSize;
 		}
 	}
+	cacheLock.Unlock();
 }
 
-//===============================================================
-//
-//	large heap code
-//
-//===============================================================
+/*
+================
+idHeap::ClearFrameStats
+================
+*/
+void idHeap::ClearFrameStats( void ) {
+	cacheLock.Lock();
+	for ( heapThreadCache_t *cache = threadCaches; cache; cache = cache->next ) {
+		cache->frameAllocs.num = cache->frameFrees.num = 0;
+		cache->frameAllocs.minSize = cache->frameFrees.minSize = 0x0fffffff;
+		cache->frameAllocs.maxSize = cache->frameFrees.maxSize = -1;
+		cache->frameAllocs.totalSize = cache->frameFrees.totalSize = 0;
+	}
+	cacheLock.Unlock();
+}
 
 /*
 ================
-idHeap::LargeAllocate
+idHeap::GetSizeClassStats
 
-  allocates a block of memory from the operating system
-  bytes	= number of bytes to allocate
-  returns pointer to allocated memory
+  the last entry are the allocations too large for a size class
 ================
 */
-void *idHeap::LargeAllocate( dword bytes ) {
-	idHeap::page_s *p = AllocatePage( bytes + ALIGN_SIZE( LARGE_HEADER_SIZE ) );
+int idHeap::GetSizeClassStats( memorySizeClassStats_t *stats, int maxStats ) {
+	int i, num;
 
-	assert( p );
+	num = Min( maxStats, HEAP_NUM_SIZE_CLASSES + 1 );
+	memset( stats, 0, num * sizeof( stats[0] ) );
 
-	if ( !p ) {
-		return NULL;
+	for ( i = 0; i < num && i < HEAP_NUM_SIZE_CLASSES; i++ ) {
+		stats[i].size = sizeClasses[i].size;
+		stats[i].numPages = sizeClasses[i].numPages;
+	}
+	if ( i < num ) {
+		stats[i].size = -1;
 	}
 
-	byte *	d	= (byte*)(p->data) + ALIGN_SIZE( LARGE_HEADER_SIZE );
-	intptr_t * dw	= (intptr_t*)(d - ALIGN_SIZE( LARGE_HEADER_SIZE ));
-	dw[0]		= (intptr_t)p;			// write pointer back to page table
-	d[-1]		= LARGE_ALLOC;			// allocation identifier
+	cacheLock.Lock();
+	for ( heapThreadCache_t *cache = threadCaches; cache; cache = cache->next ) {
+		for ( i = 0; i < num && i < HEAP_NUM_SIZE_CLASSES; i++ ) {
+			stats[i].numAllocs += cache->numAllocs[i];
+			stats[i].numFrees += cache->numFrees[i];
+			stats[i].numCached += cache->numFree[i];
+		}
+		if ( i < num ) {
+			stats[i].numAllocs += cache->numLargeAllocs;
+			stats[i].numFrees += cache->numLargeFrees;
+		}
+	}
+	cacheLock.Unlock();
 
-	// link to 'large used page list'
-	p->prev = NULL;
-	p->next = largeFirstUsedPage;
-	if ( p->next ) {
-		p->next->prev = p;
+	for ( i = 0; i < num; i++ ) {
+		stats[i].numInUse = (int)( stats[i].numAllocs - stats[i].numFrees );
 	}
-	largeFirstUsedPage = p;
 
-	return (void *)(d);
+	return num;
 }
 
 /*
 ================
-idHeap::LargeFree
+idHeap::Dump
 
-  frees a block of memory allocated by the 'large memory allocator'
-  p	= pointer to allocated memory
+  dump contents of the heap
 ================
 */
-void idHeap::LargeFree( void *ptr) {
-	idHeap::page_s*	pg;
-
-	((byte *)(ptr))[-1] = INVALID_ALLOC;
+void idHeap::Dump( void ) {
+	memorySizeClassStats_t stats[HEAP_NUM_SIZE_CLASSES + 1];
+	int i, num, numThreads;
 
-	// get page pointer
-	pg = (idHeap::page_s *)(*((intptr_t *)(((byte *)ptr) - ALIGN_SIZE( LARGE_HEADER_SIZE ))));
+	num = GetSizeClassStats( stats, HEAP_NUM_SIZE_CLASSES + 1 );
 
-	// unlink from doubly linked list
-	if ( pg->prev ) {
-		pg->prev->next = pg->next;
-	}
-	if ( pg->next ) {
-		pg->next->prev = pg->prev;
+	idLib::common->Printf( " size   pages    in use    cached      allocs       frees\n" );
+	for ( i = 0; i < num; i++ ) {
+		if ( !stats[i].numAllocs ) {
+			continue;
+		}
+		if ( stats[i].size < 0 ) {
+			idLib::common->Printf( "large       - %9d         - %11u %11u\n", stats[i].numInUse, stats[i].numAllocs, stats[i].numFrees );
+		} else {
+			idLib::common->Printf( "%5d %7d %9d %9d %11u %11u\n", stats[i].size, stats[i].numPages,
+					stats[i].numInUse, stats[i].numCached, stats[i].numAllocs, stats[i].numFrees );
+		}
 	}
-	if ( pg == largeFirstUsedPage ) {
-		largeFirstUsedPage = pg->next;
+
+	cacheLock.Lock();
+	numThreads = 0;
+	for ( heapThreadCache_t *cache = threadCaches; cache; cache = cache->next ) {
+		numThreads++;
 	}
-	pg->next = pg->prev = NULL;
+	cacheLock.Unlock();
 
-	FreePage(pg);
+	idLib::common->Printf( "%d chunks, %d kB, %d free pages, %d thread caches\n",
+			numChunks, numChunks * HEAP_PAGES_PER_CHUNK * HEAP_PAGE_SIZE >> 10, numFreePages, numThreads );
 }
 
 //===============================================================
@@ -986,9 +995,6 @@ void idHeap::LargeFree( void *ptr) {
 #undef new
 
 static idHeap *			mem_heap = NULL;
-static memoryStats_t	mem_total_allocs = { 0, 0x0fffffff, -1, 0 };
-static memoryStats_t	mem_frame_allocs;
-static memoryStats_t	mem_frame_frees;
 
 /*
 ==================
@@ -996,10 +1002,9 @@ Mem_ClearFrameStats
 ==================
 */
 void Mem_ClearFrameStats( void ) {
-	mem_frame_allocs.num = mem_frame_frees.num = 0;
-	mem_frame_allocs.minSize = mem_frame_frees.minSize = 0x0fffffff;
-	mem_frame_allocs.maxSize = mem_frame_frees.maxSize = -1;
-	mem_frame_allocs.totalSize = mem_frame_frees.totalSize = 0;
+	if ( mem_heap ) {
+		mem_heap->ClearFrameStats();
+	}
 }
 
 /*
@@ -1008,8 +1013,12 @@ Mem_GetFrameStats
 ==================
 */
 void Mem_GetFrameStats( memoryStats_t &allocs, memoryStats_t &frees ) {
-	allocs = mem_frame_allocs;
-	frees = mem_frame_frees;
+	if ( !mem_heap ) {
+		memset( &allocs, 0, sizeof( allocs ) );
+		memset( &frees, 0, sizeof( frees ) );
+		return;
+	}
+	mem_heap->GetFrameStats( allocs, frees );
 }
 
 /*
@@ -1018,7 +1027,26 @@ Mem_GetStats
 ==================
 */
 void Mem_GetStats( memoryStats_t &stats ) {
-	stats = mem_total_allocs;
+	if ( !mem_heap ) {
+		memset( &stats, 0, sizeof( stats ) );
+		return;
+	}
+	mem_heap->GetStats( stats );
+}
+
+/*
+==================
+Mem_GetSizeClassStats
+
+  fills in the counters of each size class of the heap,
+  returns the number of entries written
+==================
+*/
+int Mem_GetSizeClassStats( memorySizeClassStats_t *stats, int maxStats ) {
+	if ( !mem_heap ) {
+		return 0;
+	}
+	return mem_heap->GetSizeClassStats( stats, maxStats );
 }
 
 /*
@@ -1040,11 +1068,14 @@ void Mem_UpdateStats( memoryStats_t &stats, int size ) {
 /*
 ==================
 Mem_UpdateAllocStats
+
+  the statistics are kept per thread
 ==================
 */
 void Mem_UpdateAllocStats( int size ) {
-	Mem_UpdateStats( mem_frame_allocs, size );
-	Mem_UpdateStats( mem_total_allocs, size );
+	heapThreadCache_t *cache = mem_heap->GetThreadCache();
+	Mem_UpdateStats( cache->frameAllocs, size );
+	Mem_UpdateStats( cache->totalAllocs, size );
 }
 
 /*
@@ -1053,9 +1084,139 @@ Mem_UpdateFreeStats
 ==================
 */
 void Mem_UpdateFreeStats( int size ) {
-	Mem_UpdateStats( mem_frame_frees, size );
-	mem_total_allocs.num--;
-	mem_total_allocs.totalSize -= size;
+	heapThreadCache_t *cache = mem_heap->GetThreadCache();
+	Mem_UpdateStats( cache->frameFrees, size );
+	cache->totalAllocs.num--;
+	cache->totalAllocs.totalSize -= size;
+}
+
+/*
+==================
+Mem_Benchmark
+
+  replays the size distribution of the allocations made so far,
+  so running it after a map load compares the allocators on the
+  allocations of that map
+==================
+*/
+#define MEM_BENCHMARK_SLOTS		4096
+
+typedef struct {
+	bool				useLibc;
+	int					numOps;
+	int					seed;
+	const unsigned int *weights;			// cumulative weight of each size class
+	const int *			sizes;
+	int					numSizes;
+	xthreadInfo			thread;
+} memBenchmark_t;
+
+static int Mem_BenchmarkThread( void *data ) {
+	memBenchmark_t *bench = (memBenchmark_t *)data;
+	void *slots[MEM_BENCHMARK_SLOTS];
+	unsigned int totalWeight = bench->weights[bench->numSizes - 1];
+	idRandom random( bench->seed );
+
+	memset( slots, 0, sizeof( slots ) );
+
+	for ( int i = 0; i < bench->numOps; i++ ) {
+		int slot = random.RandomInt( MEM_BENCHMARK_SLOTS );
+		if ( slots[slot] ) {
+			if ( bench->useLibc ) {
+				free( slots[slot] );
+			} else {
+				Mem_Free( slots[slot] );
+			}
+			slots[slot] = NULL;
+			continue;
+		}
+
+		// pick a size class by its weight and a size inside the class
+		unsigned int w = (unsigned int)( random.RandomFloat() * totalWeight );
+		int c;
+		for ( c = 0; c < bench->numSizes - 1 && w >= bench->weights[c]; c++ ) {
+		}
+		int minSize = c > 0 ? bench->sizes[c-1] + 1 : 1;
+		int size = minSize + random.RandomInt( bench->sizes[c] - minSize + 1 );
+
+		slots[slot] = bench->useLibc ? malloc( size ) : Mem_Alloc( size );
+		*(byte *)slots[slot] = 0;
+	}
+
+	for ( int i = 0; i < MEM_BENCHMARK_SLOTS; i++ ) {
+		if ( bench->useLibc ) {
+			free( slots[i] );
+		} else {
+			Mem_Free( slots[i] );
+		}
+	}
+	return 0;
+}
+
+static int Mem_BenchmarkRun( memBenchmark_t *benches, int numThreads ) {
+	int start = Sys_Milliseconds();
+	if ( numThreads == 1 ) {
+		Mem_BenchmarkThread( &benches[0] );
+	} else {
+		for ( int i = 0; i < numThreads; i++ ) {
+			Sys_CreateThread( Mem_BenchmarkThread, &benches[i], benches[i].thread, "memBenchmark" );
+		}
+		for ( int i = 0; i < numThreads; i++ ) {
+			Sys_DestroyThread( benches[i].thread );
+		}
+	}
+	return Sys_Milliseconds() - start;
+}
+
+void Mem_Benchmark_f( const idCmdArgs &args ) {
+	memorySizeClassStats_t stats[64];
+	unsigned int weights[64];
+	int sizes[64];
+	memBenchmark_t benches[16];
+	int i, num, numSizes, numThreads, numOps;
+
+	numThreads = ( args.Argc() > 1 ) ? idMath::ClampInt( 1, 16, atoi( args.Argv( 1 ) ) ) : 1;
+	numOps = ( args.Argc() > 2 ) ? Max( 1, atoi( args.Argv( 2 ) ) ) : 4000000;
+
+	// large allocations are left out, they are passed on to malloc anyway
+	num = Mem_GetSizeClassStats( stats, 64 );
+	numSizes = 0;
+	unsigned int total = 0;
+	for ( i = 0; i < num; i++ ) {
+		if ( stats[i].size < 0 ) {
+			continue;
+		}
+		total += stats[i].numAllocs;
+		weights[numSizes] = total;
+		sizes[numSizes] = stats[i].size;
+		numSizes++;
+	}
+	if ( total == 0 ) {
+		// no statistics, use a spread of small sizes
+		numSizes = 0;
+		for ( int size = 16; size <= 1024; size *= 2 ) {
+			sizes[numSizes] = size;
+			weights[numSizes] = numSizes + 1;
+			numSizes++;
+		}
+	}
+
+	for ( i = 0; i < numThreads; i++ ) {
+		benches[i].numOps = numOps / numThreads;
+		benches[i].seed = i;
+		benches[i].weights = weights;
+		benches[i].sizes = sizes;
+		benches[i].numSizes = numSizes;
+	}
+
+	idLib::common->Printf( "%d allocations and frees on %d thread(s)%s\n", numOps, numThreads, total ? "" : ", no size statistics" );
+	for ( int pass = 0; pass < 2; pass++ ) {
+		for ( i = 0; i < numThreads; i++ ) {
+			benches[i].useLibc = ( pass == 1 );
+		}
+		int msec = Mem_BenchmarkRun( benches, numThreads );
+		idLib::common->Printf( "%s: %5d msec\n", pass == 0 ? "Mem_Alloc" : "   malloc", msec );
+	}
 }
 
 
@@ -1182,6 +1343,7 @@ Mem_Dump_f
 ==================
 */
 void Mem_Dump_f( const idCmdArgs &args ) {
+	mem_heap->Dump();
 }
 
 /*
@@ -38,8 +38,9 @@ If you have questions concerning this license or the applicable additional terms
 	Memory Management
 
 	This is a replacement for the compiler heap code (i.e. "C" malloc() and
-	free() calls). On average 2.5-3.0 times faster than MSVC malloc()/free().
-	Worst case performance is 1.65 times faster and best case > 70 times.
+	free() calls). Small allocations are served from per thread caches of
+	size classes backed by a central page heap, so Mem_Alloc and Mem_Free
+	can be used from any thread. All memory is 16 byte aligned.
 
 ===============================================================================
 */
@@ -52,6 +53,15 @@ typedef struct {
 	int		totalSize;
 } memoryStats_t;
 
+typedef struct {
+	int				size;			// -1 for allocations larger than any size class
+	int				numPages;		// 64 kB pages used by the size class
+	int				numInUse;
+	int				numCached;		// free blocks in the thread caches
+	unsigned int	numAllocs;
+	unsigned int	numFrees;
+} memorySizeClassStats_t;
+
 
 void		Mem_Init( void );
 void		Mem_Shutdown( void );
@@ -59,8 +69,10 @@ void		Mem_EnableLeakTest( const char *name );
 void		Mem_ClearFrameStats( void );
 void		Mem_GetFrameStats( memoryStats_t &allocs, memoryStats_t &frees );
 void		Mem_GetStats( memoryStats_t &stats );
+int			Mem_GetSizeClassStats( memorySizeClassStats_t *stats, int maxStats );
 void		Mem_Dump_f( const class idCmdArgs &args );
 void		Mem_DumpCompressed_f( const class idCmdArgs &args );
+void		Mem_Benchmark_f( const class idCmdArgs &args );
 void		Mem_AllocDefragBlock( void );
 
 
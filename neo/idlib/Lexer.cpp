@@ -246,6 +246,8 @@ void idLexer::Warning( const char *str, ... ) {
 	char text[MAX_STRING_CHARS];
 	va_list ap;
 
+	hadWarning = true;
+
 	if ( idLexer::flags & LEXFL_NOWARNINGS ) {
 		return;
 	}
@@ -1717,6 +1719,7 @@ idLexer::idLexer( void ) {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::hadWarning = false;
 }
 
 /*
@@ -1738,6 +1741,7 @@ idLexer::idLexer( int flags ) {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::hadWarning = false;
 }
 
 /*
@@ -1753,6 +1757,7 @@ idLexer::idLexer( const char *filename, int flags, bool OSPath ) {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::hadWarning = false;
 	idLexer::LoadFile( filename, OSPath );
 }
 
@@ -1769,6 +1774,7 @@ idLexer::idLexer( const char *ptr, int length, const char *name, int flags ) {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::hadWarning = false;
 	idLexer::LoadMemory( ptr, length, name );
 }
 
@@ -1798,3 +1804,12 @@ idLexer::HadError
 bool idLexer::HadError( void ) const {
 	return hadError;
 }
+
+/*
+================
+idLexer::HadWarning
+================
+*/
+bool idLexer::HadWarning( void ) const {
+	return hadWarning;
+}
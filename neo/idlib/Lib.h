@@ -37,7 +37,7 @@ If you have questions concerning this license or the applicable additional terms
 	read-only after initialization (they do not maintain a modifiable state).
 
 	The interface pointers idSys, idCommon, idCVarSystem and idFileSystem
-	should be set before using idLib. The pointers stored here should not
+	should be set before using idLib. idProfiler is optional. The pointers stored here should not
 	be used by any part of the engine except for idLib.
 
 	The frameNumber should be continuously set to the number of the current
@@ -50,6 +50,7 @@ class idSys;
 class idCommon;
 class idCVarSystem;
 class idFileSystem;
+class idProfiler;
 
 class idLib {
 public:
@@ -57,6 +58,7 @@ public:
 	static class idCommon *		common;
 	static class idCVarSystem *	cvarSystem;
 	static class idFileSystem *	fileSystem;
+	static class idProfiler *	profiler;
 	static int					frameNumber;
 
 	static void					Init( void );
@@ -0,0 +1,387 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#if defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+#include <intrin.h>
+#elif defined( __GNUC__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+#include <x86intrin.h>
+#endif
+
+#include "sys/platform.h"
+#include "idlib/Str.h"
+#include "framework/Common.h"
+#include "framework/FileSystem.h"
+
+#include "idlib/Profiler.h"
+
+const int PROFILE_MAX_THREADS		= MAX_THREADS + 1;		// the main thread isn't in the thread table
+const int PROFILE_ZONES_PER_THREAD	= 1 << 15;				// must be a power of two
+const int PROFILE_MAX_FRAMES		= 256;					// must be a power of two
+
+typedef struct {
+	const char *	name;
+	double			start;
+	double			end;
+} profileZone_t;
+
+typedef struct {
+	char			name[32];
+	profileZone_t *	zones;					// ring buffer of PROFILE_ZONES_PER_THREAD zones
+	volatile int	numZones;				// zones written since recording started
+} profileThread_t;
+
+/*
+================
+Prof_GetClockTicks
+================
+*/
+static ID_INLINE double Prof_GetClockTicks( void ) {
+#if ( defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) ) ) || ( defined( __GNUC__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) ) )
+	return (double)__rdtsc();
+#else
+	return Sys_Microseconds();
+#endif
+}
+
+class idProfilerLocal : public idProfiler {
+public:
+							idProfilerLocal( void );
+
+	virtual void			Init( void );
+	virtual void			Shutdown( void );
+	virtual void			BeginFrame( void );
+	virtual void			SetRecording( bool record );
+	virtual void			WriteTrace( int numWrite, const char *fileName );
+	virtual double			BeginZone( void );
+	virtual void			EndZone( const char *name, double startTicks );
+
+private:
+	profileThread_t			threads[PROFILE_MAX_THREADS];
+	int						numThreads;
+
+	double					frameStart[PROFILE_MAX_FRAMES];
+	int						frameNumber[PROFILE_MAX_FRAMES];
+	int						numFrames;				// frames started since recording started
+
+	// calibration of the clock ticks
+	double					baseTicks;
+	double					baseUsec;
+
+	// recording started by WriteTrace
+	int						captureFrames;
+	idStr					captureFileName;
+	bool					captureStopRecording;
+
+	profileThread_t *		GetThread( void );
+	void					Write( int numWrite, const char *fileName );
+};
+
+static ID_THREAD_LOCAL int	profileThreadNum;		// 0 = not set yet, -1 = no free thread slot
+
+static idProfilerLocal		profilerLocal;
+idProfiler *				profiler = &profilerLocal;
+
+/*
+================
+idProfilerLocal::idProfilerLocal
+================
+*/
+idProfilerLocal::idProfilerLocal( void ) {
+	recording = false;
+	memset( threads, 0, sizeof( threads ) );
+	numThreads = 0;
+	numFrames = 0;
+	baseTicks = 0.0;
+	baseUsec = 0.0;
+	captureFrames = 0;
+	captureStopRecording = false;
+}
+
+/*
+================
+idProfilerLocal::Init
+================
+*/
+void idProfilerLocal::Init( void ) {
+	baseTicks = Prof_GetClockTicks();
+	baseUsec = Sys_Microseconds();
+}
+
+/*
+================
+idProfilerLocal::Shutdown
+================
+*/
+void idProfilerLocal::Shutdown( void ) {
+	recording = false;
+	captureFrames = 0;
+
+	for ( int i = 0; i < numThreads; i++ ) {
+		delete[] threads[i].zones;
+		threads[i].zones = NULL;
+		threads[i].numZones = 0;
+	}
+}
+
+/*
+================
+idProfilerLocal::SetRecording
+================
+*/
+void idProfilerLocal::SetRecording( bool record ) {
+	if ( record == recording ) {
+		return;
+	}
+	if ( record ) {
+		// only zones of this recording end up in the trace
+		for ( int i = 0; i < numThreads; i++ ) {
+			threads[i].numZones = 0;
+		}
+		numFrames = 0;
+	} else {
+		captureFrames = 0;
+	}
+	captureStopRecording = false;
+	recording = record;
+}
+
+/*
+================
+idProfilerLocal::BeginFrame
+================
+*/
+void idProfilerLocal::BeginFrame( void ) {
+	if ( !recording ) {
+		return;
+	}
+
+	if ( captureFrames > 0 && numFrames > captureFrames ) {
+		bool stop = captureStopRecording;
+		Write( captureFrames, captureFileName );
+		captureFrames = 0;
+		if ( stop ) {
+			SetRecording( false );
+			return;
+		}
+	}
+
+	frameStart[numFrames & ( PROFILE_MAX_FRAMES - 1 )] = Prof_GetClockTicks();
+	frameNumber[numFrames & ( PROFILE_MAX_FRAMES - 1 )] = idLib::frameNumber;
+	numFrames++;
+}
+
+/*
+================
+idProfilerLocal::WriteTrace
+================
+*/
+void idProfilerLocal::WriteTrace( int numWrite, const char *fileName ) {
+	if ( numWrite < 1 ) {
+		numWrite = 1;
+	} else if ( numWrite > PROFILE_MAX_FRAMES - 1 ) {
+		numWrite = PROFILE_MAX_FRAMES - 1;
+	}
+
+	if ( recording && !captureFrames ) {
+		Write( numWrite, fileName );
+		return;
+	}
+
+	// record the next frames first
+	if ( !recording ) {
+		SetRecording( true );
+		captureStopRecording = true;
+	}
+	captureFrames = numWrite;
+	captureFileName = fileName;
+	idLib::common->Printf( "recording %i frames for %s\n", numWrite, fileName );
+}
+
+/*
+================
+idProfilerLocal::GetThread
+================
+*/
+profileThread_t *idProfilerLocal::GetThread( void ) {
+	if ( profileThreadNum > 0 ) {
+		return &threads[profileThreadNum - 1];
+	}
+	if ( profileThreadNum < 0 ) {
+		return NULL;
+	}
+
+	// first zone of this thread
+	const char *name = Sys_GetThreadName();
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_SYS );
+	if ( numThreads >= PROFILE_MAX_THREADS ) {
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_SYS );
+		profileThreadNum = -1;
+		return NULL;
+	}
+	profileThread_t *thread = &threads[numThreads];
+	idStr::Copynz( thread->name, name, sizeof( thread->name ) );
+	thread->zones = new profileZone_t[PROFILE_ZONES_PER_THREAD];
+	thread->numZones = 0;
+	profileThreadNum = ++numThreads;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_SYS );
+
+	return thread;
+}
+
+/*
+================
+idProfilerLocal::BeginZone
+================
+*/
+double idProfilerLocal::BeginZone( void ) {
+	return Prof_GetClockTicks();
+}
+
+/*
+================
+idProfilerLocal::EndZone
+================
+*/
+void idProfilerLocal::EndZone( const char *name, double startTicks ) {
+	double endTicks = Prof_GetClockTicks();
+
+	if ( !recording ) {
+		return;
+	}
+	profileThread_t *thread = GetThread();
+	if ( !thread ) {
+		return;
+	}
+
+	// only the owning thread writes to the ring buffer
+	profileZone_t *zone = &thread->zones[thread->numZones & ( PROFILE_ZONES_PER_THREAD - 1 )];
+	zone->name = name;
+	zone->start = startTicks;
+	zone->end = endTicks;
+	thread->numZones++;
+}
+
+/*
+================
+idProfilerLocal::Write
+
+  writes the zones of the last numFrames whole frames as Chrome trace events
+
+  the other threads keep recording while their ring buffers are read, a zone is
+  only written when its slot wasn't reached again by the owning thread after
+  it was copied
+================
+*/
+void idProfilerLocal::Write( int numWrite, const char *fileName ) {
+	int i, j, numWriteThreads;
+
+	if ( numFrames < 2 ) {
+		idLib::common->Printf( "no whole frames recorded yet\n" );
+		return;
+	}
+	if ( numWrite > numFrames - 1 ) {
+		numWrite = numFrames - 1;
+	}
+
+	idFile *f = idLib::fileSystem->OpenFileWrite( fileName );
+	if ( !f ) {
+		idLib::common->Warning( "couldn't write %s", fileName );
+		return;
+	}
+
+	double nowTicks = Prof_GetClockTicks();
+	double nowUsec = Sys_Microseconds();
+	double usecPerTick = 1.0;
+	if ( nowTicks > baseTicks && nowUsec > baseUsec ) {
+		usecPerTick = ( nowUsec - baseUsec ) / ( nowTicks - baseTicks );
+	}
+
+	int firstFrame = numFrames - 1 - numWrite;
+	double rangeStart = frameStart[firstFrame & ( PROFILE_MAX_FRAMES - 1 )];
+	double rangeEnd = frameStart[( numFrames - 1 ) & ( PROFILE_MAX_FRAMES - 1 )];
+
+	f->Printf( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+	f->Printf( "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"doom\"}}" );
+
+	for ( i = firstFrame; i < numFrames - 1; i++ ) {
+		f->Printf( ",\n{\"ph\":\"i\",\"s\":\"g\",\"name\":\"frame %i\",\"pid\":1,\"tid\":0,\"ts\":%.3f}",
+			frameNumber[i & ( PROFILE_MAX_FRAMES - 1 )], ( frameStart[i & ( PROFILE_MAX_FRAMES - 1 )] - rangeStart ) * usecPerTick );
+	}
+
+	// threads that start recording from now on aren't in the range anyway
+	Sys_EnterCriticalSection( CRITICAL_SECTION_SYS );
+	numWriteThreads = numThreads;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_SYS );
+
+	int numWritten = 0;
+	int numLost = 0;
+	for ( i = 0; i < numWriteThreads; i++ ) {
+		const profileThread_t *thread = &threads[i];
+
+		f->Printf( ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}", i, thread->name );
+
+		int last = thread->numZones;
+		int first = last - PROFILE_ZONES_PER_THREAD;
+		if ( first < 0 ) {
+			first = 0;
+		}
+		bool lost = ( first > 0 );
+		for ( j = first; j < last; j++ ) {
+			const volatile profileZone_t *slot = &thread->zones[j & ( PROFILE_ZONES_PER_THREAD - 1 )];
+			profileZone_t zone;
+			zone.name = slot->name;
+			zone.start = slot->start;
+			zone.end = slot->end;
+			if ( thread->numZones >= j + PROFILE_ZONES_PER_THREAD ) {
+				// the owning thread is writing to this slot again
+				lost = true;
+				continue;
+			}
+			if ( zone.end < rangeStart || zone.start > rangeEnd ) {
+				continue;
+			}
+			if ( lost ) {
+				// the ring buffer wrapped inside the range
+				numLost++;
+				lost = false;
+			}
+			f->Printf( ",\n{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%i,\"ts\":%.3f,\"dur\":%.3f}",
+				zone.name, i, ( zone.start - rangeStart ) * usecPerTick, ( zone.end - zone.start ) * usecPerTick );
+			numWritten++;
+		}
+	}
+
+	f->Printf( "\n]}\n" );
+	idLib::fileSystem->CloseFile( f );
+
+	idLib::common->Printf( "wrote %i zones of %i frames to %s\n", numWritten, numWrite, fileName );
+	if ( numLost ) {
+		idLib::common->Printf( "the oldest zones of %i threads were overwritten\n", numLost );
+	}
+}
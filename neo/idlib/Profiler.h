@@ -0,0 +1,112 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include "idlib/Lib.h"
+
+/*
+===============================================================================
+
+	Hierarchical zone profiler.
+
+	PROF_SCOPE( "name" ) times the enclosing scope. While the profiler is
+	recording, every thread writes the finished zones to its own ring buffer,
+	nested zones show up as children of the zone they ran in. When it isn't
+	recording a zone costs a single test. The zone name must be a string
+	literal, only the pointer is stored.
+
+	The engine owns the profiler, the game gets it through idLib::profiler.
+	"profileDump" writes the last frames as Chrome trace JSON which can be
+	opened with chrome://tracing or Perfetto. Compiling with ID_PROFILER 0
+	removes all zones.
+
+===============================================================================
+*/
+
+class idProfiler {
+public:
+	virtual					~idProfiler( void ) {}
+
+	virtual void			Init( void ) = 0;
+	virtual void			Shutdown( void ) = 0;
+
+							// marks the start of a frame, called by idCommon
+	virtual void			BeginFrame( void ) = 0;
+							// keep recording so the last frames can be written at any time
+	virtual void			SetRecording( bool record ) = 0;
+							// writes the last numFrames frames as Chrome trace JSON, when not
+							// recording the next numFrames frames are recorded and written
+	virtual void			WriteTrace( int numFrames, const char *fileName ) = 0;
+
+							// only used by idProfileScope
+	virtual double			BeginZone( void ) = 0;
+	virtual void			EndZone( const char *name, double startTicks ) = 0;
+
+	bool					IsRecording( void ) const { return recording; }
+
+protected:
+	volatile bool			recording;
+};
+
+class idProfileScope {
+public:
+							idProfileScope( const char *name );
+							~idProfileScope( void );
+
+private:
+	const char *			name;
+	double					startTicks;
+	bool					active;
+};
+
+ID_INLINE idProfileScope::idProfileScope( const char *name ) : name( name ), startTicks( 0.0 ) {
+	active = ( idLib::profiler != NULL && idLib::profiler->IsRecording() );
+	if ( active ) {
+		startTicks = idLib::profiler->BeginZone();
+	}
+}
+
+ID_INLINE idProfileScope::~idProfileScope( void ) {
+	if ( active ) {
+		idLib::profiler->EndZone( name, startTicks );
+	}
+}
+
+extern idProfiler *			profiler;
+
+#if ID_PROFILER
+#define PROF_SCOPE_NAME2( line )	profileScope_##line
+#define PROF_SCOPE_NAME( line )		PROF_SCOPE_NAME2( line )
+#define PROF_SCOPE( name )			idProfileScope PROF_SCOPE_NAME( __LINE__ )( name )
+#else
+#define PROF_SCOPE( name )
+#endif
+
+#endif /* !__PROFILER_H__ */
@@ -106,4 +106,22 @@ ID_INLINE dword idDrawVert::GetColor( void ) const {
 	return *reinterpret_cast<const dword *>(this->color);
 }
 
+/*
+===============================================================================
+
+	Draw Vertex Streams.
+
+	Structure-of-arrays copy of the draw vertex fields used by CPU skinning
+	and tangent derivation, so these only pull in the fields they touch.
+
+===============================================================================
+*/
+
+typedef struct drawVertStreams_s {
+	idVec3 *		xyz;
+	idVec2 *		st;
+	idVec3 *		normal;
+	idVec3 *		tangents[2];
+} drawVertStreams_t;
+
 #endif /* !__DRAWVERT_H__ */
@@ -32,6 +32,8 @@ If you have questions concerning this license or the applicable additional terms
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <mach/mach_time.h>
+#elif defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+#include <x86intrin.h>
 #endif
 
 #include "sys/platform.h"
@@ -43,6 +45,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/math/Simd_SSE.h"
 #include "idlib/math/Simd_SSE2.h"
 #include "idlib/math/Simd_SSE3.h"
+#include "idlib/math/Simd_AVX2.h"
 #include "idlib/math/Simd_AltiVec.h"
 #include "idlib/math/Plane.h"
 #include "idlib/bv/Bounds.h"
@@ -88,6 +91,8 @@ void idSIMD::InitProcessor( const char *module, bool forceGeneric ) {
 		if ( !processor ) {
 			if ( ( cpuid & CPUID_ALTIVEC ) ) {
 				processor = new idSIMD_AltiVec;
+			} else if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) && ( cpuid & CPUID_SSE3 ) && ( cpuid & CPUID_AVX2 ) ) {
+				processor = new idSIMD_AVX2;
 			} else if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) && ( cpuid & CPUID_SSE3 ) ) {
 				processor = new idSIMD_SSE3;
 			} else if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) ) {
@@ -187,6 +192,16 @@ double ticksPerNanosecond;
 #define StopRecordTime( end )				\
 	end = mach_absolute_time();
 
+#elif defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+
+#define TIME_TYPE int
+
+#define StartRecordTime( start )			\
+	start = (int)__rdtsc();
+
+#define StopRecordTime( end )				\
+	end = (int)__rdtsc();
+
 #else
 
 #define TIME_TYPE int
@@ -2554,6 +2569,71 @@ void TestTransformVerts( void ) {
 	PrintClocks( va( "   simd->TransformVerts() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
+/*
+============
+TestTransformVertsSoA
+============
+*/
+void TestTransformVertsSoA( void ) {
+	int i;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	ALIGN16( idDrawVert drawVerts[NUMVERTS] );
+	ALIGN16( idVec3 xyz[NUMVERTS] );
+	ALIGN16( idJointMat joints[NUMJOINTS] );
+	ALIGN16( idVec4 weights[COUNT] );
+	ALIGN16( int weightIndex[COUNT*2] );
+	const char *result;
+
+	idRandom srnd( RANDOM_SEED );
+
+	for ( i = 0; i < NUMJOINTS; i++ ) {
+		idAngles angles;
+		angles[0] = srnd.CRandomFloat() * 180.0f;
+		angles[1] = srnd.CRandomFloat() * 180.0f;
+		angles[2] = srnd.CRandomFloat() * 180.0f;
+		joints[i].SetRotation( angles.ToMat3() );
+		idVec3 v;
+		v[0] = srnd.CRandomFloat() * 2.0f;
+		v[1] = srnd.CRandomFloat() * 2.0f;
+		v[2] = srnd.CRandomFloat() * 2.0f;
+		joints[i].SetTranslation( v );
+	}
+
+	for ( i = 0; i < COUNT; i++ ) {
+		weights[i][0] = srnd.CRandomFloat() * 2.0f;
+		weights[i][1] = srnd.CRandomFloat() * 2.0f;
+		weights[i][2] = srnd.CRandomFloat() * 2.0f;
+		weights[i][3] = srnd.CRandomFloat();
+		weightIndex[i*2+0] = ( i * NUMJOINTS / COUNT ) * sizeof( idJointMat );
+		weightIndex[i*2+1] = i & 1;
+	}
+
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_generic->TransformVerts( drawVerts, NUMVERTS, joints, weights, weightIndex, COUNT );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->TransformVerts()", COUNT, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_simd->TransformVertsSoA( xyz, NUMVERTS, joints, weights, weightIndex, COUNT );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	for ( i = 0; i < NUMVERTS; i++ ) {
+		if ( !drawVerts[i].xyz.Compare( xyz[i], 0.5f ) ) {
+			break;
+		}
+	}
+	result = ( i >= NUMVERTS ) ? "ok" :  S_COLOR_RED "X";
+	PrintClocks( va( "   simd->TransformVertsSoA() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+}
+
 /*
 ============
 TestTracePointCull
@@ -2673,6 +2753,78 @@ void TestDecalPointCull( void ) {
 	PrintClocks( va( "   simd->DecalPointCull() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
+/*
+============
+TestCullBoxes
+============
+*/
+void TestCullBoxes( void ) {
+	int i, j, k;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	const int numBoxes = COUNT - 3;		// make sure the remainder is handled
+	ALIGN16( idPlane planes[6] );
+	ALIGN16( float boxData[12][COUNT] );
+	ALIGN16( dword visibleBits1[COUNT / 32] );
+	ALIGN16( dword visibleBits2[COUNT / 32] );
+	cullBoxes_t boxes;
+	const char *result;
+
+	idRandom srnd( RANDOM_SEED );
+
+	planes[0].SetNormal( idVec3(  1,  0,  0 ) );
+	planes[1].SetNormal( idVec3( -1,  0,  0 ) );
+	planes[2].SetNormal( idVec3(  0,  1,  0 ) );
+	planes[3].SetNormal( idVec3(  0, -1,  0 ) );
+	planes[4].SetNormal( idVec3(  0,  0,  1 ) );
+	planes[5].SetNormal( idVec3(  0,  0, -1 ) );
+	planes[0][3] = -5.3f;
+	planes[1][3] = 5.3f;
+	planes[2][3] = -4.4f;
+	planes[3][3] = 4.4f;
+	planes[4][3] = -3.5f;
+	planes[5][3] = 3.5f;
+
+	for ( j = 0; j < 3; j++ ) {
+		boxes.center[j] = boxData[j];
+		for ( k = 0; k < 3; k++ ) {
+			boxes.axis[j][k] = boxData[3 + j * 3 + k];
+		}
+	}
+	for ( i = 0; i < numBoxes; i++ ) {
+		for ( j = 0; j < 3; j++ ) {
+			boxes.center[j][i] = srnd.CRandomFloat() * 10.0f;
+			for ( k = 0; k < 3; k++ ) {
+				boxes.axis[j][k][i] = srnd.CRandomFloat() * 2.0f;
+			}
+		}
+	}
+
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_generic->CullBoxes( visibleBits1, planes, 6, boxes, numBoxes );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->CullBoxes()", numBoxes, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_simd->CullBoxes( visibleBits2, planes, 6, boxes, numBoxes );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	for ( i = 0; i < COUNT / 32; i++ ) {
+		if ( visibleBits1[i] != visibleBits2[i] ) {
+			break;
+		}
+	}
+	result = ( i >= COUNT / 32 ) ? "ok" :  S_COLOR_RED "X";
+	PrintClocks( va( "   simd->CullBoxes() %s", result ), numBoxes, bestClocksSIMD, bestClocksGeneric );
+}
+
 /*
 ============
 TestOverlayPointCull
@@ -2875,6 +3027,85 @@ void TestDeriveTangents( void ) {
 	PrintClocks( va( "   simd->DeriveTangents() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
+/*
+============
+TestDeriveTangentsSoA
+============
+*/
+void TestDeriveTangentsSoA( void ) {
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	ALIGN16( idDrawVert drawVerts[COUNT] );
+	ALIGN16( idVec3 xyz[COUNT] );
+	ALIGN16( idVec2 st[COUNT] );
+	ALIGN16( idVec3 normal[COUNT] );
+	ALIGN16( idVec3 tangents[2][COUNT] );
+	ALIGN16( idPlane planes1[COUNT] );
+	ALIGN16( idPlane planes2[COUNT] );
+	ALIGN16( int indexes[COUNT*3] );
+	drawVertStreams_t streams;
+	const char *result;
+
+	idRandom srnd( RANDOM_SEED );
+
+	for ( i = 0; i < COUNT; i++ ) {
+		for ( j = 0; j < 3; j++ ) {
+			drawVerts[i].xyz[j] = srnd.CRandomFloat() * 10.0f;
+		}
+		for ( j = 0; j < 2; j++ ) {
+			drawVerts[i].st[j] = srnd.CRandomFloat();
+		}
+		xyz[i] = drawVerts[i].xyz;
+		st[i] = drawVerts[i].st;
+	}
+
+	streams.xyz = xyz;
+	streams.st = st;
+	streams.normal = normal;
+	streams.tangents[0] = tangents[0];
+	streams.tangents[1] = tangents[1];
+
+	for ( i = 0; i < COUNT; i++ ) {
+		indexes[i*3+0] = ( i + 0 ) % COUNT;
+		indexes[i*3+1] = ( i + 1 ) % COUNT;
+		indexes[i*3+2] = ( i + 2 ) % COUNT;
+	}
+
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_generic->DeriveTangents( planes1, drawVerts, COUNT, indexes, COUNT*3 );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->DeriveTangents()", COUNT, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_simd->DeriveTangentsSoA( planes2, streams, COUNT, indexes, COUNT*3 );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	for ( i = 0; i < COUNT; i++ ) {
+		if ( !drawVerts[i].normal.Compare( normal[i], 1e-2f ) ) {
+			break;
+		}
+		if ( !drawVerts[i].tangents[0].Compare( tangents[0][i], 1e-2f ) ) {
+			break;
+		}
+		if ( !drawVerts[i].tangents[1].Compare( tangents[1][i], 1e-2f ) ) {
+			break;
+		}
+		if ( !planes1[i].Compare( planes2[i], 1e-1f, 1e-1f ) ) {
+			break;
+		}
+	}
+	result = ( i >= COUNT ) ? "ok" :  S_COLOR_RED "X";
+	PrintClocks( va( "   simd->DeriveTangentsSoA() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+}
+
 /*
 ============
 TestDeriveUnsmoothedTangents
@@ -3013,6 +3244,71 @@ void TestNormalizeTangents( void ) {
 	PrintClocks( va( "   simd->NormalizeTangents() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
+/*
+============
+TestNormalizeTangentsSoA
+============
+*/
+void TestNormalizeTangentsSoA( void ) {
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	ALIGN16( idDrawVert drawVerts[COUNT] );
+	ALIGN16( idVec3 normal[COUNT] );
+	ALIGN16( idVec3 tangents[2][COUNT] );
+	drawVertStreams_t streams;
+	const char *result;
+
+	idRandom srnd( RANDOM_SEED );
+
+	for ( i = 0; i < COUNT; i++ ) {
+		for ( j = 0; j < 3; j++ ) {
+			drawVerts[i].normal[j] = srnd.CRandomFloat() * 10.0f;
+			drawVerts[i].tangents[0][j] = srnd.CRandomFloat() * 10.0f;
+			drawVerts[i].tangents[1][j] = srnd.CRandomFloat() * 10.0f;
+		}
+		normal[i] = drawVerts[i].normal;
+		tangents[0][i] = drawVerts[i].tangents[0];
+		tangents[1][i] = drawVerts[i].tangents[1];
+	}
+
+	streams.xyz = NULL;
+	streams.st = NULL;
+	streams.normal = normal;
+	streams.tangents[0] = tangents[0];
+	streams.tangents[1] = tangents[1];
+
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_generic->NormalizeTangents( drawVerts, COUNT );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->NormalizeTangents()", COUNT, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_simd->NormalizeTangentsSoA( streams, COUNT );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	for ( i = 0; i < COUNT; i++ ) {
+		if ( !drawVerts[i].normal.Compare( normal[i], 1e-2f ) ) {
+			break;
+		}
+		if ( !drawVerts[i].tangents[0].Compare( tangents[0][i], 1e-2f ) ) {
+			break;
+		}
+		if ( !drawVerts[i].tangents[1].Compare( tangents[1][i], 1e-2f ) ) {
+			break;
+		}
+	}
+	result = ( i >= COUNT ) ? "ok" :  S_COLOR_RED "X";
+	PrintClocks( va( "   simd->NormalizeTangentsSoA() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+}
+
 /*
 ============
 TestGetTextureSpaceLightVectors
@@ -3988,6 +4284,276 @@ void TestNegate( void ) {
 }
 
 
+/*
+============
+TestBitExact
+
+  The SIMD results have to be identical to the generic code, not just close.
+  Odd counts are used so the scalar tails of the SIMD loops are exercised as well.
+============
+*/
+#define BITEXACT_COUNT		( COUNT + 3 )
+
+static void PrintBitExact( const char *name, const void *a, const void *b, int size ) {
+	const char *result = ( memcmp( a, b, size ) == 0 ) ? "ok" : S_COLOR_RED "X";
+	idLib::common->Printf( "   simd->%s bit exact %s\n", name, result );
+}
+
+void TestBitExact( void ) {
+	int i;
+	ALIGN16( float fsrc0[BITEXACT_COUNT] );
+	ALIGN16( float fsrc1[BITEXACT_COUNT] );
+	ALIGN16( float fdst0[BITEXACT_COUNT] );
+	ALIGN16( float fdst1[BITEXACT_COUNT] );
+	ALIGN16( byte bdst0[BITEXACT_COUNT] );
+	ALIGN16( byte bdst1[BITEXACT_COUNT] );
+	ALIGN16( idVec3 vsrc0[BITEXACT_COUNT] );
+	ALIGN16( idVec3 vsrc1[BITEXACT_COUNT] );
+	ALIGN16( idDrawVert drawVerts0[NUMVERTS] );
+	ALIGN16( idDrawVert drawVerts1[NUMVERTS] );
+	ALIGN16( idJointQuat jointQuats[NUMJOINTS] );
+	ALIGN16( idJointMat joints0[NUMJOINTS] );
+	ALIGN16( idJointMat joints1[NUMJOINTS] );
+	ALIGN16( int parents[NUMJOINTS] );
+	ALIGN16( idVec4 weights[COUNT] );
+	ALIGN16( int weightIndex[COUNT*2] );
+	ALIGN16( idVec4 vertexCache0[NUMVERTS*2] );
+	ALIGN16( idVec4 vertexCache1[NUMVERTS*2] );
+	ALIGN16( int vertRemap0[NUMVERTS] );
+	ALIGN16( int vertRemap1[NUMVERTS] );
+	ALIGN16( short ssrc[MIXBUFFER_SAMPLES*2] );
+	ALIGN16( short sdst0[MIXBUFFER_SAMPLES*2] );
+	ALIGN16( short sdst1[MIXBUFFER_SAMPLES*2] );
+	ALIGN16( float samples[MIXBUFFER_SAMPLES*2] );
+	ALIGN16( float mix0[MIXBUFFER_SAMPLES*6] );
+	ALIGN16( float mix1[MIXBUFFER_SAMPLES*6] );
+	ALIGN16( idPlane planes0[NUMVERTS] );
+	ALIGN16( idPlane planes1[NUMVERTS] );
+	ALIGN16( int indexes[NUMVERTS*3] );
+	ALIGN16( dominantTri_t dominantTris[NUMVERTS] );
+	ALIGN16( idVec2 texCoords0[NUMVERTS] );
+	ALIGN16( idVec2 texCoords1[NUMVERTS] );
+	ALIGN16( idVec3 lightVectors0[NUMVERTS] );
+	ALIGN16( idVec3 lightVectors1[NUMVERTS] );
+	idPlane cullPlanes[6];
+	idMatX mat;
+	idVecX vec, vdst0, vdst1;
+	float f0, f1, g0, g1;
+	idVec3 v0, v1, w0, w1;
+	byte or0, or1;
+
+	idRandom srnd( RANDOM_SEED );
+
+	for ( i = 0; i < BITEXACT_COUNT; i++ ) {
+		fsrc0[i] = srnd.CRandomFloat() * 10.0f;
+		fsrc1[i] = srnd.CRandomFloat() * 10.0f;
+		vsrc0[i].Set( srnd.CRandomFloat() * 10.0f, srnd.CRandomFloat() * 10.0f, srnd.CRandomFloat() * 10.0f );
+		vsrc1[i].Set( srnd.CRandomFloat() * 10.0f, srnd.CRandomFloat() * 10.0f, srnd.CRandomFloat() * 10.0f );
+		bdst0[i] = bdst1[i] = (byte) srnd.RandomInt( 256 );
+	}
+
+	idLib::common->Printf("====================================\n" );
+
+#define TEST_FLOATS( NAME, CALL )														\
+	memcpy( fdst0, fsrc1, sizeof( fdst0 ) );											\
+	memcpy( fdst1, fsrc1, sizeof( fdst1 ) );											\
+	p_generic->CALL( fdst0, 3.3f, fsrc0, BITEXACT_COUNT );								\
+	p_simd->CALL( fdst1, 3.3f, fsrc0, BITEXACT_COUNT );									\
+	PrintBitExact( NAME "( float[], float, float[] )", fdst0, fdst1, sizeof( fdst0 ) );	\
+	p_generic->CALL( fdst0, fsrc0, fsrc1, BITEXACT_COUNT );								\
+	p_simd->CALL( fdst1, fsrc0, fsrc1, BITEXACT_COUNT );								\
+	PrintBitExact( NAME "( float[], float[], float[] )", fdst0, fdst1, sizeof( fdst0 ) );
+
+	TEST_FLOATS( "Add", Add )
+	TEST_FLOATS( "Sub", Sub )
+	TEST_FLOATS( "Mul", Mul )
+	TEST_FLOATS( "Div", Div )
+	TEST_FLOATS( "MulAdd", MulAdd )
+	TEST_FLOATS( "MulSub", MulSub )
+
+#undef TEST_FLOATS
+
+	p_generic->Dot( fdst0, vsrc0, vsrc1, BITEXACT_COUNT );
+	p_simd->Dot( fdst1, vsrc0, vsrc1, BITEXACT_COUNT );
+	PrintBitExact( "Dot( idVec3[] * idVec3[] )", fdst0, fdst1, sizeof( fdst0 ) );
+
+	for ( i = 0; i < 16; i++ ) {
+		p_generic->Dot( fdst0[i], fsrc0, fsrc1, BITEXACT_COUNT - i );
+		p_simd->Dot( fdst1[i], fsrc0, fsrc1, BITEXACT_COUNT - i );
+	}
+	PrintBitExact( "Dot( float[] * float[] )", fdst0, fdst1, 16 * sizeof( float ) );
+
+	p_generic->CmpGT( bdst0, 3, fsrc0, 1.0f, BITEXACT_COUNT );
+	p_simd->CmpGT( bdst1, 3, fsrc0, 1.0f, BITEXACT_COUNT );
+	p_generic->CmpLE( bdst0, 5, fsrc0, -1.0f, BITEXACT_COUNT );
+	p_simd->CmpLE( bdst1, 5, fsrc0, -1.0f, BITEXACT_COUNT );
+	PrintBitExact( "Cmp( float[], float )", bdst0, bdst1, sizeof( bdst0 ) );
+
+	// signed zeros have to come out the same as well
+	for ( i = 0; i < BITEXACT_COUNT; i++ ) {
+		fdst0[i] = idMath::Fabs( fsrc0[i] );
+	}
+	fdst0[7] = -0.0f;
+	fdst0[8] = 0.0f;
+	p_generic->MinMax( f0, f1, fdst0, BITEXACT_COUNT );
+	p_simd->MinMax( g0, g1, fdst0, BITEXACT_COUNT );
+	PrintBitExact( "MinMax( float[] ) min", &f0, &g0, sizeof( f0 ) );
+	PrintBitExact( "MinMax( float[] ) max", &f1, &g1, sizeof( f1 ) );
+	p_generic->MinMax( v0, v1, vsrc0, BITEXACT_COUNT );
+	p_simd->MinMax( w0, w1, vsrc0, BITEXACT_COUNT );
+	PrintBitExact( "MinMax( idVec3[] ) min", &v0, &w0, sizeof( v0 ) );
+	PrintBitExact( "MinMax( idVec3[] ) max", &v1, &w1, sizeof( v1 ) );
+
+	p_generic->Clamp( fdst0, fsrc0, -1.0f, 1.0f, BITEXACT_COUNT );
+	p_simd->Clamp( fdst1, fsrc0, -1.0f, 1.0f, BITEXACT_COUNT );
+	PrintBitExact( "Clamp( float[] )", fdst0, fdst1, sizeof( fdst0 ) );
+
+	for ( i = 0; i < NUMJOINTS; i++ ) {
+		idAngles angles( srnd.CRandomFloat() * 180.0f, srnd.CRandomFloat() * 180.0f, srnd.CRandomFloat() * 180.0f );
+		jointQuats[i].q = angles.ToQuat();
+		jointQuats[i].t.Set( srnd.CRandomFloat() * 2.0f, srnd.CRandomFloat() * 2.0f, srnd.CRandomFloat() * 2.0f );
+		parents[i] = ( i > 0 ) ? srnd.RandomInt( i ) : -1;
+	}
+	p_generic->ConvertJointQuatsToJointMats( joints0, jointQuats, NUMJOINTS - 1 );
+	p_simd->ConvertJointQuatsToJointMats( joints1, jointQuats, NUMJOINTS - 1 );
+	PrintBitExact( "ConvertJointQuatsToJointMats()", joints0, joints1, ( NUMJOINTS - 1 ) * sizeof( joints0[0] ) );
+
+	memcpy( joints1, joints0, sizeof( joints1 ) );
+	p_generic->TransformJoints( joints0, parents, 1, NUMJOINTS - 2 );
+	p_simd->TransformJoints( joints1, parents, 1, NUMJOINTS - 2 );
+	PrintBitExact( "TransformJoints()", joints0, joints1, ( NUMJOINTS - 1 ) * sizeof( joints0[0] ) );
+
+	p_generic->UntransformJoints( joints0, parents, 1, NUMJOINTS - 2 );
+	p_simd->UntransformJoints( joints1, parents, 1, NUMJOINTS - 2 );
+	PrintBitExact( "UntransformJoints()", joints0, joints1, ( NUMJOINTS - 1 ) * sizeof( joints0[0] ) );
+
+	for ( i = 0; i < COUNT; i++ ) {
+		weights[i].Set( srnd.CRandomFloat() * 2.0f, srnd.CRandomFloat() * 2.0f, srnd.CRandomFloat() * 2.0f, srnd.CRandomFloat() );
+		weightIndex[i*2+0] = ( i * ( NUMJOINTS - 1 ) / COUNT ) * sizeof( idJointMat );
+		weightIndex[i*2+1] = i & 1;
+	}
+	memset( drawVerts0, 0, sizeof( drawVerts0 ) );
+	memset( drawVerts1, 0, sizeof( drawVerts1 ) );
+	p_generic->TransformVerts( drawVerts0, NUMVERTS, joints0, weights, weightIndex, COUNT );
+	p_simd->TransformVerts( drawVerts1, NUMVERTS, joints0, weights, weightIndex, COUNT );
+	PrintBitExact( "TransformVerts()", drawVerts0, drawVerts1, sizeof( drawVerts0 ) );
+
+	for ( i = 0; i < NUMVERTS; i++ ) {
+		vertRemap0[i] = vertRemap1[i] = srnd.RandomInt( 2 );
+	}
+	memset( vertexCache0, 0, sizeof( vertexCache0 ) );
+	memset( vertexCache1, 0, sizeof( vertexCache1 ) );
+	p_generic->CreateShadowCache( vertexCache0, vertRemap0, vsrc0[0], drawVerts0, NUMVERTS );
+	p_simd->CreateShadowCache( vertexCache1, vertRemap1, vsrc0[0], drawVerts0, NUMVERTS );
+	PrintBitExact( "CreateShadowCache()", vertexCache0, vertexCache1, sizeof( vertexCache0 ) );
+
+	for ( i = 0; i < NUMVERTS; i++ ) {
+		drawVerts0[i].Clear();
+		drawVerts0[i].xyz.Set( srnd.CRandomFloat() * 10.0f, srnd.CRandomFloat() * 10.0f, srnd.CRandomFloat() * 10.0f );
+		drawVerts0[i].st.Set( srnd.CRandomFloat(), srnd.CRandomFloat() );
+		drawVerts0[i].normal.Set( srnd.CRandomFloat(), srnd.CRandomFloat(), srnd.CRandomFloat() );
+		drawVerts0[i].tangents[0].Set( srnd.CRandomFloat(), srnd.CRandomFloat(), srnd.CRandomFloat() );
+		drawVerts0[i].tangents[1].Set( srnd.CRandomFloat(), srnd.CRandomFloat(), srnd.CRandomFloat() );
+		indexes[i*3+0] = srnd.RandomInt( NUMVERTS );
+		indexes[i*3+1] = srnd.RandomInt( NUMVERTS );
+		indexes[i*3+2] = srnd.RandomInt( NUMVERTS );
+		dominantTris[i].v2 = srnd.RandomInt( NUMVERTS );
+		dominantTris[i].v3 = srnd.RandomInt( NUMVERTS );
+		dominantTris[i].normalizationScale[0] = srnd.CRandomFloat();
+		dominantTris[i].normalizationScale[1] = srnd.CRandomFloat();
+		dominantTris[i].normalizationScale[2] = srnd.CRandomFloat();
+	}
+	memcpy( drawVerts1, drawVerts0, sizeof( drawVerts1 ) );
+
+	for ( i = 0; i < 6; i++ ) {
+		cullPlanes[i].SetNormal( vsrc1[i] * 0.1f );
+		cullPlanes[i].SetDist( fsrc1[i] * 0.1f );
+	}
+	p_generic->TracePointCull( bdst0, or0, 1.0f, cullPlanes, drawVerts0, NUMVERTS - 3 );
+	p_simd->TracePointCull( bdst1, or1, 1.0f, cullPlanes, drawVerts0, NUMVERTS - 3 );
+	PrintBitExact( "TracePointCull()", bdst0, bdst1, NUMVERTS - 3 );
+	PrintBitExact( "TracePointCull() totalOr", &or0, &or1, sizeof( or0 ) );
+	p_generic->DecalPointCull( bdst0, cullPlanes, drawVerts0, NUMVERTS - 3 );
+	p_simd->DecalPointCull( bdst1, cullPlanes, drawVerts0, NUMVERTS - 3 );
+	PrintBitExact( "DecalPointCull()", bdst0, bdst1, NUMVERTS - 3 );
+	p_generic->OverlayPointCull( bdst0, texCoords0, cullPlanes, drawVerts0, NUMVERTS - 3 );
+	p_simd->OverlayPointCull( bdst1, texCoords1, cullPlanes, drawVerts0, NUMVERTS - 3 );
+	PrintBitExact( "OverlayPointCull()", bdst0, bdst1, NUMVERTS - 3 );
+	PrintBitExact( "OverlayPointCull() texCoords", texCoords0, texCoords1, ( NUMVERTS - 3 ) * sizeof( texCoords0[0] ) );
+
+	p_generic->DeriveTriPlanes( planes0, drawVerts0, NUMVERTS, indexes, ( NUMVERTS - 3 ) * 3 );
+	p_simd->DeriveTriPlanes( planes1, drawVerts0, NUMVERTS, indexes, ( NUMVERTS - 3 ) * 3 );
+	PrintBitExact( "DeriveTriPlanes()", planes0, planes1, ( NUMVERTS - 3 ) * sizeof( planes0[0] ) );
+
+	p_generic->DeriveTangents( planes0, drawVerts0, NUMVERTS, indexes, ( NUMVERTS - 3 ) * 3 );
+	p_simd->DeriveTangents( planes1, drawVerts1, NUMVERTS, indexes, ( NUMVERTS - 3 ) * 3 );
+	PrintBitExact( "DeriveTangents() planes", planes0, planes1, ( NUMVERTS - 3 ) * sizeof( planes0[0] ) );
+	PrintBitExact( "DeriveTangents() verts", drawVerts0, drawVerts1, sizeof( drawVerts0 ) );
+
+	p_generic->NormalizeTangents( drawVerts0, NUMVERTS - 3 );
+	p_simd->NormalizeTangents( drawVerts1, NUMVERTS - 3 );
+	PrintBitExact( "NormalizeTangents()", drawVerts0, drawVerts1, sizeof( drawVerts0 ) );
+
+	p_generic->DeriveUnsmoothedTangents( drawVerts0, dominantTris, NUMVERTS - 3 );
+	p_simd->DeriveUnsmoothedTangents( drawVerts1, dominantTris, NUMVERTS - 3 );
+	PrintBitExact( "DeriveUnsmoothedTangents()", drawVerts0, drawVerts1, sizeof( drawVerts0 ) );
+
+	// only part of the vertices is referenced so the unused ones have to stay untouched
+	memset( lightVectors0, 0, sizeof( lightVectors0 ) );
+	memset( lightVectors1, 0, sizeof( lightVectors1 ) );
+	p_generic->CreateTextureSpaceLightVectors( lightVectors0, vsrc1[0], drawVerts0, NUMVERTS - 3, indexes, NUMVERTS / 2 );
+	p_simd->CreateTextureSpaceLightVectors( lightVectors1, vsrc1[0], drawVerts0, NUMVERTS - 3, indexes, NUMVERTS / 2 );
+	PrintBitExact( "CreateTextureSpaceLightVectors()", lightVectors0, lightVectors1, sizeof( lightVectors0 ) );
+
+	memset( vertexCache0, 0, sizeof( vertexCache0 ) );
+	memset( vertexCache1, 0, sizeof( vertexCache1 ) );
+	p_generic->CreateSpecularTextureCoords( vertexCache0, vsrc1[0], vsrc1[1], drawVerts0, NUMVERTS - 3, indexes, NUMVERTS / 2 );
+	p_simd->CreateSpecularTextureCoords( vertexCache1, vsrc1[0], vsrc1[1], drawVerts0, NUMVERTS - 3, indexes, NUMVERTS / 2 );
+	PrintBitExact( "CreateSpecularTextureCoords()", vertexCache0, vertexCache1, sizeof( vertexCache0 ) );
+
+	// sizes that are not a multiple of four for both the rows and the columns
+	mat.Random( 37, 23, RANDOM_SEED, -10.0f, 10.0f );
+	vec.Random( 37, RANDOM_SEED, -10.0f, 10.0f );
+	vdst0.Random( 37, RANDOM_SEED + 1, -10.0f, 10.0f );
+	vdst1 = vdst0;
+
+#define TEST_MATX( NAME )															\
+	p_generic->NAME( vdst0, mat, vec );												\
+	p_simd->NAME( vdst1, mat, vec );												\
+	PrintBitExact( #NAME "()", vdst0.ToFloatPtr(), vdst1.ToFloatPtr(), vdst0.GetSize() * sizeof( float ) );
+
+	TEST_MATX( MatX_MultiplyVecX )
+	TEST_MATX( MatX_MultiplyAddVecX )
+	TEST_MATX( MatX_MultiplySubVecX )
+	TEST_MATX( MatX_TransposeMultiplyVecX )
+	TEST_MATX( MatX_TransposeMultiplyAddVecX )
+	TEST_MATX( MatX_TransposeMultiplySubVecX )
+
+#undef TEST_MATX
+
+	for ( i = 0; i < MIXBUFFER_SAMPLES*2; i++ ) {
+		ssrc[i] = (short) srnd.RandomInt( 65536 ) - 32768;
+		samples[i] = srnd.CRandomFloat() * 32768.0f;
+	}
+	p_generic->UpSamplePCMTo44kHz( mix0, ssrc, MIXBUFFER_SAMPLES/4 + 2, 11025, 2 );
+	p_simd->UpSamplePCMTo44kHz( mix1, ssrc, MIXBUFFER_SAMPLES/4 + 2, 11025, 2 );
+	PrintBitExact( "UpSamplePCMTo44kHz()", mix0, mix1, ( MIXBUFFER_SAMPLES + 8 ) * sizeof( float ) );
+
+	const float lastV[6] = { 0.1f, 0.5f, 0.7f, 0.2f, 0.9f, 0.3f };
+	const float currentV[6] = { 0.8f, 0.2f, 0.3f, 0.6f, 0.1f, 0.4f };
+	memset( mix0, 0, sizeof( mix0 ) );
+	memset( mix1, 0, sizeof( mix1 ) );
+	p_generic->MixSoundTwoSpeakerStereo( mix0, samples, MIXBUFFER_SAMPLES, lastV, currentV );
+	p_simd->MixSoundTwoSpeakerStereo( mix1, samples, MIXBUFFER_SAMPLES, lastV, currentV );
+	p_generic->MixSoundSixSpeakerMono( mix0, samples, MIXBUFFER_SAMPLES, lastV, currentV );
+	p_simd->MixSoundSixSpeakerMono( mix1, samples, MIXBUFFER_SAMPLES, lastV, currentV );
+	PrintBitExact( "MixSound()", mix0, mix1, sizeof( mix0 ) );
+
+	p_generic->MixedSoundToSamples( sdst0, mix0, MIXBUFFER_SAMPLES*2 - 3 );
+	p_simd->MixedSoundToSamples( sdst1, mix0, MIXBUFFER_SAMPLES*2 - 3 );
+	PrintBitExact( "MixedSoundToSamples()", sdst0, sdst1, ( MIXBUFFER_SAMPLES*2 - 3 ) * sizeof( short ) );
+}
+
 /*
 ============
 idSIMD::Test_f
@@ -4038,6 +4604,12 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 				return;
 			}
 			p_simd = new idSIMD_SSE3();
+		} else if ( idStr::Icmp( argString, "AVX2" ) == 0 ) {
+			if ( !( cpuid & CPUID_MMX ) || !( cpuid & CPUID_SSE ) || !( cpuid & CPUID_SSE2 ) || !( cpuid & CPUID_SSE3 ) || !( cpuid & CPUID_AVX2 ) ) {
+				common->Printf( "CPU does not support MMX & SSE & SSE2 & SSE3 & AVX2\n" );
+				return;
+			}
+			p_simd = new idSIMD_AVX2();
 		} else if ( idStr::Icmp( argString, "AltiVec" ) == 0 ) {
 			if ( !( cpuid & CPUID_ALTIVEC ) ) {
 				common->Printf( "CPU does not support AltiVec\n" );
@@ -4045,7 +4617,7 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 			}
 			p_simd = new idSIMD_AltiVec();
 		} else {
-			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AltiVec\n" );
+			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AVX2, AltiVec\n" );
 			return;
 		}
 	}
@@ -4089,13 +4661,17 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 	TestTransformJoints();
 	TestUntransformJoints();
 	TestTransformVerts();
+	TestTransformVertsSoA();
 	TestTracePointCull();
 	TestDecalPointCull();
+	TestCullBoxes();
 	TestOverlayPointCull();
 	TestDeriveTriPlanes();
 	TestDeriveTangents();
+	TestDeriveTangentsSoA();
 	TestDeriveUnsmoothedTangents();
 	TestNormalizeTangents();
+	TestNormalizeTangentsSoA();
 	TestGetTextureSpaceLightVectors();
 	TestGetSpecularTextureCoords();
 	TestCreateShadowCache();
@@ -4105,6 +4681,8 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 	TestSoundUpSampling();
 	TestSoundMixing();
 
+	TestBitExact();
+
 	idLib::common->SetRefreshOnPrint( false );
 
 	if ( p_simd != processor ) {
@@ -82,6 +82,13 @@ class idDrawVert;
 class idJointQuat;
 class idJointMat;
 struct dominantTri_s;
+struct drawVertStreams_s;
+
+// boxes in structure of arrays layout for CullBoxes, each array has one float per box
+typedef struct cullBoxes_s {
+	float *					center[3];			// box centers
+	float *					axis[3][3];			// box axes scaled by the half size of the box
+} cullBoxes_t;
 
 const int MIXBUFFER_SAMPLES = 4096;
 
@@ -190,6 +197,13 @@ public:
 	virtual void VPCALL CreateSpecularTextureCoords( idVec4 *texCoords, const idVec3 &lightOrigin, const idVec3 &viewOrigin, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) = 0;
 	virtual int  VPCALL CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts ) = 0;
 	virtual int  VPCALL CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts ) = 0;
+	virtual void VPCALL CullBoxes( dword *visibleBits, const idPlane *planes, const int numPlanes, const cullBoxes_t &boxes, const int numBoxes ) = 0;
+
+	// structure-of-arrays vertex streams
+	virtual void VPCALL TransformVertsSoA( idVec3 *xyz, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) = 0;
+	virtual void VPCALL DeriveTangentsSoA( idPlane *planes, const drawVertStreams_s &streams, const int numVerts, const int *indexes, const int numIndexes ) = 0;
+	virtual void VPCALL DeriveUnsmoothedTangentsSoA( const drawVertStreams_s &streams, const dominantTri_s *dominantTris, const int numVerts ) = 0;
+	virtual void VPCALL NormalizeTangentsSoA( const drawVertStreams_s &streams, const int numVerts ) = 0;
 
 	// sound mixing
 	virtual void VPCALL UpSamplePCMTo44kHz( float *dest, const short *pcm, const int numSamples, const int kHz, const int numChannels ) = 0;
@@ -0,0 +1,679 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+
+#include "idlib/math/Simd_AVX2.h"
+
+//===============================================================
+//
+//	AVX2 implementation of idSIMDProcessor
+//
+//===============================================================
+
+#if defined(ID_SIMD_AVX2)
+
+#include <immintrin.h>
+
+#include "idlib/math/Math.h"
+#include "idlib/math/Plane.h"
+
+#define AVX2_TARGET		__attribute__((target("avx2")))
+
+/*
+  Same evaluation order as idSIMD_Generic, only eight floats at a time.
+  FMA is deliberately not used because it rounds differently.
+*/
+
+/*
+============
+idSIMD_AVX2::GetName
+============
+*/
+const char * idSIMD_AVX2::GetName( void ) const {
+	return "MMX & SSE & SSE2 & SSE3 & AVX2";
+}
+
+#define AVX2_LOOP8( VECOP, OPER )											\
+	int i;																	\
+	for ( i = 0; i + 8 <= count; i += 8 ) {									\
+		VECOP;																\
+	}																		\
+	for ( ; i < count; i++ ) {												\
+		OPER;																\
+	}
+
+/*
+============
+idSIMD_AVX2::Add
+
+  dst[i] = constant + src[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Add( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_loadu_ps( src + i ), c ) ), dst[i] = src[i] + constant )
+}
+
+/*
+============
+idSIMD_AVX2::Add
+
+  dst[i] = src0[i] + src1[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Add( float *dst, const float *src0, const float *src1, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) ), dst[i] = src0[i] + src1[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Sub
+
+  dst[i] = constant - src[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Sub( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_sub_ps( c, _mm256_loadu_ps( src + i ) ) ), dst[i] = constant - src[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Sub
+
+  dst[i] = src0[i] - src1[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Sub( float *dst, const float *src0, const float *src1, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_sub_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) ), dst[i] = src0[i] - src1[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Mul
+
+  dst[i] = constant * src[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Mul( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_mul_ps( c, _mm256_loadu_ps( src + i ) ) ), dst[i] = constant * src[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Mul
+
+  dst[i] = src0[i] * src1[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Mul( float *dst, const float *src0, const float *src1, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_mul_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) ), dst[i] = src0[i] * src1[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Div
+
+  dst[i] = constant / divisor[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Div( float *dst, const float constant, const float *divisor, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_div_ps( c, _mm256_loadu_ps( divisor + i ) ) ), dst[i] = constant / divisor[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Div
+
+  dst[i] = src0[i] / src1[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Div( float *dst, const float *src0, const float *src1, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_div_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) ), dst[i] = src0[i] / src1[i] )
+}
+
+/*
+============
+AVX2_MulAddDouble
+
+  dst + c * src for four floats with the intermediate in double precision like the generic code
+============
+*/
+static AVX2_TARGET ID_INLINE __m128 AVX2_MulAddDouble( const __m128 dst, const __m256d c, const __m128 src, const bool subtract ) {
+	__m256d d = _mm256_cvtps_pd( dst );
+	__m256d p = _mm256_mul_pd( c, _mm256_cvtps_pd( src ) );
+	return _mm256_cvtpd_ps( subtract ? _mm256_sub_pd( d, p ) : _mm256_add_pd( d, p ) );
+}
+
+/*
+============
+idSIMD_AVX2::MulAdd
+
+  dst[i] += constant * src[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MulAdd( float *dst, const float constant, const float *src, const int count ) {
+	const double dc = constant;
+	const __m256d c = _mm256_set1_pd( dc );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		_mm_storeu_ps( dst + i, AVX2_MulAddDouble( _mm_loadu_ps( dst + i ), c, _mm_loadu_ps( src + i ), false ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] += dc * src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MulAdd
+
+  dst[i] += src0[i] * src1[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MulAdd( float *dst, const float *src0, const float *src1, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_loadu_ps( dst + i ), _mm256_mul_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) ) ), dst[i] += src0[i] * src1[i] )
+}
+
+/*
+============
+idSIMD_AVX2::MulSub
+
+  dst[i] -= constant * src[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MulSub( float *dst, const float constant, const float *src, const int count ) {
+	const double dc = constant;
+	const __m256d c = _mm256_set1_pd( dc );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		_mm_storeu_ps( dst + i, AVX2_MulAddDouble( _mm_loadu_ps( dst + i ), c, _mm_loadu_ps( src + i ), true ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] -= dc * src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MulSub
+
+  dst[i] -= src0[i] * src1[i];
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MulSub( float *dst, const float *src0, const float *src1, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_sub_ps( _mm256_loadu_ps( dst + i ), _mm256_mul_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) ) ), dst[i] -= src0[i] * src1[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dot = src1[0] * src2[0] + src1[1] * src2[1] + src1[2] * src2[2] + ...
+
+  The four double precision partial sums of the generic code are the four lanes of one register.
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Dot( float &dot, const float *src1, const float *src2, const int count ) {
+	if ( count < 4 ) {
+		idSIMD_SSE2::Dot( dot, src1, src2, count );
+		return;
+	}
+
+	__m256d s = _mm256_cvtps_pd( _mm_mul_ps( _mm_loadu_ps( src1 ), _mm_loadu_ps( src2 ) ) );
+	int i;
+
+	for ( i = 4; i < count - 7; i += 8 ) {
+		__m256 p = _mm256_mul_ps( _mm256_loadu_ps( src1 + i ), _mm256_loadu_ps( src2 + i ) );
+		s = _mm256_add_pd( s, _mm256_cvtps_pd( _mm256_castps256_ps128( p ) ) );
+		s = _mm256_add_pd( s, _mm256_cvtps_pd( _mm256_extractf128_ps( p, 1 ) ) );
+	}
+
+	double sl[4];
+	_mm256_storeu_pd( sl, s );
+
+	switch( count - i ) {
+		case 7: sl[0] += src1[i+6] * src2[i+6];
+		case 6: sl[1] += src1[i+5] * src2[i+5];
+		case 5: sl[2] += src1[i+4] * src2[i+4];
+		case 4: sl[3] += src1[i+3] * src2[i+3];
+		case 3: sl[0] += src1[i+2] * src2[i+2];
+		case 2: sl[1] += src1[i+1] * src2[i+1];
+		case 1: sl[2] += src1[i+0] * src2[i+0];
+		case 0: break;
+	}
+
+	double sum;
+	sum = sl[3];
+	sum += sl[2];
+	sum += sl[1];
+	sum += sl[0];
+	dot = sum;
+}
+
+/*
+============
+AVX2_CmpToBytes
+
+  packs 16 compare masks into 16 bytes that are 0 or 1 << bitNum
+============
+*/
+static AVX2_TARGET ID_INLINE __m128i AVX2_CmpToBytes( const __m256 m0, const __m256 m1, const __m128i bit ) {
+	__m128i lo = _mm_packs_epi32( _mm256_castsi256_si128( _mm256_castps_si256( m0 ) ), _mm256_extracti128_si256( _mm256_castps_si256( m0 ), 1 ) );
+	__m128i hi = _mm_packs_epi32( _mm256_castsi256_si128( _mm256_castps_si256( m1 ) ), _mm256_extracti128_si256( _mm256_castps_si256( m1 ), 1 ) );
+	return _mm_and_si128( _mm_packs_epi16( lo, hi ), bit );
+}
+
+#define AVX2_CMP( CMPOP, OPER, SHIFT )												\
+	const __m256 c = _mm256_set1_ps( constant );									\
+	const __m128i bit = _mm_set1_epi8( (char) ( 1 << SHIFT ) );					\
+	int i;																			\
+	for ( i = 0; i + 16 <= count; i += 16 ) {										\
+		__m256 m0 = _mm256_cmp_ps( _mm256_loadu_ps( src0 + i + 0 ), c, CMPOP );		\
+		__m256 m1 = _mm256_cmp_ps( _mm256_loadu_ps( src0 + i + 8 ), c, CMPOP );		\
+		__m128i b = AVX2_CmpToBytes( m0, m1, bit );									\
+		OPER;																		\
+	}
+
+#define AVX2_CMP_STORE			_mm_storeu_si128( (__m128i *) ( dst + i ), b )
+#define AVX2_CMP_STORE_OR		_mm_storeu_si128( (__m128i *) ( dst + i ), _mm_or_si128( b, _mm_loadu_si128( (__m128i *) ( dst + i ) ) ) )
+
+/*
+============
+idSIMD_AVX2::CmpGT
+
+  dst[i] = src0[i] > constant;
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::CmpGT( byte *dst, const float *src0, const float constant, const int count ) {
+	AVX2_CMP( _CMP_GT_OQ, AVX2_CMP_STORE, 0 )
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] > constant;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpGT
+
+  dst[i] |= ( src0[i] > constant ) << bitNum;
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::CmpGT( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	AVX2_CMP( _CMP_GT_OQ, AVX2_CMP_STORE_OR, bitNum )
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] > constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpGE
+
+  dst[i] = src0[i] >= constant;
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::CmpGE( byte *dst, const float *src0, const float constant, const int count ) {
+	AVX2_CMP( _CMP_GE_OQ, AVX2_CMP_STORE, 0 )
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] >= constant;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpGE
+
+  dst[i] |= ( src0[i] >= constant ) << bitNum;
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::CmpGE( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	AVX2_CMP( _CMP_GE_OQ, AVX2_CMP_STORE_OR, bitNum )
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] >= constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpLT
+
+  dst[i] = src0[i] < constant;
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::CmpLT( byte *dst, const float *src0, const float constant, const int count ) {
+	AVX2_CMP( _CMP_LT_OQ, AVX2_CMP_STORE, 0 )
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] < constant;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpLT
+
+  dst[i] |= ( src0[i] < constant ) << bitNum;
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::CmpLT( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	AVX2_CMP( _CMP_LT_OQ, AVX2_CMP_STORE_OR, bitNum )
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] < constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpLE
+
+  dst[i] = src0[i] <= constant;
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::CmpLE( byte *dst, const float *src0, const float constant, const int count ) {
+	AVX2_CMP( _CMP_LE_OQ, AVX2_CMP_STORE, 0 )
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] <= constant;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpLE
+
+  dst[i] |= ( src0[i] <= constant ) << bitNum;
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::CmpLE( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	AVX2_CMP( _CMP_LE_OQ, AVX2_CMP_STORE_OR, bitNum )
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] <= constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MinMax( float &min, float &max, const float *src, const int count ) {
+	__m256 mn = _mm256_set1_ps( idMath::INFINITY );
+	__m256 mx = _mm256_set1_ps( -idMath::INFINITY );
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		__m256 v = _mm256_loadu_ps( src + i );
+		mn = _mm256_min_ps( v, mn );
+		mx = _mm256_max_ps( v, mx );
+	}
+	__m128 mn4 = _mm_min_ps( _mm256_castps256_ps128( mn ), _mm256_extractf128_ps( mn, 1 ) );
+	__m128 mx4 = _mm_max_ps( _mm256_castps256_ps128( mx ), _mm256_extractf128_ps( mx, 1 ) );
+	for ( ; i < count; i++ ) {
+		__m128 v = _mm_set1_ps( src[i] );
+		mn4 = _mm_min_ps( v, mn4 );
+		mx4 = _mm_max_ps( v, mx4 );
+	}
+	mn4 = _mm_min_ps( mn4, _mm_movehl_ps( mn4, mn4 ) );
+	mn4 = _mm_min_ss( mn4, _mm_shuffle_ps( mn4, mn4, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	mx4 = _mm_max_ps( mx4, _mm_movehl_ps( mx4, mx4 ) );
+	mx4 = _mm_max_ss( mx4, _mm_shuffle_ps( mx4, mx4, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	min = _mm_cvtss_f32( mn4 );
+	max = _mm_cvtss_f32( mx4 );
+
+	// min and max instructions treat -0.0f and 0.0f as equal, the generic code keeps the first zero
+	if ( min == 0.0f || max == 0.0f ) {
+		for ( i = 0; i < count; i++ ) {
+			if ( src[i] == 0.0f ) {
+				if ( min == 0.0f ) {
+					min = src[i];
+				}
+				if ( max == 0.0f ) {
+					max = src[i];
+				}
+				break;
+			}
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Clamp
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Clamp( float *dst, const float *src, const float min, const float max, const int count ) {
+	const __m256 mn = _mm256_set1_ps( min );
+	const __m256 mx = _mm256_set1_ps( max );
+	int i;
+
+	for ( i = 0; i + 8 <= count; i += 8 ) {
+		__m256 v = _mm256_loadu_ps( src + i );
+		__m256 below = _mm256_cmp_ps( v, mn, _CMP_LT_OQ );
+		_mm256_storeu_ps( dst + i, _mm256_blendv_ps( _mm256_min_ps( mx, v ), mn, below ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src[i] < min ? min : src[i] > max ? max : src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::ClampMin
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::ClampMin( float *dst, const float *src, const float min, const int count ) {
+	const __m256 mn = _mm256_set1_ps( min );
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_max_ps( mn, _mm256_loadu_ps( src + i ) ) ), dst[i] = src[i] < min ? min : src[i] )
+}
+
+/*
+============
+idSIMD_AVX2::ClampMax
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::ClampMax( float *dst, const float *src, const float max, const int count ) {
+	const __m256 mx = _mm256_set1_ps( max );
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_min_ps( mx, _mm256_loadu_ps( src + i ) ) ), dst[i] = src[i] > max ? max : src[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Zero16
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Zero16( float *dst, const int count ) {
+	const __m256 z = _mm256_setzero_ps();
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, z ), dst[i] = 0.0f )
+}
+
+/*
+============
+idSIMD_AVX2::Negate16
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Negate16( float *dst, const int count ) {
+	const __m256 sign = _mm256_castsi256_ps( _mm256_set1_epi32( 1u << 31 ) );
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_xor_ps( _mm256_loadu_ps( dst + i ), sign ) ), reinterpret_cast<unsigned int *>(dst)[i] ^= ( 1u << 31 ) )
+}
+
+/*
+============
+idSIMD_AVX2::Copy16
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Copy16( float *dst, const float *src, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_loadu_ps( src + i ) ), dst[i] = src[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Add16
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Add16( float *dst, const float *src1, const float *src2, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_loadu_ps( src1 + i ), _mm256_loadu_ps( src2 + i ) ) ), dst[i] = src1[i] + src2[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Sub16
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Sub16( float *dst, const float *src1, const float *src2, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_sub_ps( _mm256_loadu_ps( src1 + i ), _mm256_loadu_ps( src2 + i ) ) ), dst[i] = src1[i] - src2[i] )
+}
+
+/*
+============
+idSIMD_AVX2::Mul16
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::Mul16( float *dst, const float *src1, const float constant, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_mul_ps( _mm256_loadu_ps( src1 + i ), c ) ), dst[i] = src1[i] * constant )
+}
+
+/*
+============
+idSIMD_AVX2::AddAssign16
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::AddAssign16( float *dst, const float *src, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_loadu_ps( dst + i ), _mm256_loadu_ps( src + i ) ) ), dst[i] += src[i] )
+}
+
+/*
+============
+idSIMD_AVX2::SubAssign16
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::SubAssign16( float *dst, const float *src, const int count ) {
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_sub_ps( _mm256_loadu_ps( dst + i ), _mm256_loadu_ps( src + i ) ) ), dst[i] -= src[i] )
+}
+
+/*
+============
+idSIMD_AVX2::MulAssign16
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MulAssign16( float *dst, const float constant, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	AVX2_LOOP8( _mm256_storeu_ps( dst + i, _mm256_mul_ps( _mm256_loadu_ps( dst + i ), c ) ), dst[i] *= constant )
+}
+
+/*
+============
+idSIMD_AVX2::CullBoxes
+
+  same plane distances as idSIMD_Generic::CullBoxes, eight boxes at a time
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::CullBoxes( dword *visibleBits, const idPlane *planes, const int numPlanes, const cullBoxes_t &boxes, const int numBoxes ) {
+	const __m256 absMask = _mm256_castsi256_ps( _mm256_set1_epi32( 0x7FFFFFFF ) );
+	const __m256 zero = _mm256_setzero_ps();
+	const float *rows[12] = {
+		boxes.center[0], boxes.center[1], boxes.center[2],
+		boxes.axis[0][0], boxes.axis[0][1], boxes.axis[0][2],
+		boxes.axis[1][0], boxes.axis[1][1], boxes.axis[1][2],
+		boxes.axis[2][0], boxes.axis[2][1], boxes.axis[2][2]
+	};
+	ALIGN16( float pad[8] );
+
+	memset( visibleBits, 0, ( ( numBoxes + 31 ) >> 5 ) * sizeof( visibleBits[0] ) );
+
+	for ( int i = 0; i < numBoxes; i += 8 ) {
+		const int count = numBoxes - i;
+		__m256 b[12];
+
+		for ( int k = 0; k < 12; k++ ) {
+			if ( count >= 8 ) {
+				b[k] = _mm256_loadu_ps( rows[k] + i );
+			} else {
+				// repeat the last box
+				for ( int n = 0; n < 8; n++ ) {
+					pad[n] = rows[k][i + Min( n, count - 1 )];
+				}
+				b[k] = _mm256_loadu_ps( pad );
+			}
+		}
+
+		__m256 culled = zero;
+		for ( int j = 0; j < numPlanes; j++ ) {
+			const float *p = planes[j].ToFloatPtr();
+			const __m256 px = _mm256_set1_ps( p[0] );
+			const __m256 py = _mm256_set1_ps( p[1] );
+			const __m256 pz = _mm256_set1_ps( p[2] );
+
+			__m256 d = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( px, b[0] ), _mm256_mul_ps( py, b[1] ) ), _mm256_mul_ps( pz, b[2] ) ), _mm256_set1_ps( p[3] ) );
+			__m256 r0 = _mm256_and_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( px, b[3] ), _mm256_mul_ps( py, b[4] ) ), _mm256_mul_ps( pz, b[5] ) ), absMask );
+			__m256 r1 = _mm256_and_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( px, b[6] ), _mm256_mul_ps( py, b[7] ) ), _mm256_mul_ps( pz, b[8] ) ), absMask );
+			__m256 r2 = _mm256_and_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( px, b[9] ), _mm256_mul_ps( py, b[10] ) ), _mm256_mul_ps( pz, b[11] ) ), absMask );
+
+			culled = _mm256_or_ps( culled, _mm256_cmp_ps( _mm256_sub_ps( d, _mm256_add_ps( _mm256_add_ps( r0, r1 ), r2 ) ), zero, _CMP_GE_OQ ) );
+			if ( _mm256_movemask_ps( culled ) == 0xFF ) {
+				break;
+			}
+		}
+
+		dword visible = ~_mm256_movemask_ps( culled ) & ( ( 1 << Min( count, 8 ) ) - 1 );
+		visibleBits[i >> 5] |= visible << ( i & 31 );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixedSoundToSamples
+============
+*/
+AVX2_TARGET void VPCALL idSIMD_AVX2::MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples ) {
+	const __m256 mn = _mm256_set1_ps( -32768.0f );
+	const __m256 mx = _mm256_set1_ps( 32767.0f );
+	int i;
+
+	for ( i = 0; i + 8 <= numSamples; i += 8 ) {
+		__m256 v = _mm256_min_ps( _mm256_max_ps( _mm256_loadu_ps( mixBuffer + i ), mn ), mx );
+		__m256i s = _mm256_cvttps_epi32( v );
+		__m128i p = _mm_packs_epi32( _mm256_castsi256_si128( s ), _mm256_extracti128_si256( s, 1 ) );
+		_mm_storeu_si128( (__m128i *) ( samples + i ), p );
+	}
+	for ( ; i < numSamples; i++ ) {
+		if ( mixBuffer[i] <= -32768.0f ) {
+			samples[i] = -32768;
+		} else if ( mixBuffer[i] >= 32767.0f ) {
+			samples[i] = 32767;
+		} else {
+			samples[i] = (short) mixBuffer[i];
+		}
+	}
+}
+
+#endif /* ID_SIMD_AVX2 */
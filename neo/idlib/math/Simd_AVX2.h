@@ -0,0 +1,104 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __MATH_SIMD_AVX2_H__
+#define __MATH_SIMD_AVX2_H__
+
+#include "idlib/math/Simd_SSE3.h"
+
+/*
+===============================================================================
+
+	AVX2 implementation of idSIMDProcessor
+
+	Only selected when the CPU and the OS support AVX2, the code is compiled
+	per function for AVX2 so the rest of the engine does not require it.
+
+===============================================================================
+*/
+
+#if defined(__GNUC__) && defined(__SSE2__) && ( defined(__i386__) || defined(__x86_64__) )
+#define ID_SIMD_AVX2
+#endif
+
+class idSIMD_AVX2 : public idSIMD_SSE3 {
+public:
+#if defined(ID_SIMD_AVX2)
+	using idSIMD_SSE2::Dot;
+	using idSIMD_SSE2::MinMax;
+
+	virtual const char * VPCALL GetName( void ) const;
+
+	virtual void VPCALL Add( float *dst,			const float constant,	const float *src,		const int count );
+	virtual void VPCALL Add( float *dst,			const float *src0,		const float *src1,		const int count );
+	virtual void VPCALL Sub( float *dst,			const float constant,	const float *src,		const int count );
+	virtual void VPCALL Sub( float *dst,			const float *src0,		const float *src1,		const int count );
+	virtual void VPCALL Mul( float *dst,			const float constant,	const float *src,		const int count );
+	virtual void VPCALL Mul( float *dst,			const float *src0,		const float *src1,		const int count );
+	virtual void VPCALL Div( float *dst,			const float constant,	const float *src,		const int count );
+	virtual void VPCALL Div( float *dst,			const float *src0,		const float *src1,		const int count );
+	virtual void VPCALL MulAdd( float *dst,			const float constant,	const float *src,		const int count );
+	virtual void VPCALL MulAdd( float *dst,			const float *src0,		const float *src1,		const int count );
+	virtual void VPCALL MulSub( float *dst,			const float constant,	const float *src,		const int count );
+	virtual void VPCALL MulSub( float *dst,			const float *src0,		const float *src1,		const int count );
+
+	virtual void VPCALL Dot( float &dot,			const float *src1,		const float *src2,		const int count );
+
+	virtual void VPCALL CmpGT( byte *dst,			const float *src0,		const float constant,	const int count );
+	virtual void VPCALL CmpGT( byte *dst,			const byte bitNum,		const float *src0,		const float constant,	const int count );
+	virtual void VPCALL CmpGE( byte *dst,			const float *src0,		const float constant,	const int count );
+	virtual void VPCALL CmpGE( byte *dst,			const byte bitNum,		const float *src0,		const float constant,	const int count );
+	virtual void VPCALL CmpLT( byte *dst,			const float *src0,		const float constant,	const int count );
+	virtual void VPCALL CmpLT( byte *dst,			const byte bitNum,		const float *src0,		const float constant,	const int count );
+	virtual void VPCALL CmpLE( byte *dst,			const float *src0,		const float constant,	const int count );
+	virtual void VPCALL CmpLE( byte *dst,			const byte bitNum,		const float *src0,		const float constant,	const int count );
+
+	virtual void VPCALL MinMax( float &min,			float &max,				const float *src,		const int count );
+
+	virtual void VPCALL Clamp( float *dst,			const float *src,		const float min,		const float max,		const int count );
+	virtual void VPCALL ClampMin( float *dst,		const float *src,		const float min,		const int count );
+	virtual void VPCALL ClampMax( float *dst,		const float *src,		const float max,		const int count );
+
+	virtual void VPCALL Zero16( float *dst,			const int count );
+	virtual void VPCALL Negate16( float *dst,		const int count );
+	virtual void VPCALL Copy16( float *dst,			const float *src,		const int count );
+	virtual void VPCALL Add16( float *dst,			const float *src1,		const float *src2,		const int count );
+	virtual void VPCALL Sub16( float *dst,			const float *src1,		const float *src2,		const int count );
+	virtual void VPCALL Mul16( float *dst,			const float *src1,		const float constant,	const int count );
+	virtual void VPCALL AddAssign16( float *dst,	const float *src,		const int count );
+	virtual void VPCALL SubAssign16( float *dst,	const float *src,		const int count );
+	virtual void VPCALL MulAssign16( float *dst,	const float constant,	const int count );
+
+	virtual void VPCALL CullBoxes( dword *visibleBits, const idPlane *planes, const int numPlanes, const cullBoxes_t &boxes, const int numBoxes );
+
+	virtual void VPCALL MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples );
+
+#endif
+};
+
+#endif /* !__MATH_SIMD_AVX2_H__ */
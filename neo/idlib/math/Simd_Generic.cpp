@@ -2849,6 +2849,259 @@ int VPCALL idSIMD_Generic::CreateVertexProgramShadowCache( idVec4 *vertexCache,
 	return numVerts * 2;
 }
 
+/*
+============
+idSIMD_Generic::CullBoxes
+
+  Sets the bit of every box that is not completely on the positive side of one of the planes.
+  The box corner closest to the back of a plane is at the plane distance of the center minus
+  the sum of the absolute dot products of the plane normal with the scaled box axes.
+============
+*/
+void VPCALL idSIMD_Generic::CullBoxes( dword *visibleBits, const idPlane *planes, const int numPlanes, const cullBoxes_t &boxes, const int numBoxes ) {
+	int i, j;
+
+	memset( visibleBits, 0, ( ( numBoxes + 31 ) >> 5 ) * sizeof( visibleBits[0] ) );
+
+	for ( i = 0; i < numBoxes; i++ ) {
+		for ( j = 0; j < numPlanes; j++ ) {
+			const float *p = planes[j].ToFloatPtr();
+			float d = p[0] * boxes.center[0][i] + p[1] * boxes.center[1][i] + p[2] * boxes.center[2][i] + p[3];
+			float r0 = idMath::Fabs( p[0] * boxes.axis[0][0][i] + p[1] * boxes.axis[0][1][i] + p[2] * boxes.axis[0][2][i] );
+			float r1 = idMath::Fabs( p[0] * boxes.axis[1][0][i] + p[1] * boxes.axis[1][1][i] + p[2] * boxes.axis[1][2][i] );
+			float r2 = idMath::Fabs( p[0] * boxes.axis[2][0][i] + p[1] * boxes.axis[2][1][i] + p[2] * boxes.axis[2][2][i] );
+			if ( d - ( r0 + r1 + r2 ) >= 0.0f ) {
+				break;
+			}
+		}
+		if ( j == numPlanes ) {
+			visibleBits[i >> 5] |= 1 << ( i & 31 );
+		}
+	}
+}
+
+/*
+============
+idSIMD_Generic::TransformVertsSoA
+
+  Same as TransformVerts but only writes the position stream.
+============
+*/
+void VPCALL idSIMD_Generic::TransformVertsSoA( idVec3 *xyz, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	int i, j;
+	const byte *jointsPtr = (byte *)joints;
+
+	for( j = i = 0; i < numVerts; i++ ) {
+		idVec3 v;
+
+		v = ( *(idJointMat *) ( jointsPtr + index[j*2+0] ) ) * weights[j];
+		while( index[j*2+1] == 0 ) {
+			j++;
+			v += ( *(idJointMat *) ( jointsPtr + index[j*2+0] ) ) * weights[j];
+		}
+		j++;
+
+		xyz[i] = v;
+	}
+}
+
+/*
+============
+idSIMD_Generic::DeriveTangentsSoA
+
+  Same as DeriveTangents but reads the position and texture coordinate
+  streams and writes the normal and tangent streams.
+============
+*/
+void VPCALL idSIMD_Generic::DeriveTangentsSoA( idPlane *planes, const drawVertStreams_s &streams, const int numVerts, const int *indexes, const int numIndexes ) {
+	int i;
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	const idVec3 *xyz = streams.xyz;
+	const idVec2 *st = streams.st;
+	idVec3 *normal = streams.normal;
+	idVec3 *tangent0 = streams.tangents[0];
+	idVec3 *tangent1 = streams.tangents[1];
+
+	idPlane *planesPtr = planes;
+	for ( i = 0; i < numIndexes; i += 3 ) {
+		unsigned int signBit;
+		float d0[5], d1[5], f, area;
+		idVec3 n, t0, t1;
+
+		int v0 = indexes[i + 0];
+		int v1 = indexes[i + 1];
+		int v2 = indexes[i + 2];
+
+		d0[0] = xyz[v1][0] - xyz[v0][0];
+		d0[1] = xyz[v1][1] - xyz[v0][1];
+		d0[2] = xyz[v1][2] - xyz[v0][2];
+		d0[3] = st[v1][0] - st[v0][0];
+		d0[4] = st[v1][1] - st[v0][1];
+
+		d1[0] = xyz[v2][0] - xyz[v0][0];
+		d1[1] = xyz[v2][1] - xyz[v0][1];
+		d1[2] = xyz[v2][2] - xyz[v0][2];
+		d1[3] = st[v2][0] - st[v0][0];
+		d1[4] = st[v2][1] - st[v0][1];
+
+		// normal
+		n[0] = d1[1] * d0[2] - d1[2] * d0[1];
+		n[1] = d1[2] * d0[0] - d1[0] * d0[2];
+		n[2] = d1[0] * d0[1] - d1[1] * d0[0];
+
+		f = idMath::RSqrt( n.x * n.x + n.y * n.y + n.z * n.z );
+
+		n.x *= f;
+		n.y *= f;
+		n.z *= f;
+
+		planesPtr->SetNormal( n );
+		planesPtr->FitThroughPoint( xyz[v0] );
+		planesPtr++;
+
+		// area sign bit
+		area = d0[3] * d1[4] - d0[4] * d1[3];
+		signBit = ( *(unsigned int *)&area ) & ( 1 << 31 );
+
+		// first tangent
+		t0[0] = d0[0] * d1[4] - d0[4] * d1[0];
+		t0[1] = d0[1] * d1[4] - d0[4] * d1[1];
+		t0[2] = d0[2] * d1[4] - d0[4] * d1[2];
+
+		f = idMath::RSqrt( t0.x * t0.x + t0.y * t0.y + t0.z * t0.z );
+		*(unsigned int *)&f ^= signBit;
+
+		t0.x *= f;
+		t0.y *= f;
+		t0.z *= f;
+
+		// second tangent
+		t1[0] = d0[3] * d1[0] - d0[0] * d1[3];
+		t1[1] = d0[3] * d1[1] - d0[1] * d1[3];
+		t1[2] = d0[3] * d1[2] - d0[2] * d1[3];
+
+		f = idMath::RSqrt( t1.x * t1.x + t1.y * t1.y + t1.z * t1.z );
+		*(unsigned int *)&f ^= signBit;
+
+		t1.x *= f;
+		t1.y *= f;
+		t1.z *= f;
+
+		for ( int j = 0; j < 3; j++ ) {
+			int v = indexes[i + j];
+			if ( used[v] ) {
+				normal[v] += n;
+				tangent0[v] += t0;
+				tangent1[v] += t1;
+			} else {
+				normal[v] = n;
+				tangent0[v] = t0;
+				tangent1[v] = t1;
+				used[v] = true;
+			}
+		}
+	}
+}
+
+/*
+============
+idSIMD_Generic::DeriveUnsmoothedTangentsSoA
+
+  Same as DeriveUnsmoothedTangents but on the vertex streams.
+============
+*/
+void VPCALL idSIMD_Generic::DeriveUnsmoothedTangentsSoA( const drawVertStreams_s &streams, const dominantTri_s *dominantTris, const int numVerts ) {
+	const idVec3 *xyz = streams.xyz;
+	const idVec2 *st = streams.st;
+
+	for ( int i = 0; i < numVerts; i++ ) {
+#ifndef DERIVE_UNSMOOTHED_BITANGENT
+		float d3, d8;
+#endif
+		float d0, d1, d2, d4;
+		float d5, d6, d7, d9;
+		float s0, s1, s2;
+		float n0, n1, n2;
+		float t0, t1, t2;
+		float t3, t4, t5;
+
+		const dominantTri_s &dt = dominantTris[i];
+		const int b = dt.v2;
+		const int c = dt.v3;
+
+		d0 = xyz[b][0] - xyz[i][0];
+		d1 = xyz[b][1] - xyz[i][1];
+		d2 = xyz[b][2] - xyz[i][2];
+#ifndef DERIVE_UNSMOOTHED_BITANGENT
+		d3 = st[b][0] - st[i][0];
+#endif
+		d4 = st[b][1] - st[i][1];
+
+		d5 = xyz[c][0] - xyz[i][0];
+		d6 = xyz[c][1] - xyz[i][1];
+		d7 = xyz[c][2] - xyz[i][2];
+#ifndef DERIVE_UNSMOOTHED_BITANGENT
+		d8 = st[c][0] - st[i][0];
+#endif
+		d9 = st[c][1] - st[i][1];
+
+		s0 = dt.normalizationScale[0];
+		s1 = dt.normalizationScale[1];
+		s2 = dt.normalizationScale[2];
+
+		n0 = s2 * ( d6 * d2 - d7 * d1 );
+		n1 = s2 * ( d7 * d0 - d5 * d2 );
+		n2 = s2 * ( d5 * d1 - d6 * d0 );
+
+		t0 = s0 * ( d0 * d9 - d4 * d5 );
+		t1 = s0 * ( d1 * d9 - d4 * d6 );
+		t2 = s0 * ( d2 * d9 - d4 * d7 );
+
+#ifndef DERIVE_UNSMOOTHED_BITANGENT
+		t3 = s1 * ( d3 * d5 - d0 * d8 );
+		t4 = s1 * ( d3 * d6 - d1 * d8 );
+		t5 = s1 * ( d3 * d7 - d2 * d8 );
+#else
+		t3 = s1 * ( n2 * t1 - n1 * t2 );
+		t4 = s1 * ( n0 * t2 - n2 * t0 );
+		t5 = s1 * ( n1 * t0 - n0 * t1 );
+#endif
+
+		streams.normal[i].Set( n0, n1, n2 );
+		streams.tangents[0][i].Set( t0, t1, t2 );
+		streams.tangents[1][i].Set( t3, t4, t5 );
+	}
+}
+
+/*
+============
+idSIMD_Generic::NormalizeTangentsSoA
+
+  Same as NormalizeTangents but on the vertex streams.
+============
+*/
+void VPCALL idSIMD_Generic::NormalizeTangentsSoA( const drawVertStreams_s &streams, const int numVerts ) {
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		idVec3 &v = streams.normal[i];
+		float f;
+
+		f = idMath::RSqrt( v.x * v.x + v.y * v.y + v.z * v.z );
+		v.x *= f; v.y *= f; v.z *= f;
+
+		for ( int j = 0; j < 2; j++ ) {
+			idVec3 &t = streams.tangents[j][i];
+
+			t -= ( t * v ) * v;
+			f = idMath::RSqrt( t.x * t.x + t.y * t.y + t.z * t.z );
+			t.x *= f; t.y *= f; t.z *= f;
+		}
+	}
+}
+
 /*
 ============
 idSIMD_Generic::UpSamplePCMTo44kHz
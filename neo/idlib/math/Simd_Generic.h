@@ -126,6 +126,11 @@ public:
 	virtual void VPCALL CreateSpecularTextureCoords( idVec4 *texCoords, const idVec3 &lightOrigin, const idVec3 &viewOrigin, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes );
 	virtual int  VPCALL CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts );
 	virtual int  VPCALL CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts );
+	virtual void VPCALL CullBoxes( dword *visibleBits, const idPlane *planes, const int numPlanes, const cullBoxes_t &boxes, const int numBoxes );
+	virtual void VPCALL TransformVertsSoA( idVec3 *xyz, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights );
+	virtual void VPCALL DeriveTangentsSoA( idPlane *planes, const drawVertStreams_s &streams, const int numVerts, const int *indexes, const int numIndexes );
+	virtual void VPCALL DeriveUnsmoothedTangentsSoA( const drawVertStreams_s &streams, const dominantTri_s *dominantTris, const int numVerts );
+	virtual void VPCALL NormalizeTangentsSoA( const drawVertStreams_s &streams, const int numVerts );
 
 	virtual void VPCALL UpSamplePCMTo44kHz( float *dest, const short *pcm, const int numSamples, const int kHz, const int numChannels );
 	virtual void VPCALL UpSampleOGGTo44kHz( float *dest, const float * const *ogg, const int numSamples, const int kHz, const int numChannels );
@@ -39,9 +39,130 @@ If you have questions concerning this license or the applicable additional terms
 
 #include <emmintrin.h>
 
+#include "idlib/geometry/DrawVert.h"
+#include "idlib/geometry/JointTransform.h"
+#include "idlib/math/Vector.h"
+#include "idlib/math/Plane.h"
+#include "idlib/math/Math.h"
+#include "idlib/math/Quat.h"
+#include "idlib/math/Matrix.h"
+#include "renderer/Model.h"
+
 #define SHUFFLEPS( x, y, z, w )		(( (x) & 3 ) << 6 | ( (y) & 3 ) << 4 | ( (z) & 3 ) << 2 | ( (w) & 3 ))
 #define R_SHUFFLEPS( x, y, z, w )	(( (w) & 3 ) << 6 | ( (z) & 3 ) << 4 | ( (y) & 3 ) << 2 | ( (x) & 3 ))
 
+/*
+  All kernels below evaluate their expressions in exactly the same order and
+  precision as idSIMD_Generic so the results are bit identical to the generic
+  code. Where the generic code uses double precision the double lanes are
+  used as well. Tails that do not fill a full register are done with scalar code.
+
+  These stay on the generic code:
+
+  Memcpy, Memset
+    the generic code calls the C library which already picks vector code for the CPU
+  MatX_MultiplyMatX, MatX_TransposeMultiplyMatX
+    the generic code sums in double precision with a different order for each of the
+    special cased matrix sizes
+  MatX_LowerTriangularSolve, MatX_LowerTriangularSolveTranspose, MatX_LDLTFactor
+    every element depends on the ones solved before it, the old SSE2 versions of the
+    solvers below were slower than the generic code
+  BlendJoints
+    idQuat::Slerp branches per joint on the angle between the quaternions and uses
+    the table seeded idMath::InvSqrt, so the lanes would take different paths
+  ConvertJointMatsToJointQuats
+    branches per joint on the trace and the largest diagonal element and also uses
+    the table seeded idMath::InvSqrt
+*/
+
+/*
+============
+SSE2_Load3
+
+  loads three floats without touching the memory past the last one
+============
+*/
+static ID_INLINE __m128 SSE2_Load3( const float *p ) {
+	__m128 xy = _mm_castpd_ps( _mm_load_sd( (const double *) p ) );
+	return _mm_movelh_ps( xy, _mm_load_ss( p + 2 ) );
+}
+
+/*
+============
+SSE2_Store3
+============
+*/
+static ID_INLINE void SSE2_Store3( float *p, const __m128 v ) {
+	_mm_store_sd( (double *) p, _mm_castps_pd( v ) );
+	_mm_store_ss( p + 2, _mm_movehl_ps( v, v ) );
+}
+
+/*
+============
+SSE2_Deinterleave3
+
+  turns four consecutive idVec3 into x, y and z registers
+============
+*/
+static ID_INLINE void SSE2_Deinterleave3( const float *p, __m128 &x, __m128 &y, __m128 &z ) {
+	__m128 a = _mm_loadu_ps( p + 0 );
+	__m128 b = _mm_loadu_ps( p + 4 );
+	__m128 c = _mm_loadu_ps( p + 8 );
+	x = _mm_shuffle_ps( a, _mm_shuffle_ps( b, c, R_SHUFFLEPS( 2, 2, 1, 1 ) ), R_SHUFFLEPS( 0, 3, 0, 2 ) );
+	y = _mm_shuffle_ps( _mm_shuffle_ps( a, b, R_SHUFFLEPS( 1, 1, 0, 0 ) ), _mm_shuffle_ps( b, c, R_SHUFFLEPS( 3, 3, 2, 2 ) ), R_SHUFFLEPS( 0, 2, 0, 2 ) );
+	z = _mm_shuffle_ps( _mm_shuffle_ps( a, b, R_SHUFFLEPS( 2, 2, 1, 1 ) ), c, R_SHUFFLEPS( 0, 2, 0, 3 ) );
+}
+
+/*
+============
+SSE2_LoadXYZ
+
+  x, y and z of four draw verts
+============
+*/
+static ID_INLINE void SSE2_LoadXYZ( const idDrawVert *v, __m128 &x, __m128 &y, __m128 &z ) {
+	__m128 r0 = _mm_loadu_ps( v[0].xyz.ToFloatPtr() );
+	__m128 r1 = _mm_loadu_ps( v[1].xyz.ToFloatPtr() );
+	__m128 r2 = _mm_loadu_ps( v[2].xyz.ToFloatPtr() );
+	__m128 r3 = _mm_loadu_ps( v[3].xyz.ToFloatPtr() );
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	x = r0;
+	y = r1;
+	z = r2;
+}
+
+/*
+============
+SSE2_CmpToBytes
+
+  packs 16 compare masks into 16 bytes that are 0 or 1 << bitNum
+============
+*/
+static ID_INLINE __m128i SSE2_CmpToBytes( const __m128 m0, const __m128 m1, const __m128 m2, const __m128 m3, const __m128i bit ) {
+	__m128i lo = _mm_packs_epi32( _mm_castps_si128( m0 ), _mm_castps_si128( m1 ) );
+	__m128i hi = _mm_packs_epi32( _mm_castps_si128( m2 ), _mm_castps_si128( m3 ) );
+	return _mm_and_si128( _mm_packs_epi16( lo, hi ), bit );
+}
+
+/*
+============
+SSE2_ZeroFixup
+
+  _mm_min_ps and _mm_max_ps see -0.0f and 0.0f as equal, the generic code keeps the first zero it finds
+============
+*/
+static ID_INLINE float SSE2_ZeroFixup( float value, const float *src, const int stride, const int count ) {
+	if ( value != 0.0f ) {
+		return value;
+	}
+	for ( int i = 0; i < count; i++ ) {
+		if ( src[i*stride] == 0.0f ) {
+			return src[i*stride];
+		}
+	}
+	return value;
+}
+
 /*
 ============
 idSIMD_SSE2::GetName
@@ -51,191 +172,2279 @@ const char * idSIMD_SSE2::GetName( void ) const {
 	return "MMX & SSE & SSE2";
 }
 
+#define SSE2_LOOP4( VECOP, OPER )											\
+	int i;																	\
+	for ( i = 0; i + 4 <= count; i += 4 ) {									\
+		VECOP;																\
+	}																		\
+	for ( ; i < count; i++ ) {												\
+		OPER;																\
+	}
+
 /*
 ============
-idSIMD_SSE::CmpLT
+idSIMD_SSE2::Add
 
-  dst[i] |= ( src0[i] < constant ) << bitNum;
+  dst[i] = constant + src[i];
 ============
 */
-void VPCALL idSIMD_SSE2::CmpLT( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
-	int i, cnt, pre, post;
-	float *aligned;
-	__m128 xmm0, xmm1;
-	__m128i xmm0i;
-	int cnt_l;
-	char *src0_p;
-	char *constant_p;
-	char *dst_p;
-	int mask_l;
-	int dst_l;
-
-	/* if the float array is not aligned on a 4 byte boundary */
-	if ( ptrdiff_t(src0) & 3 ) {
-		/* unaligned memory access */
-		pre = 0;
-		cnt = count >> 2;
-		post = count - (cnt<<2);
-
-	/*
-		__asm	mov			edx, cnt
-		__asm	test		edx, edx
-		__asm	je			doneCmp
-	*/
-		cnt_l = cnt;
-		if(cnt_l != 0) {
-	/*
-		__asm	push		ebx
-		__asm	neg			edx
-		__asm	mov			esi, src0
-		__asm	prefetchnta	[esi+64]
-		__asm	movss		xmm1, constant
-		__asm	shufps		xmm1, xmm1, R_SHUFFLEPS( 0, 0, 0, 0 )
-		__asm	mov			edi, dst
-		__asm	mov			cl, bitNum
-	*/
-			cnt_l = -cnt_l;
-			src0_p = (char *) src0;
-			_mm_prefetch(src0_p+64, _MM_HINT_NTA);
-			constant_p = (char *) &constant;
-			xmm1 = _mm_load_ss((float *)constant_p);
-			xmm1 = _mm_shuffle_ps(xmm1, xmm1, R_SHUFFLEPS( 0, 0, 0, 0 ));
-			dst_p = (char *)dst;
-	/*
-			__asm loopNA:
-	*/
-			do {
-	/*
-		__asm	movups		xmm0, [esi]
-		__asm	prefetchnta	[esi+128]
-		__asm	cmpltps		xmm0, xmm1
-		__asm	movmskps	eax, xmm0																												\
-		__asm	mov			ah, al
-		__asm	shr			ah, 1
-		__asm	mov			bx, ax
-		__asm	shl			ebx, 14
-		__asm	mov			bx, ax
-		__asm	and			ebx, 0x01010101
-		__asm	shl			ebx, cl
-		__asm	or			ebx, dword ptr [edi]
-		__asm	mov			dword ptr [edi], ebx
-		__asm	add			esi, 16
-		__asm	add			edi, 4
-		__asm	inc			edx
-		__asm	jl			loopNA
-		__asm	pop			ebx
-	*/
-				xmm0 = _mm_loadu_ps((float *) src0_p);
-				_mm_prefetch(src0_p+128, _MM_HINT_NTA);
-				xmm0 = _mm_cmplt_ps(xmm0, xmm1);
-				// Simplify using SSE2
-				xmm0i = (__m128i) xmm0;
-				xmm0i = _mm_packs_epi32(xmm0i, xmm0i);
-				xmm0i = _mm_packs_epi16(xmm0i, xmm0i);
-				mask_l = _mm_cvtsi128_si32(xmm0i);
-				// End
-				mask_l = mask_l &  0x01010101;
-				mask_l = mask_l << bitNum;
-				dst_l  = *((int *) dst_p);
-				mask_l = mask_l | dst_l;
-				*((int *) dst_p) = mask_l;
-				src0_p = src0_p + 16;
-				dst_p = dst_p + 4;
-				cnt_l = cnt_l + 1;
-			} while (cnt_l < 0);
-		}
+void VPCALL idSIMD_SSE2::Add( float *dst, const float constant, const float *src, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( src + i ), c ) ), dst[i] = src[i] + constant )
+}
+
+/*
+============
+idSIMD_SSE2::Add
+
+  dst[i] = src0[i] + src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2::Add( float *dst, const float *src0, const float *src1, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( src0 + i ), _mm_loadu_ps( src1 + i ) ) ), dst[i] = src0[i] + src1[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Sub
+
+  dst[i] = constant - src[i];
+============
+*/
+void VPCALL idSIMD_SSE2::Sub( float *dst, const float constant, const float *src, const int count ) {
+	// a single float subtraction rounds the same as the generic double subtraction
+	const __m128 c = _mm_set1_ps( constant );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_sub_ps( c, _mm_loadu_ps( src + i ) ) ), dst[i] = constant - src[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Sub
+
+  dst[i] = src0[i] - src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2::Sub( float *dst, const float *src0, const float *src1, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_sub_ps( _mm_loadu_ps( src0 + i ), _mm_loadu_ps( src1 + i ) ) ), dst[i] = src0[i] - src1[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Mul
+
+  dst[i] = constant * src[i];
+============
+*/
+void VPCALL idSIMD_SSE2::Mul( float *dst, const float constant, const float *src, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_mul_ps( c, _mm_loadu_ps( src + i ) ) ), dst[i] = constant * src[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Mul
+
+  dst[i] = src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2::Mul( float *dst, const float *src0, const float *src1, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_mul_ps( _mm_loadu_ps( src0 + i ), _mm_loadu_ps( src1 + i ) ) ), dst[i] = src0[i] * src1[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Div
+
+  dst[i] = constant / divisor[i];
+============
+*/
+void VPCALL idSIMD_SSE2::Div( float *dst, const float constant, const float *divisor, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_div_ps( c, _mm_loadu_ps( divisor + i ) ) ), dst[i] = constant / divisor[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Div
+
+  dst[i] = src0[i] / src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2::Div( float *dst, const float *src0, const float *src1, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_div_ps( _mm_loadu_ps( src0 + i ), _mm_loadu_ps( src1 + i ) ) ), dst[i] = src0[i] / src1[i] )
+}
+
+/*
+============
+SSE2_MulAddDouble
+
+  dst + c * src with the intermediate in double precision like the generic code
+============
+*/
+static ID_INLINE __m128 SSE2_MulAddDouble( const __m128 dst, const __m128d c, const __m128 src, const bool subtract ) {
+	__m128d d0 = _mm_cvtps_pd( dst );
+	__m128d d1 = _mm_cvtps_pd( _mm_movehl_ps( dst, dst ) );
+	__m128d p0 = _mm_mul_pd( c, _mm_cvtps_pd( src ) );
+	__m128d p1 = _mm_mul_pd( c, _mm_cvtps_pd( _mm_movehl_ps( src, src ) ) );
+	if ( subtract ) {
+		d0 = _mm_sub_pd( d0, p0 );
+		d1 = _mm_sub_pd( d1, p1 );
+	} else {
+		d0 = _mm_add_pd( d0, p0 );
+		d1 = _mm_add_pd( d1, p1 );
 	}
-	else {
-		/* aligned memory access */
-		aligned = (float *) ((ptrdiff_t(src0) + 15) & ~15);
-		if ( ptrdiff_t(aligned) > ptrdiff_t(src0) + count ) {
-			pre = count;
-			post = 0;
-		}
-		else {
-			pre = aligned - src0;
-			cnt = (count - pre) >> 2;
-			post = count - pre - (cnt<<2);
-	/*
-			__asm	mov			edx, cnt
-			__asm	test		edx, edx
-			__asm	je			doneCmp
-	*/
-			cnt_l = cnt;
-			if(cnt_l != 0) {
-	/*
-			__asm	push		ebx
-			__asm	neg			edx
-			__asm	mov			esi, aligned
-			__asm	prefetchnta	[esi+64]
-			__asm	movss		xmm1, constant
-			__asm	shufps		xmm1, xmm1, R_SHUFFLEPS( 0, 0, 0, 0 )
-			__asm	mov			edi, dst
-			__asm	add			edi, pre
-			__asm	mov			cl, bitNum
-	*/
-				cnt_l = -cnt_l;
-				src0_p = (char *) src0;
-				_mm_prefetch(src0_p+64, _MM_HINT_NTA);
-				constant_p = (char *) &constant;
-				xmm1 = _mm_load_ss((float *)constant_p);
-				xmm1 = _mm_shuffle_ps(xmm1, xmm1, R_SHUFFLEPS( 0, 0, 0, 0 ));
-				dst_p = (char *)dst;
-				dst_p = dst_p + pre;
-	/*
-			__asm loopA:
-	*/
-			do {
-	/*
-			__asm	movaps		xmm0, [esi]
-			__asm	prefetchnta	[esi+128]
-			__asm	cmpltps		xmm0, xmm1
-			__asm	movmskps	eax, xmm0																											\
-			__asm	mov			ah, al
-			__asm	shr			ah, 1
-			__asm	mov			bx, ax
-			__asm	shl			ebx, 14
-			__asm	mov			bx, ax
-			__asm	and			ebx, 0x01010101
-			__asm	shl			ebx, cl
-			__asm	or			ebx, dword ptr [edi]
-			__asm	mov			dword ptr [edi], ebx
-			__asm	add			esi, 16
-			__asm	add			edi, 4
-			__asm	inc			edx
-			__asm	jl			loopA
-			__asm	pop			ebx
-	*/
-					xmm0 = _mm_load_ps((float *) src0_p);
-					_mm_prefetch(src0_p+128, _MM_HINT_NTA);
-					xmm0 = _mm_cmplt_ps(xmm0, xmm1);
-					// Simplify using SSE2
-					xmm0i = (__m128i) xmm0;
-					xmm0i = _mm_packs_epi32(xmm0i, xmm0i);
-					xmm0i = _mm_packs_epi16(xmm0i, xmm0i);
-					mask_l = _mm_cvtsi128_si32(xmm0i);
-					// End
-					mask_l = mask_l &  0x01010101;
-					mask_l = mask_l << bitNum;
-					dst_l  = *((int *) dst_p);
-					mask_l = mask_l | dst_l;
-					*((int *) dst_p) = mask_l;
-					src0_p = src0_p + 16;
-					dst_p = dst_p + 4;
-					cnt_l = cnt_l + 1;
-				} while (cnt_l < 0);
-			}
-		}
+	return _mm_movelh_ps( _mm_cvtpd_ps( d0 ), _mm_cvtpd_ps( d1 ) );
+}
+
+/*
+============
+idSIMD_SSE2::MulAdd
+
+  dst[i] += constant * src[i];
+============
+*/
+void VPCALL idSIMD_SSE2::MulAdd( float *dst, const float constant, const float *src, const int count ) {
+	const double dc = constant;
+	const __m128d c = _mm_set1_pd( dc );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, SSE2_MulAddDouble( _mm_loadu_ps( dst + i ), c, _mm_loadu_ps( src + i ), false ) ), dst[i] += dc * src[i] )
+}
+
+/*
+============
+idSIMD_SSE2::MulAdd
+
+  dst[i] += src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2::MulAdd( float *dst, const float *src0, const float *src1, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( dst + i ), _mm_mul_ps( _mm_loadu_ps( src0 + i ), _mm_loadu_ps( src1 + i ) ) ) ), dst[i] += src0[i] * src1[i] )
+}
+
+/*
+============
+idSIMD_SSE2::MulSub
+
+  dst[i] -= constant * src[i];
+============
+*/
+void VPCALL idSIMD_SSE2::MulSub( float *dst, const float constant, const float *src, const int count ) {
+	const double dc = constant;
+	const __m128d c = _mm_set1_pd( dc );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, SSE2_MulAddDouble( _mm_loadu_ps( dst + i ), c, _mm_loadu_ps( src + i ), true ) ), dst[i] -= dc * src[i] )
+}
+
+/*
+============
+idSIMD_SSE2::MulSub
+
+  dst[i] -= src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2::MulSub( float *dst, const float *src0, const float *src1, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_sub_ps( _mm_loadu_ps( dst + i ), _mm_mul_ps( _mm_loadu_ps( src0 + i ), _mm_loadu_ps( src1 + i ) ) ) ), dst[i] -= src0[i] * src1[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Dot
+
+  dst[i] = constant * src[i];
+============
+*/
+void VPCALL idSIMD_SSE2::Dot( float *dst, const idVec3 &constant, const idVec3 *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant.x );
+	const __m128 cy = _mm_set1_ps( constant.y );
+	const __m128 cz = _mm_set1_ps( constant.z );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		__m128 x, y, z;
+		SSE2_Deinterleave3( src[i].ToFloatPtr(), x, y, z );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) );
+		_mm_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i];
+	}
+}
+
+/*
+============
+idSIMD_SSE2::Dot
+
+  dst[i] = constant * src[i].Normal() + src[i][3];
+============
+*/
+void VPCALL idSIMD_SSE2::Dot( float *dst, const idVec3 &constant, const idPlane *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant.x );
+	const __m128 cy = _mm_set1_ps( constant.y );
+	const __m128 cz = _mm_set1_ps( constant.z );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		__m128 x = _mm_loadu_ps( src[i+0].ToFloatPtr() );
+		__m128 y = _mm_loadu_ps( src[i+1].ToFloatPtr() );
+		__m128 z = _mm_loadu_ps( src[i+2].ToFloatPtr() );
+		__m128 w = _mm_loadu_ps( src[i+3].ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( x, y, z, w );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) ), w );
+		_mm_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i].Normal() + src[i][3];
+	}
+}
+
+/*
+============
+idSIMD_SSE2::Dot
+
+  dst[i] = constant * src[i].xyz;
+============
+*/
+void VPCALL idSIMD_SSE2::Dot( float *dst, const idVec3 &constant, const idDrawVert *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant.x );
+	const __m128 cy = _mm_set1_ps( constant.y );
+	const __m128 cz = _mm_set1_ps( constant.z );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		__m128 x, y, z;
+		SSE2_LoadXYZ( src + i, x, y, z );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) );
+		_mm_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i].xyz;
+	}
+}
+
+/*
+============
+idSIMD_SSE2::Dot
+
+  dst[i] = constant.Normal() * src[i] + constant[3];
+============
+*/
+void VPCALL idSIMD_SSE2::Dot( float *dst, const idPlane &constant, const idVec3 *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant[0] );
+	const __m128 cy = _mm_set1_ps( constant[1] );
+	const __m128 cz = _mm_set1_ps( constant[2] );
+	const __m128 cd = _mm_set1_ps( constant[3] );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		__m128 x, y, z;
+		SSE2_Deinterleave3( src[i].ToFloatPtr(), x, y, z );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) ), cd );
+		_mm_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i] + constant[3];
+	}
+}
+
+/*
+============
+idSIMD_SSE2::Dot
+
+  dst[i] = constant.Normal() * src[i].Normal() + constant[3] * src[i][3];
+============
+*/
+void VPCALL idSIMD_SSE2::Dot( float *dst, const idPlane &constant, const idPlane *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant[0] );
+	const __m128 cy = _mm_set1_ps( constant[1] );
+	const __m128 cz = _mm_set1_ps( constant[2] );
+	const __m128 cd = _mm_set1_ps( constant[3] );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		__m128 x = _mm_loadu_ps( src[i+0].ToFloatPtr() );
+		__m128 y = _mm_loadu_ps( src[i+1].ToFloatPtr() );
+		__m128 z = _mm_loadu_ps( src[i+2].ToFloatPtr() );
+		__m128 w = _mm_loadu_ps( src[i+3].ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( x, y, z, w );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) ), _mm_mul_ps( cd, w ) );
+		_mm_storeu_ps( dst + i, d );
 	}
-	/*
-	doneCmp:
-	*/
-	float c = constant;
-	for ( i = 0; i < pre; i++ ) {
-		dst[i] |= ( src0[i] < c ) << bitNum;
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i].Normal() + constant[3] * src[i][3];
 	}
-	for ( i = count - post; i < count; i++ ) {
-		dst[i] |= ( src0[i] < c ) << bitNum;
+}
+
+/*
+============
+idSIMD_SSE2::Dot
+
+  dst[i] = constant.Normal() * src[i].xyz + constant[3];
+============
+*/
+void VPCALL idSIMD_SSE2::Dot( float *dst, const idPlane &constant, const idDrawVert *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant[0] );
+	const __m128 cy = _mm_set1_ps( constant[1] );
+	const __m128 cz = _mm_set1_ps( constant[2] );
+	const __m128 cd = _mm_set1_ps( constant[3] );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		__m128 x, y, z;
+		SSE2_LoadXYZ( src + i, x, y, z );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) ), cd );
+		_mm_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i].xyz + constant[3];
+	}
+}
+
+/*
+============
+idSIMD_SSE2::Dot
+
+  dst[i] = src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2::Dot( float *dst, const idVec3 *src0, const idVec3 *src1, const int count ) {
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		__m128 x0, y0, z0, x1, y1, z1;
+		SSE2_Deinterleave3( src0[i].ToFloatPtr(), x0, y0, z0 );
+		SSE2_Deinterleave3( src1[i].ToFloatPtr(), x1, y1, z1 );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x0, x1 ), _mm_mul_ps( y0, y1 ) ), _mm_mul_ps( z0, z1 ) );
+		_mm_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] * src1[i];
+	}
+}
+
+/*
+============
+idSIMD_SSE2::Dot
+
+  dot = src1[0] * src2[0] + src1[1] * src2[1] + src1[2] * src2[2] + ...
+
+  The four double precision partial sums of the generic code are kept in two registers.
+============
+*/
+void VPCALL idSIMD_SSE2::Dot( float &dot, const float *src1, const float *src2, const int count ) {
+	switch( count ) {
+		case 0:
+			dot = 0.0f;
+			return;
+		case 1:
+			dot = src1[0] * src2[0];
+			return;
+		case 2:
+			dot = src1[0] * src2[0] + src1[1] * src2[1];
+			return;
+		case 3:
+			dot = src1[0] * src2[0] + src1[1] * src2[1] + src1[2] * src2[2];
+			return;
+	}
+
+	__m128 p = _mm_mul_ps( _mm_loadu_ps( src1 ), _mm_loadu_ps( src2 ) );
+	__m128d s01 = _mm_cvtps_pd( p );
+	__m128d s23 = _mm_cvtps_pd( _mm_movehl_ps( p, p ) );
+	int i;
+
+	for ( i = 4; i < count - 7; i += 8 ) {
+		p = _mm_mul_ps( _mm_loadu_ps( src1 + i ), _mm_loadu_ps( src2 + i ) );
+		s01 = _mm_add_pd( s01, _mm_cvtps_pd( p ) );
+		s23 = _mm_add_pd( s23, _mm_cvtps_pd( _mm_movehl_ps( p, p ) ) );
+		p = _mm_mul_ps( _mm_loadu_ps( src1 + i + 4 ), _mm_loadu_ps( src2 + i + 4 ) );
+		s01 = _mm_add_pd( s01, _mm_cvtps_pd( p ) );
+		s23 = _mm_add_pd( s23, _mm_cvtps_pd( _mm_movehl_ps( p, p ) ) );
+	}
+
+	double s[4];
+	_mm_storeu_pd( s + 0, s01 );
+	_mm_storeu_pd( s + 2, s23 );
+
+	// same assignment of the remaining products to the partial sums as the generic code
+	switch( count - i ) {
+		case 7: s[0] += src1[i+6] * src2[i+6];
+		case 6: s[1] += src1[i+5] * src2[i+5];
+		case 5: s[2] += src1[i+4] * src2[i+4];
+		case 4: s[3] += src1[i+3] * src2[i+3];
+		case 3: s[0] += src1[i+2] * src2[i+2];
+		case 2: s[1] += src1[i+1] * src2[i+1];
+		case 1: s[2] += src1[i+0] * src2[i+0];
+		case 0: break;
+	}
+
+	double sum;
+	sum = s[3];
+	sum += s[2];
+	sum += s[1];
+	sum += s[0];
+	dot = sum;
+}
+
+#define SSE2_CMP( CMPOP, OPER, SHIFT )												\
+	const __m128 c = _mm_set1_ps( constant );										\
+	const __m128i bit = _mm_set1_epi8( (char) ( 1 << SHIFT ) );					\
+	int i;																			\
+	for ( i = 0; i + 16 <= count; i += 16 ) {										\
+		__m128 m0 = CMPOP( _mm_loadu_ps( src0 + i + 0 ), c );						\
+		__m128 m1 = CMPOP( _mm_loadu_ps( src0 + i + 4 ), c );						\
+		__m128 m2 = CMPOP( _mm_loadu_ps( src0 + i + 8 ), c );						\
+		__m128 m3 = CMPOP( _mm_loadu_ps( src0 + i + 12 ), c );						\
+		__m128i b = SSE2_CmpToBytes( m0, m1, m2, m3, bit );						\
+		OPER;																		\
+	}
+
+/*
+============
+idSIMD_SSE2::CmpGT
+
+  dst[i] = src0[i] > constant;
+============
+*/
+void VPCALL idSIMD_SSE2::CmpGT( byte *dst, const float *src0, const float constant, const int count ) {
+	SSE2_CMP( _mm_cmpgt_ps, _mm_storeu_si128( (__m128i *) ( dst + i ), b ), 0 )
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] > constant;
+	}
+}
+
+/*
+============
+idSIMD_SSE2::CmpGT
+
+  dst[i] |= ( src0[i] > constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_SSE2::CmpGT( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	SSE2_CMP( _mm_cmpgt_ps, _mm_storeu_si128( (__m128i *) ( dst + i ), _mm_or_si128( b, _mm_loadu_si128( (__m128i *) ( dst + i ) ) ) ), bitNum )
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] > constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_SSE2::CmpGE
+
+  dst[i] = src0[i] >= constant;
+============
+*/
+void VPCALL idSIMD_SSE2::CmpGE( byte *dst, const float *src0, const float constant, const int count ) {
+	SSE2_CMP( _mm_cmpge_ps, _mm_storeu_si128( (__m128i *) ( dst + i ), b ), 0 )
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] >= constant;
+	}
+}
+
+/*
+============
+idSIMD_SSE2::CmpGE
+
+  dst[i] |= ( src0[i] >= constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_SSE2::CmpGE( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	SSE2_CMP( _mm_cmpge_ps, _mm_storeu_si128( (__m128i *) ( dst + i ), _mm_or_si128( b, _mm_loadu_si128( (__m128i *) ( dst + i ) ) ) ), bitNum )
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] >= constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_SSE2::CmpLT
+
+  dst[i] = src0[i] < constant;
+============
+*/
+void VPCALL idSIMD_SSE2::CmpLT( byte *dst, const float *src0, const float constant, const int count ) {
+	SSE2_CMP( _mm_cmplt_ps, _mm_storeu_si128( (__m128i *) ( dst + i ), b ), 0 )
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] < constant;
+	}
+}
+
+/*
+============
+idSIMD_SSE2::CmpLT
+
+  dst[i] |= ( src0[i] < constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_SSE2::CmpLT( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	SSE2_CMP( _mm_cmplt_ps, _mm_storeu_si128( (__m128i *) ( dst + i ), _mm_or_si128( b, _mm_loadu_si128( (__m128i *) ( dst + i ) ) ) ), bitNum )
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] < constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_SSE2::CmpLE
+
+  dst[i] = src0[i] <= constant;
+============
+*/
+void VPCALL idSIMD_SSE2::CmpLE( byte *dst, const float *src0, const float constant, const int count ) {
+	SSE2_CMP( _mm_cmple_ps, _mm_storeu_si128( (__m128i *) ( dst + i ), b ), 0 )
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] <= constant;
+	}
+}
+
+/*
+============
+idSIMD_SSE2::CmpLE
+
+  dst[i] |= ( src0[i] <= constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_SSE2::CmpLE( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	SSE2_CMP( _mm_cmple_ps, _mm_storeu_si128( (__m128i *) ( dst + i ), _mm_or_si128( b, _mm_loadu_si128( (__m128i *) ( dst + i ) ) ) ), bitNum )
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] <= constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MinMax
+============
+*/
+void VPCALL idSIMD_SSE2::MinMax( float &min, float &max, const float *src, const int count ) {
+	__m128 mn = _mm_set1_ps( idMath::INFINITY );
+	__m128 mx = _mm_set1_ps( -idMath::INFINITY );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		__m128 v = _mm_loadu_ps( src + i );
+		mn = _mm_min_ps( v, mn );
+		mx = _mm_max_ps( v, mx );
+	}
+	for ( ; i < count; i++ ) {
+		__m128 v = _mm_set1_ps( src[i] );
+		mn = _mm_min_ps( v, mn );
+		mx = _mm_max_ps( v, mx );
+	}
+	mn = _mm_min_ps( mn, _mm_movehl_ps( mn, mn ) );
+	mn = _mm_min_ss( mn, _mm_shuffle_ps( mn, mn, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+	mx = _mm_max_ps( mx, _mm_movehl_ps( mx, mx ) );
+	mx = _mm_max_ss( mx, _mm_shuffle_ps( mx, mx, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+	min = SSE2_ZeroFixup( _mm_cvtss_f32( mn ), src, 1, count );
+	max = SSE2_ZeroFixup( _mm_cvtss_f32( mx ), src, 1, count );
+}
+
+/*
+============
+idSIMD_SSE2::MinMax
+============
+*/
+void VPCALL idSIMD_SSE2::MinMax( idVec2 &min, idVec2 &max, const idVec2 *src, const int count ) {
+	__m128 mn = _mm_set1_ps( idMath::INFINITY );
+	__m128 mx = _mm_set1_ps( -idMath::INFINITY );
+	int i;
+
+	for ( i = 0; i + 2 <= count; i += 2 ) {
+		__m128 v = _mm_loadu_ps( src[i].ToFloatPtr() );
+		mn = _mm_min_ps( v, mn );
+		mx = _mm_max_ps( v, mx );
+	}
+	if ( i < count ) {
+		__m128 v = _mm_castpd_ps( _mm_load1_pd( (const double *) src[i].ToFloatPtr() ) );
+		mn = _mm_min_ps( v, mn );
+		mx = _mm_max_ps( v, mx );
+	}
+	mn = _mm_min_ps( mn, _mm_movehl_ps( mn, mn ) );
+	mx = _mm_max_ps( mx, _mm_movehl_ps( mx, mx ) );
+	float t[4];
+	_mm_storeu_ps( t, _mm_movelh_ps( mn, mx ) );
+	for ( int j = 0; j < 2; j++ ) {
+		min[j] = SSE2_ZeroFixup( t[j+0], src->ToFloatPtr() + j, 2, count );
+		max[j] = SSE2_ZeroFixup( t[j+2], src->ToFloatPtr() + j, 2, count );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MinMax
+============
+*/
+void VPCALL idSIMD_SSE2::MinMax( idVec3 &min, idVec3 &max, const idVec3 *src, const int count ) {
+	__m128 mnx = _mm_set1_ps( idMath::INFINITY );
+	__m128 mny = mnx;
+	__m128 mnz = mnx;
+	__m128 mxx = _mm_set1_ps( -idMath::INFINITY );
+	__m128 mxy = mxx;
+	__m128 mxz = mxx;
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		__m128 x, y, z;
+		SSE2_Deinterleave3( src[i].ToFloatPtr(), x, y, z );
+		mnx = _mm_min_ps( x, mnx );
+		mny = _mm_min_ps( y, mny );
+		mnz = _mm_min_ps( z, mnz );
+		mxx = _mm_max_ps( x, mxx );
+		mxy = _mm_max_ps( y, mxy );
+		mxz = _mm_max_ps( z, mxz );
+	}
+
+	// reduce to ( x, y, z ) in the low lanes
+	__m128 mn, mx, tn = _mm_setzero_ps(), tx = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS( mnx, mny, mnz, tn );
+	_MM_TRANSPOSE4_PS( mxx, mxy, mxz, tx );
+	mn = _mm_min_ps( _mm_min_ps( mnx, mny ), _mm_min_ps( mnz, tn ) );
+	mx = _mm_max_ps( _mm_max_ps( mxx, mxy ), _mm_max_ps( mxz, tx ) );
+
+	for ( ; i < count; i++ ) {
+		__m128 v = SSE2_Load3( src[i].ToFloatPtr() );
+		mn = _mm_min_ps( v, mn );
+		mx = _mm_max_ps( v, mx );
+	}
+
+	float t[8];
+	_mm_storeu_ps( t + 0, mn );
+	_mm_storeu_ps( t + 4, mx );
+	for ( int j = 0; j < 3; j++ ) {
+		min[j] = SSE2_ZeroFixup( t[j+0], src->ToFloatPtr() + j, 3, count );
+		max[j] = SSE2_ZeroFixup( t[j+4], src->ToFloatPtr() + j, 3, count );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MinMax
+============
+*/
+void VPCALL idSIMD_SSE2::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int count ) {
+	__m128 mn = _mm_set1_ps( idMath::INFINITY );
+	__m128 mx = _mm_set1_ps( -idMath::INFINITY );
+
+	// the fourth lane picks up st[0] which is never used
+	for ( int i = 0; i < count; i++ ) {
+		__m128 v = _mm_loadu_ps( src[i].xyz.ToFloatPtr() );
+		mn = _mm_min_ps( v, mn );
+		mx = _mm_max_ps( v, mx );
+	}
+
+	float t[8];
+	_mm_storeu_ps( t + 0, mn );
+	_mm_storeu_ps( t + 4, mx );
+	const int stride = sizeof( idDrawVert ) / sizeof( float );
+	for ( int j = 0; j < 3; j++ ) {
+		min[j] = SSE2_ZeroFixup( t[j+0], src->xyz.ToFloatPtr() + j, stride, count );
+		max[j] = SSE2_ZeroFixup( t[j+4], src->xyz.ToFloatPtr() + j, stride, count );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MinMax
+============
+*/
+void VPCALL idSIMD_SSE2::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int *indexes, const int count ) {
+	__m128 mn = _mm_set1_ps( idMath::INFINITY );
+	__m128 mx = _mm_set1_ps( -idMath::INFINITY );
+
+	for ( int i = 0; i < count; i++ ) {
+		__m128 v = _mm_loadu_ps( src[indexes[i]].xyz.ToFloatPtr() );
+		mn = _mm_min_ps( v, mn );
+		mx = _mm_max_ps( v, mx );
+	}
+
+	float t[8];
+	_mm_storeu_ps( t + 0, mn );
+	_mm_storeu_ps( t + 4, mx );
+	for ( int j = 0; j < 3; j++ ) {
+		min[j] = t[j+0];
+		max[j] = t[j+4];
+		if ( min[j] == 0.0f || max[j] == 0.0f ) {
+			for ( int i = 0; i < count; i++ ) {
+				if ( src[indexes[i]].xyz[j] == 0.0f ) {
+					if ( min[j] == 0.0f ) {
+						min[j] = src[indexes[i]].xyz[j];
+					}
+					if ( max[j] == 0.0f ) {
+						max[j] = src[indexes[i]].xyz[j];
+					}
+					break;
+				}
+			}
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2::Clamp
+============
+*/
+void VPCALL idSIMD_SSE2::Clamp( float *dst, const float *src, const float min, const float max, const int count ) {
+	const __m128 mn = _mm_set1_ps( min );
+	const __m128 mx = _mm_set1_ps( max );
+	int i;
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		__m128 v = _mm_loadu_ps( src + i );
+		__m128 below = _mm_cmplt_ps( v, mn );
+		__m128 r = _mm_min_ps( mx, v );
+		r = _mm_or_ps( _mm_and_ps( below, mn ), _mm_andnot_ps( below, r ) );
+		_mm_storeu_ps( dst + i, r );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src[i] < min ? min : src[i] > max ? max : src[i];
+	}
+}
+
+/*
+============
+idSIMD_SSE2::ClampMin
+============
+*/
+void VPCALL idSIMD_SSE2::ClampMin( float *dst, const float *src, const float min, const int count ) {
+	const __m128 mn = _mm_set1_ps( min );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_max_ps( mn, _mm_loadu_ps( src + i ) ) ), dst[i] = src[i] < min ? min : src[i] )
+}
+
+/*
+============
+idSIMD_SSE2::ClampMax
+============
+*/
+void VPCALL idSIMD_SSE2::ClampMax( float *dst, const float *src, const float max, const int count ) {
+	const __m128 mx = _mm_set1_ps( max );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_min_ps( mx, _mm_loadu_ps( src + i ) ) ), dst[i] = src[i] > max ? max : src[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Zero16
+============
+*/
+void VPCALL idSIMD_SSE2::Zero16( float *dst, const int count ) {
+	const __m128 z = _mm_setzero_ps();
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, z ), dst[i] = 0.0f )
+}
+
+/*
+============
+idSIMD_SSE2::Negate16
+============
+*/
+void VPCALL idSIMD_SSE2::Negate16( float *dst, const int count ) {
+	const __m128 sign = _mm_castsi128_ps( _mm_set1_epi32( 1u << 31 ) );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_xor_ps( _mm_loadu_ps( dst + i ), sign ) ), reinterpret_cast<unsigned int *>(dst)[i] ^= ( 1u << 31 ) )
+}
+
+/*
+============
+idSIMD_SSE2::Copy16
+============
+*/
+void VPCALL idSIMD_SSE2::Copy16( float *dst, const float *src, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_loadu_ps( src + i ) ), dst[i] = src[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Add16
+============
+*/
+void VPCALL idSIMD_SSE2::Add16( float *dst, const float *src1, const float *src2, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( src1 + i ), _mm_loadu_ps( src2 + i ) ) ), dst[i] = src1[i] + src2[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Sub16
+============
+*/
+void VPCALL idSIMD_SSE2::Sub16( float *dst, const float *src1, const float *src2, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_sub_ps( _mm_loadu_ps( src1 + i ), _mm_loadu_ps( src2 + i ) ) ), dst[i] = src1[i] - src2[i] )
+}
+
+/*
+============
+idSIMD_SSE2::Mul16
+============
+*/
+void VPCALL idSIMD_SSE2::Mul16( float *dst, const float *src1, const float constant, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_mul_ps( _mm_loadu_ps( src1 + i ), c ) ), dst[i] = src1[i] * constant )
+}
+
+/*
+============
+idSIMD_SSE2::AddAssign16
+============
+*/
+void VPCALL idSIMD_SSE2::AddAssign16( float *dst, const float *src, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( dst + i ), _mm_loadu_ps( src + i ) ) ), dst[i] += src[i] )
+}
+
+/*
+============
+idSIMD_SSE2::SubAssign16
+============
+*/
+void VPCALL idSIMD_SSE2::SubAssign16( float *dst, const float *src, const int count ) {
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_sub_ps( _mm_loadu_ps( dst + i ), _mm_loadu_ps( src + i ) ) ), dst[i] -= src[i] )
+}
+
+/*
+============
+idSIMD_SSE2::MulAssign16
+============
+*/
+void VPCALL idSIMD_SSE2::MulAssign16( float *dst, const float constant, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+	SSE2_LOOP4( _mm_storeu_ps( dst + i, _mm_mul_ps( _mm_loadu_ps( dst + i ), c ) ), dst[i] *= constant )
+}
+
+/*
+============
+SSE2_MatXStore
+
+  op 0 stores the sums, op 1 adds them to dst and op 2 subtracts them from dst
+============
+*/
+static ID_INLINE void SSE2_MatXStore( float *dst, const __m128 sum, const int op ) {
+	if ( op == 0 ) {
+		_mm_storeu_ps( dst, sum );
+	} else if ( op == 1 ) {
+		_mm_storeu_ps( dst, _mm_add_ps( _mm_loadu_ps( dst ), sum ) );
+	} else {
+		_mm_storeu_ps( dst, _mm_sub_ps( _mm_loadu_ps( dst ), sum ) );
+	}
+}
+
+/*
+============
+SSE2_MatXMultiplyVecX
+
+  four rows at a time, the row sums are accumulated one column after the other
+  like the generic code does, so 4x4 blocks of the matrix are transposed first
+============
+*/
+static void SSE2_MatXMultiplyVecX( idVecX &dst, const idMatX &mat, const idVecX &vec, const int op ) {
+	int i, j;
+
+	assert( vec.GetSize() >= mat.GetNumColumns() );
+	assert( dst.GetSize() >= mat.GetNumRows() );
+
+	const float *mPtr = mat.ToFloatPtr();
+	const float *vPtr = vec.ToFloatPtr();
+	float *dstPtr = dst.ToFloatPtr();
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+
+	for ( i = 0; i + 4 <= numRows; i += 4 ) {
+		const float *r0 = mPtr + ( i + 0 ) * numColumns;
+		const float *r1 = mPtr + ( i + 1 ) * numColumns;
+		const float *r2 = mPtr + ( i + 2 ) * numColumns;
+		const float *r3 = mPtr + ( i + 3 ) * numColumns;
+		__m128 sum = _mm_setzero_ps();
+
+		for ( j = 0; j + 4 <= numColumns; j += 4 ) {
+			__m128 c0 = _mm_loadu_ps( r0 + j );
+			__m128 c1 = _mm_loadu_ps( r1 + j );
+			__m128 c2 = _mm_loadu_ps( r2 + j );
+			__m128 c3 = _mm_loadu_ps( r3 + j );
+			_MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+
+			// the first product is not added to zero, that would turn -0.0f into 0.0f
+			if ( j == 0 ) {
+				sum = _mm_mul_ps( c0, _mm_set1_ps( vPtr[0] ) );
+			} else {
+				sum = _mm_add_ps( sum, _mm_mul_ps( c0, _mm_set1_ps( vPtr[j] ) ) );
+			}
+			sum = _mm_add_ps( sum, _mm_mul_ps( c1, _mm_set1_ps( vPtr[j+1] ) ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( c2, _mm_set1_ps( vPtr[j+2] ) ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( c3, _mm_set1_ps( vPtr[j+3] ) ) );
+		}
+		for ( ; j < numColumns; j++ ) {
+			__m128 c = _mm_setr_ps( r0[j], r1[j], r2[j], r3[j] );
+			if ( j == 0 ) {
+				sum = _mm_mul_ps( c, _mm_set1_ps( vPtr[0] ) );
+			} else {
+				sum = _mm_add_ps( sum, _mm_mul_ps( c, _mm_set1_ps( vPtr[j] ) ) );
+			}
+		}
+
+		SSE2_MatXStore( dstPtr + i, sum, op );
+	}
+
+	for ( ; i < numRows; i++ ) {
+		const float *r = mPtr + i * numColumns;
+		float sum = r[0] * vPtr[0];
+		for ( j = 1; j < numColumns; j++ ) {
+			sum += r[j] * vPtr[j];
+		}
+		if ( op == 0 ) {
+			dstPtr[i] = sum;
+		} else if ( op == 1 ) {
+			dstPtr[i] += sum;
+		} else {
+			dstPtr[i] -= sum;
+		}
+	}
+}
+
+/*
+============
+SSE2_MatXTransposeMultiplyVecX
+
+  four columns at a time, the columns are contiguous in memory
+============
+*/
+static void SSE2_MatXTransposeMultiplyVecX( idVecX &dst, const idMatX &mat, const idVecX &vec, const int op ) {
+	int i, j;
+
+	assert( vec.GetSize() >= mat.GetNumRows() );
+	assert( dst.GetSize() >= mat.GetNumColumns() );
+
+	const float *mPtr = mat.ToFloatPtr();
+	const float *vPtr = vec.ToFloatPtr();
+	float *dstPtr = dst.ToFloatPtr();
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+
+	for ( i = 0; i + 4 <= numColumns; i += 4 ) {
+		__m128 sum = _mm_mul_ps( _mm_loadu_ps( mPtr + i ), _mm_set1_ps( vPtr[0] ) );
+		for ( j = 1; j < numRows; j++ ) {
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( mPtr + j * numColumns + i ), _mm_set1_ps( vPtr[j] ) ) );
+		}
+		SSE2_MatXStore( dstPtr + i, sum, op );
+	}
+
+	for ( ; i < numColumns; i++ ) {
+		float sum = mPtr[i] * vPtr[0];
+		for ( j = 1; j < numRows; j++ ) {
+			sum += mPtr[j * numColumns + i] * vPtr[j];
+		}
+		if ( op == 0 ) {
+			dstPtr[i] = sum;
+		} else if ( op == 1 ) {
+			dstPtr[i] += sum;
+		} else {
+			dstPtr[i] -= sum;
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MatX_MultiplyVecX
+============
+*/
+void VPCALL idSIMD_SSE2::MatX_MultiplyVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	SSE2_MatXMultiplyVecX( dst, mat, vec, 0 );
+}
+
+/*
+============
+idSIMD_SSE2::MatX_MultiplyAddVecX
+============
+*/
+void VPCALL idSIMD_SSE2::MatX_MultiplyAddVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	SSE2_MatXMultiplyVecX( dst, mat, vec, 1 );
+}
+
+/*
+============
+idSIMD_SSE2::MatX_MultiplySubVecX
+============
+*/
+void VPCALL idSIMD_SSE2::MatX_MultiplySubVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	SSE2_MatXMultiplyVecX( dst, mat, vec, 2 );
+}
+
+/*
+============
+idSIMD_SSE2::MatX_TransposeMultiplyVecX
+============
+*/
+void VPCALL idSIMD_SSE2::MatX_TransposeMultiplyVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	SSE2_MatXTransposeMultiplyVecX( dst, mat, vec, 0 );
+}
+
+/*
+============
+idSIMD_SSE2::MatX_TransposeMultiplyAddVecX
+============
+*/
+void VPCALL idSIMD_SSE2::MatX_TransposeMultiplyAddVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	SSE2_MatXTransposeMultiplyVecX( dst, mat, vec, 1 );
+}
+
+/*
+============
+idSIMD_SSE2::MatX_TransposeMultiplySubVecX
+============
+*/
+void VPCALL idSIMD_SSE2::MatX_TransposeMultiplySubVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	SSE2_MatXTransposeMultiplyVecX( dst, mat, vec, 2 );
+}
+
+/*
+============
+idSIMD_SSE2::ConvertJointQuatsToJointMats
+============
+*/
+void VPCALL idSIMD_SSE2::ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints ) {
+	const __m128 one = _mm_set1_ps( 1.0f );
+	int i;
+
+	for ( i = 0; i + 4 <= numJoints; i += 4 ) {
+		__m128 x = _mm_loadu_ps( jointQuats[i+0].q.ToFloatPtr() );
+		__m128 y = _mm_loadu_ps( jointQuats[i+1].q.ToFloatPtr() );
+		__m128 z = _mm_loadu_ps( jointQuats[i+2].q.ToFloatPtr() );
+		__m128 w = _mm_loadu_ps( jointQuats[i+3].q.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( x, y, z, w );
+
+		__m128 tx = SSE2_Load3( jointQuats[i+0].t.ToFloatPtr() );
+		__m128 ty = SSE2_Load3( jointQuats[i+1].t.ToFloatPtr() );
+		__m128 tz = SSE2_Load3( jointQuats[i+2].t.ToFloatPtr() );
+		__m128 tw = SSE2_Load3( jointQuats[i+3].t.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( tx, ty, tz, tw );
+
+		__m128 x2 = _mm_add_ps( x, x );
+		__m128 y2 = _mm_add_ps( y, y );
+		__m128 z2 = _mm_add_ps( z, z );
+
+		__m128 xx = _mm_mul_ps( x, x2 );
+		__m128 xy = _mm_mul_ps( x, y2 );
+		__m128 xz = _mm_mul_ps( x, z2 );
+		__m128 yy = _mm_mul_ps( y, y2 );
+		__m128 yz = _mm_mul_ps( y, z2 );
+		__m128 zz = _mm_mul_ps( z, z2 );
+		__m128 wx = _mm_mul_ps( w, x2 );
+		__m128 wy = _mm_mul_ps( w, y2 );
+		__m128 wz = _mm_mul_ps( w, z2 );
+
+		// rows of the joint matrices are the columns of idQuat::ToMat3
+		__m128 r00 = _mm_sub_ps( one, _mm_add_ps( yy, zz ) );
+		__m128 r01 = _mm_add_ps( xy, wz );
+		__m128 r02 = _mm_sub_ps( xz, wy );
+		__m128 r10 = _mm_sub_ps( xy, wz );
+		__m128 r11 = _mm_sub_ps( one, _mm_add_ps( xx, zz ) );
+		__m128 r12 = _mm_add_ps( yz, wx );
+		__m128 r20 = _mm_add_ps( xz, wy );
+		__m128 r21 = _mm_sub_ps( yz, wx );
+		__m128 r22 = _mm_sub_ps( one, _mm_add_ps( xx, yy ) );
+
+		_MM_TRANSPOSE4_PS( r00, r01, r02, tx );
+		_MM_TRANSPOSE4_PS( r10, r11, r12, ty );
+		_MM_TRANSPOSE4_PS( r20, r21, r22, tz );
+
+		_mm_storeu_ps( jointMats[i+0].ToFloatPtr() + 0, r00 );
+		_mm_storeu_ps( jointMats[i+0].ToFloatPtr() + 4, r10 );
+		_mm_storeu_ps( jointMats[i+0].ToFloatPtr() + 8, r20 );
+		_mm_storeu_ps( jointMats[i+1].ToFloatPtr() + 0, r01 );
+		_mm_storeu_ps( jointMats[i+1].ToFloatPtr() + 4, r11 );
+		_mm_storeu_ps( jointMats[i+1].ToFloatPtr() + 8, r21 );
+		_mm_storeu_ps( jointMats[i+2].ToFloatPtr() + 0, r02 );
+		_mm_storeu_ps( jointMats[i+2].ToFloatPtr() + 4, r12 );
+		_mm_storeu_ps( jointMats[i+2].ToFloatPtr() + 8, r22 );
+		_mm_storeu_ps( jointMats[i+3].ToFloatPtr() + 0, tx );
+		_mm_storeu_ps( jointMats[i+3].ToFloatPtr() + 4, ty );
+		_mm_storeu_ps( jointMats[i+3].ToFloatPtr() + 8, tz );
+	}
+	for ( ; i < numJoints; i++ ) {
+		jointMats[i].SetRotation( jointQuats[i].q.ToMat3() );
+		jointMats[i].SetTranslation( jointQuats[i].t );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::TransformJoints
+============
+*/
+void VPCALL idSIMD_SSE2::TransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint ) {
+	// adding -0.0f leaves the rotation part untouched, even for -0.0f
+	const __m128 signMask = _mm_castsi128_ps( _mm_setr_epi32( 1u << 31, 1u << 31, 1u << 31, 0 ) );
+
+	for ( int i = firstJoint; i <= lastJoint; i++ ) {
+		assert( parents[i] < i );
+		float *m = jointMats[i].ToFloatPtr();
+		const float *a = jointMats[parents[i]].ToFloatPtr();
+
+		__m128 row0 = _mm_loadu_ps( m + 0 );
+		__m128 row1 = _mm_loadu_ps( m + 4 );
+		__m128 row2 = _mm_loadu_ps( m + 8 );
+
+		for ( int r = 0; r < 3; r++ ) {
+			__m128 n = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( a[r*4+0] ), row0 ), _mm_mul_ps( _mm_set1_ps( a[r*4+1] ), row1 ) );
+			n = _mm_add_ps( n, _mm_mul_ps( _mm_set1_ps( a[r*4+2] ), row2 ) );
+			n = _mm_add_ps( n, _mm_or_ps( _mm_set_ps( a[r*4+3], 0.0f, 0.0f, 0.0f ), signMask ) );
+			_mm_storeu_ps( m + r * 4, n );
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2::UntransformJoints
+============
+*/
+void VPCALL idSIMD_SSE2::UntransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint ) {
+	for ( int i = lastJoint; i >= firstJoint; i-- ) {
+		assert( parents[i] < i );
+		float *m = jointMats[i].ToFloatPtr();
+		const float *a = jointMats[parents[i]].ToFloatPtr();
+
+		__m128 row0 = _mm_sub_ps( _mm_loadu_ps( m + 0 ), _mm_set_ps( a[0*4+3], 0.0f, 0.0f, 0.0f ) );
+		__m128 row1 = _mm_sub_ps( _mm_loadu_ps( m + 4 ), _mm_set_ps( a[1*4+3], 0.0f, 0.0f, 0.0f ) );
+		__m128 row2 = _mm_sub_ps( _mm_loadu_ps( m + 8 ), _mm_set_ps( a[2*4+3], 0.0f, 0.0f, 0.0f ) );
+
+		for ( int r = 0; r < 3; r++ ) {
+			__m128 n = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( a[0*4+r] ), row0 ), _mm_mul_ps( _mm_set1_ps( a[1*4+r] ), row1 ) );
+			n = _mm_add_ps( n, _mm_mul_ps( _mm_set1_ps( a[2*4+r] ), row2 ) );
+			_mm_storeu_ps( m + r * 4, n );
+		}
+	}
+}
+
+/*
+============
+SSE2_SkinVert
+
+  blends the weighted joints of one vertex, advances j past its last weight
+============
+*/
+static ID_INLINE __m128 SSE2_SkinVert( const byte *jointsPtr, const idVec4 *weights, const int *index, int &j ) {
+	__m128 v = _mm_setzero_ps();
+
+	for ( bool first = true; ; first = false, j++ ) {
+		const float *m = ( (const idJointMat *) ( jointsPtr + index[j*2+0] ) )->ToFloatPtr();
+		const __m128 w = _mm_loadu_ps( weights[j].ToFloatPtr() );
+		__m128 p0 = _mm_mul_ps( _mm_loadu_ps( m + 0 ), w );
+		__m128 p1 = _mm_mul_ps( _mm_loadu_ps( m + 4 ), w );
+		__m128 p2 = _mm_mul_ps( _mm_loadu_ps( m + 8 ), w );
+		__m128 p3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS( p0, p1, p2, p3 );
+		__m128 t = _mm_add_ps( _mm_add_ps( _mm_add_ps( p0, p1 ), p2 ), p3 );
+		v = first ? t : _mm_add_ps( v, t );
+		if ( index[j*2+1] != 0 ) {
+			break;
+		}
+	}
+	j++;
+
+	return v;
+}
+
+/*
+============
+idSIMD_SSE2::TransformVerts
+============
+*/
+void VPCALL idSIMD_SSE2::TransformVerts( idDrawVert *verts, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	const byte *jointsPtr = (byte *)joints;
+
+	for ( int i = 0, j = 0; i < numVerts; i++ ) {
+		SSE2_Store3( verts[i].xyz.ToFloatPtr(), SSE2_SkinVert( jointsPtr, weights, index, j ) );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::CreateShadowCache
+============
+*/
+int VPCALL idSIMD_SSE2::CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts ) {
+	const __m128 xyzMask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+	const __m128 w1 = _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f );
+	const __m128 light = _mm_setr_ps( lightOrigin[0], lightOrigin[1], lightOrigin[2], 0.0f );
+	int outVerts = 0;
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		if ( vertRemap[i] ) {
+			continue;
+		}
+		// R_SetupProjection() builds the projection matrix with a slight crunch
+		// for depth, which keeps this w=0 division from rasterizing right at the
+		// wrap around point and causing depth fighting with the rear caps
+		__m128 v = _mm_and_ps( _mm_loadu_ps( verts[i].xyz.ToFloatPtr() ), xyzMask );
+		_mm_storeu_ps( vertexCache[outVerts+0].ToFloatPtr(), _mm_or_ps( v, w1 ) );
+		_mm_storeu_ps( vertexCache[outVerts+1].ToFloatPtr(), _mm_and_ps( _mm_sub_ps( v, light ), xyzMask ) );
+		vertRemap[i] = outVerts;
+		outVerts += 2;
+	}
+	return outVerts;
+}
+
+/*
+============
+idSIMD_SSE2::CreateVertexProgramShadowCache
+============
+*/
+int VPCALL idSIMD_SSE2::CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts ) {
+	const __m128 xyzMask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+	const __m128 w1 = _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		__m128 v = _mm_and_ps( _mm_loadu_ps( verts[i].xyz.ToFloatPtr() ), xyzMask );
+		_mm_storeu_ps( vertexCache[i*2+0].ToFloatPtr(), _mm_or_ps( v, w1 ) );
+		_mm_storeu_ps( vertexCache[i*2+1].ToFloatPtr(), v );
+	}
+	return numVerts * 2;
+}
+
+/*
+============
+SSE2_LoadCullBoxes
+
+  loads center and axes of four boxes, repeating the last box if there are less than four left
+============
+*/
+static ID_INLINE void SSE2_LoadCullBoxes( const cullBoxes_t &boxes, const int first, const int count, __m128 b[12] ) {
+	const float *rows[12] = {
+		boxes.center[0], boxes.center[1], boxes.center[2],
+		boxes.axis[0][0], boxes.axis[0][1], boxes.axis[0][2],
+		boxes.axis[1][0], boxes.axis[1][1], boxes.axis[1][2],
+		boxes.axis[2][0], boxes.axis[2][1], boxes.axis[2][2]
+	};
+
+	if ( count >= 4 ) {
+		for ( int k = 0; k < 12; k++ ) {
+			b[k] = _mm_loadu_ps( rows[k] + first );
+		}
+	} else {
+		for ( int k = 0; k < 12; k++ ) {
+			const float *r = rows[k] + first;
+			b[k] = _mm_setr_ps( r[0], r[Min( 1, count - 1 )], r[Min( 2, count - 1 )], r[count - 1] );
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2::CullBoxes
+
+  same plane distances as idSIMD_Generic::CullBoxes, four boxes at a time
+============
+*/
+void VPCALL idSIMD_SSE2::CullBoxes( dword *visibleBits, const idPlane *planes, const int numPlanes, const cullBoxes_t &boxes, const int numBoxes ) {
+	const __m128 absMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7FFFFFFF ) );
+	const __m128 zero = _mm_setzero_ps();
+
+	memset( visibleBits, 0, ( ( numBoxes + 31 ) >> 5 ) * sizeof( visibleBits[0] ) );
+
+	for ( int i = 0; i < numBoxes; i += 4 ) {
+		const int count = numBoxes - i;
+		__m128 b[12];
+
+		SSE2_LoadCullBoxes( boxes, i, count, b );
+
+		__m128 culled = zero;
+		for ( int j = 0; j < numPlanes; j++ ) {
+			const float *p = planes[j].ToFloatPtr();
+			const __m128 px = _mm_set1_ps( p[0] );
+			const __m128 py = _mm_set1_ps( p[1] );
+			const __m128 pz = _mm_set1_ps( p[2] );
+
+			__m128 d = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, b[0] ), _mm_mul_ps( py, b[1] ) ), _mm_mul_ps( pz, b[2] ) ), _mm_set1_ps( p[3] ) );
+			__m128 r0 = _mm_and_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, b[3] ), _mm_mul_ps( py, b[4] ) ), _mm_mul_ps( pz, b[5] ) ), absMask );
+			__m128 r1 = _mm_and_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, b[6] ), _mm_mul_ps( py, b[7] ) ), _mm_mul_ps( pz, b[8] ) ), absMask );
+			__m128 r2 = _mm_and_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, b[9] ), _mm_mul_ps( py, b[10] ) ), _mm_mul_ps( pz, b[11] ) ), absMask );
+
+			culled = _mm_or_ps( culled, _mm_cmpge_ps( _mm_sub_ps( d, _mm_add_ps( _mm_add_ps( r0, r1 ), r2 ) ), zero ) );
+			if ( _mm_movemask_ps( culled ) == 0xF ) {
+				break;
+			}
+		}
+
+		dword visible = ~_mm_movemask_ps( culled ) & ( ( 1 << Min( count, 4 ) ) - 1 );
+		visibleBits[i >> 5] |= visible << ( i & 31 );
+	}
+}
+
+/*
+============
+SSE2_Interleave3
+
+  stores x, y and z registers as four consecutive idVec3
+============
+*/
+static ID_INLINE void SSE2_Interleave3( float *p, const __m128 x, const __m128 y, const __m128 z ) {
+	__m128 xy0 = _mm_unpacklo_ps( x, y );
+	__m128 xy1 = _mm_unpackhi_ps( x, y );
+	_mm_storeu_ps( p + 0, _mm_shuffle_ps( xy0, _mm_shuffle_ps( z, x, R_SHUFFLEPS( 0, 0, 1, 1 ) ), R_SHUFFLEPS( 0, 1, 0, 2 ) ) );
+	_mm_storeu_ps( p + 4, _mm_shuffle_ps( _mm_shuffle_ps( y, z, R_SHUFFLEPS( 1, 1, 1, 1 ) ), xy1, R_SHUFFLEPS( 0, 2, 0, 1 ) ) );
+	_mm_storeu_ps( p + 8, _mm_shuffle_ps( _mm_shuffle_ps( z, x, R_SHUFFLEPS( 2, 2, 3, 3 ) ), _mm_shuffle_ps( y, z, R_SHUFFLEPS( 3, 3, 3, 3 ) ), R_SHUFFLEPS( 0, 2, 0, 2 ) ) );
+}
+
+/*
+============
+SSE2_NormalizeScale
+
+  1 / length with one Newton-Raphson step, zero length vectors stay zero
+============
+*/
+static ID_INLINE __m128 SSE2_NormalizeScale( const __m128 x, const __m128 y, const __m128 z ) {
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 threeHalfs = _mm_set1_ps( 1.5f );
+	__m128 sqr = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+	sqr = _mm_max_ps( sqr, _mm_set1_ps( 1e-30f ) );
+	__m128 r = _mm_rsqrt_ps( sqr );
+	return _mm_mul_ps( r, _mm_sub_ps( threeHalfs, _mm_mul_ps( _mm_mul_ps( half, sqr ), _mm_mul_ps( r, r ) ) ) );
+}
+
+/*
+============
+idSIMD_SSE2::TransformVertsSoA
+============
+*/
+void VPCALL idSIMD_SSE2::TransformVertsSoA( idVec3 *xyz, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	const byte *jointsPtr = (byte *)joints;
+
+	for ( int i = 0, j = 0; i < numVerts; i++ ) {
+		SSE2_Store3( xyz[i].ToFloatPtr(), SSE2_SkinVert( jointsPtr, weights, index, j ) );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::NormalizeTangentsSoA
+
+  four vertices at a time, the normal and tangent streams are contiguous
+  so there is no gathering from the 60 byte draw verts
+============
+*/
+void VPCALL idSIMD_SSE2::NormalizeTangentsSoA( const drawVertStreams_s &streams, const int numVerts ) {
+	int i;
+
+	for ( i = 0; i + 4 <= numVerts; i += 4 ) {
+		__m128 nx, ny, nz;
+		SSE2_Deinterleave3( streams.normal[i].ToFloatPtr(), nx, ny, nz );
+
+		__m128 f = SSE2_NormalizeScale( nx, ny, nz );
+		nx = _mm_mul_ps( nx, f );
+		ny = _mm_mul_ps( ny, f );
+		nz = _mm_mul_ps( nz, f );
+		SSE2_Interleave3( streams.normal[i].ToFloatPtr(), nx, ny, nz );
+
+		for ( int j = 0; j < 2; j++ ) {
+			__m128 tx, ty, tz;
+			SSE2_Deinterleave3( streams.tangents[j][i].ToFloatPtr(), tx, ty, tz );
+
+			// project onto the plane orthogonal to the normal
+			__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( tx, nx ), _mm_mul_ps( ty, ny ) ), _mm_mul_ps( tz, nz ) );
+			tx = _mm_sub_ps( tx, _mm_mul_ps( d, nx ) );
+			ty = _mm_sub_ps( ty, _mm_mul_ps( d, ny ) );
+			tz = _mm_sub_ps( tz, _mm_mul_ps( d, nz ) );
+
+			f = SSE2_NormalizeScale( tx, ty, tz );
+			SSE2_Interleave3( streams.tangents[j][i].ToFloatPtr(), _mm_mul_ps( tx, f ), _mm_mul_ps( ty, f ), _mm_mul_ps( tz, f ) );
+		}
+	}
+
+	if ( i < numVerts ) {
+		drawVertStreams_t tail;
+		tail.xyz = streams.xyz + i;
+		tail.st = streams.st + i;
+		tail.normal = streams.normal + i;
+		tail.tangents[0] = streams.tangents[0] + i;
+		tail.tangents[1] = streams.tangents[1] + i;
+		idSIMD_Generic::NormalizeTangentsSoA( tail, numVerts - i );
+	}
+}
+
+/*
+============
+SSE2_Gather4
+
+  the first four floats at each of the four pointers as x, y, z and w registers
+============
+*/
+static ID_INLINE void SSE2_Gather4( const float * const p[4], __m128 &x, __m128 &y, __m128 &z, __m128 &w ) {
+	__m128 r0 = _mm_loadu_ps( p[0] );
+	__m128 r1 = _mm_loadu_ps( p[1] );
+	__m128 r2 = _mm_loadu_ps( p[2] );
+	__m128 r3 = _mm_loadu_ps( p[3] );
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	x = r0;
+	y = r1;
+	z = r2;
+	w = r3;
+}
+
+/*
+============
+SSE2_Gather3
+============
+*/
+static ID_INLINE void SSE2_Gather3( const float * const p[4], __m128 &x, __m128 &y, __m128 &z ) {
+	__m128 w;
+	SSE2_Gather4( p, x, y, z, w );
+}
+
+/*
+============
+SSE2_Scatter3
+
+  stores the x, y and z registers as one idVec3 at each of the four pointers
+============
+*/
+static ID_INLINE void SSE2_Scatter3( float * const p[4], const __m128 x, const __m128 y, const __m128 z ) {
+	__m128 r0 = x;
+	__m128 r1 = y;
+	__m128 r2 = z;
+	__m128 r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	SSE2_Store3( p[0], r0 );
+	SSE2_Store3( p[1], r1 );
+	SSE2_Store3( p[2], r2 );
+	SSE2_Store3( p[3], r3 );
+}
+
+/*
+============
+SSE2_Dot3
+============
+*/
+static ID_INLINE __m128 SSE2_Dot3( const __m128 ax, const __m128 ay, const __m128 az, const __m128 bx, const __m128 by, const __m128 bz ) {
+	return _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, bx ), _mm_mul_ps( ay, by ) ), _mm_mul_ps( az, bz ) );
+}
+
+/*
+============
+SSE2_RSqrt
+
+  the same integer estimate and Newton-Raphson step as idMath::RSqrt
+============
+*/
+static ID_INLINE __m128 SSE2_RSqrt( const __m128 x ) {
+	__m128 y = _mm_mul_ps( x, _mm_set1_ps( 0.5f ) );
+	__m128 r = _mm_castsi128_ps( _mm_sub_epi32( _mm_set1_epi32( 0x5f3759df ), _mm_srai_epi32( _mm_castps_si128( x ), 1 ) ) );
+	return _mm_mul_ps( r, _mm_sub_ps( _mm_set1_ps( 1.5f ), _mm_mul_ps( _mm_mul_ps( r, r ), y ) ) );
+}
+
+/*
+============
+SSE2_PlaneDistance
+============
+*/
+static ID_INLINE __m128 SSE2_PlaneDistance( const idPlane &plane, const __m128 x, const __m128 y, const __m128 z ) {
+	const float *p = plane.ToFloatPtr();
+	return _mm_add_ps( SSE2_Dot3( _mm_set1_ps( p[0] ), _mm_set1_ps( p[1] ), _mm_set1_ps( p[2] ), x, y, z ), _mm_set1_ps( p[3] ) );
+}
+
+/*
+============
+SSE2_SignBits
+
+  the float sign bits moved to bit number bitNum of each integer lane
+============
+*/
+static ID_INLINE __m128i SSE2_SignBits( const __m128 t, const int bitNum ) {
+	return _mm_sll_epi32( _mm_srli_epi32( _mm_castps_si128( t ), 31 ), _mm_cvtsi32_si128( bitNum ) );
+}
+
+/*
+============
+SSE2_StoreBytes4
+============
+*/
+static ID_INLINE void SSE2_StoreBytes4( byte *dst, const __m128i bits ) {
+	__m128i w = _mm_packs_epi32( bits, bits );
+	*(int *)dst = _mm_cvtsi128_si32( _mm_packus_epi16( w, w ) );
+}
+
+/*
+============
+SSE2_StorePlanes
+============
+*/
+static ID_INLINE void SSE2_StorePlanes( idPlane *planes, __m128 a, __m128 b, __m128 c, __m128 d, const int count ) {
+	_MM_TRANSPOSE4_PS( a, b, c, d );
+	const __m128 r[4] = { a, b, c, d };
+	for ( int k = 0; k < count; k++ ) {
+		_mm_storeu_ps( planes[k].ToFloatPtr(), r[k] );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::TracePointCull
+============
+*/
+void VPCALL idSIMD_SSE2::TracePointCull( byte *cullBits, byte &totalOr, const float radius, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	const __m128 r = _mm_set1_ps( radius );
+	__m128i tOr = _mm_setzero_si128();
+	int i;
+
+	for ( i = 0; i + 4 <= numVerts; i += 4 ) {
+		__m128 x, y, z;
+		SSE2_LoadXYZ( verts + i, x, y, z );
+
+		__m128i bits = _mm_setzero_si128();
+		for ( int k = 0; k < 4; k++ ) {
+			__m128 d = SSE2_PlaneDistance( planes[k], x, y, z );
+			bits = _mm_or_si128( bits, SSE2_SignBits( _mm_add_ps( d, r ), k ) );
+			bits = _mm_or_si128( bits, SSE2_SignBits( _mm_sub_ps( d, r ), k + 4 ) );
+		}
+		bits = _mm_xor_si128( bits, _mm_set1_epi32( 0x0F ) );		// flip lower four bits
+
+		tOr = _mm_or_si128( tOr, bits );
+		SSE2_StoreBytes4( cullBits + i, bits );
+	}
+
+	tOr = _mm_or_si128( tOr, _mm_srli_si128( tOr, 8 ) );
+	tOr = _mm_or_si128( tOr, _mm_srli_si128( tOr, 4 ) );
+	byte total = (byte) _mm_cvtsi128_si32( tOr );
+
+	if ( i < numVerts ) {
+		byte tailOr;
+		idSIMD_Generic::TracePointCull( cullBits + i, tailOr, radius, planes, verts + i, numVerts - i );
+		total |= tailOr;
+	}
+
+	totalOr = total;
+}
+
+/*
+============
+idSIMD_SSE2::DecalPointCull
+============
+*/
+void VPCALL idSIMD_SSE2::DecalPointCull( byte *cullBits, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	int i;
+
+	for ( i = 0; i + 4 <= numVerts; i += 4 ) {
+		__m128 x, y, z;
+		SSE2_LoadXYZ( verts + i, x, y, z );
+
+		__m128i bits = _mm_setzero_si128();
+		for ( int k = 0; k < 6; k++ ) {
+			bits = _mm_or_si128( bits, SSE2_SignBits( SSE2_PlaneDistance( planes[k], x, y, z ), k ) );
+		}
+
+		SSE2_StoreBytes4( cullBits + i, _mm_xor_si128( bits, _mm_set1_epi32( 0x3F ) ) );		// flip lower 6 bits
+	}
+
+	if ( i < numVerts ) {
+		idSIMD_Generic::DecalPointCull( cullBits + i, planes, verts + i, numVerts - i );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::OverlayPointCull
+============
+*/
+void VPCALL idSIMD_SSE2::OverlayPointCull( byte *cullBits, idVec2 *texCoords, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	const __m128 one = _mm_set1_ps( 1.0f );
+	int i;
+
+	for ( i = 0; i + 4 <= numVerts; i += 4 ) {
+		__m128 x, y, z;
+		SSE2_LoadXYZ( verts + i, x, y, z );
+
+		__m128 d0 = SSE2_PlaneDistance( planes[0], x, y, z );
+		__m128 d1 = SSE2_PlaneDistance( planes[1], x, y, z );
+
+		_mm_storeu_ps( texCoords[i+0].ToFloatPtr(), _mm_unpacklo_ps( d0, d1 ) );
+		_mm_storeu_ps( texCoords[i+2].ToFloatPtr(), _mm_unpackhi_ps( d0, d1 ) );
+
+		__m128i bits = SSE2_SignBits( d0, 0 );
+		bits = _mm_or_si128( bits, SSE2_SignBits( d1, 1 ) );
+		bits = _mm_or_si128( bits, SSE2_SignBits( _mm_sub_ps( one, d0 ), 2 ) );
+		bits = _mm_or_si128( bits, SSE2_SignBits( _mm_sub_ps( one, d1 ), 3 ) );
+
+		SSE2_StoreBytes4( cullBits + i, bits );
+	}
+
+	if ( i < numVerts ) {
+		idSIMD_Generic::OverlayPointCull( cullBits + i, texCoords + i, planes, verts + i, numVerts - i );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::DeriveTriPlanes
+
+  four triangles at a time
+============
+*/
+void VPCALL idSIMD_SSE2::DeriveTriPlanes( idPlane *planes, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	const __m128 signMask = _mm_castsi128_ps( _mm_set1_epi32( 0x80000000 ) );
+	int i;
+
+	for ( i = 0; i + 12 <= numIndexes; i += 12 ) {
+		const float *pa[4], *pb[4], *pc[4];
+		__m128 ax, ay, az, bx, by, bz, cx, cy, cz;
+
+		for ( int k = 0; k < 4; k++ ) {
+			pa[k] = verts[indexes[i + k * 3 + 0]].xyz.ToFloatPtr();
+			pb[k] = verts[indexes[i + k * 3 + 1]].xyz.ToFloatPtr();
+			pc[k] = verts[indexes[i + k * 3 + 2]].xyz.ToFloatPtr();
+		}
+		SSE2_Gather3( pa, ax, ay, az );
+		SSE2_Gather3( pb, bx, by, bz );
+		SSE2_Gather3( pc, cx, cy, cz );
+
+		__m128 d0x = _mm_sub_ps( bx, ax );
+		__m128 d0y = _mm_sub_ps( by, ay );
+		__m128 d0z = _mm_sub_ps( bz, az );
+
+		__m128 d1x = _mm_sub_ps( cx, ax );
+		__m128 d1y = _mm_sub_ps( cy, ay );
+		__m128 d1z = _mm_sub_ps( cz, az );
+
+		__m128 nx = _mm_sub_ps( _mm_mul_ps( d1y, d0z ), _mm_mul_ps( d1z, d0y ) );
+		__m128 ny = _mm_sub_ps( _mm_mul_ps( d1z, d0x ), _mm_mul_ps( d1x, d0z ) );
+		__m128 nz = _mm_sub_ps( _mm_mul_ps( d1x, d0y ), _mm_mul_ps( d1y, d0x ) );
+
+		__m128 f = SSE2_RSqrt( SSE2_Dot3( nx, ny, nz, nx, ny, nz ) );
+		nx = _mm_mul_ps( nx, f );
+		ny = _mm_mul_ps( ny, f );
+		nz = _mm_mul_ps( nz, f );
+
+		__m128 d = _mm_xor_ps( SSE2_Dot3( nx, ny, nz, ax, ay, az ), signMask );
+		SSE2_StorePlanes( planes, nx, ny, nz, d, 4 );
+		planes += 4;
+	}
+
+	if ( i < numIndexes ) {
+		idSIMD_Generic::DeriveTriPlanes( planes, verts, numVerts, indexes + i, numIndexes - i );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::DeriveTangents
+
+  the normals, tangents and planes of four triangles are calculated at a time,
+  adding them to the vertices is done in triangle order like the generic code
+============
+*/
+void VPCALL idSIMD_SSE2::DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	const __m128 signMask = _mm_castsi128_ps( _mm_set1_epi32( 0x80000000 ) );
+	const int numTris = numIndexes / 3;
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	for ( int i = 0; i < numTris; i += 4 ) {
+		const int count = Min( numTris - i, 4 );
+		const float *pa[4], *pb[4], *pc[4];
+		__m128 ax, ay, az, as, bx, by, bz, bs, cx, cy, cz, cs;
+
+		// the last triangle is repeated to fill up the registers
+		for ( int k = 0; k < 4; k++ ) {
+			const int *tri = indexes + ( i + Min( k, count - 1 ) ) * 3;
+			pa[k] = verts[tri[0]].xyz.ToFloatPtr();
+			pb[k] = verts[tri[1]].xyz.ToFloatPtr();
+			pc[k] = verts[tri[2]].xyz.ToFloatPtr();
+		}
+
+		// st follows xyz in the draw vert
+		SSE2_Gather4( pa, ax, ay, az, as );
+		SSE2_Gather4( pb, bx, by, bz, bs );
+		SSE2_Gather4( pc, cx, cy, cz, cs );
+		__m128 at = _mm_setr_ps( pa[0][4], pa[1][4], pa[2][4], pa[3][4] );
+		__m128 bt = _mm_setr_ps( pb[0][4], pb[1][4], pb[2][4], pb[3][4] );
+		__m128 ct = _mm_setr_ps( pc[0][4], pc[1][4], pc[2][4], pc[3][4] );
+
+		__m128 d00 = _mm_sub_ps( bx, ax );
+		__m128 d01 = _mm_sub_ps( by, ay );
+		__m128 d02 = _mm_sub_ps( bz, az );
+		__m128 d03 = _mm_sub_ps( bs, as );
+		__m128 d04 = _mm_sub_ps( bt, at );
+
+		__m128 d10 = _mm_sub_ps( cx, ax );
+		__m128 d11 = _mm_sub_ps( cy, ay );
+		__m128 d12 = _mm_sub_ps( cz, az );
+		__m128 d13 = _mm_sub_ps( cs, as );
+		__m128 d14 = _mm_sub_ps( ct, at );
+
+		// normal
+		__m128 nx = _mm_sub_ps( _mm_mul_ps( d11, d02 ), _mm_mul_ps( d12, d01 ) );
+		__m128 ny = _mm_sub_ps( _mm_mul_ps( d12, d00 ), _mm_mul_ps( d10, d02 ) );
+		__m128 nz = _mm_sub_ps( _mm_mul_ps( d10, d01 ), _mm_mul_ps( d11, d00 ) );
+
+		__m128 f = SSE2_RSqrt( SSE2_Dot3( nx, ny, nz, nx, ny, nz ) );
+		nx = _mm_mul_ps( nx, f );
+		ny = _mm_mul_ps( ny, f );
+		nz = _mm_mul_ps( nz, f );
+
+		__m128 d = _mm_xor_ps( SSE2_Dot3( nx, ny, nz, ax, ay, az ), signMask );
+		SSE2_StorePlanes( planes + i, nx, ny, nz, d, count );
+
+		// area sign bit
+		__m128 signBit = _mm_and_ps( _mm_sub_ps( _mm_mul_ps( d03, d14 ), _mm_mul_ps( d04, d13 ) ), signMask );
+
+		// first tangent
+		__m128 t0x = _mm_sub_ps( _mm_mul_ps( d00, d14 ), _mm_mul_ps( d04, d10 ) );
+		__m128 t0y = _mm_sub_ps( _mm_mul_ps( d01, d14 ), _mm_mul_ps( d04, d11 ) );
+		__m128 t0z = _mm_sub_ps( _mm_mul_ps( d02, d14 ), _mm_mul_ps( d04, d12 ) );
+
+		f = _mm_xor_ps( SSE2_RSqrt( SSE2_Dot3( t0x, t0y, t0z, t0x, t0y, t0z ) ), signBit );
+		t0x = _mm_mul_ps( t0x, f );
+		t0y = _mm_mul_ps( t0y, f );
+		t0z = _mm_mul_ps( t0z, f );
+
+		// second tangent
+		__m128 t1x = _mm_sub_ps( _mm_mul_ps( d03, d10 ), _mm_mul_ps( d00, d13 ) );
+		__m128 t1y = _mm_sub_ps( _mm_mul_ps( d03, d11 ), _mm_mul_ps( d01, d13 ) );
+		__m128 t1z = _mm_sub_ps( _mm_mul_ps( d03, d12 ), _mm_mul_ps( d02, d13 ) );
+
+		f = _mm_xor_ps( SSE2_RSqrt( SSE2_Dot3( t1x, t1y, t1z, t1x, t1y, t1z ) ), signBit );
+		t1x = _mm_mul_ps( t1x, f );
+		t1y = _mm_mul_ps( t1y, f );
+		t1z = _mm_mul_ps( t1z, f );
+
+		ALIGN16( float n[3][4] );
+		ALIGN16( float t0[3][4] );
+		ALIGN16( float t1[3][4] );
+		_mm_store_ps( n[0], nx );
+		_mm_store_ps( n[1], ny );
+		_mm_store_ps( n[2], nz );
+		_mm_store_ps( t0[0], t0x );
+		_mm_store_ps( t0[1], t0y );
+		_mm_store_ps( t0[2], t0z );
+		_mm_store_ps( t1[0], t1x );
+		_mm_store_ps( t1[1], t1y );
+		_mm_store_ps( t1[2], t1z );
+
+		for ( int k = 0; k < count; k++ ) {
+			const idVec3 normal( n[0][k], n[1][k], n[2][k] );
+			const idVec3 tangent0( t0[0][k], t0[1][k], t0[2][k] );
+			const idVec3 tangent1( t1[0][k], t1[1][k], t1[2][k] );
+			const int *tri = indexes + ( i + k ) * 3;
+
+			for ( int m = 0; m < 3; m++ ) {
+				idDrawVert *v = verts + tri[m];
+				if ( used[tri[m]] ) {
+					v->normal += normal;
+					v->tangents[0] += tangent0;
+					v->tangents[1] += tangent1;
+				} else {
+					v->normal = normal;
+					v->tangents[0] = tangent0;
+					v->tangents[1] = tangent1;
+					used[tri[m]] = true;
+				}
+			}
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2::DeriveUnsmoothedTangents
+
+  four vertices at a time, the second tangent is derived from the normal and
+  the first tangent like the generic code does with DERIVE_UNSMOOTHED_BITANGENT
+============
+*/
+void VPCALL idSIMD_SSE2::DeriveUnsmoothedTangents( idDrawVert *verts, const dominantTri_s *dominantTris, const int numVerts ) {
+	for ( int i = 0; i < numVerts; i += 4 ) {
+		const dominantTri_s *dt[4];
+		const float *pa[4], *pb[4], *pc[4];
+		float *pn[4], *pt0[4], *pt1[4];
+		__m128 ax, ay, az, as, bx, by, bz, bs, cx, cy, cz, cs;
+
+		// the last vertex is repeated to fill up the registers, it is stored with the same values again
+		for ( int k = 0; k < 4; k++ ) {
+			const int v = i + Min( k, numVerts - i - 1 );
+			dt[k] = dominantTris + v;
+			pa[k] = verts[v].xyz.ToFloatPtr();
+			pb[k] = verts[dt[k]->v2].xyz.ToFloatPtr();
+			pc[k] = verts[dt[k]->v3].xyz.ToFloatPtr();
+			pn[k] = verts[v].normal.ToFloatPtr();
+			pt0[k] = verts[v].tangents[0].ToFloatPtr();
+			pt1[k] = verts[v].tangents[1].ToFloatPtr();
+		}
+
+		SSE2_Gather4( pa, ax, ay, az, as );
+		SSE2_Gather4( pb, bx, by, bz, bs );
+		SSE2_Gather4( pc, cx, cy, cz, cs );
+		__m128 at = _mm_setr_ps( pa[0][4], pa[1][4], pa[2][4], pa[3][4] );
+		__m128 bt = _mm_setr_ps( pb[0][4], pb[1][4], pb[2][4], pb[3][4] );
+		__m128 ct = _mm_setr_ps( pc[0][4], pc[1][4], pc[2][4], pc[3][4] );
+
+		__m128 d0 = _mm_sub_ps( bx, ax );
+		__m128 d1 = _mm_sub_ps( by, ay );
+		__m128 d2 = _mm_sub_ps( bz, az );
+		__m128 d4 = _mm_sub_ps( bt, at );
+
+		__m128 d5 = _mm_sub_ps( cx, ax );
+		__m128 d6 = _mm_sub_ps( cy, ay );
+		__m128 d7 = _mm_sub_ps( cz, az );
+		__m128 d9 = _mm_sub_ps( ct, at );
+
+		__m128 s0 = _mm_setr_ps( dt[0]->normalizationScale[0], dt[1]->normalizationScale[0], dt[2]->normalizationScale[0], dt[3]->normalizationScale[0] );
+		__m128 s1 = _mm_setr_ps( dt[0]->normalizationScale[1], dt[1]->normalizationScale[1], dt[2]->normalizationScale[1], dt[3]->normalizationScale[1] );
+		__m128 s2 = _mm_setr_ps( dt[0]->normalizationScale[2], dt[1]->normalizationScale[2], dt[2]->normalizationScale[2], dt[3]->normalizationScale[2] );
+
+		__m128 n0 = _mm_mul_ps( s2, _mm_sub_ps( _mm_mul_ps( d6, d2 ), _mm_mul_ps( d7, d1 ) ) );
+		__m128 n1 = _mm_mul_ps( s2, _mm_sub_ps( _mm_mul_ps( d7, d0 ), _mm_mul_ps( d5, d2 ) ) );
+		__m128 n2 = _mm_mul_ps( s2, _mm_sub_ps( _mm_mul_ps( d5, d1 ), _mm_mul_ps( d6, d0 ) ) );
+
+		__m128 t0 = _mm_mul_ps( s0, _mm_sub_ps( _mm_mul_ps( d0, d9 ), _mm_mul_ps( d4, d5 ) ) );
+		__m128 t1 = _mm_mul_ps( s0, _mm_sub_ps( _mm_mul_ps( d1, d9 ), _mm_mul_ps( d4, d6 ) ) );
+		__m128 t2 = _mm_mul_ps( s0, _mm_sub_ps( _mm_mul_ps( d2, d9 ), _mm_mul_ps( d4, d7 ) ) );
+
+		__m128 t3 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( n2, t1 ), _mm_mul_ps( n1, t2 ) ) );
+		__m128 t4 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( n0, t2 ), _mm_mul_ps( n2, t0 ) ) );
+		__m128 t5 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( n1, t0 ), _mm_mul_ps( n0, t1 ) ) );
+
+		SSE2_Scatter3( pn, n0, n1, n2 );
+		SSE2_Scatter3( pt0, t0, t1, t2 );
+		SSE2_Scatter3( pt1, t3, t4, t5 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::NormalizeTangents
+
+  four vertices at a time
+============
+*/
+void VPCALL idSIMD_SSE2::NormalizeTangents( idDrawVert *verts, const int numVerts ) {
+	int i;
+
+	for ( i = 0; i + 4 <= numVerts; i += 4 ) {
+		float *pn[4], *pt[2][4];
+		__m128 nx, ny, nz;
+
+		for ( int k = 0; k < 4; k++ ) {
+			pn[k] = verts[i + k].normal.ToFloatPtr();
+			pt[0][k] = verts[i + k].tangents[0].ToFloatPtr();
+			pt[1][k] = verts[i + k].tangents[1].ToFloatPtr();
+		}
+
+		SSE2_Gather3( pn, nx, ny, nz );
+		__m128 f = SSE2_RSqrt( SSE2_Dot3( nx, ny, nz, nx, ny, nz ) );
+		nx = _mm_mul_ps( nx, f );
+		ny = _mm_mul_ps( ny, f );
+		nz = _mm_mul_ps( nz, f );
+		SSE2_Scatter3( pn, nx, ny, nz );
+
+		for ( int j = 0; j < 2; j++ ) {
+			__m128 tx, ty, tz;
+			SSE2_Gather3( pt[j], tx, ty, tz );
+
+			__m128 d = SSE2_Dot3( tx, ty, tz, nx, ny, nz );
+			tx = _mm_sub_ps( tx, _mm_mul_ps( d, nx ) );
+			ty = _mm_sub_ps( ty, _mm_mul_ps( d, ny ) );
+			tz = _mm_sub_ps( tz, _mm_mul_ps( d, nz ) );
+
+			f = SSE2_RSqrt( SSE2_Dot3( tx, ty, tz, tx, ty, tz ) );
+			SSE2_Scatter3( pt[j], _mm_mul_ps( tx, f ), _mm_mul_ps( ty, f ), _mm_mul_ps( tz, f ) );
+		}
+	}
+
+	if ( i < numVerts ) {
+		idSIMD_Generic::NormalizeTangents( verts + i, numVerts - i );
+	}
+}
+
+/*
+============
+SSE2_LoadTangentSpace
+
+  position and tangent space of four vertices, the last vertex is repeated when there are less than four
+============
+*/
+static ID_INLINE void SSE2_LoadTangentSpace( const idDrawVert *verts, const int count, __m128 xyz[3], __m128 t0[3], __m128 t1[3], __m128 n[3] ) {
+	const float *pxyz[4], *pt0[4], *pt1[4], *pn[4];
+
+	for ( int k = 0; k < 4; k++ ) {
+		const idDrawVert &v = verts[Min( k, count - 1 )];
+		pxyz[k] = v.xyz.ToFloatPtr();
+		pt0[k] = v.tangents[0].ToFloatPtr();
+		pt1[k] = v.tangents[1].ToFloatPtr();
+		pn[k] = v.normal.ToFloatPtr();
+	}
+
+	SSE2_Gather3( pxyz, xyz[0], xyz[1], xyz[2] );
+	SSE2_Gather3( pt0, t0[0], t0[1], t0[2] );
+	SSE2_Gather3( pt1, t1[0], t1[1], t1[2] );
+	SSE2_Gather3( pn, n[0], n[1], n[2] );
+}
+
+/*
+============
+idSIMD_SSE2::CreateTextureSpaceLightVectors
+
+  four vertices at a time, only the vertices referenced by the indexes are written
+============
+*/
+void VPCALL idSIMD_SSE2::CreateTextureSpaceLightVectors( idVec3 *lightVectors, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	const __m128 lox = _mm_set1_ps( lightOrigin[0] );
+	const __m128 loy = _mm_set1_ps( lightOrigin[1] );
+	const __m128 loz = _mm_set1_ps( lightOrigin[2] );
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	for ( int i = numIndexes - 1; i >= 0; i-- ) {
+		used[indexes[i]] = true;
+	}
+
+	for ( int i = 0; i < numVerts; i += 4 ) {
+		const int count = Min( numVerts - i, 4 );
+		int k;
+
+		for ( k = 0; k < count; k++ ) {
+			if ( used[i + k] ) {
+				break;
+			}
+		}
+		if ( k >= count ) {
+			continue;
+		}
+
+		__m128 xyz[3], t0[3], t1[3], n[3];
+		SSE2_LoadTangentSpace( verts + i, count, xyz, t0, t1, n );
+
+		__m128 lx = _mm_sub_ps( lox, xyz[0] );
+		__m128 ly = _mm_sub_ps( loy, xyz[1] );
+		__m128 lz = _mm_sub_ps( loz, xyz[2] );
+
+		ALIGN16( float lv[3][4] );
+		_mm_store_ps( lv[0], SSE2_Dot3( lx, ly, lz, t0[0], t0[1], t0[2] ) );
+		_mm_store_ps( lv[1], SSE2_Dot3( lx, ly, lz, t1[0], t1[1], t1[2] ) );
+		_mm_store_ps( lv[2], SSE2_Dot3( lx, ly, lz, n[0], n[1], n[2] ) );
+
+		for ( k = 0; k < count; k++ ) {
+			if ( used[i + k] ) {
+				lightVectors[i + k][0] = lv[0][k];
+				lightVectors[i + k][1] = lv[1][k];
+				lightVectors[i + k][2] = lv[2][k];
+			}
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2::CreateSpecularTextureCoords
+
+  four vertices at a time, only the vertices referenced by the indexes are written
+============
+*/
+void VPCALL idSIMD_SSE2::CreateSpecularTextureCoords( idVec4 *texCoords, const idVec3 &lightOrigin, const idVec3 &viewOrigin, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	const __m128 lox = _mm_set1_ps( lightOrigin[0] );
+	const __m128 loy = _mm_set1_ps( lightOrigin[1] );
+	const __m128 loz = _mm_set1_ps( lightOrigin[2] );
+	const __m128 vox = _mm_set1_ps( viewOrigin[0] );
+	const __m128 voy = _mm_set1_ps( viewOrigin[1] );
+	const __m128 voz = _mm_set1_ps( viewOrigin[2] );
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	for ( int i = numIndexes - 1; i >= 0; i-- ) {
+		used[indexes[i]] = true;
+	}
+
+	for ( int i = 0; i < numVerts; i += 4 ) {
+		const int count = Min( numVerts - i, 4 );
+		int k;
+
+		for ( k = 0; k < count; k++ ) {
+			if ( used[i + k] ) {
+				break;
+			}
+		}
+		if ( k >= count ) {
+			continue;
+		}
+
+		__m128 xyz[3], t0[3], t1[3], n[3];
+		SSE2_LoadTangentSpace( verts + i, count, xyz, t0, t1, n );
+
+		__m128 lx = _mm_sub_ps( lox, xyz[0] );
+		__m128 ly = _mm_sub_ps( loy, xyz[1] );
+		__m128 lz = _mm_sub_ps( loz, xyz[2] );
+		__m128 vx = _mm_sub_ps( vox, xyz[0] );
+		__m128 vy = _mm_sub_ps( voy, xyz[1] );
+		__m128 vz = _mm_sub_ps( voz, xyz[2] );
+
+		__m128 ilength = SSE2_RSqrt( SSE2_Dot3( lx, ly, lz, lx, ly, lz ) );
+		lx = _mm_mul_ps( lx, ilength );
+		ly = _mm_mul_ps( ly, ilength );
+		lz = _mm_mul_ps( lz, ilength );
+
+		ilength = SSE2_RSqrt( SSE2_Dot3( vx, vy, vz, vx, vy, vz ) );
+		vx = _mm_mul_ps( vx, ilength );
+		vy = _mm_mul_ps( vy, ilength );
+		vz = _mm_mul_ps( vz, ilength );
+
+		lx = _mm_add_ps( lx, vx );
+		ly = _mm_add_ps( ly, vy );
+		lz = _mm_add_ps( lz, vz );
+
+		__m128 r0 = SSE2_Dot3( lx, ly, lz, t0[0], t0[1], t0[2] );
+		__m128 r1 = SSE2_Dot3( lx, ly, lz, t1[0], t1[1], t1[2] );
+		__m128 r2 = SSE2_Dot3( lx, ly, lz, n[0], n[1], n[2] );
+		__m128 r3 = _mm_set1_ps( 1.0f );
+		_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+		const __m128 tc[4] = { r0, r1, r2, r3 };
+
+		for ( k = 0; k < count; k++ ) {
+			if ( used[i + k] ) {
+				_mm_storeu_ps( texCoords[i + k].ToFloatPtr(), tc[k] );
+			}
+		}
+	}
+}
+
+/*
+============
+SSE2_UpSample4
+
+  writes four interleaved input samples duplicated for 44kHz output
+============
+*/
+static ID_INLINE void SSE2_UpSample4( float *dest, const __m128 v, const int factor, const int numChannels ) {
+	if ( factor == 1 ) {
+		_mm_storeu_ps( dest, v );
+	} else if ( numChannels == 1 ) {
+		if ( factor == 2 ) {
+			_mm_storeu_ps( dest + 0, _mm_unpacklo_ps( v, v ) );
+			_mm_storeu_ps( dest + 4, _mm_unpackhi_ps( v, v ) );
+		} else {
+			_mm_storeu_ps( dest + 0, _mm_shuffle_ps( v, v, R_SHUFFLEPS( 0, 0, 0, 0 ) ) );
+			_mm_storeu_ps( dest + 4, _mm_shuffle_ps( v, v, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+			_mm_storeu_ps( dest + 8, _mm_shuffle_ps( v, v, R_SHUFFLEPS( 2, 2, 2, 2 ) ) );
+			_mm_storeu_ps( dest + 12, _mm_shuffle_ps( v, v, R_SHUFFLEPS( 3, 3, 3, 3 ) ) );
+		}
+	} else {
+		__m128 lo = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 0, 1, 0, 1 ) );
+		__m128 hi = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 2, 3, 2, 3 ) );
+		if ( factor == 2 ) {
+			_mm_storeu_ps( dest + 0, lo );
+			_mm_storeu_ps( dest + 4, hi );
+		} else {
+			_mm_storeu_ps( dest + 0, lo );
+			_mm_storeu_ps( dest + 4, lo );
+			_mm_storeu_ps( dest + 8, hi );
+			_mm_storeu_ps( dest + 12, hi );
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2::UpSamplePCMTo44kHz
+
+  Duplicate samples for 44kHz output.
+============
+*/
+void idSIMD_SSE2::UpSamplePCMTo44kHz( float *dest, const short *src, const int numSamples, const int kHz, const int numChannels ) {
+	if ( kHz != 11025 && kHz != 22050 && kHz != 44100 ) {
+		assert( 0 );
+		return;
+	}
+
+	const int factor = 44100 / kHz;
+	int i;
+
+	for ( i = 0; i + 4 <= numSamples; i += 4 ) {
+		__m128i s = _mm_loadl_epi64( (const __m128i *) ( src + i ) );
+		s = _mm_srai_epi32( _mm_unpacklo_epi16( s, s ), 16 );
+		SSE2_UpSample4( dest + i * factor, _mm_cvtepi32_ps( s ), factor, numChannels );
+	}
+	if ( i < numSamples ) {
+		idSIMD_Generic::UpSamplePCMTo44kHz( dest + i * factor, src + i, numSamples - i, kHz, numChannels );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::UpSampleOGGTo44kHz
+
+  Duplicate samples for 44kHz output.
+============
+*/
+void idSIMD_SSE2::UpSampleOGGTo44kHz( float *dest, const float * const *ogg, const int numSamples, const int kHz, const int numChannels ) {
+	if ( kHz != 11025 && kHz != 22050 && kHz != 44100 ) {
+		assert( 0 );
+		return;
+	}
+
+	const __m128 scale = _mm_set1_ps( 32768.0f );
+	const int factor = 44100 / kHz;
+	int i;
+
+	if ( numChannels == 1 ) {
+		for ( i = 0; i + 4 <= numSamples; i += 4 ) {
+			SSE2_UpSample4( dest + i * factor, _mm_mul_ps( _mm_loadu_ps( ogg[0] + i ), scale ), factor, 1 );
+		}
+		if ( i < numSamples ) {
+			const float *tail[1] = { ogg[0] + i };
+			idSIMD_Generic::UpSampleOGGTo44kHz( dest + i * factor, tail, numSamples - i, kHz, numChannels );
+		}
+	} else {
+		const int numFrames = numSamples >> 1;
+		for ( i = 0; i + 4 <= numFrames; i += 4 ) {
+			__m128 l = _mm_mul_ps( _mm_loadu_ps( ogg[0] + i ), scale );
+			__m128 r = _mm_mul_ps( _mm_loadu_ps( ogg[1] + i ), scale );
+			SSE2_UpSample4( dest + ( i * 2 + 0 ) * factor, _mm_unpacklo_ps( l, r ), factor, 2 );
+			SSE2_UpSample4( dest + ( i * 2 + 4 ) * factor, _mm_unpackhi_ps( l, r ), factor, 2 );
+		}
+		if ( i < numFrames ) {
+			const float *tail[2] = { ogg[0] + i, ogg[1] + i };
+			idSIMD_Generic::UpSampleOGGTo44kHz( dest + i * 2 * factor, tail, numSamples - i * 2, kHz, numChannels );
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MixSoundTwoSpeakerMono
+
+  Each lane steps its volume ramp with the same chain of additions as the generic code.
+============
+*/
+void VPCALL idSIMD_SSE2::MixSoundTwoSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	float incL = ( currentV[0] - lastV[0] ) / MIXBUFFER_SAMPLES;
+	float incR = ( currentV[1] - lastV[1] ) / MIXBUFFER_SAMPLES;
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	const __m128 inc = _mm_setr_ps( incL, incR, incL, incR );
+	__m128 s0 = _mm_setr_ps( lastV[0], lastV[1], lastV[0] + incL, lastV[1] + incR );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		__m128 x = _mm_loadu_ps( samples + j );
+		__m128 s1 = _mm_add_ps( _mm_add_ps( s0, inc ), inc );
+		_mm_storeu_ps( mixBuffer + j*2+0, _mm_add_ps( _mm_loadu_ps( mixBuffer + j*2+0 ), _mm_mul_ps( _mm_unpacklo_ps( x, x ), s0 ) ) );
+		_mm_storeu_ps( mixBuffer + j*2+4, _mm_add_ps( _mm_loadu_ps( mixBuffer + j*2+4 ), _mm_mul_ps( _mm_unpackhi_ps( x, x ), s1 ) ) );
+		s0 = _mm_add_ps( _mm_add_ps( s1, inc ), inc );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MixSoundTwoSpeakerStereo
+============
+*/
+void VPCALL idSIMD_SSE2::MixSoundTwoSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	float incL = ( currentV[0] - lastV[0] ) / MIXBUFFER_SAMPLES;
+	float incR = ( currentV[1] - lastV[1] ) / MIXBUFFER_SAMPLES;
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	const __m128 inc = _mm_setr_ps( incL, incR, incL, incR );
+	__m128 s0 = _mm_setr_ps( lastV[0], lastV[1], lastV[0] + incL, lastV[1] + incR );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		__m128 s1 = _mm_add_ps( _mm_add_ps( s0, inc ), inc );
+		_mm_storeu_ps( mixBuffer + j*2+0, _mm_add_ps( _mm_loadu_ps( mixBuffer + j*2+0 ), _mm_mul_ps( _mm_loadu_ps( samples + j*2+0 ), s0 ) ) );
+		_mm_storeu_ps( mixBuffer + j*2+4, _mm_add_ps( _mm_loadu_ps( mixBuffer + j*2+4 ), _mm_mul_ps( _mm_loadu_ps( samples + j*2+4 ), s1 ) ) );
+		s0 = _mm_add_ps( _mm_add_ps( s1, inc ), inc );
+	}
+}
+
+/*
+============
+SSE2_SixSpeakerRamps
+
+  volumes for two consecutive samples spread over three registers
+============
+*/
+static ID_INLINE void SSE2_SixSpeakerRamps( const float lastV[6], const float currentV[6], __m128 s[3], __m128 inc[3] ) {
+	float sL[12], incL[12];
+
+	for ( int k = 0; k < 6; k++ ) {
+		incL[k] = incL[k+6] = ( currentV[k] - lastV[k] ) / MIXBUFFER_SAMPLES;
+		sL[k] = lastV[k];
+		sL[k+6] = lastV[k] + incL[k];
+	}
+	for ( int k = 0; k < 3; k++ ) {
+		s[k] = _mm_loadu_ps( sL + k * 4 );
+		inc[k] = _mm_loadu_ps( incL + k * 4 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MixSoundSixSpeakerMono
+============
+*/
+void VPCALL idSIMD_SSE2::MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	__m128 s[3], inc[3];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SSE2_SixSpeakerRamps( lastV, currentV, s, inc );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 2 ) {
+		__m128 x = _mm_castpd_ps( _mm_load_sd( (const double *) ( samples + i ) ) );
+		__m128 x0 = _mm_shuffle_ps( x, x, R_SHUFFLEPS( 0, 0, 0, 0 ) );
+		__m128 x1 = _mm_shuffle_ps( x, x, R_SHUFFLEPS( 0, 0, 1, 1 ) );
+		__m128 x2 = _mm_shuffle_ps( x, x, R_SHUFFLEPS( 1, 1, 1, 1 ) );
+		float *mix = mixBuffer + i * 6;
+		_mm_storeu_ps( mix + 0, _mm_add_ps( _mm_loadu_ps( mix + 0 ), _mm_mul_ps( x0, s[0] ) ) );
+		_mm_storeu_ps( mix + 4, _mm_add_ps( _mm_loadu_ps( mix + 4 ), _mm_mul_ps( x1, s[1] ) ) );
+		_mm_storeu_ps( mix + 8, _mm_add_ps( _mm_loadu_ps( mix + 8 ), _mm_mul_ps( x2, s[2] ) ) );
+		s[0] = _mm_add_ps( _mm_add_ps( s[0], inc[0] ), inc[0] );
+		s[1] = _mm_add_ps( _mm_add_ps( s[1], inc[1] ), inc[1] );
+		s[2] = _mm_add_ps( _mm_add_ps( s[2], inc[2] ), inc[2] );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MixSoundSixSpeakerStereo
+============
+*/
+void VPCALL idSIMD_SSE2::MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	__m128 s[3], inc[3];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SSE2_SixSpeakerRamps( lastV, currentV, s, inc );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 2 ) {
+		// left goes to speakers 0, 2, 3, 4 and right to speakers 1, 5
+		__m128 x = _mm_loadu_ps( samples + i * 2 );
+		__m128 x0 = _mm_shuffle_ps( x, x, R_SHUFFLEPS( 0, 1, 0, 0 ) );
+		__m128 x2 = _mm_shuffle_ps( x, x, R_SHUFFLEPS( 2, 2, 2, 3 ) );
+		float *mix = mixBuffer + i * 6;
+		_mm_storeu_ps( mix + 0, _mm_add_ps( _mm_loadu_ps( mix + 0 ), _mm_mul_ps( x0, s[0] ) ) );
+		_mm_storeu_ps( mix + 4, _mm_add_ps( _mm_loadu_ps( mix + 4 ), _mm_mul_ps( x, s[1] ) ) );
+		_mm_storeu_ps( mix + 8, _mm_add_ps( _mm_loadu_ps( mix + 8 ), _mm_mul_ps( x2, s[2] ) ) );
+		s[0] = _mm_add_ps( _mm_add_ps( s[0], inc[0] ), inc[0] );
+		s[1] = _mm_add_ps( _mm_add_ps( s[1], inc[1] ), inc[1] );
+		s[2] = _mm_add_ps( _mm_add_ps( s[2], inc[2] ), inc[2] );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MixedSoundToSamples
+============
+*/
+void VPCALL idSIMD_SSE2::MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples ) {
+	const __m128 mn = _mm_set1_ps( -32768.0f );
+	const __m128 mx = _mm_set1_ps( 32767.0f );
+	int i;
+
+	for ( i = 0; i + 8 <= numSamples; i += 8 ) {
+		__m128 a = _mm_min_ps( _mm_max_ps( _mm_loadu_ps( mixBuffer + i + 0 ), mn ), mx );
+		__m128 b = _mm_min_ps( _mm_max_ps( _mm_loadu_ps( mixBuffer + i + 4 ), mn ), mx );
+		__m128i s = _mm_packs_epi32( _mm_cvttps_epi32( a ), _mm_cvttps_epi32( b ) );
+		_mm_storeu_si128( (__m128i *) ( samples + i ), s );
+	}
+	for ( ; i < numSamples; i++ ) {
+		if ( mixBuffer[i] <= -32768.0f ) {
+			samples[i] = -32768;
+		} else if ( mixBuffer[i] >= 32767.0f ) {
+			samples[i] = 32767;
+		} else {
+			samples[i] = (short) mixBuffer[i];
+		}
 	}
 }
 
@@ -0,0 +1,467 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "renderer/tr_local.h"
+
+#include "renderer/AreaBVH.h"
+
+/*
+================
+AreaBVH_Cost
+
+half the surface area of the bounds
+================
+*/
+static ID_INLINE float AreaBVH_Cost( const idBounds &bounds ) {
+	idVec3 size = bounds[1] - bounds[0];
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+/*
+================
+AreaBVH_Select
+
+partially sorts the leaves so the nth leaf has the nth
+smallest center on the axis
+================
+*/
+static void AreaBVH_Select( const areaBVHNode_t *nodes, int *leafNums, int numLeafNums, int nth, int axis ) {
+	int left = 0;
+	int right = numLeafNums - 1;
+
+	while ( right > left ) {
+		const idBounds &p = nodes[leafNums[( left + right ) >> 1]].bounds;
+		float pivot = p[0][axis] + p[1][axis];
+
+		int i = left;
+		int j = right;
+		while ( i <= j ) {
+			while ( nodes[leafNums[i]].bounds[0][axis] + nodes[leafNums[i]].bounds[1][axis] < pivot ) {
+				i++;
+			}
+			while ( nodes[leafNums[j]].bounds[0][axis] + nodes[leafNums[j]].bounds[1][axis] > pivot ) {
+				j--;
+			}
+			if ( i <= j ) {
+				int swap = leafNums[i];
+				leafNums[i] = leafNums[j];
+				leafNums[j] = swap;
+				i++;
+				j--;
+			}
+		}
+
+		if ( nth <= j ) {
+			right = j;
+		} else if ( nth >= i ) {
+			left = i;
+		} else {
+			break;
+		}
+	}
+}
+
+/*
+================
+idAreaBVH::idAreaBVH
+================
+*/
+idAreaBVH::idAreaBVH( void ) {
+	root = -1;
+	firstFree = -1;
+	numLeaves = 0;
+	numChanges = 0;
+	numRebuilds = 0;
+}
+
+/*
+================
+idAreaBVH::Clear
+================
+*/
+void idAreaBVH::Clear( void ) {
+	nodes.Clear();
+	root = -1;
+	firstFree = -1;
+	numLeaves = 0;
+	numChanges = 0;
+}
+
+/*
+================
+idAreaBVH::AllocNode
+================
+*/
+int idAreaBVH::AllocNode( void ) {
+	int nodeNum;
+
+	if ( firstFree != -1 ) {
+		nodeNum = firstFree;
+		firstFree = nodes[nodeNum].children[0];
+	} else {
+		nodeNum = nodes.Num();
+		nodes.Alloc();
+	}
+
+	areaBVHNode_t &node = nodes[nodeNum];
+	node.parent = -1;
+	node.children[0] = node.children[1] = -1;
+	node.ref = NULL;
+
+	return nodeNum;
+}
+
+/*
+================
+idAreaBVH::FreeNode
+================
+*/
+void idAreaBVH::FreeNode( int nodeNum ) {
+	areaBVHNode_t &node = nodes[nodeNum];
+	node.ref = NULL;
+	node.children[0] = firstFree;
+	node.children[1] = -1;
+	firstFree = nodeNum;
+}
+
+/*
+================
+idAreaBVH::RefitParents
+
+recalculates the bounds of the node and its parents
+================
+*/
+void idAreaBVH::RefitParents( int nodeNum ) {
+	while ( nodeNum != -1 ) {
+		areaBVHNode_t &node = nodes[nodeNum];
+		idBounds bounds = nodes[node.children[0]].bounds + nodes[node.children[1]].bounds;
+		if ( bounds == node.bounds ) {
+			// the parents won't change either
+			break;
+		}
+		node.bounds = bounds;
+		nodeNum = node.parent;
+	}
+}
+
+/*
+================
+idAreaBVH::InsertLeaf
+
+pairs the leaf with the node that grows the least by adding it
+================
+*/
+void idAreaBVH::InsertLeaf( int leafNum ) {
+	if ( root == -1 ) {
+		root = leafNum;
+		nodes[leafNum].parent = -1;
+		return;
+	}
+
+	idBounds bounds = nodes[leafNum].bounds;
+
+	int sibling = root;
+	int depth = 0;
+	while ( !nodes[sibling].ref ) {
+		const areaBVHNode_t &node = nodes[sibling];
+		const idBounds &b0 = nodes[node.children[0]].bounds;
+		const idBounds &b1 = nodes[node.children[1]].bounds;
+
+		float cost0 = AreaBVH_Cost( b0 + bounds ) - AreaBVH_Cost( b0 );
+		float cost1 = AreaBVH_Cost( b1 + bounds ) - AreaBVH_Cost( b1 );
+
+		sibling = ( cost0 <= cost1 ) ? node.children[0] : node.children[1];
+		depth++;
+	}
+
+	int oldParent = nodes[sibling].parent;
+	int newParent = AllocNode();
+
+	areaBVHNode_t &node = nodes[newParent];
+	node.parent = oldParent;
+	node.children[0] = sibling;
+	node.children[1] = leafNum;
+	node.bounds = nodes[sibling].bounds + bounds;
+
+	nodes[sibling].parent = newParent;
+	nodes[leafNum].parent = newParent;
+
+	if ( oldParent == -1 ) {
+		root = newParent;
+	} else {
+		areaBVHNode_t &parent = nodes[oldParent];
+		parent.children[ parent.children[0] == sibling ? 0 : 1 ] = newParent;
+		RefitParents( oldParent );
+	}
+
+	// keep the depth within the iterator stack
+	if ( depth + 1 > AREA_BVH_MAX_DEPTH ) {
+		Rebuild();
+	}
+}
+
+/*
+================
+idAreaBVH::RemoveLeaf
+================
+*/
+void idAreaBVH::RemoveLeaf( int leafNum ) {
+	if ( leafNum == root ) {
+		root = -1;
+		return;
+	}
+
+	int parentNum = nodes[leafNum].parent;
+	const areaBVHNode_t &parent = nodes[parentNum];
+	int grandParent = parent.parent;
+	int sibling = ( parent.children[0] == leafNum ) ? parent.children[1] : parent.children[0];
+
+	nodes[sibling].parent = grandParent;
+	if ( grandParent == -1 ) {
+		root = sibling;
+	} else {
+		areaBVHNode_t &node = nodes[grandParent];
+		node.children[ node.children[0] == parentNum ? 0 : 1 ] = sibling;
+		RefitParents( grandParent );
+	}
+
+	FreeNode( parentNum );
+}
+
+/*
+================
+idAreaBVH::Build_r
+================
+*/
+int idAreaBVH::Build_r( int *leafNums, int numLeafNums, int parent ) {
+	int i;
+
+	if ( numLeafNums == 1 ) {
+		nodes[leafNums[0]].parent = parent;
+		return leafNums[0];
+	}
+
+	// split at the median of the centers on the longest axis
+	idBounds centers;
+	centers.Clear();
+	for ( i = 0; i < numLeafNums; i++ ) {
+		centers.AddPoint( nodes[leafNums[i]].bounds.GetCenter() );
+	}
+	idVec3 size = centers[1] - centers[0];
+	int axis = 0;
+	for ( i = 1; i < 3; i++ ) {
+		if ( size[i] > size[axis] ) {
+			axis = i;
+		}
+	}
+
+	int mid = numLeafNums >> 1;
+	AreaBVH_Select( nodes.Ptr(), leafNums, numLeafNums, mid, axis );
+
+	int nodeNum = AllocNode();
+	nodes[nodeNum].parent = parent;
+
+	int child0 = Build_r( leafNums, mid, nodeNum );
+	int child1 = Build_r( leafNums + mid, numLeafNums - mid, nodeNum );
+
+	areaBVHNode_t &node = nodes[nodeNum];
+	node.children[0] = child0;
+	node.children[1] = child1;
+	node.bounds = nodes[child0].bounds + nodes[child1].bounds;
+
+	return nodeNum;
+}
+
+/*
+================
+idAreaBVH::Rebuild
+================
+*/
+void idAreaBVH::Rebuild( void ) {
+	numChanges = 0;
+	numRebuilds++;
+
+	if ( !numLeaves ) {
+		return;
+	}
+
+	// keep the leaves, all other nodes are free now
+	int *leafNums = (int *)_alloca16( numLeaves * sizeof( leafNums[0] ) );
+	int n = 0;
+
+	firstFree = -1;
+	for ( int i = nodes.Num() - 1; i >= 0; i-- ) {
+		if ( nodes[i].ref ) {
+			leafNums[n++] = i;
+		} else {
+			FreeNode( i );
+		}
+	}
+	assert( n == numLeaves );
+
+	root = Build_r( leafNums, n, -1 );
+}
+
+/*
+================
+idAreaBVH::Add
+================
+*/
+void idAreaBVH::Add( areaReference_t *ref, const idBounds &bounds ) {
+	int leafNum = AllocNode();
+	nodes[leafNum].bounds = bounds;
+	nodes[leafNum].ref = ref;
+	ref->bvhNode = leafNum;
+	numLeaves++;
+
+	InsertLeaf( leafNum );
+
+	numChanges++;
+	if ( numChanges > 2 * numLeaves + 16 ) {
+		Rebuild();
+	}
+}
+
+/*
+================
+idAreaBVH::Remove
+================
+*/
+void idAreaBVH::Remove( areaReference_t *ref ) {
+	int leafNum = ref->bvhNode;
+
+	assert( nodes[leafNum].ref == ref );
+
+	RemoveLeaf( leafNum );
+	FreeNode( leafNum );
+	ref->bvhNode = -1;
+	numLeaves--;
+
+	if ( !numLeaves ) {
+		// keep the memory for the next references
+		nodes.SetNum( 0, false );
+		firstFree = -1;
+		numChanges = 0;
+		return;
+	}
+
+	numChanges++;
+	if ( numChanges > 2 * numLeaves + 16 ) {
+		Rebuild();
+	}
+}
+
+/*
+================
+idAreaBVH::Move
+================
+*/
+void idAreaBVH::Move( areaReference_t *ref, const idBounds &bounds ) {
+	int leafNum = ref->bvhNode;
+
+	assert( nodes[leafNum].ref == ref );
+
+	if ( nodes[leafNum].bounds == bounds ) {
+		return;
+	}
+	nodes[leafNum].bounds = bounds;
+	RefitParents( nodes[leafNum].parent );
+
+	// the refitted nodes overlap more and more as the leaves move around
+	numChanges++;
+	if ( numChanges > 2 * numLeaves + 16 ) {
+		Rebuild();
+	}
+}
+
+/*
+================
+idAreaBVHIterator::idAreaBVHIterator
+================
+*/
+idAreaBVHIterator::idAreaBVHIterator( const idAreaBVH *tree, const idBounds *bounds ) {
+	this->tree = tree;
+	this->bounds = bounds;
+	numPlanes = 0;
+	planes = NULL;
+	stackDepth = 0;
+	if ( tree->root != -1 ) {
+		stack[stackDepth++] = tree->root;
+	}
+}
+
+/*
+================
+idAreaBVHIterator::idAreaBVHIterator
+================
+*/
+idAreaBVHIterator::idAreaBVHIterator( const idAreaBVH *tree, int numPlanes, const idPlane *planes ) {
+	this->tree = tree;
+	this->bounds = NULL;
+	this->numPlanes = numPlanes;
+	this->planes = planes;
+	stackDepth = 0;
+	if ( tree->root != -1 ) {
+		stack[stackDepth++] = tree->root;
+	}
+}
+
+/*
+================
+idAreaBVHIterator::Next
+================
+*/
+areaReference_t *idAreaBVHIterator::Next( void ) {
+	int i;
+
+	while ( stackDepth > 0 ) {
+		const areaBVHNode_t &node = tree->nodes[stack[--stackDepth]];
+
+		if ( bounds && !node.bounds.IntersectsBounds( *bounds ) ) {
+			continue;
+		}
+		for ( i = 0; i < numPlanes; i++ ) {
+			if ( node.bounds.PlaneSide( planes[i] ) == PLANESIDE_FRONT ) {
+				break;
+			}
+		}
+		if ( i < numPlanes ) {
+			continue;
+		}
+
+		if ( node.ref ) {
+			return node.ref;
+		}
+
+		stack[stackDepth++] = node.children[1];
+		stack[stackDepth++] = node.children[0];
+	}
+
+	return NULL;
+}
@@ -0,0 +1,118 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __AREABVH_H__
+#define __AREABVH_H__
+
+#include "idlib/bv/Bounds.h"
+#include "idlib/containers/List.h"
+
+/*
+===============================================================================
+
+	Bounding volume hierarchy of the entity or light references in a portal area.
+
+	The leaves hold the global bounds of the references. A moving reference
+	only refits the bounds of its ancestors, after enough changes relative to
+	the number of leaves the tree is rebuilt with median splits. The tree must
+	not be changed while an idAreaBVHIterator walks it.
+
+===============================================================================
+*/
+
+struct areaReference_s;
+
+const int AREA_BVH_MAX_DEPTH		= 64;		// a deeper insert rebuilds the tree
+
+typedef struct {
+	idBounds					bounds;
+	int							parent;
+	int							children[2];	// the next free node in children[0] for free nodes
+	struct areaReference_s *	ref;			// only set for leaves
+} areaBVHNode_t;
+
+class idAreaBVH {
+	friend class idAreaBVHIterator;
+public:
+							idAreaBVH( void );
+
+	void					Clear( void );
+
+	void					Add( struct areaReference_s *ref, const idBounds &bounds );
+	void					Remove( struct areaReference_s *ref );
+							// refits the tree for the new bounds of the reference
+	void					Move( struct areaReference_s *ref, const idBounds &bounds );
+
+	int						Num( void ) const { return numLeaves; }
+	int						GetNumRebuilds( void ) const { return numRebuilds; }
+
+private:
+	idList<areaBVHNode_t>	nodes;
+	int						root;
+	int						firstFree;
+	int						numLeaves;
+	int						numChanges;			// inserts and refits since the last rebuild
+	int						numRebuilds;
+
+	int						AllocNode( void );
+	void					FreeNode( int nodeNum );
+	void					RefitParents( int nodeNum );
+	void					InsertLeaf( int leafNum );
+	void					RemoveLeaf( int leafNum );
+	void					Rebuild( void );
+	int						Build_r( int *leafNums, int numLeafNums, int parent );
+};
+
+/*
+===============================================================================
+
+	Walks the references of an area tree that touch the bounds, or that are
+	not completely on the positive side of one of the planes.
+
+===============================================================================
+*/
+
+class idAreaBVHIterator {
+public:
+							// all references when bounds is NULL
+							idAreaBVHIterator( const idAreaBVH *tree, const idBounds *bounds );
+							idAreaBVHIterator( const idAreaBVH *tree, int numPlanes, const idPlane *planes );
+
+							// returns NULL after the last reference
+	struct areaReference_s *Next( void );
+
+private:
+	const idAreaBVH *		tree;
+	const idBounds *		bounds;
+	int						numPlanes;
+	const idPlane *			planes;
+	int						stack[AREA_BVH_MAX_DEPTH + 2];
+	int						stackDepth;
+};
+
+#endif /* !__AREABVH_H__ */
@@ -151,6 +151,20 @@ typedef enum {
 
 #define	MAX_IMAGE_NAME	256
 
+#define MAX_IMAGE_LEVELS	20
+
+// all the mip levels of a 2D image, built by idImage::BuildMipChain
+// and handed to idImage::UploadMipChain
+typedef struct {
+	GLenum				internalFormat;
+	int					numLevels;
+	int					width[MAX_IMAGE_LEVELS];
+	int					height[MAX_IMAGE_LEVELS];
+	byte *				data[MAX_IMAGE_LEVELS];		// R_StaticAlloc'd
+} imageMipChain_t;
+
+struct imageLoadJob_t;
+
 class idImage {
 public:
 				idImage();
@@ -211,6 +225,11 @@ public:
 	bool		CheckPrecompressedImage( bool fullLoad );
 	void		UploadPrecompressedImage( byte *data, int len );
 	void		ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd );
+	void		PrefetchImage();
+	bool		StartParallelLoad( imageLoadJob_t &job );
+	void		FinishParallelLoad( imageLoadJob_t &job );
+	void		BuildMipChain( const byte *pic, int width, int height, imageMipChain_t &chain );
+	void		UploadMipChain( imageMipChain_t &chain );
 	void		StartBackgroundImageLoad();
 	int			BitsForInternalFormat( int internalFormat ) const;
 	void		UploadCompressedNormalMap( int width, int height, const byte *rgba, int mipLevel );
@@ -255,6 +274,7 @@ public:
 	// data for listImages
 	int					uploadWidth, uploadHeight, uploadDepth;	// after power of two, downsample, and MAX_TEXTURE_SIZE
 	int					internalFormat;
+	float				readTime, decodeTime, mipTime, uploadTime;	// milliseconds spent in each load stage
 
 	idImage				*cacheUsagePrev, *cacheUsageNext;	// for dynamic cache purging of old images
 
@@ -289,6 +309,7 @@ ID_INLINE idImage::idImage() {
 	bindCount = 0;
 	uploadWidth = uploadHeight = uploadDepth = 0;
 	internalFormat = 0;
+	readTime = decodeTime = mipTime = uploadTime = 0.0f;
 	cacheUsagePrev = cacheUsageNext = NULL;
 	hashNext = NULL;
 	refCount = 0;
@@ -393,6 +414,7 @@ public:
 	static idCVar		image_downSizeBumpLimit;	// downsize bump limit
 	static idCVar		image_ignoreHighQuality;	// ignore high quality on materials
 	static idCVar		image_downSizeLimit;		// downsize diffuse limit
+	static idCVar		image_parallelLoad;			// decode and mip map level load images on the job threads
 
 	// built-in images
 	idImage *			defaultImage;
@@ -422,6 +444,7 @@ public:
 	idImage *			AllocImage( const char *name );
 	void				SetNormalPalette();
 	void				ChangeTextureFilter();
+	void				LoadImagesInParallel( const idList<idImage *> &loadImages );
 
 	idList<idImage*>	images;
 	idStrList			ddsList;
@@ -492,6 +515,50 @@ bool R_LoadCubeImages( const char *cname, cubeFiles_t extensions, byte *pic[6],
 /*
 ====================================================================
 
+PARALLEL IMAGE LOADING
+
+Images loaded at the end of a level load are decoded and mip mapped on the
+job threads.  The main thread first runs the image program of an image
+without generating it, which reads every file it will need, so the job never
+has to touch the file system.  Errors and warnings raised while the job runs
+are kept with it and reported by the main thread when it uploads the image.
+
+====================================================================
+*/
+
+typedef struct {
+	idStr				name;
+	byte *				buffer;					// NULL if the file couldn't be read
+	int					length;
+	ID_TIME_T			timestamp;
+} imageFile_t;
+
+struct imageLoadJob_t {
+	idImage *			image;
+	bool				gathering;				// true while the main thread reads the files
+	idList<imageFile_t>	files;
+	imageMipChain_t		chain;
+	bool				loaded;					// false if the image program failed
+	bool				missedFile;				// the job asked for a file that wasn't gathered
+	idStr				error;
+	idStrList			warnings;
+	idStrList			messages;
+};
+
+void R_StartImageGather( imageLoadJob_t *job );
+void R_EndImageGather( imageLoadJob_t *job );
+void R_FreeImageFiles( imageLoadJob_t *job );
+void R_ImageLoadJob( imageLoadJob_t *job );
+bool R_InsideImageLoadJob();
+
+// these report to common, unless called from an image load job
+void R_ImageLoadError( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+void R_ImageLoadWarning( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+void R_ImageLoadPrintf( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+
+/*
+====================================================================
+
 IMAGEPROGRAM
 
 ====================================================================
@@ -36,6 +36,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "stb_image.h"
 
 #include "sys/platform.h"
+#include "idlib/hashing/MD4.h"
 
 #include "renderer/tr_local.h"
 
@@ -137,6 +138,227 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 static void LoadJPG( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp );
 
 
+/*
+========================================================================
+
+Image load jobs
+
+The loaders below read their files through R_ReadImageFile, so a job thread
+can decode from the files the main thread gathered for it.
+
+========================================================================
+*/
+
+static ID_THREAD_LOCAL imageLoadJob_t *	imageLoadJob;
+
+/*
+================
+R_StartImageGather
+
+Every file read by the loaders on this thread is kept in the job until R_EndImageGather
+================
+*/
+void R_StartImageGather( imageLoadJob_t *job ) {
+	job->gathering = true;
+	imageLoadJob = job;
+}
+
+/*
+================
+R_EndImageGather
+================
+*/
+void R_EndImageGather( imageLoadJob_t *job ) {
+	job->gathering = false;
+	imageLoadJob = NULL;
+}
+
+/*
+================
+R_FreeImageFiles
+================
+*/
+void R_FreeImageFiles( imageLoadJob_t *job ) {
+	for ( int i = 0; i < job->files.Num(); i++ ) {
+		if ( job->files[i].buffer ) {
+			fileSystem->FreeFile( job->files[i].buffer );
+		}
+	}
+	job->files.Clear();
+}
+
+/*
+================
+R_InsideImageLoadJob
+================
+*/
+bool R_InsideImageLoadJob() {
+	return imageLoadJob != NULL && !imageLoadJob->gathering;
+}
+
+/*
+================
+R_ReadImageFile
+
+Reads the whole file when gathering, even if only the timestamp was asked for,
+because the job will want the contents
+================
+*/
+static int R_ReadImageFile( const char *name, byte **buffer, ID_TIME_T *timestamp ) {
+	imageLoadJob_t *job = imageLoadJob;
+
+	if ( job == NULL ) {
+		return fileSystem->ReadFile( name, (void **)buffer, timestamp );
+	}
+
+	imageFile_t *file = NULL;
+	for ( int i = 0; i < job->files.Num(); i++ ) {
+		if ( job->files[i].name.Icmp( name ) == 0 ) {
+			file = &job->files[i];
+			break;
+		}
+	}
+
+	if ( file == NULL ) {
+		if ( !job->gathering ) {
+			// the image program took a path the gather didn't, let the main thread load it
+			job->missedFile = true;
+			throw idException( name );
+		}
+		file = &job->files.Alloc();
+		file->name = name;
+		file->buffer = NULL;
+		file->length = fileSystem->ReadFile( name, (void **)&file->buffer, &file->timestamp );
+	}
+
+	if ( buffer ) {
+		*buffer = file->buffer;
+	}
+	if ( timestamp ) {
+		*timestamp = file->timestamp;
+	}
+	return file->length;
+}
+
+/*
+================
+R_FreeImageFile
+================
+*/
+static void R_FreeImageFile( void *buffer ) {
+	// gathered files are owned by the job
+	if ( imageLoadJob == NULL ) {
+		fileSystem->FreeFile( buffer );
+	}
+}
+
+/*
+================
+R_ImageLoadError
+
+Image load jobs can't drop to the console, so the error is thrown back to R_ImageLoadJob
+and raised on the main thread when the image is finished
+================
+*/
+void R_ImageLoadError( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( R_InsideImageLoadJob() ) {
+		throw idException( text );
+	}
+	common->Error( "%s", text );
+}
+
+/*
+================
+R_ImageLoadWarning
+================
+*/
+void R_ImageLoadWarning( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( R_InsideImageLoadJob() ) {
+		imageLoadJob->warnings.Append( text );
+	} else {
+		common->Warning( "%s", text );
+	}
+}
+
+/*
+================
+R_ImageLoadPrintf
+================
+*/
+void R_ImageLoadPrintf( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( R_InsideImageLoadJob() ) {
+		imageLoadJob->messages.Append( text );
+	} else {
+		common->Printf( "%s", text );
+	}
+}
+
+/*
+================
+R_ImageLoadJob
+
+Runs the image program of a gathered image and builds its mip chain.
+Everything that needs the main thread is left to idImage::FinishParallelLoad.
+================
+*/
+void R_ImageLoadJob( imageLoadJob_t *job ) {
+	idImage	*image = job->image;
+	byte	*pic = NULL;
+	int		width, height;
+
+	imageLoadJob = job;
+	try {
+		double start = Sys_Microseconds();
+
+		R_LoadImageProgram( image->imgName, &pic, &width, &height, &image->timestamp, &image->depth );
+		if ( pic != NULL ) {
+			image->imageHash = MD4_BlockChecksum( pic, width * height * 4 );
+		}
+		image->decodeTime = ( Sys_Microseconds() - start ) * 0.001;
+
+		if ( pic != NULL && glConfig.isInitialized ) {
+			image->BuildMipChain( pic, width, height, job->chain );
+		}
+		job->loaded = ( pic != NULL );
+	} catch ( idException &ex ) {
+		for ( int i = 0; i < job->chain.numLevels; i++ ) {
+			R_StaticFree( job->chain.data[i] );
+		}
+		job->chain.numLevels = 0;
+		job->loaded = false;
+		if ( !job->missedFile ) {
+			job->error = ex.error;
+		}
+	}
+	imageLoadJob = NULL;
+
+	if ( pic != NULL ) {
+		R_StaticFree( pic );
+	}
+}
+
+
 /*
 ========================================================================
 
@@ -224,7 +446,7 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 	byte		*bmpRGBA;
 
 	if ( !pic ) {
-		fileSystem->ReadFile ( name, NULL, timestamp );
+		R_ReadImageFile( name, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -233,7 +455,7 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 	//
 	// load the file
 	//
-	length = fileSystem->ReadFile( name, (void **)&buffer, timestamp );
+	length = R_ReadImageFile( name, &buffer, timestamp );
 	if ( !buffer ) {
 		return;
 	}
@@ -278,19 +500,19 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 
 	if ( bmpHeader.id[0] != 'B' && bmpHeader.id[1] != 'M' )
 	{
-		common->Error( "LoadBMP: only Windows-style BMP files supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: only Windows-style BMP files supported (%s)\n", name );
 	}
 	if ( bmpHeader.fileSize != length )
 	{
-		common->Error( "LoadBMP: header size does not match file size (%u vs. %d) (%s)\n", bmpHeader.fileSize, length, name );
+		R_ImageLoadError( "LoadBMP: header size does not match file size (%u vs. %d) (%s)\n", bmpHeader.fileSize, length, name );
 	}
 	if ( bmpHeader.compression != 0 )
 	{
-		common->Error( "LoadBMP: only uncompressed BMP files supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: only uncompressed BMP files supported (%s)\n", name );
 	}
 	if ( bmpHeader.bitsPerPixel < 8 )
 	{
-		common->Error( "LoadBMP: monochrome and 4-bit BMP files not supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: monochrome and 4-bit BMP files not supported (%s)\n", name );
 	}
 
 	columns = bmpHeader.width;
@@ -356,13 +578,13 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 				*pixbuf++ = alpha;
 				break;
 			default:
-				common->Error( "LoadBMP: illegal pixel_size '%d' in file '%s'\n", bmpHeader.bitsPerPixel, name );
+				R_ImageLoadError( "LoadBMP: illegal pixel_size '%d' in file '%s'\n", bmpHeader.bitsPerPixel, name );
 				break;
 			}
 		}
 	}
 
-	fileSystem->FreeFile( buffer );
+	R_FreeImageFile( buffer );
 
 }
 
@@ -392,7 +614,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 	int		xmax, ymax;
 
 	if ( !pic ) {
-		fileSystem->ReadFile( filename, NULL, timestamp );
+		R_ReadImageFile( filename, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -402,7 +624,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 	//
 	// load the file
 	//
-	len = fileSystem->ReadFile( filename, (void **)&raw, timestamp );
+	len = R_ReadImageFile( filename, &raw, timestamp );
 	if (!raw) {
 		return;
 	}
@@ -423,7 +645,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 		|| xmax >= 1024
 		|| ymax >= 1024)
 	{
-		common->Printf( "Bad pcx file %s (%i x %i) (%i x %i)\n", filename, xmax+1, ymax+1, pcx->xmax, pcx->ymax);
+		R_ImageLoadPrintf( "Bad pcx file %s (%i x %i) (%i x %i)\n", filename, xmax+1, ymax+1, pcx->xmax, pcx->ymax);
 		return;
 	}
 
@@ -467,12 +689,12 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 
 	if ( raw - (byte *)pcx > len)
 	{
-		common->Printf( "PCX file %s was malformed", filename );
+		R_ImageLoadPrintf( "PCX file %s was malformed", filename );
 		R_StaticFree (*pic);
 		*pic = NULL;
 	}
 
-	fileSystem->FreeFile( pcx );
+	R_FreeImageFile( pcx );
 }
 
 
@@ -488,7 +710,7 @@ static void LoadPCX32 ( const char *filename, byte **pic, int *width, int *heigh
 	byte	*pic32;
 
 	if ( !pic ) {
-		fileSystem->ReadFile( filename, NULL, timestamp );
+		R_ReadImageFile( filename, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 	LoadPCX (filename, &pic8, &palette, width, height, timestamp);
@@ -535,7 +757,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	byte		*targa_rgba;
 
 	if ( !pic ) {
-		fileSystem->ReadFile( name, NULL, timestamp );
+		R_ReadImageFile( name, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -544,7 +766,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	//
 	// load the file
 	//
-	fileSize = fileSystem->ReadFile( name, (void **)&buffer, timestamp );
+	fileSize = R_ReadImageFile( name, &buffer, timestamp );
 	if ( !buffer ) {
 		return;
 	}
@@ -572,21 +794,21 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	targa_header.attributes = *buf_p++;
 
 	if ( targa_header.image_type != 2 && targa_header.image_type != 10 && targa_header.image_type != 3 ) {
-		common->Error( "LoadTGA( %s ): Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported\n", name );
 	}
 
 	if ( targa_header.colormap_type != 0 ) {
-		common->Error( "LoadTGA( %s ): colormaps not supported\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): colormaps not supported\n", name );
 	}
 
 	if ( ( targa_header.pixel_size != 32 && targa_header.pixel_size != 24 ) && targa_header.image_type != 3 ) {
-		common->Error( "LoadTGA( %s ): Only 32 or 24 bit images supported (no colormaps)\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): Only 32 or 24 bit images supported (no colormaps)\n", name );
 	}
 
 	if ( targa_header.image_type == 2 || targa_header.image_type == 3 ) {
 		numBytes = targa_header.width * targa_header.height * ( targa_header.pixel_size >> 3 );
 		if ( numBytes > fileSize - 18 - targa_header.id_length ) {
-			common->Error( "LoadTGA( %s ): incomplete file\n", name );
+			R_ImageLoadError( "LoadTGA( %s ): incomplete file\n", name );
 		}
 	}
 
@@ -650,7 +872,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 					*pixbuf++ = alphabyte;
 					break;
 				default:
-					common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+					R_ImageLoadError( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
 					break;
 				}
 			}
@@ -684,7 +906,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 								alphabyte = *buf_p++;
 								break;
 						default:
-							common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+							R_ImageLoadError( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
 							break;
 					}
 
@@ -729,7 +951,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 									*pixbuf++ = alphabyte;
 									break;
 							default:
-								common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+								R_ImageLoadError( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
 								break;
 						}
 						column++;
@@ -754,7 +976,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 		R_VerticalFlip( *pic, *width, *height );
 	}
 
-	fileSystem->FreeFile( buffer );
+	R_FreeImageFile( buffer );
 }
 
 /*
@@ -768,29 +990,19 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
 		*pic = NULL;		// until proven otherwise
 	}
 
-	idFile *f = fileSystem->OpenFileRead( filename );
-	if ( !f ) {
-		return;
-	}
-	int len = f->Length();
-	if ( timestamp ) {
-		*timestamp = f->Timestamp();
-	}
-	if ( !pic ) {
-		fileSystem->CloseFile( f );
-		return;	// just getting timestamp
+	byte *fbuffer = NULL;
+	int len = R_ReadImageFile( filename, pic ? &fbuffer : NULL, timestamp );
+	if ( !pic || !fbuffer ) {
+		return;	// just getting timestamp, or no file
 	}
-	byte *fbuffer = (byte *)Mem_ClearedAlloc( len );
-	f->Read( fbuffer, len );
-	fileSystem->CloseFile( f );
 
 	int w=0, h=0, comp=0;
 	byte* decodedImageData = stbi_load_from_memory( fbuffer, len, &w, &h, &comp, 4 );
 
-	Mem_Free( fbuffer );
+	R_FreeImageFile( fbuffer );
 
 	if ( decodedImageData == NULL ) {
-		common->Warning( "stb_image was unable to load JPG %s : %s\n",
+		R_ImageLoadWarning( "stb_image was unable to load JPG %s : %s\n",
 					filename, stbi_failure_reason());
 		return;
 	}
@@ -72,6 +72,7 @@ idCVar idImageManager::image_downSizeSpecularLimit( "image_downSizeSpecularLimit
 idCVar idImageManager::image_downSizeBumpLimit( "image_downSizeBumpLimit", "128", CVAR_RENDERER | CVAR_ARCHIVE, "controls normal map downsample limit" );
 idCVar idImageManager::image_ignoreHighQuality( "image_ignoreHighQuality", "0", CVAR_RENDERER | CVAR_ARCHIVE, "ignore high quality setting on materials" );
 idCVar idImageManager::image_downSizeLimit( "image_downSizeLimit", "256", CVAR_RENDERER | CVAR_ARCHIVE, "controls diffuse map downsample limit" );
+idCVar idImageManager::image_parallelLoad( "image_parallelLoad", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "decode and mip map the images of a level load on the job threads" );
 // do this with a pointer, in case we want to make the actual manager
 // a private virtual subclass
 idImageManager	imageManager;
@@ -1151,6 +1152,8 @@ void R_ListImages_f( const idCmdArgs &args ) {
 	bool	duplicated = false;
 	bool	byClassification = false;
 	bool	overSized = false;
+	bool	timing = false;
+	float	readTime = 0.0f, decodeTime = 0.0f, mipTime = 0.0f, uploadTime = 0.0f;
 
 	if ( args.Argc() == 1 ) {
 
@@ -1180,6 +1183,8 @@ void R_ListImages_f( const idCmdArgs &args ) {
 			byClassification = true;
 			sorted = true;
 			overSized = true;
+		} else if ( idStr::Icmp( args.Argv( 1 ), "timing" ) == 0 ) {
+			timing = true;
 		} else {
 			failed = true;
 		}
@@ -1188,11 +1193,15 @@ void R_ListImages_f( const idCmdArgs &args ) {
 	}
 
 	if ( failed ) {
-		common->Printf( "usage: listImages [ sorted | partial | unloaded | cached | uncached | tagged | duplicated | touched | classify | showOverSized ]\n" );
+		common->Printf( "usage: listImages [ sorted | partial | unloaded | cached | uncached | tagged | duplicated | touched | classify | showOverSized | timing ]\n" );
 		return;
 	}
 
 	const char *header = "       -w-- -h-- filt -fmt-- wrap  size --name-------\n";
+	if ( timing ) {
+		// milliseconds spent in each stage of the last load
+		header = "        read  decode    mips  upload --name-------\n";
+	}
 	common->Printf( "\n%s", header );
 
 	totalSize = 0;
@@ -1246,6 +1255,22 @@ void R_ListImages_f( const idCmdArgs &args ) {
 			image->bindCount = 0;
 		}
 
+		if ( timing ) {
+			// without a GL context the images are still decoded, so don't go by texnum
+			if ( image->readTime + image->decodeTime + image->mipTime + image->uploadTime == 0.0f ) {
+				continue;
+			}
+			common->Printf( "%4i: %7.2f %7.2f %7.2f %7.2f %s\n", i, image->readTime, image->decodeTime,
+				image->mipTime, image->uploadTime, image->imgName.c_str() );
+			readTime += image->readTime;
+			decodeTime += image->decodeTime;
+			mipTime += image->mipTime;
+			uploadTime += image->uploadTime;
+			totalSize += image->StorageSize();
+			count++;
+			continue;
+		}
+
 		if ( sorted ) {
 			sortedArray[count].image = image;
 			sortedArray[count].size = image->StorageSize();
@@ -1275,6 +1300,11 @@ void R_ListImages_f( const idCmdArgs &args ) {
 	common->Printf( " %i images (%i total)\n", count, globalImages->images.Num() );
 	common->Printf( " %5.1f total megabytes of images\n\n\n", totalSize / (1024*1024.0) );
 
+	if ( timing ) {
+		common->Printf( " %7.1f ms reading\n %7.1f ms decoding\n %7.1f ms mip mapping\n %7.1f ms uploading\n\n",
+			readTime, decodeTime, mipTime, uploadTime );
+	}
+
 	if ( byClassification ) {
 
 		idList< int > classifications[IC_COUNT];
@@ -2085,6 +2115,7 @@ void idImageManager::EndLevelLoad() {
 	}
 
 	// load the ones we do need, if we are preloading
+	idList<idImage *> loadImages;
 	for ( int i = 0 ; i < images.Num() ; i++ ) {
 		idImage	*image = images[ i ];
 		if ( image->generatorFunction ) {
@@ -2092,6 +2123,28 @@ void idImageManager::EndLevelLoad() {
 		}
 
 		if ( image->levelLoadReferenced && image->texnum == idImage::TEXTURE_NOT_LOADED && !image->partialImage ) {
+			loadImages.Append( image );
+		}
+	}
+
+	// the debug .tga writes happen while the mip chain is built, which has to stay on this thread
+	if ( image_parallelLoad.GetBool() && parallelJobManager->GetNumThreads() > 0
+			&& !image_writeTGA.GetBool() && !image_writeNormalTGA.GetBool() ) {
+		LoadImagesInParallel( loadImages );
+		loadCount = loadImages.Num();
+	} else {
+		// keep the files of the next few images reading in the background while one is loaded
+		const int prefetchAhead = 16;
+		for ( int i = 0 ; i < loadImages.Num() && i < prefetchAhead ; i++ ) {
+			loadImages[ i ]->PrefetchImage();
+		}
+
+		for ( int i = 0 ; i < loadImages.Num() ; i++ ) {
+			idImage	*image = loadImages[ i ];
+			if ( i + prefetchAhead < loadImages.Num() ) {
+				loadImages[ i + prefetchAhead ]->PrefetchImage();
+			}
+
 //			common->Printf( "Loading %s\n", image->imgName.c_str() );
 			loadCount++;
 			image->ActuallyLoadImage( true, false );
@@ -2102,11 +2155,135 @@ void idImageManager::EndLevelLoad() {
 		}
 	}
 
+	float	readTime = 0.0f, decodeTime = 0.0f, mipTime = 0.0f, uploadTime = 0.0f;
+	for ( int i = 0 ; i < loadImages.Num() ; i++ ) {
+		readTime += loadImages[ i ]->readTime;
+		decodeTime += loadImages[ i ]->decodeTime;
+		mipTime += loadImages[ i ]->mipTime;
+		uploadTime += loadImages[ i ]->uploadTime;
+	}
+
 	int	end = Sys_Milliseconds();
 	common->Printf( "%5i purged from previous\n", purgeCount );
 	common->Printf( "%5i kept from previous\n", keepCount );
 	common->Printf( "%5i new loaded\n", loadCount );
 	common->Printf( "all images loaded in %5.1f seconds\n", (end-start) * 0.001 );
+	common->Printf( "%5.1f seconds reading, %5.1f decoding, %5.1f mip mapping, %5.1f uploading\n",
+		readTime * 0.001f, decodeTime * 0.001f, mipTime * 0.001f, uploadTime * 0.001f );
+}
+
+/*
+====================
+R_FreeImageLoadJob
+====================
+*/
+static void R_FreeImageLoadJob( imageLoadJob_t *job ) {
+	R_FreeImageFiles( job );
+	for ( int i = 0 ; i < job->chain.numLevels ; i++ ) {
+		R_StaticFree( job->chain.data[ i ] );
+	}
+	delete job;
+}
+
+/*
+====================
+LoadImagesInParallel
+
+The images are loaded in batches.  While the job threads decode and mip map
+one batch, this thread reads the files of the next one and uploads the one
+before it.  The decode and mip map times of the images are summed over all the
+job threads, so they can add up to more than the wall clock time.
+====================
+*/
+void idImageManager::LoadImagesInParallel( const idList<idImage *> &loadImages ) {
+	const int					prefetchAhead = 16;
+	const int					batchSize = Max( 4, parallelJobManager->GetNumThreads() * 2 );
+	idParallelJobList *			jobLists[2];
+	idList<imageLoadJob_t *>	batches[2];
+	int							nextImage = 0;
+	int							loadCount = 0;
+
+	jobLists[0] = parallelJobManager->AllocJobList( "imageLoad" );
+	jobLists[1] = parallelJobManager->AllocJobList( "imageLoad" );
+
+	for ( int i = 0 ; i < loadImages.Num() && i < prefetchAhead ; i++ ) {
+		loadImages[ i ]->PrefetchImage();
+	}
+
+	try {
+		for ( int b = 0 ; ; b ^= 1 ) {
+			idList<imageLoadJob_t *> &batch = batches[ b ];
+			idList<imageLoadJob_t *> &previous = batches[ b ^ 1 ];
+
+			// read the files of the next batch, images that can't
+			// be built on the job threads are loaded right away
+			while ( batch.Num() < batchSize && nextImage < loadImages.Num() ) {
+				if ( nextImage + prefetchAhead < loadImages.Num() ) {
+					loadImages[ nextImage + prefetchAhead ]->PrefetchImage();
+				}
+
+				imageLoadJob_t *job = new imageLoadJob_t;
+				if ( loadImages[ nextImage++ ]->StartParallelLoad( *job ) ) {
+					batch.Append( job );
+				} else {
+					delete job;
+					if ( ( ++loadCount & 15 ) == 0 ) {
+						session->PacifierUpdate();
+					}
+				}
+			}
+
+			for ( int i = 0 ; i < batch.Num() ; i++ ) {
+				jobLists[ b ]->AddJob( (jobRun_t)R_ImageLoadJob, batch[ i ] );
+			}
+			jobLists[ b ]->Submit();
+
+			if ( previous.Num() ) {
+				jobLists[ b ^ 1 ]->Wait();
+
+				for ( int i = 0 ; i < previous.Num() ; i++ ) {
+					imageLoadJob_t *job = previous[ i ];
+
+					// the files aren't needed anymore
+					R_FreeImageFiles( job );
+
+					if ( job->error.Length() ) {
+						common->Error( "%s", job->error.c_str() );
+					}
+
+					job->image->FinishParallelLoad( *job );
+					R_FreeImageLoadJob( job );
+					previous[ i ] = NULL;
+
+					if ( ( ++loadCount & 15 ) == 0 ) {
+						session->PacifierUpdate();
+					}
+				}
+				previous.Clear();
+			}
+
+			if ( batch.Num() == 0 ) {
+				jobLists[ b ]->Wait();
+				break;
+			}
+		}
+	} catch ( idException & ) {
+		// let the jobs finish before their data goes away
+		for ( int b = 0 ; b < 2 ; b++ ) {
+			jobLists[ b ]->Wait();
+			for ( int i = 0 ; i < batches[ b ].Num() ; i++ ) {
+				if ( batches[ b ][ i ] ) {
+					R_FreeImageLoadJob( batches[ b ][ i ] );
+				}
+			}
+		}
+		parallelJobManager->FreeJobList( jobLists[ 0 ] );
+		parallelJobManager->FreeJobList( jobLists[ 1 ] );
+		throw;
+	}
+
+	parallelJobManager->FreeJobList( jobLists[ 0 ] );
+	parallelJobManager->FreeJobList( jobLists[ 1 ] );
 }
 
 /*
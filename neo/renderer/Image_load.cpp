@@ -498,10 +498,7 @@ There is no way to specify explicit mip map levels
 void idImage::GenerateImage( const byte *pic, int width, int height,
 					   textureFilter_t filterParm, bool allowDownSizeParm,
 					   textureRepeat_t repeatParm, textureDepth_t depthParm ) {
-	bool	preserveBorder;
-	byte		*scaledBuffer;
-	int			scaled_width, scaled_height;
-	byte		*shrunk;
+	imageMipChain_t	chain;
 
 	PurgeImage();
 
@@ -518,6 +515,28 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 		return;
 	}
 
+	BuildMipChain( pic, width, height, chain );
+	UploadMipChain( chain );
+}
+
+/*
+==================
+BuildMipChain
+
+The CPU side of GenerateImage: resamples the image to its upload size,
+selects the internal format and creates every mip level.
+Only reads the image parameters, so it can run on a job thread.
+==================
+*/
+void idImage::BuildMipChain( const byte *pic, int width, int height, imageMipChain_t &chain ) {
+	bool	preserveBorder;
+	byte		*scaledBuffer;
+	int			scaled_width, scaled_height;
+	byte		*shrunk;
+	double		start = Sys_Microseconds();
+
+	chain.numLevels = 0;
+
 	// don't let mip mapping smear the texture into the clamped border
 	if ( repeat == TR_CLAMP_TO_ZERO ) {
 		preserveBorder = true;
@@ -530,7 +549,7 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 	scaled_height = MakePowerOfTwo( height );
 
 	if ( scaled_width != width || scaled_height != height ) {
-		common->Error( "R_CreateImage: not a power of 2 image" );
+		R_ImageLoadError( "R_CreateImage: not a power of 2 image" );
 	}
 
 	// Optionally modify our width/height based on options/hardware
@@ -538,11 +557,8 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 
 	scaledBuffer = NULL;
 
-	// generate the texture number
-	qglGenTextures( 1, &texnum );
-
 	// select proper internal format before we resample
-	internalFormat = SelectInternalFormat( &pic, 1, width, height, depth );
+	chain.internalFormat = SelectInternalFormat( &pic, 1, width, height, depth );
 
 	// copy or resample data as appropriate for first MIP level
 	if ( ( scaled_width == width ) && ( scaled_height == height ) ) {
@@ -583,10 +599,6 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 		scaled_height = height;
 	}
 
-	uploadHeight = scaled_height;
-	uploadWidth = scaled_width;
-	type = TT_2D;
-
 	// zero the border if desired, allowing clamped projection textures
 	// even after picmip resampling or careless artists.
 	if ( repeat == TR_CLAMP_TO_ZERO ) {
@@ -645,32 +657,20 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 			scaledBuffer[ i ] = 0;
 		}
 	}
-	// upload the main image level
-	Bind();
 
+	// the main image level
+	chain.numLevels = 1;
+	chain.width[0] = scaled_width;
+	chain.height[0] = scaled_height;
+	chain.data[0] = scaledBuffer;
 
-	if ( internalFormat == GL_COLOR_INDEX8_EXT ) {
-		/*
-		if ( depth == TD_BUMP ) {
-			for ( int i = 0; i < scaled_width * scaled_height * 4; i += 4 ) {
-				scaledBuffer[ i ] = scaledBuffer[ i + 3 ];
-				scaledBuffer[ i + 3 ] = 0;
-			}
-		}
-		*/
-		UploadCompressedNormalMap( scaled_width, scaled_height, scaledBuffer, 0 );
-	} else {
-		qglTexImage2D( GL_TEXTURE_2D, 0, internalFormat, scaled_width, scaled_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer );
-	}
-
-	// create and upload the mip map levels, which we do in all cases, even if we don't think they are needed
+	// create the mip map levels, which we do in all cases, even if we don't think they are needed
 	int		miplevel;
 
 	miplevel = 0;
-	while ( scaled_width > 1 || scaled_height > 1 ) {
+	while ( ( scaled_width > 1 || scaled_height > 1 ) && chain.numLevels < MAX_IMAGE_LEVELS ) {
 		// preserve the border after mip map unless repeating
 		shrunk = R_MipMap( scaledBuffer, scaled_width, scaled_height, preserveBorder );
-		R_StaticFree( scaledBuffer );
 		scaledBuffer = shrunk;
 
 		scaled_width >>= 1;
@@ -691,23 +691,52 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 			R_BlendOverTexture( (byte *)scaledBuffer, scaled_width * scaled_height, mipBlendColors[miplevel] );
 		}
 
-		// upload the mip map
+		chain.width[chain.numLevels] = scaled_width;
+		chain.height[chain.numLevels] = scaled_height;
+		chain.data[chain.numLevels] = scaledBuffer;
+		chain.numLevels++;
+	}
+
+	mipTime = ( Sys_Microseconds() - start ) * 0.001;
+}
+
+/*
+==================
+UploadMipChain
+
+The GL side of GenerateImage, frees the levels of the chain as they are uploaded
+==================
+*/
+void idImage::UploadMipChain( imageMipChain_t &chain ) {
+	double	start = Sys_Microseconds();
+
+	// generate the texture number
+	qglGenTextures( 1, &texnum );
+
+	internalFormat = chain.internalFormat;
+	uploadWidth = chain.width[0];
+	uploadHeight = chain.height[0];
+	type = TT_2D;
+
+	Bind();
+
+	for ( int miplevel = 0 ; miplevel < chain.numLevels ; miplevel++ ) {
 		if ( internalFormat == GL_COLOR_INDEX8_EXT ) {
-			UploadCompressedNormalMap( scaled_width, scaled_height, scaledBuffer, miplevel );
+			UploadCompressedNormalMap( chain.width[miplevel], chain.height[miplevel], chain.data[miplevel], miplevel );
 		} else {
-			qglTexImage2D( GL_TEXTURE_2D, miplevel, internalFormat, scaled_width, scaled_height,
-				0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer );
+			qglTexImage2D( GL_TEXTURE_2D, miplevel, internalFormat, chain.width[miplevel], chain.height[miplevel],
+				0, GL_RGBA, GL_UNSIGNED_BYTE, chain.data[miplevel] );
 		}
+		R_StaticFree( chain.data[miplevel] );
 	}
-
-	if ( scaledBuffer != 0 ) {
-		R_StaticFree( scaledBuffer );
-	}
+	chain.numLevels = 0;
 
 	SetImageFilterAndRepeat();
 
 	// see if we messed anything up
 	GL_CheckErrors();
+
+	uploadTime = ( Sys_Microseconds() - start ) * 0.001;
 }
 
 
@@ -1359,17 +1388,15 @@ bool idImage::CheckPrecompressedImage( bool fullLoad ) {
 
 	timestamp = precompTimestamp;
 
-	// open it and just read the header
-	idFile *f;
-
-	f = fileSystem->OpenFileRead( filename );
-	if ( !f ) {
+	// read it through ReadFile, it may have been prefetched
+	byte *data;
+	int len = fileSystem->ReadFile( filename, (void **)&data );
+	if ( !data ) {
 		return false;
 	}
 
-	int	len = f->Length();
 	if ( len < sizeof( ddsFileHeader_t ) ) {
-		fileSystem->CloseFile( f );
+		fileSystem->FreeFile( data );
 		return false;
 	}
 
@@ -1383,33 +1410,27 @@ bool idImage::CheckPrecompressedImage( bool fullLoad ) {
 	}
 #endif
 
-	byte *data = (byte *)R_StaticAlloc( len );
-
-	f->Read( data, len );
-
-	fileSystem->CloseFile( f );
-
 	unsigned int magic = LittleInt( *(unsigned int *)data );
 	ddsFileHeader_t	*_header = (ddsFileHeader_t *)(data + 4);
 	int ddspf_dwFlags = LittleInt( _header->ddspf.dwFlags );
 
 	if ( magic != DDS_MAKEFOURCC('D', 'D', 'S', ' ')) {
 		common->Printf( "CheckPrecompressedImage( %s ): magic != 'DDS '\n", imgName.c_str() );
-		R_StaticFree( data );
+		fileSystem->FreeFile( data );
 		return false;
 	}
 
 	// if we don't support color index textures, we must load the full image
 	// should we just expand the 256 color image to 32 bit for upload?
 	if ( ddspf_dwFlags & DDSF_ID_INDEXCOLOR && !glConfig.sharedTexturePaletteAvailable ) {
-		R_StaticFree( data );
+		fileSystem->FreeFile( data );
 		return false;
 	}
 
 	// upload all the levels
 	UploadPrecompressedImage( data, len );
 
-	R_StaticFree( data );
+	fileSystem->FreeFile( data );
 
 	return true;
 }
@@ -1604,14 +1625,20 @@ void	idImage::ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd )
 	} else {
 		// see if we have a pre-generated image file that is
 		// already image processed and compressed
+		double start = Sys_Microseconds();
+		readTime = decodeTime = mipTime = uploadTime = 0.0f;
+
 		if ( checkForPrecompressed && globalImages->image_usePrecompressedTextures.GetBool() ) {
 			if ( CheckPrecompressedImage( true ) ) {
 				// we got the precompressed image
+				readTime = ( Sys_Microseconds() - start ) * 0.001;
 				return;
 			}
 			// fall through to load the normal image
 		}
 
+		// the files are read while the image program runs
+		start = Sys_Microseconds();
 		R_LoadImageProgram( imgName, &pic, &width, &height, &timestamp, &depth );
 
 		if ( pic == NULL ) {
@@ -1636,6 +1663,7 @@ void	idImage::ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd )
 		// NOTE: takes about 10% of image load times (SD)
 		// may not be strictly necessary, but some code uses it, so let's leave it in
 		imageHash = MD4_BlockChecksum( pic, width * height * 4 );
+		decodeTime = ( Sys_Microseconds() - start ) * 0.001;
 
 		GenerateImage( pic, width, height, filter, allowDownSize, repeat, depth );
 		timestamp = timestamp;
@@ -1648,6 +1676,125 @@ void	idImage::ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd )
 	}
 }
 
+/*
+================
+PrefetchImage
+
+Starts reading the file ActuallyLoadImage will most likely read first, in the
+background, so it is in memory when the image gets loaded
+================
+*/
+void idImage::PrefetchImage() {
+	if ( generatorFunction || isPartialImage || cubeFiles != CF_2D ) {
+		return;
+	}
+
+	if ( globalImages->image_usePrecompressedTextures.GetBool() && glConfig.textureCompressionAvailable
+			&& !fileSystem->PerformingCopyFiles() && ( depth != TD_BUMP || globalImages->image_useNormalCompression.GetInteger() == 2 )
+			&& !( com_machineSpec.GetInteger() >= 1 && imgName.Icmpn( "lights/", 7 ) == 0 ) ) {
+		char filename[MAX_IMAGE_NAME];
+		ImageProgramStringToCompressedFileName( imgName, filename );
+		fileSystem->PrefetchFile( filename );
+		return;
+	}
+
+	// image programs combine several files, only plain images are prefetched
+	if ( imgName.Find( '(' ) != -1 ) {
+		return;
+	}
+	idStr name = imgName;
+	name.DefaultFileExtension( ".tga" );
+	name.ToLower();
+	fileSystem->PrefetchFile( name );
+}
+
+/*
+================
+StartParallelLoad
+
+Loads the images that can't be built on a job thread right away and returns false.
+Otherwise runs the image program without generating the image, which reads
+every file it needs into the job, and returns true.  R_ImageLoadJob will then
+decode the image and FinishParallelLoad upload it.
+================
+*/
+bool idImage::StartParallelLoad( imageLoadJob_t &job ) {
+	if ( generatorFunction || isPartialImage || cubeFiles != CF_2D ) {
+		ActuallyLoadImage( true, false );
+		return false;
+	}
+
+	double start = Sys_Microseconds();
+	readTime = decodeTime = mipTime = uploadTime = 0.0f;
+
+	if ( globalImages->image_usePrecompressedTextures.GetBool() ) {
+		if ( CheckPrecompressedImage( true ) ) {
+			readTime = ( Sys_Microseconds() - start ) * 0.001;
+			return false;
+		}
+	}
+
+	job.image = this;
+	job.chain.numLevels = 0;
+	job.loaded = false;
+	job.missedFile = false;
+
+	int			width, height;
+	ID_TIME_T	gatherTimestamp;
+
+	R_StartImageGather( &job );
+	try {
+		R_LoadImageProgram( imgName, NULL, &width, &height, &gatherTimestamp );
+	} catch ( idException & ) {
+		R_EndImageGather( &job );
+		R_FreeImageFiles( &job );
+		throw;
+	}
+	R_EndImageGather( &job );
+
+	readTime = ( Sys_Microseconds() - start ) * 0.001;
+	return true;
+}
+
+/*
+================
+FinishParallelLoad
+
+Reports what the job had to say and uploads the mip chain it built.
+Errors are raised by the caller, after it has waited for the other jobs.
+================
+*/
+void idImage::FinishParallelLoad( imageLoadJob_t &job ) {
+	for ( int i = 0; i < job.messages.Num(); i++ ) {
+		common->Printf( "%s", job.messages[i].c_str() );
+	}
+	for ( int i = 0; i < job.warnings.Num(); i++ ) {
+		common->Warning( "%s", job.warnings[i].c_str() );
+	}
+
+	if ( job.missedFile ) {
+		// the image program wanted a file the gather didn't read, so do it the slow way
+		ActuallyLoadImage( false, false );
+		return;
+	}
+
+	if ( !job.loaded ) {
+		common->Warning( "Couldn't load image: %s", imgName.c_str() );
+		MakeDefault();
+		return;
+	}
+
+	// same as GenerateImage, with the mip chain already built
+	PurgeImage();
+	if ( glConfig.isInitialized ) {
+		UploadMipChain( job.chain );
+	}
+	precompressedFile = false;
+
+	// write out the precompressed version of this file if needed
+	WritePrecompressedImage();
+}
+
 //=========================================================================================================
 
 /*
@@ -330,8 +330,9 @@ static void R_ImageAdd( byte *data1, int width1, int height1, byte *data2, int w
 }
 
 
-// we build a canonical token form of the image program here
-static char parseBuffer[MAX_IMAGE_NAME];
+// we build a canonical token form of the image program here,
+// one per thread so image load jobs can run image programs
+static ID_THREAD_LOCAL char parseBuffer[MAX_IMAGE_NAME];
 
 /*
 ===================
@@ -614,6 +615,10 @@ void R_LoadImageProgram( const char *name, byte **pic, int *width, int *height,
 
 	src.LoadMemory( name, strlen(name), name );
 	src.SetFlags( LEXFL_NOFATALERRORS | LEXFL_NOSTRINGCONCAT | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES );
+	if ( R_InsideImageLoadJob() ) {
+		// the main thread already parsed it once while gathering the files and reported any problems
+		src.SetFlags( src.GetFlags() | LEXFL_NOERRORS | LEXFL_NOWARNINGS );
+	}
 
 	parseBuffer[0] = 0;
 	if ( timestamps ) {
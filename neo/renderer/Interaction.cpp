@@ -449,6 +449,8 @@ idInteraction::idInteraction( void ) {
 	entityNext				= NULL;
 	entityPrev				= NULL;
 	dynamicModelFrameCount	= 0;
+	entityRevision			= 0;
+	lightRevision			= 0;
 	frustumState			= FRUSTUM_UNINITIALIZED;
 	frustumAreas			= NULL;
 }
@@ -469,6 +471,8 @@ idInteraction *idInteraction::AllocAndLink( idRenderEntityLocal *edef, idRenderL
 
 	// link and initialize
 	interaction->dynamicModelFrameCount = 0;
+	interaction->entityRevision = edef->revision;
+	interaction->lightRevision = ldef->revision;
 
 	interaction->lightDef = ldef;
 	interaction->entityDef = edef;
@@ -808,6 +812,111 @@ bool idInteraction::CullInteractionByViewFrustum( const idFrustum &viewFrustum )
 	return false;
 }
 
+/*
+===============================================================================
+
+	Shadow volume jobs
+
+	The shadow volumes of the interactions created while building a view are
+	independent of each other, so they are queued up and created on the job
+	threads.  Each queued surface interaction is written by exactly one job,
+	and the surfaces are linked afterwards in the original order, so the
+	resulting draw lists do not depend on the job scheduling.
+
+===============================================================================
+*/
+
+typedef struct {
+	surfaceInteraction_t *		sint;
+	const idRenderEntityLocal *	entityDef;
+	const idRenderLightLocal *	lightDef;
+	shadowGen_t					shadowGen;
+} shadowJob_t;
+
+static bool					shadowJobsActive;
+static idList<shadowJob_t>	shadowJobs;
+
+/*
+====================
+R_CreateInteractionShadow
+====================
+*/
+static void R_CreateInteractionShadow( surfaceInteraction_t *sint, const idRenderEntityLocal *entityDef,
+									  const idRenderLightLocal *lightDef, shadowGen_t shadowGen ) {
+	sint->shadowTris = R_CreateShadowVolume( entityDef, sint->ambientTris, lightDef, shadowGen, sint->cullInfo );
+	if ( sint->shadowTris ) {
+		if ( sint->shader->Coverage() != MC_OPAQUE || ( !r_skipSuppress.GetBool() && entityDef->parms.suppressSurfaceInViewID ) ) {
+			// if any surface is a shadow-casting perforated or translucent surface, or the
+			// base surface is suppressed in the view (world weapon shadows) we can't use
+			// the external shadow optimizations because we can see through some of the faces
+			sint->shadowTris->numShadowIndexesNoCaps = sint->shadowTris->numIndexes;
+			sint->shadowTris->numShadowIndexesNoFrontCaps = sint->shadowTris->numIndexes;
+		}
+	}
+}
+
+/*
+====================
+R_CreateInteractionShadowJob
+====================
+*/
+static void R_CreateInteractionShadowJob( void *data ) {
+	shadowJob_t *job = (shadowJob_t *)data;
+
+	R_CreateInteractionShadow( job->sint, job->entityDef, job->lightDef, job->shadowGen );
+}
+
+/*
+====================
+R_BeginShadowJobs
+====================
+*/
+void R_BeginShadowJobs( void ) {
+	assert( !shadowJobsActive );
+	shadowJobsActive = true;
+	shadowJobs.SetNum( 0, false );
+}
+
+/*
+====================
+R_EndShadowJobs
+
+Creates all the queued shadow volumes and waits for them to finish.
+====================
+*/
+void R_EndShadowJobs( idParallelJobList *jobList ) {
+	assert( shadowJobsActive );
+	shadowJobsActive = false;
+
+	if ( shadowJobs.Num() == 0 ) {
+		return;
+	}
+
+	double start = Sys_Microseconds();
+
+	// the list doesn't grow anymore, so the jobs can point into it
+	for ( int i = 0; i < shadowJobs.Num(); i++ ) {
+		jobList->AddJob( R_CreateInteractionShadowJob, &shadowJobs[i] );
+	}
+	jobList->Submit();
+	jobList->Wait();
+
+	R_AddJobPerformanceCounters();
+
+	tr.pc.c_shadowJobs += shadowJobs.Num();
+	tr.pc.c_shadowJobBatches++;
+	tr.pc.shadowJobUsec += (int)( Sys_Microseconds() - start );
+
+	// free the cull information that CreateInteraction kept around for the jobs
+	for ( int i = 0; i < shadowJobs.Num(); i++ ) {
+		surfaceInteraction_t *sint = shadowJobs[i].sint;
+		if ( sint->lightTris != LIGHT_TRIS_DEFERRED ) {
+			R_FreeInteractionCullInfo( sint->cullInfo );
+		}
+	}
+	shadowJobs.SetNum( 0, false );
+}
+
 /*
 ====================
 idInteraction::CreateInteraction
@@ -830,6 +939,9 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 
 	tr.pc.c_createInteractions++;
 
+	entityRevision = entityDef->revision;
+	lightRevision = lightDef->revision;
+
 	bounds = model->Bounds( &entityDef->parms );
 
 	// if it doesn't contact the light frustum, none of the surfaces will
@@ -882,6 +994,7 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 		}
 
 		surfaceInteraction_t *sint = &surfaces[c];
+		bool shadowQueued = false;
 
 		sint->shader = shader;
 
@@ -913,22 +1026,28 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 			if ( lightDef->parms.prelightModel == NULL || !model->IsStaticWorldModel() || !r_useOptimizedShadows.GetBool() ) {
 
 				// this is the only place during gameplay (outside the utilities) that R_CreateShadowVolume() is called
-				sint->shadowTris = R_CreateShadowVolume( entityDef, tri, lightDef, shadowGen, sint->cullInfo );
-				if ( sint->shadowTris ) {
-					if ( shader->Coverage() != MC_OPAQUE || ( !r_skipSuppress.GetBool() && entityDef->parms.suppressSurfaceInViewID ) ) {
-						// if any surface is a shadow-casting perforated or translucent surface, or the
-						// base surface is suppressed in the view (world weapon shadows) we can't use
-						// the external shadow optimizations because we can see through some of the faces
-						sint->shadowTris->numShadowIndexesNoCaps = sint->shadowTris->numIndexes;
-						sint->shadowTris->numShadowIndexesNoFrontCaps = sint->shadowTris->numIndexes;
+				if ( shadowJobsActive ) {
+					// the face planes are shared by all the interactions of the surface,
+					// so they have to be derived before the jobs run
+					if ( !tri->facePlanes || !tri->facePlanesCalculated ) {
+						R_DeriveFacePlanes( tri );
 					}
+					shadowJob_t &job = shadowJobs.Alloc();
+					job.sint = sint;
+					job.entityDef = entityDef;
+					job.lightDef = lightDef;
+					job.shadowGen = shadowGen;
+					shadowQueued = true;
+				} else {
+					R_CreateInteractionShadow( sint, entityDef, lightDef, shadowGen );
 				}
 				interactionGenerated = true;
 			}
 		}
 
 		// free the cull information when it's no longer needed
-		if ( sint->lightTris != LIGHT_TRIS_DEFERRED ) {
+		// R_EndShadowJobs frees it for the queued shadows
+		if ( sint->lightTris != LIGHT_TRIS_DEFERRED && !shadowQueued ) {
 			R_FreeInteractionCullInfo( sint->cullInfo );
 		}
 	}
@@ -1024,12 +1143,23 @@ instantiate the dynamic model to find out
 ==================
 */
 void idInteraction::AddActiveInteraction( void ) {
+	idScreenRect	shadowScissor;
+
+	if ( PrepareActiveInteraction( shadowScissor ) ) {
+		LinkActiveInteraction( shadowScissor );
+	}
+}
+
+/*
+==================
+idInteraction::PrepareActiveInteraction
+
+Culls the interaction and creates it if needed
+==================
+*/
+bool idInteraction::PrepareActiveInteraction( idScreenRect &shadowScissor ) {
 	viewLight_t *	vLight;
 	viewEntity_t *	vEntity;
-	idScreenRect	shadowScissor;
-	idScreenRect	lightScissor;
-	idVec3			localLightOrigin;
-	idVec3			localViewOrigin;
 
 	vLight = lightDef->viewLight;
 	vEntity = entityDef->viewEntity;
@@ -1052,7 +1182,7 @@ void idInteraction::AddActiveInteraction( void ) {
 		// this will also cull the case where the light origin is inside the
 		// view frustum and the entity bounds are outside the view frustum
 		if ( CullInteractionByViewFrustum( tr.viewDef->viewFrustum ) ) {
-			return;
+			return false;
 		}
 
 		// calculate the shadow scissor rectangle
@@ -1061,7 +1191,7 @@ void idInteraction::AddActiveInteraction( void ) {
 
 	// get out before making the dynamic model if the shadow scissor rectangle is empty
 	if ( shadowScissor.IsEmpty() ) {
-		return;
+		return false;
 	}
 
 	// We will need the dynamic surface created to make interactions, even if the
@@ -1069,7 +1199,7 @@ void idInteraction::AddActiveInteraction( void ) {
 	// has been generated once in the view.
 	idRenderModel *model = R_EntityDefDynamicModel( entityDef );
 	if ( model == NULL || model->NumSurfaces() <= 0 ) {
-		return;
+		return false;
 	}
 
 	// the dynamic model may have changed since we built the surface list
@@ -1078,11 +1208,42 @@ void idInteraction::AddActiveInteraction( void ) {
 	}
 	dynamicModelFrameCount = entityDef->dynamicModelFrameCount;
 
+	// the entity or light may have been updated in a way that kept the interaction,
+	// but not the surfaces
+	if ( !IsDeferred() ) {
+		if ( entityDef->revision != entityRevision || lightDef->revision != lightRevision ) {
+			tr.pc.c_interactionCacheStale++;
+			FreeSurfaces();
+		} else {
+			tr.pc.c_interactionCacheHits++;
+		}
+	}
+
 	// actually create the interaction if needed, building light and shadow surfaces as needed
 	if ( IsDeferred() ) {
 		CreateInteraction( model );
 	}
 
+	return true;
+}
+
+/*
+==================
+idInteraction::LinkActiveInteraction
+
+Adds the light and shadow surfaces of a prepared interaction to the view
+==================
+*/
+void idInteraction::LinkActiveInteraction( const idScreenRect &shadowScissor ) {
+	viewLight_t *	vLight;
+	viewEntity_t *	vEntity;
+	idScreenRect	lightScissor;
+	idVec3			localLightOrigin;
+	idVec3			localViewOrigin;
+
+	vLight = lightDef->viewLight;
+	vEntity = entityDef->viewEntity;
+
 	R_GlobalPointToLocal( vEntity->modelMatrix, lightDef->globalLightOrigin, localLightOrigin );
 	R_GlobalPointToLocal( vEntity->modelMatrix, tr.viewDef->renderView.vieworg, localViewOrigin );
 
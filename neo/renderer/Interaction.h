@@ -93,6 +93,7 @@ typedef struct areaNumRef_s {
 
 class idRenderEntityLocal;
 class idRenderLightLocal;
+class idParallelJobList;
 
 class idInteraction {
 public:
@@ -150,6 +151,12 @@ public:
 	// calls R_LinkLightSurf() for each one
 	void					AddActiveInteraction( void );
 
+	// the two halves of AddActiveInteraction, so the shadow volumes created by
+	// the first half can be batched with R_BeginShadowJobs / R_EndShadowJobs
+	// returns false if there is nothing to link
+	bool					PrepareActiveInteraction( idScreenRect &shadowScissor );
+	void					LinkActiveInteraction( const idScreenRect &shadowScissor );
+
 private:
 	enum {
 		FRUSTUM_UNINITIALIZED,
@@ -161,6 +168,8 @@ private:
 	areaNumRef_t *			frustumAreas;			// numbers of the areas the frustum touches
 
 	int						dynamicModelFrameCount;	// so we can tell if a callback model animated
+	int						entityRevision;			// revisions of the entity and light the surfaces
+	int						lightRevision;			// were created from
 
 private:
 	// actually create the interaction
@@ -183,6 +192,11 @@ void R_CalcInteractionFacing( const idRenderEntityLocal *ent, const srfTriangles
 void R_CalcInteractionCullBits( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo );
 void R_FreeInteractionCullInfo( srfCullInfo_t &cullInfo );
 
+// while a batch is open, CreateInteraction queues the shadow volumes instead of
+// creating them, and R_EndShadowJobs creates them all on the job threads
+void R_BeginShadowJobs( void );
+void R_EndShadowJobs( idParallelJobList *jobList );
+
 void R_ShowInteractionMemory_f( const idCmdArgs &args );
 
 #endif /* !__INTERACTION_H__ */
@@ -497,6 +497,15 @@ idRenderModel *idRenderModelStatic::InstantiateDynamicModel( const struct render
 	return NULL;
 }
 
+/*
+================
+idRenderModelStatic::CanInstantiateInParallel
+================
+*/
+bool idRenderModelStatic::CanInstantiateInParallel( const struct renderEntity_s *ent ) const {
+	return false;
+}
+
 /*
 ================
 idRenderModelStatic::NumJoints
@@ -547,7 +556,7 @@ const idJointQuat *idRenderModelStatic::GetDefaultPose( void ) const {
 idRenderModelStatic::NearestJoint
 ================
 */
-int idRenderModelStatic::NearestJoint( int surfaceNum, int a, int b, int c ) const {
+int idRenderModelStatic::NearestJoint( int surfaceId, int a, int b, int c ) const {
 	return INVALID_JOINT;
 }
 
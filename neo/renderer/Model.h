@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #define __MODEL_H__
 
 #include "idlib/bv/Bounds.h"
+#include "idlib/geometry/DrawVert.h"
 #include "renderer/Material.h"
 
 /*
@@ -100,6 +101,8 @@ typedef struct srfTriangles_s {
 
 	int							numVerts;				// number of vertices
 	idDrawVert *				verts;					// vertices, allocated with special allocator
+	drawVertStreams_t			streams;				// structure-of-arrays copy of the verts of deforming surfaces,
+														// only allocated when r_useVertexStreams is set
 
 	int							numIndexes;				// for shadows, this has both front and rear end caps and silhouette planes
 	glIndex_t *					indexes;				// indexes, allocated with special allocator
@@ -291,6 +294,11 @@ public:
 	// wasn't precached correctly.
 	virtual idRenderModel *		InstantiateDynamicModel( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel ) = 0;
 
+	// returns true if InstantiateDynamicModel can run on a job thread for this entity,
+	// it must not write any shared state other than the tri surface allocators,
+	// performance counters must go through R_ThreadPerformanceCounters
+	virtual bool				CanInstantiateInParallel( const struct renderEntity_s *ent ) const = 0;
+
 	// Returns the number of joints or 0 if the model is not an MD5
 	virtual int					NumJoints( void ) const = 0;
 
@@ -306,8 +314,9 @@ public:
 	// Returns the default animation pose or NULL if the model is not an MD5.
 	virtual const idJointQuat *	GetDefaultPose( void ) const = 0;
 
-	// Returns number of the joint nearest to the given triangle.
-	virtual int					NearestJoint( int surfaceNum, int a, int c, int b ) const = 0;
+	// Returns number of the joint nearest to the given triangle of the surface with
+	// the given id in the instantiated model.
+	virtual int					NearestJoint( int surfaceId, int a, int c, int b ) const = 0;
 
 	// Writing to and reading from a demo file.
 	virtual void				ReadFromDemoFile( class idDemoFile *f ) = 0;
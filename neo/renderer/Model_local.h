@@ -77,12 +77,13 @@ public:
 	virtual bool				IsDefaultModel() const;
 	virtual bool				IsReloadable() const;
 	virtual idRenderModel *		InstantiateDynamicModel( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel );
+	virtual bool				CanInstantiateInParallel( const struct renderEntity_s *ent ) const;
 	virtual int					NumJoints( void ) const;
 	virtual const idMD5Joint *	GetJoints( void ) const;
 	virtual jointHandle_t		GetJointHandle( const char *name ) const;
 	virtual const char *		GetJointName( jointHandle_t handle ) const;
 	virtual const idJointQuat *	GetDefaultPose( void ) const;
-	virtual int					NearestJoint( int surfaceNum, int a, int b, int c ) const;
+	virtual int					NearestJoint( int surfaceId, int a, int b, int c ) const;
 	virtual idBounds			Bounds( const struct renderEntity_s *ent ) const;
 	virtual void				ReadFromDemoFile( class idDemoFile *f );
 	virtual void				WriteToDemoFile( class idDemoFile *f );
@@ -161,10 +162,10 @@ private:
 	const idMaterial *			shader;				// material applied to mesh
 	int							numTris;			// number of triangles
 	struct deformInfo_s *		deformInfo;			// used to create srfTriangles_t from base frames and new vertexes
-	int							surfaceNum;			// number of the static surface created for this mesh
 
 	void						TransformVerts( idDrawVert *verts, const idJointMat *joints );
 	void						TransformScaledVerts( idDrawVert *verts, const idJointMat *joints, float scale );
+	void						UpdateSurfaceStreams( const struct renderEntity_s *ent, const idJointMat *joints, srfTriangles_t *tri );
 };
 
 class idRenderModelMD5 : public idRenderModelStatic {
@@ -179,12 +180,13 @@ public:
 	virtual void				LoadModel();
 	virtual int					Memory() const;
 	virtual idRenderModel *		InstantiateDynamicModel( const struct renderEntity_s *ent, const struct viewDef_s *view, idRenderModel *cachedModel );
+	virtual bool				CanInstantiateInParallel( const struct renderEntity_s *ent ) const;
 	virtual int					NumJoints( void ) const;
 	virtual const idMD5Joint *	GetJoints( void ) const;
 	virtual jointHandle_t		GetJointHandle( const char *name ) const;
 	virtual const char *		GetJointName( jointHandle_t handle ) const;
 	virtual const idJointQuat *	GetDefaultPose( void ) const;
-	virtual int					NearestJoint( int surfaceNum, int a, int b, int c ) const;
+	virtual int					NearestJoint( int surfaceId, int a, int b, int c ) const;
 
 private:
 	idList<idMD5Joint>			joints;
@@ -62,7 +62,6 @@ idMD5Mesh::idMD5Mesh() {
 	shader			= NULL;
 	numTris			= 0;
 	deformInfo		= NULL;
-	surfaceNum		= 0;
 }
 
 /*
@@ -274,10 +273,11 @@ idMD5Mesh::UpdateSurface
 void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, modelSurface_t *surf ) {
 	int i, base;
 	srfTriangles_t *tri;
+	performanceCounters_t &pc = R_ThreadPerformanceCounters();
 
-	tr.pc.c_deformedSurfaces++;
-	tr.pc.c_deformedVerts += deformInfo->numOutputVerts;
-	tr.pc.c_deformedIndexes += deformInfo->numIndexes;
+	pc.c_deformedSurfaces++;
+	pc.c_deformedVerts += deformInfo->numOutputVerts;
+	pc.c_deformedIndexes += deformInfo->numIndexes;
 
 	surf->shader = shader;
 
@@ -321,14 +321,21 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 		}
 	}
 
-	if ( ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] != 0.0f ) {
-		TransformScaledVerts( tri->verts, entJoints, ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] );
+	base = deformInfo->numOutputVerts - deformInfo->numMirroredVerts;
+
+	if ( r_useVertexStreams.GetBool() ) {
+		UpdateSurfaceStreams( ent, entJoints, tri );
 	} else {
-		TransformVerts( tri->verts, entJoints );
+		R_FreeStaticTriSurfStreams( tri );
+
+		if ( ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] != 0.0f ) {
+			TransformScaledVerts( tri->verts, entJoints, ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] );
+		} else {
+			TransformVerts( tri->verts, entJoints );
+		}
 	}
 
 	// replicate the mirror seam vertexes
-	base = deformInfo->numOutputVerts - deformInfo->numMirroredVerts;
 	for ( i = 0; i < deformInfo->numMirroredVerts; i++ ) {
 		tri->verts[base + i] = tri->verts[deformInfo->mirroredVerts[i]];
 	}
@@ -345,6 +352,42 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 	}
 }
 
+/*
+====================
+idMD5Mesh::UpdateSurfaceStreams
+
+Skins into the position stream of the surface, which is then copied to the
+verts. R_DeriveTangents works on the streams as well.
+====================
+*/
+void idMD5Mesh::UpdateSurfaceStreams( const struct renderEntity_s *ent, const idJointMat *entJoints, srfTriangles_t *tri ) {
+	int i, base;
+
+	if ( tri->streams.xyz == NULL ) {
+		R_AllocStaticTriSurfStreams( tri, tri->numVerts );
+		for ( i = 0; i < deformInfo->numSourceVerts; i++ ) {
+			tri->streams.st[i] = texCoords[i];
+		}
+	}
+
+	const idVec4 *weights = scaledWeights;
+	if ( ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] != 0.0f ) {
+		idVec4 *skinScaledWeights = (idVec4 *) _alloca16( numWeights * sizeof( skinScaledWeights[0] ) );
+		SIMDProcessor->Mul( skinScaledWeights[0].ToFloatPtr(), ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ], scaledWeights[0].ToFloatPtr(), numWeights * 4 );
+		weights = skinScaledWeights;
+	}
+	SIMDProcessor->TransformVertsSoA( tri->streams.xyz, texCoords.Num(), entJoints, weights, weightIndex, numWeights );
+
+	// replicate the mirror seam vertexes
+	base = deformInfo->numOutputVerts - deformInfo->numMirroredVerts;
+	for ( i = 0; i < deformInfo->numMirroredVerts; i++ ) {
+		tri->streams.xyz[base + i] = tri->streams.xyz[deformInfo->mirroredVerts[i]];
+		tri->streams.st[base + i] = tri->streams.st[deformInfo->mirroredVerts[i]];
+	}
+
+	R_CopyStreamPositionsToVerts( tri );
+}
+
 /*
 ====================
 idMD5Mesh::CalcBounds
@@ -352,11 +395,12 @@ idMD5Mesh::CalcBounds
 */
 idBounds idMD5Mesh::CalcBounds( const idJointMat *entJoints ) {
 	idBounds	bounds;
-	idDrawVert *verts = (idDrawVert *) _alloca16( texCoords.Num() * sizeof( idDrawVert ) );
+	idVec3 *	xyz = (idVec3 *) _alloca16( texCoords.Num() * sizeof( idVec3 ) );
 
-	TransformVerts( verts, entJoints );
+	// only the positions are needed
+	SIMDProcessor->TransformVertsSoA( xyz, texCoords.Num(), entJoints, scaledWeights, weightIndex, numWeights );
 
-	SIMDProcessor->MinMax( bounds[0], bounds[1], verts, texCoords.Num() );
+	SIMDProcessor->MinMax( bounds[0], bounds[1], xyz, texCoords.Num() );
 
 	return bounds;
 }
@@ -743,7 +787,7 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 		return NULL;
 	}
 
-	tr.pc.c_generateMd5++;
+	R_ThreadPerformanceCounters().c_generateMd5++;
 
 	if ( cachedModel ) {
 		assert( dynamic_cast<idRenderModelStatic *>(cachedModel) != NULL );
@@ -779,21 +823,18 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 
 		if ( !shader || ( !shader->IsDrawn() && !shader->SurfaceCastsShadow() ) ) {
 			staticModel->DeleteSurfaceWithId( i );
-			mesh->surfaceNum = -1;
 			continue;
 		}
 
 		modelSurface_t *surf;
 
 		if ( staticModel->FindSurfaceWithId( i, surfaceNum ) ) {
-			mesh->surfaceNum = surfaceNum;
 			surf = &staticModel->surfaces[surfaceNum];
 		} else {
 
 			// Remove Overlays before adding new surfaces
 			idRenderModelOverlay::RemoveOverlaySurfacesFromModel( staticModel );
 
-			mesh->surfaceNum = staticModel->NumSurfaces();
 			surf = &staticModel->surfaces.Alloc();
 			surf->geometry = NULL;
 			surf->shader = NULL;
@@ -809,6 +850,19 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 	return staticModel;
 }
 
+/*
+====================
+idRenderModelMD5::CanInstantiateInParallel
+
+  everything that would print, reload or draw debug lines is left to the main thread,
+  the remaining work only reads the shared model and writes to the entity's own
+  cached model, the tri surface allocators and the counters of the job thread
+====================
+*/
+bool idRenderModelMD5::CanInstantiateInParallel( const struct renderEntity_s *ent ) const {
+	return !purged && ent->joints != NULL && ent->numJoints == joints.Num() && !r_showSkel.GetInteger();
+}
+
 /*
 ====================
 idRenderModelMD5::IsDynamicModel
@@ -882,20 +936,12 @@ const char *idRenderModelMD5::GetJointName( jointHandle_t handle ) const {
 idRenderModelMD5::NearestJoint
 ====================
 */
-int idRenderModelMD5::NearestJoint( int surfaceNum, int a, int b, int c ) const {
-	int i;
-	const idMD5Mesh *mesh;
-
-	if ( surfaceNum > meshes.Num() ) {
-		common->Error( "idRenderModelMD5::NearestJoint: surfaceNum > meshes.Num()" );
-	}
-
-	for ( mesh = meshes.Ptr(), i = 0; i < meshes.Num(); i++, mesh++ ) {
-		if ( mesh->surfaceNum == surfaceNum ) {
-			return mesh->NearestJoint( a, b, c );
-		}
+int idRenderModelMD5::NearestJoint( int surfaceId, int a, int b, int c ) const {
+	// the surfaces of an instantiated md5 use the mesh number as id
+	if ( surfaceId < 0 || surfaceId >= meshes.Num() ) {
+		return 0;
 	}
-	return 0;
+	return meshes[surfaceId].NearestJoint( a, b, c );
 }
 
 /*
@@ -38,9 +38,15 @@ idRenderEntityLocal::idRenderEntityLocal() {
 	index					= 0;
 	lastModifiedFrameNum	= 0;
 	archived				= false;
+	revision				= 0;
 	dynamicModel			= NULL;
 	dynamicModelFrameCount	= 0;
 	cachedDynamicModel		= NULL;
+	skinnedModel			= NULL;
+	skinnedSkin				= NULL;
+	skinnedShader			= NULL;
+	skinnedScale			= 0.0f;
+	skinnedFrameCount		= 0;
 	referenceBounds			= bounds_zero;
 	viewCount				= 0;
 	viewEntity				= NULL;
@@ -90,6 +96,7 @@ idRenderLightLocal::idRenderLightLocal() {
 	areaNum					= 0;
 	lastModifiedFrameNum	= 0;
 	archived				= false;
+	revision				= 0;
 	lightShader				= NULL;
 	falloffImage			= NULL;
 	globalLightOrigin		= vec3_zero;
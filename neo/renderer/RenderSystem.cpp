@@ -80,9 +80,11 @@ static void R_PerformanceCounters( void ) {
 	}
 
 	if ( r_showDynamic.GetBool() ) {
-		common->Printf( "callback:%i md5:%i dfrmVerts:%i dfrmTris:%i tangTris:%i guis:%i\n",
+		common->Printf( "callback:%i md5:%i skinReuse:%i/%i dfrmVerts:%i dfrmTris:%i tangTris:%i guis:%i\n",
 			tr.pc.c_entityDefCallbacks,
 			tr.pc.c_generateMd5,
+			tr.pc.c_skinCacheViewHits,
+			tr.pc.c_skinCacheFrameHits,
 			tr.pc.c_deformedVerts,
 			tr.pc.c_deformedIndexes/3,
 			tr.pc.c_tangentIndexes/3,
@@ -103,19 +105,25 @@ static void R_PerformanceCounters( void ) {
 	if ( r_showInteractions.GetBool() ) {
 		common->Printf( "createInteractions:%i createLightTris:%i createShadowVolumes:%i\n",
 			tr.pc.c_createInteractions, tr.pc.c_createLightTris, tr.pc.c_createShadowVolumes );
+		common->Printf( "cacheHits:%i cacheStale:%i keptEntityUpdates:%i keptLightUpdates:%i\n",
+			tr.pc.c_interactionCacheHits, tr.pc.c_interactionCacheStale,
+			tr.pc.c_entityUpdatesKept, tr.pc.c_lightUpdatesKept );
+	}
+	if ( r_showShadowJobs.GetBool() ) {
+		common->Printf( "shadowJobs:%i batches:%i wait:%.2f msec\n",
+			tr.pc.c_shadowJobs, tr.pc.c_shadowJobBatches, tr.pc.shadowJobUsec * 0.001f );
 	}
 	if ( r_showDefs.GetBool() ) {
 		common->Printf( "viewEntities:%i  shadowEntities:%i  viewLights:%i\n", tr.pc.c_visibleViewEntities,
 			tr.pc.c_shadowViewEntities, tr.pc.c_viewLights );
 	}
 	if ( r_showUpdates.GetBool() ) {
-		common->Printf( "entityUpdates:%i  entityRefs:%i  lightUpdates:%i  lightRefs:%i\n",
-			tr.pc.c_entityUpdates, tr.pc.c_entityReferences,
+		common->Printf( "entityUpdates:%i  entityRefs:%i (%i kept)  lightUpdates:%i  lightRefs:%i\n",
+			tr.pc.c_entityUpdates, tr.pc.c_entityReferences, tr.pc.c_entityReferencesKept,
 			tr.pc.c_lightUpdates, tr.pc.c_lightReferences );
 	}
 	if ( r_showMemory.GetBool() ) {
-		int	m1 = frameData ? frameData->memoryHighwater : 0;
-		common->Printf( "frameData: %i (%i)\n", R_CountFrameData(), m1 );
+		R_PrintFrameData();
 	}
 	if ( r_showLightScale.GetBool() ) {
 		common->Printf( "lightScale: %f\n", backEnd.pc.maxLightValue );
@@ -150,7 +158,14 @@ static void R_IssueRenderCommands( void ) {
 	// r_skipRender is usually more usefull, because it will still
 	// draw 2D graphics
 	if ( !r_skipBackEnd.GetBool() ) {
-		RB_ExecuteBackEndCommands( frameData->cmdHead );
+		// the front end has finished writing the frame temp data
+		vertexCache.UploadFrameTemp();
+
+		if ( tr.nullBackend ) {
+			RB_NullExecuteBackEndCommands( frameData->cmdHead );
+		} else {
+			RB_ExecuteBackEndCommands( frameData->cmdHead );
+		}
 	}
 
 	R_ClearCommandChain();
@@ -680,6 +695,11 @@ void idRenderSystemLocal::EndFrame( int *frontEndMsec, int *backEndMsec ) {
 	if ( backEndMsec ) {
 		*backEndMsec = backEnd.pc.msec;
 	}
+	frameTimings.frontEndUsec = pc.frontEndUsec;
+	frameTimings.backEndUsec = backEnd.pc.usec;
+	frameTimings.addLightsUsec = pc.addLightsUsec;
+	frameTimings.addModelsUsec = pc.addModelsUsec;
+	frameTimings.shadowUsec = pc.shadowJobUsec;
 
 	// print any other statistics and clear all of them
 	R_PerformanceCounters();
@@ -1003,3 +1023,12 @@ bool idRenderSystemLocal::UploadImage( const char *imageName, const byte *data,
 	image->SetImageFilterAndRepeat();
 	return true;
 }
+
+/*
+===============
+idRenderSystemLocal::GetFrameTimings
+===============
+*/
+void idRenderSystemLocal::GetFrameTimings( renderFrameTimings_t &timings ) const {
+	timings = frameTimings;
+}
@@ -95,6 +95,16 @@ typedef struct glconfig_s {
 } glconfig_t;
 
 
+// timings of a frame in microseconds, for benchmarks
+typedef struct {
+	int					frontEndUsec;		// sum of all RenderScene calls
+	int					backEndUsec;
+	int					addLightsUsec;		// R_AddLightSurfaces
+	int					addModelsUsec;		// R_AddModelSurfaces
+	int					shadowUsec;			// waiting for the shadow volume jobs
+} renderFrameTimings_t;
+
+
 // font support
 const int GLYPH_START			= 0;
 const int GLYPH_END				= 255;
@@ -251,6 +261,9 @@ public:
 	// texture filter / mipmapping / repeat won't be modified by the upload
 	// returns false if the image wasn't found
 	virtual bool			UploadImage( const char *imageName, const byte *data, int width, int height ) = 0;
+
+	// returns the timings of the frame that was finished by the last EndFrame
+	virtual void			GetFrameTimings( renderFrameTimings_t &timings ) const = 0;
 };
 
 extern idRenderSystem *			renderSystem;
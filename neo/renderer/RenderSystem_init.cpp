@@ -75,7 +75,9 @@ idCVar r_useInteractionTable( "r_useInteractionTable", "1", CVAR_RENDERER | CVAR
 idCVar r_useTurboShadow( "r_useTurboShadow", "1", CVAR_RENDERER | CVAR_BOOL, "use the infinite projection with W technique for dynamic shadows" );
 idCVar r_useTwoSidedStencil( "r_useTwoSidedStencil", "1", CVAR_RENDERER | CVAR_BOOL, "do stencil shadows in one pass with different ops on each side" );
 idCVar r_useDeferredTangents( "r_useDeferredTangents", "1", CVAR_RENDERER | CVAR_BOOL, "defer tangents calculations after deform" );
+idCVar r_useVertexStreams( "r_useVertexStreams", "1", CVAR_RENDERER | CVAR_BOOL, "skin and derive tangents of md5 meshes in structure-of-arrays vertex streams" );
 idCVar r_useCachedDynamicModels( "r_useCachedDynamicModels", "1", CVAR_RENDERER | CVAR_BOOL, "cache snapshots of dynamic models" );
+idCVar r_useSkinCache( "r_useSkinCache", "1", CVAR_RENDERER | CVAR_BOOL, "reuse the snapshot of an md5 model instead of skinning it again if the joints and skin didn't change" );
 
 idCVar r_useVertexBuffers( "r_useVertexBuffers", "1", CVAR_RENDERER | CVAR_INTEGER, "use ARB_vertex_buffer_object for vertexes", 0, 1, idCmdSystem::ArgCompletion_Integer<0,1>  );
 idCVar r_useIndexBuffers( "r_useIndexBuffers", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "use ARB_vertex_buffer_object for indexes", 0, 1, idCmdSystem::ArgCompletion_Integer<0,1>  );
@@ -104,6 +106,7 @@ idCVar r_skipInteractions( "r_skipInteractions", "0", CVAR_RENDERER | CVAR_BOOL,
 idCVar r_skipDynamicTextures( "r_skipDynamicTextures", "0", CVAR_RENDERER | CVAR_BOOL, "don't dynamically create textures" );
 idCVar r_skipCopyTexture( "r_skipCopyTexture", "0", CVAR_RENDERER | CVAR_BOOL, "do all rendering, but don't actually copyTexSubImage2D" );
 idCVar r_skipBackEnd( "r_skipBackEnd", "0", CVAR_RENDERER | CVAR_BOOL, "don't draw anything" );
+idCVar r_nullBackend( "r_nullBackend", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_INIT, "run the front end without a window or OpenGL context, the back end only counts what it would draw" );
 idCVar r_skipRender( "r_skipRender", "0", CVAR_RENDERER | CVAR_BOOL, "skip 3D rendering, but pass 2D" );
 idCVar r_skipRenderContext( "r_skipRenderContext", "0", CVAR_RENDERER | CVAR_BOOL, "NULL the rendering context during backend 3D rendering" );
 idCVar r_skipTranslucent( "r_skipTranslucent", "0", CVAR_RENDERER | CVAR_BOOL, "skip the translucent interaction rendering" );
@@ -128,6 +131,9 @@ idCVar r_useLightCulling( "r_useLightCulling", "3", CVAR_RENDERER | CVAR_INTEGER
 idCVar r_useLightScissors( "r_useLightScissors", "1", CVAR_RENDERER | CVAR_BOOL, "1 = use custom scissor rectangle for each light" );
 idCVar r_useClippedLightScissors( "r_useClippedLightScissors", "1", CVAR_RENDERER | CVAR_INTEGER, "0 = full screen when near clipped, 1 = exact when near clipped, 2 = exact always", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar r_useEntityCulling( "r_useEntityCulling", "1", CVAR_RENDERER | CVAR_BOOL, "0 = none, 1 = box" );
+idCVar r_useAreaBVH( "r_useAreaBVH", "1", CVAR_RENDERER | CVAR_BOOL, "use the per area bounding volume trees to find the entities and lights touching a volume" );
+idCVar r_parallelDynamicModels( "r_parallelDynamicModels", "1", CVAR_RENDERER | CVAR_BOOL, "instantiate md5 models on the job threads" );
+idCVar r_parallelShadows( "r_parallelShadows", "1", CVAR_RENDERER | CVAR_BOOL, "create the shadow volumes of a view on the job threads" );
 idCVar r_useEntityScissors( "r_useEntityScissors", "0", CVAR_RENDERER | CVAR_BOOL, "1 = use custom scissor rectangle for each entity" );
 idCVar r_useInteractionCulling( "r_useInteractionCulling", "1", CVAR_RENDERER | CVAR_BOOL, "1 = cull interactions" );
 idCVar r_useInteractionScissors( "r_useInteractionScissors", "2", CVAR_RENDERER | CVAR_INTEGER, "1 = use a custom scissor rectangle for each shadow interaction, 2 = also crop using portal scissors", -2, 2, idCmdSystem::ArgCompletion_Integer<-2,2> );
@@ -198,6 +204,7 @@ idCVar r_showNormals( "r_showNormals", "0", CVAR_RENDERER | CVAR_FLOAT, "draws w
 idCVar r_showMemory( "r_showMemory", "0", CVAR_RENDERER | CVAR_BOOL, "print frame memory utilization" );
 idCVar r_showCull( "r_showCull", "0", CVAR_RENDERER | CVAR_BOOL, "report sphere and box culling stats" );
 idCVar r_showInteractions( "r_showInteractions", "0", CVAR_RENDERER | CVAR_BOOL, "report interaction generation activity" );
+idCVar r_showShadowJobs( "r_showShadowJobs", "0", CVAR_RENDERER | CVAR_BOOL, "report the shadow volumes created on the job threads" );
 idCVar r_showDepth( "r_showDepth", "0", CVAR_RENDERER | CVAR_BOOL, "display the contents of the depth buffer and the depth range" );
 idCVar r_showSurfaces( "r_showSurfaces", "0", CVAR_RENDERER | CVAR_BOOL, "report surface/light/shadow counts" );
 idCVar r_showPrimitives( "r_showPrimitives", "0", CVAR_RENDERER | CVAR_INTEGER, "report drawsurf/index/vertex counts" );
@@ -653,44 +660,53 @@ void R_InitOpenGL( void ) {
 
 	initSortedVidModes();
 
-	//
-	// initialize OS specific portions of the renderSystem
-	//
-	for ( i = 0 ; i < 2 ; i++ ) {
-		// set the parameters we are trying
+	tr.nullBackend = r_nullBackend.GetBool();
+
+	if ( tr.nullBackend ) {
 		R_GetModeInfo( &glConfig.vidWidth, &glConfig.vidHeight, r_mode.GetInteger() );
 
-		parms.width = glConfig.vidWidth;
-		parms.height = glConfig.vidHeight;
-		parms.fullScreen = r_fullscreen.GetBool();
-		parms.displayHz = r_displayRefresh.GetInteger();
-		parms.multiSamples = r_multiSamples.GetInteger();
-		parms.stereo = false;
+		// no window or context, every qgl function does nothing
+		R_InitNullBackend();
+	} else {
+		//
+		// initialize OS specific portions of the renderSystem
+		//
+		for ( i = 0 ; i < 2 ; i++ ) {
+			// set the parameters we are trying
+			R_GetModeInfo( &glConfig.vidWidth, &glConfig.vidHeight, r_mode.GetInteger() );
+
+			parms.width = glConfig.vidWidth;
+			parms.height = glConfig.vidHeight;
+			parms.fullScreen = r_fullscreen.GetBool();
+			parms.displayHz = r_displayRefresh.GetInteger();
+			parms.multiSamples = r_multiSamples.GetInteger();
+			parms.stereo = false;
+
+			if ( GLimp_Init( parms ) ) {
+				// it worked
+				break;
+			}
 
-		if ( GLimp_Init( parms ) ) {
-			// it worked
-			break;
-		}
+			if ( i == 1 ) {
+				common->FatalError( "Unable to initialize OpenGL" );
+			}
 
-		if ( i == 1 ) {
-			common->FatalError( "Unable to initialize OpenGL" );
+			// if we failed, set everything back to "safe mode"
+			// and try again
+			r_mode.SetInteger( 3 );
+			r_fullscreen.SetInteger( 0 );
+			r_displayRefresh.SetInteger( 0 );
+			r_multiSamples.SetInteger( 0 );
 		}
 
-		// if we failed, set everything back to "safe mode"
-		// and try again
-		r_mode.SetInteger( 3 );
-		r_fullscreen.SetInteger( 0 );
-		r_displayRefresh.SetInteger( 0 );
-		r_multiSamples.SetInteger( 0 );
-	}
-
-// load qgl function pointers
+	// load qgl function pointers
 #define QGLPROC(name, rettype, args) \
-	q##name = (rettype(APIENTRYP)args)GLimp_ExtensionPointer(#name); \
-	if (!q##name) \
-		common->FatalError("Unable to initialize OpenGL (%s)", #name);
+		q##name = (rettype(APIENTRYP)args)GLimp_ExtensionPointer(#name); \
+		if (!q##name) \
+			common->FatalError("Unable to initialize OpenGL (%s)", #name);
 
 #include "renderer/qgl_proc.h"
+	}
 
 	// input and sound systems need to be tied to the new window
 	Sys_InitInput();
@@ -718,7 +734,9 @@ void R_InitOpenGL( void ) {
 	common->Printf("OpenGL version: %s\n", glConfig.version_string );
 
 	// recheck all the extensions (FIXME: this might be dangerous)
-	R_CheckPortableExtensions();
+	if ( !tr.nullBackend ) {
+		R_CheckPortableExtensions();
+	}
 
 	// parse our vertex and fragment programs, possibly disably support for
 	// one of the paths if there was an error
@@ -1769,7 +1787,7 @@ R_SetColorMappings
 */
 void R_SetColorMappings( void ) {
 
-	if ( r_gammaInShader.GetBool() ) {
+	if ( r_gammaInShader.GetBool() || tr.nullBackend ) {
 		// nothing to do here
 		return;
 	}
@@ -2076,6 +2094,8 @@ void R_InitCommands( void ) {
 	cmdSystem->AddCommand( "listRenderLightDefs", R_ListRenderLightDefs_f, CMD_FL_RENDERER, "lists the light defs" );
 	cmdSystem->AddCommand( "listModes", R_ListModes_f, CMD_FL_RENDERER, "lists all video modes" );
 	cmdSystem->AddCommand( "reloadSurface", R_ReloadSurface_f, CMD_FL_RENDERER, "reloads the decl and images for selected surface" );
+	cmdSystem->AddCommand( "nullBackendStats", R_NullBackendStats_f, CMD_FL_RENDERER, "prints what the null back end counted, \"reset\" clears it" );
+	cmdSystem->AddCommand( "cullBenchmark", R_CullBenchmark_f, CMD_FL_RENDERER, "times single and batched box culling on the entities of the map" );
 }
 
 /*
@@ -2096,6 +2116,7 @@ void idRenderSystemLocal::Clear( void ) {
 	backEndRenderer = BE_BAD;
 	backEndRendererHasVertexPrograms = false;
 	backEndRendererMaxLight = 1.0f;
+	nullBackend = false;
 	ambientLightVector.Zero();
 	sortOffset = 0;
 	worlds.Clear();
@@ -2116,6 +2137,8 @@ void idRenderSystemLocal::Clear( void ) {
 	guiRecursionLevel = 0;
 	guiModel = NULL;
 	demoGuiModel = NULL;
+	frontEndJobs = NULL;
+	memset( &frameTimings, 0, sizeof( frameTimings ) );
 	takingScreenshot = false;
 }
 
@@ -2147,6 +2170,8 @@ void idRenderSystemLocal::Init( void ) {
 	demoGuiModel = new idGuiModel;
 	demoGuiModel->Clear();
 
+	frontEndJobs = parallelJobManager->AllocJobList( "frontEnd" );
+
 	R_InitTriSurfData();
 
 	globalImages->Init();
@@ -2195,11 +2220,15 @@ void idRenderSystemLocal::Shutdown( void ) {
 
 	R_ShutdownTriSurfData();
 
+	R_FreeShadowScratch();
+
 	RB_ShutdownDebugTools();
 
 	delete guiModel;
 	delete demoGuiModel;
 
+	parallelJobManager->FreeJobList( frontEndJobs );
+
 	Clear();
 
 	ShutdownOpenGL();
@@ -133,6 +133,8 @@ idRenderWorldLocal::idRenderWorldLocal() {
 
 	generateAllInteractionsCalled = false;
 
+	oldEntityRefs = NULL;
+
 	areaNodes = NULL;
 	numAreaNodes = 0;
 
@@ -254,13 +256,38 @@ void idRenderWorldLocal::UpdateEntityDef( qhandle_t entityHandle, const renderEn
 					return;
 				}
 			}
+
+			// a static model that stays in place keeps its references and interactions,
+			// the interaction surfaces only need to be recreated if the shaders or
+			// the shadow flags changed (demo playback owns the guis of the parms,
+			// so it has to take the full path to free them)
+			if ( !session->readDemo && !re->callback && !def->parms.callback && re->hModel == def->parms.hModel &&
+				re->hModel->IsDynamicModel() == DM_STATIC && re->origin == def->parms.origin &&
+				re->axis == def->parms.axis && re->bounds == def->parms.bounds ) {
+
+				if ( re->customShader != def->parms.customShader || re->customSkin != def->parms.customSkin ||
+					re->noShadow != def->parms.noShadow || re->noSelfShadow != def->parms.noSelfShadow ||
+					re->suppressSurfaceInViewID != def->parms.suppressSurfaceInViewID ) {
+					R_InvalidateEntityDefInteractions( def );
+				}
+				tr.pc.c_entityUpdatesKept++;
+
+				def->parms = *re;
+				def->lastModifiedFrameNum = tr.frameCount;
+				if ( session->writeDemo && def->archived ) {
+					WriteFreeEntity( entityHandle );
+					def->archived = false;
+				}
+				return;
+			}
 		}
 
 		// save any decals if the model is the same, allowing marks to move with entities
+		// and keep the area references, R_CreateEntityRefs reuses them
 		if ( def->parms.hModel == re->hModel ) {
-			R_FreeEntityDefDerivedData( def, true, true );
+			R_FreeEntityDefDerivedData( def, true, true, true );
 		} else {
-			R_FreeEntityDefDerivedData( def, false, false );
+			R_FreeEntityDefDerivedData( def, false, false, true );
 		}
 	} else {
 		// creating a new one
@@ -313,7 +340,7 @@ void idRenderWorldLocal::FreeEntityDef( qhandle_t entityHandle ) {
 		return;
 	}
 
-	R_FreeEntityDefDerivedData( def, false, false );
+	R_FreeEntityDefDerivedData( def, false, false, false );
 
 	if ( session->writeDemo && def->archived ) {
 		WriteFreeEntity( entityHandle );
@@ -399,18 +426,26 @@ void idRenderWorldLocal::UpdateLightDef( qhandle_t lightHandle, const renderLigh
 	}
 
 	bool justUpdate = false;
+	bool shaderChanged = false;
 	idRenderLightLocal *light = lightDefs[lightHandle];
 	if ( light ) {
 		// if the shape of the light stays the same, we don't need to dump
 		// any of our derived data, because shader parms are calculated every frame
-		if ( rlight->axis == light->parms.axis && rlight->end == light->parms.end &&
+		bool sameShape = ( rlight->axis == light->parms.axis && rlight->end == light->parms.end &&
 			 rlight->lightCenter == light->parms.lightCenter && rlight->lightRadius == light->parms.lightRadius &&
 			 rlight->noShadows == light->parms.noShadows && rlight->origin == light->parms.origin &&
 			 rlight->parallel == light->parms.parallel && rlight->pointLight == light->parms.pointLight &&
 			 rlight->right == light->parms.right && rlight->start == light->parms.start &&
 			 rlight->target == light->parms.target && rlight->up == light->parms.up &&
-			 rlight->shader == light->lightShader && rlight->prelightModel == light->parms.prelightModel ) {
+			 rlight->prelightModel == light->parms.prelightModel );
+		if ( sameShape && rlight->shader == light->lightShader ) {
+			justUpdate = true;
+		} else if ( sameShape && rlight->shader != NULL && !rlight->shader->IsFogLight() && !rlight->shader->IsBlendLight() &&
+			!light->lightShader->IsFogLight() && !light->lightShader->IsBlendLight() ) {
+			// a switched shader, like a broken light, keeps the references but the
+			// interaction surfaces have to be recreated
 			justUpdate = true;
+			shaderChanged = true;
 		} else {
 			// if we are updating shadows, the prelight model is no longer valid
 			light->lightHasMoved = true;
@@ -436,10 +471,17 @@ void idRenderWorldLocal::UpdateLightDef( qhandle_t lightHandle, const renderLigh
 		light->parms.prelightModel = NULL;
 	}
 
+	if ( shaderChanged ) {
+		R_DeriveLightData( light );
+		R_InvalidateLightDefInteractions( light );
+	}
+
 	if (!justUpdate) {
 		R_DeriveLightData( light );
 		R_CreateLightRefs( light );
 		R_CreateLightDefFogPortals( light );
+	} else {
+		tr.pc.c_lightUpdatesKept++;
 	}
 }
 
@@ -522,8 +564,9 @@ void idRenderWorldLocal::ProjectDecalOntoWorld( const idFixedWinding &winding, c
 
 		area = &portalAreas[ areas[i] ];
 
-		// check all models in this area
-		for ( ref = area->entityRefs.areaNext; ref != &area->entityRefs; ref = ref->areaNext ) {
+		// check all models in this area that may touch the projection
+		idAreaBVHIterator iter( area->entityTree, r_useAreaBVH.GetBool() ? &info.projectionBounds : NULL );
+		while ( ( ref = iter.Next() ) != NULL ) {
 			def = ref->entity;
 
 			// completely ignore any dynamic or callback models
@@ -702,6 +745,7 @@ void idRenderWorldLocal::RenderScene( const renderView_t *renderView ) {
 	tr.guiModel->Clear();
 
 	int startTime = Sys_Milliseconds();
+	double startUsec = Sys_Microseconds();
 
 	// setup view parms for the initial view
 	//
@@ -804,6 +848,7 @@ void idRenderWorldLocal::RenderScene( const renderView_t *renderView ) {
 	int endTime = Sys_Milliseconds();
 
 	tr.pc.frontEndMsec += endTime - startTime;
+	tr.pc.frontEndUsec += (int)( Sys_Microseconds() - startUsec );
 
 	// prepare for any 2D drawing after this
 	tr.guiModel->Clear();
@@ -1150,7 +1195,7 @@ bool idRenderWorldLocal::ModelTrace( modelTrace_t &trace, qhandle_t entityHandle
 			trace.normal = localTrace.normal * refEnt->axis;
 			trace.material = shader;
 			trace.entity = &def->parms;
-			trace.jointNumber = refEnt->hModel->NearestJoint( i, localTrace.indexes[0], localTrace.indexes[1], localTrace.indexes[2] );
+			trace.jointNumber = refEnt->hModel->NearestJoint( surf->id, localTrace.indexes[0], localTrace.indexes[1], localTrace.indexes[2] );
 		}
 	}
 
@@ -1206,8 +1251,9 @@ bool idRenderWorldLocal::Trace( modelTrace_t &trace, const idVec3 &start, const
 
 		area = &portalAreas[ areas[i] ];
 
-		// check all models in this area
-		for ( ref = area->entityRefs.areaNext; ref != &area->entityRefs; ref = ref->areaNext ) {
+		// check all models in this area that may touch the trace
+		idAreaBVHIterator iter( area->entityTree, r_useAreaBVH.GetBool() ? &traceBounds : NULL );
+		while ( ( ref = iter.Next() ) != NULL ) {
 			def = ref->entity;
 
 			model = def->parms.hModel;
@@ -1306,7 +1352,7 @@ bool idRenderWorldLocal::Trace( modelTrace_t &trace, const idVec3 &start, const
 					trace.normal = localTrace.normal * def->parms.axis;
 					trace.material = shader;
 					trace.entity = &def->parms;
-					trace.jointNumber = model->NearestJoint( j, localTrace.indexes[0], localTrace.indexes[1], localTrace.indexes[2] );
+					trace.jointNumber = model->NearestJoint( surf->id, localTrace.indexes[0], localTrace.indexes[1], localTrace.indexes[2] );
 
 					traceBounds.Clear();
 					traceBounds.AddPoint( start );
@@ -1405,12 +1451,30 @@ for the world model references that are precalculated.
 =================
 */
 void idRenderWorldLocal::AddEntityRefToArea( idRenderEntityLocal *def, portalArea_t *area ) {
-	areaReference_t	*ref;
+	areaReference_t	*ref, **prev;
+	idBounds		bounds;
 
 	if ( !def ) {
 		common->Error( "idRenderWorldLocal::AddEntityRefToArea: NULL def" );
 	}
 
+	bounds.FromTransformedBounds( def->referenceBounds, def->parms.origin, def->parms.axis );
+
+	// an entity that is moved keeps the references to the areas it is still in,
+	// only the area tree has to be refitted
+	for ( prev = &oldEntityRefs; *prev; prev = &(*prev)->ownerNext ) {
+		ref = *prev;
+		if ( ref->area == area ) {
+			assert( ref->entity == def );
+			*prev = ref->ownerNext;
+			ref->ownerNext = def->entityRefs;
+			def->entityRefs = ref;
+			area->entityTree->Move( ref, bounds );
+			tr.pc.c_entityReferencesKept++;
+			return;
+		}
+	}
+
 	ref = areaReferenceAllocator.Alloc();
 
 	tr.pc.c_entityReferences++;
@@ -1427,6 +1491,8 @@ void idRenderWorldLocal::AddEntityRefToArea( idRenderEntityLocal *def, portalAre
 	ref->areaPrev = area->entityRefs.areaPrev;
 	ref->areaNext->areaPrev = ref;
 	ref->areaPrev->areaNext = ref;
+
+	area->entityTree->Add( ref, bounds );
 }
 
 /*
@@ -1451,6 +1517,54 @@ void idRenderWorldLocal::AddLightRefToArea( idRenderLightLocal *light, portalAre
 	lref->areaNext = area->lightRefs.areaNext;
 	lref->areaPrev = &area->lightRefs;
 	area->lightRefs.areaNext = lref;
+
+	area->lightTree->Add( lref, light->frustumTris->bounds );
+}
+
+/*
+===================
+FreeEntityRefs
+
+Unlinks a chain of entity references from their areas
+===================
+*/
+void idRenderWorldLocal::FreeEntityRefs( areaReference_t *refs ) {
+	areaReference_t	*ref, *next;
+
+	for ( ref = refs ; ref ; ref = next ) {
+		next = ref->ownerNext;
+
+		// unlink from the area
+		ref->areaNext->areaPrev = ref->areaPrev;
+		ref->areaPrev->areaNext = ref->areaNext;
+		ref->area->entityTree->Remove( ref );
+
+		// put it back on the free list for reuse
+		areaReferenceAllocator.Free( ref );
+	}
+}
+
+/*
+===================
+FreeLightRefs
+
+Unlinks a chain of light references from their areas
+===================
+*/
+void idRenderWorldLocal::FreeLightRefs( areaReference_t *refs ) {
+	areaReference_t	*lref, *next;
+
+	for ( lref = refs ; lref ; lref = next ) {
+		next = lref->ownerNext;
+
+		// unlink from the area
+		lref->areaNext->areaPrev = lref->areaPrev;
+		lref->areaPrev->areaNext = lref->areaNext;
+		lref->area->lightTree->Remove( lref );
+
+		// put it back on the free list for reuse
+		areaReferenceAllocator.Free( lref );
+	}
 }
 
 /*
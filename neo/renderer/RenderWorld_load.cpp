@@ -63,6 +63,9 @@ void idRenderWorldLocal::FreeWorld() {
 		if ( area->entityRefs.areaNext != &area->entityRefs ) {
 			common->Error( "FreeWorld: unexpected remaining entityRefs" );
 		}
+
+		delete area->entityTree;
+		delete area->lightTree;
 	}
 
 	if ( portalAreas ) {
@@ -262,6 +265,8 @@ void idRenderWorldLocal::SetupAreaRefs() {
 		portalAreas[i].entityRefs.areaNext =
 		portalAreas[i].entityRefs.areaPrev =
 			&portalAreas[i].entityRefs;
+		portalAreas[i].entityTree = new idAreaBVH;
+		portalAreas[i].lightTree = new idAreaBVH;
 	}
 }
 
@@ -32,6 +32,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/geometry/Winding.h"
 #include "renderer/RenderWorld.h"
 #include "renderer/tr_local.h"
+#include "renderer/AreaBVH.h"
 
 class idRenderLightLocal;
 
@@ -67,6 +68,8 @@ typedef struct portalArea_s {
 	portal_t *		portals;		// never changes after load
 	areaReference_t	entityRefs;		// head/tail of doubly linked list, may change
 	areaReference_t	lightRefs;		// head/tail of doubly linked list, may change
+	idAreaBVH *		entityTree;		// the entityRefs by their global reference bounds
+	idAreaBVH *		lightTree;		// the lightRefs by their global frustum bounds
 } portalArea_t;
 
 
@@ -160,6 +163,7 @@ public:
 	idList<idRenderLightLocal*>		lightDefs;
 
 	idBlockAlloc<areaReference_t, 1024> areaReferenceAllocator;
+	areaReference_t *		oldEntityRefs;			// references of the entity in R_CreateEntityRefs that may be reused
 	idBlockAlloc<idInteraction, 256>	interactionAllocator;
 	idBlockAlloc<areaNumRef_t, 1024>	areaNumRefAllocator;
 
@@ -246,6 +250,8 @@ public:
 
 	void					AddEntityRefToArea( idRenderEntityLocal *def, portalArea_t *area );
 	void					AddLightRefToArea( idRenderLightLocal *light, portalArea_t *area );
+	void					FreeEntityRefs( areaReference_t *refs );
+	void					FreeLightRefs( areaReference_t *refs );
 
 	void					RecurseProcBSP_r( modelTrace_t *results, int parentNodeNum, int nodeNum, float p1f, float p2f, const idVec3 &p1, const idVec3 &p2 ) const;
 
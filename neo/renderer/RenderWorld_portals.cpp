@@ -594,11 +594,25 @@ void idRenderWorldLocal::AddAreaEntityRefs( int areaNum, const portalStack_t *ps
 	idRenderEntityLocal	*entity;
 	portalArea_t		*area;
 	viewEntity_t		*vEnt;
-	idBounds			b;
+	int					i, numEntities;
 
 	area = &portalAreas[ areaNum ];
 
-	for ( ref = area->entityRefs.areaNext ; ref != &area->entityRefs ; ref = ref->areaNext ) {
+	numEntities = area->entityTree->Num();
+	if ( !numEntities ) {
+		return;
+	}
+
+	idRenderEntityLocal **entities = (idRenderEntityLocal **)R_FrameAlloc( numEntities * sizeof( entities[0] ) );
+	cullBoxes_t boxes;
+	R_AllocCullBoxes( boxes, numEntities );
+
+	// the area tree skips groups of entities that are completely outside the portal chain
+	int numTreePlanes = ( r_useAreaBVH.GetBool() && r_useEntityCulling.GetBool() ) ? ps->numPortalPlanes : 0;
+	idAreaBVHIterator iter( area->entityTree, numTreePlanes, ps->portalPlanes );
+
+	numEntities = 0;
+	while ( ( ref = iter.Next() ) != NULL ) {
 		entity = ref->entity;
 
 		// debug tool to allow viewing of only one entity at a time
@@ -621,14 +635,29 @@ void idRenderWorldLocal::AddAreaEntityRefs( int areaNum, const portalStack_t *ps
 			}
 		}
 
-		// cull reference bounds
-		if ( CullEntityByPortals( entity, ps ) ) {
+		entities[numEntities] = entity;
+		R_SetCullBox( boxes, numEntities, entity->referenceBounds, entity->modelMatrix );
+		numEntities++;
+	}
+
+	// cull all the reference bounds at once, the same test CullEntityByPortals does.
+	// we do not yet do callbacks or dynamic model creation,
+	// because we want to do all touching of the model after
+	// we have determined all the lights that may effect it,
+	// which optimizes cache usage
+	const dword *visibleBits = NULL;
+	if ( r_useEntityCulling.GetBool() ) {
+		visibleBits = R_CullBoxes( boxes, numEntities, ps->numPortalPlanes, ps->portalPlanes );
+	}
+
+	for ( i = 0; i < numEntities; i++ ) {
+		if ( visibleBits && !R_CullBoxVisible( visibleBits, i ) ) {
 			// we are culled out through this portal chain, but it might
 			// still be visible through others
 			continue;
 		}
 
-		vEnt = R_SetEntityDefViewEntity( entity );
+		vEnt = R_SetEntityDefViewEntity( entities[i] );
 
 		// possibly expand the scissor rect
 		vEnt->scissorRect.Union( ps->rect );
@@ -726,10 +755,28 @@ void idRenderWorldLocal::AddAreaLightRefs( int areaNum, const portalStack_t *ps
 	portalArea_t		*area;
 	idRenderLightLocal			*light;
 	viewLight_t			*vLight;
+	int					i, numLights;
 
 	area = &portalAreas[ areaNum ];
 
-	for ( lref = area->lightRefs.areaNext ; lref != &area->lightRefs ; lref = lref->areaNext ) {
+	numLights = area->lightTree->Num();
+	if ( !numLights ) {
+		return;
+	}
+
+	idRenderLightLocal **lights = (idRenderLightLocal **)R_FrameAlloc( numLights * sizeof( lights[0] ) );
+	cullBoxes_t boxes;
+	R_AllocCullBoxes( boxes, numLights );
+
+	// the area tree skips groups of lights that are completely outside the portal chain
+	int numTreePlanes = 0;
+	if ( r_useAreaBVH.GetBool() && r_useLightCulling.GetInteger() != 0 && ps->numPortalPlanes > 1 ) {
+		numTreePlanes = ps->numPortalPlanes - 1;
+	}
+	idAreaBVHIterator iter( area->lightTree, numTreePlanes, ps->portalPlanes );
+
+	numLights = 0;
+	while ( ( lref = iter.Next() ) != NULL ) {
 		light = lref->light;
 
 		// debug tool to allow viewing of only one light at a time
@@ -745,8 +792,23 @@ void idRenderWorldLocal::AddAreaLightRefs( int areaNum, const portalStack_t *ps
 			continue;
 		}
 
+		lights[numLights] = light;
+		R_SetCullBox( boxes, numLights, light->frustumTris->bounds, tr.identitySpace.modelMatrix );
+		numLights++;
+	}
+
+	// cull the bounds of all the light frustums at once before the more
+	// expensive polyhedron test, again without the last stack plane
+	const dword *visibleBits = NULL;
+	if ( r_useLightCulling.GetInteger() != 0 && ps->numPortalPlanes > 1 ) {
+		visibleBits = R_CullBoxes( boxes, numLights, ps->numPortalPlanes - 1, ps->portalPlanes );
+	}
+
+	for ( i = 0; i < numLights; i++ ) {
+		light = lights[i];
+
 		// cull frustum
-		if ( CullLightByPortals( light, ps ) ) {
+		if ( ( visibleBits && !R_CullBoxVisible( visibleBits, i ) ) || CullLightByPortals( light, ps ) ) {
 			// we are culled out through this portal chain, but it might
 			// still be visible through others
 			continue;
@@ -32,14 +32,207 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "renderer/VertexCache.h"
 
-static const int	FRAME_MEMORY_BYTES = 0x200000;
 static const int	EXPAND_HEADERS = 1024;
+static const int	MIN_TEMP_RING_BYTES = 0x400000;
+static const int	TEMP_RING_GRANULARITY = 0x10000;
 
 idCVar idVertexCache::r_showVertexCache( "r_showVertexCache", "0", CVAR_INTEGER|CVAR_RENDERER, "" );
 idCVar idVertexCache::r_vertexBufferMegs( "r_vertexBufferMegs", "32", CVAR_INTEGER|CVAR_RENDERER, "" );
 
 idVertexCache		vertexCache;
 
+/*
+==============
+VertexCache_AtomicAdd
+
+returns the value before the add
+==============
+*/
+static ID_INLINE int VertexCache_AtomicAdd( volatile int *value, int add ) {
+#ifdef _WIN32
+	return InterlockedExchangeAdd( (volatile LONG *)value, add );
+#else
+	return __sync_fetch_and_add( value, add );
+#endif
+}
+
+/*
+==============
+idVertexRing::idVertexRing
+==============
+*/
+idVertexRing::idVertexRing( void ) {
+	memory = NULL;
+	size = 0;
+	frameStart = 0;
+	frameUsed = 0;
+	frameLimit = 0;
+	frameFlushed = 0;
+	memset( inFlight, 0, sizeof( inFlight ) );
+	inFlightIndex = 0;
+	memset( demand, 0, sizeof( demand ) );
+	numFrames = 0;
+	framesSinceResize = 0;
+	highWater = 0;
+	peakHighWater = 0;
+	numOverflows = 0;
+}
+
+/*
+==============
+idVertexRing::~idVertexRing
+==============
+*/
+idVertexRing::~idVertexRing( void ) {
+	Free();
+}
+
+/*
+==============
+idVertexRing::Alloc
+==============
+*/
+void idVertexRing::Alloc( int newSize ) {
+	Free();
+
+	size = newSize;
+	memory = (byte *)Mem_Alloc16( size );
+
+	frameStart = 0;
+	frameUsed = 0;
+	frameLimit = size;
+	frameFlushed = 0;
+	memset( inFlight, 0, sizeof( inFlight ) );
+	inFlightIndex = 0;
+	framesSinceResize = 0;
+}
+
+/*
+==============
+idVertexRing::Free
+==============
+*/
+void idVertexRing::Free( void ) {
+	if ( memory ) {
+		Mem_Free16( memory );
+		memory = NULL;
+	}
+	size = 0;
+	frameLimit = 0;
+}
+
+/*
+==============
+idVertexRing::Reserve
+==============
+*/
+int idVertexRing::Reserve( int bytes ) {
+	bytes = ( bytes + 15 ) & ~15;
+
+	while( 1 ) {
+		int start = VertexCache_AtomicAdd( &frameUsed, bytes );
+		if ( start + bytes > frameLimit ) {
+			// the demand is still counted for sizing the ring
+			return -1;
+		}
+		int offset = frameStart + start;
+		if ( offset >= size ) {
+			offset -= size;
+		}
+		if ( offset + bytes <= size ) {
+			return offset;
+		}
+		// the reservation straddles the end of the ring, skip the
+		// rest of the ring and take the next one from the start
+	}
+}
+
+/*
+==============
+idVertexRing::GetUnflushedRanges
+==============
+*/
+int idVertexRing::GetUnflushedRanges( int offsets[2], int sizes[2] ) {
+	int used = Min( (int)frameUsed, frameLimit );
+	if ( used <= frameFlushed ) {
+		return 0;
+	}
+
+	int start = frameStart + frameFlushed;
+	if ( start >= size ) {
+		start -= size;
+	}
+	int bytes = used - frameFlushed;
+	frameFlushed = used;
+
+	offsets[0] = start;
+	if ( start + bytes <= size ) {
+		sizes[0] = bytes;
+		return 1;
+	}
+	sizes[0] = size - start;
+	offsets[1] = 0;
+	sizes[1] = bytes - sizes[0];
+	return 2;
+}
+
+/*
+==============
+idVertexRing::EndFrame
+==============
+*/
+void idVertexRing::EndFrame( int minSize, int maxSize ) {
+	int	i;
+
+	int frameDemand = frameUsed;
+	int used = Min( frameDemand, frameLimit );
+	bool overflow = ( frameDemand > frameLimit );
+	if ( overflow ) {
+		numOverflows++;
+	}
+
+	// track the demand of the recent frames
+	demand[numFrames & ( VERTEX_RING_HISTORY - 1 )] = frameDemand;
+	numFrames++;
+	framesSinceResize++;
+	highWater = 0;
+	for ( i = 0; i < VERTEX_RING_HISTORY; i++ ) {
+		highWater = Max( highWater, demand[i] );
+	}
+	peakHighWater = Max( peakHighWater, frameDemand );
+
+	// every in flight frame must fit the ring with some room to spare
+	double desired = (double)highWater * NUM_VERTEX_FRAMES * 1.25;
+	int desiredSize = maxSize;
+	if ( desired < maxSize ) {
+		desiredSize = ( (int)desired + TEMP_RING_GRANULARITY - 1 ) & ~( TEMP_RING_GRANULARITY - 1 );
+		desiredSize = Max( desiredSize, minSize );
+	}
+
+	if ( ( overflow && desiredSize > size ) || ( framesSinceResize >= VERTEX_RING_HISTORY && desiredSize * 2 < size ) ) {
+		// nothing in the ring is referenced anymore after the back end ran
+		Alloc( desiredSize );
+		return;
+	}
+
+	// the used part of this frame stays in flight for the next frames
+	frameStart += used;
+	if ( frameStart >= size ) {
+		frameStart -= size;
+	}
+	inFlight[inFlightIndex] = used;
+	inFlightIndex = ( inFlightIndex + 1 ) % ( NUM_VERTEX_FRAMES - 1 );
+
+	frameLimit = size;
+	for ( i = 0; i < NUM_VERTEX_FRAMES - 1; i++ ) {
+		frameLimit -= inFlight[i];
+	}
+	frameUsed = 0;
+	frameFlushed = 0;
+}
+
+//================================================================================
+
 /*
 ==============
 R_ListVertexCache_f
@@ -171,25 +364,21 @@ void idVertexCache::Init() {
 	// initialize the cache memory blocks
 	freeStaticHeaders.next = freeStaticHeaders.prev = &freeStaticHeaders;
 	staticHeaders.next = staticHeaders.prev = &staticHeaders;
-	freeDynamicHeaders.next = freeDynamicHeaders.prev = &freeDynamicHeaders;
-	dynamicHeaders.next = dynamicHeaders.prev = &dynamicHeaders;
 	deferredFreeList.next = deferredFreeList.prev = &deferredFreeList;
 
-	// set up the dynamic frame memory
-	frameBytes = FRAME_MEMORY_BYTES;
 	staticAllocTotal = 0;
 
-	byte	*junk = (byte *)Mem_Alloc( frameBytes );
-	for ( int i = 0 ; i < NUM_VERTEX_FRAMES ; i++ ) {
-		allocatingTempBuffer = true;	// force the alloc to use GL_STREAM_DRAW_ARB
-		Alloc( junk, frameBytes, &tempBuffers[i] );
-		allocatingTempBuffer = false;
-		tempBuffers[i]->tag = TAG_FIXED;
-		// unlink these from the static list, so they won't ever get purged
-		tempBuffers[i]->next->prev = tempBuffers[i]->prev;
-		tempBuffers[i]->prev->next = tempBuffers[i]->next;
+	// set up the dynamic frame memory, the stream buffer
+	// gets its size at the first upload
+	tempRing.Alloc( MIN_TEMP_RING_BYTES );
+	tempVbo = 0;
+	tempVboSize = 0;
+	if ( !virtualMemory ) {
+		qglGenBuffersARB( 1, &tempVbo );
 	}
-	Mem_Free( junk );
+
+	memset( (void *)tempHeaderChunks, 0, sizeof( tempHeaderChunks ) );
+	numTempHeaders = 0;
 
 	EndFrame();
 }
@@ -217,6 +406,12 @@ void idVertexCache::Shutdown() {
 //	PurgeAll();	// !@#: also purge the temp buffers
 
 	headerAllocator.Shutdown();
+
+	for ( int i = 0; i < MAX_TEMP_HEADER_CHUNKS; i++ ) {
+		delete[] tempHeaderChunks[i];
+		tempHeaderChunks[i] = NULL;
+	}
+	tempRing.Free();
 }
 
 /*
@@ -287,11 +482,7 @@ void idVertexCache::Alloc( void *data, int size, vertCache_t **buffer, bool inde
 			qglBufferDataARB( GL_ELEMENT_ARRAY_BUFFER_ARB, (GLsizeiptrARB)size, data, GL_STATIC_DRAW_ARB );
 		} else {
 			qglBindBufferARB( GL_ARRAY_BUFFER_ARB, block->vbo );
-			if ( allocatingTempBuffer ) {
-				qglBufferDataARB( GL_ARRAY_BUFFER_ARB, (GLsizeiptrARB)size, data, GL_STREAM_DRAW_ARB );
-			} else {
-				qglBufferDataARB( GL_ARRAY_BUFFER_ARB, (GLsizeiptrARB)size, data, GL_STATIC_DRAW_ARB );
-			}
+			qglBufferDataARB( GL_ARRAY_BUFFER_ARB, (GLsizeiptrARB)size, data, GL_STATIC_DRAW_ARB );
 		}
 	} else {
 		block->virtMem = Mem_Alloc( size );
@@ -360,75 +551,131 @@ void idVertexCache::Free( vertCache_t *block ) {
 
 /*
 ===========
-idVertexCache::AllocFrameTemp
+idVertexCache::AllocTempHeader
 
-A frame temp allocation must never be allowed to fail due to overflow.
-We can't simply sync with the GPU and overwrite what we have, because
-there may still be future references to dynamically created surfaces.
+safe to call from any thread
 ===========
 */
-vertCache_t	*idVertexCache::AllocFrameTemp( void *data, int size ) {
-	vertCache_t	*block;
-
-	if ( size <= 0 ) {
-		common->Error( "idVertexCache::AllocFrameTemp: size = %i\n", size );
+vertCache_t *idVertexCache::AllocTempHeader() {
+	int index = VertexCache_AtomicAdd( &numTempHeaders, 1 );
+	int chunk = index / TEMP_HEADER_CHUNK;
+	if ( chunk >= MAX_TEMP_HEADER_CHUNKS ) {
+		return NULL;
 	}
 
-	if ( dynamicAllocThisFrame + size > frameBytes ) {
-		// if we don't have enough room in the temp block, allocate a static block,
-		// but immediately free it so it will get freed at the next frame
-		tempOverflow = true;
-		Alloc( data, size, &block );
-		Free( block);
-		return block;
+	if ( !tempHeaderChunks[chunk] ) {
+		Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
+		if ( !tempHeaderChunks[chunk] ) {
+			tempHeaderChunks[chunk] = new vertCache_t[TEMP_HEADER_CHUNK];
+		}
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 	}
 
-	// this data is just going on the shared dynamic list
+	return &tempHeaderChunks[chunk][index % TEMP_HEADER_CHUNK];
+}
 
-	// if we don't have any remaining unused headers, allocate some more
-	if ( freeDynamicHeaders.next == &freeDynamicHeaders ) {
+/*
+===========
+idVertexCache::AllocFrameTemp
 
-		for ( int i = 0; i < EXPAND_HEADERS; i++ ) {
-			block = headerAllocator.Alloc();
-			block->next = freeDynamicHeaders.next;
-			block->prev = &freeDynamicHeaders;
-			block->next->prev = block;
-			block->prev->next = block;
-		}
+The data is written directly into the frame temp ring and
+uploaded by UploadFrameTemp.
+===========
+*/
+vertCache_t	*idVertexCache::AllocFrameTemp( int size, void **dest ) {
+	if ( size <= 0 ) {
+		common->Error( "idVertexCache::AllocFrameTemp: size = %i\n", size );
 	}
 
-	// move it from the freeDynamicHeaders list to the dynamicHeaders list
-	block = freeDynamicHeaders.next;
-	block->next->prev = block->prev;
-	block->prev->next = block->next;
-	block->next = dynamicHeaders.next;
-	block->prev = &dynamicHeaders;
-	block->next->prev = block;
-	block->prev->next = block;
+	*dest = NULL;
+
+	int offset = tempRing.Reserve( size );
+	if ( offset < 0 ) {
+		return NULL;
+	}
+
+	vertCache_t *block = AllocTempHeader();
+	if ( !block ) {
+		return NULL;
+	}
 
 	block->size = size;
 	block->tag = TAG_TEMP;
 	block->indexBuffer = false;
-	block->offset = dynamicAllocThisFrame;
-	dynamicAllocThisFrame += block->size;
-	dynamicCountThisFrame++;
+	block->offset = offset;
 	block->user = NULL;
 	block->frameUsed = 0;
+	block->next = block->prev = NULL;
 
-	// copy the data
-	block->virtMem = tempBuffers[listNum]->virtMem;
-	block->vbo = tempBuffers[listNum]->vbo;
-
-	if ( block->vbo ) {
-		qglBindBufferARB( GL_ARRAY_BUFFER_ARB, block->vbo );
-		qglBufferSubDataARB( GL_ARRAY_BUFFER_ARB, block->offset, (GLsizeiptrARB)size, data );
+	if ( virtualMemory ) {
+		block->vbo = 0;
+		block->virtMem = tempRing.GetPointer( 0 );
 	} else {
-		SIMDProcessor->Memcpy( (byte *)block->virtMem + block->offset, data, size );
+		block->vbo = tempVbo;
+		block->virtMem = NULL;
 	}
 
+	*dest = tempRing.GetPointer( offset );
 	return block;
 }
 
+/*
+===========
+idVertexCache::AllocFrameTemp
+
+A frame temp allocation must never be allowed to fail due to overflow.
+We can't simply sync with the GPU and overwrite what we have, because
+there may still be future references to dynamically created surfaces.
+===========
+*/
+vertCache_t	*idVertexCache::AllocFrameTemp( void *data, int size ) {
+	vertCache_t	*block;
+	void		*dest;
+
+	block = AllocFrameTemp( size, &dest );
+	if ( block ) {
+		SIMDProcessor->Memcpy( dest, data, size );
+		return block;
+	}
+
+	// the static blocks can only be handled by the main thread
+	if ( !Sys_IsMainThread() ) {
+		return NULL;
+	}
+
+	// if we don't have enough room in the temp ring, allocate a static block,
+	// but immediately free it so it will get freed at the next frame
+	tempOverflow = true;
+	Alloc( data, size, &block );
+	Free( block );
+	return block;
+}
+
+/*
+===========
+idVertexCache::UploadFrameTemp
+===========
+*/
+void idVertexCache::UploadFrameTemp() {
+	int offsets[2], sizes[2];
+
+	int numRanges = tempRing.GetUnflushedRanges( offsets, sizes );
+	if ( virtualMemory ) {
+		return;
+	}
+
+	qglBindBufferARB( GL_ARRAY_BUFFER_ARB, tempVbo );
+	if ( tempVboSize != tempRing.GetSize() ) {
+		// the ring has been resized
+		tempVboSize = tempRing.GetSize();
+		qglBufferDataARB( GL_ARRAY_BUFFER_ARB, (GLsizeiptrARB)tempVboSize, NULL, GL_STREAM_DRAW_ARB );
+	}
+	for ( int i = 0; i < numRanges; i++ ) {
+		qglBufferSubDataARB( GL_ARRAY_BUFFER_ARB, offsets[i], (GLsizeiptrARB)sizes[i], tempRing.GetPointer( offsets[i] ) );
+	}
+	qglBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
+}
+
 /*
 ===========
 idVertexCache::EndFrame
@@ -450,10 +697,15 @@ void idVertexCache::EndFrame() {
 		const char *frameOverflow = tempOverflow ? "(OVERFLOW)" : "";
 
 		common->Printf( "vertex dynamic:%i=%ik%s, static alloc:%i=%ik used:%i=%ik total:%i=%ik\n",
-			dynamicCountThisFrame, dynamicAllocThisFrame/1024, frameOverflow,
+			Min( (int)numTempHeaders, TEMP_HEADER_CHUNK * MAX_TEMP_HEADER_CHUNKS ), tempRing.GetFrameDemand()/1024, frameOverflow,
 			staticCountThisFrame, staticAllocThisFrame/1024,
 			staticUseCount, staticUseSize/1024,
 			staticCountTotal, staticAllocTotal/1024 );
+		common->Printf( "temp ring:%ik limit:%ik high water:%ik peak:%ik overflows:%i\n",
+			tempRing.GetSize()/1024, tempRing.GetFrameLimit()/1024,
+			Max( tempRing.GetHighWater(), tempRing.GetFrameDemand() )/1024,
+			Max( tempRing.GetPeakHighWater(), tempRing.GetFrameDemand() )/1024,
+			tempRing.GetNumOverflows() );
 	}
 
 #if 0
@@ -473,28 +725,19 @@ void idVertexCache::EndFrame() {
 
 
 	currentFrame = tr.frameCount;
-	listNum = currentFrame % NUM_VERTEX_FRAMES;
 	staticAllocThisFrame = 0;
 	staticCountThisFrame = 0;
-	dynamicAllocThisFrame = 0;
-	dynamicCountThisFrame = 0;
 	tempOverflow = false;
 
+	// the back end is done with the frame temp data of this frame, resize the
+	// ring to the recent demand and reuse all the frame temp headers
+	tempRing.EndFrame( MIN_TEMP_RING_BYTES, Max( r_vertexBufferMegs.GetInteger() * 1024 * 1024, MIN_TEMP_RING_BYTES ) );
+	numTempHeaders = 0;
+
 	// free all the deferred free headers
 	while( deferredFreeList.next != &deferredFreeList ) {
 		ActuallyFree( deferredFreeList.next );
 	}
-
-	// free all the frame temp headers
-	vertCache_t	*block = dynamicHeaders.next;
-	if ( block != &dynamicHeaders ) {
-		block->prev = &freeDynamicHeaders;
-		dynamicHeaders.prev->next = freeDynamicHeaders.next;
-		freeDynamicHeaders.next->prev = dynamicHeaders.prev;
-		freeDynamicHeaders.next = block;
-
-		dynamicHeaders.next = dynamicHeaders.prev = &dynamicHeaders;
-	}
 }
 
 /*
@@ -522,16 +765,20 @@ void idVertexCache::List( void ) {
 		numFreeStaticHeaders++;
 	}
 
-	int	numFreeDynamicHeaders = 0;
-	for ( block = freeDynamicHeaders.next ; block != &freeDynamicHeaders ; block = block->next ) {
-		numFreeDynamicHeaders++;
+	int	numTempHeaderChunks = 0;
+	for ( int i = 0; i < MAX_TEMP_HEADER_CHUNKS; i++ ) {
+		if ( tempHeaderChunks[i] ) {
+			numTempHeaderChunks++;
+		}
 	}
 
 	common->Printf( "%i megs working set\n", r_vertexBufferMegs.GetInteger() );
-	common->Printf( "%i dynamic temp buffers of %ik\n", NUM_VERTEX_FRAMES, frameBytes / 1024 );
+	common->Printf( "%ik dynamic temp ring for %i frames, high water %ik, peak %ik, %i overflows\n",
+		tempRing.GetSize() / 1024, NUM_VERTEX_FRAMES, tempRing.GetHighWater() / 1024,
+		tempRing.GetPeakHighWater() / 1024, tempRing.GetNumOverflows() );
 	common->Printf( "%5i active static headers\n", numActive );
 	common->Printf( "%5i free static headers\n", numFreeStaticHeaders );
-	common->Printf( "%5i free dynamic headers\n", numFreeDynamicHeaders );
+	common->Printf( "%5i dynamic headers\n", numTempHeaderChunks * TEMP_HEADER_CHUNK );
 
 	if ( !virtualMemory  ) {
 		common->Printf( "Vertex cache is in ARB_vertex_buffer_object memory (FAST).\n");
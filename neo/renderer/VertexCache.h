@@ -36,7 +36,6 @@ const int NUM_VERTEX_FRAMES = 2;
 typedef enum {
 	TAG_FREE,
 	TAG_USED,
-	TAG_FIXED,		// for the temp buffers
 	TAG_TEMP		// in frame temp area, not static area
 } vertBlockTag_t;
 
@@ -54,6 +53,79 @@ typedef struct vertCache_s {
 	int				frameUsed;			// it can't be purged if near the current frame
 } vertCache_t;
 
+/*
+===============================================================================
+
+	Frame temp ring buffer
+
+	Frame temporary vertex and index data is appended to a ring of memory,
+	each frame starts where the previous one ended. A frame can use all of
+	the ring that isn't still referenced by the previous NUM_VERTEX_FRAMES-1
+	frames. Reserve is lock-free, so front end threads can write skinned and
+	deformed data directly into the ring.
+
+	The ring doesn't know about GL, idVertexCache uploads the written ranges
+	to a stream buffer before the back end runs. At the end of each frame the
+	ring is resized to fit the highest demand of the recent frames.
+
+===============================================================================
+*/
+
+const int VERTEX_RING_HISTORY = 64;		// frames of demand used for sizing, must be a power of two
+
+class idVertexRing {
+public:
+					idVertexRing( void );
+					~idVertexRing( void );
+
+	// sets the size and drops everything in the ring
+	void			Alloc( int size );
+	void			Free( void );
+
+	// returns the offset of bytes of 16 byte aligned memory, or -1 when the
+	// current frame is out of space. Safe to call from any thread.
+	int				Reserve( int bytes );
+	byte *			GetPointer( int offset ) const { return memory + offset; }
+	int				GetSize( void ) const { return size; }
+
+	// gets the ranges reserved since the last call and returns the number of
+	// ranges, there are two if the frame wrapped around the end of the ring.
+	// All writes to the ranges must be finished.
+	int				GetUnflushedRanges( int offsets[2], int sizes[2] );
+
+	// retires the oldest frame and resizes the ring if the demand of the
+	// recent frames doesn't fit it or it is way too large
+	void			EndFrame( int minSize, int maxSize );
+
+	int				GetFrameDemand( void ) const { return frameUsed; }	// includes reservations that failed
+	int				GetFrameLimit( void ) const { return frameLimit; }
+	int				GetHighWater( void ) const { return highWater; }	// over the last VERTEX_RING_HISTORY frames
+	int				GetPeakHighWater( void ) const { return peakHighWater; }
+	int				GetNumOverflows( void ) const { return numOverflows; }
+
+private:
+	byte *			memory;
+	int				size;
+
+	int				frameStart;				// offset of the first byte of the current frame
+	volatile int	frameUsed;				// bytes reserved by the current frame, may be larger than frameLimit
+	int				frameLimit;				// bytes the current frame can use
+	int				frameFlushed;			// bytes of the current frame returned by GetUnflushedRanges
+
+	int				inFlight[NUM_VERTEX_FRAMES - 1];	// bytes used by the previous frames
+	int				inFlightIndex;
+
+	int				demand[VERTEX_RING_HISTORY];
+	int				numFrames;
+	int				framesSinceResize;
+	int				highWater;
+	int				peakHighWater;
+	int				numOverflows;
+};
+
+
+const int TEMP_HEADER_CHUNK = 1024;
+const int MAX_TEMP_HEADER_CHUNKS = 256;
 
 class idVertexCache {
 public:
@@ -89,6 +161,16 @@ public:
 	// As with Position(), this may not actually be a pointer you can access.
 	vertCache_t	*	AllocFrameTemp( void *data, int bytes );
 
+	// reserves frame temp memory that the caller fills in through dest
+	// before the render commands are issued. Safe to call from any front
+	// end thread. Returns NULL when the frame temp memory is full, the
+	// copying AllocFrameTemp can still fall back to static memory then.
+	vertCache_t	*	AllocFrameTemp( int bytes, void **dest );
+
+	// uploads the frame temp data written since the last call, called
+	// before the back end runs
+	void			UploadFrameTemp();
+
 	// notes that a buffer is used this frame, so it can't be purged
 	// out from under the GPU
 	void			Touch( vertCache_t *buffer );
@@ -109,6 +191,7 @@ public:
 private:
 	void			InitMemoryBlocks( int size );
 	void			ActuallyFree( vertCache_t *block );
+	vertCache_t *	AllocTempHeader();
 
 	static idCVar	r_showVertexCache;
 	static idCVar	r_vertexBufferMegs;
@@ -118,29 +201,27 @@ private:
 
 	int				staticAllocThisFrame;	// debug counter
 	int				staticCountThisFrame;
-	int				dynamicAllocThisFrame;
-	int				dynamicCountThisFrame;
 
 	int				currentFrame;			// for purgable block tracking
-	int				listNum;				// currentFrame % NUM_VERTEX_FRAMES, determines which tempBuffers to use
 
 	bool			virtualMemory;			// not fast stuff
 
-	bool			allocatingTempBuffer;	// force GL_STREAM_DRAW_ARB
-
-	vertCache_t		*tempBuffers[NUM_VERTEX_FRAMES];		// allocated at startup
+	idVertexRing	tempRing;				// frame temp data
+	GLuint			tempVbo;				// GL_STREAM_DRAW_ARB copy of tempRing
+	int				tempVboSize;
 	bool			tempOverflow;			// had to alloc a temp in static memory
 
+	// frame temp headers are handed out lock-free from chunks that are
+	// allocated on demand and reused every frame
+	vertCache_t * volatile	tempHeaderChunks[MAX_TEMP_HEADER_CHUNKS];
+	volatile int	numTempHeaders;
+
 	idBlockAlloc<vertCache_t,1024>	headerAllocator;
 
 	vertCache_t		freeStaticHeaders;		// head of doubly linked list
-	vertCache_t		freeDynamicHeaders;		// head of doubly linked list
-	vertCache_t		dynamicHeaders;			// head of doubly linked list
 	vertCache_t		deferredFreeList;		// head of doubly linked list
 	vertCache_t		staticHeaders;			// head of doubly linked list in MRU order,
 											// staticHeaders.next is most recently used
-
-	int				frameBytes;				// for each of NUM_VERTEX_FRAMES frames
 };
 
 extern	idVertexCache	vertexCache;
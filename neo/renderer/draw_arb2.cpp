@@ -566,6 +566,12 @@ void R_LoadARBProgram( int progIndex ) {
 		start = outStr;
 	}
 
+	// the null back end has no program functions
+	if ( tr.nullBackend ) {
+		common->Printf( "\n" );
+		return;
+	}
+
 	qglBindProgramARB( progs[progIndex].target, progs[progIndex].ident );
 	qglGetError();
 
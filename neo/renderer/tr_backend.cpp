@@ -26,6 +26,7 @@ If you have questions concerning this license or the applicable additional terms
 ===========================================================================
 */
 #include "sys/platform.h"
+#include "idlib/Profiler.h"
 
 #include "renderer/tr_local.h"
 
@@ -646,7 +647,10 @@ void RB_ExecuteBackEndCommands( const emptyCommand_t *cmds ) {
 		return;
 	}
 
+	PROF_SCOPE( "RB_ExecuteBackEndCommands" );
+
 	backEndStartTime = Sys_Milliseconds();
+	double startUsec = Sys_Microseconds();
 
 	// needed for editor rendering
 	RB_SetDefaultGLState();
@@ -692,6 +696,7 @@ void RB_ExecuteBackEndCommands( const emptyCommand_t *cmds ) {
 	// stop rendering on this thread
 	backEndFinishTime = Sys_Milliseconds();
 	backEnd.pc.msec = backEndFinishTime - backEndStartTime;
+	backEnd.pc.usec = (int)( Sys_Microseconds() - startUsec );
 
 	if ( r_debugRenderToTexture.GetInteger() == 1 ) {
 		common->Printf( "3d: %i, 2d: %i, SetBuf: %i, SwpBuf: %i, CpyRenders: %i, CpyFrameBuf: %i\n", c_draw3d, c_draw2d, c_setBuffers, c_swapBuffers, c_copyRenders, backEnd.c_copyFrameBuffer );
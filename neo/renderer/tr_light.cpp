@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "idlib/math/Interpolate.h"
+#include "idlib/Profiler.h"
 #include "framework/Game.h"
 #include "renderer/VertexCache.h"
 #include "renderer/RenderWorld_local.h"
@@ -201,7 +202,11 @@ void R_SkyboxTexGen( drawSurf_t *surf, const idVec3 &viewOrg ) {
 
 	int numVerts = surf->geo->numVerts;
 	int size = numVerts * sizeof( idVec3 );
-	idVec3 *texCoords = (idVec3 *) _alloca16( size );
+	idVec3 *texCoords;
+	surf->dynamicTexCoords = vertexCache.AllocFrameTemp( size, (void **)&texCoords );
+	if ( !surf->dynamicTexCoords ) {
+		texCoords = (idVec3 *) _alloca16( size );
+	}
 
 	const idDrawVert *verts = surf->geo->verts;
 	for ( i = 0; i < numVerts; i++ ) {
@@ -210,7 +215,10 @@ void R_SkyboxTexGen( drawSurf_t *surf, const idVec3 &viewOrg ) {
 		texCoords[i][2] = verts[i].xyz[2] - localViewOrigin[2];
 	}
 
-	surf->dynamicTexCoords = vertexCache.AllocFrameTemp( texCoords, size );
+	if ( !surf->dynamicTexCoords ) {
+		// the frame temp memory is full
+		surf->dynamicTexCoords = vertexCache.AllocFrameTemp( texCoords, size );
+	}
 }
 
 /*
@@ -279,7 +287,11 @@ void R_WobbleskyTexGen( drawSurf_t *surf, const idVec3 &viewOrg ) {
 
 	int numVerts = surf->geo->numVerts;
 	int size = numVerts * sizeof( idVec3 );
-	idVec3 *texCoords = (idVec3 *) _alloca16( size );
+	idVec3 *texCoords;
+	surf->dynamicTexCoords = vertexCache.AllocFrameTemp( size, (void **)&texCoords );
+	if ( !surf->dynamicTexCoords ) {
+		texCoords = (idVec3 *) _alloca16( size );
+	}
 
 	const idDrawVert *verts = surf->geo->verts;
 	for ( i = 0; i < numVerts; i++ ) {
@@ -292,7 +304,10 @@ void R_WobbleskyTexGen( drawSurf_t *surf, const idVec3 &viewOrg ) {
 		R_LocalPointToGlobal( transform, v, texCoords[i] );
 	}
 
-	surf->dynamicTexCoords = vertexCache.AllocFrameTemp( texCoords, size );
+	if ( !surf->dynamicTexCoords ) {
+		// the frame temp memory is full
+		surf->dynamicTexCoords = vertexCache.AllocFrameTemp( texCoords, size );
+	}
 }
 
 /*
@@ -314,7 +329,11 @@ static void R_SpecularTexGen( drawSurf_t *surf, const idVec3 &globalLightOrigin,
 
 	// FIXME: change to 3 component?
 	int	size = tri->numVerts * sizeof( idVec4 );
-	idVec4 *texCoords = (idVec4 *) _alloca16( size );
+	idVec4 *texCoords;
+	surf->dynamicTexCoords = vertexCache.AllocFrameTemp( size, (void **)&texCoords );
+	if ( !surf->dynamicTexCoords ) {
+		texCoords = (idVec4 *) _alloca16( size );
+	}
 
 #if 1
 
@@ -362,7 +381,10 @@ static void R_SpecularTexGen( drawSurf_t *surf, const idVec3 &globalLightOrigin,
 
 #endif
 
-	surf->dynamicTexCoords = vertexCache.AllocFrameTemp( texCoords, size );
+	if ( !surf->dynamicTexCoords ) {
+		// the frame temp memory is full
+		surf->dynamicTexCoords = vertexCache.AllocFrameTemp( texCoords, size );
+	}
 }
 
 
@@ -548,11 +570,19 @@ void idRenderWorldLocal::CreateLightDefInteractions( idRenderLightLocal *ldef )
 	portalArea_t	*area;
 	idInteraction	*inter;
 
+	// the area trees only return the entities touching the light bounds, the
+	// others would just get empty interactions
+	const idBounds *lightBounds = NULL;
+	if ( r_useAreaBVH.GetBool() && ldef->frustumTris ) {
+		lightBounds = &ldef->frustumTris->bounds;
+	}
+
 	for ( lref = ldef->references ; lref ; lref = lref->ownerNext ) {
 		area = lref->area;
 
 		// check all the models in this area
-		for ( eref = area->entityRefs.areaNext ; eref != &area->entityRefs ; eref = eref->areaNext ) {
+		idAreaBVHIterator iter( area->entityTree, lightBounds );
+		while ( ( eref = iter.Next() ) != NULL ) {
 			edef = eref->entity;
 
 			// if the entity doesn't have any light-interacting surfaces, we could skip this,
@@ -879,12 +909,41 @@ void R_AddLightSurfaces( void ) {
 	viewLight_t		*vLight;
 	idRenderLightLocal *light;
 	viewLight_t		**ptr;
+	int				lightNum;
+
+	PROF_SCOPE( "R_AddLightSurfaces" );
+
+	// cull the prelight shadows of all the lights at once, they are
+	// indexed by the position of the light on the unfiltered list
+	const dword *prelightVisibleBits = NULL;
+	if ( r_useOptimizedShadows.GetBool() && r_useShadowCulling.GetBool() ) {
+		int numLights = 0;
+		for ( vLight = tr.viewDef->viewLights; vLight; vLight = vLight->next ) {
+			numLights++;
+		}
+		if ( numLights ) {
+			cullBoxes_t boxes;
+			R_AllocCullBoxes( boxes, numLights );
+			lightNum = 0;
+			for ( vLight = tr.viewDef->viewLights; vLight; vLight = vLight->next, lightNum++ ) {
+				const idRenderModel *prelightModel = vLight->lightDef->parms.prelightModel;
+				if ( prelightModel && prelightModel->NumSurfaces() ) {
+					R_SetCullBox( boxes, lightNum, prelightModel->Surface( 0 )->geometry->bounds, tr.viewDef->worldSpace.modelMatrix );
+				} else {
+					R_SetCullBox( boxes, lightNum, bounds_zero, tr.viewDef->worldSpace.modelMatrix );
+				}
+			}
+			prelightVisibleBits = R_CullBoxes( boxes, numLights, 5, tr.viewDef->frustum );
+		}
+	}
 
 	// go through each visible light, possibly removing some from the list
 	ptr = &tr.viewDef->viewLights;
+	lightNum = -1;
 	while ( *ptr ) {
 		vLight = *ptr;
 		light = vLight->lightDef;
+		lightNum++;
 
 		const idMaterial	*lightShader = light->lightShader;
 		if ( !lightShader ) {
@@ -1024,10 +1083,8 @@ void R_AddLightSurfaces( void ) {
 			}
 
 			// these shadows will all have valid bounds, and can be culled normally
-			if ( r_useShadowCulling.GetBool() ) {
-				if ( R_CullLocalBox( tri->bounds, tr.viewDef->worldSpace.modelMatrix, 5, tr.viewDef->frustum ) ) {
-					continue;
-				}
+			if ( prelightVisibleBits && !R_CullBoxVisible( prelightVisibleBits, lightNum ) ) {
+				continue;
 			}
 
 			// if we have been purged, re-upload the shadowVertexes
@@ -1095,15 +1152,103 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal *def ) {
 
 /*
 ===================
-R_EntityDefDynamicModel
+R_StoreEntityDefSkin
 
-Issues a deferred entity callback if necessary.
-If the model isn't dynamic, it returns the original.
-Returns the cached dynamic model if present, otherwise creates
-it and any necessary overlays
+Keeps a copy of the joints and the skin the cached snapshot of an md5
+model was created from. The joint pointer and tr.frameCount alone can't
+tell if the snapshot is current, the game moves the joints in place and
+may run several tics between two frames.
 ===================
 */
-idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
+static void R_StoreEntityDefSkin( idRenderEntityLocal *def ) {
+	const renderEntity_t &parms = def->parms;
+
+	if ( def->cachedDynamicModel == NULL || parms.joints == NULL || parms.numJoints <= 0 ||
+			parms.hModel->IsDynamicModel() != DM_CACHED || r_showSkel.GetInteger() != 0 ) {
+		def->skinnedModel = NULL;
+		return;
+	}
+
+	def->skinnedModel = parms.hModel;
+	def->skinnedJoints.SetNum( parms.numJoints, false );
+	memcpy( def->skinnedJoints.Ptr(), parms.joints, parms.numJoints * sizeof( parms.joints[0] ) );
+	def->skinnedSkin = parms.customSkin;
+	def->skinnedShader = parms.customShader;
+	def->skinnedScale = parms.shaderParms[SHADERPARM_MD5_SKINSCALE];
+	def->skinnedFrameCount = tr.frameCount;
+}
+
+/*
+===================
+R_EntityDefSkinIsCurrent
+
+Returns true if the cached snapshot was skinned with the current joints and skin
+===================
+*/
+static bool R_EntityDefSkinIsCurrent( const idRenderEntityLocal *def ) {
+	const renderEntity_t &parms = def->parms;
+
+	if ( !r_useSkinCache.GetBool() || !r_useCachedDynamicModels.GetBool() || r_showSkel.GetInteger() != 0 ) {
+		return false;
+	}
+	if ( def->skinnedModel == NULL || def->skinnedModel != parms.hModel || def->cachedDynamicModel == NULL || !parms.hModel->IsLoaded() ) {
+		return false;
+	}
+	if ( parms.customSkin != def->skinnedSkin || parms.customShader != def->skinnedShader ||
+			parms.shaderParms[SHADERPARM_MD5_SKINSCALE] != def->skinnedScale ) {
+		return false;
+	}
+	if ( parms.joints == NULL || parms.numJoints != def->skinnedJoints.Num() ) {
+		return false;
+	}
+	// the views of the frame the snapshot was skinned in see the same joints,
+	// unless the entity was updated in between
+	return memcmp( parms.joints, def->skinnedJoints.Ptr(), parms.numJoints * sizeof( parms.joints[0] ) ) == 0;
+}
+
+/*
+===================
+R_SetEntityDefDynamicModel
+
+Adds any overlays to the cached snapshot and makes it current
+===================
+*/
+static void R_SetEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	if ( def->cachedDynamicModel ) {
+
+		// add any overlays to the snapshot of the dynamic model
+		if ( def->overlay && !r_skipOverlays.GetBool() ) {
+			def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
+		} else {
+			idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
+		}
+
+		if ( r_checkBounds.GetBool() ) {
+			idBounds b = def->cachedDynamicModel->Bounds();
+			if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
+					b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
+					b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
+					b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
+					b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
+					b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
+				common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
+			}
+		}
+	}
+
+	def->dynamicModel = def->cachedDynamicModel;
+	def->dynamicModelFrameCount = tr.frameCount;
+}
+
+/*
+===================
+R_PrepareEntityDefDynamicModel
+
+Issues a deferred entity callback if necessary and clears an outdated snapshot.
+Returns true if a new snapshot of the dynamic model has to be instantiated.
+===================
+*/
+static bool R_PrepareEntityDefDynamicModel( idRenderEntityLocal *def ) {
 	bool callbackUpdate;
 
 	// allow deferred entities to construct themselves
@@ -1122,7 +1267,7 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 	if ( model->IsDynamicModel() == DM_STATIC ) {
 		def->dynamicModel = NULL;
 		def->dynamicModelFrameCount = 0;
-		return model;
+		return false;
 	}
 
 	// continously animating models (particle systems, etc) will have their snapshot updated every single view
@@ -1130,36 +1275,57 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 		R_ClearEntityDefDynamicModel( def );
 	}
 
-	// if we don't have a snapshot of the dynamic model, generate it now
-	if ( !def->dynamicModel ) {
+	// an animated model that didn't move since it was skinned can use the cached snapshot as is
+	if ( def->dynamicModel == NULL && R_EntityDefSkinIsCurrent( def ) ) {
+		if ( def->skinnedFrameCount == tr.frameCount ) {
+			tr.pc.c_skinCacheViewHits++;
+		} else {
+			tr.pc.c_skinCacheFrameHits++;
+		}
+		R_SetEntityDefDynamicModel( def );
+	}
 
-		// instantiate the snapshot of the dynamic model, possibly reusing memory from the cached snapshot
-		def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
+	// if we don't have a snapshot of the dynamic model, it has to be generated now
+	return ( def->dynamicModel == NULL );
+}
+
+/*
+===================
+R_InstantiateEntityDefDynamicModel
 
-		if ( def->cachedDynamicModel ) {
+Instantiates the snapshot of the dynamic model, possibly reusing memory
+from the cached snapshot. This is the only part that may run on a job thread.
+===================
+*/
+static void R_InstantiateEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	def->cachedDynamicModel = def->parms.hModel->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
+}
 
-			// add any overlays to the snapshot of the dynamic model
-			if ( def->overlay && !r_skipOverlays.GetBool() ) {
-				def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
-			} else {
-				idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
-			}
+/*
+===================
+R_FinishEntityDefDynamicModel
 
-			if ( r_checkBounds.GetBool() ) {
-				idBounds b = def->cachedDynamicModel->Bounds();
-				if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
-						b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
-						b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
-						b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
-						b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
-						b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
-					common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
-				}
-			}
-		}
+Remembers what a freshly instantiated snapshot was skinned with and makes it current
+===================
+*/
+static void R_FinishEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	R_StoreEntityDefSkin( def );
+	R_SetEntityDefDynamicModel( def );
+}
 
-		def->dynamicModel = def->cachedDynamicModel;
-		def->dynamicModelFrameCount = tr.frameCount;
+/*
+===================
+R_EntityDefCurrentModel
+
+Returns the model to use for the view once the snapshot is up to date
+and sets the model depth hack.
+===================
+*/
+static idRenderModel *R_EntityDefCurrentModel( idRenderEntityLocal *def ) {
+	idRenderModel *model = def->parms.hModel;
+
+	if ( model->IsDynamicModel() == DM_STATIC ) {
+		return model;
 	}
 
 	// set model depth hack value
@@ -1177,6 +1343,39 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 	return def->dynamicModel;
 }
 
+/*
+===================
+R_EntityDefPreparedDynamicModel
+
+Like R_EntityDefDynamicModel, but without issuing the callback
+===================
+*/
+static idRenderModel *R_EntityDefPreparedDynamicModel( idRenderEntityLocal *def ) {
+	if ( def->dynamicModel == NULL && def->parms.hModel->IsDynamicModel() != DM_STATIC ) {
+		R_InstantiateEntityDefDynamicModel( def );
+		R_FinishEntityDefDynamicModel( def );
+	}
+	return R_EntityDefCurrentModel( def );
+}
+
+/*
+===================
+R_EntityDefDynamicModel
+
+Issues a deferred entity callback if necessary.
+If the model isn't dynamic, it returns the original.
+Returns the cached dynamic model if present, otherwise creates
+it and any necessary overlays
+===================
+*/
+idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
+	if ( R_PrepareEntityDefDynamicModel( def ) ) {
+		R_InstantiateEntityDefDynamicModel( def );
+		R_FinishEntityDefDynamicModel( def );
+	}
+	return R_EntityDefCurrentModel( def );
+}
+
 /*
 =================
 R_AddDrawSurf
@@ -1449,6 +1648,185 @@ idScreenRect R_CalcEntityScissorRectangle( viewEntity_t *vEntity ) {
 	return R_ScreenRectFromViewFrustumBounds( bounds );
 }
 
+/*
+===================
+R_SkipXrayEntity
+===================
+*/
+static bool R_SkipXrayEntity( const viewEntity_t *vEntity ) {
+	if ( tr.viewDef->isXraySubview ) {
+		return ( vEntity->entityDef->parms.xrayIndex == 1 );
+	}
+	return ( vEntity->entityDef->parms.xrayIndex == 2 );
+}
+
+/*
+===================
+R_InstantiateDynamicModelJob
+===================
+*/
+static void R_InstantiateDynamicModelJob( void *data ) {
+	R_InstantiateEntityDefDynamicModel( (idRenderEntityLocal *)data );
+}
+
+/*
+===================
+R_InstantiateDynamicModels
+
+Issues the callbacks of all visible entities in order on the main thread and
+instantiates the snapshots of models that allow it on the job threads.
+R_AddModelSurfaces instantiates the remaining ones serially without issuing
+the callbacks a second time.
+===================
+*/
+static void R_InstantiateDynamicModels( void ) {
+	viewEntity_t		*vEntity;
+	idRenderEntityLocal	*def;
+	idParallelJobList	*jobList = tr.frontEndJobs;
+	idRenderEntityLocal	**jobDefs;
+	int					numEntities, numJobDefs;
+
+	numEntities = 0;
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		numEntities++;
+	}
+	jobDefs = (idRenderEntityLocal **)R_FrameAlloc( numEntities * sizeof( jobDefs[0] ) );
+	numJobDefs = 0;
+
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		if ( vEntity->scissorRect.IsEmpty() || R_SkipXrayEntity( vEntity ) ) {
+			continue;
+		}
+		def = vEntity->entityDef;
+
+		float oldFloatTime = 0.0f;
+		int oldTime = 0;
+
+		game->SelectTimeGroup( def->parms.timeGroup );
+
+		if ( def->parms.timeGroup ) {
+			oldFloatTime = tr.viewDef->floatTime;
+			oldTime = tr.viewDef->renderView.time;
+
+			tr.viewDef->floatTime = game->GetTimeGroupTime( def->parms.timeGroup ) * 0.001;
+			tr.viewDef->renderView.time = game->GetTimeGroupTime( def->parms.timeGroup );
+		}
+
+		if ( R_PrepareEntityDefDynamicModel( def ) && def->parms.hModel->CanInstantiateInParallel( &def->parms ) ) {
+			jobList->AddJob( R_InstantiateDynamicModelJob, def );
+			jobDefs[numJobDefs++] = def;
+		}
+		vEntity->dynamicModelPrepared = true;
+
+		if ( def->parms.timeGroup ) {
+			tr.viewDef->floatTime = oldFloatTime;
+			tr.viewDef->renderView.time = oldTime;
+		}
+	}
+
+	if ( numJobDefs == 0 ) {
+		return;
+	}
+
+	jobList->Submit();
+	jobList->Wait();
+
+	R_AddJobPerformanceCounters();
+
+	// overlays and bounds checks may print, so they are done here
+	for ( int i = 0; i < numJobDefs; i++ ) {
+		R_FinishEntityDefDynamicModel( jobDefs[i] );
+	}
+}
+
+/*
+===================
+R_SetEntityTimeGroup
+
+Switches the view time to the time group of the entity, returns false if the
+entity isn't in a time group.
+===================
+*/
+static bool R_SetEntityTimeGroup( const idRenderEntityLocal *def, float &oldFloatTime, int &oldTime ) {
+	game->SelectTimeGroup( def->parms.timeGroup );
+
+	if ( !def->parms.timeGroup ) {
+		return false;
+	}
+	oldFloatTime = tr.viewDef->floatTime;
+	oldTime = tr.viewDef->renderView.time;
+
+	tr.viewDef->floatTime = game->GetTimeGroupTime( def->parms.timeGroup ) * 0.001;
+	tr.viewDef->renderView.time = game->GetTimeGroupTime( def->parms.timeGroup );
+	return true;
+}
+
+/*
+===================
+R_AddActiveInteraction
+
+When the shadows are created on the job threads, the interaction is only
+prepared here and linked by R_LinkPreparedInteractions once the jobs are done.
+===================
+*/
+typedef struct {
+	idInteraction *		inter;
+	idScreenRect		shadowScissor;
+} preparedInteraction_t;
+
+static idList<preparedInteraction_t>	preparedInteractions;
+
+static void R_AddActiveInteraction( idInteraction *inter, bool parallelShadows ) {
+	if ( !parallelShadows ) {
+		inter->AddActiveInteraction();
+		return;
+	}
+
+	preparedInteraction_t prepared;
+	if ( inter->PrepareActiveInteraction( prepared.shadowScissor ) ) {
+		prepared.inter = inter;
+		preparedInteractions.Append( prepared );
+	}
+}
+
+/*
+===================
+R_LinkPreparedInteractions
+
+Links the prepared interactions in the order they were prepared, so the draw
+surface lists come out the same as when everything is done serially.
+===================
+*/
+static void R_LinkPreparedInteractions( void ) {
+	const idRenderEntityLocal *def = NULL;
+	bool inTimeGroup = false;
+	float oldFloatTime = 0.0f;
+	int oldTime = 0;
+
+	for ( int i = 0; i < preparedInteractions.Num(); i++ ) {
+		idInteraction *inter = preparedInteractions[i].inter;
+
+		// the interactions of an entity are prepared together
+		if ( inter->entityDef != def ) {
+			if ( inTimeGroup ) {
+				tr.viewDef->floatTime = oldFloatTime;
+				tr.viewDef->renderView.time = oldTime;
+			}
+			def = inter->entityDef;
+			inTimeGroup = R_SetEntityTimeGroup( def, oldFloatTime, oldTime );
+		}
+
+		inter->LinkActiveInteraction( preparedInteractions[i].shadowScissor );
+	}
+
+	if ( inTimeGroup ) {
+		tr.viewDef->floatTime = oldFloatTime;
+		tr.viewDef->renderView.time = oldTime;
+	}
+
+	preparedInteractions.SetNum( 0, false );
+}
+
 /*
 ===================
 R_AddModelSurfaces
@@ -1465,15 +1843,14 @@ void R_AddModelSurfaces( void ) {
 	idInteraction		*inter, *next;
 	idRenderModel		*model;
 
+	PROF_SCOPE( "R_AddModelSurfaces" );
+
 	// clear the ambient surface list
 	tr.viewDef->numDrawSurfs = 0;
 	tr.viewDef->maxDrawSurfs = 0;	// will be set to INITIAL_DRAWSURFS on R_AddDrawSurf
 
-	// go through each entity that is either visible to the view, or to
-	// any light that intersects the view (for shadows)
-	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
-
-		if ( r_useEntityScissors.GetBool() ) {
+	if ( r_useEntityScissors.GetBool() ) {
+		for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
 			// calculate the screen area covered by the entity
 			idScreenRect scissorRect = R_CalcEntityScissorRectangle( vEntity );
 			// intersect with the portal crossing scissor rectangle
@@ -1483,6 +1860,24 @@ void R_AddModelSurfaces( void ) {
 				R_ShowColoredScreenRect( vEntity->scissorRect, vEntity->entityDef->index );
 			}
 		}
+	}
+
+	// instantiate the dynamic models of the visible entities up front so
+	// the md5 meshes can be skinned in parallel
+	if ( r_parallelDynamicModels.GetBool() ) {
+		R_InstantiateDynamicModels();
+	}
+
+	// queue up the shadow volumes of the interactions created in this view
+	// and create them on the job threads
+	bool parallelShadows = r_parallelShadows.GetBool() && parallelJobManager->GetNumThreads() > 0;
+	if ( parallelShadows ) {
+		R_BeginShadowJobs();
+	}
+
+	// go through each entity that is either visible to the view, or to
+	// any light that intersects the view (for shadows)
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
 
 		float oldFloatTime = 0.0f;
 		int oldTime = 0;
@@ -1497,13 +1892,7 @@ void R_AddModelSurfaces( void ) {
 			tr.viewDef->renderView.time = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup );
 		}
 
-		if ( tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex == 1 ) {
-			if ( vEntity->entityDef->parms.timeGroup ) {
-				tr.viewDef->floatTime = oldFloatTime;
-				tr.viewDef->renderView.time = oldTime;
-			}
-			continue;
-		} else if ( !tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex == 2 ) {
+		if ( R_SkipXrayEntity( vEntity ) ) {
 			if ( vEntity->entityDef->parms.timeGroup ) {
 				tr.viewDef->floatTime = oldFloatTime;
 				tr.viewDef->renderView.time = oldTime;
@@ -1513,7 +1902,12 @@ void R_AddModelSurfaces( void ) {
 
 		// add the ambient surface if it has a visible rectangle
 		if ( !vEntity->scissorRect.IsEmpty() ) {
-			model = R_EntityDefDynamicModel( vEntity->entityDef );
+			if ( vEntity->dynamicModelPrepared ) {
+				// the callback was already issued by R_InstantiateDynamicModels
+				model = R_EntityDefPreparedDynamicModel( vEntity->entityDef );
+			} else {
+				model = R_EntityDefDynamicModel( vEntity->entityDef );
+			}
 			if ( model == NULL || model->NumSurfaces() <= 0 ) {
 				if ( vEntity->entityDef->parms.timeGroup ) {
 					tr.viewDef->floatTime = oldFloatTime;
@@ -1538,7 +1932,7 @@ void R_AddModelSurfaces( void ) {
 					if ( inter->lightDef->viewCount != tr.viewCount ) {
 						continue;
 					}
-					inter->AddActiveInteraction();
+					R_AddActiveInteraction( inter, parallelShadows );
 				}
 			}
 		} else {
@@ -1553,7 +1947,7 @@ void R_AddModelSurfaces( void ) {
 				if ( inter->lightDef->viewCount != tr.viewCount ) {
 					continue;
 				}
-				inter->AddActiveInteraction();
+				R_AddActiveInteraction( inter, parallelShadows );
 			}
 		}
 
@@ -1563,6 +1957,11 @@ void R_AddModelSurfaces( void ) {
 		}
 
 	}
+
+	if ( parallelShadows ) {
+		R_EndShadowJobs( tr.frontEndJobs );
+		R_LinkPreparedInteractions();
+	}
 }
 
 /*
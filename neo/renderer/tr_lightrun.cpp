@@ -160,15 +160,10 @@ void R_ModulateLights_f( const idCmdArgs &args ) {
 
 /*
 ===============
-R_CreateEntityRefs
-
-Creates all needed model references in portal areas,
-chaining them to both the area and the entityDef.
-
-Bumps tr.viewCount.
+R_PushEntityRefs
 ===============
 */
-void R_CreateEntityRefs( idRenderEntityLocal *def ) {
+static void R_PushEntityRefs( idRenderEntityLocal *def ) {
 	int			i;
 	idVec3		transformed[8];
 	idVec3		v;
@@ -213,6 +208,31 @@ void R_CreateEntityRefs( idRenderEntityLocal *def ) {
 	def->world->PushVolumeIntoTree( def, NULL, 8, transformed );
 }
 
+/*
+===============
+R_CreateEntityRefs
+
+Creates all needed model references in portal areas,
+chaining them to both the area and the entityDef.
+References kept by R_FreeEntityDefDerivedData are
+reused for the areas the entity is still in.
+
+Bumps tr.viewCount.
+===============
+*/
+void R_CreateEntityRefs( idRenderEntityLocal *def ) {
+	idRenderWorldLocal *world = def->world;
+
+	world->oldEntityRefs = def->entityRefs;
+	def->entityRefs = NULL;
+
+	R_PushEntityRefs( def );
+
+	// free the references to the areas the entity left
+	world->FreeEntityRefs( world->oldEntityRefs );
+	world->oldEntityRefs = NULL;
+}
+
 
 /*
 =================================================================================
@@ -596,8 +616,6 @@ Frees all references and lit surfaces from the light
 ====================
 */
 void R_FreeLightDefDerivedData( idRenderLightLocal *ldef ) {
-	areaReference_t	*lref, *nextRef;
-
 	// rmove any portal fog references
 	for ( doublePortal_t *dp = ldef->foggedPortals ; dp ; dp = dp->nextFoggedPortal ) {
 		dp->fogLight = NULL;
@@ -609,32 +627,48 @@ void R_FreeLightDefDerivedData( idRenderLightLocal *ldef ) {
 	}
 
 	// free all the references to the light
-	for ( lref = ldef->references ; lref ; lref = nextRef ) {
-		nextRef = lref->ownerNext;
-
-		// unlink from the area
-		lref->areaNext->areaPrev = lref->areaPrev;
-		lref->areaPrev->areaNext = lref->areaNext;
-
-		// put it back on the free list for reuse
-		ldef->world->areaReferenceAllocator.Free( lref );
+	if ( ldef->references ) {
+		ldef->world->FreeLightRefs( ldef->references );
+		ldef->references = NULL;
 	}
-	ldef->references = NULL;
 
 	R_FreeLightDefFrustum( ldef );
 }
 
+/*
+====================
+R_InvalidateLightDefInteractions
+
+Used when the light changed in a way that doesn't move its area references.
+The interaction surfaces are recreated when the interactions are next used in
+a view, but empty interactions are never looked at again, so they are freed
+and will be created anew by CreateLightDefInteractions.
+====================
+*/
+void R_InvalidateLightDefInteractions( idRenderLightLocal *ldef ) {
+	idInteraction *inter, *next;
+
+	ldef->revision++;
+
+	for ( inter = ldef->firstInteraction; inter != NULL; inter = next ) {
+		next = inter->lightNext;
+		if ( inter->IsEmpty() ) {
+			inter->UnlinkAndFree();
+		}
+	}
+}
+
 /*
 ===================
 R_FreeEntityDefDerivedData
 
 Used by both RE_FreeEntityDef and RE_UpdateEntityDef
 Does not actually free the entityDef.
+The kept references are reused or freed by R_CreateEntityRefs.
 ===================
 */
-void R_FreeEntityDefDerivedData( idRenderEntityLocal *def, bool keepDecals, bool keepCachedDynamicModel ) {
+void R_FreeEntityDefDerivedData( idRenderEntityLocal *def, bool keepDecals, bool keepCachedDynamicModel, bool keepRefs ) {
 	int i;
-	areaReference_t	*ref, *next;
 
 	// demo playback needs to free the joints, while normal play
 	// leaves them in the control of the game
@@ -673,20 +707,14 @@ void R_FreeEntityDefDerivedData( idRenderEntityLocal *def, bool keepDecals, bool
 	if ( !keepCachedDynamicModel ) {
 		delete def->cachedDynamicModel;
 		def->cachedDynamicModel = NULL;
+		def->skinnedModel = NULL;
 	}
 
 	// free the entityRefs from the areas
-	for ( ref = def->entityRefs ; ref ; ref = next ) {
-		next = ref->ownerNext;
-
-		// unlink from the area
-		ref->areaNext->areaPrev = ref->areaPrev;
-		ref->areaPrev->areaNext = ref->areaNext;
-
-		// put it back on the free list for reuse
-		def->world->areaReferenceAllocator.Free( ref );
+	if ( def->entityRefs && !keepRefs ) {
+		def->world->FreeEntityRefs( def->entityRefs );
+		def->entityRefs = NULL;
 	}
-	def->entityRefs = NULL;
 }
 
 /*
@@ -710,6 +738,26 @@ void R_ClearEntityDefDynamicModel( idRenderEntityLocal *def ) {
 	}
 }
 
+/*
+==================
+R_InvalidateEntityDefInteractions
+
+The entity counterpart of R_InvalidateLightDefInteractions
+==================
+*/
+void R_InvalidateEntityDefInteractions( idRenderEntityLocal *def ) {
+	idInteraction *inter, *next;
+
+	def->revision++;
+
+	for ( inter = def->firstInteraction; inter != NULL; inter = next ) {
+		next = inter->entityNext;
+		if ( inter->IsEmpty() ) {
+			inter->UnlinkAndFree();
+		}
+	}
+}
+
 /*
 ===================
 R_FreeEntityDefDecals
@@ -766,7 +814,7 @@ void R_FreeDerivedData( void ) {
 			if ( !def ) {
 				continue;
 			}
-			R_FreeEntityDefDerivedData( def, false, false );
+			R_FreeEntityDefDerivedData( def, false, false, false );
 		}
 
 		for ( i = 0; i < rw->lightDefs.Num(); i++ ) {
@@ -800,7 +848,7 @@ void R_CheckForEntityDefsUsingModel( idRenderModel *model ) {
 			if ( def->parms.hModel == model ) {
 				//assert( 0 );
 				// this should never happen but Radiant messes it up all the time so just free the derived data
-				R_FreeEntityDefDerivedData( def, false, false );
+				R_FreeEntityDefDerivedData( def, false, false, false );
 			}
 		}
 	}
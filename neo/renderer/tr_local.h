@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 
 class idScreenRect; // yay for include recursion
 
+#include "idlib/geometry/JointTransform.h"
 #include "renderer/Image.h"
 #include "renderer/Interaction.h"
 #include "renderer/MegaTexture.h"
@@ -38,6 +39,7 @@ class idScreenRect; // yay for include recursion
 #include "renderer/ModelOverlay.h"
 #include "renderer/RenderSystem.h"
 #include "renderer/RenderWorld.h"
+#include "sys/jobs.h"
 
 class idRenderWorldLocal;
 
@@ -147,6 +149,7 @@ typedef struct areaReference_s {
 	idRenderEntityLocal *	entity;					// only one of entity / light will be non-NULL
 	idRenderLightLocal *	light;					// only one of entity / light will be non-NULL
 	struct portalArea_s	*	area;					// so owners can find all the areas they are in
+	int						bvhNode;				// leaf in the area entityTree or lightTree
 } areaReference_t;
 
 
@@ -208,6 +211,8 @@ public:
 													// in the cached memory
 	bool					archived;				// for demo writing
 
+	int						revision;				// changed when the interactions have to be recreated
+
 
 	// derived information
 	idPlane					lightProject[4];
@@ -262,11 +267,22 @@ public:
 													// in the cached memory
 	bool					archived;				// for demo writing
 
+	int						revision;				// changed when the interactions have to be recreated
+
 	idRenderModel *			dynamicModel;			// if parms.model->IsDynamicModel(), this is the generated data
 	int						dynamicModelFrameCount;	// continuously animating dynamic models will recreate
 													// dynamicModel if this doesn't == tr.viewCount
 	idRenderModel *			cachedDynamicModel;
 
+	// the joints and skin cachedDynamicModel was skinned with, so the views, subviews
+	// and entity updates that don't change the pose can reuse it
+	const idRenderModel *	skinnedModel;			// NULL if the cached snapshot can't be reused
+	idList<idJointMat>		skinnedJoints;
+	const idDeclSkin *		skinnedSkin;
+	const idMaterial *		skinnedShader;
+	float					skinnedScale;
+	int						skinnedFrameCount;		// tr.frameCount when the snapshot was skinned
+
 	idBounds				referenceBounds;		// the local bounds used to place entityRefs, either from parms or a model
 
 	// a viewEntity_t is created whenever a idRenderEntityLocal is considered for inclusion
@@ -359,6 +375,9 @@ typedef struct viewEntity_s {
 	bool				weaponDepthHack;
 	float				modelDepthHack;
 
+	// the entity callback was already issued by R_InstantiateDynamicModels
+	bool				dynamicModelPrepared;
+
 	float				modelMatrix[16];		// local coords to global coords
 	float				modelViewMatrix[16];	// local coords to eye coords
 } viewEntity_t;
@@ -525,6 +544,10 @@ typedef struct frameMemoryBlock_s {
 // contained in a frameData_t.  This entire structure is
 // duplicated so the front and back end can run in parallel
 // on an SMP machine (OBSOLETE: this capability has been removed)
+// the main thread and each job worker thread allocate
+// frame memory from their own arena
+const int MAX_FRAME_ARENAS =			MAX_JOB_THREADS + 1;
+
 typedef struct {
 	// one or more blocks of memory for all frame
 	// temporary allocations
@@ -533,10 +556,20 @@ typedef struct {
 	// alloc will point somewhere into the memory chain
 	frameMemoryBlock_t	*alloc;
 
+	// updated by R_CountFrameData
+	int					used;				// used on the current frame
+	int					highwater;			// max used on any frame
+	int					numBlocks;
+} frameArena_t;
+
+typedef struct {
+	frameArena_t		arenas[MAX_FRAME_ARENAS];
+
 	srfTriangles_t *	firstDeferredFreeTriSurf;
 	srfTriangles_t *	lastDeferredFreeTriSurf;
 
 	int					memoryHighwater;	// max used on any frame
+	int					frameHighwater;		// used by the last completed frame
 
 	// the currently building command list
 	// commands can be inserted at the front if needed, as for required
@@ -546,6 +579,10 @@ typedef struct {
 
 extern	frameData_t	*frameData;
 
+// tri surface, vertex cache and frame memory block allocations can
+// be done by front end jobs, they are serialized with this
+#define CRITICAL_SECTION_RENDERER		CRITICAL_SECTION_TWO
+
 //=======================================================================
 
 void R_ClearCommandChain( void );
@@ -575,7 +612,12 @@ typedef struct {
 	int		c_createInteractions;	// number of calls to idInteraction::CreateInteraction
 	int		c_createLightTris;
 	int		c_createShadowVolumes;
+	int		c_interactionCacheHits;		// interactions that were reused by a view
+	int		c_interactionCacheStale;	// interactions recreated because of a revision change
+	int		c_entityUpdatesKept, c_lightUpdatesKept;	// updates that didn't free the interactions
 	int		c_generateMd5;
+	int		c_skinCacheViewHits;	// md5 snapshots reused by another view of the same frame
+	int		c_skinCacheFrameHits;	// md5 snapshots reused by a later frame
 	int		c_entityDefCallbacks;
 	int		c_alloc, c_free;	// counts for R_StaticAllc/R_StaticFree
 	int		c_visibleViewEntities;
@@ -587,8 +629,15 @@ typedef struct {
 	int		c_deformedIndexes;	// idMD5Mesh::GenerateSurface
 	int		c_tangentIndexes;	// R_DeriveTangents()
 	int		c_entityUpdates, c_lightUpdates, c_entityReferences, c_lightReferences;
+	int		c_entityReferencesKept;		// references reused by a moved entity
 	int		c_guiSurfs;
+	int		c_shadowJobs;		// shadow volumes queued for the job threads
+	int		c_shadowJobBatches;
+	int		shadowJobUsec;		// time spent waiting for the shadow jobs
+	int		addLightsUsec;		// R_AddLightSurfaces
+	int		addModelsUsec;		// R_AddModelSurfaces
 	int		frontEndMsec;		// sum of time in all RE_RenderScene's in a frame
+	int		frontEndUsec;
 } performanceCounters_t;
 
 
@@ -631,8 +680,11 @@ typedef struct {
 	int		c_vboIndexes;
 	float	c_overDraw;
 
+	int		c_stateChanges;		// material and light changes, only counted by the null back end
+
 	float	maxLightValue;	// for light scale
 	int		msec;			// total msec for backend run
+	int		usec;
 } backEndCounters_t;
 
 // all state modified by the back end is separated
@@ -727,6 +779,7 @@ public:
 	virtual void			CaptureRenderToFile( const char *fileName, bool fixAlpha );
 	virtual void			UnCrop();
 	virtual bool			UploadImage( const char *imageName, const byte *data, int width, int height );
+	virtual void			GetFrameTimings( renderFrameTimings_t &timings ) const;
 
 public:
 	// internal functions
@@ -760,6 +813,7 @@ public:
 	float					backEndRendererMaxLight;	// 1.0 for standard, unlimited for floats
 														// determines how much overbrighting needs
 														// to be done post-process
+	bool					nullBackend;		// r_nullBackend when the renderer was started, nothing is drawn
 
 	idVec4					ambientLightVector;	// used for "ambient bump mapping"
 
@@ -782,6 +836,7 @@ public:
 	viewDef_t *				viewDef;
 
 	performanceCounters_t	pc;					// performance counters
+	performanceCounters_t	jobPC[MAX_JOB_THREADS];	// counted by the front end jobs, added to pc by R_AddJobPerformanceCounters
 
 	drawSurfsCommand_t		lockSurfacesCmd;	// use this when r_lockSurfaces = 1
 	//renderView_t			lockSurfacesRenderView;
@@ -799,6 +854,10 @@ public:
 	class idGuiModel *		guiModel;
 	class idGuiModel *		demoGuiModel;
 
+	idParallelJobList *		frontEndJobs;		// dynamic model instantiation and shadow volumes
+
+	renderFrameTimings_t	frameTimings;		// saved by EndFrame before the counters are cleared
+
 	// DG: remember the original glConfig.vidWidth/Height values that get overwritten in BeginFrame()
 	//     so they can be reset in EndFrame() (Editors tend to mess up the viewport by using BeginFrame())
 	int						origWidth;
@@ -809,6 +868,16 @@ extern backEndState_t		backEnd;
 extern idRenderSystemLocal	tr;
 extern glconfig_t			glConfig;		// outside of TR since it shouldn't be cleared during ref re-init
 
+// performance counters of the calling thread, code that runs in the
+// front end jobs must count into these instead of tr.pc
+ID_INLINE performanceCounters_t &R_ThreadPerformanceCounters( void ) {
+	int worker = parallelJobManager->GetWorkerIndex();
+	return ( worker < 0 ) ? tr.pc : tr.jobPC[worker];
+}
+
+// adds the counters of the job threads to tr.pc, called after the jobs are done
+void R_AddJobPerformanceCounters( void );
+
 
 //
 // cvars
@@ -854,6 +923,9 @@ extern idCVar r_useLightCulling;		// 0 = none, 1 = box, 2 = exact clip of polyhe
 extern idCVar r_useLightScissors;		// 1 = use custom scissor rectangle for each light
 extern idCVar r_useClippedLightScissors;// 0 = full screen when near clipped, 1 = exact when near clipped, 2 = exact always
 extern idCVar r_useEntityCulling;		// 0 = none, 1 = box
+extern idCVar r_useAreaBVH;			// use the area trees to find the entities and lights touching a volume
+extern idCVar r_parallelDynamicModels;	// instantiate md5 models on the job threads
+extern idCVar r_parallelShadows;		// create the shadow volumes of a view on the job threads
 extern idCVar r_useEntityScissors;		// 1 = use custom scissor rectangle for each entity
 extern idCVar r_useInteractionCulling;	// 1 = cull interactions
 extern idCVar r_useInteractionScissors;	// 1 = use a custom scissor rectangle for each interaction
@@ -866,7 +938,9 @@ extern idCVar r_useOptimizedShadows;	// 1 = use the dmap generated static shadow
 extern idCVar r_useShadowVertexProgram;	// 1 = do the shadow projection in the vertex program on capable cards
 extern idCVar r_useShadowProjectedCull;	// 1 = discard triangles outside light volume before shadowing
 extern idCVar r_useDeferredTangents;	// 1 = don't always calc tangents after deform
+extern idCVar r_useVertexStreams;		// 1 = skin md5 meshes into tri->streams
 extern idCVar r_useCachedDynamicModels;	// 1 = cache snapshots of dynamic models
+extern idCVar r_useSkinCache;			// 1 = reuse md5 snapshots if the joints and skin didn't change
 extern idCVar r_useTwoSidedStencil;		// 1 = do stencil shadows in one pass with different ops on each side
 extern idCVar r_useInfiniteFarZ;		// 1 = use the no-far-clip-plane trick
 extern idCVar r_useScissor;				// 1 = scissor clip as portals and lights are processed
@@ -884,6 +958,7 @@ extern idCVar r_skipSuppress;			// ignore the per-view suppressions
 extern idCVar r_skipInteractions;		// skip all light/surface interaction drawing
 extern idCVar r_skipFrontEnd;			// bypasses all front end work, but 2D gui rendering still draws
 extern idCVar r_skipBackEnd;			// don't draw anything
+extern idCVar r_nullBackend;			// run the front end without a window or OpenGL context
 extern idCVar r_skipCopyTexture;		// do all rendering, but don't actually copyTexSubImage2D
 extern idCVar r_skipRender;				// skip 3D rendering, but pass 2D
 extern idCVar r_skipRenderContext;		// NULL the rendering context during backend 3D rendering
@@ -944,6 +1019,7 @@ extern idCVar r_showInteractionScissors;// show screen rectangle which contains
 extern idCVar r_showMemory;				// print frame memory utilization
 extern idCVar r_showCull;				// report sphere and box culling stats
 extern idCVar r_showInteractions;		// report interaction generation activity
+extern idCVar r_showShadowJobs;		// report the shadow volumes created on the job threads
 extern idCVar r_showSurfaces;			// report surface/light/shadow counts
 extern idCVar r_showPrimitives;			// report vertex/index/draw counts
 extern idCVar r_showPortals;			// draw portal outlines in color based on passed / not passed
@@ -1128,6 +1204,13 @@ bool R_CullLocalBox( const idBounds &bounds, const float modelMatrix[16], int nu
 bool R_RadiusCullLocalBox( const idBounds &bounds, const float modelMatrix[16], int numPlanes, const idPlane *planes );
 bool R_CornerCullLocalBox( const idBounds &bounds, const float modelMatrix[16], int numPlanes, const idPlane *planes );
 
+// batched R_CullLocalBox, the boxes and the visible bits are in frame memory
+#define R_CullBoxVisible( visibleBits, i )	( ( (visibleBits)[(i) >> 5] & ( 1 << ( (i) & 31 ) ) ) != 0 )
+void R_AllocCullBoxes( cullBoxes_t &boxes, int numBoxes );
+void R_SetCullBox( cullBoxes_t &boxes, int index, const idBounds &bounds, const float modelMatrix[16] );
+dword *R_CullBoxes( const cullBoxes_t &boxes, int numBoxes, int numPlanes, const idPlane *planes );
+void R_CullBenchmark_f( const idCmdArgs &args );
+
 void R_AxisToModelMatrix( const idMat3 &axis, const idVec3 &origin, float modelMatrix[16] );
 
 // note that many of these assume a normalized matrix, and will not work with scaled axis
@@ -1207,10 +1290,12 @@ void R_CreateLightRefs( idRenderLightLocal *light );
 
 void R_DeriveLightData( idRenderLightLocal *light );
 void R_FreeLightDefDerivedData( idRenderLightLocal *light );
+void R_InvalidateLightDefInteractions( idRenderLightLocal *light );
 void R_CheckForEntityDefsUsingModel( idRenderModel *model );
 
 void R_ClearEntityDefDynamicModel( idRenderEntityLocal *def );
-void R_FreeEntityDefDerivedData( idRenderEntityLocal *def, bool keepDecals, bool keepCachedDynamicModel );
+void R_InvalidateEntityDefInteractions( idRenderEntityLocal *def );
+void R_FreeEntityDefDerivedData( idRenderEntityLocal *def, bool keepDecals, bool keepCachedDynamicModel, bool keepRefs );
 void R_FreeEntityDefCachedDynamicModel( idRenderEntityLocal *def );
 void R_FreeEntityDefDecals( idRenderEntityLocal *def );
 void R_FreeEntityDefOverlay( idRenderEntityLocal *def );
@@ -1381,6 +1466,9 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 									 const srfTriangles_t *tri, const idRenderLightLocal *light,
 									 shadowGen_t optimize, srfCullInfo_t &cullInfo );
 
+// frees the scratch buffers the threads used to build shadow volumes
+void R_FreeShadowScratch( void );
+
 /*
 ============================================================
 
@@ -1450,6 +1538,8 @@ srfTriangles_t *	R_AllocStaticTriSurf( void );
 srfTriangles_t *	R_CopyStaticTriSurf( const srfTriangles_t *tri );
 void				R_AllocStaticTriSurfVerts( srfTriangles_t *tri, int numVerts );
 void				R_AllocStaticTriSurfIndexes( srfTriangles_t *tri, int numIndexes );
+void				R_AllocStaticTriSurfStreams( srfTriangles_t *tri, int numVerts );
+void				R_FreeStaticTriSurfStreams( srfTriangles_t *tri );
 void				R_AllocStaticTriSurfShadowVerts( srfTriangles_t *tri, int numVerts );
 void				R_AllocStaticTriSurfPlanes( srfTriangles_t *tri, int numIndexes );
 void				R_ResizeStaticTriSurfVerts( srfTriangles_t *tri, int numVerts );
@@ -1465,6 +1555,8 @@ void				R_FreeDeferredTriSurfs( frameData_t *frame );
 int					R_TriSurfMemory( const srfTriangles_t *tri );
 
 void				R_BoundTriSurf( srfTriangles_t *tri );
+void				R_CopyStreamPositionsToVerts( srfTriangles_t *tri );
+void				R_CopyStreamTangentsToVerts( srfTriangles_t *tri );
 void				R_RemoveDuplicatedTriangles( srfTriangles_t *tri );
 void				R_CreateSilIndexes( srfTriangles_t *tri );
 void				R_RemoveDegenerateTriangles( srfTriangles_t *tri );
@@ -1538,6 +1630,7 @@ SCENE GENERATION
 void R_InitFrameData( void );
 void R_ShutdownFrameData( void );
 int R_CountFrameData( void );
+void R_PrintFrameData( void );
 void R_ToggleSmpFrame( void );
 void *R_FrameAlloc( int bytes );
 void *R_ClearedFrameAlloc( int bytes );
@@ -1588,6 +1681,18 @@ void RB_ShowImages( void );
 
 void RB_ExecuteBackEndCommands( const emptyCommand_t *cmds );
 
+/*
+=============================================================
+
+TR_NULLBACKEND
+
+=============================================================
+*/
+
+void R_InitNullBackend( void );
+void RB_NullExecuteBackEndCommands( const emptyCommand_t *cmds );
+void R_NullBackendStats_f( const idCmdArgs &args );
+
 
 /*
 =============================================================
@@ -34,6 +34,7 @@ If you have questions concerning this license or the applicable additional terms
 #endif
 
 #include "sys/platform.h"
+#include "idlib/Profiler.h"
 #include "framework/Session.h"
 #include "renderer/RenderWorld_local.h"
 
@@ -178,9 +179,40 @@ void R_ShowColoredScreenRect( const idScreenRect &rect, int colorIndex ) {
 	}
 }
 
+#define	MEMORY_BLOCK_SIZE	0x100000
+
+/*
+====================
+R_AllocFrameBlock
+
+Can be called by front end jobs.
+====================
+*/
+static frameMemoryBlock_t *R_AllocFrameBlock( int size ) {
+	frameMemoryBlock_t *block;
+
+	// round up to whole blocks
+	size = ( Max( size, 1 ) + MEMORY_BLOCK_SIZE - 1 ) & ~( MEMORY_BLOCK_SIZE - 1 );
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
+	block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
+	if ( !block ) {
+		common->FatalError( "R_AllocFrameBlock: Mem_Alloc() failed" );
+	}
+	block->size = size;
+	block->used = 0;
+	block->next = NULL;
+	return block;
+}
+
 /*
 ====================
 R_ToggleSmpFrame
+
+An arena that had to chain several blocks on the last frame
+gets them replaced by a single block large enough for that frame,
+so the chain doesn't keep growing in small steps on large maps.
 ====================
 */
 void R_ToggleSmpFrame( void ) {
@@ -188,19 +220,32 @@ void R_ToggleSmpFrame( void ) {
 
 	// clear frame-temporary data
 	frameData_t		*frame;
-	frameMemoryBlock_t	*block;
-
-	// update the highwater mark
-	R_CountFrameData();
+	frameArena_t	*arena;
+	frameMemoryBlock_t	*block, *nextBlock;
 
+	// update the highwater marks
 	frame = frameData;
+	frame->frameHighwater = R_CountFrameData();
+
+	for ( arena = frame->arenas; arena < frame->arenas + MAX_FRAME_ARENAS; arena++ ) {
+		if ( arena->numBlocks > 1 ) {
+			// leave some room for growth
+			int size = arena->used + arena->used / 4;
+			for ( block = arena->memory ; block ; block = nextBlock ) {
+				nextBlock = block->next;
+				Mem_Free( block );
+			}
+			arena->memory = R_AllocFrameBlock( size );
+			arena->numBlocks = 1;
+		}
 
-	// reset the memory allocation to the first block
-	frame->alloc = frame->memory;
+		// reset the memory allocation to the first block
+		arena->alloc = arena->memory;
 
-	// clear all the blocks
-	for ( block = frame->memory ; block ; block = block->next ) {
-		block->used = 0;
+		// clear all the blocks
+		for ( block = arena->memory ; block ; block = block->next ) {
+			block->used = 0;
+		}
 	}
 
 	R_ClearCommandChain();
@@ -209,8 +254,6 @@ void R_ToggleSmpFrame( void ) {
 
 //=====================================================
 
-#define	MEMORY_BLOCK_SIZE	0x100000
-
 /*
 =====================
 R_ShutdownFrameData
@@ -229,9 +272,11 @@ void R_ShutdownFrameData( void ) {
 	R_FreeDeferredTriSurfs( frame );
 
 	frameMemoryBlock_t *nextBlock;
-	for ( block = frame->memory ; block ; block = nextBlock ) {
-		nextBlock = block->next;
-		Mem_Free( block );
+	for ( int i = 0; i < MAX_FRAME_ARENAS; i++ ) {
+		for ( block = frame->arenas[i].memory ; block ; block = nextBlock ) {
+			nextBlock = block->next;
+			Mem_Free( block );
+		}
 	}
 	Mem_Free( frame );
 	frameData = NULL;
@@ -240,26 +285,19 @@ void R_ShutdownFrameData( void ) {
 /*
 =====================
 R_InitFrameData
+
+The arenas of the job worker threads get their
+first block when they first allocate frame memory.
 =====================
 */
 void R_InitFrameData( void ) {
-	int size;
 	frameData_t *frame;
-	frameMemoryBlock_t *block;
 
 	R_ShutdownFrameData();
 
 	frameData = (frameData_t *)Mem_ClearedAlloc( sizeof( *frameData ));
 	frame = frameData;
-	size = MEMORY_BLOCK_SIZE;
-	block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
-	if ( !block ) {
-		common->FatalError( "R_InitFrameData: Mem_Alloc() failed" );
-	}
-	block->size = size;
-	block->used = 0;
-	block->next = NULL;
-	frame->memory = block;
+	frame->arenas[0].memory = R_AllocFrameBlock( MEMORY_BLOCK_SIZE );
 	frame->memoryHighwater = 0;
 
 	R_ToggleSmpFrame();
@@ -268,20 +306,37 @@ void R_InitFrameData( void ) {
 /*
 ================
 R_CountFrameData
+
+Returns the frame memory used so far this frame and
+updates the highwater marks of the frame and the arenas.
 ================
 */
 int R_CountFrameData( void ) {
 	frameData_t		*frame;
+	frameArena_t	*arena;
 	frameMemoryBlock_t	*block;
 	int				count;
+	bool			counting;
 
 	count = 0;
 	frame = frameData;
-	for ( block = frame->memory ; block ; block=block->next ) {
-		count += block->used;
-		if ( block == frame->alloc ) {
-			break;
+	for ( arena = frame->arenas; arena < frame->arenas + MAX_FRAME_ARENAS; arena++ ) {
+		arena->used = 0;
+		arena->numBlocks = 0;
+		counting = ( arena->alloc != NULL );
+		for ( block = arena->memory ; block ; block=block->next ) {
+			arena->numBlocks++;
+			if ( counting ) {
+				arena->used += block->used;
+			}
+			if ( block == arena->alloc ) {
+				counting = false;
+			}
 		}
+		if ( arena->used > arena->highwater ) {
+			arena->highwater = arena->used;
+		}
+		count += arena->used;
 	}
 
 	// note if this is a new highwater mark
@@ -292,6 +347,41 @@ int R_CountFrameData( void ) {
 	return count;
 }
 
+/*
+================
+R_PrintFrameData
+
+Prints the frame memory utilization for r_showMemory
+================
+*/
+void R_PrintFrameData( void ) {
+	frameData_t		*frame;
+	frameArena_t	*arena;
+	frameMemoryBlock_t	*block;
+	int				count, size;
+
+	frame = frameData;
+	if ( !frame ) {
+		return;
+	}
+
+	count = R_CountFrameData();
+	common->Printf( "frameData: %i (%i) last frame: %i\n", count, frame->memoryHighwater, frame->frameHighwater );
+
+	for ( int i = 0; i < MAX_FRAME_ARENAS; i++ ) {
+		arena = &frame->arenas[i];
+		if ( !arena->memory ) {
+			continue;
+		}
+		size = 0;
+		for ( block = arena->memory ; block ; block=block->next ) {
+			size += block->size;
+		}
+		common->Printf( "  %s %2i: %8i used %8i peak %3i blocks %6ik\n", i == 0 ? "main  " : "worker", i - 1,
+			arena->used, arena->highwater, arena->numBlocks, size >> 10 );
+	}
+}
+
 /*
 =================
 R_StaticAlloc
@@ -300,7 +390,7 @@ R_StaticAlloc
 void *R_StaticAlloc( int bytes ) {
 	void	*buf;
 
-	tr.pc.c_alloc++;
+	R_ThreadPerformanceCounters().c_alloc++;
 
 	tr.staticAllocCount += bytes;
 
@@ -332,10 +422,32 @@ R_StaticFree
 =================
 */
 void R_StaticFree( void *data ) {
-	tr.pc.c_free++;
+	R_ThreadPerformanceCounters().c_free++;
 	Mem_Free( data );
 }
 
+/*
+================
+R_AddJobPerformanceCounters
+================
+*/
+void R_AddJobPerformanceCounters( void ) {
+	for ( int i = 0; i < MAX_JOB_THREADS; i++ ) {
+		performanceCounters_t &pc = tr.jobPC[i];
+
+		tr.pc.c_createShadowVolumes += pc.c_createShadowVolumes;
+		tr.pc.c_generateMd5 += pc.c_generateMd5;
+		tr.pc.c_deformedSurfaces += pc.c_deformedSurfaces;
+		tr.pc.c_deformedVerts += pc.c_deformedVerts;
+		tr.pc.c_deformedIndexes += pc.c_deformedIndexes;
+		tr.pc.c_tangentIndexes += pc.c_tangentIndexes;
+		tr.pc.c_alloc += pc.c_alloc;
+		tr.pc.c_free += pc.c_free;
+
+		memset( &pc, 0, sizeof( pc ) );
+	}
+}
+
 /*
 ================
 R_FrameAlloc
@@ -357,51 +469,50 @@ The memory will not move, but it may not be
 contiguous with previous allocations even
 from this frame.
 
+Front end jobs can allocate frame memory as well,
+each job worker thread has its own arena so only
+the allocation of new blocks needs a lock. All
+arenas are reset together by R_ToggleSmpFrame.
+
 The memory is NOT zero filled.
 Should part of this be inlined in a macro?
 ================
 */
 void *R_FrameAlloc( int bytes ) {
-	frameData_t		*frame;
+	frameArena_t		*arena;
 	frameMemoryBlock_t	*block;
 	void			*buf;
 
 	bytes = (bytes+16)&~15;
 	// see if it can be satisfied in the current block
-	frame = frameData;
-	block = frame->alloc;
+	arena = &frameData->arenas[ parallelJobManager->GetWorkerIndex() + 1 ];
+	block = arena->alloc;
 
-	if ( block->size - block->used >= bytes ) {
+	if ( block && block->size - block->used >= bytes ) {
 		buf = block->base + block->used;
 		block->used += bytes;
 		return buf;
 	}
 
 	// advance to the next memory block if available
-	block = block->next;
+	block = block ? block->next : arena->memory;
+	// skip blocks that are too small for a large allocation
+	while ( block && bytes > block->size ) {
+		arena->alloc = block;
+		block = block->next;
+	}
 	// create a new block if we are at the end of
-	// the chain
+	// the chain, large enough for the allocation
 	if ( !block ) {
-		int		size;
-
-		size = MEMORY_BLOCK_SIZE;
-		block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
-		if ( !block ) {
-			common->FatalError( "R_FrameAlloc: Mem_Alloc() failed" );
+		block = R_AllocFrameBlock( Max( bytes, MEMORY_BLOCK_SIZE ) );
+		if ( arena->alloc ) {
+			arena->alloc->next = block;
+		} else {
+			arena->memory = block;
 		}
-		block->size = size;
-		block->used = 0;
-		block->next = NULL;
-		frame->alloc->next = block;
 	}
 
-	// we could fix this if we needed to...
-	if ( bytes > block->size ) {
-		common->FatalError( "R_FrameAlloc of %i exceeded MEMORY_BLOCK_SIZE",
-			bytes );
-	}
-
-	frame->alloc = block;
+	arena->alloc = block;
 
 	block->used = bytes;
 
@@ -678,6 +789,204 @@ bool R_CullLocalBox( const idBounds &bounds, const float modelMatrix[16], int nu
 	return R_CornerCullLocalBox( bounds, modelMatrix, numPlanes, planes );
 }
 
+/*
+=================
+R_AllocCullBoxes
+
+Allocates frame memory for numBoxes boxes that will be culled together
+=================
+*/
+void R_AllocCullBoxes( cullBoxes_t &boxes, int numBoxes ) {
+	float *data = (float *)R_FrameAlloc( 12 * numBoxes * sizeof( float ) );
+
+	for ( int i = 0; i < 3; i++ ) {
+		boxes.center[i] = data + i * numBoxes;
+		for ( int j = 0; j < 3; j++ ) {
+			boxes.axis[i][j] = data + ( 3 + i * 3 + j ) * numBoxes;
+		}
+	}
+}
+
+/*
+=================
+R_SetCullBox
+
+Transforms the local bounds into a global box for R_CullBoxes
+=================
+*/
+void R_SetCullBox( cullBoxes_t &boxes, int index, const idBounds &bounds, const float modelMatrix[16] ) {
+	idVec3 localOrigin = ( bounds[0] + bounds[1] ) * 0.5f;
+	idVec3 worldOrigin;
+
+	R_LocalPointToGlobal( modelMatrix, localOrigin, worldOrigin );
+
+	for ( int i = 0; i < 3; i++ ) {
+		float halfSize = bounds[1][i] - localOrigin[i];
+
+		boxes.center[i][index] = worldOrigin[i];
+		boxes.axis[i][0][index] = modelMatrix[i * 4 + 0] * halfSize;
+		boxes.axis[i][1][index] = modelMatrix[i * 4 + 1] * halfSize;
+		boxes.axis[i][2][index] = modelMatrix[i * 4 + 2] * halfSize;
+	}
+}
+
+/*
+=================
+R_CullBoxes
+
+Culls all the boxes against the given global frustum at once.
+Returns a bit for every box that is not outside the frustum, (positive sides are out)
+
+This is the same test as R_CornerCullLocalBox, which also covers the radius test
+of R_CullLocalBox, because a box outside the radius is outside with all corners.
+=================
+*/
+dword *R_CullBoxes( const cullBoxes_t &boxes, int numBoxes, int numPlanes, const idPlane *planes ) {
+	int numWords = ( numBoxes + 31 ) >> 5;
+	dword *visibleBits = (dword *)R_FrameAlloc( numWords * sizeof( dword ) );
+
+	if ( r_useCulling.GetInteger() == 0 ) {
+		memset( visibleBits, 0xFF, numWords * sizeof( dword ) );
+		return visibleBits;
+	}
+
+	if ( r_useCulling.GetInteger() == 1 ) {
+		// the radius test alone is only used for experimental timing purposes
+		memset( visibleBits, 0, numWords * sizeof( dword ) );
+		for ( int i = 0; i < numBoxes; i++ ) {
+			idVec3 center( boxes.center[0][i], boxes.center[1][i], boxes.center[2][i] );
+			float radiusSqr = 0.0f;
+			for ( int j = 0; j < 3; j++ ) {
+				radiusSqr += boxes.axis[j][0][i] * boxes.axis[j][0][i] + boxes.axis[j][1][i] * boxes.axis[j][1][i] + boxes.axis[j][2][i] * boxes.axis[j][2][i];
+			}
+			float radius = idMath::Sqrt( radiusSqr );
+			int j;
+			for ( j = 0; j < numPlanes; j++ ) {
+				if ( planes[j].Distance( center ) > radius ) {
+					break;
+				}
+			}
+			if ( j == numPlanes ) {
+				visibleBits[i >> 5] |= 1 << ( i & 31 );
+			}
+		}
+		return visibleBits;
+	}
+
+	SIMDProcessor->CullBoxes( visibleBits, planes, numPlanes, boxes, numBoxes );
+
+	int numVisible = 0;
+	for ( int i = 0; i < numWords; i++ ) {
+		for ( dword bits = visibleBits[i]; bits; bits &= bits - 1 ) {
+			numVisible++;
+		}
+	}
+	tr.pc.c_box_cull_in += numVisible;
+	tr.pc.c_box_cull_out += numBoxes - numVisible;
+
+	return visibleBits;
+}
+
+/*
+=================
+R_CullBenchmark_f
+
+Culls the entity reference bounds of the current map against all
+light frustums, one at a time and batched
+=================
+*/
+void R_CullBenchmark_f( const idCmdArgs &args ) {
+	idRenderWorldLocal *world = tr.primaryWorld;
+
+	if ( !world ) {
+		common->Printf( "No world loaded.\n" );
+		return;
+	}
+
+	int numRepeats = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 10;
+
+	idList<idRenderEntityLocal *> entities;
+	for ( int i = 0; i < world->entityDefs.Num(); i++ ) {
+		if ( world->entityDefs[i] ) {
+			entities.Append( world->entityDefs[i] );
+		}
+	}
+	idList<idRenderLightLocal *> lights;
+	for ( int i = 0; i < world->lightDefs.Num(); i++ ) {
+		if ( world->lightDefs[i] ) {
+			lights.Append( world->lightDefs[i] );
+		}
+	}
+	if ( entities.Num() == 0 || lights.Num() == 0 ) {
+		common->Printf( "No entities or lights to cull.\n" );
+		return;
+	}
+
+	// the batched boxes are built once, like they would be built once per area
+	cullBoxes_t boxes;
+	float *boxData = (float *)Mem_Alloc16( 12 * entities.Num() * sizeof( float ) );
+	for ( int i = 0; i < 3; i++ ) {
+		boxes.center[i] = boxData + i * entities.Num();
+		for ( int j = 0; j < 3; j++ ) {
+			boxes.axis[i][j] = boxData + ( 3 + i * 3 + j ) * entities.Num();
+		}
+	}
+	for ( int i = 0; i < entities.Num(); i++ ) {
+		R_SetCullBox( boxes, i, entities[i]->referenceBounds, entities[i]->modelMatrix );
+	}
+	dword *visibleBits = (dword *)Mem_Alloc( ( ( entities.Num() + 31 ) >> 5 ) * sizeof( dword ) );
+
+	int numSingleVisible = 0;
+	int numBatchVisible = 0;
+	int numMismatches = 0;
+
+	double start = Sys_Microseconds();
+	for ( int r = 0; r < numRepeats; r++ ) {
+		for ( int l = 0; l < lights.Num(); l++ ) {
+			for ( int i = 0; i < entities.Num(); i++ ) {
+				if ( !R_CullLocalBox( entities[i]->referenceBounds, entities[i]->modelMatrix, 6, lights[l]->frustum ) ) {
+					numSingleVisible++;
+				}
+			}
+		}
+	}
+	double singleTime = Sys_Microseconds() - start;
+
+	start = Sys_Microseconds();
+	for ( int r = 0; r < numRepeats; r++ ) {
+		for ( int l = 0; l < lights.Num(); l++ ) {
+			SIMDProcessor->CullBoxes( visibleBits, lights[l]->frustum, 6, boxes, entities.Num() );
+			for ( int i = 0; i < entities.Num(); i++ ) {
+				if ( R_CullBoxVisible( visibleBits, i ) ) {
+					numBatchVisible++;
+				}
+			}
+		}
+	}
+	double batchTime = Sys_Microseconds() - start;
+
+	// the float rounding differs from the corner transforms, so a box
+	// that exactly touches a plane may come out differently
+	for ( int l = 0; l < lights.Num(); l++ ) {
+		SIMDProcessor->CullBoxes( visibleBits, lights[l]->frustum, 6, boxes, entities.Num() );
+		for ( int i = 0; i < entities.Num(); i++ ) {
+			bool visible = !R_CullLocalBox( entities[i]->referenceBounds, entities[i]->modelMatrix, 6, lights[l]->frustum );
+			if ( visible != R_CullBoxVisible( visibleBits, i ) ) {
+				numMismatches++;
+			}
+		}
+	}
+
+	Mem_Free16( boxData );
+	Mem_Free( visibleBits );
+
+	int numTests = numRepeats * lights.Num() * entities.Num();
+	common->Printf( "%i entities against %i light frustums, %i times (%s)\n", entities.Num(), lights.Num(), numRepeats, SIMDProcessor->GetName() );
+	common->Printf( "R_CullLocalBox: %8.2f msec, %6.1f nsec per box, %i visible\n", singleTime * 0.001, singleTime * 1000.0 / numTests, numSingleVisible );
+	common->Printf( "CullBoxes:      %8.2f msec, %6.1f nsec per box, %i visible\n", batchTime * 0.001, batchTime * 1000.0 / numTests, numBatchVisible );
+	common->Printf( "%i mismatches\n", numMismatches );
+}
+
 /*
 ==========================
 R_TransformModelToClip
@@ -1095,6 +1404,8 @@ Parms will typically be allocated with R_FrameAlloc
 void R_RenderView( viewDef_t *parms ) {
 	viewDef_t		*oldView;
 
+	PROF_SCOPE( "R_RenderView" );
+
 	if ( parms->renderView.width <= 0 || parms->renderView.height <= 0 ) {
 		return;
 	}
@@ -1129,11 +1440,15 @@ void R_RenderView( viewDef_t *parms ) {
 	// make sure that interactions exist for all light / entity combinations
 	// that are visible
 	// add any pre-generated light shadows, and calculate the light shader values
+	double start = Sys_Microseconds();
 	R_AddLightSurfaces();
+	double lightsEnd = Sys_Microseconds();
 
 	// adds ambient surfaces and create any necessary interaction surfaces to add to the light
 	// lists
 	R_AddModelSurfaces();
+	tr.pc.addModelsUsec += (int)( Sys_Microseconds() - lightsEnd );
+	tr.pc.addLightsUsec += (int)( lightsEnd - start );
 
 	// any viewLight that didn't have visible surfaces can have it's shadows removed
 	R_RemoveUnecessaryViewLights();
@@ -0,0 +1,353 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+
+#include "renderer/tr_local.h"
+
+/*
+
+  The null back end runs the complete front end without a window or an OpenGL
+  context, so timedemos can measure it on machines without a GPU.
+
+  Every qgl function is replaced by one that does nothing, which keeps image
+  and vertex cache creation working unchanged, and the back end commands are
+  only walked to count what the ARB2 back end would draw.
+
+*/
+
+// the core functions do nothing and return zero
+#define QGLPROC(name, rettype, args) static rettype APIENTRY null_##name args { return (rettype)0; }
+#include "renderer/qgl_proc.h"
+#undef QGLPROC
+
+static const char *NULL_GL_VERSION = "2.0 null";
+
+static GLuint nullTextureNum;
+
+static const GLubyte * APIENTRY R_NullGetString( GLenum name ) {
+	switch ( name ) {
+	case GL_VENDOR:
+	case GL_RENDERER:
+		return (const GLubyte *)"null";
+	case GL_VERSION:
+		return (const GLubyte *)NULL_GL_VERSION;
+	}
+	return (const GLubyte *)"";
+}
+
+static void APIENTRY R_NullGetIntegerv( GLenum pname, GLint *params ) {
+	switch ( pname ) {
+	case GL_MAX_TEXTURE_SIZE:
+		*params = 4096;
+		break;
+	default:
+		*params = 0;
+		break;
+	}
+}
+
+static void APIENTRY R_NullGetFloatv( GLenum pname, GLfloat *params ) {
+	*params = 0.0f;
+}
+
+// images must get a texture number to count as loaded
+static void APIENTRY R_NullGenTextures( GLsizei n, GLuint *textures ) {
+	for ( int i = 0; i < n; i++ ) {
+		textures[i] = ++nullTextureNum;
+	}
+}
+
+/*
+==================
+R_InitNullBackend
+
+Installs the qgl functions that do nothing and sets up glConfig like
+a card that supports the ARB2 path, so the front end behaves the same
+as with a real context.
+==================
+*/
+void R_InitNullBackend( void ) {
+	common->Printf( "Using the null back end, nothing will be drawn\n" );
+
+#define QGLPROC(name, rettype, args) q##name = null_##name;
+#include "renderer/qgl_proc.h"
+#undef QGLPROC
+
+	qglGetString = R_NullGetString;
+	qglGetIntegerv = R_NullGetIntegerv;
+	qglGetFloatv = R_NullGetFloatv;
+	qglGenTextures = R_NullGenTextures;
+
+	glConfig.glVersion = atof( NULL_GL_VERSION );
+	glConfig.multitextureAvailable = true;
+	glConfig.maxTextureUnits = MAX_MULTITEXTURE_UNITS;
+	glConfig.maxTextureCoords = MAX_MULTITEXTURE_UNITS;
+	glConfig.maxTextureImageUnits = MAX_MULTITEXTURE_UNITS;
+	glConfig.textureEnvCombineAvailable = true;
+	glConfig.cubeMapAvailable = true;
+	glConfig.envDot3Available = true;
+	glConfig.textureEnvAddAvailable = true;
+	glConfig.textureNonPowerOfTwoAvailable = true;
+	glConfig.textureLODBiasAvailable = true;
+	glConfig.maxTextureAnisotropy = 1;
+	glConfig.ARBVertexProgramAvailable = true;
+	glConfig.ARBFragmentProgramAvailable = true;
+
+	// the extension functions stay NULL, so nothing may use them
+	glConfig.textureCompressionAvailable = false;
+	glConfig.anisotropicAvailable = false;
+	glConfig.sharedTexturePaletteAvailable = false;
+	glConfig.texture3DAvailable = false;
+	glConfig.twoSidedStencilAvailable = false;
+	glConfig.ARBVertexBufferObjectAvailable = false;
+	glConfig.depthBoundsTestAvailable = false;
+}
+
+/*
+==========================================================================================
+
+STATISTICS
+
+==========================================================================================
+*/
+
+typedef struct {
+	int		frames;
+	int		views;
+	int		draws;
+	int		indexes;
+	int		verts;
+	int		shadowDraws;
+	int		shadowIndexes;
+	int		stateChanges;
+	int		copyRenders;
+	int		msec;
+} nullBackEndTotals_t;
+
+static nullBackEndTotals_t	nullTotals;
+static const idMaterial *	nullLastMaterial;
+
+/*
+==================
+RB_NullCountDraw
+==================
+*/
+static void RB_NullCountDraw( const drawSurf_t *surf, const idMaterial *material ) {
+	const srfTriangles_t *tri = surf->geo;
+
+	if ( material != nullLastMaterial ) {
+		nullLastMaterial = material;
+		backEnd.pc.c_stateChanges++;
+	}
+
+	backEnd.pc.c_drawElements++;
+	backEnd.pc.c_drawIndexes += tri->numIndexes;
+	backEnd.pc.c_drawVertexes += tri->numVerts;
+}
+
+/*
+==================
+RB_NullCountInteractions
+
+One draw per surface and light stage, the ARB2 path combines the bump,
+diffuse and specular images of a surface in a single pass.
+==================
+*/
+static void RB_NullCountInteractions( const viewLight_t *vLight, const drawSurf_t *surfs ) {
+	for ( const drawSurf_t *surf = surfs; surf; surf = surf->nextOnLight ) {
+		if ( !surf->geo || !surf->geo->numIndexes ) {
+			continue;
+		}
+		for ( int i = 0; i < vLight->lightShader->GetNumStages(); i++ ) {
+			const shaderStage_t *stage = vLight->lightShader->GetStage( i );
+			if ( !vLight->shaderRegisters[ stage->conditionRegister ] ) {
+				continue;
+			}
+			RB_NullCountDraw( surf, surf->material );
+		}
+	}
+}
+
+/*
+==================
+RB_NullCountShadows
+==================
+*/
+static void RB_NullCountShadows( const drawSurf_t *surfs ) {
+	for ( const drawSurf_t *surf = surfs; surf; surf = surf->nextOnLight ) {
+		if ( !surf->geo || !surf->geo->numIndexes ) {
+			continue;
+		}
+		backEnd.pc.c_shadowElements++;
+		backEnd.pc.c_shadowIndexes += surf->geo->numIndexes;
+		backEnd.pc.c_shadowVertexes += surf->geo->numVerts;
+	}
+}
+
+/*
+==================
+RB_NullDrawView
+
+Counts the depth fill, the light interactions, the shadows and the
+shader passes of a view in the order the ARB2 back end draws them.
+==================
+*/
+static void RB_NullDrawView( const void *data ) {
+	const drawSurfsCommand_t *cmd = (const drawSurfsCommand_t *)data;
+	const viewDef_t *viewDef = cmd->viewDef;
+	int i, j;
+
+	backEnd.viewDef = viewDef;
+	backEnd.pc.c_surfaces += viewDef->numDrawSurfs;
+	nullTotals.views++;
+
+	// the depth buffer is filled by the opaque and perforated surfaces
+	for ( i = 0; i < viewDef->numDrawSurfs; i++ ) {
+		const drawSurf_t *surf = viewDef->drawSurfs[i];
+		if ( !surf->geo || !surf->geo->numIndexes || !surf->material->IsDrawn() ) {
+			continue;
+		}
+		if ( surf->material->Coverage() == MC_TRANSLUCENT || surf->material->GetSort() >= SS_POST_PROCESS ) {
+			continue;
+		}
+		RB_NullCountDraw( surf, surf->material );
+	}
+
+	if ( viewDef->viewEntitys ) {
+		for ( const viewLight_t *vLight = viewDef->viewLights; vLight; vLight = vLight->next ) {
+			if ( vLight->lightShader->IsFogLight() || vLight->lightShader->IsBlendLight() ) {
+				continue;
+			}
+			backEnd.pc.c_stateChanges++;
+			RB_NullCountShadows( vLight->globalShadows );
+			RB_NullCountInteractions( vLight, vLight->localInteractions );
+			RB_NullCountShadows( vLight->localShadows );
+			RB_NullCountInteractions( vLight, vLight->globalInteractions );
+			RB_NullCountInteractions( vLight, vLight->translucentInteractions );
+		}
+	}
+
+	// the shader passes of everything that has non-lighting stages
+	for ( i = 0; i < viewDef->numDrawSurfs; i++ ) {
+		const drawSurf_t *surf = viewDef->drawSurfs[i];
+		const idMaterial *material = surf->material;
+		if ( !surf->geo || !surf->geo->numIndexes || !material->HasAmbient() ) {
+			continue;
+		}
+		for ( j = 0; j < material->GetNumStages(); j++ ) {
+			const shaderStage_t *stage = material->GetStage( j );
+			if ( !surf->shaderRegisters[ stage->conditionRegister ] ) {
+				continue;
+			}
+			if ( stage->lighting != SL_AMBIENT ) {
+				continue;
+			}
+			RB_NullCountDraw( surf, material );
+		}
+	}
+}
+
+/*
+==================
+RB_NullExecuteBackEndCommands
+
+Walks the command list like RB_ExecuteBackEndCommands, but only records statistics
+==================
+*/
+void RB_NullExecuteBackEndCommands( const emptyCommand_t *cmds ) {
+	if ( cmds->commandId == RC_NOP && !cmds->next ) {
+		return;
+	}
+
+	int startTime = Sys_Milliseconds();
+	double startUsec = Sys_Microseconds();
+
+	// images that finished loading still have to be "uploaded"
+	globalImages->CompleteBackgroundImageLoads();
+
+	nullLastMaterial = NULL;
+
+	for ( ; cmds ; cmds = (const emptyCommand_t *)cmds->next ) {
+		switch ( cmds->commandId ) {
+		case RC_NOP:
+			break;
+		case RC_DRAW_VIEW:
+			RB_NullDrawView( cmds );
+			break;
+		case RC_SET_BUFFER:
+			break;
+		case RC_SWAP_BUFFERS:
+			nullTotals.frames++;
+			break;
+		case RC_COPY_RENDER:
+			nullTotals.copyRenders++;
+			break;
+		default:
+			common->Error( "RB_NullExecuteBackEndCommands: bad commandId" );
+			break;
+		}
+	}
+
+	backEnd.viewDef = NULL;
+	backEnd.pc.msec = Sys_Milliseconds() - startTime;
+	backEnd.pc.usec = (int)( Sys_Microseconds() - startUsec );
+
+	nullTotals.draws += backEnd.pc.c_drawElements;
+	nullTotals.indexes += backEnd.pc.c_drawIndexes;
+	nullTotals.verts += backEnd.pc.c_drawVertexes;
+	nullTotals.shadowDraws += backEnd.pc.c_shadowElements;
+	nullTotals.shadowIndexes += backEnd.pc.c_shadowIndexes;
+	nullTotals.stateChanges += backEnd.pc.c_stateChanges;
+	nullTotals.msec += backEnd.pc.msec;
+}
+
+/*
+==================
+R_NullBackendStats_f
+
+Prints what the null back end counted since the last reset as a single
+line of key=value pairs, so scripts can compare runs.
+==================
+*/
+void R_NullBackendStats_f( const idCmdArgs &args ) {
+	if ( args.Argc() > 1 && !idStr::Icmp( args.Argv( 1 ), "reset" ) ) {
+		memset( &nullTotals, 0, sizeof( nullTotals ) );
+		return;
+	}
+
+	if ( !tr.nullBackend ) {
+		common->Printf( "nullBackendStats: r_nullBackend isn't enabled\n" );
+		return;
+	}
+
+	common->Printf( "nullBackend frames=%i views=%i draws=%i tris=%i verts=%i shadowDraws=%i shadowTris=%i stateChanges=%i copyRenders=%i msec=%i\n",
+		nullTotals.frames, nullTotals.views, nullTotals.draws, nullTotals.indexes / 3, nullTotals.verts,
+		nullTotals.shadowDraws, nullTotals.shadowIndexes / 3, nullTotals.stateChanges, nullTotals.copyRenders,
+		nullTotals.msec );
+}
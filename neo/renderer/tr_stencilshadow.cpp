@@ -125,27 +125,39 @@ If a high order bit is clear, the point is outside the plane (definately negativ
 //#define	LIGHT_CLIP_EPSILON	0.001f
 #define	LIGHT_CLIP_EPSILON		0.1f
 
+// the shadow volume state is kept per thread, so the shadow volumes
+// of a view can be created on the job threads
 #define	MAX_CLIP_SIL_EDGES		2048
-static int	numClipSilEdges;
-static int	clipSilEdges[MAX_CLIP_SIL_EDGES][2];
+static ID_THREAD_LOCAL int	numClipSilEdges;
+static ID_THREAD_LOCAL int	(*clipSilEdges)[2];
 
 // facing will be 0 if forward facing, 1 if backwards facing
 // grabbed with alloca
-static byte	*globalFacing;
+static ID_THREAD_LOCAL byte	*globalFacing;
 
 // faceCastsShadow will be 1 if the face is in the projection
 // and facing the apropriate direction
-static byte	*faceCastsShadow;
+static ID_THREAD_LOCAL byte	*faceCastsShadow;
 
-static int	*remap;
+static ID_THREAD_LOCAL int	*remap;
 
 #define	MAX_SHADOW_INDEXES		0x18000
 #define	MAX_SHADOW_VERTS		0x18000
-static int	numShadowIndexes;
-static glIndex_t	shadowIndexes[MAX_SHADOW_INDEXES];
-static int	numShadowVerts;
-static idVec4	shadowVerts[MAX_SHADOW_VERTS];
-static bool overflowed;
+static ID_THREAD_LOCAL int	numShadowIndexes;
+static ID_THREAD_LOCAL glIndex_t	*shadowIndexes;
+static ID_THREAD_LOCAL int	numShadowVerts;
+static ID_THREAD_LOCAL idVec4	*shadowVerts;
+static ID_THREAD_LOCAL bool overflowed;
+
+// the big buffers are allocated on first use for each thread that builds
+// shadow volumes, indexed the same way as the frame memory arenas
+typedef struct {
+	glIndex_t *	indexes;
+	idVec4 *	verts;
+	int			(*clipSilEdges)[2];
+} shadowScratch_t;
+
+static shadowScratch_t	shadowScratch[MAX_FRAME_ARENAS];
 
 idPlane	pointLightFrustums[6][6] = {
 	{
@@ -200,9 +212,7 @@ idPlane	pointLightFrustums[6][6] = {
 	},
 };
 
-int	c_caps, c_sils;
-
-static bool	callOptimizer;			// call the preprocessor optimizer after clipping occluders
+static ID_THREAD_LOCAL bool	callOptimizer;			// call the preprocessor optimizer after clipping occluders
 
 typedef struct {
 	int		frontCapStart;
@@ -210,8 +220,46 @@ typedef struct {
 	int		silStart;
 	int		end;
 } indexRef_t;
-static indexRef_t	indexRef[6];
-static int indexFrustumNumber;		// which shadow generating side of a light the indexRef is for
+static ID_THREAD_LOCAL indexRef_t	indexRef[6];
+static ID_THREAD_LOCAL int indexFrustumNumber;		// which shadow generating side of a light the indexRef is for
+
+/*
+===============
+R_SetupShadowScratch
+
+Points the shadow volume buffers at the scratch memory of this thread
+===============
+*/
+static void R_SetupShadowScratch( void ) {
+	shadowScratch_t *scratch = &shadowScratch[ parallelJobManager->GetWorkerIndex() + 1 ];
+
+	if ( scratch->verts == NULL ) {
+		scratch->indexes = (glIndex_t *)Mem_Alloc16( MAX_SHADOW_INDEXES * sizeof( scratch->indexes[0] ) );
+		scratch->verts = (idVec4 *)Mem_Alloc16( MAX_SHADOW_VERTS * sizeof( scratch->verts[0] ) );
+		scratch->clipSilEdges = (int (*)[2])Mem_Alloc16( MAX_CLIP_SIL_EDGES * sizeof( scratch->clipSilEdges[0] ) );
+	}
+	shadowIndexes = scratch->indexes;
+	shadowVerts = scratch->verts;
+	clipSilEdges = scratch->clipSilEdges;
+}
+
+/*
+===============
+R_FreeShadowScratch
+===============
+*/
+void R_FreeShadowScratch( void ) {
+	for ( int i = 0; i < MAX_FRAME_ARENAS; i++ ) {
+		shadowScratch_t *scratch = &shadowScratch[i];
+		if ( scratch->verts == NULL ) {
+			continue;
+		}
+		Mem_Free16( scratch->indexes );
+		Mem_Free16( scratch->verts );
+		Mem_Free16( scratch->clipSilEdges );
+		memset( scratch, 0, sizeof( *scratch ) );
+	}
+}
 
 /*
 ===============
@@ -993,9 +1041,7 @@ static void R_CreateShadowVolumeInFrustum( const idRenderEntityLocal *ent,
 	}
 	numShadowIndexes += numCapIndexes;
 
-c_caps += numCapIndexes * 2;
-
-int preSilIndexes = numShadowIndexes;
+	int preSilIndexes = numShadowIndexes;
 
 	// if any triangles were clipped, we will have a list of edges
 	// on the frustum which must now become sil edges
@@ -1007,8 +1053,6 @@ int preSilIndexes = numShadowIndexes;
 	// non-shadowing triangle will cast a silhouette edge
 	R_AddSilEdges( tri, pointCull, frustum );
 
-c_sils += numShadowIndexes - preSilIndexes;
-
 	// project all of the vertexes to the shadow plane, generating
 	// an equal number of back vertexes
 	R_ProjectPointsToFarPlane( ent, light, farPlane, firstShadowVert, numShadowVerts );
@@ -1237,7 +1281,7 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 		common->Error( "R_CreateShadowVolume: tri->numVerts = %i", tri->numVerts );
 	}
 
-	tr.pc.c_createShadowVolumes++;
+	R_ThreadPerformanceCounters().c_createShadowVolumes++;
 
 	// use the fast infinite projection in dynamic situations, which
 	// trades somewhat more overdraw and no cap optimizations for
@@ -1263,6 +1307,7 @@ srfTriangles_t *R_CreateShadowVolume( const idRenderEntityLocal *ent,
 	}
 
 	// clear the shadow volume
+	R_SetupShadowScratch();
 	numShadowIndexes = 0;
 	numShadowVerts = 0;
 	overflowed = false;
@@ -124,6 +124,8 @@ static silEdge_t *	silEdges;
 static idHashIndex	silEdgeHash( SILEDGE_HASH_SIZE, MAX_SIL_EDGES );
 static int			numPlanes;
 
+// the allocators are also used by front end jobs, so they are
+// only accessed inside CRITICAL_SECTION_RENDERER
 static idBlockAlloc<srfTriangles_t, 1<<8>				srfTrianglesAllocator;
 
 #ifdef USE_TRI_DATA_ALLOCATOR
@@ -136,6 +138,7 @@ static idDynamicBlockAlloc<silEdge_t, 1<<17, 1<<10>		triSilEdgeAllocator;
 static idDynamicBlockAlloc<dominantTri_t, 1<<16, 1<<10>	triDominantTrisAllocator;
 static idDynamicBlockAlloc<int, 1<<16, 1<<10>			triMirroredVertAllocator;
 static idDynamicBlockAlloc<int, 1<<16, 1<<10>			triDupVertAllocator;
+static idDynamicBlockAlloc<float, 1<<18, 1<<10>			triVertexStreamAllocator;
 #else
 static idDynamicAlloc<idDrawVert, 1<<20, 1<<10>			triVertexAllocator;
 static idDynamicAlloc<glIndex_t, 1<<18, 1<<10>			triIndexAllocator;
@@ -146,8 +149,12 @@ static idDynamicAlloc<silEdge_t, 1<<17, 1<<10>			triSilEdgeAllocator;
 static idDynamicAlloc<dominantTri_t, 1<<16, 1<<10>		triDominantTrisAllocator;
 static idDynamicAlloc<int, 1<<16, 1<<10>				triMirroredVertAllocator;
 static idDynamicAlloc<int, 1<<16, 1<<10>				triDupVertAllocator;
+static idDynamicAlloc<float, 1<<18, 1<<10>				triVertexStreamAllocator;
 #endif
 
+// floats per vertex in the vertex streams: xyz, st, normal and two tangents
+const int VERTEX_STREAM_FLOATS		= 3 + 2 + 3 + 3 + 3;
+
 
 /*
 ===============
@@ -167,6 +174,7 @@ void R_InitTriSurfData( void ) {
 	triDominantTrisAllocator.Init();
 	triMirroredVertAllocator.Init();
 	triDupVertAllocator.Init();
+	triVertexStreamAllocator.Init();
 
 	// never swap out triangle surfaces
 	triVertexAllocator.SetLockMemory( true );
@@ -178,6 +186,7 @@ void R_InitTriSurfData( void ) {
 	triDominantTrisAllocator.SetLockMemory( true );
 	triMirroredVertAllocator.SetLockMemory( true );
 	triDupVertAllocator.SetLockMemory( true );
+	triVertexStreamAllocator.SetLockMemory( true );
 }
 
 /*
@@ -198,6 +207,7 @@ void R_ShutdownTriSurfData( void ) {
 	triDominantTrisAllocator.Shutdown();
 	triMirroredVertAllocator.Shutdown();
 	triDupVertAllocator.Shutdown();
+	triVertexStreamAllocator.Shutdown();
 }
 
 /*
@@ -219,6 +229,7 @@ void R_PurgeTriSurfData( frameData_t *frame ) {
 	triDominantTrisAllocator.FreeEmptyBaseBlocks();
 	triMirroredVertAllocator.FreeEmptyBaseBlocks();
 	triDupVertAllocator.FreeEmptyBaseBlocks();
+	triVertexStreamAllocator.FreeEmptyBaseBlocks();
 }
 
 /*
@@ -267,6 +278,10 @@ void R_ShowTriSurfMemory_f( const idCmdArgs &args ) {
 		triDupVertAllocator.GetBaseBlockMemory() >> 10, triDupVertAllocator.GetFreeBlockMemory() >> 10,
 			triDupVertAllocator.GetNumFreeBlocks(), triDupVertAllocator.GetNumEmptyBaseBlocks() );
 
+	common->Printf( "%6d kB vertex stream memory (%d kB free in %d blocks, %d empty base blocks)\n",
+		triVertexStreamAllocator.GetBaseBlockMemory() >> 10, triVertexStreamAllocator.GetFreeBlockMemory() >> 10,
+			triVertexStreamAllocator.GetNumFreeBlocks(), triVertexStreamAllocator.GetNumEmptyBaseBlocks() );
+
 	common->Printf( "%6zu kB total triangle memory\n",
 		( srfTrianglesAllocator.GetAllocCount() * sizeof( srfTriangles_t ) +
 			triVertexAllocator.GetBaseBlockMemory() +
@@ -277,7 +292,8 @@ void R_ShowTriSurfMemory_f( const idCmdArgs &args ) {
 			triSilEdgeAllocator.GetBaseBlockMemory() +
 			triDominantTrisAllocator.GetBaseBlockMemory() +
 			triMirroredVertAllocator.GetBaseBlockMemory() +
-			triDupVertAllocator.GetBaseBlockMemory() ) >> 10 );
+			triDupVertAllocator.GetBaseBlockMemory() +
+			triVertexStreamAllocator.GetBaseBlockMemory() ) >> 10 );
 }
 
 /*
@@ -329,6 +345,9 @@ int R_TriSurfMemory( const srfTriangles_t *tri ) {
 	if ( tri->dupVerts != NULL ) {
 		total += tri->numDupVerts * sizeof( tri->dupVerts[0] );
 	}
+	if ( tri->streams.xyz != NULL ) {
+		total += tri->numVerts * VERTEX_STREAM_FLOATS * sizeof( float );
+	}
 
 	total += sizeof( *tri );
 
@@ -341,6 +360,7 @@ R_FreeStaticTriSurfVertexCaches
 ==============
 */
 void R_FreeStaticTriSurfVertexCaches( srfTriangles_t *tri ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 	if ( tri->ambientSurface == NULL ) {
 		// this is a real model surface
 		vertexCache.Free( tri->ambientCache );
@@ -362,6 +382,7 @@ void R_FreeStaticTriSurfVertexCaches( srfTriangles_t *tri ) {
 		vertexCache.Free( tri->shadowCache );
 		tri->shadowCache = NULL;
 	}
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 }
 
 /*
@@ -378,6 +399,8 @@ void R_ReallyFreeStaticTriSurf( srfTriangles_t *tri ) {
 
 	R_FreeStaticTriSurfVertexCaches( tri );
 
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
+
 	if ( tri->verts != NULL ) {
 		// R_CreateLightTris points tri->verts at the verts of the ambient surface
 		if ( tri->ambientSurface == NULL || tri->verts != tri->ambientSurface->verts ) {
@@ -417,11 +440,17 @@ void R_ReallyFreeStaticTriSurf( srfTriangles_t *tri ) {
 		triShadowVertexAllocator.Free( tri->shadowVertexes );
 	}
 
+	if ( tri->streams.xyz != NULL ) {
+		triVertexStreamAllocator.Free( tri->streams.xyz->ToFloatPtr() );
+	}
+
 #ifdef _DEBUG
 	memset( tri, 0, sizeof( srfTriangles_t ) );
 #endif
 
 	srfTrianglesAllocator.Free( tri );
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 }
 
 /*
@@ -506,12 +535,14 @@ void R_FreeStaticTriSurf( srfTriangles_t *tri ) {
 		R_CheckStaticTriSurfMemory( tri );
 #endif
 		tri->nextDeferredFree = NULL;
+		Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 		if ( frame->lastDeferredFreeTriSurf ) {
 			frame->lastDeferredFreeTriSurf->nextDeferredFree = tri;
 		} else {
 			frame->firstDeferredFreeTriSurf = tri;
 		}
 		frame->lastDeferredFreeTriSurf = tri;
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 	}
 }
 
@@ -521,7 +552,9 @@ R_AllocStaticTriSurf
 ==============
 */
 srfTriangles_t *R_AllocStaticTriSurf( void ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 	srfTriangles_t *tris = srfTrianglesAllocator.Alloc();
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 	memset( tris, 0, sizeof( srfTriangles_t ) );
 	return tris;
 }
@@ -554,7 +587,44 @@ R_AllocStaticTriSurfVerts
 */
 void R_AllocStaticTriSurfVerts( srfTriangles_t *tri, int numVerts ) {
 	assert( tri->verts == NULL );
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 	tri->verts = triVertexAllocator.Alloc( numVerts );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
+}
+
+/*
+=================
+R_AllocStaticTriSurfStreams
+
+All the streams are in a single block that starts with the positions
+=================
+*/
+void R_AllocStaticTriSurfStreams( srfTriangles_t *tri, int numVerts ) {
+	assert( tri->streams.xyz == NULL );
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
+	float *data = triVertexStreamAllocator.Alloc( numVerts * VERTEX_STREAM_FLOATS );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
+
+	tri->streams.xyz = (idVec3 *)data;
+	tri->streams.st = (idVec2 *)( data + numVerts * 3 );
+	tri->streams.normal = (idVec3 *)( data + numVerts * 5 );
+	tri->streams.tangents[0] = (idVec3 *)( data + numVerts * 8 );
+	tri->streams.tangents[1] = (idVec3 *)( data + numVerts * 11 );
+}
+
+/*
+=================
+R_FreeStaticTriSurfStreams
+=================
+*/
+void R_FreeStaticTriSurfStreams( srfTriangles_t *tri ) {
+	if ( tri->streams.xyz == NULL ) {
+		return;
+	}
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
+	triVertexStreamAllocator.Free( tri->streams.xyz->ToFloatPtr() );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
+	memset( &tri->streams, 0, sizeof( tri->streams ) );
 }
 
 /*
@@ -564,7 +634,9 @@ R_AllocStaticTriSurfIndexes
 */
 void R_AllocStaticTriSurfIndexes( srfTriangles_t *tri, int numIndexes ) {
 	assert( tri->indexes == NULL );
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 	tri->indexes = triIndexAllocator.Alloc( numIndexes );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 }
 
 /*
@@ -574,7 +646,9 @@ R_AllocStaticTriSurfShadowVerts
 */
 void R_AllocStaticTriSurfShadowVerts( srfTriangles_t *tri, int numVerts ) {
 	assert( tri->shadowVertexes == NULL );
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 	tri->shadowVertexes = triShadowVertexAllocator.Alloc( numVerts );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 }
 
 /*
@@ -583,10 +657,12 @@ R_AllocStaticTriSurfPlanes
 =================
 */
 void R_AllocStaticTriSurfPlanes( srfTriangles_t *tri, int numIndexes ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 	if ( tri->facePlanes ) {
 		triPlaneAllocator.Free( tri->facePlanes );
 	}
 	tri->facePlanes = triPlaneAllocator.Alloc( numIndexes / 3 );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 }
 
 /*
@@ -596,7 +672,9 @@ R_ResizeStaticTriSurfVerts
 */
 void R_ResizeStaticTriSurfVerts( srfTriangles_t *tri, int numVerts ) {
 #ifdef USE_TRI_DATA_ALLOCATOR
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 	tri->verts = triVertexAllocator.Resize( tri->verts, numVerts );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 #else
 	assert( false );
 #endif
@@ -609,7 +687,9 @@ R_ResizeStaticTriSurfIndexes
 */
 void R_ResizeStaticTriSurfIndexes( srfTriangles_t *tri, int numIndexes ) {
 #ifdef USE_TRI_DATA_ALLOCATOR
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 	tri->indexes = triIndexAllocator.Resize( tri->indexes, numIndexes );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 #else
 	assert( false );
 #endif
@@ -622,7 +702,9 @@ R_ResizeStaticTriSurfShadowVerts
 */
 void R_ResizeStaticTriSurfShadowVerts( srfTriangles_t *tri, int numVerts ) {
 #ifdef USE_TRI_DATA_ALLOCATOR
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 	tri->shadowVertexes = triShadowVertexAllocator.Resize( tri->shadowVertexes, numVerts );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 #else
 	assert( false );
 #endif
@@ -652,7 +734,9 @@ R_FreeStaticTriSurfSilIndexes
 =================
 */
 void R_FreeStaticTriSurfSilIndexes( srfTriangles_t *tri ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_RENDERER );
 	triSilIndexAllocator.Free( tri->silIndexes );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_RENDERER );
 	tri->silIndexes = NULL;
 }
 
@@ -702,9 +786,46 @@ R_BoundTriSurf
 =================
 */
 void R_BoundTriSurf( srfTriangles_t *tri ) {
+	if ( tri->streams.xyz != NULL ) {
+		SIMDProcessor->MinMax( tri->bounds[0], tri->bounds[1], tri->streams.xyz, tri->numVerts );
+		return;
+	}
 	SIMDProcessor->MinMax( tri->bounds[0], tri->bounds[1], tri->verts, tri->numVerts );
 }
 
+/*
+=================
+R_CopyStreamPositionsToVerts
+
+Deforming surfaces that use the vertex streams only write the
+interleaved verts with these, everything else reads tri->verts
+=================
+*/
+void R_CopyStreamPositionsToVerts( srfTriangles_t *tri ) {
+	const idVec3 *xyz = tri->streams.xyz;
+	idDrawVert *verts = tri->verts;
+
+	for ( int i = 0; i < tri->numVerts; i++ ) {
+		verts[i].xyz = xyz[i];
+	}
+}
+
+/*
+=================
+R_CopyStreamTangentsToVerts
+=================
+*/
+void R_CopyStreamTangentsToVerts( srfTriangles_t *tri ) {
+	const drawVertStreams_t &streams = tri->streams;
+	idDrawVert *verts = tri->verts;
+
+	for ( int i = 0; i < tri->numVerts; i++ ) {
+		verts[i].normal = streams.normal[i];
+		verts[i].tangents[0] = streams.tangents[0][i];
+		verts[i].tangents[1] = streams.tangents[1][i];
+	}
+}
+
 /*
 =================
 R_CreateSilRemap
@@ -1601,7 +1722,12 @@ void R_DeriveUnsmoothedTangents( srfTriangles_t *tri ) {
 
 #if 1
 
-	SIMDProcessor->DeriveUnsmoothedTangents( tri->verts, tri->dominantTris, tri->numVerts );
+	if ( tri->streams.xyz != NULL ) {
+		SIMDProcessor->DeriveUnsmoothedTangentsSoA( tri->streams, tri->dominantTris, tri->numVerts );
+		R_CopyStreamTangentsToVerts( tri );
+	} else {
+		SIMDProcessor->DeriveUnsmoothedTangents( tri->verts, tri->dominantTris, tri->numVerts );
+	}
 
 #else
 
@@ -1654,6 +1780,36 @@ void R_DeriveUnsmoothedTangents( srfTriangles_t *tri ) {
 	tri->tangentsCalculated = true;
 }
 
+/*
+==================
+R_DeriveStreamTangents
+
+R_DeriveTangents on the vertex streams, the interleaved verts
+only get the final normals and tangents
+==================
+*/
+static void R_DeriveStreamTangents( srfTriangles_t *tri, idPlane *planes ) {
+	const drawVertStreams_t &streams = tri->streams;
+
+	SIMDProcessor->DeriveTangentsSoA( planes, streams, tri->numVerts, tri->indexes, tri->numIndexes );
+
+	int *dupVerts = tri->dupVerts;
+
+	// add the normal of a duplicated vertex to the normal of the first vertex with the same XYZ
+	for ( int i = 0; i < tri->numDupVerts; i++ ) {
+		streams.normal[dupVerts[i*2+0]] += streams.normal[dupVerts[i*2+1]];
+	}
+
+	// copy vertex normals to duplicated vertices
+	for ( int i = 0; i < tri->numDupVerts; i++ ) {
+		streams.normal[dupVerts[i*2+1]] = streams.normal[dupVerts[i*2+0]];
+	}
+
+	SIMDProcessor->NormalizeTangentsSoA( streams, tri->numVerts );
+
+	R_CopyStreamTangentsToVerts( tri );
+}
+
 /*
 ==================
 R_DeriveTangents
@@ -1676,7 +1832,7 @@ void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
 		return;
 	}
 
-	tr.pc.c_tangentIndexes += tri->numIndexes;
+	R_ThreadPerformanceCounters().c_tangentIndexes += tri->numIndexes;
 
 	if ( !tri->facePlanes && allocFacePlanes ) {
 		R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
@@ -1689,6 +1845,13 @@ void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
 		planes = (idPlane *)_alloca16( ( tri->numIndexes / 3 ) * sizeof( planes[0] ) );
 	}
 
+	if ( tri->streams.xyz != NULL ) {
+		R_DeriveStreamTangents( tri, planes );
+		tri->tangentsCalculated = true;
+		tri->facePlanesCalculated = true;
+		return;
+	}
+
 	SIMDProcessor->DeriveTangents( planes, tri->verts, tri->numVerts, tri->indexes, tri->numIndexes );
 
 #else
@@ -30,9 +30,6 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "renderer/tr_local.h"
 
-int	c_turboUsedVerts;
-int c_turboUnusedVerts;
-
 /*
 =====================
 R_CreateVertexProgramTurboShadowVolume
@@ -263,9 +260,6 @@ srfTriangles_t *R_CreateTurboShadowVolume( const idRenderEntityLocal *ent,
 
 	newTri->numVerts = SIMDProcessor->CreateShadowCache( &shadowVerts->xyz, vertRemap, localLightOrigin, tri->verts, tri->numVerts );
 
-	c_turboUsedVerts += newTri->numVerts;
-	c_turboUnusedVerts += tri->numVerts * 2 - newTri->numVerts;
-
 #ifdef USE_TRI_DATA_ALLOCATOR
 	R_ResizeStaticTriSurfShadowVerts( newTri, newTri->numVerts );
 #else
@@ -27,6 +27,7 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "idlib/Profiler.h"
 #include "framework/FileSystem.h"
 #include "framework/Session.h"
 #include "renderer/RenderWorld.h"
@@ -498,6 +499,8 @@ void idSoundWorldLocal::MixLoop( int current44kHz, int numSpeakers, float *final
 	int i, j;
 	idSoundEmitterLocal *sound;
 
+	PROF_SCOPE( "idSoundWorldLocal::MixLoop" );
+
 	// if noclip flying outside the world, leave silence
 	if ( listenerArea == -1 ) {
 		alListenerf( AL_GAIN, 0.0f );
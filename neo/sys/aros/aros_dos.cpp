@@ -178,6 +178,31 @@ int Sys_ListFiles( const char *directory, const char *extension, idStrList &list
     return list.Num();
 }
 
+/*
+================
+Sys_MapFile
+
+no memory mapped files, callers fall back to reading the file
+================
+*/
+bool Sys_MapFile( const char *OSPath, sysMappedFile_t &file ) {
+    file.data = NULL;
+    file.length = 0;
+    file.handle = NULL;
+    return false;
+}
+
+/*
+================
+Sys_UnmapFile
+================
+*/
+void Sys_UnmapFile( sysMappedFile_t &file ) {
+    file.data = NULL;
+    file.length = 0;
+    file.handle = NULL;
+}
+
 /*
 ================
 Sys_Mkdir
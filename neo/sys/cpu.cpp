@@ -79,28 +79,50 @@ static inline void CPUid(int index, int *a, int *b, int *c, int *d) {
 		"xchg %%" REG_b ", %%" REG_S
 		:	"=a" (*a), "=S" (*b),
 			"=c" (*c), "=d" (*d)
-		: "0" (index));
+		: "0" (index), "2" (0));
+}
+
+static inline unsigned int XGetBV() {
+	unsigned int a, d;
+
+	__asm__ volatile
+	(	"xgetbv"
+		:	"=a" (a), "=d" (d)
+		: "c" (0));
+
+	return a;
 }
 #elif defined(_MSC_VER)
 #include <intrin.h>
 static inline void CPUid(int index, int *a, int *b, int *c, int *d) {
 	int info[4] = { };
 
-	// VS2005 and up
-	__cpuid(info, index);
+	// VS2008 and up
+	__cpuidex(info, index, 0);
 
 	*a = info[0];
 	*b = info[1];
 	*c = info[2];
 	*d = info[3];
 }
+
+static inline unsigned int XGetBV() {
+	// VS2010 SP1 and up
+	return (unsigned int)_xgetbv(0);
+}
 #else
 #error unsupported compiler
 #endif
 
 #define c_SSE3		(1 << 0)
+#define c_OSXSAVE	(1 << 27)
+#define c_AVX		(1 << 28)
+#define b_AVX2		(1 << 5)
 #define d_FXSAVE	(1 << 24)
 
+#define XCR0_SSE	(1 << 1)
+#define XCR0_AVX	(1 << 2)
+
 static inline bool HasDAZ() {
 	int a, b, c, d;
 
@@ -125,6 +147,36 @@ static inline bool HasSSE3() {
 	return (c & c_SSE3) == c_SSE3;
 }
 
+static inline bool HasAVX() {
+	int a, b, c, d;
+
+	CPUid(0, &a, &b, &c, &d);
+	if (a < 1)
+		return false;
+
+	CPUid(1, &a, &b, &c, &d);
+	if ((c & (c_OSXSAVE | c_AVX)) != (c_OSXSAVE | c_AVX))
+		return false;
+
+	// the OS has to save the upper halves of the ymm registers on context switches
+	return (XGetBV() & (XCR0_SSE | XCR0_AVX)) == (XCR0_SSE | XCR0_AVX);
+}
+
+static inline bool HasAVX2() {
+	int a, b, c, d;
+
+	if (!HasAVX())
+		return false;
+
+	CPUid(0, &a, &b, &c, &d);
+	if (a < 7)
+		return false;
+
+	CPUid(7, &a, &b, &c, &d);
+
+	return (b & b_AVX2) == b_AVX2;
+}
+
 #define MXCSR_DAZ	(1 << 6)
 #define MXCSR_FTZ	(1 << 15)
 
@@ -214,6 +266,12 @@ int Sys_GetProcessorId( void ) {
 	// there is no SDL_HasSSE3() in SDL 1.2
 	if (HasSSE3())
 		flags |= CPUID_SSE3;
+
+	if (HasAVX())
+		flags |= CPUID_AVX;
+
+	if (HasAVX2())
+		flags |= CPUID_AVX2;
 #endif
 
 	if (SDL_HasAltiVec())
@@ -0,0 +1,860 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include <SDL_version.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+#include <SDL_timer.h>
+#include <SDL_cpuinfo.h>
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+#include <SDL_atomic.h>
+#endif
+
+#include "sys/platform.h"
+#include "idlib/containers/List.h"
+#include "idlib/Str.h"
+#include "idlib/Profiler.h"
+#include "framework/Common.h"
+#include "framework/CmdSystem.h"
+#include "framework/CVarSystem.h"
+
+#include "sys/sys_public.h"
+#include "sys/jobs.h"
+
+extern idCVar com_numJobThreads;
+
+const int MAX_QUEUED_JOBS			= 4096;		// per worker, must be a power of two
+
+/*
+===============================================================================
+
+	idJobCounter
+
+	Counter that can be changed from multiple threads at once.
+	SDL1.2 has no atomics so the counter falls back to a critical section.
+
+===============================================================================
+*/
+
+class idJobCounter {
+public:
+					idJobCounter( void ) { Set( 0 ); }
+
+	int				Add( int v );		// returns the new value
+	int				Get( void ) const;
+	void			Set( int v );
+
+private:
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	mutable SDL_atomic_t	value;
+#else
+	volatile int			value;
+#endif
+};
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+
+ID_INLINE int idJobCounter::Add( int v ) {
+	return SDL_AtomicAdd( &value, v ) + v;
+}
+
+ID_INLINE int idJobCounter::Get( void ) const {
+	return SDL_AtomicGet( &value );
+}
+
+ID_INLINE void idJobCounter::Set( int v ) {
+	SDL_AtomicSet( &value, v );
+}
+
+#else
+
+ID_INLINE int idJobCounter::Add( int v ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_SYS );
+	int r = ( value += v );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_SYS );
+	return r;
+}
+
+ID_INLINE int idJobCounter::Get( void ) const {
+	return value;
+}
+
+ID_INLINE void idJobCounter::Set( int v ) {
+	value = v;
+}
+
+#endif
+
+/*
+================
+Job_Microseconds
+================
+*/
+static double Job_Microseconds( void ) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	static double scale = 1000000.0 / SDL_GetPerformanceFrequency();
+	return SDL_GetPerformanceCounter() * scale;
+#else
+	return Sys_Milliseconds() * 1000.0;
+#endif
+}
+
+/*
+===============================================================================
+
+	idParallelJobListLocal
+
+===============================================================================
+*/
+
+typedef struct {
+	jobRun_t					function;
+	void *						data;
+} job_t;
+
+class idParallelJobListLocal : public idParallelJobList {
+public:
+							idParallelJobListLocal( const char *name );
+	virtual					~idParallelJobListLocal( void );
+
+	virtual void			AddJob( jobRun_t function, void *data );
+	virtual void			Clear( void );
+	virtual void			Submit( idParallelJobList *waitFor = NULL );
+	virtual void			Wait( void );
+	virtual bool			IsSubmitted( void ) const { return submitted; }
+	virtual bool			IsDone( void ) const { return submitted && done.Get() != 0; }
+	virtual int				NumJobs( void ) const { return jobs.Num(); }
+	virtual const char *	GetName( void ) const { return name.c_str(); }
+
+	void					Start( void );
+
+	idStr					name;
+	idList<job_t>			jobs;
+	bool					submitted;
+	idJobCounter			pendingJobs;
+	idJobCounter			done;
+
+	// lists submitted with this list as dependency, linked while this list is running
+	idParallelJobListLocal *firstDependent;
+	idParallelJobListLocal *nextDependent;
+
+	// statistics
+	int						numSubmits;
+	double					submitTime;
+	double					lastTime;
+};
+
+typedef struct {
+	idParallelJobListLocal *	list;
+	int							index;
+} queuedJob_t;
+
+/*
+===============================================================================
+
+	idParallelJobManagerLocal
+
+===============================================================================
+*/
+
+typedef struct {
+	SDL_mutex *					lock;
+	queuedJob_t					jobs[MAX_QUEUED_JOBS];
+	int							head;			// jobs are stolen from the head
+	int							tail;			// the owner pushes and pops at the tail
+} jobQueue_t;
+
+typedef struct {
+	int							index;
+	char						name[16];
+	xthreadInfo					thread;
+	jobQueue_t					queue;
+
+	// statistics since the last listJobs
+	int							jobsExecuted;
+	int							jobsStolen;
+	double						busyTime;
+} jobWorker_t;
+
+class idParallelJobManagerLocal : public idParallelJobManager {
+public:
+							idParallelJobManagerLocal( void );
+
+	virtual void			Init( void );
+	virtual void			Shutdown( void );
+
+	virtual void			SetNumThreads( int numThreads );
+	virtual int				GetNumThreads( void ) const { return numWorkers; }
+	virtual int				GetWorkerIndex( void ) const;
+
+	virtual idParallelJobList *	AllocJobList( const char *name );
+	virtual void			FreeJobList( idParallelJobList *jobList );
+
+	void					QueueJobs( idParallelJobListLocal *list );
+	void					JobListDone( idParallelJobListLocal *list );
+	void					WaitForJobList( idParallelJobListLocal *list );
+
+	static void				ListJobs_f( const idCmdArgs &args );
+
+private:
+	friend class idParallelJobListLocal;
+
+	bool					initialized;
+	int						numWorkers;
+	jobWorker_t				workers[MAX_JOB_THREADS];
+	jobQueue_t				sharedQueue;		// used when there are no worker threads
+
+	SDL_mutex *				signalLock;
+	SDL_cond *				signalCond;			// signaled when jobs are queued and when a job list is done
+	idJobCounter			queuedJobs;
+	idJobCounter			nextWorker;
+	idJobCounter			exitThreads;
+
+	idList<idParallelJobListLocal *> jobLists;
+
+	// statistics since the last listJobs
+	idJobCounter			waitingThreadJobs;
+	double					statsStartTime;
+
+	static int				WorkerThread( void *parms );
+
+	void					StartThreads( int num );
+	void					StopThreads( void );
+	bool					PushJob( jobQueue_t &queue, const queuedJob_t &job );
+	bool					PopJob( jobQueue_t &queue, queuedJob_t &job );
+	bool					StealJob( jobQueue_t &queue, queuedJob_t &job );
+	void					RunJob( const queuedJob_t &job, int workerNum, bool stolen );
+	bool					ExecuteJob( int workerNum );
+	void					ResetStats( void );
+	void					PrintStats( void );
+};
+
+static idParallelJobManagerLocal	parallelJobManagerLocal;
+idParallelJobManager *				parallelJobManager = &parallelJobManagerLocal;
+
+static ID_THREAD_LOCAL int			jobWorkerIndex = -1;
+
+/*
+================
+idParallelJobListLocal::idParallelJobListLocal
+================
+*/
+idParallelJobListLocal::idParallelJobListLocal( const char *name ) {
+	this->name = name;
+	submitted = false;
+	firstDependent = NULL;
+	nextDependent = NULL;
+	numSubmits = 0;
+	submitTime = 0.0;
+	lastTime = 0.0;
+}
+
+/*
+================
+idParallelJobListLocal::~idParallelJobListLocal
+================
+*/
+idParallelJobListLocal::~idParallelJobListLocal( void ) {
+	Wait();
+}
+
+/*
+================
+idParallelJobListLocal::AddJob
+================
+*/
+void idParallelJobListLocal::AddJob( jobRun_t function, void *data ) {
+	assert( !submitted );
+	job_t &job = jobs.Alloc();
+	job.function = function;
+	job.data = data;
+}
+
+/*
+================
+idParallelJobListLocal::Clear
+================
+*/
+void idParallelJobListLocal::Clear( void ) {
+	assert( !submitted );
+	jobs.SetNum( 0, false );
+}
+
+/*
+================
+idParallelJobListLocal::Submit
+================
+*/
+void idParallelJobListLocal::Submit( idParallelJobList *waitFor ) {
+	assert( !submitted );
+
+	submitted = true;
+	numSubmits++;
+	submitTime = Job_Microseconds();
+	pendingJobs.Set( jobs.Num() );
+	done.Set( 0 );
+
+	if ( waitFor != NULL && waitFor->IsSubmitted() ) {
+		idParallelJobListLocal *dependency = static_cast<idParallelJobListLocal *>( waitFor );
+		assert( dependency != this );
+
+		// the dependency is done once its done flag is set while holding the signal lock,
+		// so either it picks us up from its dependents or we see it's done already
+		SDL_LockMutex( parallelJobManagerLocal.signalLock );
+		if ( !dependency->done.Get() ) {
+			nextDependent = dependency->firstDependent;
+			dependency->firstDependent = this;
+			SDL_UnlockMutex( parallelJobManagerLocal.signalLock );
+			return;
+		}
+		SDL_UnlockMutex( parallelJobManagerLocal.signalLock );
+	}
+
+	Start();
+}
+
+/*
+================
+idParallelJobListLocal::Start
+================
+*/
+void idParallelJobListLocal::Start( void ) {
+	if ( jobs.Num() == 0 ) {
+		parallelJobManagerLocal.JobListDone( this );
+	} else {
+		parallelJobManagerLocal.QueueJobs( this );
+	}
+}
+
+/*
+================
+idParallelJobListLocal::Wait
+================
+*/
+void idParallelJobListLocal::Wait( void ) {
+	if ( !submitted ) {
+		return;
+	}
+	parallelJobManagerLocal.WaitForJobList( this );
+	submitted = false;
+	jobs.SetNum( 0, false );
+}
+
+/*
+================
+idParallelJobManagerLocal::idParallelJobManagerLocal
+================
+*/
+idParallelJobManagerLocal::idParallelJobManagerLocal( void ) {
+	initialized = false;
+	numWorkers = 0;
+	signalLock = NULL;
+	signalCond = NULL;
+	statsStartTime = 0.0;
+	memset( workers, 0, sizeof( workers ) );
+	memset( &sharedQueue, 0, sizeof( sharedQueue ) );
+}
+
+/*
+================
+idParallelJobManagerLocal::Init
+================
+*/
+void idParallelJobManagerLocal::Init( void ) {
+	signalLock = SDL_CreateMutex();
+	signalCond = SDL_CreateCond();
+	if ( !signalLock || !signalCond ) {
+		common->FatalError( "idParallelJobManager::Init: %s", SDL_GetError() );
+	}
+
+	sharedQueue.lock = SDL_CreateMutex();
+	for ( int i = 0; i < MAX_JOB_THREADS; i++ ) {
+		workers[i].index = i;
+		workers[i].queue.lock = SDL_CreateMutex();
+		idStr::snPrintf( workers[i].name, sizeof( workers[i].name ), "jobWorker%d", i );
+	}
+
+	initialized = true;
+	ResetStats();
+
+	cmdSystem->AddCommand( "listJobs", ListJobs_f, CMD_FL_SYSTEM, "lists the job lists and the utilisation of the job worker threads" );
+
+	SetNumThreads( com_numJobThreads.GetInteger() );
+	com_numJobThreads.ClearModified();
+}
+
+/*
+================
+idParallelJobManagerLocal::Shutdown
+================
+*/
+void idParallelJobManagerLocal::Shutdown( void ) {
+	if ( !initialized ) {
+		return;
+	}
+
+	StopThreads();
+
+	cmdSystem->RemoveCommand( "listJobs" );
+
+	jobLists.DeleteContents( true );
+
+	for ( int i = 0; i < MAX_JOB_THREADS; i++ ) {
+		SDL_DestroyMutex( workers[i].queue.lock );
+		workers[i].queue.lock = NULL;
+	}
+	SDL_DestroyMutex( sharedQueue.lock );
+	sharedQueue.lock = NULL;
+
+	SDL_DestroyCond( signalCond );
+	SDL_DestroyMutex( signalLock );
+	signalCond = NULL;
+	signalLock = NULL;
+
+	initialized = false;
+}
+
+/*
+================
+idParallelJobManagerLocal::SetNumThreads
+================
+*/
+void idParallelJobManagerLocal::SetNumThreads( int numThreads ) {
+	if ( numThreads == 0 ) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		numThreads = SDL_GetCPUCount() - 1;
+#else
+		numThreads = 1;
+#endif
+	}
+	numThreads = idMath::ClampInt( 0, MAX_JOB_THREADS, numThreads );
+
+	if ( numThreads == numWorkers ) {
+		return;
+	}
+
+	StopThreads();
+	StartThreads( numThreads );
+
+	common->Printf( "%d job worker threads\n", numWorkers );
+}
+
+/*
+================
+idParallelJobManagerLocal::StartThreads
+================
+*/
+void idParallelJobManagerLocal::StartThreads( int num ) {
+	assert( numWorkers == 0 );
+
+	exitThreads.Set( 0 );
+	numWorkers = num;
+
+	for ( int i = 0; i < numWorkers; i++ ) {
+		Sys_CreateThread( WorkerThread, &workers[i], workers[i].thread, workers[i].name );
+	}
+
+	ResetStats();
+}
+
+/*
+================
+idParallelJobManagerLocal::StopThreads
+
+  the workers keep executing jobs until all queues are empty
+================
+*/
+void idParallelJobManagerLocal::StopThreads( void ) {
+	if ( numWorkers == 0 ) {
+		return;
+	}
+
+	SDL_LockMutex( signalLock );
+	exitThreads.Set( 1 );
+	SDL_CondBroadcast( signalCond );
+	SDL_UnlockMutex( signalLock );
+
+	for ( int i = 0; i < numWorkers; i++ ) {
+		Sys_DestroyThread( workers[i].thread );
+	}
+	numWorkers = 0;
+
+	assert( queuedJobs.Get() == 0 );
+}
+
+/*
+================
+idParallelJobManagerLocal::AllocJobList
+================
+*/
+idParallelJobList *idParallelJobManagerLocal::AllocJobList( const char *name ) {
+	idParallelJobListLocal *list = new idParallelJobListLocal( name );
+	jobLists.Append( list );
+	return list;
+}
+
+/*
+================
+idParallelJobManagerLocal::FreeJobList
+================
+*/
+void idParallelJobManagerLocal::FreeJobList( idParallelJobList *jobList ) {
+	if ( jobList == NULL ) {
+		return;
+	}
+	idParallelJobListLocal *list = static_cast<idParallelJobListLocal *>( jobList );
+	jobLists.Remove( list );
+	delete list;
+}
+
+/*
+================
+idParallelJobManagerLocal::GetWorkerIndex
+================
+*/
+int idParallelJobManagerLocal::GetWorkerIndex( void ) const {
+	return jobWorkerIndex;
+}
+
+/*
+================
+idParallelJobManagerLocal::PushJob
+
+  queue lock must be held
+================
+*/
+ID_INLINE bool idParallelJobManagerLocal::PushJob( jobQueue_t &queue, const queuedJob_t &job ) {
+	if ( queue.tail - queue.head >= MAX_QUEUED_JOBS ) {
+		return false;
+	}
+	queue.jobs[queue.tail & ( MAX_QUEUED_JOBS - 1 )] = job;
+	queue.tail++;
+	return true;
+}
+
+/*
+================
+idParallelJobManagerLocal::PopJob
+================
+*/
+bool idParallelJobManagerLocal::PopJob( jobQueue_t &queue, queuedJob_t &job ) {
+	bool found = false;
+	SDL_LockMutex( queue.lock );
+	if ( queue.tail > queue.head ) {
+		queue.tail--;
+		job = queue.jobs[queue.tail & ( MAX_QUEUED_JOBS - 1 )];
+		queuedJobs.Add( -1 );
+		found = true;
+	}
+	SDL_UnlockMutex( queue.lock );
+	return found;
+}
+
+/*
+================
+idParallelJobManagerLocal::StealJob
+================
+*/
+bool idParallelJobManagerLocal::StealJob( jobQueue_t &queue, queuedJob_t &job ) {
+	if ( queue.tail == queue.head ) {
+		// don't bother locking an empty queue
+		return false;
+	}
+	bool found = false;
+	SDL_LockMutex( queue.lock );
+	if ( queue.tail > queue.head ) {
+		job = queue.jobs[queue.head & ( MAX_QUEUED_JOBS - 1 )];
+		queue.head++;
+		queuedJobs.Add( -1 );
+		found = true;
+	}
+	SDL_UnlockMutex( queue.lock );
+	return found;
+}
+
+/*
+================
+idParallelJobManagerLocal::QueueJobs
+
+  a worker pushes all jobs on its own queue and leaves it to the other workers
+  to steal them, any other thread spreads the jobs over the workers
+================
+*/
+void idParallelJobManagerLocal::QueueJobs( idParallelJobListLocal *list ) {
+	const int numJobs = list->jobs.Num();
+	int numQueued = 0;
+	int numOverflow = 0;
+	queuedJob_t job;
+
+	job.list = list;
+
+	const int workerNum = GetWorkerIndex();
+	const int numQueues = ( workerNum >= 0 || numWorkers == 0 ) ? 1 : Min( numWorkers, numJobs );
+	const int firstQueue = ( numQueues > 1 ) ? ( nextWorker.Add( 1 ) & 0xffff ) : 0;
+	int overflow[MAX_JOB_THREADS];
+
+	for ( int q = 0; q < numQueues; q++ ) {
+		jobQueue_t *queue;
+		if ( workerNum >= 0 ) {
+			queue = &workers[workerNum].queue;
+		} else if ( numWorkers == 0 ) {
+			queue = &sharedQueue;
+		} else {
+			queue = &workers[( firstQueue + q ) % numWorkers].queue;
+		}
+
+		SDL_LockMutex( queue->lock );
+		const int firstQueued = numQueued;
+		for ( job.index = q; job.index < numJobs; job.index += numQueues ) {
+			if ( !PushJob( *queue, job ) ) {
+				break;
+			}
+			numQueued++;
+		}
+		// count the jobs before they can be taken, so queuedJobs never goes negative
+		if ( numQueued > firstQueued ) {
+			queuedJobs.Add( numQueued - firstQueued );
+		}
+		SDL_UnlockMutex( queue->lock );
+
+		overflow[q] = job.index;
+		numOverflow += ( job.index < numJobs );
+	}
+
+	if ( numQueued ) {
+		SDL_LockMutex( signalLock );
+		SDL_CondBroadcast( signalCond );
+		SDL_UnlockMutex( signalLock );
+	}
+
+	if ( numOverflow ) {
+		// the queues are full, execute the jobs that didn't fit right away
+		for ( int q = 0; q < numQueues; q++ ) {
+			for ( job.index = overflow[q]; job.index < numJobs; job.index += numQueues ) {
+				RunJob( job, workerNum, false );
+			}
+		}
+	}
+}
+
+/*
+================
+idParallelJobManagerLocal::RunJob
+================
+*/
+void idParallelJobManagerLocal::RunJob( const queuedJob_t &job, int workerNum, bool stolen ) {
+	idParallelJobListLocal *list = job.list;
+	const job_t &j = list->jobs[job.index];
+
+	PROF_SCOPE( "RunJob" );
+
+	if ( workerNum >= 0 ) {
+		jobWorker_t &worker = workers[workerNum];
+		double start = Job_Microseconds();
+		j.function( j.data );
+		worker.busyTime += Job_Microseconds() - start;
+		worker.jobsExecuted++;
+		worker.jobsStolen += stolen;
+	} else {
+		j.function( j.data );
+		waitingThreadJobs.Add( 1 );
+	}
+
+	if ( list->pendingJobs.Add( -1 ) == 0 ) {
+		JobListDone( list );
+	}
+}
+
+/*
+================
+idParallelJobManagerLocal::ExecuteJob
+
+  executes a single job from the own queue or steals one from another queue,
+  returns false if there was nothing to do
+================
+*/
+bool idParallelJobManagerLocal::ExecuteJob( int workerNum ) {
+	queuedJob_t job;
+
+	if ( workerNum >= 0 && PopJob( workers[workerNum].queue, job ) ) {
+		RunJob( job, workerNum, false );
+		return true;
+	}
+
+	if ( StealJob( sharedQueue, job ) ) {
+		RunJob( job, workerNum, false );
+		return true;
+	}
+
+	// start stealing at the next worker so the victims are spread out
+	for ( int i = 1; i <= numWorkers; i++ ) {
+		int victim = ( workerNum + i ) % numWorkers;
+		if ( victim == workerNum ) {
+			continue;
+		}
+		if ( StealJob( workers[victim].queue, job ) ) {
+			RunJob( job, workerNum, true );
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+================
+idParallelJobManagerLocal::JobListDone
+
+  the list may be freed by a waiting thread as soon as the done flag is set,
+  so it is not touched anymore after that
+================
+*/
+void idParallelJobManagerLocal::JobListDone( idParallelJobListLocal *list ) {
+	list->lastTime = Job_Microseconds() - list->submitTime;
+
+	SDL_LockMutex( signalLock );
+	idParallelJobListLocal *dependent = list->firstDependent;
+	list->firstDependent = NULL;
+	list->done.Set( 1 );
+	SDL_CondBroadcast( signalCond );
+	SDL_UnlockMutex( signalLock );
+
+	while ( dependent != NULL ) {
+		idParallelJobListLocal *next = dependent->nextDependent;
+		dependent->nextDependent = NULL;
+		dependent->Start();
+		dependent = next;
+	}
+}
+
+/*
+================
+idParallelJobManagerLocal::WaitForJobList
+
+  executes queued jobs until the list is done, this also takes care of
+  dependencies when there are no worker threads
+================
+*/
+void idParallelJobManagerLocal::WaitForJobList( idParallelJobListLocal *list ) {
+	const int workerNum = GetWorkerIndex();
+
+	while ( !list->done.Get() ) {
+		if ( ExecuteJob( workerNum ) ) {
+			continue;
+		}
+		SDL_LockMutex( signalLock );
+		while ( !list->done.Get() && queuedJobs.Get() == 0 ) {
+			SDL_CondWait( signalCond, signalLock );
+		}
+		SDL_UnlockMutex( signalLock );
+	}
+}
+
+/*
+================
+idParallelJobManagerLocal::WorkerThread
+================
+*/
+int idParallelJobManagerLocal::WorkerThread( void *parms ) {
+	idParallelJobManagerLocal &manager = parallelJobManagerLocal;
+	jobWorker_t *worker = (jobWorker_t *)parms;
+
+	jobWorkerIndex = worker->index;
+
+	while ( 1 ) {
+		if ( manager.ExecuteJob( worker->index ) ) {
+			continue;
+		}
+
+		SDL_LockMutex( manager.signalLock );
+		while ( manager.queuedJobs.Get() == 0 && !manager.exitThreads.Get() ) {
+			SDL_CondWait( manager.signalCond, manager.signalLock );
+		}
+		bool exit = ( manager.queuedJobs.Get() == 0 );
+		SDL_UnlockMutex( manager.signalLock );
+
+		if ( exit ) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/*
+================
+idParallelJobManagerLocal::ResetStats
+================
+*/
+void idParallelJobManagerLocal::ResetStats( void ) {
+	for ( int i = 0; i < MAX_JOB_THREADS; i++ ) {
+		workers[i].jobsExecuted = 0;
+		workers[i].jobsStolen = 0;
+		workers[i].busyTime = 0.0;
+	}
+	waitingThreadJobs.Set( 0 );
+	statsStartTime = Job_Microseconds();
+}
+
+/*
+================
+idParallelJobManagerLocal::PrintStats
+================
+*/
+void idParallelJobManagerLocal::PrintStats( void ) {
+	double elapsed = Max( Job_Microseconds() - statsStartTime, 1.0 );
+
+	common->Printf( "%d job worker threads, %1.1f seconds since the last listJobs\n", numWorkers, elapsed * 0.000001 );
+	common->Printf( "worker         jobs  stolen   busy ms   util\n" );
+	common->Printf( "------------ ------ ------- --------- ------\n" );
+	for ( int i = 0; i < numWorkers; i++ ) {
+		const jobWorker_t &worker = workers[i];
+		common->Printf( "%-12s %6d %7d %9.1f %5.1f%%\n", worker.name, worker.jobsExecuted, worker.jobsStolen,
+							worker.busyTime * 0.001, worker.busyTime * 100.0 / elapsed );
+	}
+	common->Printf( "%d jobs executed by waiting threads\n\n", waitingThreadJobs.Get() );
+
+	common->Printf( "job list                 jobs submits   last ms\n" );
+	common->Printf( "------------------------ ---- ------- ---------\n" );
+	for ( int i = 0; i < jobLists.Num(); i++ ) {
+		const idParallelJobListLocal *list = jobLists[i];
+		common->Printf( "%-24s %4d %7d %9.2f\n", list->name.c_str(), list->jobs.Num(), list->numSubmits, list->lastTime * 0.001 );
+	}
+	common->Printf( "%d job lists\n", jobLists.Num() );
+}
+
+/*
+================
+idParallelJobManagerLocal::ListJobs_f
+
+  prints the worker utilisation since the last call
+================
+*/
+void idParallelJobManagerLocal::ListJobs_f( const idCmdArgs &args ) {
+	parallelJobManagerLocal.PrintStats();
+	parallelJobManagerLocal.ResetStats();
+}
@@ -0,0 +1,103 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __SYS_JOBS__
+#define __SYS_JOBS__
+
+/*
+===============================================================================
+
+	Parallel job system
+
+	A job is a function with a single data pointer. Jobs are gathered in job
+	lists which are submitted as a whole and then waited on. Each worker thread
+	owns a deque of queued jobs, it executes jobs from the back of its own deque
+	and steals jobs from the front of the deques of the other workers when it
+	runs out of work. A thread waiting on a job list helps executing jobs until
+	the list is done, so with no worker threads all jobs simply run on the
+	waiting thread.
+
+	A job list can be submitted with a dependency on another job list, none of
+	its jobs will start before all jobs of the other list are done.
+
+	Jobs may submit and wait on job lists of their own. Jobs must not call
+	non thread-safe engine code like the console.
+
+	"com_numJobThreads" sets the number of worker threads, "listJobs" prints
+	the per worker utilisation.
+
+===============================================================================
+*/
+
+const int MAX_JOB_THREADS			= 16;
+
+typedef void ( *jobRun_t )( void * );
+
+class idParallelJobList {
+public:
+	virtual					~idParallelJobList( void ) {}
+
+							// adds a job to the list, the list must not be running
+	virtual void			AddJob( jobRun_t function, void *data ) = 0;
+							// removes all jobs from the list, the list must not be running
+	virtual void			Clear( void ) = 0;
+							// starts executing the jobs, if waitFor != NULL the jobs won't start before all jobs of waitFor are done
+	virtual void			Submit( idParallelJobList *waitFor = NULL ) = 0;
+							// blocks until all jobs are done, the calling thread executes queued jobs while waiting
+							// after Wait() the jobs are cleared so the list can be filled again
+	virtual void			Wait( void ) = 0;
+							// true if the list has been submitted and not waited on yet
+	virtual bool			IsSubmitted( void ) const = 0;
+							// true if all jobs of a submitted list are done
+	virtual bool			IsDone( void ) const = 0;
+
+	virtual int				NumJobs( void ) const = 0;
+	virtual const char *	GetName( void ) const = 0;
+};
+
+class idParallelJobManager {
+public:
+	virtual					~idParallelJobManager( void ) {}
+
+	virtual void			Init( void ) = 0;
+	virtual void			Shutdown( void ) = 0;
+
+							// all job lists must be done when the number of threads is changed
+							// 0 = one worker per additional CPU core, -1 = no worker threads
+	virtual void			SetNumThreads( int numThreads ) = 0;
+	virtual int				GetNumThreads( void ) const = 0;
+							// index of the worker thread the caller runs on, -1 for any other thread
+	virtual int				GetWorkerIndex( void ) const = 0;
+
+	virtual idParallelJobList *	AllocJobList( const char *name ) = 0;
+	virtual void			FreeJobList( idParallelJobList *jobList ) = 0;
+};
+
+extern idParallelJobManager *	parallelJobManager;
+
+#endif /* !__SYS_JOBS__ */
@@ -221,6 +221,13 @@ If you have questions concerning this license or the applicable additional terms
 #define id_attribute(x)
 #endif
 
+// thread local storage, only for plain old data
+#ifdef _MSC_VER
+#define ID_THREAD_LOCAL __declspec(thread)
+#else
+#define ID_THREAD_LOCAL __thread
+#endif
+
 #if !defined(_MSC_VER)
 	// MSVC does not provide this C99 header
 	#include <inttypes.h>
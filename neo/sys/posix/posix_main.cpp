@@ -239,6 +239,54 @@ int Sys_ListFiles( const char *directory, const char *extension, idStrList &list
 	return list.Num();
 }
 
+/*
+================
+Sys_MapFile
+================
+*/
+bool Sys_MapFile( const char *OSPath, sysMappedFile_t &file ) {
+	struct stat st;
+	void *data;
+	int fd;
+
+	file.data = NULL;
+	file.length = 0;
+	file.handle = NULL;
+
+	fd = open( OSPath, O_RDONLY );
+	if ( fd == -1 ) {
+		return false;
+	}
+	if ( fstat( fd, &st ) == -1 || st.st_size <= 0 || st.st_size > 0x7fffffff ) {
+		close( fd );
+		return false;
+	}
+	data = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+	// the mapping stays valid after the descriptor is closed
+	close( fd );
+	if ( data == MAP_FAILED ) {
+		return false;
+	}
+
+	file.data = data;
+	file.length = st.st_size;
+	return true;
+}
+
+/*
+================
+Sys_UnmapFile
+================
+*/
+void Sys_UnmapFile( sysMappedFile_t &file ) {
+	if ( file.data != NULL ) {
+		munmap( (void *)file.data, file.length );
+	}
+	file.data = NULL;
+	file.length = 0;
+	file.handle = NULL;
+}
+
 /*
 ================
 Posix_Cwd
@@ -41,6 +41,8 @@ typedef enum {
 	CPUID_SSE2							= 0x00080,	// Streaming SIMD Extensions 2
 	CPUID_SSE3							= 0x00100,	// Streaming SIMD Extentions 3 aka Prescott's New Instructions
 	CPUID_ALTIVEC						= 0x00200,	// AltiVec
+	CPUID_AVX							= 0x00400,	// Advanced Vector Extensions
+	CPUID_AVX2							= 0x00800,	// Advanced Vector Extensions 2
 } cpuidSimd_t;
 
 typedef enum {
@@ -120,6 +122,8 @@ void			Sys_Sleep( int msec );
 // Sys_Milliseconds should only be used for profiling purposes,
 // any game related timing information should come from event timestamps
 unsigned int	Sys_Milliseconds( void );
+// high resolution time for profiling short intervals, only differences are meaningful
+double			Sys_Microseconds( void );
 
 // returns a selection of the CPUID_* flags
 int				Sys_GetProcessorId( void );
@@ -210,6 +214,16 @@ bool			Sys_GetPath(sysPath_t type, idStr &path);
 // returns -1 if directory was not found (the list is cleared)
 int				Sys_ListFiles( const char *directory, const char *extension, idList<class idStr> &list );
 
+typedef struct {
+	const void *	data;
+	int				length;
+	void *			handle;		// platform specific
+} sysMappedFile_t;
+
+// maps a file read-only into memory, returns false if the file can't be mapped
+bool			Sys_MapFile( const char *OSPath, sysMappedFile_t &file );
+void			Sys_UnmapFile( sysMappedFile_t &file );
+
 /*
 ==============================================================
 
@@ -348,6 +362,14 @@ enum {
 void				Sys_WaitForEvent( int index = TRIGGER_EVENT_ZERO );
 void				Sys_TriggerEvent( int index = TRIGGER_EVENT_ZERO );
 
+// counting semaphores, unlike the events above any number of threads may wait on one
+typedef struct sysSemaphore_s sysSemaphore_t;
+
+sysSemaphore_t *	Sys_CreateSemaphore( int initialCount = 0 );
+void				Sys_DestroySemaphore( sysSemaphore_t *sem );
+void				Sys_SemaphoreWait( sysSemaphore_t *sem );
+void				Sys_SemaphorePost( sysSemaphore_t *sem );
+
 /*
 ==============================================================
 
@@ -77,6 +77,20 @@ unsigned int Sys_Milliseconds() {
 	return SDL_GetTicks();
 }
 
+/*
+================
+Sys_Microseconds
+================
+*/
+double Sys_Microseconds() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	static double scale = 1000000.0 / SDL_GetPerformanceFrequency();
+	return SDL_GetPerformanceCounter() * scale;
+#else
+	return SDL_GetTicks() * 1000.0;
+#endif
+}
+
 /*
 ==================
 Sys_InitThreads
@@ -233,6 +247,50 @@ void Sys_TriggerEvent(int index) {
 	Sys_LeaveCriticalSection(CRITICAL_SECTION_SYS);
 }
 
+/*
+==================
+Sys_CreateSemaphore
+==================
+*/
+sysSemaphore_t *Sys_CreateSemaphore(int initialCount) {
+	SDL_sem *sem = SDL_CreateSemaphore(initialCount);
+
+	if (!sem)
+		common->Error("ERROR: SDL_CreateSemaphore failed\n");
+
+	return (sysSemaphore_t *)sem;
+}
+
+/*
+==================
+Sys_DestroySemaphore
+==================
+*/
+void Sys_DestroySemaphore(sysSemaphore_t *sem) {
+	if (sem)
+		SDL_DestroySemaphore((SDL_sem *)sem);
+}
+
+/*
+==================
+Sys_SemaphoreWait
+==================
+*/
+void Sys_SemaphoreWait(sysSemaphore_t *sem) {
+	if (SDL_SemWait((SDL_sem *)sem) != 0)
+		common->Error("ERROR: SDL_SemWait failed\n");
+}
+
+/*
+==================
+Sys_SemaphorePost
+==================
+*/
+void Sys_SemaphorePost(sysSemaphore_t *sem) {
+	if (SDL_SemPost((SDL_sem *)sem) != 0)
+		common->Error("ERROR: SDL_SemPost failed\n");
+}
+
 /*
 ==================
 Sys_CreateThread
@@ -317,6 +317,61 @@ ID_TIME_T Sys_FileTimeStamp( FILE *fp ) {
 	return (long) st.st_mtime;
 }
 
+/*
+=================
+Sys_MapFile
+=================
+*/
+bool Sys_MapFile( const char *OSPath, sysMappedFile_t &file ) {
+	HANDLE hFile, hMapping;
+	LARGE_INTEGER size;
+	void *data;
+
+	file.data = NULL;
+	file.length = 0;
+	file.handle = NULL;
+
+	hFile = CreateFileA( OSPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( hFile == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+	if ( !GetFileSizeEx( hFile, &size ) || size.QuadPart <= 0 || size.QuadPart > 0x7fffffff ) {
+		CloseHandle( hFile );
+		return false;
+	}
+	hMapping = CreateFileMappingA( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+	// the mapping keeps the file open
+	CloseHandle( hFile );
+	if ( hMapping == NULL ) {
+		return false;
+	}
+	data = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+	if ( data == NULL ) {
+		CloseHandle( hMapping );
+		return false;
+	}
+
+	file.data = data;
+	file.length = (int)size.QuadPart;
+	file.handle = hMapping;
+	return true;
+}
+
+/*
+=================
+Sys_UnmapFile
+=================
+*/
+void Sys_UnmapFile( sysMappedFile_t &file ) {
+	if ( file.data != NULL ) {
+		UnmapViewOfFile( file.data );
+		CloseHandle( (HANDLE)file.handle );
+	}
+	file.data = NULL;
+	file.length = 0;
+	file.handle = NULL;
+}
+
 /*
 ==============
 Sys_Cwd